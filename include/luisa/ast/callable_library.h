@@ -37,6 +37,10 @@ public:
     void add_callable(luisa::string_view name, luisa::shared_ptr<const detail::FunctionBuilder> callable) noexcept;
     void load(luisa::span<const std::byte> binary) noexcept;
     [[nodiscard]] luisa::vector<std::byte> serialize() const noexcept;
+    // a kernel with all the callables it uses, e.g. to compile it in another process;
+    // bound resources are kept as handles and must be valid on the deserializing side
+    [[nodiscard]] static luisa::vector<std::byte> serialize_kernel(Function kernel) noexcept;
+    [[nodiscard]] static luisa::shared_ptr<const detail::FunctionBuilder> deserialize_kernel(luisa::span<const std::byte> binary) noexcept;
     CallableLibrary(CallableLibrary const &) = delete;
     CallableLibrary(CallableLibrary &&) noexcept;
     ~CallableLibrary() noexcept;
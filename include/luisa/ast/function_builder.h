@@ -99,6 +99,7 @@ private:
     Tag _tag;
     bool _hash_computed{false};
     bool _requires_atomic_float{false};
+    bool _allows_raster_stage_calls{false};
 
 protected:
     [[nodiscard]] static luisa::vector<FunctionBuilder *> &_function_stack() noexcept;
@@ -215,6 +216,11 @@ public:
     [[nodiscard]] bool requires_atomic_float() const noexcept;
     /// Return if uses automatic differentiation.
     [[nodiscard]] bool requires_autodiff() const noexcept;
+    /// Return if the kernel may call raster stages.
+    [[nodiscard]] auto allows_raster_stage_calls() const noexcept { return _allows_raster_stage_calls; }
+    /// Let the kernel call raster stages. Only for the internal kernels of backends
+    /// that emulate the raster pipeline; must be set before the calls are built.
+    void allow_raster_stage_calls() noexcept;
 
     // build primitives
     /// Define a kernel function with given definition
@@ -356,7 +362,7 @@ public:
     /// Add ray query statement
     [[nodiscard]] RayQueryStmt *ray_query_(const RefExpr *query) noexcept;
     /// Add auto diff statement
-    [[nodiscard]] AutoDiffStmt *autodiff_() noexcept;
+    [[nodiscard]] AutoDiffStmt *autodiff_(uint checkpoint_interval = 1u) noexcept;
 
     // For autodiff use only
     [[nodiscard]] const Statement *pop_stmt() noexcept;
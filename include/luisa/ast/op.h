@@ -172,6 +172,17 @@ enum struct CallOp : uint32_t {
     ATOMIC_FETCH_MIN,       /// [(atomic_ref, val) -> old]: stores min(old, val), returns old.
     ATOMIC_FETCH_MAX,       /// [(atomic_ref, val) -> old]: stores max(old, val), returns old.
 
+    // explicit memory orders, the trailing order is a uint literal of MemoryOrder
+    ATOMIC_EXCHANGE_EXPLICIT,        /// [(atomic_ref, desired, order) -> old]: ATOMIC_EXCHANGE with the memory order.
+    ATOMIC_COMPARE_EXCHANGE_EXPLICIT,/// [(atomic_ref, expected, desired, order) -> old]: ATOMIC_COMPARE_EXCHANGE with the memory order.
+    ATOMIC_FETCH_ADD_EXPLICIT,       /// [(atomic_ref, val, order) -> old]: ATOMIC_FETCH_ADD with the memory order.
+    ATOMIC_FETCH_SUB_EXPLICIT,       /// [(atomic_ref, val, order) -> old]: ATOMIC_FETCH_SUB with the memory order.
+    ATOMIC_FETCH_AND_EXPLICIT,       /// [(atomic_ref, val, order) -> old]: ATOMIC_FETCH_AND with the memory order.
+    ATOMIC_FETCH_OR_EXPLICIT,        /// [(atomic_ref, val, order) -> old]: ATOMIC_FETCH_OR with the memory order.
+    ATOMIC_FETCH_XOR_EXPLICIT,       /// [(atomic_ref, val, order) -> old]: ATOMIC_FETCH_XOR with the memory order.
+    ATOMIC_FETCH_MIN_EXPLICIT,       /// [(atomic_ref, val, order) -> old]: ATOMIC_FETCH_MIN with the memory order.
+    ATOMIC_FETCH_MAX_EXPLICIT,       /// [(atomic_ref, val, order) -> old]: ATOMIC_FETCH_MAX with the memory order.
+
     BUFFER_READ, /// [(buffer, index) -> value]: reads the index-th element in buffer
     BUFFER_WRITE,/// [(buffer, index, value) -> void]: writes value into the index-th element of buffer
     BUFFER_SIZE, /// [(buffer) -> size]
@@ -326,9 +337,38 @@ enum struct CallOp : uint32_t {
 
 static constexpr size_t call_op_count = to_underlying(CallOp::CALL_OP_END) + 1u;
 
+/// Memory orders of the explicit atomic operations, same as std::memory_order.
+/// The atomic operations without explicit orders are SEQ_CST.
+enum struct MemoryOrder : uint32_t {
+    RELAXED,
+    ACQUIRE,
+    RELEASE,
+    ACQ_REL,
+    SEQ_CST,
+};
+
 [[nodiscard]] constexpr auto is_atomic_operation(CallOp op) noexcept {
     auto op_value = luisa::to_underlying(op);
-    return op_value >= luisa::to_underlying(CallOp::ATOMIC_EXCHANGE) && op_value <= luisa::to_underlying(CallOp::ATOMIC_FETCH_MAX);
+    return op_value >= luisa::to_underlying(CallOp::ATOMIC_EXCHANGE) && op_value <= luisa::to_underlying(CallOp::ATOMIC_FETCH_MAX_EXPLICIT);
+}
+
+[[nodiscard]] constexpr auto is_explicit_atomic_operation(CallOp op) noexcept {
+    auto op_value = luisa::to_underlying(op);
+    return op_value >= luisa::to_underlying(CallOp::ATOMIC_EXCHANGE_EXPLICIT) && op_value <= luisa::to_underlying(CallOp::ATOMIC_FETCH_MAX_EXPLICIT);
+}
+
+/// Maps an explicit atomic operation to the one without the memory order.
+[[nodiscard]] constexpr auto implicit_atomic_operation(CallOp op) noexcept {
+    if (!is_explicit_atomic_operation(op)) { return op; }
+    return static_cast<CallOp>(luisa::to_underlying(op) -
+                               luisa::to_underlying(CallOp::ATOMIC_EXCHANGE_EXPLICIT) +
+                               luisa::to_underlying(CallOp::ATOMIC_EXCHANGE));
+}
+
+/// Number of arguments of an atomic operation following the access chain, including the memory order.
+[[nodiscard]] constexpr auto atomic_operation_value_count(CallOp op) noexcept {
+    auto count = implicit_atomic_operation(op) == CallOp::ATOMIC_COMPARE_EXCHANGE ? 2u : 1u;
+    return is_explicit_atomic_operation(op) ? count + 1u : count;
 }
 
 [[nodiscard]] constexpr auto is_autodiff_operation(CallOp op) noexcept {
@@ -398,15 +438,11 @@ public:
                test(CallOp::RAY_TRACING_QUERY_ANY);
     }
     [[nodiscard]] auto uses_atomic() const noexcept {
-        return test(CallOp::ATOMIC_FETCH_ADD) ||
-               test(CallOp::ATOMIC_FETCH_SUB) ||
-               test(CallOp::ATOMIC_FETCH_MIN) ||
-               test(CallOp::ATOMIC_FETCH_AND) ||
-               test(CallOp::ATOMIC_FETCH_OR) ||
-               test(CallOp::ATOMIC_FETCH_XOR) ||
-               test(CallOp::ATOMIC_EXCHANGE) ||
-               test(CallOp::ATOMIC_EXCHANGE) ||
-               test(CallOp::ATOMIC_COMPARE_EXCHANGE);
+        for (auto op = luisa::to_underlying(CallOp::ATOMIC_EXCHANGE);
+             op <= luisa::to_underlying(CallOp::ATOMIC_FETCH_MAX_EXPLICIT); op++) {
+            if (_bits.test(op)) { return true; }
+        }
+        return false;
     }
     [[nodiscard]] auto uses_autodiff() const noexcept {
         return test(CallOp::REQUIRES_GRADIENT) ||
@@ -477,14 +477,20 @@ class AutoDiffStmt : public Statement {
 
 private:
     ScopeStmt _body;
+    uint _checkpoint_interval;
 
 private:
     [[nodiscard]] uint64_t _compute_hash() const noexcept override;
 
 public:
-    explicit AutoDiffStmt() noexcept : Statement{Tag::AUTO_DIFF} {}
+    /// checkpoint_interval controls which forward intermediates are kept for the
+    /// backward pass: 1 stores all, k > 1 stores every k-th recomputable one and
+    /// recomputes the rest, 0 recomputes everything that can be recomputed
+    explicit AutoDiffStmt(uint checkpoint_interval = 1u) noexcept
+        : Statement{Tag::AUTO_DIFF}, _checkpoint_interval{checkpoint_interval} {}
     [[nodiscard]] auto body() noexcept { return &_body; }
     [[nodiscard]] auto body() const noexcept { return &_body; }
+    [[nodiscard]] auto checkpoint_interval() const noexcept { return _checkpoint_interval; }
     LUISA_STATEMENT_COMMON()
 };
 
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <luisa/core/stl/functional.h>
+#include <luisa/runtime/rhi/command.h>
+#include <luisa/backends/ext/registry.h>
+
+namespace luisa::compute::cpu {
+
+// runs a host function on the thread of the stream after the preceding commands are completed,
+// for the extensions of the CPU backend that work on the host (e.g., the denoiser)
+class CPUHostCallbackCommand final : public luisa::compute::CustomCommand {
+
+public:
+    luisa::function<void()> func;
+
+public:
+    explicit CPUHostCallbackCommand(luisa::function<void()> f) noexcept
+        : CustomCommand{}, func{std::move(f)} {}
+    [[nodiscard]] StreamTag stream_tag() const noexcept override { return StreamTag::COMPUTE; }
+    [[nodiscard]] uint64_t uuid() const noexcept override {
+        return static_cast<uint64_t>(CustomCommandUUID::CPU_HOST_CALLBACK);
+    }
+};
+
+}// namespace luisa::compute::cpu
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <luisa/core/stl/functional.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/rhi/command.h>
+#include <luisa/backends/ext/registry.h>
+
+namespace luisa::compute::cpu {
+
+// executed by the thread of the stream after the preceding commands are completed
+class CPULCubCommand final : public luisa::compute::CustomCommand {
+
+public:
+    luisa::function<void()> func;
+
+public:
+    explicit CPULCubCommand(luisa::function<void()> f) noexcept
+        : CustomCommand{}, func{std::move(f)} {}
+    [[nodiscard]] StreamTag stream_tag() const noexcept override { return StreamTag::COMPUTE; }
+    [[nodiscard]] uint64_t uuid() const noexcept override {
+        return static_cast<uint64_t>(CustomCommandUUID::CPU_LCUB_COMMAND);
+    }
+};
+
+}// namespace luisa::compute::cpu
@@ -0,0 +1,6 @@
+#pragma once
+#include "device_scan.h"
+#include "device_reduce.h"
+#include "device_radix_sort.h"
+#include "device_run_length_encode.h"
+#include "device_select.h"
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace luisa::compute::cpu::lcub {
+
+template<typename _Key, typename _Value>
+struct KeyValuePair {
+    typedef _Key Key;    ///< Key data type
+    typedef _Value Value;///< Value data type
+
+    Key key;    ///< Item key
+    Value value;///< Item value
+
+    /// Constructor
+    KeyValuePair() {}
+
+    /// Constructor
+    KeyValuePair(Key const &key, Value const &value) : key(key), value(value) {}
+};
+
+}// namespace luisa::compute::cpu::lcub
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <luisa/runtime/rhi/device_interface.h>
+
+namespace luisa::compute {
+
+// Memory policy of the CPU backend, passed as DeviceConfig::extension.
+// Resources of at least `large_threshold` bytes are mapped separately when
+// huge pages or a placement other than the default are asked for (Linux only).
+struct CPUDeviceConfigExt : public DeviceConfigExt {
+    enum struct HugePages : uint8_t {
+        NONE,
+        // madvise(MADV_HUGEPAGE)
+        TRANSPARENT,
+        // MAP_HUGETLB, falls back to transparent huge pages if the pool is exhausted
+        EXPLICIT,
+    };
+    enum struct Placement : uint8_t {
+        // pages land on the node of the thread that touches them first
+        DEFAULT,
+        // pages are interleaved across all NUMA nodes
+        INTERLEAVED,
+        // pages are first touched by the workers of a dispatch or of a large copy,
+        // which split the work statically so that each page stays on its node
+        FIRST_TOUCH,
+    };
+    HugePages huge_pages{HugePages::NONE};
+    Placement placement{Placement::DEFAULT};
+    // pins the workers evenly to the NUMA nodes
+    bool pin_workers{false};
+    size_t large_threshold{2u << 20u};
+};
+
+}// namespace luisa::compute
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <mutex>
+#include <chrono>
+
+#include <luisa/core/basic_types.h>
+#include <luisa/core/stl/format.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/runtime/rhi/device_interface.h>
+#include <luisa/runtime/stream.h>
+
+namespace luisa::compute {
+
+struct ProfilingRecord {
+    enum struct Kind : uint32_t {
+        COMMAND_LIST,
+        COMMAND,
+        EVENT_SIGNAL,
+        EVENT_WAIT,
+        PRESENT,
+    };
+    static constexpr auto invalid_parent = ~static_cast<size_t>(0u);
+    Kind kind{};
+    uint64_t stream_handle{};
+    // kernel name for shader dispatches, command type otherwise
+    luisa::string name;
+    // index of the enclosing command list record for commands
+    size_t parent{invalid_parent};
+    uint3 dispatch_size{};
+    size_t bytes{};
+    uint64_t event_value{};
+    // nanoseconds since the extension was created
+    uint64_t submit_time{};
+    uint64_t start_time{};
+    uint64_t end_time{};
+    [[nodiscard]] auto queue_wait_time() const noexcept { return start_time - submit_time; }
+    [[nodiscard]] auto duration() const noexcept { return end_time - start_time; }
+};
+
+// bytes moved by a copy command, zero for other commands
+[[nodiscard]] inline size_t profiling_command_bytes(const Command *command) noexcept {
+    switch (command->tag()) {
+        case Command::Tag::EBufferUploadCommand:
+            return static_cast<const BufferUploadCommand *>(command)->size();
+        case Command::Tag::EBufferDownloadCommand:
+            return static_cast<const BufferDownloadCommand *>(command)->size();
+        case Command::Tag::EBufferCopyCommand:
+            return static_cast<const BufferCopyCommand *>(command)->size();
+        case Command::Tag::EBufferToTextureCopyCommand: {
+            auto cmd = static_cast<const BufferToTextureCopyCommand *>(command);
+            return pixel_storage_size(cmd->storage(), cmd->size());
+        }
+        case Command::Tag::ETextureToBufferCopyCommand: {
+            auto cmd = static_cast<const TextureToBufferCopyCommand *>(command);
+            return pixel_storage_size(cmd->storage(), cmd->size());
+        }
+        case Command::Tag::ETextureUploadCommand: {
+            auto cmd = static_cast<const TextureUploadCommand *>(command);
+            return pixel_storage_size(cmd->storage(), cmd->size());
+        }
+        case Command::Tag::ETextureDownloadCommand: {
+            auto cmd = static_cast<const TextureDownloadCommand *>(command);
+            return pixel_storage_size(cmd->storage(), cmd->size());
+        }
+        case Command::Tag::ETextureCopyCommand: {
+            auto cmd = static_cast<const TextureCopyCommand *>(command);
+            return pixel_storage_size(cmd->storage(), cmd->size());
+        }
+        default: break;
+    }
+    return 0u;
+}
+
+class ProfilingExt : public DeviceExtension {
+
+public:
+    using Record = ProfilingRecord;
+    static constexpr luisa::string_view name = "ProfilingExt";
+
+private:
+    [[nodiscard]] virtual bool enable_stream_profiling(uint64_t stream_handle) noexcept = 0;
+    virtual void disable_stream_profiling(uint64_t stream_handle) noexcept = 0;
+
+protected:
+    ~ProfilingExt() noexcept = default;
+
+public:
+    // synchronizes the stream and records everything submitted to it afterwards;
+    // returns false if the backend cannot time the stream
+    bool enable(const Stream &stream) noexcept { return enable_stream_profiling(stream.handle()); }
+    // synchronizes the stream and stops recording it
+    void disable(const Stream &stream) noexcept { disable_stream_profiling(stream.handle()); }
+    // takes the records of all completed work, in completion order
+    [[nodiscard]] virtual luisa::vector<Record> collect() noexcept = 0;
+
+    // Chrome trace event format, also accepted by Perfetto
+    [[nodiscard]] static luisa::string chrome_trace(luisa::span<const Record> records) noexcept {
+        auto escape = [](luisa::string_view s) noexcept {
+            luisa::string escaped;
+            escaped.reserve(s.size());
+            for (auto c : s) {
+                if (c == '"' || c == '\\') {
+                    escaped.push_back('\\');
+                    escaped.push_back(c);
+                } else if (static_cast<uint8_t>(c) < 0x20u) {
+                    escaped.append(luisa::format("\\u{:04x}", static_cast<uint>(c)));
+                } else {
+                    escaped.push_back(c);
+                }
+            }
+            return escaped;
+        };
+        auto category = [](Record::Kind kind) noexcept -> luisa::string_view {
+            switch (kind) {
+                case Record::Kind::COMMAND_LIST: return "command_list";
+                case Record::Kind::COMMAND: return "command";
+                case Record::Kind::EVENT_SIGNAL: return "event_signal";
+                case Record::Kind::EVENT_WAIT: return "event_wait";
+                case Record::Kind::PRESENT: return "present";
+            }
+            return "unknown";
+        };
+        // one trace thread per stream, numbered by first appearance
+        luisa::unordered_map<uint64_t, size_t> threads;
+        luisa::string trace{"{\"displayTimeUnit\":\"ns\",\"traceEvents\":["};
+        auto first = true;
+        auto append = [&](luisa::string_view event) noexcept {
+            if (!first) { trace.push_back(','); }
+            trace.append("\n").append(event);
+            first = false;
+        };
+        for (auto &&r : records) {
+            auto [iter, first_seen] = threads.try_emplace(r.stream_handle, threads.size());
+            if (first_seen) {
+                append(luisa::format(
+                    R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"Stream 0x{:016x}"}}}})",
+                    iter->second, r.stream_handle));
+            }
+            auto args = luisa::format(R"("queue_wait_us":{:.3f})", static_cast<double>(r.queue_wait_time()) * 1e-3);
+            if (r.kind == Record::Kind::COMMAND && any(r.dispatch_size != make_uint3(0u))) {
+                args.append(luisa::format(R"(,"dispatch_size":[{},{},{}])",
+                                          r.dispatch_size.x, r.dispatch_size.y, r.dispatch_size.z));
+            }
+            if (r.bytes != 0u) { args.append(luisa::format(R"(,"bytes":{})", r.bytes)); }
+            if (r.kind == Record::Kind::EVENT_SIGNAL || r.kind == Record::Kind::EVENT_WAIT) {
+                args.append(luisa::format(R"(,"value":{})", r.event_value));
+            }
+            append(luisa::format(
+                R"({{"name":"{}","cat":"{}","ph":"X","pid":0,"tid":{},"ts":{:.3f},"dur":{:.3f},"args":{{{}}}}})",
+                escape(r.name), category(r.kind), iter->second,
+                static_cast<double>(r.start_time) * 1e-3,
+                static_cast<double>(r.duration()) * 1e-3, args));
+        }
+        trace.append("\n]}\n");
+        return trace;
+    }
+};
+
+// Times the command lists of any backend on the host, through Stream::set_profiler.
+// A list is submitted when dispatched, starts when the previous list of its stream
+// completes (or on submission if that already happened), and ends when its callbacks
+// run. Commands, events and presents are not recorded; backends exposing
+// ProfilingExt time those on the device.
+class HostProfiler final : public StreamProfiler,
+                           public luisa::enable_shared_from_this<HostProfiler> {
+
+public:
+    using Record = ProfilingRecord;
+
+private:
+    std::chrono::steady_clock::time_point _epoch{std::chrono::steady_clock::now()};
+    std::mutex _mutex;
+    luisa::unordered_map<uint64_t, uint64_t> _last_end_times;
+    luisa::vector<Record> _completed;
+
+private:
+    [[nodiscard]] uint64_t _now() const noexcept {
+        auto dt = std::chrono::steady_clock::now() - _epoch;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count();
+    }
+
+public:
+    // must be owned by a shared_ptr, which the pending callbacks keep alive
+    [[nodiscard]] static auto create() noexcept { return luisa::make_shared<HostProfiler>(); }
+
+    void on_dispatch(uint64_t stream_handle, CommandList &list) noexcept override {
+        Record record{.kind = Record::Kind::COMMAND_LIST,
+                      .stream_handle = stream_handle,
+                      .name = "CommandList",
+                      .submit_time = _now()};
+        for (auto &&command : list.commands()) {
+            record.bytes += profiling_command_bytes(command.get());
+        }
+        // callbacks of a stream run in submission order, so the previous end is final here
+        list.add_callback([self = shared_from_this(), record = std::move(record)]() mutable noexcept {
+            auto time = self->_now();
+            std::scoped_lock lock{self->_mutex};
+            auto &&last_end = self->_last_end_times[record.stream_handle];
+            record.start_time = std::min(std::max(record.submit_time, last_end), time);
+            record.end_time = time;
+            last_end = time;
+            self->_completed.emplace_back(std::move(record));
+        });
+    }
+
+    // takes the records of all completed command lists, in completion order
+    [[nodiscard]] luisa::vector<Record> collect() noexcept {
+        std::scoped_lock lock{_mutex};
+        return std::exchange(_completed, {});
+    }
+};
+
+}// namespace luisa::compute
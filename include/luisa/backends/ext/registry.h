@@ -23,6 +23,10 @@ enum struct CustomCommandUUID : uint32_t {
     CUDA_CUSTOM_COMMAND_BEGIN = 0x0400u,
     CUDA_LCUB_COMMAND = CUDA_CUSTOM_COMMAND_BEGIN,
 
+    CPU_CUSTOM_COMMAND_BEGIN = 0x0500u,
+    CPU_LCUB_COMMAND = CPU_CUSTOM_COMMAND_BEGIN,
+    CPU_HOST_CALLBACK,
+
     REGISTERED_END = 0xffffu,
 };
 
@@ -38,6 +42,8 @@ namespace luisa {
         case compute::CustomCommandUUID::DSTORAGE_READ: return "DSTORAGE_READ";
         case compute::CustomCommandUUID::DENOISER_DENOISE: return "DENOISER_DENOISE";
         case compute::CustomCommandUUID::CUDA_LCUB_COMMAND: return "CUDA_LCUB_COMMAND";
+        case compute::CustomCommandUUID::CPU_LCUB_COMMAND: return "CPU_LCUB_COMMAND";
+        case compute::CustomCommandUUID::CPU_HOST_CALLBACK: return "CPU_HOST_CALLBACK";
         default: break;
     }
     return "UNKNOWN";
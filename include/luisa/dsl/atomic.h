@@ -37,6 +37,10 @@ protected:
     [[nodiscard]] auto member(size_t i) const noexcept {
         return AtomicRef<T>{_access_chain->access(i)};
     }
+
+    [[nodiscard]] static auto memory_order(MemoryOrder order) noexcept {
+        return FunctionBuilder::current()->literal(Type::of<uint>(), luisa::to_underlying(order));
+    }
 };
 
 #define LUISA_ATOMIC_REF_COMMON()                                  \
@@ -65,6 +69,13 @@ public:
             {desired.expression()}));
     }
 
+    /// Atomic exchange with the memory order. See also CallOp::ATOMIC_EXCHANGE_EXPLICIT.
+    auto exchange(Expr<T> desired, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_EXCHANGE_EXPLICIT,
+            {desired.expression(), memory_order(order)}));
+    }
+
     /// Atomic compare exchange. Stores old == expected ? desired : old, returns old. See also CallOp::ATOMIC_COMPARE_EXCHANGE.
     auto compare_exchange(Expr<T> expected, Expr<T> desired) noexcept {
         return def<T>(access_chain()->operate(
@@ -72,6 +83,13 @@ public:
             {expected.expression(), desired.expression()}));
     }
 
+    /// Atomic compare exchange with the memory order. See also CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT.
+    auto compare_exchange(Expr<T> expected, Expr<T> desired, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT,
+            {expected.expression(), desired.expression(), memory_order(order)}));
+    }
+
     /// Atomic fetch add. Stores old + val, returns old. See also CallOp::ATOMIC_FETCH_ADD.
     auto fetch_add(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
@@ -79,6 +97,13 @@ public:
             {val.expression()}));
     };
 
+    /// Atomic fetch add with the memory order. See also CallOp::ATOMIC_FETCH_ADD_EXPLICIT.
+    auto fetch_add(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_ADD_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
+
     /// Atomic fetch sub. Stores old - val, returns old. See also CallOp::ATOMIC_FETCH_SUB.
     auto fetch_sub(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
@@ -86,6 +111,13 @@ public:
             {val.expression()}));
     };
 
+    /// Atomic fetch sub with the memory order. See also CallOp::ATOMIC_FETCH_SUB_EXPLICIT.
+    auto fetch_sub(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_SUB_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
+
     /// Atomic fetch and. Stores old & val, returns old. See also CallOp::ATOMIC_FETCH_AND.
     auto fetch_and(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
@@ -93,6 +125,13 @@ public:
             {val.expression()}));
     };
 
+    /// Atomic fetch and with the memory order. See also CallOp::ATOMIC_FETCH_AND_EXPLICIT.
+    auto fetch_and(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_AND_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
+
     /// Atomic fetch or. Stores old | val, returns old. See also CallOp::ATOMIC_FETCH_OR.
     auto fetch_or(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
@@ -100,6 +139,13 @@ public:
             {val.expression()}));
     };
 
+    /// Atomic fetch or with the memory order. See also CallOp::ATOMIC_FETCH_OR_EXPLICIT.
+    auto fetch_or(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_OR_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
+
     /// Atomic fetch xor. Stores old ^ val, returns old. See also CallOp::ATOMIC_FETCH_XOR.
     auto fetch_xor(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
@@ -107,6 +153,13 @@ public:
             {val.expression()}));
     };
 
+    /// Atomic fetch xor with the memory order. See also CallOp::ATOMIC_FETCH_XOR_EXPLICIT.
+    auto fetch_xor(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_XOR_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
+
     /// Atomic fetch min. Stores min(old, val), returns old. See also CallOp::ATOMIC_FETCH_MIN.
     auto fetch_min(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
@@ -114,12 +167,26 @@ public:
             {val.expression()}));
     };
 
+    /// Atomic fetch min with the memory order. See also CallOp::ATOMIC_FETCH_MIN_EXPLICIT.
+    auto fetch_min(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_MIN_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
+
     /// Atomic fetch max. Stores max(old, val), returns old. See also CallOp::ATOMIC_FETCH_MAX.
     auto fetch_max(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
             CallOp::ATOMIC_FETCH_MAX,
             {val.expression()}));
     };
+
+    /// Atomic fetch max with the memory order. See also CallOp::ATOMIC_FETCH_MAX_EXPLICIT.
+    auto fetch_max(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_MAX_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
 };
 
 template<typename T>
@@ -137,6 +204,13 @@ public:
             {desired.expression()}));
     }
 
+    /// Atomic exchange with the memory order. See also CallOp::ATOMIC_EXCHANGE_EXPLICIT.
+    auto exchange(Expr<T> desired, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_EXCHANGE_EXPLICIT,
+            {desired.expression(), memory_order(order)}));
+    }
+
     /// Atomic compare exchange. Stores old == expected ? desired : old, returns old. See also CallOp::ATOMIC_COMPARE_EXCHANGE.
     auto compare_exchange(Expr<T> expected, Expr<T> desired) noexcept {
         return def<T>(access_chain()->operate(
@@ -144,6 +218,13 @@ public:
             {expected.expression(), desired.expression()}));
     }
 
+    /// Atomic compare exchange with the memory order. See also CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT.
+    auto compare_exchange(Expr<T> expected, Expr<T> desired, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT,
+            {expected.expression(), desired.expression(), memory_order(order)}));
+    }
+
     /// Atomic fetch add. Stores old + val, returns old. See also CallOp::ATOMIC_FETCH_ADD.
     auto fetch_add(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
@@ -151,6 +232,13 @@ public:
             {val.expression()}));
     };
 
+    /// Atomic fetch add with the memory order. See also CallOp::ATOMIC_FETCH_ADD_EXPLICIT.
+    auto fetch_add(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_ADD_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
+
     /// Atomic fetch sub. Stores old - val, returns old. See also CallOp::ATOMIC_FETCH_SUB.
     auto fetch_sub(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
@@ -158,6 +246,13 @@ public:
             {val.expression()}));
     };
 
+    /// Atomic fetch sub with the memory order. See also CallOp::ATOMIC_FETCH_SUB_EXPLICIT.
+    auto fetch_sub(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_SUB_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
+
     /// Atomic fetch min. Stores min(old, val), returns old. See also CallOp::ATOMIC_FETCH_MIN.
     auto fetch_min(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
@@ -165,12 +260,26 @@ public:
             {val.expression()}));
     };
 
+    /// Atomic fetch min with the memory order. See also CallOp::ATOMIC_FETCH_MIN_EXPLICIT.
+    auto fetch_min(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_MIN_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
+
     /// Atomic fetch max. Stores max(old, val), returns old. See also CallOp::ATOMIC_FETCH_MAX.
     auto fetch_max(Expr<T> val) noexcept {
         return def<T>(access_chain()->operate(
             CallOp::ATOMIC_FETCH_MAX,
             {val.expression()}));
     };
+
+    /// Atomic fetch max with the memory order. See also CallOp::ATOMIC_FETCH_MAX_EXPLICIT.
+    auto fetch_max(Expr<T> val, MemoryOrder order) noexcept {
+        return def<T>(access_chain()->operate(
+            CallOp::ATOMIC_FETCH_MAX_EXPLICIT,
+            {val.expression(), memory_order(order)}));
+    };
 };
 
 /*
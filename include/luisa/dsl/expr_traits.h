@@ -297,4 +297,29 @@ using is_soa_expr = detail::is_soa_expr_impl<expr_value_t<T>>;
 template<typename T>
 constexpr auto is_soa_expr_v = is_soa_expr<T>::value;
 
+template<typename T>
+class AoSoAView;
+
+template<typename T>
+class AoSoA;
+
+namespace detail {
+
+template<typename T>
+struct is_aosoa_expr_impl : std::false_type {};
+
+template<typename T>
+struct is_aosoa_expr_impl<AoSoAView<T>> : std::true_type {};
+
+template<typename T>
+struct is_aosoa_expr_impl<AoSoA<T>> : std::true_type {};
+
+}// namespace detail
+
+template<typename T>
+using is_aosoa_expr = detail::is_aosoa_expr_impl<expr_value_t<T>>;
+
+template<typename T>
+constexpr auto is_aosoa_expr_v = is_aosoa_expr<T>::value;
+
 }// namespace luisa::compute
@@ -304,6 +304,8 @@ public:
             callable_encode_binding_group(*this, arg);
         } else if constexpr (is_soa_expr_v<T>) {
             callable_encode_soa(*this, arg);
+        } else if constexpr (is_aosoa_expr_v<T>) {
+            callable_encode_aosoa(*this, arg);
         } else {
             if (_arg_count == max_argument_count) [[unlikely]] {
                 _error_too_many_arguments();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mutex>
+
 #include <luisa/core/logging.h>
 #include <luisa/runtime/buffer.h>
 #include <luisa/runtime/event.h>
@@ -26,17 +28,24 @@ public:
             : size{size}, f{std::move(f)} {}
     };
 
+private:
+    class AsyncRetriever;
+
 private:
     Buffer<uint> _buffer;// count & records (desc_id, arg0, arg1, ...)
     luisa::vector<uint> _host_buffer;
     luisa::vector<Item> _items;
+    std::mutex _items_mutex;// items are decoded on the async retriever thread
     luisa::logger _logger;
     std::atomic_bool _reset_called{false};
+    luisa::unique_ptr<AsyncRetriever> _async;
 
 private:
     static void _error_in_kernel() noexcept {
         LUISA_ERROR_WITH_LOCATION("Error occurred in kernel. Aborting.");
     }
+    // prints the records in data[0, size), `count` is the value of the device counter
+    void _print(const uint *data, uint size, uint count, bool abort_on_error) noexcept;
     void _log_to_buffer(Expr<uint>, uint) noexcept {}
 
     template<typename Curr, typename... Other>
@@ -75,6 +84,9 @@ private:
 public:
     /// Create printer object on device. Will create a buffer in it.
     explicit Printer(Device &device, luisa::string_view name = "device", size_t capacity = 1_M) noexcept;
+    ~Printer() noexcept;
+    Printer(Printer &&) noexcept = delete;
+    Printer(const Printer &) noexcept = delete;
     /// Reset the printer. Must be called before any shader dispatch that uses this printer.
     [[nodiscard]] luisa::unique_ptr<Command> reset() noexcept;
     /// Retrieve and print the logs. Will automatically reset the printer for future use.
@@ -83,6 +95,18 @@ public:
                              luisa::unique_ptr<Command> /* reset */,
                              Stream::Synchronize /* synchronize */>
     retrieve(bool abort_on_error = false) noexcept;
+    /// Retrieve the logs without blocking the stream. The records are snapshot on
+    /// the device and the printer is reset; a background thread then downloads
+    /// only the used records on its own stream and prints them. Two snapshots can
+    /// be in flight, a third retrieval waits for the oldest one to be printed.
+    /// Dropping the returned commands without submitting them frees their snapshot.
+    /// Destroying the printer waits until all retrieved logs are printed.
+    [[nodiscard]] std::tuple<luisa::unique_ptr<Command> /* snapshot */,
+                             luisa::unique_ptr<Command> /* reset */,
+                             luisa::unique_ptr<Command> /* download counter */,
+                             luisa::move_only_function<void()> /* notify */,
+                             Event::Signal /* signal */>
+    retrieve_async(bool abort_on_error = false) noexcept;
 
     /// Log in kernel at debug level.
     template<typename... Args>
@@ -165,6 +189,7 @@ void Printer::_log(luisa::log_level level, luisa::string fmt, const Args &...arg
     for (auto c : count_per_arg) { count += c; }
     auto size = static_cast<uint>(_buffer.size() - 1u);
     auto offset = _buffer->atomic(size).fetch_add(count);
+    std::scoped_lock lock{_items_mutex};
     auto item = static_cast<uint>(_items.size());
     dsl::if_(offset < size, [&] { _buffer->write(offset, item); });
     dsl::if_(offset + count <= size, [&] { _log_to_buffer(offset, 1u, args...); });
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <luisa/core/stl/optional.h>
 #include <luisa/dsl/var.h>
 #include <luisa/dsl/atomic.h>
 #include <luisa/dsl/builtin.h>
 #include <luisa/dsl/func.h>
 #include <luisa/runtime/shader.h>
+#include <luisa/runtime/command_list.h>
 
 namespace luisa::compute {
 
@@ -29,20 +31,36 @@ private:
     Expr<uint> _soa_offset;
     Expr<uint> _soa_size;
     Expr<uint> _element_offset;
+    // 64-bit word offset of the SOA in the buffer, only set for the blocks of AoSoA
+    luisa::optional<Expr<ulong>> _base;
 
 public:
     SOAExprBase(Expr<Buffer<uint>> buffer,
                 Expr<uint> soa_offset,
                 Expr<uint> soa_size,
-                Expr<uint> element_offset) noexcept
+                Expr<uint> element_offset,
+                luisa::optional<Expr<ulong>> base = luisa::nullopt) noexcept
         : _buffer{buffer},
           _soa_offset{soa_offset},
           _soa_size{soa_size},
-          _element_offset{element_offset} {}
+          _element_offset{element_offset},
+          _base{base} {}
     [[nodiscard]] auto buffer() const noexcept { return _buffer; }
     [[nodiscard]] auto soa_offset() const noexcept { return _soa_offset; }
     [[nodiscard]] auto soa_size() const noexcept { return _soa_size; }
     [[nodiscard]] auto element_offset() const noexcept { return _element_offset; }
+    [[nodiscard]] auto base() const noexcept { return _base; }
+    [[nodiscard]] Var<uint> read_word(Expr<uint> i) const noexcept {
+        if (_base) { return _buffer.read(*_base + cast<ulong>(i)); }
+        return _buffer.read(i);
+    }
+    void write_word(Expr<uint> i, Expr<uint> value) const noexcept {
+        if (_base) {
+            _buffer.write(*_base + cast<ulong>(i), value);
+        } else {
+            _buffer.write(i, value);
+        }
+    }
 };
 
 }// namespace detail
@@ -57,8 +75,9 @@ public:
     Expr(Expr<Buffer<uint>> buffer,
          Expr<uint> soa_offset,
          Expr<uint> soa_size,
-         Expr<uint> elem_offset) noexcept
-        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset} {}
+         Expr<uint> elem_offset,
+         luisa::optional<Expr<ulong>> base = luisa::nullopt) noexcept
+        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset, base} {}
 
     Expr(SOAView<T> soa) noexcept
         : Expr{soa.buffer(), soa.soa_offset(), soa.soa_size(), soa.element_offset()} {}
@@ -70,7 +89,7 @@ public:
     [[nodiscard]] auto read(I &&index) const noexcept {
         if constexpr (element_stride == 1u) {
             auto i = soa_offset() + std::forward<I>(index) + element_offset();
-            auto x = buffer().read(i);
+            auto x = read_word(i);
             if constexpr (sizeof(T) == sizeof(uint)) {
                 return x.template as<T>();
             } else if constexpr (sizeof(T) * 2u == sizeof(uint)) {// 16bit
@@ -90,16 +109,16 @@ public:
             }
         } else if constexpr (element_stride == 2u) {
             auto i = soa_offset() + (std::forward<I>(index) + element_offset()) * 2u;
-            auto u = dsl::make_uint2(buffer().read(i),
-                                     buffer().read(i + 1u));
+            auto u = dsl::make_uint2(read_word(i),
+                                     read_word(i + 1u));
             return u.template as<T>();
         } else {
             static_assert(element_stride == 4u);
             auto i = soa_offset() + (std::forward<I>(index) + element_offset()) * 4u;
-            auto u = dsl::make_uint4(buffer().read(i),
-                                     buffer().read(i + 1u),
-                                     buffer().read(i + 2u),
-                                     buffer().read(i + 3u));
+            auto u = dsl::make_uint4(read_word(i),
+                                     read_word(i + 1u),
+                                     read_word(i + 2u),
+                                     read_word(i + 3u));
             return u.template as<T>();
         }
     }
@@ -109,38 +128,38 @@ public:
         if constexpr (element_stride == 1u) {
             auto i = soa_offset() + std::forward<I>(index) + element_offset();
             if constexpr (sizeof(T) == sizeof(uint)) {
-                buffer().write(i, value.template as<uint>());
+                write_word(i, value.template as<uint>());
             } else if constexpr (sizeof(T) * 2u == sizeof(uint)) {// 16bit
                 if constexpr (is_scalar_v<T>) {
                     auto u = def<Vector<T, 2u>>();
                     u.x = value;
-                    buffer().write(i, u.template as<uint>());
+                    write_word(i, u.template as<uint>());
                 } else {
                     static_assert(std::is_same_v<T, bool2>);
                     auto u = make_bool4(value, make_bool2());
-                    buffer().write(i, u.template as<uint>());
+                    write_word(i, u.template as<uint>());
                 }
             } else if constexpr (sizeof(T) * 4u == sizeof(uint)) {
                 static_assert(is_scalar_v<T>);
                 auto u = def<Vector<T, 4u>>();
                 u.x = value;
-                buffer().write(i, u.template as<uint>());
+                write_word(i, u.template as<uint>());
             } else {// unreachable
                 static_assert(sizeof(T) == sizeof(uint));
             }
         } else if constexpr (element_stride == 2u) {
             auto i = soa_offset() + (std::forward<I>(index) + element_offset()) * 2u;
             auto u = value.template as<Vector<uint, 2>>();
-            buffer().write(i, u.x);
-            buffer().write(i + 1u, u.y);
+            write_word(i, u.x);
+            write_word(i + 1u, u.y);
         } else {
             static_assert(element_stride == 4u);
             auto i = soa_offset() + (std::forward<I>(index) + element_offset()) * 4u;
             auto u = value.template as<Vector<uint, 4>>();
-            buffer().write(i, u.x);
-            buffer().write(i + 1u, u.y);
-            buffer().write(i + 2u, u.z);
-            buffer().write(i + 3u, u.w);
+            write_word(i, u.x);
+            write_word(i + 1u, u.y);
+            write_word(i + 2u, u.z);
+            write_word(i + 3u, u.w);
         }
     }
 
@@ -159,10 +178,11 @@ public:
     Expr(Expr<Buffer<uint>> buffer,
          Expr<uint> soa_offset,
          Expr<uint> soa_size,
-         Expr<uint> elem_offset) noexcept
-        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset},
-          x{buffer, soa_offset, soa_size, elem_offset},
-          y{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size), soa_size, elem_offset} {}
+         Expr<uint> elem_offset,
+         luisa::optional<Expr<ulong>> base = luisa::nullopt) noexcept
+        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset, base},
+          x{buffer, soa_offset, soa_size, elem_offset, base},
+          y{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size), soa_size, elem_offset, base} {}
 
     Expr(SOAView<Vector<T, 2>> soa) noexcept
         : Expr{soa.buffer(), soa.soa_offset(), soa.soa_size(), soa.element_offset()} {}
@@ -201,11 +221,12 @@ public:
     Expr(Expr<Buffer<uint>> buffer,
          Expr<uint> soa_offset,
          Expr<uint> soa_size,
-         Expr<uint> elem_offset) noexcept
-        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset},
-          x{buffer, soa_offset, soa_size, elem_offset},
-          y{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size), soa_size, elem_offset},
-          z{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size) * 2u, soa_size, elem_offset} {}
+         Expr<uint> elem_offset,
+         luisa::optional<Expr<ulong>> base = luisa::nullopt) noexcept
+        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset, base},
+          x{buffer, soa_offset, soa_size, elem_offset, base},
+          y{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size), soa_size, elem_offset, base},
+          z{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size) * 2u, soa_size, elem_offset, base} {}
 
     Expr(SOAView<Vector<T, 3>> soa) noexcept
         : Expr{soa.buffer(), soa.soa_offset(), soa.soa_size(), soa.element_offset()} {}
@@ -247,12 +268,13 @@ public:
     Expr(Expr<Buffer<uint>> buffer,
          Expr<uint> soa_offset,
          Expr<uint> soa_size,
-         Expr<uint> elem_offset) noexcept
-        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset},
-          x{buffer, soa_offset, soa_size, elem_offset},
-          y{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size), soa_size, elem_offset},
-          z{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size) * 2u, soa_size, elem_offset},
-          w{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size) * 3u, soa_size, elem_offset} {}
+         Expr<uint> elem_offset,
+         luisa::optional<Expr<ulong>> base = luisa::nullopt) noexcept
+        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset, base},
+          x{buffer, soa_offset, soa_size, elem_offset, base},
+          y{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size), soa_size, elem_offset, base},
+          z{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size) * 2u, soa_size, elem_offset, base},
+          w{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size) * 3u, soa_size, elem_offset, base} {}
 
     Expr(SOAView<Vector<T, 4>> soa) noexcept
         : Expr{soa.buffer(), soa.soa_offset(), soa.soa_size(), soa.element_offset()} {}
@@ -295,10 +317,11 @@ private:
          Expr<uint> soa_offset,
          Expr<uint> soa_size,
          Expr<uint> elem_offset,
+         luisa::optional<Expr<ulong>> base,
          std::index_sequence<i...>) noexcept
-        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset},
+        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset, base},
           _cols{Expr<SOA<Column>>{buffer, soa_offset + SOA<Column>::compute_soa_size(soa_size) * static_cast<uint>(i),
-                                  soa_size, elem_offset}...} {}
+                                  soa_size, elem_offset, base}...} {}
 
 public:
     Expr(SOAView<Matrix<N>> soa) noexcept
@@ -310,8 +333,9 @@ public:
     Expr(Expr<Buffer<uint>> buffer,
          Expr<uint> soa_offset,
          Expr<uint> soa_size,
-         Expr<uint> elem_offset) noexcept
-        : Expr{buffer, soa_offset, soa_size, elem_offset, std::make_index_sequence<N>{}} {}
+         Expr<uint> elem_offset,
+         luisa::optional<Expr<ulong>> base = luisa::nullopt) noexcept
+        : Expr{buffer, soa_offset, soa_size, elem_offset, base, std::make_index_sequence<N>{}} {}
 
     template<typename I>
     [[nodiscard]] auto read(I &&index) const noexcept {
@@ -349,10 +373,11 @@ private:
          Expr<uint> soa_offset,
          Expr<uint> soa_size,
          Expr<uint> elem_offset,
+         luisa::optional<Expr<ulong>> base,
          std::index_sequence<i...>) noexcept
-        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset},
+        : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset, base},
           _elems{Expr<SOA<T>>{buffer, soa_offset + SOA<T>::compute_soa_size(soa_size) * static_cast<uint>(i),
-                              soa_size, elem_offset}...} {}
+                              soa_size, elem_offset, base}...} {}
 
 public:
     Expr(SOAView<Array> soa) noexcept
@@ -364,8 +389,9 @@ public:
     Expr(Expr<Buffer<uint>> buffer,
          Expr<uint> soa_offset,
          Expr<uint> soa_size,
-         Expr<uint> elem_offset) noexcept
-        : Expr{buffer, soa_offset, soa_size, elem_offset,
+         Expr<uint> elem_offset,
+         luisa::optional<Expr<ulong>> base = luisa::nullopt) noexcept
+        : Expr{buffer, soa_offset, soa_size, elem_offset, base,
                std::make_index_sequence<N>{}} {}
 
     template<typename I>
@@ -407,8 +433,12 @@ Expr(const SOA<T> &) -> Expr<SOA<T>>;
 
 namespace detail {
 
+LC_DSL_API void error_soa_block_as_argument() noexcept;
+
 template<typename T>
 void callable_encode_soa(CallableInvoke &invoke, Expr<T> soa) {
+    // the 64-bit base of AoSoA blocks is not part of the SOA arguments
+    if (soa.base()) [[unlikely]] { error_soa_block_as_argument(); }
     invoke << soa.buffer()
            << soa.soa_offset()
            << soa.soa_size()
@@ -485,6 +515,17 @@ LC_DSL_API void error_soa_subview_out_of_range() noexcept;
 LC_DSL_API void error_soa_view_exceeds_uint_max() noexcept;
 LC_DSL_API void error_soa_index_out_of_range() noexcept;
 
+// Host-side transposition between AoS data of the given type and the elements [elem_offset, elem_offset + elem_count)
+// of SOA blocks, where block b holds block_size elements in block_words words from soa_offset + b * block_words.
+// The upload transposes the data in parallel right away and the download does so in the callback of the returned list,
+// so the data pointer passed to the latter must stay valid until the stream is synchronized.
+[[nodiscard]] LC_DSL_API CommandList soa_upload(const Type *type, BufferView<uint> buffer,
+                                                size_t soa_offset, size_t block_size, size_t block_words,
+                                                size_t elem_offset, size_t elem_count, const void *data) noexcept;
+[[nodiscard]] LC_DSL_API CommandList soa_download(const Type *type, BufferView<uint> buffer,
+                                                  size_t soa_offset, size_t block_size, size_t block_words,
+                                                  size_t elem_offset, size_t elem_count, void *data) noexcept;
+
 template<typename T>
 class SOAViewBase {
 
@@ -526,6 +567,18 @@ public:
                     this->element_offset() + offset,
                     size};
     }
+    // transpose element_size() elements of AoS data into the SOA
+    [[nodiscard]] auto copy_from(const T *data) const noexcept {
+        return soa_upload(Type::of<T>(), _buffer, _soa_offset, _soa_size, View::compute_soa_size(_soa_size),
+                          _elem_offset, _elem_size, data)
+            .commit();
+    }
+    // transpose the SOA back into element_size() elements of AoS data
+    [[nodiscard]] auto copy_to(T *data) const noexcept {
+        return soa_download(Type::of<T>(), _buffer, _soa_offset, _soa_size, View::compute_soa_size(_soa_size),
+                            _elem_offset, _elem_size, data)
+            .commit();
+    }
 };
 
 }// namespace detail
@@ -762,4 +815,228 @@ SOAView(const SOA<T> &) -> SOAView<T>;
 template<typename T>
 using SOAVar = Var<SOA<T>>;
 
+// AoSoA: an array of fixed-size SOA blocks, addressed with 64-bit offsets
+template<typename T>
+class AoSoAView;
+
+template<typename T>
+class AoSoA;
+
+constexpr auto aosoa_default_block_size = 32u;
+
+template<typename T>
+struct Expr<AoSoA<T>> {
+
+private:
+    Expr<Buffer<uint>> _buffer;
+    Expr<uint> _block_size;
+    Expr<ulong> _element_offset;
+
+public:
+    Expr(Expr<Buffer<uint>> buffer,
+         Expr<uint> block_size,
+         Expr<ulong> elem_offset) noexcept
+        : _buffer{buffer},
+          _block_size{block_size},
+          _element_offset{elem_offset} {}
+
+    Expr(AoSoAView<T> aosoa) noexcept
+        : Expr{aosoa.buffer(), aosoa.block_size(), aosoa.element_offset()} {}
+
+    Expr(const AoSoA<T> &aosoa) noexcept
+        : Expr{aosoa.view()} {}
+
+    [[nodiscard]] auto buffer() const noexcept { return _buffer; }
+    [[nodiscard]] auto block_size() const noexcept { return _block_size; }
+    [[nodiscard]] auto element_offset() const noexcept { return _element_offset; }
+
+    // returns the SOA block holding the element and the index of the element in it,
+    // so that the members can be accessed individually, e.g., `block.m.read(lane)`
+    template<typename I>
+    [[nodiscard]] auto block(I &&index) const noexcept {
+        auto i = def(cast<ulong>(std::forward<I>(index)) + _element_offset);
+        // the block size is a power of two
+        auto lane = def(cast<uint>(i) & (_block_size - 1u));
+        auto b = i >> cast<ulong>(ctz(_block_size));
+        auto base = b * cast<ulong>(SOAView<T>::compute_soa_size(_block_size));
+        return std::make_pair(Expr<SOA<T>>{_buffer, 0u, _block_size, 0u, base}, std::move(lane));
+    }
+
+    template<typename I>
+    [[nodiscard]] auto read(I &&index) const noexcept {
+        auto [block, lane] = this->block(std::forward<I>(index));
+        return block.read(lane);
+    }
+
+    template<typename I>
+    void write(I &&index, Expr<T> value) const noexcept {
+        auto [block, lane] = this->block(std::forward<I>(index));
+        block.write(lane, value);
+    }
+
+    [[nodiscard]] auto operator->() const noexcept { return this; }
+};
+
+template<typename T>
+struct Expr<AoSoAView<T>> : public Expr<AoSoA<T>> {
+    using Expr<AoSoA<T>>::Expr;
+};
+
+template<typename T>
+Expr(AoSoAView<T>) -> Expr<AoSoAView<T>>;
+
+template<typename T>
+Expr(const AoSoA<T> &) -> Expr<AoSoA<T>>;
+
+namespace detail {
+
+template<typename T>
+void callable_encode_aosoa(CallableInvoke &invoke, Expr<T> aosoa) {
+    invoke << aosoa.buffer()
+           << aosoa.block_size()
+           << aosoa.element_offset();
+}
+
+}// namespace detail
+
+template<typename T>
+struct Var<AoSoA<T>> : public Expr<AoSoA<T>> {
+
+private:
+    using Base = Expr<AoSoA<T>>;
+
+    Var(Expr<Buffer<uint>> buffer,
+        Expr<uint> block_size,
+        Expr<ulong> elem_offset) noexcept
+        : Base{buffer, block_size, elem_offset} {}
+
+    // make the call sequential
+    Var(Expr<Buffer<uint>> buffer,
+        Expr<uint> block_size) noexcept
+        : Var{buffer, block_size,
+              Var<ulong>{detail::ArgumentCreation{}}} {}
+
+    Var(Expr<Buffer<uint>> buffer) noexcept
+        : Var{buffer,
+              Var<uint>{detail::ArgumentCreation{}}} {}
+
+public:
+    Var(detail::ArgumentCreation) noexcept
+        : Var{Var<Buffer<uint>>{detail::ArgumentCreation{}}} {}
+    [[nodiscard]] explicit operator Expr<AoSoAView<T>>() const noexcept { return Base{*this}; }
+    [[nodiscard]] explicit operator Var<AoSoAView<T>>() const noexcept { return Expr<AoSoAView<T>>{*this}; }
+};
+
+template<typename T>
+struct Var<AoSoAView<T>> : public Var<AoSoA<T>> {
+    using Var<AoSoA<T>>::Var;
+};
+
+namespace detail {
+
+template<typename T>
+struct shader_argument_encode_count<AoSoA<T>> {
+    static constexpr uint value = 3u;
+};
+
+template<typename T>
+struct shader_argument_encode_count<AoSoAView<T>>
+    : public shader_argument_encode_count<AoSoA<T>> {};
+
+template<typename T>
+ShaderInvokeBase &ShaderInvokeBase::operator<<(AoSoAView<T> aosoa) noexcept {
+    return *this << aosoa.buffer()
+                 << aosoa.block_size()
+                 << aosoa.element_offset();
+}
+
+template<typename T>
+ShaderInvokeBase &ShaderInvokeBase::operator<<(const AoSoA<T> &aosoa) noexcept {
+    return *this << aosoa.view();
+}
+
+LC_DSL_API void error_aosoa_invalid_block_size(uint block_size) noexcept;
+LC_DSL_API void error_aosoa_subview_out_of_range() noexcept;
+
+}// namespace detail
+
+template<typename T>
+class AoSoAView {
+
+private:
+    BufferView<uint> _buffer;
+    uint _block_size{};
+    ulong _elem_offset{};
+    ulong _elem_size{};
+
+public:
+    [[nodiscard]] static auto compute_block_words(uint block_size) noexcept {
+        return SOAView<T>::compute_soa_size(block_size);
+    }
+    [[nodiscard]] static auto compute_aosoa_size(size_t n, uint block_size) noexcept {
+        return (n + block_size - 1u) / block_size * static_cast<size_t>(compute_block_words(block_size));
+    }
+
+public:
+    AoSoAView() noexcept = default;
+    AoSoAView(BufferView<uint> buffer, uint block_size,
+              size_t elem_offset, size_t elem_size) noexcept
+        : _buffer{buffer},
+          _block_size{block_size},
+          _elem_offset{static_cast<ulong>(elem_offset)},
+          _elem_size{static_cast<ulong>(elem_size)} {
+        if (block_size == 0u || (block_size & (block_size - 1u)) != 0u) [[unlikely]] {
+            detail::error_aosoa_invalid_block_size(block_size);
+        }
+    }
+    [[nodiscard]] auto buffer() const noexcept { return _buffer; }
+    [[nodiscard]] auto block_size() const noexcept { return _block_size; }
+    [[nodiscard]] auto element_offset() const noexcept { return _elem_offset; }
+    [[nodiscard]] auto element_size() const noexcept { return _elem_size; }
+    [[nodiscard]] auto operator->() const noexcept { return Expr<AoSoAView<T>>{*this}; }
+    [[nodiscard]] auto subview(size_t offset, size_t size) const noexcept {
+        if (!(offset + size <= _elem_size)) [[unlikely]] {
+            detail::error_aosoa_subview_out_of_range();
+        }
+        return AoSoAView{_buffer, _block_size, _elem_offset + offset, size};
+    }
+    // transpose element_size() elements of AoS data into the blocks
+    [[nodiscard]] auto copy_from(const T *data) const noexcept {
+        return detail::soa_upload(Type::of<T>(), _buffer, 0u, _block_size, compute_block_words(_block_size),
+                                  _elem_offset, _elem_size, data)
+            .commit();
+    }
+    // transpose the blocks back into element_size() elements of AoS data
+    [[nodiscard]] auto copy_to(T *data) const noexcept {
+        return detail::soa_download(Type::of<T>(), _buffer, 0u, _block_size, compute_block_words(_block_size),
+                                    _elem_offset, _elem_size, data)
+            .commit();
+    }
+};
+
+template<typename T>
+class AoSoA : public AoSoAView<T> {
+
+private:
+    Buffer<uint> _buffer;
+
+private:
+    AoSoA(Buffer<uint> buffer, uint block_size, size_t size) noexcept
+        : AoSoAView<T>{buffer.view(), block_size, 0u, size},
+          _buffer{std::move(buffer)} {}
+
+public:
+    AoSoA() noexcept = default;
+    AoSoA(Device &device, size_t elem_count, uint block_size = aosoa_default_block_size) noexcept
+        : AoSoA{device.create_buffer<uint>(AoSoAView<T>::compute_aosoa_size(elem_count, block_size)),
+                block_size, elem_count} {}
+    [[nodiscard]] auto view() const noexcept { return AoSoAView<T>{*this}; }
+};
+
+template<typename T>
+AoSoAView(const AoSoA<T> &) -> AoSoAView<T>;
+
+template<typename T>
+using AoSoAVar = Var<AoSoA<T>>;
+
 }// namespace luisa::compute
@@ -78,8 +78,8 @@ private:
     AutoDiffStmt *_stmt;
 
 public:
-    AutoDiffStmtBuilder() noexcept
-        : _stmt{FunctionBuilder::current()->autodiff_()} {}
+    explicit AutoDiffStmtBuilder(uint checkpoint_interval = 1u) noexcept
+        : _stmt{FunctionBuilder::current()->autodiff_(checkpoint_interval)} {}
 
     /// Add body statement
     template<typename Body>
@@ -304,6 +304,14 @@ inline void autodiff(Body &&body) noexcept {
     detail::AutoDiffStmtBuilder{} % std::forward<Body>(body);
 }
 
+/// automatic differentiation block that stores only every k-th recomputable
+/// forward intermediate and recomputes the rest in the backward pass
+/// (0 recomputes everything recomputable, 1 is the same as autodiff())
+template<typename Body>
+inline void autodiff(uint checkpoint_interval, Body &&body) noexcept {
+    detail::AutoDiffStmtBuilder{checkpoint_interval} % std::forward<Body>(body);
+}
+
 /// switch(expr). Return SwitchStmtBuilder
 template<typename T>
 inline auto switch_(T &&expr) noexcept {
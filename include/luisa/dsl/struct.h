@@ -223,7 +223,7 @@ using c_array_to_std_array_t = typename c_array_to_std_array<T>::type;
     Expr<SOA<member_type_##m>> m;
 
 #define LUISA_SOA_EXPR_MAKE_MEMBER_INIT(m) \
-    m(buffer, soa_offset + _accumulate_soa_offset<member_type_##m>(soa_offset_accum, soa_size), soa_size, elem_offset)
+    m(buffer, soa_offset + _accumulate_soa_offset<member_type_##m>(soa_offset_accum, soa_size), soa_size, elem_offset, base)
 
 #define LUISA_SOA_EXPR_MAKE_MEMBER_READ(m) \
     this->m.read(i)
@@ -253,16 +253,18 @@ using c_array_to_std_array_t = typename c_array_to_std_array<T>::type;
              Expr<Buffer<uint>> buffer,                                                                    \
              Expr<uint> soa_offset,                                                                        \
              Expr<uint> soa_size,                                                                          \
-             Expr<uint> elem_offset) noexcept                                                              \
-            : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset},                              \
+             Expr<uint> elem_offset,                                                                       \
+             luisa::optional<Expr<ulong>> base) noexcept                                                   \
+            : detail::SOAExprBase{buffer, soa_offset, soa_size, elem_offset, base},                        \
               LUISA_MAP_LIST(LUISA_SOA_EXPR_MAKE_MEMBER_INIT, __VA_ARGS__) {}                              \
                                                                                                            \
     public:                                                                                                \
         Expr(Expr<Buffer<uint>> buffer,                                                                    \
              Expr<uint> soa_offset,                                                                        \
              Expr<uint> soa_size,                                                                          \
-             Expr<uint> elem_offset) noexcept                                                              \
-            : Expr{def(0u), buffer, soa_offset, soa_size, elem_offset} {}                                  \
+             Expr<uint> elem_offset,                                                                       \
+             luisa::optional<Expr<ulong>> base = luisa::nullopt) noexcept                                  \
+            : Expr{def(0u), buffer, soa_offset, soa_size, elem_offset, base} {}                            \
                                                                                                            \
         Expr(SOAView<S> soa) noexcept                                                                      \
             : Expr{soa.buffer(), soa.soa_offset(), soa.soa_size(), soa.element_offset()} {}                \
@@ -94,6 +94,7 @@
 } % [&]() noexcept
 
 #define $autodiff ::luisa::compute::detail::AutoDiffStmtBuilder{} % [&]() noexcept
+#define $autodiff_checkpoint(k) ::luisa::compute::detail::AutoDiffStmtBuilder(k) % [&]() noexcept
 
 #define $switch(...) ::luisa::compute::detail::SwitchStmtBuilder{__VA_ARGS__} % [&]() noexcept
 #define $case(...) ::luisa::compute::detail::SwitchCaseStmtBuilder{__VA_ARGS__} % [&]() noexcept
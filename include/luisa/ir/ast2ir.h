@@ -8,6 +8,10 @@
 
 #include <luisa/rust/ir.hpp>
 
+namespace luisa {
+class ThreadPool;
+}// namespace luisa
+
 namespace luisa::compute {
 
 namespace detail {
@@ -29,9 +33,9 @@ private:
     };
 
 private:
-    luisa::unordered_map<uint64_t, ir::CArc<ir::Type>> _struct_types;// maps Type::hash() to ir::Type
     luisa::unordered_map<uint64_t, ir::NodeRef> _constants;          // maps Constant::hash() to ir::NodeRef
     luisa::unordered_map<uint32_t, ir::NodeRef> _variables;          // maps Variable::uid to ir::NodeRef
+    // callables visible to this conversion, resolved before it starts since the shared cache may evict them
     luisa::unordered_map<Function, luisa::shared_ptr<ir::CArc<ir::CallableModule>>> _converted_callables;
     luisa::vector<ir::IrBuilder *> _builder_stack;
     Function _function;
@@ -89,13 +93,24 @@ private:
     // helper functions
     [[nodiscard]] ir::NodeRef _cast(const Type *type_dst, const Type *type_src, ir::NodeRef node_src) noexcept;
     [[nodiscard]] ir::NodeRef _literal(const Type *type, LiteralExpr::Value value) noexcept;
-    [[nodiscard]] luisa::shared_ptr<ir::CArc<ir::KernelModule>> _convert_kernel(Function function) noexcept;
-    [[nodiscard]] luisa::shared_ptr<ir::CArc<ir::CallableModule>> _convert_callable(Function function) noexcept;
+    [[nodiscard]] luisa::shared_ptr<ir::CArc<ir::CallableModule>> _find_callable(Function function) const noexcept;
+    void _convert_callables(Function function, luisa::ThreadPool *pool) noexcept;
+    [[nodiscard]] luisa::shared_ptr<ir::CArc<ir::CallableModule>> _convert_callable_module(Function function) noexcept;
+    [[nodiscard]] luisa::shared_ptr<ir::CArc<ir::KernelModule>> _convert_kernel(Function function, luisa::ThreadPool *pool) noexcept;
+    [[nodiscard]] luisa::shared_ptr<ir::CArc<ir::CallableModule>> _convert_callable(Function function, luisa::ThreadPool *pool) noexcept;
 
 public:
-    [[nodiscard]] static luisa::shared_ptr<ir::CArc<ir::KernelModule>> build_kernel(Function function) noexcept;
-    [[nodiscard]] static luisa::shared_ptr<ir::CArc<ir::CallableModule>> build_callable(Function function) noexcept;
+    // If a thread pool is given, independent callables reachable from the
+    // function are converted concurrently on it. Converted callables are
+    // cached process-wide (keyed by Function::hash()) and shared across kernels,
+    // so transforms must work on copies (see the transform pipeline).
+    [[nodiscard]] static luisa::shared_ptr<ir::CArc<ir::KernelModule>> build_kernel(Function function, luisa::ThreadPool *pool = nullptr) noexcept;
+    [[nodiscard]] static luisa::shared_ptr<ir::CArc<ir::CallableModule>> build_callable(Function function, luisa::ThreadPool *pool = nullptr) noexcept;
     [[nodiscard]] static ir::CArc<ir::Type> build_type(const Type *type) noexcept;
+    // the least recently used callables are evicted beyond the capacity (4096 by default)
+    static void set_callable_cache_capacity(size_t capacity) noexcept;
+    // drops all cached callable modules; modules still referenced by kernels stay alive
+    static void clear_callable_cache() noexcept;
 };
 
 }// namespace luisa::compute
@@ -478,6 +478,12 @@ public:
         static constexpr Tag tag() noexcept { return raw::Func::Tag::DispatchSize; }
     };
     explicit Func(Func::DispatchSize _) noexcept { _inner.tag = DispatchSize::tag(); }
+    class LC_IR_API KernelId : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::KernelId; }
+    };
+    explicit Func(Func::KernelId _) noexcept { _inner.tag = KernelId::tag(); }
     class LC_IR_API RequiresGradient : Marker, concepts::Noncopyable {
         uint8_t _pad;
     public:
@@ -1330,6 +1336,60 @@ public:
         static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicFetchMax; }
     };
     explicit Func(Func::AtomicFetchMax _) noexcept { _inner.tag = AtomicFetchMax::tag(); }
+    class LC_IR_API AtomicExchangeExplicit : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicExchangeExplicit; }
+    };
+    explicit Func(Func::AtomicExchangeExplicit _) noexcept { _inner.tag = AtomicExchangeExplicit::tag(); }
+    class LC_IR_API AtomicCompareExchangeExplicit : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicCompareExchangeExplicit; }
+    };
+    explicit Func(Func::AtomicCompareExchangeExplicit _) noexcept { _inner.tag = AtomicCompareExchangeExplicit::tag(); }
+    class LC_IR_API AtomicFetchAddExplicit : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicFetchAddExplicit; }
+    };
+    explicit Func(Func::AtomicFetchAddExplicit _) noexcept { _inner.tag = AtomicFetchAddExplicit::tag(); }
+    class LC_IR_API AtomicFetchSubExplicit : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicFetchSubExplicit; }
+    };
+    explicit Func(Func::AtomicFetchSubExplicit _) noexcept { _inner.tag = AtomicFetchSubExplicit::tag(); }
+    class LC_IR_API AtomicFetchAndExplicit : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicFetchAndExplicit; }
+    };
+    explicit Func(Func::AtomicFetchAndExplicit _) noexcept { _inner.tag = AtomicFetchAndExplicit::tag(); }
+    class LC_IR_API AtomicFetchOrExplicit : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicFetchOrExplicit; }
+    };
+    explicit Func(Func::AtomicFetchOrExplicit _) noexcept { _inner.tag = AtomicFetchOrExplicit::tag(); }
+    class LC_IR_API AtomicFetchXorExplicit : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicFetchXorExplicit; }
+    };
+    explicit Func(Func::AtomicFetchXorExplicit _) noexcept { _inner.tag = AtomicFetchXorExplicit::tag(); }
+    class LC_IR_API AtomicFetchMinExplicit : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicFetchMinExplicit; }
+    };
+    explicit Func(Func::AtomicFetchMinExplicit _) noexcept { _inner.tag = AtomicFetchMinExplicit::tag(); }
+    class LC_IR_API AtomicFetchMaxExplicit : Marker, concepts::Noncopyable {
+        uint8_t _pad;
+    public:
+        static constexpr Tag tag() noexcept { return raw::Func::Tag::AtomicFetchMaxExplicit; }
+    };
+    explicit Func(Func::AtomicFetchMaxExplicit _) noexcept { _inner.tag = AtomicFetchMaxExplicit::tag(); }
     class LC_IR_API BufferRead : Marker, concepts::Noncopyable {
         uint8_t _pad;
     public:
@@ -2132,6 +2192,7 @@ public:
         static constexpr Tag tag() noexcept { return raw::Instruction::Tag::AdScope; }
         [[nodiscard]] auto raw() const noexcept { return &_inner; }
         [[nodiscard]] const Pooled<BasicBlock> &body() const noexcept;
+        [[nodiscard]] const uint32_t &checkpoint_interval() const noexcept;
     };
     class LC_IR_API RayQuery : Marker, concepts::Noncopyable {
         raw::Instruction::RayQuery_Body _inner{};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <luisa/core/stl/memory.h>
+#include <luisa/ast/function.h>
+
+namespace luisa::compute {
+
+namespace detail {
+class FunctionBuilder;
+}// namespace detail
+
+// Converts the kernel to IR, runs the named transforms (e.g., "aggregate_atomics")
+// in order on it, and converts the result back to AST.
+[[nodiscard]] LC_IR_API luisa::shared_ptr<const detail::FunctionBuilder>
+transform_kernel(Function kernel, luisa::span<const char *const> transforms) noexcept;
+
+}// namespace luisa::compute
@@ -15,16 +15,28 @@ namespace luisa::compute {
 
 class Device;
 struct DeviceConfig;
+class DeviceInterface;
 
 namespace detail {
 class ContextImpl;
 }// namespace detail
 
+struct ShaderCacheStatistics {
+    uint64_t hit_count{0u};
+    uint64_t miss_count{0u};
+};
+
 class LC_RUNTIME_API Context {
 
 private:
     luisa::shared_ptr<detail::ContextImpl> _impl;
 
+private:
+    // only backends report to the statistics, through DeviceInterface
+    friend class DeviceInterface;
+    void _report_shader_cache_hit() const noexcept;
+    void _report_shader_cache_miss() const noexcept;
+
 public:
     explicit Context(luisa::shared_ptr<luisa::compute::detail::ContextImpl> impl) noexcept;
     // program_path can be first arg from main entry
@@ -55,6 +67,8 @@ public:
     // program panic when no installed backends compiled
     [[nodiscard]] Device create_default_device() noexcept;
     [[nodiscard]] luisa::vector<luisa::string> backend_device_names(luisa::string_view backend_name) const noexcept;
+    // shader cache hits/misses reported by backends, accumulated over all devices created from this context
+    [[nodiscard]] ShaderCacheStatistics shader_cache_statistics() const noexcept;
 };
 
 }// namespace luisa::compute
@@ -30,6 +30,9 @@ class ByteBuffer;
 template<typename T>
 class SOA;
 
+template<typename T>
+class AoSoA;
+
 template<typename T>
 class Buffer;
 
@@ -221,6 +224,11 @@ public:
         return SOA<T>{*this, size};
     }
 
+    template<typename T>
+    [[nodiscard]] auto create_aosoa(size_t size, uint block_size = 32u) noexcept {
+        return AoSoA<T>{*this, size, block_size};
+    }
+
     template<typename T>
         requires(!is_custom_struct_v<T>)//backend-specific type not allowed
     [[nodiscard]] auto create_sparse_buffer(size_t size) noexcept {
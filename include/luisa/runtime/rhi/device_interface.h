@@ -56,6 +56,11 @@ protected:
     luisa::string _backend_name;
     luisa::shared_ptr<detail::ContextImpl> _ctx_impl;
 
+protected:
+    // for backends with a shader cache, accumulated in Context::shader_cache_statistics()
+    void report_shader_cache_hit() const noexcept;
+    void report_shader_cache_miss() const noexcept;
+
 public:
     explicit DeviceInterface(Context &&ctx) noexcept;
     virtual ~DeviceInterface() noexcept;
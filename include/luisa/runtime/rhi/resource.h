@@ -113,6 +113,14 @@ struct ShaderOption {
     /// \details No shader object will be created if this field is set to
     ///   `true`. This field is useful for AOT compilation.
     bool compile_only{false};
+    /// \brief Whether to aggregate integer atomic additions across warps.
+    /// \details If enabled, `atomic_fetch_add` on integers is rewritten to
+    ///   a single atomic operation per warp (SIMD group) when all active
+    ///   lanes target the same address, which reduces contention on hot
+    ///   counters such as histogram bins and queue tails. This is done by
+    ///   an IR transform, so it has no effects if LuisaCompute is built
+    ///   without the IR module.
+    bool enable_atomic_aggregation{false};
     /// \brief A user-defined name for the shader.
     /// \details If provided, the shader will be read from or written to disk
     ///   via the `BinaryIO` object (passed to backends on device creation)
@@ -224,10 +232,12 @@ struct hash<compute::ShaderOption> {
         constexpr auto enable_fast_math_shift = 1u;
         constexpr auto enable_debug_info_shift = 2u;
         constexpr auto compile_only_shift = 3u;
+        constexpr auto enable_atomic_aggregation_shift = 4u;
         auto opt_hash = hash_value((static_cast<uint>(option.enable_cache) << enable_cache_shift) |
                                        (static_cast<uint>(option.enable_fast_math) << enable_fast_math_shift) |
                                        (static_cast<uint>(option.enable_debug_info) << enable_debug_info_shift) |
-                                       (static_cast<uint>(option.compile_only) << compile_only_shift),
+                                       (static_cast<uint>(option.compile_only) << compile_only_shift) |
+                                       (static_cast<uint>(option.enable_atomic_aggregation) << enable_atomic_aggregation_shift),
                                    seed);
         auto name_hash = hash_value(option.name, seed);
         return hash_combine({opt_hash, name_hash}, seed);
@@ -2,6 +2,7 @@
 
 #ifdef LUISA_ENABLE_IR
 #include <luisa/ir/ir2ast.h>
+#include <luisa/ir/transform.h>
 #endif
 
 #include <luisa/core/basic_types.h>
@@ -24,6 +25,12 @@ class SOA;
 template<typename T>
 class SOAView;
 
+template<typename>
+class AoSoA;
+
+template<typename T>
+class AoSoAView;
+
 namespace detail {
 
 template<typename... Args>
@@ -61,6 +68,11 @@ struct prototype_to_shader_invocation<SOA<T>> {
     using type = SOAView<T>;
 };
 
+template<typename T>
+struct prototype_to_shader_invocation<AoSoA<T>> {
+    using type = AoSoAView<T>;
+};
+
 template<typename T>
 using prototype_to_shader_invocation_t = typename prototype_to_shader_invocation<T>::type;
 
@@ -122,6 +134,12 @@ public:
     template<typename T>
     ShaderInvokeBase &operator<<(SOAView<T> soa) noexcept;
 
+    template<typename T>
+    ShaderInvokeBase &operator<<(const AoSoA<T> &aosoa) noexcept;
+
+    template<typename T>
+    ShaderInvokeBase &operator<<(AoSoAView<T> aosoa) noexcept;
+
     template<typename T>
     ShaderInvokeBase &operator<<(T data) noexcept {
         _encoder.encode_uniform(&data, sizeof(T));
@@ -208,6 +226,19 @@ struct shader_argument_encode_count {
     static constexpr uint value = 1u;
 };
 
+[[nodiscard]] inline ShaderCreationInfo create_shader(DeviceInterface *device,
+                                                      Function kernel,
+                                                      const ShaderOption &option) noexcept {
+#ifdef LUISA_ENABLE_IR
+    if (option.enable_atomic_aggregation) {
+        const char *const transforms[]{"aggregate_atomics"};
+        auto transformed = transform_kernel(kernel, transforms);
+        return device->create_shader(option, transformed->function());
+    }
+#endif
+    return device->create_shader(option, kernel);
+}
+
 }// namespace detail
 
 template<size_t dimension, typename... Args>
@@ -234,7 +265,7 @@ private:
     Shader(DeviceInterface *device,
            Function kernel,
            const ShaderOption &option) noexcept
-        : Shader{device, device->create_shader(option, kernel),
+        : Shader{device, detail::create_shader(device, kernel, option),
                  ShaderDispatchCmdEncoder::compute_uniform_size(kernel.unbound_arguments())} {}
 
 #ifdef LUISA_ENABLE_IR
@@ -3,6 +3,7 @@
 #include <utility>
 
 #include <luisa/core/spin_mutex.h>
+#include <luisa/core/stl/memory.h>
 #include <luisa/runtime/rhi/resource.h>
 #include <luisa/runtime/rhi/stream_tag.h>
 #include <luisa/runtime/stream_event.h>
@@ -10,6 +11,14 @@
 
 namespace luisa::compute {
 
+// Observes the command lists dispatched to a stream, e.g. to time them on the host
+class StreamProfiler {
+public:
+    virtual ~StreamProfiler() noexcept = default;
+    // called before the list is handed to the device, may add callbacks to it
+    virtual void on_dispatch(uint64_t stream_handle, CommandList &list) noexcept = 0;
+};
+
 class LC_RUNTIME_API Stream final : public Resource {
 
 public:
@@ -62,6 +71,7 @@ private:
     friend class Device;
     friend class DStorageExt;
     StreamTag _stream_tag{};
+    luisa::shared_ptr<StreamProfiler> _profiler;
 
 private:
     explicit Stream(DeviceInterface *device, StreamTag stream_tag) noexcept;
@@ -76,6 +86,7 @@ public:
     Stream(Stream const &) noexcept = delete;
     Stream &operator=(Stream &&rhs) noexcept {
         _move_from(std::move(rhs));
+        _profiler = std::move(rhs._profiler);
         return *this;
     }
     Stream &operator=(Stream const &) noexcept = delete;
@@ -92,6 +103,8 @@ public:
     Stream &operator<<(Synchronize &&) noexcept;
     void synchronize() noexcept { _synchronize(); }
     [[nodiscard]] auto stream_tag() const noexcept { return _stream_tag; }
+    // observes every command list dispatched from now on, nullptr to stop
+    void set_profiler(luisa::shared_ptr<StreamProfiler> profiler) noexcept { _profiler = std::move(profiler); }
 
     // compound commands
     template<typename... T>
@@ -76,6 +76,13 @@ typedef enum LCPixelStorage {
     LC_PIXEL_STORAGE_FLOAT4,
 } LCPixelStorage;
 
+typedef enum LCProfilingMark {
+    LC_PROFILING_MARK_WORK_BEGIN,
+    LC_PROFILING_MARK_WORK_END,
+    LC_PROFILING_MARK_COMMAND_BEGIN,
+    LC_PROFILING_MARK_COMMAND_END,
+} LCProfilingMark;
+
 typedef enum LCSamplerAddress {
     LC_SAMPLER_ADDRESS_EDGE,
     LC_SAMPLER_ADDRESS_REPEAT,
@@ -269,11 +276,18 @@ typedef struct LCArgument {
     };
 } LCArgument;
 
+typedef struct LCIndirectDispatchArgument {
+    struct LCBuffer buffer;
+    uint32_t offset;
+    uint32_t max_dispatch_count;
+} LCIndirectDispatchArgument;
+
 typedef struct LCShaderDispatchCommand {
     struct LCShader shader;
     uint32_t dispatch_size[3];
     const struct LCArgument *args;
     size_t args_count;
+    struct LCIndirectDispatchArgument indirect;
 } LCShaderDispatchCommand;
 
 typedef struct LCMesh {
@@ -425,6 +439,11 @@ typedef struct LCCreatedShaderInfo {
     uint32_t block_size[3];
 } LCCreatedShaderInfo;
 
+typedef struct LCShaderArtifact {
+    uint8_t *data;
+    size_t size;
+} LCShaderArtifact;
+
 typedef struct LCCreatedSwapchainInfo {
     struct LCCreatedResourceInfo resource;
     enum LCPixelStorage storage;
@@ -446,11 +465,14 @@ typedef struct LCShaderOption {
 
 typedef void (*LCDispatchCallback)(uint8_t*);
 
+typedef void (*LCProfilingCallback)(uint8_t*, enum LCProfilingMark, size_t);
+
 typedef struct LCDeviceInterface {
     struct LCDevice device;
     void (*destroy_device)(struct LCDeviceInterface);
     struct LCCreatedBufferInfo (*create_buffer)(struct LCDevice, const void*, size_t);
     void (*destroy_buffer)(struct LCDevice, struct LCBuffer);
+    struct LCCreatedBufferInfo (*create_buffer_from_memory)(struct LCDevice, const void*, size_t, void*);
     struct LCCreatedResourceInfo (*create_texture)(struct LCDevice,
                                                    enum LCPixelFormat,
                                                    uint32_t,
@@ -459,6 +481,14 @@ typedef struct LCDeviceInterface {
                                                    uint32_t,
                                                    uint32_t,
                                                    bool);
+    struct LCCreatedResourceInfo (*create_texture_from_memory)(struct LCDevice,
+                                                               enum LCPixelFormat,
+                                                               uint32_t,
+                                                               uint32_t,
+                                                               uint32_t,
+                                                               uint32_t,
+                                                               uint32_t,
+                                                               void*);
     void *(*native_handle)(struct LCDevice);
     uint32_t (*compute_warp_size)(struct LCDevice);
     void (*destroy_texture)(struct LCDevice, struct LCTexture);
@@ -472,6 +502,7 @@ typedef struct LCDeviceInterface {
                      struct LCCommandList,
                      LCDispatchCallback,
                      uint8_t*);
+    bool (*set_stream_profiling)(struct LCDevice, struct LCStream, LCProfilingCallback, uint8_t*);
     struct LCCreatedSwapchainInfo (*create_swapchain)(struct LCDevice,
                                                       uint64_t,
                                                       struct LCStream,
@@ -489,6 +520,13 @@ typedef struct LCDeviceInterface {
                                                 struct LCKernelModule,
                                                 const struct LCShaderOption*);
     void (*destroy_shader)(struct LCDevice, struct LCShader);
+    struct LCShaderArtifact (*shader_artifact)(struct LCDevice, struct LCShader);
+    void (*free_shader_artifact)(struct LCDevice, struct LCShaderArtifact);
+    struct LCCreatedShaderInfo (*create_shader_from_artifact)(struct LCDevice,
+                                                              const uint8_t*,
+                                                              size_t,
+                                                              const struct LCArgument*,
+                                                              size_t);
     struct LCCreatedResourceInfo (*create_event)(struct LCDevice);
     void (*destroy_event)(struct LCDevice, struct LCEvent);
     void (*signal_event)(struct LCDevice, struct LCEvent, struct LCStream, uint64_t);
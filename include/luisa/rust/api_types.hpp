@@ -79,6 +79,13 @@ enum class PixelStorage {
     FLOAT4,
 };
 
+enum class ProfilingMark {
+    WORK_BEGIN,
+    WORK_END,
+    COMMAND_BEGIN,
+    COMMAND_END,
+};
+
 enum class SamplerAddress {
     EDGE,
     REPEAT,
@@ -310,11 +317,18 @@ struct Argument {
     };
 };
 
+struct IndirectDispatchArgument {
+    Buffer buffer;
+    uint32_t offset;
+    uint32_t max_dispatch_count;
+};
+
 struct ShaderDispatchCommand {
     Shader shader;
     uint32_t dispatch_size[3];
     const Argument *args;
     size_t args_count;
+    IndirectDispatchArgument indirect;
 };
 
 struct Mesh {
@@ -492,6 +506,11 @@ struct CreatedShaderInfo {
     uint32_t block_size[3];
 };
 
+struct ShaderArtifact {
+    uint8_t *data;
+    size_t size;
+};
+
 struct CreatedSwapchainInfo {
     CreatedResourceInfo resource;
     PixelStorage storage;
@@ -513,11 +532,14 @@ struct ShaderOption {
 
 using DispatchCallback = void(*)(uint8_t*);
 
+using ProfilingCallback = void(*)(uint8_t*, ProfilingMark, size_t);
+
 struct DeviceInterface {
     Device device;
     void (*destroy_device)(DeviceInterface);
     CreatedBufferInfo (*create_buffer)(Device, const void*, size_t);
     void (*destroy_buffer)(Device, Buffer);
+    CreatedBufferInfo (*create_buffer_from_memory)(Device, const void*, size_t, void*);
     CreatedResourceInfo (*create_texture)(Device,
                                           PixelFormat,
                                           uint32_t,
@@ -526,6 +548,14 @@ struct DeviceInterface {
                                           uint32_t,
                                           uint32_t,
                                           bool);
+    CreatedResourceInfo (*create_texture_from_memory)(Device,
+                                                      PixelFormat,
+                                                      uint32_t,
+                                                      uint32_t,
+                                                      uint32_t,
+                                                      uint32_t,
+                                                      uint32_t,
+                                                      void*);
     void *(*native_handle)(Device);
     uint32_t (*compute_warp_size)(Device);
     void (*destroy_texture)(Device, Texture);
@@ -535,6 +565,7 @@ struct DeviceInterface {
     void (*destroy_stream)(Device, Stream);
     void (*synchronize_stream)(Device, Stream);
     void (*dispatch)(Device, Stream, CommandList, DispatchCallback, uint8_t*);
+    bool (*set_stream_profiling)(Device, Stream, ProfilingCallback, uint8_t*);
     CreatedSwapchainInfo (*create_swapchain)(Device,
                                              uint64_t,
                                              Stream,
@@ -547,6 +578,13 @@ struct DeviceInterface {
     void (*destroy_swapchain)(Device, Swapchain);
     CreatedShaderInfo (*create_shader)(Device, KernelModule, const ShaderOption*);
     void (*destroy_shader)(Device, Shader);
+    ShaderArtifact (*shader_artifact)(Device, Shader);
+    void (*free_shader_artifact)(Device, ShaderArtifact);
+    CreatedShaderInfo (*create_shader_from_artifact)(Device,
+                                                     const uint8_t*,
+                                                     size_t,
+                                                     const Argument*,
+                                                     size_t);
     CreatedResourceInfo (*create_event)(Device);
     void (*destroy_event)(Device, Event);
     void (*signal_event)(Device, Event, Stream, uint64_t);
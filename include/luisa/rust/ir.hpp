@@ -255,6 +255,7 @@ struct Func {
         WarpLaneId,
         DispatchId,
         DispatchSize,
+        KernelId,
         RequiresGradient,
         Backward,
         Gradient,
@@ -410,6 +411,24 @@ struct Func {
         AtomicFetchMin,
         /// (buffer/smem, indices..., val) -> old: stores max(old, val), returns old.
         AtomicFetchMax,
+        /// (buffer/smem, indices..., desired, order) -> old: same as AtomicExchange, with the constant memory order.
+        AtomicExchangeExplicit,
+        /// (buffer/smem, indices..., expected, desired, order) -> old: same as AtomicCompareExchange, with the constant memory order.
+        AtomicCompareExchangeExplicit,
+        /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchAdd, with the constant memory order.
+        AtomicFetchAddExplicit,
+        /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchSub, with the constant memory order.
+        AtomicFetchSubExplicit,
+        /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchAnd, with the constant memory order.
+        AtomicFetchAndExplicit,
+        /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchOr, with the constant memory order.
+        AtomicFetchOrExplicit,
+        /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchXor, with the constant memory order.
+        AtomicFetchXorExplicit,
+        /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchMin, with the constant memory order.
+        AtomicFetchMinExplicit,
+        /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchMax, with the constant memory order.
+        AtomicFetchMaxExplicit,
         /// (buffer, index) -> value: reads the index-th element in buffer
         BufferRead,
         /// (buffer, index, value) -> void: writes value into the indeex
@@ -718,6 +737,7 @@ struct Instruction {
 
     struct AdScope_Body {
         Pooled<BasicBlock> body;
+        uint32_t checkpoint_interval;
     };
 
     struct RayQuery_Body {
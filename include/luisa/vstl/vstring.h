@@ -1,5 +1,6 @@
 #pragma once
 #include <luisa/vstl/config.h>
+#include <bit>
 #include <cstdint>
 #include <string>
 #include <luisa/vstl/hash.h>
@@ -22,6 +23,31 @@ Elem *UIntegral_to_buff(Elem *RNext, UTy UVal) noexcept {// format UVal into buf
     return RNext;
 }
 
+template<class Elem>
+Elem *HexFloat_to_buff(Elem *RNext, double Val) noexcept {// format finite Val as printf's "%a" into buffer *ending at* RNext, needs 24 elements
+    const auto Bits = std::bit_cast<uint64_t>(Val);
+    auto Mantissa = Bits & ((1ull << 52u) - 1u);
+    const auto Biased = static_cast<int>((Bits >> 52u) & 0x7ffu);
+    // subnormals are printed as 0x0.xxxp-1022 and zero as 0x0p+0
+    const auto Exp = Biased != 0 ? Biased - 1023 : (Mantissa != 0 ? -1022 : 0);
+    RNext = UIntegral_to_buff(RNext, static_cast<uint32_t>(Exp < 0 ? -Exp : Exp));
+    *--RNext = static_cast<Elem>(Exp < 0 ? '-' : '+');
+    *--RNext = static_cast<Elem>('p');
+    if (Mantissa != 0) {
+        auto Digits = 13;
+        for (; (Mantissa & 0xfu) == 0; Mantissa >>= 4u) { --Digits; }
+        for (; Digits != 0; --Digits, Mantissa >>= 4u) {
+            *--RNext = static_cast<Elem>("0123456789abcdef"[Mantissa & 0xfu]);
+        }
+        *--RNext = static_cast<Elem>('.');
+    }
+    *--RNext = static_cast<Elem>(Biased != 0 ? '1' : '0');
+    *--RNext = static_cast<Elem>('x');
+    *--RNext = static_cast<Elem>('0');
+    if (Bits >> 63u) { *--RNext = static_cast<Elem>('-'); }
+    return RNext;
+}
+
 template<class Ty>
 inline void IntegerToString(const Ty Val, string &str, bool negative = false) noexcept {// convert Val to string
     static_assert(std::is_integral_v<Ty>, "_Ty must be integral");
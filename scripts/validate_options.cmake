@@ -72,10 +72,9 @@ if (LUISA_COMPUTE_ENABLE_VULKAN)
     endif ()
 endif ()
 
-if (LUISA_COMPUTE_ENABLE_CPU OR LUISA_COMPUTE_ENABLE_REMOTE)
+if (LUISA_COMPUTE_ENABLE_CPU)
     if (NOT LUISA_COMPUTE_ENABLE_RUST)
         report_feature_not_available(CPU "CPU backend")
-        report_feature_not_available(REMOTE "Remote backend")
     endif ()
 endif ()
 
@@ -143,9 +143,12 @@ before_check(function(option)
 	end
 
 	-- checking vulkan
-	local vk_path = os.getenv("VULKAN_SDK")
+	local vk_path = os.getenv("VULKAN_SDK") or os.getenv("VK_SDK_PATH")
+	-- Linux distributions install the Vulkan headers and loader without an SDK
+	if not vk_path and is_host("linux") and os.isfile("/usr/include/vulkan/vulkan.h") then
+		vk_path = "/usr"
+	end
 	if not vk_path then
-		vk_path = os.getenv("VK_SDK_PATH")
 		local vk_backend = option:dep("vk_backend")
 		if vk_backend:enabled() then
 			vk_backend:enable(false, {
@@ -166,9 +169,11 @@ rule("lc_vulkan")
 on_load(function(target)
 	local vk_path = get_config("_lc_vk_path")
 	if is_plat("linux", "macosx") then
-		target:add("linkdirs", path.join(vk_path, "lib"))
+		if vk_path ~= "/usr" then
+			target:add("linkdirs", path.join(vk_path, "lib"))
+			target:add("includedirs", path.join(vk_path, "include"))
+		end
 		target:add("links", "vulkan")
-		target:add("includedirs", path.join(vk_path, "include"))
 	else
 		target:add("linkdirs", path.join(vk_path, "Lib"))
 		target:add("links", "vulkan-1")
@@ -644,10 +644,27 @@ LUISA_EXPORT_API LCDeviceInterface luisa_compute_device_interface_create(LCConte
     interface.synchronize_event = luisa_compute_event_synchronize;
     interface.create_shader = luisa_compute_shader_create;
     interface.destroy_shader = luisa_compute_shader_destroy;
+    // shader artifacts are managed by the native backends' own caches
+    interface.shader_artifact = [](LCDevice, LCShader) -> LCShaderArtifact {
+        return LCShaderArtifact{.data = nullptr, .size = 0u};
+    };
+    interface.free_shader_artifact = [](LCDevice, LCShaderArtifact) {};
+    interface.create_shader_from_artifact = [](LCDevice, const uint8_t *, size_t,
+                                               const LCArgument *, size_t) -> LCCreatedShaderInfo {
+        return LCCreatedShaderInfo{
+            .resource = LCCreatedResourceInfo{
+                .handle = UINT64_MAX,
+                .native_handle = nullptr,
+            },
+            .block_size = {0u, 0u, 0u},
+        };
+    };
     interface.create_stream = luisa_compute_stream_create;
     interface.synchronize_stream = luisa_compute_stream_synchronize;
     interface.destroy_stream = luisa_compute_stream_destroy;
     interface.dispatch = luisa_compute_stream_dispatch;
+    // per-command progress is only reported by the Rust backends
+    interface.set_stream_profiling = [](LCDevice, LCStream, LCProfilingCallback, uint8_t *) { return false; };
     interface.create_mesh = luisa_compute_mesh_create;
     interface.destroy_mesh = luisa_compute_mesh_destroy;
     interface.create_accel = luisa_compute_accel_create;
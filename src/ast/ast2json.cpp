@@ -935,6 +935,7 @@ private:
     }
     void _convert_autodiff_stmt(JSON &j, const AutoDiffStmt *stmt) noexcept {
         j["body"] = _convert_stmt(stmt->body());
+        j["checkpoint_interval"] = stmt->checkpoint_interval();
     }
 
 public:
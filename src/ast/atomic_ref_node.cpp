@@ -30,10 +30,17 @@ const Expression *AtomicRefNode::operate(
                  "Only atomic operations are allowed "
                  "on AtomicRefNode (got {}).",
                  to_string(op));
-    LUISA_ASSERT((op == CallOp::ATOMIC_COMPARE_EXCHANGE && values.size() == 2u) ||
-                     (op != CallOp::ATOMIC_COMPARE_EXCHANGE && values.size() == 1u),
+    LUISA_ASSERT(values.size() == atomic_operation_value_count(op),
                  "Invalid number of arguments for atomic operation {} (got {}).",
                  to_string(op), values.size());
+    const Expression *order = nullptr;
+    if (is_explicit_atomic_operation(op)) {
+        order = values.back();
+        LUISA_ASSERT(order->tag() == Expression::Tag::LITERAL && order->type()->is_uint32(),
+                     "Memory order of atomic operation {} must be a uint literal.",
+                     to_string(op));
+        values = values.subspan(0u, values.size() - 1u);
+    }
     luisa::fixed_vector<const Expression *, 16u> args;
     for (auto node = this; node != nullptr; node = node->_parent) {
         args.emplace_back(node->_value);
@@ -98,6 +105,7 @@ const Expression *AtomicRefNode::operate(
                      type->description());
         args.emplace_back(value);
     }
+    if (order != nullptr) { args.emplace_back(order); }
 
     // create atomic call
     return FunctionBuilder::current()->call(type, op, luisa::span{args});
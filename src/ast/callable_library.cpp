@@ -467,10 +467,12 @@ void CallableLibrary::deser_ptr(CommentStmt *obj, std::byte const *&ptr, DeserPa
 template<>
 void CallableLibrary::ser_value(AutoDiffStmt const &t, luisa::vector<std::byte> &vec) noexcept {
     ser_value<Statement>(t._body, vec);
+    ser_value(t._checkpoint_interval, vec);
 }
 template<>
 void CallableLibrary::deser_ptr(AutoDiffStmt *obj, std::byte const *&ptr, DeserPackage &pack) noexcept {
     deser_ptr<Statement *>(&obj->_body, ptr, pack);
+    obj->_checkpoint_interval = deser_value<uint32_t>(ptr, pack);
 }
 template<>
 void CallableLibrary::ser_value(RayQueryStmt const &t, luisa::vector<std::byte> &vec) noexcept {
@@ -705,10 +707,12 @@ void CallableLibrary::deserialize_func_builder(detail::FunctionBuilder &builder,
 void CallableLibrary::serialize_func_builder(detail::FunctionBuilder const &builder, luisa::vector<std::byte> &vec) noexcept {
     using namespace detail;
     using namespace std::string_view_literals;
-    LUISA_ASSERT(builder.tag() == Function::Tag::CALLABLE, "Only callable can be serialized.");
-    for (auto &&i : builder._bound_arguments) {
-        LUISA_ASSERT(luisa::holds_alternative<luisa::monostate>(i),
-                     "Callable cannot contain bound-argument.");
+    LUISA_ASSERT(builder.tag() != Function::Tag::RASTER_STAGE, "Raster stage cannot be serialized.");
+    if (builder.tag() == Function::Tag::CALLABLE) {
+        for (auto &&i : builder._bound_arguments) {
+            LUISA_ASSERT(luisa::holds_alternative<luisa::monostate>(i),
+                         "Callable cannot contain bound-argument.");
+        }
     }
     LUISA_ASSERT(builder._used_external_functions.empty(), "Callable cannot contain external-function.");
     // return type
@@ -830,6 +834,89 @@ luisa::vector<std::byte> CallableLibrary::serialize() const noexcept {
     }
     return vec;
 }
+luisa::vector<std::byte> CallableLibrary::serialize_kernel(Function kernel) noexcept {
+    LUISA_ASSERT(kernel.tag() == Function::Tag::KERNEL, "Only kernel can be serialized.");
+    auto builder = kernel.builder();
+    LUISA_ASSERT(builder->_cpu_callbacks.empty(), "Kernel cannot contain cpu-callback.");
+    // all callables used directly or indirectly
+    luisa::vector<const detail::FunctionBuilder *> callables;
+    luisa::unordered_set<uint64_t> visited;
+    auto collect = [&](auto &&self, const detail::FunctionBuilder *f) noexcept -> void {
+        for (auto &&i : f->_used_custom_callables) {
+            if (visited.emplace(i->hash()).second) {
+                callables.emplace_back(i.get());
+                self(self, i.get());
+            }
+        }
+    };
+    collect(collect, builder);
+    luisa::vector<std::byte> vec;
+    ser_value(callables.size(), vec);
+    for (auto &&i : callables) {
+        ser_value(i->hash(), vec);
+    }
+    for (auto &&i : callables) {
+        ser_value(i->hash(), vec);
+        serialize_func_builder(*i, vec);
+    }
+    // kernel
+    ser_value(builder->hash(), vec);
+    serialize_func_builder(*builder, vec);
+    ser_value(builder->_block_size, vec);
+    ser_value(builder->_bound_arguments.size(), vec);
+    for (auto &&i : builder->_bound_arguments) {
+        ser_value(i.index(), vec);
+        luisa::visit(
+            [&]<typename T>(T const &b) {
+                if constexpr (!std::is_same_v<T, luisa::monostate>) {
+                    ser_value(b, vec);
+                }
+            },
+            i);
+    }
+    return vec;
+}
+luisa::shared_ptr<const detail::FunctionBuilder> CallableLibrary::deserialize_kernel(luisa::span<const std::byte> binary) noexcept {
+    DeserPackage pack;
+    auto ptr = binary.data();
+    auto callable_size = deser_value<size_t>(ptr, pack);
+    pack.callable_map.reserve(callable_size);
+    for (size_t i = 0; i < callable_size; ++i) {
+        auto hash = deser_value<uint64_t>(ptr, pack);
+        auto func = luisa::make_unique<detail::FunctionBuilder>();
+        func->_hash = hash;
+        func->_hash_computed = true;
+        pack.callable_map.try_emplace(hash, std::move(func));
+    }
+    for (size_t i = 0; i < callable_size; ++i) {
+        auto hash = deser_value<uint64_t>(ptr, pack);
+        auto iter = pack.callable_map.find(hash);
+        LUISA_ASSERT(iter != pack.callable_map.end(), "Illegal bin-data.");
+        pack.builder = iter->second.get();
+        deserialize_func_builder(*iter->second, ptr, pack);
+    }
+    auto kernel = luisa::make_shared<detail::FunctionBuilder>();
+    kernel->_hash = deser_value<uint64_t>(ptr, pack);
+    kernel->_hash_computed = true;
+    pack.builder = kernel.get();
+    deserialize_func_builder(*kernel, ptr, pack);
+    kernel->_block_size = deser_value<uint3>(ptr, pack);
+    kernel->_bound_arguments.clear();
+    auto bound_size = deser_value<size_t>(ptr, pack);
+    kernel->_bound_arguments.reserve(bound_size);
+    for (size_t i = 0; i < bound_size; ++i) {
+        switch (deser_value<size_t>(ptr, pack)) {
+            case 0: kernel->_bound_arguments.emplace_back(luisa::monostate{}); break;
+            case 1: kernel->_bound_arguments.emplace_back(deser_value<Function::BufferBinding>(ptr, pack)); break;
+            case 2: kernel->_bound_arguments.emplace_back(deser_value<Function::TextureBinding>(ptr, pack)); break;
+            case 3: kernel->_bound_arguments.emplace_back(deser_value<Function::BindlessArrayBinding>(ptr, pack)); break;
+            case 4: kernel->_bound_arguments.emplace_back(deser_value<Function::AccelBinding>(ptr, pack)); break;
+            default: LUISA_ERROR("Illegal bin-data.");
+        }
+    }
+    LUISA_ASSERT(ptr == binary.data() + binary.size(), "Illegal bin-data.");
+    return kernel;
+}
 void CallableLibrary::add_callable(luisa::string_view name, luisa::shared_ptr<const detail::FunctionBuilder> callable) noexcept {
     _callables.try_emplace(name, std::move(callable));
 }
@@ -59,6 +59,15 @@ void CallExpr::_mark() const noexcept {
             case CallOp::ATOMIC_FETCH_XOR:
             case CallOp::ATOMIC_FETCH_MIN:
             case CallOp::ATOMIC_FETCH_MAX:
+            case CallOp::ATOMIC_EXCHANGE_EXPLICIT:
+            case CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT:
+            case CallOp::ATOMIC_FETCH_ADD_EXPLICIT:
+            case CallOp::ATOMIC_FETCH_SUB_EXPLICIT:
+            case CallOp::ATOMIC_FETCH_AND_EXPLICIT:
+            case CallOp::ATOMIC_FETCH_OR_EXPLICIT:
+            case CallOp::ATOMIC_FETCH_XOR_EXPLICIT:
+            case CallOp::ATOMIC_FETCH_MIN_EXPLICIT:
+            case CallOp::ATOMIC_FETCH_MAX_EXPLICIT:
             case CallOp::INDIRECT_SET_DISPATCH_KERNEL:
             case CallOp::INDIRECT_SET_DISPATCH_COUNT:
                 _arguments[0]->mark(Usage::WRITE);
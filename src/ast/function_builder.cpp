@@ -100,8 +100,8 @@ RayQueryStmt *FunctionBuilder::ray_query_(const RefExpr *query) noexcept {
     return _create_and_append_statement<RayQueryStmt>(query);
 }
 
-AutoDiffStmt *FunctionBuilder::autodiff_() noexcept {
-    return _create_and_append_statement<AutoDiffStmt>();
+AutoDiffStmt *FunctionBuilder::autodiff_(uint checkpoint_interval) noexcept {
+    return _create_and_append_statement<AutoDiffStmt>(checkpoint_interval);
 }
 
 IfStmt *FunctionBuilder::if_(const Expression *cond) noexcept {
@@ -520,7 +520,9 @@ void FunctionBuilder::call(luisa::shared_ptr<const ExternalFunction> func,
 
 // call custom functions
 const CallExpr *FunctionBuilder::call(const Type *type, Function custom, luisa::span<const Expression *const> args) noexcept {
-    if (custom.tag() != Function::Tag::CALLABLE) {
+    // raster stages may only be called from kernels that emulate the raster pipeline (e.g., on the CPU)
+    if (custom.tag() != Function::Tag::CALLABLE &&
+        !(custom.tag() == Function::Tag::RASTER_STAGE && _allows_raster_stage_calls)) {
         LUISA_ERROR_WITH_LOCATION(
             "Calling non-callable function in device code.");
     }
@@ -649,6 +651,12 @@ bool FunctionBuilder::requires_autodiff() const noexcept {
     return _propagated_builtin_callables.uses_autodiff();
 }
 
+void FunctionBuilder::allow_raster_stage_calls() noexcept {
+    LUISA_ASSERT(_tag == Function::Tag::KERNEL,
+                 "Only kernels may call raster stages.");
+    _allows_raster_stage_calls = true;
+}
+
 void FunctionBuilder::sort_bindings() noexcept {
     luisa::vector<Variable> new_args;
     luisa::vector<Binding> new_bindings;
@@ -91,7 +91,7 @@ uint64_t RayQueryStmt::_compute_hash() const noexcept {
 }
 
 uint64_t AutoDiffStmt::_compute_hash() const noexcept {
-    return _body.hash();
+    return hash_combine({_body.hash(), luisa::hash_value(_checkpoint_interval)});
 }
 
 void StmtVisitor::visit(const AutoDiffStmt *stmt) {
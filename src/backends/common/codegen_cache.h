@@ -0,0 +1,46 @@
+#pragma once
+
+#include <mutex>
+
+#include <luisa/core/stl/string.h>
+#include <luisa/core/stl/unordered_map.h>
+
+#include "string_scratch.h"
+
+namespace luisa::compute {
+
+// Caches generated source snippets that only depend on their key, e.g., struct
+// declarations keyed by type hash or callables keyed by function hash, so that
+// kernels sharing them replay the text instead of walking the AST again.
+class CodegenCache {
+
+public:
+    static constexpr auto capacity = 64_M;
+
+private:
+    std::mutex _mutex;
+    luisa::unordered_map<uint64_t, luisa::string> _snippets;
+    size_t _size{0u};
+
+public:
+    // appends the snippet recorded for the key to the scratch, returns false if there is none
+    [[nodiscard]] bool replay(uint64_t key, StringScratch &scratch) noexcept {
+        std::scoped_lock lock{_mutex};
+        if (auto iter = _snippets.find(key); iter != _snippets.end()) {
+            scratch << iter->second;
+            return true;
+        }
+        return false;
+    }
+    // records the text emitted to the scratch since the offset as the snippet of the key
+    void record(uint64_t key, const StringScratch &scratch, size_t offset) noexcept {
+        auto snippet = scratch.string_view().substr(offset);
+        std::scoped_lock lock{_mutex};
+        if (_size + snippet.size() <= capacity &&
+            _snippets.try_emplace(key, snippet).second) {
+            _size += snippet.size();
+        }
+    }
+};
+
+}// namespace luisa::compute
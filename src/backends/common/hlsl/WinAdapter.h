@@ -0,0 +1,126 @@
+#pragma once
+// The subset of DXC's WinAdapter.h needed by dxcapi.h on non-Windows platforms,
+// so that libdxcompiler can be loaded without the Windows SDK.
+// IUnknown must keep the vtable layout libdxcompiler is built with (no virtual destructor).
+#ifndef _WIN32
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+#include <type_traits>
+
+#define STDMETHODCALLTYPE
+#ifndef __stdcall
+#define __stdcall
+#endif
+
+// SAL annotations
+#define _In_
+#define _In_z_
+#define _In_opt_
+#define _In_opt_z_
+#define _In_count_(x)
+#define _In_opt_count_(x)
+#define _In_bytecount_(x)
+#define _Out_
+#define _Outptr_result_z_
+#define _Outptr_opt_result_z_
+#define _Outptr_result_nullonfailure_
+#define _COM_Outptr_
+#define _COM_Outptr_opt_
+#define _COM_Outptr_result_maybenull_
+#define _COM_Outptr_opt_result_maybenull_
+#define _Maybenull_
+
+typedef unsigned char BYTE;
+typedef bool BOOL;
+typedef int INT;
+typedef unsigned int UINT;
+typedef long LONG;
+typedef unsigned long ULONG;
+typedef uint32_t UINT32;
+typedef uint64_t UINT64;
+typedef size_t SIZE_T;
+typedef int32_t HRESULT;
+typedef void *LPVOID;
+typedef const void *LPCVOID;
+typedef char *LPSTR;
+typedef const char *LPCSTR;
+typedef wchar_t WCHAR;
+typedef wchar_t *LPWSTR;
+typedef const wchar_t *LPCWSTR;
+typedef wchar_t *BSTR;
+
+#define S_OK ((HRESULT)0L)
+#define S_FALSE ((HRESULT)1L)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#define TRUE true
+#define FALSE false
+
+struct GUID {
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t Data4[8];
+};
+typedef GUID IID;
+typedef GUID CLSID;
+typedef const GUID &REFGUID;
+typedef const IID &REFIID;
+typedef const CLSID &REFCLSID;
+
+inline bool operator==(REFGUID a, REFGUID b) noexcept {
+    if (a.Data1 != b.Data1 || a.Data2 != b.Data2 || a.Data3 != b.Data3) return false;
+    for (auto i = 0; i < 8; i++) {
+        if (a.Data4[i] != b.Data4[i]) return false;
+    }
+    return true;
+}
+inline bool operator!=(REFGUID a, REFGUID b) noexcept { return !(a == b); }
+
+namespace lc::hlsl::detail {
+// parses "XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX"
+[[nodiscard]] constexpr uint8_t guid_nibble(char c) noexcept {
+    return c >= '0' && c <= '9' ? c - '0' :
+           c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                                  c - 'A' + 10;
+}
+[[nodiscard]] constexpr uint64_t guid_hex(const char *s, size_t digits) noexcept {
+    uint64_t value = 0u;
+    for (auto i = 0u; i < digits; i++) { value = (value << 4u) | guid_nibble(s[i]); }
+    return value;
+}
+[[nodiscard]] constexpr GUID guid_from_string(const char *s) noexcept {
+    GUID guid{static_cast<uint32_t>(guid_hex(s, 8u)),
+              static_cast<uint16_t>(guid_hex(s + 9u, 4u)),
+              static_cast<uint16_t>(guid_hex(s + 14u, 4u)),
+              {}};
+    for (auto i = 0u; i < 2u; i++) { guid.Data4[i] = static_cast<uint8_t>(guid_hex(s + 19u + i * 2u, 2u)); }
+    for (auto i = 0u; i < 6u; i++) { guid.Data4[i + 2u] = static_cast<uint8_t>(guid_hex(s + 24u + i * 2u, 2u)); }
+    return guid;
+}
+}// namespace lc::hlsl::detail
+
+template<typename T>
+inline const GUID &__emulated_uuidof() noexcept;
+
+#define CROSS_PLATFORM_UUIDOF(iface, spec)                                                 \
+    struct iface;                                                                         \
+    template<>                                                                            \
+    inline const GUID &__emulated_uuidof<iface>() noexcept {                              \
+        static constexpr GUID uuid = ::lc::hlsl::detail::guid_from_string(spec);          \
+        return uuid;                                                                      \
+    }
+
+#define __uuidof(T) __emulated_uuidof<std::remove_cv_t<std::remove_reference_t<decltype(T)>>>()
+#define IID_PPV_ARGS(pp) __uuidof(**(pp)), reinterpret_cast<void **>(pp)
+
+CROSS_PLATFORM_UUIDOF(IUnknown, "00000000-0000-0000-C000-000000000046")
+struct IUnknown {
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **ppvObject) = 0;
+    virtual ULONG STDMETHODCALLTYPE AddRef() = 0;
+    virtual ULONG STDMETHODCALLTYPE Release() = 0;
+};
+
+struct IStream;
+#endif
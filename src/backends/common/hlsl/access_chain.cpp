@@ -3,14 +3,15 @@
 namespace lc::hlsl {
 AccessChain::AccessChain(
     CallOp op,
+    MemoryOrder order,
     Variable const &root_var,
-    luisa::span<Expression const *const> exprs) : _op{op}, _root_var{root_var}, _nodes{nodes_from_exprs(exprs)} {
+    luisa::span<Expression const *const> exprs) : _op{op}, _order{order}, _root_var{root_var}, _nodes{nodes_from_exprs(exprs)} {
     _hash = _get_hash();
 }
 void AccessChain::init_name() {
     vstd::vector<uint8_t> bin_vecs;
     auto desc = _root_var.type()->description();
-    size_t basic_size = desc.size() + sizeof(CallOp);
+    size_t basic_size = desc.size() + sizeof(CallOp) + sizeof(MemoryOrder);
     if (_root_var.is_shared()) {
         uint uid = _root_var.uid();
         bin_vecs.push_back_uninitialized(basic_size + sizeof(uint));
@@ -21,6 +22,8 @@ void AccessChain::init_name() {
     auto ptr = bin_vecs.data();
     *reinterpret_cast<CallOp *>(ptr) = _op;
     ptr += sizeof(CallOp);
+    *reinterpret_cast<MemoryOrder *>(ptr) = _order;
+    ptr += sizeof(MemoryOrder);
     memcpy(ptr, desc.data(), desc.size());
 
     for (auto &&i : _nodes) {
@@ -39,10 +42,11 @@ void AccessChain::init_name() {
 }
 size_t AccessChain::_get_hash() const {
     auto hash_value = luisa::hash<CallOp>{}(_op);
+    hash_value = luisa::hash<uint>{}(luisa::to_underlying(_order), hash_value);
     if (_root_var.is_shared()) {
-        hash_value = luisa::hash<size_t>{}(_root_var.uid());
+        hash_value = luisa::hash<size_t>{}(_root_var.uid(), hash_value);
     } else {
-        hash_value = luisa::hash<size_t>{}(reinterpret_cast<size_t>(_root_var.type()));
+        hash_value = luisa::hash<size_t>{}(reinterpret_cast<size_t>(_root_var.type()), hash_value);
     }
     for (auto &&i : _nodes) {
         hash_value = luisa::hash<size_t>{}(i.index(), hash_value);
@@ -55,7 +59,7 @@ size_t AccessChain::_get_hash() const {
     return hash_value;
 }
 bool AccessChain::operator==(AccessChain const &node) const {
-    if (_op != node._op || node._nodes.size() != _nodes.size())
+    if (_op != node._op || _order != node._order || node._nodes.size() != _nodes.size())
         return false;
     if (_root_var.is_shared()) {
         if (node._root_var != _root_var) return false;
@@ -176,12 +180,27 @@ void AccessChain::gen_func_impl(CodegenUtility *util, TemplateFunction const &tm
         build_other_arguments();
     }
     builder << "){\n"sv;
+    // Interlocked functions are relaxed, so a release fences before the operation,
+    // and an acquire fences after it, before every return of the template
+    auto release = _order == MemoryOrder::RELEASE || _order == MemoryOrder::ACQ_REL || _order == MemoryOrder::SEQ_CST;
+    auto acquire = _order == MemoryOrder::ACQUIRE || _order == MemoryOrder::ACQ_REL || _order == MemoryOrder::SEQ_CST;
+    if (release) { builder << "DeviceMemoryBarrier();\n"sv; }
     std::bitset<std::numeric_limits<char>::max()> bitsets;
     bitsets[tmp.access_place] = true;
     bitsets[tmp.args_place] = true;
     bitsets[tmp.temp_type_place] = true;
-    for (auto &&i : tmp.body) {
-        if (bitsets[i]) {
+    // returns may be the bodies of ifs, so the fence and the return are braced together
+    auto in_return = false;
+    for (auto idx : vstd::range(tmp.body.size())) {
+        auto i = tmp.body[idx];
+        if (acquire && tmp.body.substr(idx).starts_with("return"sv)) {
+            builder << "{DeviceMemoryBarrier();"sv;
+            in_return = true;
+        }
+        if (in_return && i == ';') {
+            builder << ";}"sv;
+            in_return = false;
+        } else if (bitsets[i]) {
             if (i == tmp.access_place) {
                 builder << chain_str;
             } else if (i == tmp.args_place) {
@@ -30,6 +30,8 @@ public:
 
 private:
     CallOp _op;
+    // fences placed around the Interlocked functions, see MemoryOrder
+    MemoryOrder _order;
     Variable _root_var;
     vstd::vector<Node> _nodes;
     size_t _hash;
@@ -40,6 +42,7 @@ private:
 public:
     AccessChain(
         CallOp op,
+        MemoryOrder order,
         Variable const &root_var,
         luisa::span<Expression const *const> access_expr);
     AccessChain(AccessChain const &) = delete;
@@ -29,6 +29,9 @@ void CodegenStackData::Clear() {
     customStruct.clear();
     atomicsFuncs.clear();
     sharedVariable.clear();
+    codegenData.clear();
+    varData.clear();
+    incrementalFuncData.clear();
     constCount = 0;
     argOffset = 0;
     appdataId = -1;
@@ -179,6 +182,7 @@ if(r==old) return old;
 }})"sv;
 AccessChain const &CodegenStackData::GetAtomicFunc(
     CallOp op,
+    MemoryOrder order,
     Variable const &rootVar,
     Type const *retType,
     luisa::span<Expression const *const> exprs) {
@@ -245,6 +249,7 @@ AccessChain const &CodegenStackData::GetAtomicFunc(
 
     AccessChain chain{
         op,
+        order,
         rootVar,
         exprs.subspan(0, exprs.size() - extra_arg_size)};
     auto iter = atomicsFuncs.emplace(std::move(chain));
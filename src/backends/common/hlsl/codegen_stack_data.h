@@ -41,11 +41,16 @@ struct CodegenStackData : public vstd::IOperatorNewBase {
     vstd::unordered_map<vstd::string, vstd::string, vstd::hash<vstd::StringBuilder>> structReplaceName;
     vstd::unordered_map<uint64, Variable> sharedVariable;
     vstd::unordered_set<AccessChain, AccessHash> atomicsFuncs;
+    // scratch builders of Codegen, cleared but not freed between kernels
+    vstd::StringBuilder codegenData;
+    vstd::StringBuilder varData;
+    vstd::StringBuilder incrementalFuncData;
     Expression const *tempSwitchExpr;
     size_t tempSwitchCounter = 0;
     CodegenStackData();
     AccessChain const &GetAtomicFunc(
         CallOp op,
+        MemoryOrder order,
         Variable const &rootVar,
         Type const *retType,
         luisa::span<Expression const *const> exprs);
@@ -221,14 +221,15 @@ struct PrintValue<ushort> {
 template<>
 struct PrintValue<int> {
     void operator()(int const &v, vstd::StringBuilder &str) {
-        str.append(luisa::format("{}", v));
+        vstd::to_string(v, str);
     }
 };
 
 template<>
 struct PrintValue<uint> {
     void operator()(uint const &v, vstd::StringBuilder &str) {
-        str.append(luisa::format("{}u", v));
+        vstd::to_string(v, str);
+        str << 'u';
     }
 };
 
@@ -689,10 +689,28 @@ void CodegenUtility::GetFunctionName(CallExpr const *expr, vstd::StringBuilder &
         case CallOp::ATOMIC_FETCH_OR:
         case CallOp::ATOMIC_FETCH_XOR:
         case CallOp::ATOMIC_FETCH_MIN:
-        case CallOp::ATOMIC_FETCH_MAX: {
-            auto rootVar = static_cast<RefExpr const *>(args[0]);
-            auto &chain = opt->GetAtomicFunc(expr->op(), rootVar->variable(), expr->type(), args);
-            chain.call_this_func(args, str, vis);
+        case CallOp::ATOMIC_FETCH_MAX:
+        case CallOp::ATOMIC_EXCHANGE_EXPLICIT:
+        case CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT:
+        case CallOp::ATOMIC_FETCH_ADD_EXPLICIT:
+        case CallOp::ATOMIC_FETCH_SUB_EXPLICIT:
+        case CallOp::ATOMIC_FETCH_AND_EXPLICIT:
+        case CallOp::ATOMIC_FETCH_OR_EXPLICIT:
+        case CallOp::ATOMIC_FETCH_XOR_EXPLICIT:
+        case CallOp::ATOMIC_FETCH_MIN_EXPLICIT:
+        case CallOp::ATOMIC_FETCH_MAX_EXPLICIT: {
+            // Interlocked functions take no memory order, so the trailing order of explicit atomics
+            // becomes fences in the generated function, as the Interlocked functions are relaxed
+            auto order = MemoryOrder::RELAXED;
+            auto atomic_args = args;
+            if (is_explicit_atomic_operation(expr->op())) {
+                auto literal = static_cast<LiteralExpr const *>(args.back())->value();
+                order = static_cast<MemoryOrder>(luisa::get<uint>(literal));
+                atomic_args = args.subspan(0, args.size() - 1);
+            }
+            auto rootVar = static_cast<RefExpr const *>(atomic_args[0]);
+            auto &chain = opt->GetAtomicFunc(implicit_atomic_operation(expr->op()), order, rootVar->variable(), expr->type(), atomic_args);
+            chain.call_this_func(atomic_args, str, vis);
             return;
         }
         case CallOp::TEXTURE_READ:
@@ -1900,9 +1918,9 @@ CodegenResult CodegenUtility::Codegen(
     opt->kernel = kernel;
     bool nonEmptyCbuffer = IsCBufferNonEmpty(kernel);
 
-    vstd::StringBuilder codegenData;
-    vstd::StringBuilder varData;
-    vstd::StringBuilder incrementalFunc;
+    auto &codegenData = opt->codegenData;
+    auto &varData = opt->varData;
+    auto &incrementalFunc = opt->incrementalFuncData;
     vstd::StringBuilder finalResult;
     opt->incrementalFunc = &incrementalFunc;
     finalResult.reserve(65500);
@@ -1932,6 +1950,7 @@ uint4 dsp_c;
     PreprocessCodegenProperties(properties, varData, indexer, internalDataPath, nonEmptyCbuffer, false, isSpirV);
     CodegenProperties(properties, varData, kernel, 0, indexer);
     PostprocessCodegenProperties(finalResult);
+    finalResult.reserve(finalResult.size() + varData.size() + incrementalFunc.size() + codegenData.size());
     finalResult << varData << incrementalFunc << codegenData;
     return {
         std::move(finalResult),
@@ -1958,10 +1977,10 @@ CodegenResult CodegenUtility::RasterCodegen(
         opt->isRaster = false;
         CodegenStackData::DeAllocate(std::move(opt));
     });
-    vstd::StringBuilder codegenData;
-    vstd::StringBuilder varData;
+    auto &codegenData = opt->codegenData;
+    auto &varData = opt->varData;
+    auto &incrementalFunc = opt->incrementalFuncData;
     vstd::StringBuilder finalResult;
-    vstd::StringBuilder incrementalFunc;
     opt->incrementalFunc = &incrementalFunc;
     finalResult.reserve(65500);
     auto opSet = vertFunc.propagated_builtin_callables();
@@ -2103,6 +2122,7 @@ uint iid:SV_INSTANCEID;
     CodegenProperties(properties, varData, vertFunc, 1, indexer);
     CodegenProperties(properties, varData, pixelFunc, 1, indexer);
     PostprocessCodegenProperties(finalResult);
+    finalResult.reserve(finalResult.size() + varData.size() + incrementalFunc.size() + codegenData.size());
     finalResult << varData << incrementalFunc << codegenData;
     return {
         std::move(finalResult),
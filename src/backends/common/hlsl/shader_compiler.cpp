@@ -10,7 +10,7 @@ namespace lc::hlsl {
         LUISA_ASSERT(hr_ == S_OK, "bad HRESULT."); \
     }
 #endif
-DxcByteBlob::DxcByteBlob(ComPtr<IDxcBlob> &&b)
+DxcByteBlob::DxcByteBlob(DxcPtr<IDxcBlob> &&b)
     : blob(std::move(b)) {}
 std::byte *DxcByteBlob::data() const {
     return reinterpret_cast<std::byte *>(blob->GetBufferPointer());
@@ -30,28 +30,36 @@ static vstd::wstring GetSM(uint shaderModel) {
 }
 IDxcCompiler3 *ShaderCompiler::compiler() {
     std::lock_guard lck{moduleInstantiateMtx};
-    if (module) return module->comp.Get();
+    if (module) return module->comp.get();
     module.create(path);
-    return module->comp.Get();
+    return module->comp.get();
 }
 ShaderCompiler::~ShaderCompiler() {}
 ShaderCompilerModule::ShaderCompilerModule(std::filesystem::path const &path)
     : dxil(luisa::DynamicModule::load(path, "dxil")),
       dxcCompiler(luisa::DynamicModule::load(path, "dxcompiler")) {
+#ifdef _WIN32
     if (!dxil) {
         LUISA_ERROR("dxil.dll not found.");
     }
+#endif
+    // the libdxcompiler of Linux is shipped without dxil (it does not sign DXIL),
+    // and is usually installed with the Vulkan SDK rather than next to the runtime
+    if (!dxcCompiler) {
+        dxcCompiler = luisa::DynamicModule::load("dxcompiler");
+    }
     if (!dxcCompiler) {
-        LUISA_ERROR("dxcompiler.dll not found.");
+        LUISA_ERROR("dxcompiler not found in '{}' or the system library paths.", luisa::to_string(path));
+    }
+    auto create_instance = reinterpret_cast<DxcCreateInstanceProc>(dxcCompiler.address("DxcCreateInstance"sv));
+    if (create_instance == nullptr ||
+        create_instance(CLSID_DxcCompiler, IID_PPV_ARGS(comp.address_of())) != S_OK) {
+        LUISA_ERROR("Failed to create the DXC compiler.");
     }
-    auto voidPtr = dxcCompiler.address("DxcCreateInstance"sv);
-    HRESULT(WINAPI * DxcCreateInstance)
-    (const IID &, const IID &, LPVOID *) =
-        reinterpret_cast<HRESULT(WINAPI *)(const IID &, const IID &, LPVOID *)>(voidPtr);
-    DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(comp.GetAddressOf()));
 }
 ShaderCompilerModule::~ShaderCompilerModule() {
-    comp = nullptr;
+    // released before the library is unloaded
+    comp.reset();
 }
 ShaderCompiler::ShaderCompiler(std::filesystem::path const &path)
     : path(path) {}
@@ -61,24 +69,24 @@ CompileResult ShaderCompiler::compile(
     DxcBuffer buffer{
         code.data(),
         code.size(),
-        CP_ACP};
-    ComPtr<IDxcResult> compileResult;
+        DXC_CP_ACP};
+    DxcPtr<IDxcResult> compileResult;
 
     LC_DXC_THROW_IF_FAILED(compiler()->Compile(
         &buffer,
         args.data(),
         args.size(),
         nullptr,
-        IID_PPV_ARGS(compileResult.GetAddressOf())));
+        IID_PPV_ARGS(compileResult.address_of())));
     HRESULT status;
     LC_DXC_THROW_IF_FAILED(compileResult->GetStatus(&status));
     if (status == 0) {
-        ComPtr<IDxcBlob> resultBlob;
-        LC_DXC_THROW_IF_FAILED(compileResult->GetResult(resultBlob.GetAddressOf()));
+        DxcPtr<IDxcBlob> resultBlob;
+        LC_DXC_THROW_IF_FAILED(compileResult->GetResult(resultBlob.address_of()));
         return vstd::create_unique(new DxcByteBlob(std::move(resultBlob)));
     } else {
-        ComPtr<IDxcBlobEncoding> errBuffer;
-        LC_DXC_THROW_IF_FAILED(compileResult->GetErrorBuffer(errBuffer.GetAddressOf()));
+        DxcPtr<IDxcBlobEncoding> errBuffer;
+        LC_DXC_THROW_IF_FAILED(compileResult->GetErrorBuffer(errBuffer.address_of()));
         auto errStr = vstd::string_view(
             reinterpret_cast<char const *>(errBuffer->GetBufferPointer()),
             errBuffer->GetBufferSize());
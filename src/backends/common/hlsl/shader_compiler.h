@@ -1,19 +1,56 @@
 #pragma once
 #include <filesystem>
 #include <luisa/core/dynamic_module.h>
-#include <wrl/client.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <unknwn.h>
+#endif
 #include "dxcapi.h"
 #include <luisa/vstl/common.h>
 #include <luisa/core/platform.h>
 
 namespace lc::hlsl {
-using Microsoft::WRL::ComPtr;
+// owns a reference to a DXC object, the part of WRL's ComPtr used here, which also works
+// with the libdxcompiler of Linux
+template<typename T>
+class DxcPtr {
+    T *_ptr{nullptr};
+
+public:
+    DxcPtr() noexcept = default;
+    DxcPtr(DxcPtr const &) = delete;
+    DxcPtr(DxcPtr &&rhs) noexcept : _ptr{rhs._ptr} { rhs._ptr = nullptr; }
+    DxcPtr &operator=(DxcPtr const &) = delete;
+    DxcPtr &operator=(DxcPtr &&rhs) noexcept {
+        if (this != &rhs) {
+            reset();
+            _ptr = rhs._ptr;
+            rhs._ptr = nullptr;
+        }
+        return *this;
+    }
+    ~DxcPtr() noexcept { reset(); }
+    void reset() noexcept {
+        if (_ptr) {
+            _ptr->Release();
+            _ptr = nullptr;
+        }
+    }
+    [[nodiscard]] T *get() const noexcept { return _ptr; }
+    [[nodiscard]] T *operator->() const noexcept { return _ptr; }
+    [[nodiscard]] explicit operator bool() const noexcept { return _ptr != nullptr; }
+    // releases the current object, for the out-parameters of DXC calls
+    [[nodiscard]] T **address_of() noexcept {
+        reset();
+        return &_ptr;
+    }
+};
 class DxcByteBlob final : public vstd::IOperatorNewBase {
 private:
-    ComPtr<IDxcBlob> blob;
+    DxcPtr<IDxcBlob> blob;
 
 public:
-    DxcByteBlob(Microsoft::WRL::ComPtr<IDxcBlob> &&b);
+    DxcByteBlob(DxcPtr<IDxcBlob> &&b);
     std::byte *data() const;
     size_t size() const;
 };
@@ -29,7 +66,7 @@ class ShaderCompilerModule {
 public:
     luisa::DynamicModule dxil;
     luisa::DynamicModule dxcCompiler;
-    ComPtr<IDxcCompiler3> comp;
+    DxcPtr<IDxcCompiler3> comp;
     ShaderCompilerModule(std::filesystem::path const &path);
     ~ShaderCompilerModule();
 };
@@ -1,8 +1,11 @@
 #include "string_builder.h"
+#include <cstring>
 namespace vstd {
 StringBuilder::~StringBuilder() = default;
 StringBuilder &StringBuilder::append(vstd::string_view str) {
-    vstd::push_back_all(vec, str.data(), str.size());
+    if (!str.empty()) {
+        std::memcpy(vec.push_back_uninitialized(str.size()), str.data(), str.size());
+    }
     return *this;
 }
 StringBuilder &StringBuilder::append(char str) {
@@ -10,29 +13,22 @@ StringBuilder &StringBuilder::append(char str) {
     return *this;
 }
 StringBuilder &StringBuilder::append(vstd::string const &str) {
-    vstd::push_back_all(vec, str.data(), str.size());
-    return *this;
+    return append(vstd::string_view{str});
 }
 StringBuilder::StringBuilder() = default;
 
 void to_string(float Val, StringBuilder &str) noexcept {
-    const size_t len = snprintf(nullptr, 0, "%a", Val);
-    auto lastLen = str.size();
-    str.push_back(len + 1);
-    auto iter = str.end() - 1;
-    *iter = 0;
-    snprintf(str.data() + lastLen, len + 1, "%a", Val);
-    *iter = 'f';
+    char Buff[32];
+    char *const Buff_end = std::end(Buff);
+    char *RNext = HexFloat_to_buff(Buff_end, static_cast<double>(Val));
+    str << vstd::string_view{RNext, static_cast<size_t>(Buff_end - RNext)} << 'f';
 }
 
 void to_string(double Val, StringBuilder &str) noexcept {
-    const size_t len = snprintf(nullptr, 0, "%a", Val);
-    auto lastLen = str.size();
-    str.push_back(len + 1);
-    auto iter = str.end() - 1;
-    *iter = 0;
-    snprintf(str.data() + lastLen, len + 1, "%a", Val);
-    str.erase(str.end() - 1);
+    char Buff[32];
+    char *const Buff_end = std::end(Buff);
+    char *RNext = HexFloat_to_buff(Buff_end, Val);
+    str << vstd::string_view{RNext, static_cast<size_t>(Buff_end - RNext)};
 }
 
 }// namespace vstd
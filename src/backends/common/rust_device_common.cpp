@@ -8,16 +8,38 @@ using luisa::compute::ir::KernelModule;
 using luisa::compute::ir::Type;
 }// namespace luisa::compute::backend
 
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
 #include <luisa/core/dynamic_module.h>
+#include <luisa/core/thread_pool.h>
 #include <luisa/core/logging.h>
 #include <luisa/runtime/context.h>
 #include <luisa/runtime/rtx/triangle.h>
 #include <luisa/ir/ast2ir.h>
 #include <luisa/runtime/rtx/aabb.h>
+#include <luisa/core/binary_io.h>
+#include <luisa/core/stl/hash.h>
+#include <luisa/core/stl/deque.h>
+#include <luisa/backends/ext/profiling_ext.hpp>
+#include <luisa/backends/ext/dstorage_cmd.h>
+#include <luisa/backends/ext/raster_cmd.h>
+#include <luisa/backends/ext/cpu/lcub/cpu_lcub_command.h>
+#include <luisa/backends/ext/cpu/cpu_host_callback_command.h>
+#include <luisa/backends/ext/cpu_config_ext.h>
+#include "default_binary_io.h"
 #include "rust_device_common.h"
+#include "../cpu/cpu_dstorage.h"
+#include "../cpu/cpu_tex_compress.h"
+#include "../cpu/cpu_sparse.h"
+#include "../cpu/cpu_shader_bundle.h"
+#include "../cpu/cpu_raster.h"
+#include "../cpu/cpu_denoiser.h"
 
 // must go last to avoid name conflicts
 #include <luisa/runtime/rhi/resource.h>
+#include <luisa/runtime/dispatch_buffer.h>
 
 namespace luisa::compute::rust {
 
@@ -29,17 +51,62 @@ public:
     private:
         luisa::vector<void *> _temp;
         luisa::vector<api::Command> _api_commands;
+        luisa::vector<const CustomCommand *> _host_commands;
+        cpu::CPUDStorageExt *_dstorage_ext;
+        cpu::CPURasterExt *_raster_ext;
         CommandList _list;
 
     public:
         CommandBuffer(luisa::vector<void *> temp,
                       luisa::vector<api::Command> api_commands,
+                      luisa::vector<const CustomCommand *> host_commands,
+                      cpu::CPUDStorageExt *dstorage_ext,
+                      cpu::CPURasterExt *raster_ext,
                       CommandList list) noexcept
             : _temp{std::move(temp)},
               _api_commands{std::move(api_commands)},
+              _host_commands{std::move(host_commands)},
+              _dstorage_ext{dstorage_ext},
+              _raster_ext{raster_ext},
               _list{std::move(list)} {}
 
+        // runs on the stream thread, which blocks later work until the host commands are done
         void on_completion() noexcept {
+            luisa::vector<const DStorageReadCommand *> reads;
+            auto flush_reads = [&] {
+                if (!reads.empty()) {
+                    _dstorage_ext->execute(reads);
+                    reads.clear();
+                }
+            };
+            for (auto command : _host_commands) {
+                switch (command->uuid()) {
+                    case to_underlying(CustomCommandUUID::DSTORAGE_READ):
+                        // consecutive reads are batched to overlap their I/O
+                        reads.emplace_back(static_cast<const DStorageReadCommand *>(command));
+                        break;
+                    case to_underlying(CustomCommandUUID::CPU_LCUB_COMMAND):
+                        flush_reads();
+                        static_cast<const cpu::CPULCubCommand *>(command)->func();
+                        break;
+                    case to_underlying(CustomCommandUUID::CPU_HOST_CALLBACK):
+                        flush_reads();
+                        static_cast<const cpu::CPUHostCallbackCommand *>(command)->func();
+                        break;
+#ifdef LUISA_ENABLE_DSL
+                    case to_underlying(CustomCommandUUID::RASTER_DRAW_SCENE):
+                        flush_reads();
+                        _raster_ext->draw(static_cast<const DrawRasterSceneCommand *>(command));
+                        break;
+                    case to_underlying(CustomCommandUUID::RASTER_CLEAR_DEPTH):
+                        flush_reads();
+                        _raster_ext->clear_depth(static_cast<const ClearDepthCommand *>(command));
+                        break;
+#endif
+                    default: LUISA_ERROR_WITH_LOCATION("Unreachable.");
+                }
+            }
+            flush_reads();
             for (auto &&callback : _list.callbacks()) { callback(); }
             for (auto p : _temp) {
                 luisa::deallocate_with_allocator(
@@ -48,9 +115,20 @@ public:
         }
     };
 
+private:
+    // a run of converted commands followed by the host commands that consume their results
+    struct Segment {
+        size_t command_begin;
+        size_t command_end;
+        size_t converted_end;
+        luisa::vector<const CustomCommand *> host_commands;
+    };
+
 private:
     luisa::vector<void *> _temp;
     luisa::vector<api::Command> _converted;
+    luisa::vector<Segment> _segments;
+    size_t _command_index{0u};
 
 private:
     template<typename T>
@@ -74,34 +152,79 @@ private:
                    api::AccelBuildRequest::FORCE_BUILD;
     }
 
+    // starts a segment unless no commands were converted since the last host command
+    void _open_segment() noexcept {
+        if (!_segments.empty() && _segments.back().converted_end == _converted.size()) { return; }
+        auto begin = _segments.empty() ? 0u : _segments.back().command_end +
+                                                  _segments.back().host_commands.size();
+        _segments.emplace_back(Segment{.command_begin = begin,
+                                       .command_end = _command_index,
+                                       .converted_end = _converted.size()});
+    }
+
 public:
+    // Host commands (DStorage reads, lcub algorithms and raster draws) cannot run inside the
+    // device, so the list is split at them: each segment is dispatched as a work
+    // item whose completion handler runs the host commands on the stream thread.
+    // The last segment owns the command list and the temporaries.
+    template<typename OnSegment>
     void dispatch(api::DeviceInterface device, api::Stream stream,
-                  CommandList &&list) noexcept {
+                  CommandList &&list, cpu::CPUDStorageExt *dstorage_ext,
+                  cpu::CPURasterExt *raster_ext, OnSegment &&on_segment) noexcept {
 
         LUISA_ASSERT(_temp.empty(), "Temporary buffer leak.");
         LUISA_ASSERT(_converted.empty(), "Command buffer leak.");
+        LUISA_ASSERT(_segments.empty(), "Command segment leak.");
 
-        _converted.reserve(list.commands().size());
-        for (auto &&cmd : list.commands()) { cmd->accept(*this); }
-        LUISA_ASSERT(_converted.size() == list.commands().size(),
+        auto commands = list.commands();
+        _converted.reserve(commands.size());
+        for (_command_index = 0u; _command_index < commands.size(); _command_index++) {
+            commands[_command_index]->accept(*this);
+        }
+        _open_segment();
+        auto host_command_count = static_cast<size_t>(0u);
+        for (auto &&segment : _segments) { host_command_count += segment.host_commands.size(); }
+        LUISA_ASSERT(_converted.size() + host_command_count == commands.size(),
                      "Command list size mismatch.");
 
-        api::CommandList converted_list{
-            .commands = _converted.data(),
-            .commands_count = _converted.size(),
-        };
-        auto ctx = luisa::new_with_allocator<CommandBuffer>(
-            std::move(_temp),
-            std::move(_converted),
-            std::move(list));
-        device.dispatch(
-            device.device, stream, converted_list,
-            [](uint8_t *ctx) noexcept {
-                auto cb = reinterpret_cast<CommandBuffer *>(ctx);
-                cb->on_completion();
-                luisa::delete_with_allocator(cb);
-            },
-            reinterpret_cast<uint8_t *>(ctx));
+        // the storage of the converted commands is kept alive by the last segment
+        auto converted = _converted.data();
+        auto converted_begin = static_cast<size_t>(0u);
+        for (auto i = 0u; i < _segments.size(); i++) {
+            auto &&segment = _segments[i];
+            auto last = i + 1u == _segments.size();
+            auto ctx = last ? luisa::new_with_allocator<CommandBuffer>(
+                                  std::move(_temp),
+                                  std::move(_converted),
+                                  std::move(segment.host_commands),
+                                  dstorage_ext,
+                                  raster_ext,
+                                  std::move(list)) :
+                              luisa::new_with_allocator<CommandBuffer>(
+                                  luisa::vector<void *>{},
+                                  luisa::vector<api::Command>{},
+                                  std::move(segment.host_commands),
+                                  dstorage_ext,
+                                  raster_ext,
+                                  CommandList{});
+            on_segment(commands.subspan(segment.command_begin,
+                                        segment.command_end - segment.command_begin));
+            api::CommandList converted_list{
+                .commands = converted + converted_begin,
+                .commands_count = segment.converted_end - converted_begin,
+            };
+            device.dispatch(
+                device.device, stream, converted_list,
+                [](uint8_t *ctx) noexcept {
+                    auto cb = reinterpret_cast<CommandBuffer *>(ctx);
+                    cb->on_completion();
+                    luisa::delete_with_allocator(cb);
+                },
+                reinterpret_cast<uint8_t *>(ctx));
+            converted_begin = segment.converted_end;
+        }
+        _converted = {};
+        _segments.clear();
     }
     void visit(const BufferUploadCommand *command) noexcept override {
         api::Command converted{.tag = Tag::BUFFER_UPLOAD};
@@ -145,8 +268,6 @@ public:
         _converted.emplace_back(converted);
     }
     void visit(const ShaderDispatchCommand *command) noexcept override {
-        LUISA_ASSERT(!command->is_indirect(),
-                     "Indirect dispatch is not supported.");
         auto n = command->arguments().size();
         auto args = _create_temporary<api::Argument>(n);
         for (size_t i = 0; i < n; i++) {
@@ -192,11 +313,24 @@ public:
         api::Command converted{.tag = Tag::SHADER_DISPATCH};
         converted.SHADER_DISPATCH._0 = api::ShaderDispatchCommand{
             .shader = {command->handle()},
-            .dispatch_size = {command->dispatch_size().x,
-                              command->dispatch_size().y,
-                              command->dispatch_size().z},
+            .dispatch_size = {},
             .args = args,
-            .args_count = n};
+            .args_count = n,
+            .indirect = {.buffer = {invalid_resource_handle}}};
+        auto &&dispatch = converted.SHADER_DISPATCH._0;
+        if (command->is_indirect()) {
+            // the dispatches are read from the buffer when the command executes
+            auto indirect = command->indirect_dispatch();
+            dispatch.indirect = api::IndirectDispatchArgument{
+                .buffer = {indirect.handle},
+                .offset = indirect.offset,
+                .max_dispatch_count = indirect.max_dispatch_size};
+        } else {
+            auto size = command->dispatch_size();
+            dispatch.dispatch_size[0] = size.x;
+            dispatch.dispatch_size[1] = size.y;
+            dispatch.dispatch_size[2] = size.z;
+        }
         _converted.emplace_back(converted);
     }
     void visit(const TextureUploadCommand *command) noexcept override {
@@ -362,12 +496,219 @@ public:
         _converted.emplace_back(converted);
     }
     void visit(const CustomCommand *command) noexcept override {
-        LUISA_ERROR_WITH_LOCATION("Not implemented.");
+        switch (command->uuid()) {
+            case to_underlying(CustomCommandUUID::DSTORAGE_READ):
+            case to_underlying(CustomCommandUUID::CPU_LCUB_COMMAND):
+            case to_underlying(CustomCommandUUID::CPU_HOST_CALLBACK):
+#ifdef LUISA_ENABLE_DSL
+            case to_underlying(CustomCommandUUID::RASTER_DRAW_SCENE):
+            case to_underlying(CustomCommandUUID::RASTER_CLEAR_DEPTH):
+#endif
+                _open_segment();
+                _segments.back().host_commands.emplace_back(command);
+                break;
+            default:
+                LUISA_ERROR_WITH_LOCATION("Custom command (UUID = 0x{:04x}) "
+                                          "is not supported on the CPU backend.",
+                                          command->uuid());
+        }
+    }
+};
+
+// Records are built on submission; the stream reports begin/end marks while
+// executing its work queue in order, which are timestamped here so that host
+// and device times share the same clock.
+class RustProfilingExt final : public ProfilingExt {
+
+private:
+    struct StreamProfile {
+        RustProfilingExt *ext{};
+        std::mutex mutex;
+        // records of the submitted work items, front is the next to execute
+        luisa::deque<luisa::vector<Record>> submitted;
+        // only accessed by the stream thread
+        luisa::vector<Record> executing;
+    };
+
+private:
+    api::DeviceInterface _device;
+    std::chrono::steady_clock::time_point _epoch;
+    std::atomic_size_t _profiled_stream_count{0u};
+    std::mutex _mutex;
+    luisa::unordered_map<uint64_t, luisa::unique_ptr<StreamProfile>> _streams;
+    luisa::unordered_map<uint64_t, luisa::string> _shader_names;
+    luisa::vector<Record> _completed;
+
+private:
+    [[nodiscard]] uint64_t _now() const noexcept {
+        auto dt = std::chrono::steady_clock::now() - _epoch;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count();
+    }
+
+    [[nodiscard]] static luisa::string_view _command_name(Command::Tag tag) noexcept {
+        switch (tag) {
+#define LUISA_RUST_PROFILING_COMMAND_NAME(Cmd) \
+    case Command::Tag::E##Cmd: return #Cmd;
+            LUISA_MAP(LUISA_RUST_PROFILING_COMMAND_NAME, LUISA_COMPUTE_RUNTIME_COMMANDS)
+#undef LUISA_RUST_PROFILING_COMMAND_NAME
+        }
+        return "UnknownCommand";
+    }
+
+    static void _on_mark(uint8_t *user_data, api::ProfilingMark mark, size_t index) noexcept {
+        auto profile = reinterpret_cast<StreamProfile *>(user_data);
+        auto ext = profile->ext;
+        auto time = ext->_now();
+        auto &&executing = profile->executing;
+        switch (mark) {
+            case api::ProfilingMark::WORK_BEGIN: {
+                std::scoped_lock lock{profile->mutex};
+                LUISA_ASSERT(!profile->submitted.empty(),
+                             "Profiled stream executes unrecorded work.");
+                executing = std::move(profile->submitted.front());
+                profile->submitted.pop_front();
+                executing.front().start_time = time;
+                break;
+            }
+            case api::ProfilingMark::COMMAND_BEGIN:
+                executing[index + 1u].start_time = time;
+                break;
+            case api::ProfilingMark::COMMAND_END:
+                executing[index + 1u].end_time = time;
+                break;
+            case api::ProfilingMark::WORK_END: {
+                executing.front().end_time = time;
+                std::scoped_lock lock{ext->_mutex};
+                auto parent = ext->_completed.size();
+                for (auto i = 1u; i < executing.size(); i++) { executing[i].parent = parent; }
+                for (auto &&r : executing) { ext->_completed.emplace_back(std::move(r)); }
+                executing.clear();
+                break;
+            }
+        }
+    }
+
+    [[nodiscard]] StreamProfile *_profile(uint64_t stream_handle) noexcept {
+        if (_profiled_stream_count.load(std::memory_order_relaxed) == 0u) { return nullptr; }
+        std::scoped_lock lock{_mutex};
+        auto iter = _streams.find(stream_handle);
+        return iter == _streams.end() ? nullptr : iter->second.get();
+    }
+
+    void _submit(StreamProfile *profile, luisa::vector<Record> records) noexcept {
+        std::scoped_lock lock{profile->mutex};
+        profile->submitted.emplace_back(std::move(records));
+    }
+
+    // the stream is synchronized without holding the lock, which completing work needs
+    [[nodiscard]] bool enable_stream_profiling(uint64_t stream_handle) noexcept override {
+        _device.synchronize_stream(_device.device, api::Stream{stream_handle});
+        std::scoped_lock lock{_mutex};
+        if (_streams.contains(stream_handle)) { return true; }
+        auto profile = luisa::make_unique<StreamProfile>();
+        profile->ext = this;
+        if (!_device.set_stream_profiling(_device.device, api::Stream{stream_handle}, &_on_mark,
+                                          reinterpret_cast<uint8_t *>(profile.get()))) {
+            return false;
+        }
+        _streams.emplace(stream_handle, std::move(profile));
+        _profiled_stream_count.fetch_add(1u, std::memory_order_relaxed);
+        return true;
+    }
+
+    void disable_stream_profiling(uint64_t stream_handle) noexcept override {
+        // the last work item reports its end before the stream counts it as finished
+        _device.synchronize_stream(_device.device, api::Stream{stream_handle});
+        std::scoped_lock lock{_mutex};
+        if (auto iter = _streams.find(stream_handle); iter != _streams.end()) {
+            _device.set_stream_profiling(_device.device, api::Stream{stream_handle}, nullptr, nullptr);
+            _streams.erase(iter);
+            _profiled_stream_count.fetch_sub(1u, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    explicit RustProfilingExt(api::DeviceInterface device) noexcept
+        : _device{device}, _epoch{std::chrono::steady_clock::now()} {}
+
+    [[nodiscard]] luisa::vector<Record> collect() noexcept override {
+        std::scoped_lock lock{_mutex};
+        return std::exchange(_completed, {});
+    }
+
+    void set_shader_name(uint64_t handle, luisa::string_view name) noexcept {
+        std::scoped_lock lock{_mutex};
+        _shader_names[handle] = name;
+    }
+
+    void remove_shader(uint64_t handle) noexcept {
+        std::scoped_lock lock{_mutex};
+        _shader_names.erase(handle);
+    }
+
+    void remove_stream(uint64_t stream_handle) noexcept {
+        disable_stream_profiling(stream_handle);
+    }
+
+    void record_dispatch(uint64_t stream_handle, luisa::span<const luisa::unique_ptr<Command>> commands) noexcept {
+        auto profile = _profile(stream_handle);
+        if (profile == nullptr) { return; }
+        auto time = _now();
+        luisa::vector<Record> records;
+        records.reserve(commands.size() + 1u);
+        records.emplace_back(Record{.kind = Record::Kind::COMMAND_LIST,
+                                    .stream_handle = stream_handle,
+                                    .name = "CommandList",
+                                    .submit_time = time});
+        for (auto &&command : commands) {
+            Record r{.kind = Record::Kind::COMMAND,
+                     .stream_handle = stream_handle,
+                     .name = luisa::string{_command_name(command->tag())},
+                     .bytes = profiling_command_bytes(command.get()),
+                     .submit_time = time};
+            if (command->tag() == Command::Tag::EShaderDispatchCommand) {
+                auto dispatch = static_cast<const ShaderDispatchCommand *>(command.get());
+                if (!dispatch->is_indirect()) { r.dispatch_size = dispatch->dispatch_size(); }
+                std::scoped_lock lock{_mutex};
+                if (auto iter = _shader_names.find(dispatch->handle());
+                    iter != _shader_names.end()) { r.name = iter->second; }
+            }
+            records.front().bytes += r.bytes;
+            records.emplace_back(std::move(r));
+        }
+        _submit(profile, std::move(records));
+    }
+
+    void record_event(uint64_t stream_handle, Record::Kind kind, uint64_t value) noexcept {
+        auto profile = _profile(stream_handle);
+        if (profile == nullptr) { return; }
+        luisa::vector<Record> records;
+        records.emplace_back(Record{.kind = kind,
+                                    .stream_handle = stream_handle,
+                                    .name = kind == Record::Kind::EVENT_SIGNAL ? "SignalEvent" : "WaitEvent",
+                                    .event_value = value,
+                                    .submit_time = _now()});
+        _submit(profile, std::move(records));
+    }
+
+    void record_present(uint64_t stream_handle) noexcept {
+        auto profile = _profile(stream_handle);
+        if (profile == nullptr) { return; }
+        luisa::vector<Record> records;
+        records.emplace_back(Record{.kind = Record::Kind::PRESENT,
+                                    .stream_handle = stream_handle,
+                                    .name = "Present",
+                                    .submit_time = _now()});
+        _submit(profile, std::move(records));
     }
 };
 
 // @Mike-Leo-Smith: fill-in the blanks pls
 class RustDevice final : public DeviceInterface {
+    // layout of indirect dispatch buffers, mirrors the CUDA backend
+    static constexpr size_t indirect_dispatch_header_size = 16u;
+    static constexpr size_t indirect_dispatch_stride = 32u;
+
     api::DeviceInterface device{};
     api::LibInterface lib{};
     luisa::filesystem::path runtime_path;
@@ -377,20 +718,190 @@ class RustDevice final : public DeviceInterface {
 
     api::Context api_ctx{};
 
+    luisa::unique_ptr<DefaultBinaryIO> default_binary_io;
+    const BinaryIO *binary_io{nullptr};
+
+    luisa::unique_ptr<RustProfilingExt> profiling_ext;
+    luisa::unique_ptr<cpu::CPUDStorageExt> dstorage_ext;
+    luisa::unique_ptr<cpu::CPUDenoiserExt> denoiser_ext;
+    // converts the callables of a kernel concurrently in AST2IR, created on first use
+    std::mutex ast2ir_pool_mutex;
+    luisa::unique_ptr<ThreadPool> ast2ir_pool;
+#ifdef LUISA_ENABLE_DSL
+    luisa::unique_ptr<cpu::CPURasterExt> raster_ext;
+#endif
+    // created on first use, as it owns a worker pool
+    std::mutex tex_compress_ext_mutex;
+    luisa::unique_ptr<cpu::CPUTexCompressExt> tex_compress_ext;
+    // the reserved memory of sparse resources, by the handles of their Rust wrappers
+    std::mutex sparse_mutex;
+    luisa::unordered_map<uint64_t, luisa::unique_ptr<cpu::CPUSparseResource>> sparse_resources;
+    // argument usages of the shaders created from ASTs or loaded from bundles
+    std::mutex shader_mutex;
+    luisa::unordered_map<uint64_t, luisa::vector<Usage>> shader_argument_usages;
+
+private:
+    [[nodiscard]] ThreadPool *_ast2ir_pool() noexcept {
+        std::scoped_lock lock{ast2ir_pool_mutex};
+        if (ast2ir_pool == nullptr) { ast2ir_pool = luisa::make_unique<ThreadPool>(); }
+        return ast2ir_pool.get();
+    }
+
+    [[nodiscard]] static auto _convert_bindings(Function kernel) noexcept {
+        luisa::vector<api::Argument> captures;
+        captures.reserve(kernel.bound_arguments().size());
+        for (auto &&binding : kernel.bound_arguments()) {
+            luisa::visit(
+                [&captures]<typename T>(T b) noexcept {
+                    api::Argument arg{};
+                    if constexpr (std::is_same_v<T, Function::BufferBinding>) {
+                        arg.tag = api::Argument::Tag::BUFFER;
+                        arg.BUFFER._0 = api::BufferArgument{
+                            .buffer = {b.handle},
+                            .offset = b.offset,
+                            .size = b.size};
+                    } else if constexpr (std::is_same_v<T, Function::TextureBinding>) {
+                        arg.tag = api::Argument::Tag::TEXTURE;
+                        arg.TEXTURE._0 = api::TextureArgument{
+                            .texture = {b.handle},
+                            .level = b.level};
+                    } else if constexpr (std::is_same_v<T, Function::BindlessArrayBinding>) {
+                        arg.tag = api::Argument::Tag::BINDLESS_ARRAY;
+                        arg.BINDLESS_ARRAY._0 = {b.handle};
+                    } else if constexpr (std::is_same_v<T, Function::AccelBinding>) {
+                        arg.tag = api::Argument::Tag::ACCEL;
+                        arg.ACCEL._0 = {b.handle};
+                    } else {
+                        LUISA_ERROR_WITH_LOCATION("Unsupported binding type.");
+                    }
+                    captures.emplace_back(arg);
+                },
+                binding);
+        }
+        return captures;
+    }
+
+    [[nodiscard]] static auto _ast_cache_name(const ShaderOption &option, Function kernel) noexcept {
+        auto hash = hash_combine({kernel.hash(),
+                                  hash_value(option.enable_fast_math),
+                                  hash_value(option.enable_debug_info)});
+        return luisa::format("kernel_{:016x}.cpu.ast", hash);
+    }
+
+    [[nodiscard]] static luisa::string _shader_display_name(const ShaderOption &option, Function kernel) noexcept {
+        if (!option.name.empty()) { return luisa::string{option.name}; }
+        return luisa::format("kernel_{:016x}", kernel.hash());
+    }
+
+    [[nodiscard]] ShaderCreationInfo _load_from_ast_cache(luisa::string_view name, Function kernel) noexcept {
+        auto stream = binary_io->read_shader_cache(name);
+        if (stream == nullptr) { return ShaderCreationInfo::make_invalid(); }
+        luisa::vector<std::byte> artifact(stream->length());
+        stream->read(artifact);
+        auto captures = _convert_bindings(kernel);
+        auto shader = device.create_shader_from_artifact(
+            device.device,
+            reinterpret_cast<const uint8_t *>(artifact.data()), artifact.size(),
+            captures.data(), captures.size());
+        ShaderCreationInfo info{};
+        info.block_size[0] = shader.block_size[0];
+        info.block_size[1] = shader.block_size[1];
+        info.block_size[2] = shader.block_size[2];
+        info.handle = shader.resource.handle;
+        info.native_handle = shader.resource.native_handle;
+        if (!info.valid()) {
+            LUISA_WARNING_WITH_LOCATION(
+                "Shader '{}' is found in cache but cannot be loaded. "
+                "The shader will be recompiled.",
+                name);
+        }
+        return info;
+    }
+
+    [[nodiscard]] static auto _argument_usages(Function kernel) noexcept {
+        luisa::vector<Usage> usages;
+        usages.reserve(kernel.arguments().size());
+        for (auto &&arg : kernel.arguments()) {
+            usages.emplace_back(kernel.variable_usage(arg.uid()));
+        }
+        return usages;
+    }
+
+    void _register_shader(uint64_t handle, luisa::string name, luisa::vector<Usage> usages) noexcept {
+        profiling_ext->set_shader_name(handle, std::move(name));
+        std::scoped_lock lock{shader_mutex};
+        shader_argument_usages.insert_or_assign(handle, std::move(usages));
+    }
+
+    void _store_bundle(luisa::string_view name, Function kernel, uint64_t handle) noexcept {
+        // the captured resources would be dangling when the bundle is loaded
+        if (!kernel.bound_arguments().empty()) {
+            LUISA_WARNING_WITH_LOCATION(
+                "Shader '{}' captures resources and cannot be saved as a bundle.", name);
+            return;
+        }
+        auto artifact = device.shader_artifact(device.device, api::Shader{handle});
+        if (artifact.data == nullptr) {
+            LUISA_WARNING_WITH_LOCATION(
+                "Shader '{}' uses host callbacks and cannot be saved as a bundle.", name);
+            return;
+        }
+        cpu::CPUShaderBundle bundle;
+        bundle.argument_usages = _argument_usages(kernel);
+        bundle.argument_types.reserve(kernel.arguments().size());
+        for (auto &&arg : kernel.arguments()) {
+            bundle.argument_types.emplace_back(arg.type()->description());
+        }
+        auto artifact_data = reinterpret_cast<const std::byte *>(artifact.data);
+        bundle.artifact.assign(artifact_data, artifact_data + artifact.size);
+        device.free_shader_artifact(device.device, artifact);
+        auto path = binary_io->write_shader_bytecode(name, bundle.serialize());
+        LUISA_VERBOSE("Saved shader bundle '{}' to '{}'.", name, luisa::to_string(path));
+    }
+
+    void _store_to_ast_cache(luisa::string_view name, uint64_t handle) noexcept {
+        auto artifact = device.shader_artifact(device.device, api::Shader{handle});
+        if (artifact.data == nullptr) { return; }
+        luisa::span data{reinterpret_cast<const std::byte *>(artifact.data), artifact.size};
+        static_cast<void>(binary_io->write_shader_cache(name, data));
+        device.free_shader_artifact(device.device, artifact);
+    }
+
 public:
     ~RustDevice() noexcept override {
+        profiling_ext = nullptr;
+#ifdef LUISA_ENABLE_DSL
+        // the raster extension releases its resources through the device
+        raster_ext = nullptr;
+#endif
+        denoiser_ext = nullptr;
+        dstorage_ext = nullptr;
+        tex_compress_ext = nullptr;
         device.destroy_device(device);
         lib.destroy_context(api_ctx);
     }
 
-    RustDevice(Context &&ctx, luisa::filesystem::path runtime_path, string_view name) noexcept
+    RustDevice(Context &&ctx, luisa::filesystem::path runtime_path,
+               string_view name, const BinaryIO *io,
+               const luisa::string &config) noexcept
         : DeviceInterface(std::move(ctx)),
-          runtime_path(std::move(runtime_path)) {
+          runtime_path(std::move(runtime_path)),
+          binary_io(io) {
+        if (binary_io == nullptr) {
+            default_binary_io = luisa::make_unique<DefaultBinaryIO>(context());
+            binary_io = default_binary_io.get();
+        }
         dll = DynamicModule::load(this->runtime_path, "luisa_compute_backend_impl");
         luisa_compute_lib_interface = dll.function<api::LibInterface()>("luisa_compute_lib_interface");
         lib = luisa_compute_lib_interface();
         api_ctx = lib.create_context(this->runtime_path.generic_string().c_str());
-        device = lib.create_device(api_ctx, name.data(), nullptr);
+        device = lib.create_device(api_ctx, name.data(), config.c_str());
+        profiling_ext = luisa::make_unique<RustProfilingExt>(device);
+        dstorage_ext = luisa::make_unique<cpu::CPUDStorageExt>(this);
+        denoiser_ext = luisa::make_unique<cpu::CPUDenoiserExt>();
+#ifdef LUISA_ENABLE_DSL
+        raster_ext = luisa::make_unique<cpu::CPURasterExt>(this, dstorage_ext.get());
+#endif
         lib.set_logger_callback([](api::LoggerMessage message) {
             luisa::string_view target(message.target);
             luisa::string_view level(message.level);
@@ -416,6 +927,15 @@ public:
     }
 
     BufferCreationInfo create_buffer(const Type *element, size_t elem_count) noexcept override {
+        if (element == Type::of<IndirectKernelDispatch>()) {
+            // a header with the dispatch count followed by the dispatches, see
+            // lc_indirect_set_dispatch_count/kernel in the CPU kernel prelude
+            auto type = AST2IR::build_type(nullptr);
+            auto info = create_buffer(&type, indirect_dispatch_header_size +
+                                                 std::max<size_t>(elem_count, 1u) * indirect_dispatch_stride);
+            info.element_stride = indirect_dispatch_stride;
+            return info;
+        }
         auto type = AST2IR::build_type(element);
         return create_buffer(&type, elem_count);
     }
@@ -427,10 +947,13 @@ public:
         info.total_size_bytes = buffer.total_size_bytes;
         info.handle = buffer.resource.handle;
         info.native_handle = buffer.resource.native_handle;
+        dstorage_ext->register_buffer(info.handle, {static_cast<std::byte *>(info.native_handle),
+                                                    info.total_size_bytes});
         return info;
     }
 
     void destroy_buffer(uint64_t handle) noexcept override {
+        dstorage_ext->unregister_buffer(handle);
         device.destroy_buffer(device.device, api::Buffer{handle});
     }
 
@@ -442,10 +965,16 @@ public:
         ResourceCreationInfo info{};
         info.handle = texture.handle;
         info.native_handle = texture.native_handle;
+        dstorage_ext->register_texture(info.handle, {.data = static_cast<std::byte *>(info.native_handle),
+                                                     .storage = pixel_format_to_storage(format),
+                                                     .dimension = dimension,
+                                                     .size = make_uint3(width, height, depth),
+                                                     .mipmap_levels = mipmap_levels});
         return info;
     }
 
     void destroy_texture(uint64_t handle) noexcept override {
+        dstorage_ext->unregister_texture(handle);
         device.destroy_texture(device.device, api::Texture{handle});
     }
 
@@ -470,6 +999,7 @@ public:
     }
 
     void destroy_stream(uint64_t handle) noexcept override {
+        profiling_ext->remove_stream(handle);
         device.destroy_stream(device.device, api::Stream{handle});
     }
 
@@ -479,7 +1009,130 @@ public:
 
     void dispatch(uint64_t stream_handle, CommandList &&list) noexcept override {
         APICommandConverter converter;
-        converter.dispatch(device, api::Stream{stream_handle}, std::move(list));
+#ifdef LUISA_ENABLE_DSL
+        auto raster = raster_ext.get();
+#else
+        auto raster = static_cast<cpu::CPURasterExt *>(nullptr);
+#endif
+        converter.dispatch(device, api::Stream{stream_handle}, std::move(list), dstorage_ext.get(), raster,
+                           [&](luisa::span<const luisa::unique_ptr<Command>> commands) noexcept {
+                               profiling_ext->record_dispatch(stream_handle, commands);
+                           });
+    }
+
+    SparseBufferCreationInfo create_sparse_buffer(const Type *element, size_t elem_count) noexcept override {
+        auto type = AST2IR::build_type(element);
+        auto memory = luisa::make_unique<cpu::CPUSparseBuffer>(element->size() * elem_count);
+        api::CreatedBufferInfo buffer = device.create_buffer_from_memory(device.device, &type, elem_count, memory->data());
+        SparseBufferCreationInfo info{};
+        info.element_stride = buffer.element_stride;
+        info.total_size_bytes = buffer.total_size_bytes;
+        info.handle = buffer.resource.handle;
+        info.native_handle = buffer.resource.native_handle;
+        info.tile_size_bytes = cpu::CPUSparseResource::tile_size_bytes;
+        dstorage_ext->register_buffer(info.handle, {static_cast<std::byte *>(info.native_handle),
+                                                    info.total_size_bytes});
+        std::scoped_lock lock{sparse_mutex};
+        sparse_resources.emplace(info.handle, std::move(memory));
+        return info;
+    }
+
+    void destroy_sparse_buffer(uint64_t handle) noexcept override {
+        dstorage_ext->unregister_buffer(handle);
+        device.destroy_buffer(device.device, api::Buffer{handle});
+        std::scoped_lock lock{sparse_mutex};
+        sparse_resources.erase(handle);
+    }
+
+    SparseTextureCreationInfo create_sparse_texture(PixelFormat format, uint dimension,
+                                                    uint width, uint height, uint depth,
+                                                    uint mipmap_levels, bool simultaneous_access) noexcept override {
+        auto storage = pixel_format_to_storage(format);
+        if (is_block_compressed(storage)) {
+            LUISA_WARNING_WITH_LOCATION("Block-compressed sparse textures are not supported.");
+            return SparseTextureCreationInfo::make_invalid();
+        }
+        auto size = make_uint3(width, height, depth);
+        auto memory = luisa::make_unique<cpu::CPUSparseTexture>(storage, dimension, size, mipmap_levels);
+        api::CreatedResourceInfo texture =
+            device.create_texture_from_memory(device.device, (api::PixelFormat)format, dimension,
+                                              width, height, depth, mipmap_levels, memory->data());
+        SparseTextureCreationInfo info{};
+        info.handle = texture.handle;
+        info.native_handle = texture.native_handle;
+        info.tile_size_bytes = cpu::CPUSparseResource::tile_size_bytes;
+        info.tile_size = memory->tile_size();
+        dstorage_ext->register_texture(info.handle, {.data = static_cast<std::byte *>(info.native_handle),
+                                                     .storage = storage,
+                                                     .dimension = dimension,
+                                                     .size = size,
+                                                     .mipmap_levels = mipmap_levels,
+                                                     .tiled = true});
+        std::scoped_lock lock{sparse_mutex};
+        sparse_resources.emplace(info.handle, std::move(memory));
+        return info;
+    }
+
+    void destroy_sparse_texture(uint64_t handle) noexcept override {
+        dstorage_ext->unregister_texture(handle);
+        device.destroy_texture(device.device, api::Texture{handle});
+        std::scoped_lock lock{sparse_mutex};
+        sparse_resources.erase(handle);
+    }
+
+    // heaps only bound the number of tiles mapped at once, as the pages are committed per tile
+    ResourceCreationInfo allocate_sparse_buffer_heap(size_t byte_size) noexcept override {
+        auto heap = luisa::new_with_allocator<cpu::CPUSparseResource::Heap>(
+            cpu::CPUSparseResource::Heap{byte_size});
+        ResourceCreationInfo info{};
+        info.handle = reinterpret_cast<uint64_t>(heap);
+        info.native_handle = heap;
+        return info;
+    }
+
+    void deallocate_sparse_buffer_heap(uint64_t handle) noexcept override {
+        luisa::delete_with_allocator(reinterpret_cast<cpu::CPUSparseResource::Heap *>(handle));
+    }
+
+    ResourceCreationInfo allocate_sparse_texture_heap(size_t byte_size, bool is_compressed_type) noexcept override {
+        return allocate_sparse_buffer_heap(byte_size);
+    }
+
+    void deallocate_sparse_texture_heap(uint64_t handle) noexcept override {
+        deallocate_sparse_buffer_heap(handle);
+    }
+
+    void update_sparse_resources(uint64_t stream_handle,
+                                 luisa::vector<SparseUpdateTile> &&update) noexcept override {
+        // an empty work item runs the update on the stream thread, after the work before it
+        struct SparseUpdate {
+            RustDevice *device;
+            luisa::vector<SparseUpdateTile> tiles;
+        };
+        auto ctx = luisa::new_with_allocator<SparseUpdate>(SparseUpdate{this, std::move(update)});
+        profiling_ext->record_dispatch(stream_handle, {});
+        device.dispatch(
+            device.device, api::Stream{stream_handle}, api::CommandList{},
+            [](uint8_t *ctx) noexcept {
+                auto update = reinterpret_cast<SparseUpdate *>(ctx);
+                for (auto &&tile : update->tiles) {
+                    cpu::CPUSparseResource *resource = nullptr;
+                    {
+                        std::scoped_lock lock{update->device->sparse_mutex};
+                        auto iter = update->device->sparse_resources.find(tile.handle);
+                        LUISA_ASSERT(iter != update->device->sparse_resources.end(),
+                                     "Invalid sparse resource handle {}.", tile.handle);
+                        resource = iter->second.get();
+                    }
+                    if (!resource->update(tile.operations)) {
+                        LUISA_WARNING_WITH_LOCATION("Failed to update the tiles of sparse resource {}, "
+                                                    "the failed ones are left as they were.",
+                                                    tile.handle);
+                    }
+                }
+                luisa::delete_with_allocator(update);
+            },
+            reinterpret_cast<uint8_t *>(ctx));
     }
 
     SwapchainCreationInfo
@@ -501,13 +1154,41 @@ public:
 
     void present_display_in_stream(uint64_t stream_handle, uint64_t swapchain_handle,
                                    uint64_t image_handle) noexcept override {
+        profiling_ext->record_present(stream_handle);
         device.present_display_in_stream(device.device, api::Stream{stream_handle},
                                          api::Swapchain{swapchain_handle}, api::Texture{image_handle});
     }
 
     ShaderCreationInfo create_shader(const ShaderOption &option, Function kernel) noexcept override {
-        auto shader = AST2IR::build_kernel(kernel);
-        return create_shader(option, shader->get());
+        // the AST cache maps kernel hashes to backend artifacts, so a
+        // warm start skips both AST-to-IR conversion and code generation
+        auto use_ast_cache = option.enable_cache && option.name.empty();
+        auto cache_name = use_ast_cache ? _ast_cache_name(option, kernel) : luisa::string{};
+        if (use_ast_cache) {
+            if (auto info = _load_from_ast_cache(cache_name, kernel); info.valid()) {
+                report_shader_cache_hit();
+                LUISA_VERBOSE("Loaded shader '{}' from AST cache.", cache_name);
+                if (option.compile_only) {
+                    destroy_shader(info.handle);
+                    return ShaderCreationInfo::make_invalid();
+                }
+                _register_shader(info.handle, _shader_display_name(option, kernel), _argument_usages(kernel));
+                return info;
+            }
+            report_shader_cache_miss();
+        }
+        auto shader = AST2IR::build_kernel(kernel, _ast2ir_pool());
+        auto info = create_shader(option, shader->get());
+        if (!info.valid()) { return info; }
+        if (use_ast_cache) { _store_to_ast_cache(cache_name, info.handle); }
+        // named shaders are compiled ahead of time and loaded with load_shader()
+        if (!option.name.empty()) { _store_bundle(option.name, kernel, info.handle); }
+        if (option.compile_only) {
+            destroy_shader(info.handle);
+            return ShaderCreationInfo::make_invalid();
+        }
+        _register_shader(info.handle, _shader_display_name(option, kernel), _argument_usages(kernel));
+        return info;
     }
 
     ShaderCreationInfo
@@ -529,14 +1210,70 @@ public:
 
     ShaderCreationInfo
     load_shader(luisa::string_view name, luisa::span<const Type *const> arg_types) noexcept override {
-        LUISA_NOT_IMPLEMENTED();
+        auto stream = binary_io->read_shader_bytecode(name);
+        if (stream == nullptr) {
+            LUISA_WARNING_WITH_LOCATION("Shader bundle '{}' is not found.", name);
+            return ShaderCreationInfo::make_invalid();
+        }
+        luisa::vector<std::byte> data(stream->length());
+        stream->read(data);
+        auto bundle = cpu::CPUShaderBundle::deserialize(data);
+        if (!bundle) {
+            LUISA_WARNING_WITH_LOCATION("Invalid shader bundle '{}'.", name);
+            return ShaderCreationInfo::make_invalid();
+        }
+        if (bundle->argument_types.size() != arg_types.size()) {
+            LUISA_WARNING_WITH_LOCATION(
+                "Shader bundle '{}' expects {} arguments but {} are given.",
+                name, bundle->argument_types.size(), arg_types.size());
+            return ShaderCreationInfo::make_invalid();
+        }
+        for (auto i = 0u; i < arg_types.size(); i++) {
+            if (bundle->argument_types[i] != arg_types[i]->description()) {
+                LUISA_WARNING_WITH_LOCATION(
+                    "Argument #{} of shader bundle '{}' has type {} but {} is given.",
+                    i, name, bundle->argument_types[i], arg_types[i]->description());
+                return ShaderCreationInfo::make_invalid();
+            }
+        }
+        auto shader = device.create_shader_from_artifact(
+            device.device,
+            reinterpret_cast<const uint8_t *>(bundle->artifact.data()),
+            bundle->artifact.size(), nullptr, 0u);
+        ShaderCreationInfo info{};
+        info.block_size[0] = shader.block_size[0];
+        info.block_size[1] = shader.block_size[1];
+        info.block_size[2] = shader.block_size[2];
+        info.handle = shader.resource.handle;
+        info.native_handle = shader.resource.native_handle;
+        if (!info.valid()) {
+            LUISA_WARNING_WITH_LOCATION(
+                "Shader bundle '{}' was built with a different LLVM or "
+                "compiler options and cannot be loaded.",
+                name);
+            return info;
+        }
+        _register_shader(info.handle, luisa::string{name}, std::move(bundle->argument_usages));
+        return info;
     }
 
     Usage shader_argument_usage(uint64_t handle, size_t index) noexcept override {
-        LUISA_NOT_IMPLEMENTED();
+        std::scoped_lock lock{shader_mutex};
+        auto iter = shader_argument_usages.find(handle);
+        // shaders created from IR modules do not record usages
+        if (iter == shader_argument_usages.end()) { return Usage::READ_WRITE; }
+        LUISA_ASSERT(index < iter->second.size(),
+                     "Argument index {} out of range {}.",
+                     index, iter->second.size());
+        return iter->second[index];
     }
 
     void destroy_shader(uint64_t handle) noexcept override {
+        {
+            std::scoped_lock lock{shader_mutex};
+            shader_argument_usages.erase(handle);
+        }
+        profiling_ext->remove_shader(handle);
         device.destroy_shader(device.device, api::Shader{handle});
     }
 
@@ -553,10 +1290,12 @@ public:
     }
 
     void signal_event(uint64_t handle, uint64_t stream_handle, uint64_t value) noexcept override {
+        profiling_ext->record_event(stream_handle, ProfilingRecord::Kind::EVENT_SIGNAL, value);
         device.signal_event(device.device, api::Event{handle}, api::Stream{stream_handle}, value);
     }
 
     void wait_event(uint64_t handle, uint64_t stream_handle, uint64_t value) noexcept override {
+        profiling_ext->record_event(stream_handle, ProfilingRecord::Kind::EVENT_WAIT, value);
         device.wait_event(device.device, api::Event{handle}, api::Stream{stream_handle}, value);
     }
 
@@ -624,6 +1363,25 @@ public:
 
     void set_name(luisa::compute::Resource::Tag resource_tag, uint64_t resource_handle,
                   luisa::string_view name) noexcept override {
+        if (resource_tag == Resource::Tag::SHADER) {
+            profiling_ext->set_shader_name(resource_handle, name);
+        }
+    }
+
+    DeviceExtension *extension(luisa::string_view name) noexcept override {
+        if (name == ProfilingExt::name) { return profiling_ext.get(); }
+        if (name == DStorageExt::name) { return dstorage_ext.get(); }
+        if (name == DenoiserExt::name) { return denoiser_ext.get(); }
+#ifdef LUISA_ENABLE_DSL
+        if (name == RasterExt::name) { return raster_ext.get(); }
+#endif
+        if (name == TexCompressExt::name) {
+            std::scoped_lock lock{tex_compress_ext_mutex};
+            if (tex_compress_ext == nullptr) { tex_compress_ext = luisa::make_unique<cpu::CPUTexCompressExt>(); }
+            return tex_compress_ext.get();
+        }
+        LUISA_WARNING_WITH_LOCATION("Unknown device extension '{}'.", name);
+        return nullptr;
     }
 };
 
@@ -631,8 +1389,37 @@ luisa::compute::DeviceInterface *create(luisa::compute::Context &&ctx,
                                         const luisa::compute::DeviceConfig *config,
                                         luisa::string_view name) noexcept {
     auto path = ctx.runtime_directory();
+    auto io = config == nullptr ? nullptr : config->binary_io;
+    // the backend takes its config as JSON, and only a CPUDeviceConfigExt changes its defaults
+    luisa::string json{"{}"};
+    if (config != nullptr && config->extension != nullptr) {
+        using luisa::compute::CPUDeviceConfigExt;
+        if (auto ext = dynamic_cast<const CPUDeviceConfigExt *>(config->extension.get())) {
+            auto huge_pages = [&] {
+                switch (ext->huge_pages) {
+                    case CPUDeviceConfigExt::HugePages::TRANSPARENT: return "transparent";
+                    case CPUDeviceConfigExt::HugePages::EXPLICIT: return "explicit";
+                    default: break;
+                }
+                return "none";
+            }();
+            auto placement = [&] {
+                switch (ext->placement) {
+                    case CPUDeviceConfigExt::Placement::INTERLEAVED: return "interleaved";
+                    case CPUDeviceConfigExt::Placement::FIRST_TOUCH: return "first_touch";
+                    default: break;
+                }
+                return "default";
+            }();
+            json = luisa::format(R"({{"memory":{{"huge_pages":"{}","placement":"{}","pin_workers":{},"large_threshold":{}}}}})",
+                                 huge_pages, placement, ext->pin_workers, ext->large_threshold);
+        } else {
+            LUISA_WARNING_WITH_LOCATION("Ignoring device config extension that is not "
+                                        "a CPUDeviceConfigExt for the CPU backend.");
+        }
+    }
     return luisa::new_with_allocator<luisa::compute::rust::RustDevice>(
-        std::move(ctx), std::move(path), "cpu");
+        std::move(ctx), std::move(path), "cpu", io, json);
 }
 
 void destroy(luisa::compute::DeviceInterface *device) noexcept {
@@ -1,8 +1,7 @@
 #include <array>
 
 #include <luisa/core/platform.h>
-#include <luisa/core/stl/format.h>
-#include <luisa/core/logging.h>
+#include <luisa/vstl/vstring.h>
 
 #include "string_scratch.h"
 
@@ -10,19 +9,25 @@ namespace luisa::compute {
 
 namespace detail {
 
+// formats numbers into a stack buffer without going through fmt, as
+// literals and variable names make up a large part of the generated code
 template<typename T>
-inline auto to_string(T x) noexcept {
-    static thread_local std::array<char, 128u> s;
-    auto [iter, size] = [x] {
-        if constexpr (std::is_floating_point_v<T>) {
-            return fmt::format_to_n(s.data(), s.size(), FMT_STRING("{:a}"), x);
-        } else {
-            return fmt::format_to_n(s.data(), s.size(), FMT_STRING("{}"), x);
-        }
-    }();
-    LUISA_ASSERT(iter == s.data() + size,
-                 "No enough storage converting '{}' to string.", x);
-    return std::string_view{s.data(), size};
+inline void append_number(luisa::string &buffer, T x) noexcept {
+    std::array<char, 32u> s;
+    auto end = s.data() + s.size();
+    auto begin = end;
+    if constexpr (std::is_floating_point_v<T>) {
+        // hexadecimal to represent the value exactly, same as "%a"
+        begin = vstd::HexFloat_to_buff(end, static_cast<double>(x));
+    } else if constexpr (std::is_signed_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        auto u = static_cast<U>(x);
+        begin = vstd::UIntegral_to_buff(end, x < 0 ? static_cast<U>(0u - u) : u);
+        if (x < 0) { *--begin = '-'; }
+    } else {
+        begin = vstd::UIntegral_to_buff(end, x);
+    }
+    buffer.append(begin, end);
 }
 
 }// namespace detail
@@ -36,12 +41,12 @@ StringScratch::StringScratch() noexcept : StringScratch{std::min<size_t>(luisa::
 StringScratch &StringScratch::operator<<(std::string_view s) noexcept { return _buffer.append(s), *this; }
 StringScratch &StringScratch::operator<<(const char *s) noexcept { return *this << std::string_view{s}; }
 StringScratch &StringScratch::operator<<(const std::string &s) noexcept { return *this << std::string_view{s}; }
-StringScratch &StringScratch::operator<<(bool x) noexcept { return *this << detail::to_string(x); }
-StringScratch &StringScratch::operator<<(float x) noexcept { return *this << detail::to_string(x); }
-StringScratch &StringScratch::operator<<(double x) noexcept { return *this << detail::to_string(x); }
-StringScratch &StringScratch::operator<<(int x) noexcept { return *this << detail::to_string(x); }
-StringScratch &StringScratch::operator<<(uint x) noexcept { return *this << detail::to_string(x); }
-StringScratch &StringScratch::operator<<(size_t x) noexcept { return *this << detail::to_string(x); }
+StringScratch &StringScratch::operator<<(bool x) noexcept { return *this << (x ? "true" : "false"); }
+StringScratch &StringScratch::operator<<(float x) noexcept { return detail::append_number(_buffer, x), *this; }
+StringScratch &StringScratch::operator<<(double x) noexcept { return detail::append_number(_buffer, x), *this; }
+StringScratch &StringScratch::operator<<(int x) noexcept { return detail::append_number(_buffer, x), *this; }
+StringScratch &StringScratch::operator<<(uint x) noexcept { return detail::append_number(_buffer, x), *this; }
+StringScratch &StringScratch::operator<<(size_t x) noexcept { return detail::append_number(_buffer, x), *this; }
 const luisa::string &StringScratch::string() const noexcept { return _buffer; }
 luisa::string_view StringScratch::string_view() const noexcept { return _buffer; }
 const char *StringScratch::c_str() const noexcept { return _buffer.c_str(); }
@@ -50,5 +55,6 @@ size_t StringScratch::size() const noexcept { return _buffer.size(); }
 void StringScratch::pop_back() noexcept { _buffer.pop_back(); }
 void StringScratch::clear() noexcept { _buffer.clear(); }
 char StringScratch::back() const noexcept { return _buffer.back(); }
+void StringScratch::reserve(size_t size) noexcept { _buffer.reserve(size); }
 
 }// namespace luisa::compute
@@ -29,6 +29,7 @@ public:
     [[nodiscard]] size_t size() const noexcept;
     void pop_back() noexcept;
     void clear() noexcept;
+    void reserve(size_t size) noexcept;
     [[nodiscard]] char back() const noexcept;
 };
 
@@ -0,0 +1,770 @@
+#include <array>
+#include <algorithm>
+#include <cstring>
+
+#include "cpu_deflate.h"
+
+namespace luisa::compute::cpu {
+
+namespace detail {
+
+static constexpr auto deflate_window_size = 32768u;
+static constexpr auto deflate_min_match = 3u;
+static constexpr auto deflate_max_match = 258u;
+static constexpr auto deflate_max_code_length = 15u;
+static constexpr auto deflate_max_code_length_code_length = 7u;
+static constexpr auto deflate_litlen_symbol_count = 288u;
+static constexpr auto deflate_dist_symbol_count = 32u;
+static constexpr auto deflate_end_of_block = 256u;
+
+static constexpr std::array<uint16_t, 29u> deflate_length_base{
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static constexpr std::array<uint8_t, 29u> deflate_length_extra{
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static constexpr std::array<uint16_t, 30u> deflate_dist_base{
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static constexpr std::array<uint8_t, 30u> deflate_dist_extra{
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+static constexpr std::array<uint8_t, 19u> deflate_code_length_order{
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+[[nodiscard]] static auto deflate_fixed_litlen_lengths() noexcept {
+    std::array<uint8_t, deflate_litlen_symbol_count> lengths{};
+    for (auto i = 0u; i < 144u; i++) { lengths[i] = 8u; }
+    for (auto i = 144u; i < 256u; i++) { lengths[i] = 9u; }
+    for (auto i = 256u; i < 280u; i++) { lengths[i] = 7u; }
+    for (auto i = 280u; i < 288u; i++) { lengths[i] = 8u; }
+    return lengths;
+}
+
+[[nodiscard]] static auto deflate_fixed_dist_lengths() noexcept {
+    std::array<uint8_t, deflate_dist_symbol_count> lengths{};
+    lengths.fill(5u);
+    return lengths;
+}
+
+[[nodiscard]] static auto deflate_reverse_bits(uint code, uint length) noexcept {
+    auto r = 0u;
+    for (auto i = 0u; i < length; i++) {
+        r = (r << 1u) | (code & 1u);
+        code >>= 1u;
+    }
+    return r;
+}
+
+// maps lengths and distances to their symbols, built once
+struct DeflateSymbolTables {
+    std::array<uint8_t, deflate_max_match + 1u> length_code{};
+    std::array<uint8_t, 512u> dist_code{};
+    DeflateSymbolTables() noexcept {
+        for (auto code = 0u; code < deflate_length_base.size(); code++) {
+            auto base = deflate_length_base[code];
+            auto count = code + 1u == deflate_length_base.size() ? 1u : 1u << deflate_length_extra[code];
+            for (auto i = 0u; i < count && base + i <= deflate_max_match; i++) {
+                length_code[base + i] = static_cast<uint8_t>(code);
+            }
+        }
+        // distances up to 256 are looked up directly, larger ones by (dist - 1) >> 7
+        for (auto code = 0u; code < deflate_dist_base.size(); code++) {
+            auto base = deflate_dist_base[code];
+            auto count = 1u << deflate_dist_extra[code];
+            for (auto i = 0u; i < count; i++) {
+                auto d = base + i - 1u;
+                if (d < 256u) {
+                    dist_code[d] = static_cast<uint8_t>(code);
+                } else {
+                    dist_code[256u + (d >> 7u)] = static_cast<uint8_t>(code);
+                }
+            }
+        }
+    }
+    [[nodiscard]] auto dist(uint d) const noexcept {
+        return d <= 256u ? dist_code[d - 1u] : dist_code[256u + ((d - 1u) >> 7u)];
+    }
+};
+
+[[nodiscard]] static const auto &deflate_symbol_tables() noexcept {
+    static const DeflateSymbolTables tables;
+    return tables;
+}
+
+/* ----------------------------------- compression ----------------------------------- */
+
+class DeflateBitWriter {
+
+private:
+    luisa::vector<std::byte> &_output;
+    uint64_t _buffer{0u};
+    uint _count{0u};
+
+public:
+    explicit DeflateBitWriter(luisa::vector<std::byte> &output) noexcept : _output{output} {}
+    void put(uint bits, uint n) noexcept {
+        _buffer |= static_cast<uint64_t>(bits) << _count;
+        _count += n;
+        while (_count >= 8u) {
+            _output.emplace_back(static_cast<std::byte>(_buffer & 0xffu));
+            _buffer >>= 8u;
+            _count -= 8u;
+        }
+    }
+    void align() noexcept {
+        if (_count != 0u) { put(0u, 8u - _count); }
+    }
+    void put_bytes(const std::byte *data, size_t size) noexcept {
+        _output.insert(_output.end(), data, data + size);
+    }
+    [[nodiscard]] auto pending_bits() const noexcept { return _count; }
+};
+
+struct DeflateHuffmanCode {
+    std::array<uint16_t, deflate_litlen_symbol_count> codes{};
+    std::array<uint8_t, deflate_litlen_symbol_count> lengths{};
+    void assign(const uint8_t *lengths_in, uint n) noexcept {
+        std::array<uint, deflate_max_code_length + 2u> counts{};
+        for (auto i = 0u; i < n; i++) { counts[lengths_in[i]]++; }
+        counts[0] = 0u;
+        std::array<uint, deflate_max_code_length + 2u> next{};
+        auto code = 0u;
+        for (auto len = 1u; len <= deflate_max_code_length; len++) {
+            code = (code + counts[len - 1u]) << 1u;
+            next[len] = code;
+        }
+        for (auto i = 0u; i < n; i++) {
+            auto len = lengths_in[i];
+            lengths[i] = len;
+            codes[i] = len == 0u ? 0u : static_cast<uint16_t>(deflate_reverse_bits(next[len]++, len));
+        }
+    }
+    void put(DeflateBitWriter &writer, uint symbol) const noexcept {
+        writer.put(codes[symbol], lengths[symbol]);
+    }
+};
+
+// Huffman code lengths limited to max_length, at least two symbols are always
+// coded so that every decoder sees a complete prefix code
+static void deflate_build_lengths(const uint *freqs, uint n, uint max_length, uint8_t *lengths) noexcept {
+    std::fill_n(lengths, n, static_cast<uint8_t>(0u));
+    struct Node {
+        uint freq;
+        int left;
+        int right;
+    };
+    std::array<Node, 2u * deflate_litlen_symbol_count> nodes{};
+    std::array<uint, deflate_litlen_symbol_count> symbols{};
+    auto symbol_count = 0u;
+    for (auto i = 0u; i < n; i++) {
+        if (freqs[i] != 0u) { symbols[symbol_count++] = i; }
+    }
+    for (auto i = 0u; symbol_count < 2u && i < n; i++) {
+        if (freqs[i] == 0u) { symbols[symbol_count++] = i; }
+    }
+    std::sort(symbols.begin(), symbols.begin() + symbol_count, [freqs](auto a, auto b) noexcept {
+        return freqs[a] == freqs[b] ? a < b : freqs[a] < freqs[b];
+    });
+    // two-queue Huffman construction over the sorted leaves
+    for (auto i = 0u; i < symbol_count; i++) {
+        nodes[i] = {std::max(freqs[symbols[i]], 1u), -1, -1};
+    }
+    auto leaf = 0u, internal_begin = symbol_count, internal_end = symbol_count;
+    auto pick = [&]() noexcept {
+        if (leaf < symbol_count &&
+            (internal_begin == internal_end || nodes[leaf].freq <= nodes[internal_begin].freq)) {
+            return static_cast<int>(leaf++);
+        }
+        return static_cast<int>(internal_begin++);
+    };
+    for (auto i = 1u; i < symbol_count; i++) {
+        auto a = pick();
+        auto b = pick();
+        nodes[internal_end++] = {nodes[a].freq + nodes[b].freq, a, b};
+    }
+    std::array<uint, 2u * deflate_litlen_symbol_count> depths{};
+    std::array<uint, deflate_max_code_length + 1u> length_counts{};
+    for (auto i = internal_end - 1u; i >= symbol_count; i--) {
+        auto node = nodes[i];
+        depths[node.left] = depths[i] + 1u;
+        depths[node.right] = depths[i] + 1u;
+    }
+    for (auto i = 0u; i < symbol_count; i++) {
+        length_counts[std::min(depths[i], max_length)]++;
+    }
+    // fix up the Kraft sum after clamping overlong codes
+    auto total = 0u;
+    for (auto len = 1u; len <= max_length; len++) {
+        total += length_counts[len] << (max_length - len);
+    }
+    while (total > (1u << max_length)) {
+        length_counts[max_length]--;
+        for (auto len = max_length - 1u; len > 0u; len--) {
+            if (length_counts[len] != 0u) {
+                length_counts[len]--;
+                length_counts[len + 1u] += 2u;
+                break;
+            }
+        }
+        total--;
+    }
+    // the most frequent symbols get the shortest codes
+    auto s = symbol_count;
+    for (auto len = 1u; len <= max_length; len++) {
+        for (auto i = 0u; i < length_counts[len]; i++) {
+            lengths[symbols[--s]] = static_cast<uint8_t>(len);
+        }
+    }
+}
+
+struct DeflateSymbol {
+    uint16_t length;// 0 for literals
+    uint16_t value; // literal byte or match distance
+};
+
+class DeflateEncoder {
+
+private:
+    static constexpr auto hash_bits = 15u;
+    static constexpr auto hash_size = 1u << hash_bits;
+    static constexpr auto max_block_symbols = 16384u;
+
+private:
+    const std::byte *_data;
+    uint _size;
+    uint _max_chain;
+    uint _nice_length;
+    bool _lazy;
+    luisa::vector<int> _head;
+    luisa::vector<int> _prev;
+    luisa::vector<DeflateSymbol> _symbols;
+    DeflateBitWriter _writer;
+
+private:
+    [[nodiscard]] auto _byte(uint i) const noexcept { return static_cast<uint>(_data[i]); }
+    [[nodiscard]] auto _hash(uint i) const noexcept {
+        return ((_byte(i) << 10u) ^ (_byte(i + 1u) << 5u) ^ _byte(i + 2u)) & (hash_size - 1u);
+    }
+    void _insert(uint i) noexcept {
+        if (i + deflate_min_match > _size) { return; }
+        auto h = _hash(i);
+        _prev[i & (deflate_window_size - 1u)] = _head[h];
+        _head[h] = static_cast<int>(i);
+    }
+    // returns (length, distance) of the longest match at i, length 0 if none
+    [[nodiscard]] std::pair<uint, uint> _match(uint i) const noexcept {
+        if (i + deflate_min_match > _size) { return {0u, 0u}; }
+        auto max_length = std::min(deflate_max_match, _size - i);
+        auto best_length = deflate_min_match - 1u;
+        auto best_dist = 0u;
+        auto candidate = _head[_hash(i)];
+        for (auto chain = _max_chain; candidate >= 0 && chain != 0u; chain--) {
+            auto c = static_cast<uint>(candidate);
+            auto dist = i - c;
+            if (dist == 0u || dist > deflate_window_size) { break; }
+            if (_data[c + best_length] == _data[i + best_length]) {
+                auto length = 0u;
+                while (length < max_length && _data[c + length] == _data[i + length]) { length++; }
+                if (length > best_length) {
+                    best_length = length;
+                    best_dist = dist;
+                    if (length >= _nice_length || length == max_length) { break; }
+                }
+            }
+            auto next = _prev[c & (deflate_window_size - 1u)];
+            if (next >= candidate) { break; }
+            candidate = next;
+        }
+        if (best_dist == 0u) { return {0u, 0u}; }
+        return {best_length, best_dist};
+    }
+
+    void _write_stored(uint begin, uint end, bool final) noexcept {
+        do {
+            auto size = std::min(end - begin, 65535u);
+            auto last = final && begin + size == end;
+            _writer.put(last ? 1u : 0u, 1u);
+            _writer.put(0u, 2u);
+            _writer.align();
+            _writer.put(size, 16u);
+            _writer.put(~size & 0xffffu, 16u);
+            _writer.put_bytes(_data + begin, size);
+            begin += size;
+        } while (begin < end);
+    }
+
+    void _write_symbols(const DeflateHuffmanCode &litlen, const DeflateHuffmanCode &dist) noexcept {
+        auto &&tables = deflate_symbol_tables();
+        for (auto s : _symbols) {
+            if (s.length == 0u) {
+                litlen.put(_writer, s.value);
+            } else {
+                auto lc = tables.length_code[s.length];
+                litlen.put(_writer, 257u + lc);
+                _writer.put(s.length - deflate_length_base[lc], deflate_length_extra[lc]);
+                auto dc = tables.dist(s.value);
+                dist.put(_writer, dc);
+                _writer.put(s.value - deflate_dist_base[dc], deflate_dist_extra[dc]);
+            }
+        }
+        litlen.put(_writer, deflate_end_of_block);
+    }
+
+    void _flush(uint begin, uint end, bool final) noexcept {
+        auto &&tables = deflate_symbol_tables();
+        std::array<uint, deflate_litlen_symbol_count> litlen_freqs{};
+        std::array<uint, deflate_dist_symbol_count> dist_freqs{};
+        auto extra_bits = 0ull;
+        for (auto s : _symbols) {
+            if (s.length == 0u) {
+                litlen_freqs[s.value]++;
+            } else {
+                auto lc = tables.length_code[s.length];
+                auto dc = tables.dist(s.value);
+                litlen_freqs[257u + lc]++;
+                dist_freqs[dc]++;
+                extra_bits += deflate_length_extra[lc] + deflate_dist_extra[dc];
+            }
+        }
+        litlen_freqs[deflate_end_of_block] = 1u;
+
+        // dynamic code
+        std::array<uint8_t, deflate_litlen_symbol_count> litlen_lengths{};
+        std::array<uint8_t, deflate_dist_symbol_count> dist_lengths{};
+        deflate_build_lengths(litlen_freqs.data(), 286u, deflate_max_code_length, litlen_lengths.data());
+        deflate_build_lengths(dist_freqs.data(), 30u, deflate_max_code_length, dist_lengths.data());
+        auto hlit = 286u;
+        while (hlit > 257u && litlen_lengths[hlit - 1u] == 0u) { hlit--; }
+        auto hdist = 30u;
+        while (hdist > 1u && dist_lengths[hdist - 1u] == 0u) { hdist--; }
+
+        // run-length encode the code lengths
+        std::array<uint8_t, 286u + 30u> sequence{};
+        std::copy_n(litlen_lengths.data(), hlit, sequence.data());
+        std::copy_n(dist_lengths.data(), hdist, sequence.data() + hlit);
+        auto sequence_length = hlit + hdist;
+        luisa::vector<std::pair<uint8_t, uint8_t>> runs;// (symbol, extra)
+        runs.reserve(sequence_length);
+        for (auto i = 0u; i < sequence_length;) {
+            auto value = sequence[i];
+            auto run = 1u;
+            while (i + run < sequence_length && sequence[i + run] == value) { run++; }
+            i += run;
+            if (value == 0u) {
+                while (run >= 11u) {
+                    auto r = std::min(run, 138u);
+                    runs.emplace_back(18u, static_cast<uint8_t>(r - 11u));
+                    run -= r;
+                }
+                if (run >= 3u) {
+                    runs.emplace_back(17u, static_cast<uint8_t>(run - 3u));
+                    run = 0u;
+                }
+            } else {
+                runs.emplace_back(value, 0u);
+                run--;
+                while (run >= 3u) {
+                    auto r = std::min(run, 6u);
+                    runs.emplace_back(16u, static_cast<uint8_t>(r - 3u));
+                    run -= r;
+                }
+            }
+            for (; run != 0u; run--) { runs.emplace_back(value, 0u); }
+        }
+        std::array<uint, 19u> code_length_freqs{};
+        for (auto [symbol, _] : runs) { code_length_freqs[symbol]++; }
+        std::array<uint8_t, 19u> code_length_lengths{};
+        deflate_build_lengths(code_length_freqs.data(), 19u, deflate_max_code_length_code_length,
+                              code_length_lengths.data());
+        auto hclen = 19u;
+        while (hclen > 4u && code_length_lengths[deflate_code_length_order[hclen - 1u]] == 0u) { hclen--; }
+
+        auto dynamic_bits = 3ull + 5u + 5u + 4u + 3u * hclen + extra_bits;
+        for (auto [symbol, _] : runs) {
+            dynamic_bits += code_length_lengths[symbol] +
+                            (symbol == 16u ? 2u : symbol == 17u ? 3u :
+                                             symbol == 18u      ? 7u :
+                                                                  0u);
+        }
+        for (auto i = 0u; i < 286u; i++) { dynamic_bits += static_cast<uint64_t>(litlen_freqs[i]) * litlen_lengths[i]; }
+        for (auto i = 0u; i < 30u; i++) { dynamic_bits += static_cast<uint64_t>(dist_freqs[i]) * dist_lengths[i]; }
+
+        // fixed code
+        static const auto fixed_litlen_lengths = deflate_fixed_litlen_lengths();
+        static const auto fixed_dist_lengths = deflate_fixed_dist_lengths();
+        auto fixed_bits = 3ull + extra_bits;
+        for (auto i = 0u; i < 286u; i++) { fixed_bits += static_cast<uint64_t>(litlen_freqs[i]) * fixed_litlen_lengths[i]; }
+        for (auto i = 0u; i < 30u; i++) { fixed_bits += static_cast<uint64_t>(dist_freqs[i]) * fixed_dist_lengths[i]; }
+
+        // stored blocks, including the padding to the byte boundary
+        auto stored_pieces = std::max((end - begin + 65534u) / 65535u, 1u);
+        auto stored_bits = (end - begin) * 8ull + stored_pieces * (3u + 32u) +
+                           (8u - (_writer.pending_bits() + 3u) % 8u) % 8u;
+
+        if (stored_bits <= std::min(dynamic_bits, fixed_bits)) {
+            _write_stored(begin, end, final);
+        } else if (fixed_bits <= dynamic_bits) {
+            DeflateHuffmanCode litlen, dist;
+            litlen.assign(fixed_litlen_lengths.data(), deflate_litlen_symbol_count);
+            dist.assign(fixed_dist_lengths.data(), deflate_dist_symbol_count);
+            _writer.put(final ? 1u : 0u, 1u);
+            _writer.put(1u, 2u);
+            _write_symbols(litlen, dist);
+        } else {
+            DeflateHuffmanCode litlen, dist, code_length;
+            litlen.assign(litlen_lengths.data(), 286u);
+            dist.assign(dist_lengths.data(), 30u);
+            code_length.assign(code_length_lengths.data(), 19u);
+            _writer.put(final ? 1u : 0u, 1u);
+            _writer.put(2u, 2u);
+            _writer.put(hlit - 257u, 5u);
+            _writer.put(hdist - 1u, 5u);
+            _writer.put(hclen - 4u, 4u);
+            for (auto i = 0u; i < hclen; i++) {
+                _writer.put(code_length_lengths[deflate_code_length_order[i]], 3u);
+            }
+            for (auto [symbol, extra] : runs) {
+                code_length.put(_writer, symbol);
+                if (symbol == 16u) {
+                    _writer.put(extra, 2u);
+                } else if (symbol == 17u) {
+                    _writer.put(extra, 3u);
+                } else if (symbol == 18u) {
+                    _writer.put(extra, 7u);
+                }
+            }
+            _write_symbols(litlen, dist);
+        }
+        _symbols.clear();
+    }
+
+public:
+    DeflateEncoder(luisa::span<const std::byte> input, uint level,
+                   luisa::vector<std::byte> &output) noexcept
+        : _data{input.data()},
+          _size{static_cast<uint>(input.size())},
+          _max_chain{level == 0u ? 8u : level == 1u ? 64u :
+                                                      1024u},
+          _nice_length{level == 0u ? 32u : level == 1u ? 128u :
+                                                         deflate_max_match},
+          _lazy{level != 0u},
+          _head(hash_size, -1),
+          _prev(deflate_window_size, -1),
+          _writer{output} { _symbols.reserve(max_block_symbols); }
+
+    void encode() noexcept {
+        auto block_begin = 0u;
+        auto emit = [&](DeflateSymbol s, uint end) noexcept {
+            _symbols.emplace_back(s);
+            if (_symbols.size() == max_block_symbols) {
+                _flush(block_begin, end, end == _size);
+                block_begin = end;
+            }
+        };
+        auto i = 0u;
+        while (i < _size) {
+            auto [length, dist] = _match(i);
+            if (_lazy && length >= deflate_min_match && length < _nice_length && i + 1u < _size) {
+                // emit a literal instead if the next position starts a longer match
+                _insert(i);
+                auto [next_length, next_dist] = _match(i + 1u);
+                if (next_length <= length) {
+                    emit({static_cast<uint16_t>(length), static_cast<uint16_t>(dist)}, i + length);
+                    for (auto j = i + 1u; j < i + length; j++) { _insert(j); }
+                    i += length;
+                    continue;
+                }
+                emit({0u, static_cast<uint16_t>(_data[i])}, i + 1u);
+                i++;
+                length = next_length;
+                dist = next_dist;
+            }
+            if (length >= deflate_min_match) {
+                emit({static_cast<uint16_t>(length), static_cast<uint16_t>(dist)}, i + length);
+                for (auto j = i; j < i + length; j++) { _insert(j); }
+                i += length;
+            } else {
+                emit({0u, static_cast<uint16_t>(_data[i])}, i + 1u);
+                _insert(i);
+                i++;
+            }
+        }
+        if (!_symbols.empty() || block_begin == 0u) {
+            _flush(block_begin, _size, true);
+        }
+        _writer.align();
+    }
+};
+
+/* ---------------------------------- decompression ---------------------------------- */
+
+class DeflateBitReader {
+
+private:
+    const uint8_t *_p;
+    const uint8_t *_end;
+    uint64_t _buffer{0u};
+    uint _count{0u};
+    uint _overrun{0u};
+
+public:
+    DeflateBitReader(const uint8_t *data, size_t size) noexcept
+        : _p{data}, _end{data + size} {}
+    // keeps at least 56 bits available, padding with zeros past the end
+    void refill() noexcept {
+        while (_count <= 56u) {
+            uint64_t byte = 0u;
+            if (_p < _end) {
+                byte = *_p++;
+            } else {
+                _overrun++;
+            }
+            _buffer |= byte << _count;
+            _count += 8u;
+        }
+    }
+    [[nodiscard]] auto peek() const noexcept { return _buffer; }
+    void consume(uint n) noexcept {
+        _buffer >>= n;
+        _count -= n;
+    }
+    [[nodiscard]] auto bits(uint n) noexcept {
+        if (_count < n) { refill(); }
+        auto value = static_cast<uint>(_buffer & ((1ull << n) - 1u));
+        consume(n);
+        return value;
+    }
+    void align() noexcept { consume(_count & 7u); }
+    // reads whole bytes, the bit buffer must be byte-aligned
+    [[nodiscard]] bool read_bytes(uint8_t *dst, size_t size) noexcept {
+        if (overrun()) { return false; }
+        auto buffered = _count / 8u - _overrun;
+        if (size > buffered + static_cast<size_t>(_end - _p)) { return false; }
+        auto n = std::min<size_t>(size, buffered);
+        for (auto i = 0u; i < n; i++) {
+            dst[i] = static_cast<uint8_t>(_buffer & 0xffu);
+            consume(8u);
+        }
+        if (n == buffered) {
+            // only zero padding is left in the buffer
+            _buffer = 0u;
+            _count = 0u;
+            _overrun = 0u;
+        }
+        std::memcpy(dst + n, _p, size - n);
+        _p += size - n;
+        return true;
+    }
+    // whether any of the zero padding has been consumed
+    [[nodiscard]] bool overrun() const noexcept { return _overrun * 8u > _count; }
+};
+
+class DeflateHuffmanTable {
+
+public:
+    static constexpr auto fast_bits = 10u;
+
+private:
+    // (symbol << 4) | length, 0 if the code is longer than fast_bits
+    std::array<uint16_t, 1u << fast_bits> _fast{};
+    std::array<uint16_t, deflate_max_code_length + 1u> _counts{};
+    std::array<uint16_t, deflate_litlen_symbol_count> _symbols{};
+
+public:
+    // incomplete codes are accepted as other encoders emit them for single symbols
+    [[nodiscard]] bool build(const uint8_t *lengths, uint n) noexcept {
+        _fast.fill(0u);
+        _counts.fill(0u);
+        for (auto i = 0u; i < n; i++) { _counts[lengths[i]]++; }
+        _counts[0] = 0u;
+        auto left = 1;
+        for (auto len = 1u; len <= deflate_max_code_length; len++) {
+            left <<= 1;
+            left -= _counts[len];
+            if (left < 0) { return false; }
+        }
+        std::array<uint16_t, deflate_max_code_length + 2u> offsets{};
+        for (auto len = 1u; len <= deflate_max_code_length; len++) {
+            offsets[len + 1u] = offsets[len] + _counts[len];
+        }
+        std::array<uint, deflate_max_code_length + 1u> next{};
+        auto code = 0u;
+        for (auto len = 1u; len <= deflate_max_code_length; len++) {
+            code = (code + _counts[len - 1u]) << 1u;
+            next[len] = code;
+        }
+        for (auto i = 0u; i < n; i++) {
+            auto len = lengths[i];
+            if (len == 0u) { continue; }
+            _symbols[offsets[len]++] = static_cast<uint16_t>(i);
+            auto c = next[len]++;
+            if (len <= fast_bits) {
+                auto entry = static_cast<uint16_t>((i << 4u) | len);
+                for (auto r = deflate_reverse_bits(c, len); r < (1u << fast_bits); r += 1u << len) {
+                    _fast[r] = entry;
+                }
+            }
+        }
+        return true;
+    }
+    // the reader must hold at least 15 bits
+    [[nodiscard]] int decode(DeflateBitReader &reader) const noexcept {
+        auto bits = reader.peek();
+        if (auto entry = _fast[bits & ((1u << fast_bits) - 1u)]; entry != 0u) {
+            reader.consume(entry & 15u);
+            return entry >> 4u;
+        }
+        auto code = 0, first = 0, index = 0;
+        for (auto len = 1u; len <= deflate_max_code_length; len++) {
+            code |= static_cast<int>((bits >> (len - 1u)) & 1u);
+            auto count = static_cast<int>(_counts[len]);
+            if (code - count < first) {
+                reader.consume(len);
+                return _symbols[index + (code - first)];
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+};
+
+class DeflateDecoder {
+
+private:
+    DeflateBitReader _reader;
+    uint8_t *_out;
+    size_t _size;
+    size_t _offset{0u};
+    DeflateHuffmanTable _litlen;
+    DeflateHuffmanTable _dist;
+
+private:
+    [[nodiscard]] bool _stored() noexcept {
+        _reader.align();
+        auto size = _reader.bits(16u);
+        auto check = _reader.bits(16u);
+        if ((size ^ 0xffffu) != check || size > _size - _offset) { return false; }
+        if (!_reader.read_bytes(_out + _offset, size)) { return false; }
+        _offset += size;
+        return true;
+    }
+
+    [[nodiscard]] bool _dynamic() noexcept {
+        _reader.refill();
+        auto hlit = _reader.bits(5u) + 257u;
+        auto hdist = _reader.bits(5u) + 1u;
+        auto hclen = _reader.bits(4u) + 4u;
+        if (hlit > 286u || hdist > 30u) { return false; }
+        std::array<uint8_t, 19u> code_length_lengths{};
+        for (auto i = 0u; i < hclen; i++) {
+            code_length_lengths[deflate_code_length_order[i]] = static_cast<uint8_t>(_reader.bits(3u));
+        }
+        DeflateHuffmanTable code_length;
+        if (!code_length.build(code_length_lengths.data(), 19u)) { return false; }
+        std::array<uint8_t, 286u + 30u> lengths{};
+        for (auto i = 0u; i < hlit + hdist;) {
+            _reader.refill();
+            auto symbol = code_length.decode(_reader);
+            if (symbol < 0) { return false; }
+            if (symbol < 16) {
+                lengths[i++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+            auto value = 0u, repeat = 0u;
+            if (symbol == 16) {
+                if (i == 0u) { return false; }
+                value = lengths[i - 1u];
+                repeat = 3u + _reader.bits(2u);
+            } else if (symbol == 17) {
+                repeat = 3u + _reader.bits(3u);
+            } else {
+                repeat = 11u + _reader.bits(7u);
+            }
+            if (i + repeat > hlit + hdist) { return false; }
+            for (; repeat != 0u; repeat--) { lengths[i++] = static_cast<uint8_t>(value); }
+        }
+        if (lengths[deflate_end_of_block] == 0u) { return false; }
+        return _litlen.build(lengths.data(), hlit) &&
+               _dist.build(lengths.data() + hlit, hdist) &&
+               _codes();
+    }
+
+    [[nodiscard]] bool _fixed() noexcept {
+        static const auto litlen_lengths = deflate_fixed_litlen_lengths();
+        static const auto dist_lengths = deflate_fixed_dist_lengths();
+        return _litlen.build(litlen_lengths.data(), deflate_litlen_symbol_count) &&
+               _dist.build(dist_lengths.data(), deflate_dist_symbol_count) &&
+               _codes();
+    }
+
+    [[nodiscard]] bool _codes() noexcept {
+        for (;;) {
+            _reader.refill();
+            auto symbol = _litlen.decode(_reader);
+            if (symbol < 0) { return false; }
+            if (symbol < 256) {
+                if (_offset == _size) { return false; }
+                _out[_offset++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+            if (symbol == deflate_end_of_block) { return !_reader.overrun(); }
+            auto lc = static_cast<uint>(symbol - 257);
+            if (lc >= deflate_length_base.size()) { return false; }
+            auto length = deflate_length_base[lc] + _reader.bits(deflate_length_extra[lc]);
+            auto dc = _dist.decode(_reader);
+            if (dc < 0 || dc >= static_cast<int>(deflate_dist_base.size())) { return false; }
+            auto dist = deflate_dist_base[dc] + _reader.bits(deflate_dist_extra[dc]);
+            if (dist > _offset || length > _size - _offset) { return false; }
+            auto dst = _out + _offset;
+            auto src = dst - dist;
+            if (dist >= length) {
+                std::memcpy(dst, src, length);
+            } else {
+                for (auto i = 0u; i < length; i++) { dst[i] = src[i]; }
+            }
+            _offset += length;
+        }
+    }
+
+public:
+    DeflateDecoder(luisa::span<const std::byte> input, luisa::span<std::byte> output) noexcept
+        : _reader{reinterpret_cast<const uint8_t *>(input.data()), input.size()},
+          _out{reinterpret_cast<uint8_t *>(output.data())},
+          _size{output.size()} {}
+
+    [[nodiscard]] bool decode() noexcept {
+        for (auto final = false; !final;) {
+            _reader.refill();
+            final = _reader.bits(1u) != 0u;
+            auto ok = false;
+            switch (_reader.bits(2u)) {
+                case 0u: ok = _stored(); break;
+                case 1u: ok = _fixed(); break;
+                case 2u: ok = _dynamic(); break;
+                default: break;
+            }
+            if (!ok) { return false; }
+        }
+        return _offset == _size;
+    }
+};
+
+}// namespace detail
+
+void deflate_compress(luisa::span<const std::byte> input, uint level,
+                      luisa::vector<std::byte> &output) noexcept {
+    detail::DeflateEncoder encoder{input, level, output};
+    encoder.encode();
+}
+
+bool deflate_decompress(luisa::span<const std::byte> input,
+                        luisa::span<std::byte> output) noexcept {
+    detail::DeflateDecoder decoder{input, output};
+    return decoder.decode();
+}
+
+}// namespace luisa::compute::cpu
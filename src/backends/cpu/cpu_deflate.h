@@ -0,0 +1,18 @@
+#pragma once
+
+#include <luisa/core/stl/vector.h>
+#include <luisa/core/basic_types.h>
+
+namespace luisa::compute::cpu {
+
+/// Compresses the input as a raw DEFLATE (RFC 1951) stream and appends it to the output.
+/// Higher levels search longer match chains; 0 is the fastest.
+void deflate_compress(luisa::span<const std::byte> input, uint level,
+                      luisa::vector<std::byte> &output) noexcept;
+
+/// Decompresses a raw DEFLATE stream. Returns false if the stream is malformed
+/// or does not decompress to exactly the size of the output.
+[[nodiscard]] bool deflate_decompress(luisa::span<const std::byte> input,
+                                      luisa::span<std::byte> output) noexcept;
+
+}// namespace luisa::compute::cpu
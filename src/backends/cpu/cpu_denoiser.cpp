@@ -0,0 +1,444 @@
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include <luisa/core/logging.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/backends/ext/cpu/cpu_host_callback_command.h>
+
+#include "cpu_denoiser.h"
+
+namespace luisa::compute::cpu {
+
+namespace {
+
+constexpr auto atrous_iterations = 5u;
+constexpr auto sigma_luminance = 4.f;
+constexpr auto normal_power_log2 = 7u;// i.e., the weight is dot(n_p, n_q)^128
+constexpr auto min_normal_similarity = .9f;
+constexpr auto min_temporal_alpha = .2f;
+// below this history length, the variance is estimated spatially
+constexpr auto min_temporal_variance_frames = 4.f;
+constexpr auto min_albedo = 1e-3f;
+// the B3 spline of the a-trous filter
+constexpr std::array<float, 5u> atrous_kernel{1.f / 16.f, 1.f / 4.f, 3.f / 8.f, 1.f / 4.f, 1.f / 16.f};
+// per-pixel row scratch of the a-trous filter: luminance, 1 / sigma, and the sums of rgb, variance and weight
+constexpr auto atrous_row_scratch = 7u;
+
+[[nodiscard]] inline float luminance(float r, float g, float b) noexcept {
+    return .2126f * r + .7152f * g + .0722f * b;
+}
+
+// exp(x) for x <= 0 as 2^i * 2^f with a cubic for the fraction, which unlike std::exp is vectorized
+[[nodiscard]] inline float fast_exp(float x) noexcept {
+    auto t = std::max(x * 1.442695041f, -126.f);
+    auto i = std::floor(t);
+    auto f = t - i;
+    auto p = 1.f + f * (.695556856f + f * (.226173572f + f * .0781455737f));
+    return p * luisa::bit_cast<float>(static_cast<uint>(static_cast<int>(i) + 127) << 23u);
+}
+
+// splits the rows into a few blocks per worker, so that each block can reuse its scratch
+template<typename F>
+void parallel_rows(ThreadPool &pool, uint height, F &&f) noexcept {
+    auto block_count = std::min(height, std::max(pool.size(), 1u) * 4u);
+    auto rows_per_block = (height + block_count - 1u) / block_count;
+    pool.parallel(block_count, [&](uint block) noexcept {
+        auto begin = block * rows_per_block;
+        auto end = std::min(begin + rows_per_block, height);
+        if (begin < end) { f(begin, end); }
+    });
+    pool.synchronize();
+}
+
+// One row of an a-trous iteration over the planes of rgb and variance. The taps are
+// accumulated one at a time over the row, so the inner loops are contiguous and branch-free.
+template<bool guided>
+void atrous_row(const float *src, float *dst, const float *normal,
+                uint width, uint height, uint y, int step, float *scratch) noexcept {
+    auto n = static_cast<size_t>(width) * height;
+    auto row = static_cast<size_t>(y) * width;
+    auto sr = src, sg = src + n, sb = src + 2u * n, sv = src + 3u * n;
+    auto nx = normal, ny = normal + n, nz = normal + 2u * n;
+    auto lum_p = scratch;
+    auto inv_sigma = scratch + width;
+    auto acc_r = scratch + 2u * width;
+    auto acc_g = scratch + 3u * width;
+    auto acc_b = scratch + 4u * width;
+    auto acc_v = scratch + 5u * width;
+    auto acc_w = scratch + 6u * width;
+    constexpr auto center = atrous_kernel[2] * atrous_kernel[2];
+    for (auto x = 0u; x < width; x++) {
+        auto p = row + x;
+        lum_p[x] = luminance(sr[p], sg[p], sb[p]);
+        inv_sigma[x] = 1.f / (sigma_luminance * std::sqrt(std::max(sv[p], 0.f)) + 1e-6f);
+        acc_r[x] = center * sr[p];
+        acc_g[x] = center * sg[p];
+        acc_b[x] = center * sb[p];
+        acc_v[x] = center * center * sv[p];
+        acc_w[x] = center;
+    }
+    for (auto dy = -2; dy <= 2; dy++) {
+        auto qy = static_cast<int>(y) + dy * step;
+        if (qy < 0 || qy >= static_cast<int>(height)) { continue; }
+        for (auto dx = -2; dx <= 2; dx++) {
+            if (dx == 0 && dy == 0) { continue; }
+            auto offset = dx * step;
+            auto x_begin = std::max(0, -offset);
+            auto x_end = std::min(static_cast<int>(width), static_cast<int>(width) - offset);
+            auto h = atrous_kernel[dy + 2] * atrous_kernel[dx + 2];
+            auto q_row = static_cast<ptrdiff_t>(qy) * width + offset;
+            for (auto x = x_begin; x < x_end; x++) {
+                auto p = row + x;
+                auto q = q_row + x;
+                auto r = sr[q], g = sg[q], b = sb[q];
+                auto w = h * fast_exp(-std::abs(luminance(r, g, b) - lum_p[x]) * inv_sigma[x]);
+                if constexpr (guided) {
+                    auto d = std::max(nx[p] * nx[q] + ny[p] * ny[q] + nz[p] * nz[q], 0.f);
+                    for (auto i = 0u; i < normal_power_log2; i++) { d *= d; }
+                    w *= d;
+                }
+                acc_r[x] += w * r;
+                acc_g[x] += w * g;
+                acc_b[x] += w * b;
+                acc_v[x] += w * w * sv[q];
+                acc_w[x] += w;
+            }
+        }
+    }
+    for (auto x = 0u; x < width; x++) {
+        auto p = row + x;
+        auto inv_w = 1.f / acc_w[x];
+        dst[p] = acc_r[x] * inv_w;
+        dst[n + p] = acc_g[x] * inv_w;
+        dst[2u * n + p] = acc_b[x] * inv_w;
+        dst[3u * n + p] = acc_v[x] * inv_w * inv_w;
+    }
+}
+
+}// namespace
+
+CPUDenoiserExt::View CPUDenoiserExt::_view(const Buffer<float> *buffer, uint2 resolution) noexcept {
+    if (buffer == nullptr || !*buffer) { return {}; }
+    auto pixel_count = static_cast<size_t>(resolution.x) * resolution.y;
+    auto channels = buffer->size() / pixel_count;
+    LUISA_ASSERT(channels != 0u && channels <= 4u && channels * pixel_count == buffer->size(),
+                 "Denoiser buffer of {} floats does not match resolution {}x{}.",
+                 buffer->size(), resolution.x, resolution.y);
+    return {static_cast<const float *>(buffer->native_handle()), static_cast<uint>(channels)};
+}
+
+CPUDenoiserExt::Frame CPUDenoiserExt::_frame(const DenoiserInput &input, uint2 resolution) noexcept {
+    LUISA_ASSERT(input.beauty != nullptr && *input.beauty, "input image(beauty) is invalid!");
+    Frame frame{.beauty = _view(input.beauty, resolution),
+                .normal = _view(input.normal, resolution),
+                .albedo = _view(input.albedo, resolution),
+                .flow = _view(input.flow, resolution),
+                .flow_trust = _view(input.flowtrust, resolution)};
+    frame.aovs.reserve(input.aov_size);
+    for (auto i = 0u; i < input.aov_size; i++) {
+        frame.aovs.emplace_back(_view(input.aovs[i], resolution));
+    }
+    return frame;
+}
+
+void CPUDenoiserExt::_init(const Frame &frame, DenoiserMode mode, uint2 resolution) noexcept {
+    if (mode.upscale) {
+        LUISA_WARNING_WITH_LOCATION("Upscaling is not supported by the CPU denoiser.");
+    }
+    // kernel prediction is a model of OptiX; the same filter is used for all the layers here
+    _mode = mode;
+    _mode.upscale = false;
+    _resolution = resolution;
+    if (_pool == nullptr) { _pool = luisa::make_unique<ThreadPool>(); }
+    auto n = static_cast<size_t>(resolution.x) * resolution.y;
+    auto check_guide = [](View view, uint channels, luisa::string_view name) noexcept {
+        LUISA_ASSERT(view.data == nullptr || view.channels >= channels,
+                     "Denoiser {} needs at least {} channels, got {}.",
+                     name, channels, view.channels);
+    };
+    check_guide(frame.normal, 3u, "normal");
+    check_guide(frame.albedo, 3u, "albedo");
+    check_guide(frame.flow, 2u, "flow");
+    _layers.clear();
+    _layers.reserve(frame.aovs.size() + 1u);
+    for (auto i = 0u; i <= frame.aovs.size(); i++) {
+        auto view = i == 0u ? frame.beauty : frame.aovs[i - 1u];
+        LUISA_ASSERT(view.data != nullptr && view.channels >= 3u,
+                     "Denoiser layer {} must be valid with at least 3 channels.", i);
+        // specular lobes are not proportional to the albedo
+        auto specular = static_cast<int>(i) == _mode.aov_specular_id ||
+                        static_cast<int>(i) == _mode.aov_reflection_id ||
+                        static_cast<int>(i) == _mode.aov_refract_id;
+        auto &layer = _layers.emplace_back(Layer{.channels = view.channels, .demodulate = !specular});
+        if (_mode.temporal) { layer.history.resize(5u * n); }
+    }
+    _guides.resize(6u * n);
+    _ping.resize(4u * n);
+    _pong.resize(4u * n);
+    if (_mode.temporal) {
+        _previous_normal.resize(3u * n);
+        _history_length.assign(n, 0.f);
+        _reprojection.resize(n);
+        _next_history.resize(5u * n);
+    }
+    _has_history = false;
+    _initialized = true;
+}
+
+void CPUDenoiserExt::_load_guides(const Frame &frame) noexcept {
+    auto width = _resolution.x;
+    auto n = static_cast<size_t>(width) * _resolution.y;
+    auto normal = _guides.data();
+    auto albedo = _guides.data() + 3u * n;
+    parallel_rows(*_pool, _resolution.y, [&](uint y_begin, uint y_end) noexcept {
+        for (auto p = static_cast<size_t>(y_begin) * width; p < static_cast<size_t>(y_end) * width; p++) {
+            if (auto v = frame.normal; v.data != nullptr) {
+                auto nx = v.data[p * v.channels + 0u];
+                auto ny = v.data[p * v.channels + 1u];
+                auto nz = v.data[p * v.channels + 2u];
+                auto length = std::sqrt(nx * nx + ny * ny + nz * nz);
+                auto inv_length = length > 0.f ? 1.f / length : 0.f;
+                normal[p] = nx * inv_length;
+                normal[n + p] = ny * inv_length;
+                normal[2u * n + p] = nz * inv_length;
+            }
+            for (auto c = 0u; c < 3u; c++) {
+                albedo[c * n + p] = frame.albedo.data == nullptr ?
+                                        1.f :
+                                        std::max(frame.albedo.data[p * frame.albedo.channels + c], min_albedo);
+            }
+        }
+    });
+}
+
+void CPUDenoiserExt::_reproject(const Frame &frame) noexcept {
+    auto width = _resolution.x;
+    auto height = _resolution.y;
+    auto n = static_cast<size_t>(width) * height;
+    auto normal = _guides.data();
+    auto previous = _previous_normal.data();
+    // the first plane of _ping is free until the layers are filtered
+    auto length = _ping.data();
+    parallel_rows(*_pool, height, [&](uint y_begin, uint y_end) noexcept {
+        for (auto y = y_begin; y < y_end; y++) {
+            for (auto x = 0u; x < width; x++) {
+                auto p = static_cast<size_t>(y) * width + x;
+                auto source = -1;
+                if (_has_history) {
+                    auto fx = 0.f, fy = 0.f;
+                    if (auto v = frame.flow; v.data != nullptr) {
+                        fx = v.data[p * v.channels + 0u];
+                        fy = v.data[p * v.channels + 1u];
+                    }
+                    auto sx = std::floor(static_cast<float>(x) + .5f - fx);
+                    auto sy = std::floor(static_cast<float>(y) + .5f - fy);
+                    if (sx >= 0.f && sy >= 0.f && sx < static_cast<float>(width) && sy < static_cast<float>(height)) {
+                        auto q = static_cast<size_t>(sy) * width + static_cast<size_t>(sx);
+                        auto similar = frame.normal.data == nullptr ||
+                                       normal[p] * previous[q] +
+                                               normal[n + p] * previous[n + q] +
+                                               normal[2u * n + p] * previous[2u * n + q] >=
+                                           min_normal_similarity;
+                        if (similar) { source = static_cast<int>(q); }
+                    }
+                }
+                _reprojection[p] = source;
+                length[p] = source < 0 ? 1.f : _history_length[source] + 1.f;
+            }
+        }
+    });
+    std::copy_n(length, n, _history_length.data());
+}
+
+void CPUDenoiserExt::_filter(const Frame &frame, uint index, float *output) noexcept {
+    auto &layer = _layers[index];
+    auto input = index == 0u ? frame.beauty : frame.aovs[index - 1u];
+    LUISA_ASSERT(input.data != nullptr && input.channels == layer.channels,
+                 "Denoiser layer {} does not match the initialization.", index);
+    auto width = _resolution.x;
+    auto height = _resolution.y;
+    auto n = static_cast<size_t>(width) * height;
+    if (output == nullptr) {
+        layer.output.resize(n * layer.channels);
+        output = layer.output.data();
+    }
+    auto demodulate = layer.demodulate && frame.albedo.data != nullptr;
+    auto temporal = _mode.temporal;
+    auto albedo = _guides.data() + 3u * n;
+    auto history = layer.history.data();
+    auto next = _next_history.data();
+    auto src = _ping.data();
+    auto dst = _pong.data();
+
+    // demodulate, and accumulate the color and the luminance moments along the flow
+    parallel_rows(*_pool, height, [&](uint y_begin, uint y_end) noexcept {
+        for (auto p = static_cast<size_t>(y_begin) * width; p < static_cast<size_t>(y_end) * width; p++) {
+            std::array<float, 3u> rgb{};
+            for (auto c = 0u; c < 3u; c++) {
+                rgb[c] = input.data[p * input.channels + c];
+                if (demodulate) { rgb[c] /= albedo[c * n + p]; }
+            }
+            auto l = luminance(rgb[0], rgb[1], rgb[2]);
+            auto m1 = l;
+            auto m2 = l * l;
+            if (temporal) {
+                if (auto q = _reprojection[p]; q >= 0) {
+                    auto alpha = std::max(1.f / _history_length[p], min_temporal_alpha);
+                    if (auto v = frame.flow_trust; v.data != nullptr) {
+                        auto trust = std::clamp(v.data[p * v.channels], 0.f, 1.f);
+                        alpha = 1.f - trust * (1.f - alpha);
+                    }
+                    for (auto c = 0u; c < 3u; c++) {
+                        rgb[c] = history[c * n + q] + alpha * (rgb[c] - history[c * n + q]);
+                    }
+                    m1 = history[3u * n + q] + alpha * (m1 - history[3u * n + q]);
+                    m2 = history[4u * n + q] + alpha * (m2 - history[4u * n + q]);
+                }
+                next[3u * n + p] = m1;
+                next[4u * n + p] = m2;
+            }
+            for (auto c = 0u; c < 3u; c++) { src[c * n + p] = rgb[c]; }
+            src[3u * n + p] = std::max(m2 - m1 * m1, 0.f);
+        }
+    });
+
+    // short histories do not have enough samples for the moments, so estimate them over 3x3 pixels
+    parallel_rows(*_pool, height, [&](uint y_begin, uint y_end) noexcept {
+        for (auto y = y_begin; y < y_end; y++) {
+            for (auto x = 0u; x < width; x++) {
+                auto p = static_cast<size_t>(y) * width + x;
+                if (temporal && _history_length[p] >= min_temporal_variance_frames) { continue; }
+                auto sum = 0.f, sum_sqr = 0.f, count = 0.f;
+                for (auto qy = std::max(y, 1u) - 1u; qy <= std::min(y + 1u, height - 1u); qy++) {
+                    for (auto qx = std::max(x, 1u) - 1u; qx <= std::min(x + 1u, width - 1u); qx++) {
+                        auto q = static_cast<size_t>(qy) * width + qx;
+                        auto l = luminance(src[q], src[n + q], src[2u * n + q]);
+                        sum += l;
+                        sum_sqr += l * l;
+                        count += 1.f;
+                    }
+                }
+                auto mean = sum / count;
+                src[3u * n + p] = std::max(sum_sqr / count - mean * mean, 0.f);
+            }
+        }
+    });
+
+    auto guided = frame.normal.data != nullptr;
+    for (auto i = 0u; i < atrous_iterations; i++) {
+        auto step = 1 << i;
+        parallel_rows(*_pool, height, [&](uint y_begin, uint y_end) noexcept {
+            luisa::vector<float> scratch(atrous_row_scratch * width);
+            for (auto y = y_begin; y < y_end; y++) {
+                if (guided) {
+                    atrous_row<true>(src, dst, _guides.data(), width, height, y, step, scratch.data());
+                } else {
+                    atrous_row<false>(src, dst, _guides.data(), width, height, y, step, scratch.data());
+                }
+            }
+        });
+        // like SVGF, the history keeps the color after the first iteration
+        if (temporal && i == 0u) { std::copy_n(dst, 3u * n, next); }
+        std::swap(src, dst);
+    }
+    if (temporal) { layer.history.swap(_next_history); }
+
+    // modulate, and copy the alpha channel if any
+    parallel_rows(*_pool, height, [&](uint y_begin, uint y_end) noexcept {
+        for (auto p = static_cast<size_t>(y_begin) * width; p < static_cast<size_t>(y_end) * width; p++) {
+            for (auto c = 0u; c < 3u; c++) {
+                auto value = src[c * n + p];
+                if (demodulate) { value *= albedo[c * n + p]; }
+                output[p * layer.channels + c] = value;
+            }
+            if (layer.channels == 4u) { output[p * 4u + 3u] = input.data[p * 4u + 3u]; }
+        }
+    });
+}
+
+void CPUDenoiserExt::_process(const Frame &frame, float *beauty_output) noexcept {
+    LUISA_ASSERT(_initialized, "The CPU denoiser is not initialized.");
+    LUISA_ASSERT(frame.aovs.size() + 1u == _layers.size(),
+                 "Expected {} AOV layer(s) as initialized, got {}.",
+                 _layers.size() - 1u, frame.aovs.size());
+    _load_guides(frame);
+    if (_mode.temporal) { _reproject(frame); }
+    for (auto i = 0u; i < _layers.size(); i++) {
+        _filter(frame, i, i == 0u ? beauty_output : nullptr);
+    }
+    if (_mode.temporal) {
+        std::copy_n(_guides.data(), _previous_normal.size(), _previous_normal.data());
+        _has_history = true;
+    }
+}
+
+void CPUDenoiserExt::_destroy() noexcept {
+    _layers = {};
+    _guides = {};
+    _previous_normal = {};
+    _history_length = {};
+    _reprojection = {};
+    _next_history = {};
+    _ping = {};
+    _pong = {};
+    _has_history = false;
+    _initialized = false;
+}
+
+void CPUDenoiserExt::init(Stream &stream, DenoiserMode mode, DenoiserInput data, uint2 resolution) noexcept {
+    _input_resolution = resolution;
+    stream << luisa::make_unique<CPUHostCallbackCommand>(
+        [this, frame = _frame(data, resolution), mode, resolution] {
+            _init(frame, mode, resolution);
+        });
+}
+
+void CPUDenoiserExt::process(Stream &stream, DenoiserInput input) noexcept {
+    stream << luisa::make_unique<CPUHostCallbackCommand>(
+        [this, frame = _frame(input, _input_resolution)] {
+            _process(frame, nullptr);
+        });
+}
+
+void CPUDenoiserExt::get_result(Stream &stream, Buffer<float> &output, int index) noexcept {
+    auto data = static_cast<float *>(output.native_handle());
+    auto size = output.size();
+    stream << luisa::make_unique<CPUHostCallbackCommand>([this, data, size, index] {
+        auto layer = static_cast<size_t>(index + 1);
+        LUISA_ASSERT(index >= -1 && layer < _layers.size(), "Invalid denoiser layer {}.", index);
+        auto &&result = _layers[layer].output;
+        LUISA_ASSERT(result.size() == size,
+                     "Denoiser output of {} floats does not match the result of {} floats.",
+                     size, result.size());
+        std::memcpy(data, result.data(), size * sizeof(float));
+    });
+}
+
+void CPUDenoiserExt::destroy(Stream &stream) noexcept {
+    stream << luisa::make_unique<CPUHostCallbackCommand>([this] { _destroy(); });
+}
+
+void CPUDenoiserExt::denoise(Stream &stream, uint2 resolution, Buffer<float> const &image, Buffer<float> &output,
+                             Buffer<float> const &normal, Buffer<float> const &albedo, Buffer<float> **aovs, uint aov_size) noexcept {
+    // only the beauty is returned, so the AOVs are not filtered
+    DenoiserInput data{};
+    data.beauty = &image;
+    data.normal = &normal;
+    data.albedo = &albedo;
+    LUISA_ASSERT(output.size() == image.size(),
+                 "Denoiser output of {} floats does not match the input of {} floats.",
+                 output.size(), image.size());
+    stream << luisa::make_unique<CPUHostCallbackCommand>(
+        [this, frame = _frame(data, resolution), resolution,
+         result = static_cast<float *>(output.native_handle())] {
+            _init(frame, DenoiserMode{}, resolution);
+            // filtered straight into the output
+            _process(frame, result);
+            _destroy();
+        });
+}
+
+}// namespace luisa::compute::cpu
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <luisa/core/thread_pool.h>
+#include <luisa/core/stl/memory.h>
+#include <luisa/core/stl/vector.h>
+#include <luisa/backends/ext/denoiser_ext.h>
+
+namespace luisa::compute::cpu {
+
+/**
+ * @brief DenoiserExt of the CPU backend
+ *
+ * A built-in spatiotemporal variance-guided filter (SVGF): the color is
+ * demodulated by the albedo, accumulated along the flow in the temporal mode,
+ * and smoothed by an edge-avoiding a-trous wavelet filter that is guided by the
+ * normal and the luminance variance, before it is modulated again.
+ *
+ * The input buffers are read in place, and the work is done by host commands on
+ * the stream passed in, so it is ordered with the other commands of the stream.
+ * Upscaling and kernel prediction are not supported, and alpha is copied.
+ */
+class CPUDenoiserExt final : public DenoiserExt {
+
+private:
+    // a Buffer<float> of interleaved pixels
+    struct View {
+        const float *data{nullptr};
+        uint channels{0u};
+    };
+
+    struct Frame {
+        View beauty;
+        View normal;
+        View albedo;
+        View flow;
+        View flow_trust;
+        luisa::vector<View> aovs;
+    };
+
+    struct Layer {
+        uint channels;
+        bool demodulate;
+        luisa::vector<float> output;
+        // planes of the accumulated demodulated color and luminance moments
+        luisa::vector<float> history;
+    };
+
+private:
+    luisa::unique_ptr<ThreadPool> _pool;
+    uint2 _resolution{};
+    // the resolution as of the last init(), for views made on the calling thread
+    uint2 _input_resolution{};
+    bool _initialized{false};
+    bool _has_history{false};
+    luisa::vector<Layer> _layers;
+    // planes of the normal and the albedo, and of the normal of the previous frame
+    luisa::vector<float> _guides;
+    luisa::vector<float> _previous_normal;
+    luisa::vector<float> _history_length;
+    // the pixel each pixel is reprojected from, or -1 if it is disoccluded
+    luisa::vector<int> _reprojection;
+    luisa::vector<float> _next_history;
+    // planes of the color and the variance, filtered back and forth
+    luisa::vector<float> _ping;
+    luisa::vector<float> _pong;
+
+private:
+    [[nodiscard]] static View _view(const Buffer<float> *buffer, uint2 resolution) noexcept;
+    [[nodiscard]] static Frame _frame(const DenoiserInput &input, uint2 resolution) noexcept;
+    void _init(const Frame &frame, DenoiserMode mode, uint2 resolution) noexcept;
+    void _load_guides(const Frame &frame) noexcept;
+    void _reproject(const Frame &frame) noexcept;
+    void _filter(const Frame &frame, uint index, float *output) noexcept;
+    void _process(const Frame &frame, float *beauty_output) noexcept;
+    void _destroy() noexcept;
+
+public:
+    CPUDenoiserExt() noexcept = default;
+    void init(Stream &stream, DenoiserMode mode, DenoiserInput data, uint2 resolution) noexcept override;
+    void process(Stream &stream, DenoiserInput input) noexcept override;
+    void get_result(Stream &stream, Buffer<float> &output, int index) noexcept override;
+    void destroy(Stream &stream) noexcept override;
+    void denoise(Stream &stream, uint2 resolution, Buffer<float> const &image, Buffer<float> &output,
+                 Buffer<float> const &normal, Buffer<float> const &albedo, Buffer<float> **aovs, uint aov_size) noexcept override;
+};
+
+}// namespace luisa::compute::cpu
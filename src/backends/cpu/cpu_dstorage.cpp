@@ -0,0 +1,558 @@
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <bit>
+#include <latch>
+#include <cstring>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include <luisa/core/stl/optional.h>
+#include <luisa/backends/ext/dstorage_cmd.h>
+
+#include "cpu_deflate.h"
+#include "cpu_dstorage.h"
+
+namespace luisa::compute::cpu {
+
+class CPUFileHandle {
+
+private:
+#ifdef _WIN32
+    HANDLE _handle{INVALID_HANDLE_VALUE};
+#else
+    int _fd{-1};
+#endif
+    size_t _size_bytes{0u};
+
+public:
+    explicit CPUFileHandle(luisa::string_view path) noexcept {
+        luisa::string p{path};
+#ifdef _WIN32
+        _handle = CreateFileA(p.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (LARGE_INTEGER size{}; _handle != INVALID_HANDLE_VALUE && GetFileSizeEx(_handle, &size)) {
+            _size_bytes = static_cast<size_t>(size.QuadPart);
+        }
+#else
+        _fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+        if (struct stat s {}; _fd >= 0 && ::fstat(_fd, &s) == 0) {
+            _size_bytes = static_cast<size_t>(s.st_size);
+#ifdef POSIX_FADV_SEQUENTIAL
+            static_cast<void>(::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL));
+#endif
+        }
+#endif
+    }
+    ~CPUFileHandle() noexcept {
+#ifdef _WIN32
+        if (_handle != INVALID_HANDLE_VALUE) { CloseHandle(_handle); }
+#else
+        if (_fd >= 0) { ::close(_fd); }
+#endif
+    }
+    CPUFileHandle(CPUFileHandle &&) noexcept = delete;
+    CPUFileHandle(const CPUFileHandle &) noexcept = delete;
+    CPUFileHandle &operator=(CPUFileHandle &&) noexcept = delete;
+    CPUFileHandle &operator=(const CPUFileHandle &) noexcept = delete;
+    [[nodiscard]] auto valid() const noexcept {
+#ifdef _WIN32
+        return _handle != INVALID_HANDLE_VALUE;
+#else
+        return _fd >= 0;
+#endif
+    }
+    [[nodiscard]] auto size() const noexcept { return _size_bytes; }
+    // positional, so that pieces of a file can be read concurrently
+    void read(void *data, size_t size_bytes, size_t offset) const noexcept {
+        auto p = static_cast<std::byte *>(data);
+        while (size_bytes != 0u) {
+#ifdef _WIN32
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32u);
+            DWORD n = 0u;
+            auto request = static_cast<DWORD>(std::min<size_t>(size_bytes, 1u << 30u));
+            if (!ReadFile(_handle, p, request, &n, &overlapped) || n == 0u) {
+                LUISA_ERROR_WITH_LOCATION("Failed to read {} bytes at offset {} from file (error = {}).",
+                                          size_bytes, offset, GetLastError());
+            }
+#else
+            auto n = ::pread(_fd, p, size_bytes, static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR) { continue; }
+            if (n <= 0) {
+                LUISA_ERROR_WITH_LOCATION("Failed to read {} bytes at offset {} from file: {}.",
+                                          size_bytes, offset, n == 0 ? "unexpected end of file" : std::strerror(errno));
+            }
+#endif
+            p += n;
+            offset += n;
+            size_bytes -= n;
+        }
+    }
+};
+
+struct CPUPinnedMemory {
+    const std::byte *data;
+    size_t size_bytes;
+};
+
+struct CPUCompressionChunkMetadata {
+    uint64_t is_compressed;
+    size_t file_offset;
+    size_t compressed_size;
+};
+
+// chunks are compressed independently so that they can be decoded in parallel
+struct CPUCompressionFileHeader {
+
+    static constexpr auto cpu_compression_magic = 0x4c434446u;
+    static constexpr auto default_chunk_size = static_cast<size_t>(64u * 1024u);
+
+    uint magic;
+    uint padding;
+    size_t chunk_size;
+    size_t chunk_count;
+    // followed by chunk_count metadata entries and then the chunks
+};
+
+static_assert(sizeof(CPUCompressionFileHeader) == 24u);
+
+namespace detail {
+
+static constexpr auto dstorage_read_piece_size = static_cast<size_t>(1024u * 1024u);
+static constexpr auto dstorage_texture_block_size = 4u;
+
+[[nodiscard]] static auto dstorage_compression_level(DStorageCompressionQuality quality) noexcept {
+    switch (quality) {
+        case DStorageCompressionQuality::Fastest: return 0u;
+        case DStorageCompressionQuality::Default: return 1u;
+        case DStorageCompressionQuality::Best: return 2u;
+    }
+    return 1u;
+}
+
+// mirrors the block-linear layout of textures in the CPU backend (cpu/texture.rs),
+// an untiled level is a single tile covering the whole level
+class DStorageTextureLayout {
+
+private:
+    std::byte *_data;
+    uint3 _size;
+    uint3 _tile;
+    bool _is_3d;
+    size_t _pixel_size;
+
+private:
+    [[nodiscard]] static auto _tile_size(const CPUDStorageExt::TextureMemory &texture,
+                                         uint3 size, size_t pixel_size) noexcept {
+        auto b = dstorage_texture_block_size;
+        if (texture.tiled) {
+            auto s = static_cast<uint>(std::countr_zero(pixel_size));
+            return texture.dimension == 3u ?
+                       make_uint3(256u >> s, 16u, 16u) :
+                       make_uint3(1024u >> s, 64u, 1u);
+        }
+        auto tile = (size + b - 1u) / b * b;
+        if (texture.dimension != 3u) { tile.z = 1u; }
+        return tile;
+    }
+
+public:
+    DStorageTextureLayout(const CPUDStorageExt::TextureMemory &texture, uint level) noexcept
+        : _data{texture.data},
+          _size{luisa::max(texture.size >> level, 1u)},
+          _is_3d{texture.dimension == 3u},
+          _pixel_size{pixel_storage_size(texture.storage, make_uint3(1u))} {
+        for (auto l = 0u; l < level; l++) {
+            auto s = luisa::max(texture.size >> l, 1u);
+            auto tile = _tile_size(texture, s, _pixel_size);
+            auto tiles = (s + tile - 1u) / tile;
+            _data += static_cast<size_t>(tiles.x) * tiles.y * tiles.z *
+                     tile.x * tile.y * tile.z * _pixel_size;
+        }
+        _tile = _tile_size(texture, _size, _pixel_size);
+    }
+    [[nodiscard]] auto size() const noexcept { return _size; }
+    [[nodiscard]] auto pixel_size() const noexcept { return _pixel_size; }
+    [[nodiscard]] std::byte *texel(uint x, uint y, uint z) const noexcept {
+        auto b = dstorage_texture_block_size;
+        auto tiles = (_size + _tile - 1u) / _tile;
+        auto tile = static_cast<size_t>(x / _tile.x) +
+                    static_cast<size_t>(y / _tile.y) * tiles.x +
+                    static_cast<size_t>(z / _tile.z) * tiles.x * tiles.y;
+        auto grid = _tile / b;
+        auto block = (x % _tile.x / b) + (y % _tile.y / b) * grid.x + (z % _tile.z / b) * grid.x * grid.y;
+        auto block_pixels = _is_3d ? b * b * b : b * b;
+        auto index = tile * _tile.x * _tile.y * _tile.z +
+                     static_cast<size_t>(block) * block_pixels +
+                     (x % b) + (y % b) * b + (z % b) * b * b;
+        return _data + index * _pixel_size;
+    }
+};
+
+}// namespace detail
+
+CPUDStorageExt::CPUDStorageExt(DeviceInterface *device) noexcept
+    : _device{device} {}
+
+CPUDStorageExt::~CPUDStorageExt() noexcept = default;
+
+void CPUDStorageExt::register_buffer(uint64_t handle, BufferMemory memory) noexcept {
+    std::scoped_lock lock{_mutex};
+    _buffers.emplace(handle, memory);
+}
+
+void CPUDStorageExt::register_texture(uint64_t handle, TextureMemory memory) noexcept {
+    std::scoped_lock lock{_mutex};
+    _textures.emplace(handle, memory);
+}
+
+void CPUDStorageExt::unregister_buffer(uint64_t handle) noexcept {
+    std::scoped_lock lock{_mutex};
+    _buffers.erase(handle);
+}
+
+void CPUDStorageExt::unregister_texture(uint64_t handle) noexcept {
+    std::scoped_lock lock{_mutex};
+    _textures.erase(handle);
+}
+
+CPUDStorageExt::BufferMemory CPUDStorageExt::buffer_memory(uint64_t handle) noexcept {
+    std::scoped_lock lock{_mutex};
+    auto iter = _buffers.find(handle);
+    LUISA_ASSERT(iter != _buffers.end(), "Invalid buffer handle 0x{:016x}.", handle);
+    return iter->second;
+}
+
+CPUDStorageExt::TextureMemory CPUDStorageExt::texture_memory(uint64_t handle) noexcept {
+    std::scoped_lock lock{_mutex};
+    auto iter = _textures.find(handle);
+    LUISA_ASSERT(iter != _textures.end(), "Invalid texture handle 0x{:016x}.", handle);
+    return iter->second;
+}
+
+void CPUDStorageExt::_run(luisa::vector<luisa::move_only_function<void()>> &tasks) noexcept {
+    if (tasks.empty()) { return; }
+    // the pool is shared by all the DStorage streams, so only wait for our own tasks
+    std::latch latch{static_cast<std::ptrdiff_t>(tasks.size())};
+    _pool.parallel(static_cast<uint>(tasks.size()), [&tasks, &latch](uint i) noexcept {
+        tasks[i]();
+        latch.count_down();
+    });
+    latch.wait();
+    tasks.clear();
+}
+
+ResourceCreationInfo CPUDStorageExt::create_stream_handle(const DStorageStreamOption &option) noexcept {
+    // reads are executed by the thread of an ordinary stream
+    return _device->create_stream(StreamTag::COPY);
+}
+
+DStorageExt::FileCreationInfo CPUDStorageExt::open_file_handle(luisa::string_view path) noexcept {
+    auto file = luisa::new_with_allocator<CPUFileHandle>(path);
+    if (!file->valid()) {
+        LUISA_WARNING_WITH_LOCATION("Failed to open file '{}' for DStorage.", path);
+        luisa::delete_with_allocator(file);
+        return FileCreationInfo::make_invalid();
+    }
+    FileCreationInfo info{};
+    info.handle = reinterpret_cast<uint64_t>(file);
+    info.native_handle = file;
+    info.size_bytes = file->size();
+    return info;
+}
+
+void CPUDStorageExt::close_file_handle(uint64_t handle) noexcept {
+    luisa::delete_with_allocator(reinterpret_cast<CPUFileHandle *>(handle));
+}
+
+DStorageExt::PinnedMemoryInfo CPUDStorageExt::pin_host_memory(void *ptr, size_t size_bytes) noexcept {
+    // host memory is directly accessible, so pinning only records the range
+    auto memory = luisa::new_with_allocator<CPUPinnedMemory>(
+        CPUPinnedMemory{static_cast<const std::byte *>(ptr), size_bytes});
+    PinnedMemoryInfo info{};
+    info.handle = reinterpret_cast<uint64_t>(memory);
+    info.native_handle = ptr;
+    info.size_bytes = size_bytes;
+    return info;
+}
+
+void CPUDStorageExt::unpin_host_memory(uint64_t handle) noexcept {
+    luisa::delete_with_allocator(reinterpret_cast<CPUPinnedMemory *>(handle));
+}
+
+void CPUDStorageExt::execute(luisa::span<const DStorageReadCommand *const> commands) noexcept {
+
+    struct Read {
+        // source, either pinned memory or a file
+        const std::byte *source_data{nullptr};
+        const CPUFileHandle *source_file{nullptr};
+        size_t source_offset{0u};
+        size_t source_size{0u};
+        DStorageCompression compression{DStorageCompression::None};
+        // contiguous destination, the staged pixels for textures
+        std::byte *destination{nullptr};
+        size_t size_bytes{0u};
+        luisa::vector<std::byte> fetched;
+        luisa::vector<std::byte> pixels;
+        // texture destination
+        luisa::optional<detail::DStorageTextureLayout> texture;
+        uint3 texture_offset;
+        uint3 texture_size;
+    };
+
+    luisa::vector<Read> reads(commands.size());
+    for (auto i = 0u; i < commands.size(); i++) {
+        auto command = commands[i];
+        auto &&read = reads[i];
+        read.compression = command->compression();
+        luisa::visit(
+            [&read]<typename S>(const S &s) noexcept {
+                if constexpr (std::is_same_v<S, DStorageReadCommand::FileSource>) {
+                    read.source_file = reinterpret_cast<const CPUFileHandle *>(s.handle);
+                    LUISA_ASSERT(s.offset_bytes + s.size_bytes <= read.source_file->size(),
+                                 "DStorage read out of file range.");
+                    read.source_offset = s.offset_bytes;
+                } else {
+                    auto memory = reinterpret_cast<const CPUPinnedMemory *>(s.handle);
+                    LUISA_ASSERT(s.offset_bytes + s.size_bytes <= memory->size_bytes,
+                                 "DStorage read out of pinned memory range.");
+                    read.source_data = memory->data + s.offset_bytes;
+                }
+                read.source_size = s.size_bytes;
+            },
+            command->source());
+        luisa::visit(
+            [&read, this]<typename R>(const R &r) noexcept {
+                if constexpr (std::is_same_v<R, DStorageReadCommand::BufferRequest>) {
+                    auto buffer = buffer_memory(r.handle);
+                    LUISA_ASSERT(r.offset_bytes + r.size_bytes <= buffer.size_bytes,
+                                 "DStorage read out of buffer range.");
+                    read.destination = buffer.data + r.offset_bytes;
+                    read.size_bytes = r.size_bytes;
+                } else if constexpr (std::is_same_v<R, DStorageReadCommand::MemoryRequest>) {
+                    read.destination = static_cast<std::byte *>(r.data);
+                    read.size_bytes = r.size_bytes;
+                } else {
+                    auto texture = texture_memory(r.handle);
+                    LUISA_ASSERT(r.level < texture.mipmap_levels, "Invalid mipmap level {} for DStorage read.", r.level);
+                    read.texture.emplace(texture, r.level);
+                    read.texture_offset = make_uint3(r.offset[0], r.offset[1], r.offset[2]);
+                    read.texture_size = make_uint3(r.size[0], r.size[1], r.size[2]);
+                    LUISA_ASSERT(all(read.texture_offset + read.texture_size <= read.texture->size()),
+                                 "DStorage read out of texture range.");
+                    read.size_bytes = pixel_storage_size(texture.storage, read.texture_size);
+                }
+            },
+            command->request());
+        if (read.compression == DStorageCompression::None) {
+            LUISA_ASSERT(read.source_size >= read.size_bytes,
+                         "DStorage source ({} bytes) is smaller than the destination ({} bytes).",
+                         read.source_size, read.size_bytes);
+            read.source_size = read.size_bytes;
+        } else {
+            LUISA_ASSERT(read.compression == DStorageCompression::GDeflate,
+                         "Unsupported DStorage compression: {}.",
+                         luisa::to_string(read.compression));
+        }
+    }
+
+    luisa::vector<luisa::move_only_function<void()>> tasks;
+
+    // fetch: uncompressed files go straight to their destination unless it is a texture
+    for (auto &&read : reads) {
+        if (read.source_file == nullptr) {
+            if (read.compression == DStorageCompression::None && !read.texture) {
+                for (size_t offset = 0u; offset < read.size_bytes; offset += detail::dstorage_read_piece_size) {
+                    auto n = std::min(detail::dstorage_read_piece_size, read.size_bytes - offset);
+                    tasks.emplace_back([&read, offset, n] {
+                        std::memcpy(read.destination + offset, read.source_data + offset, n);
+                    });
+                }
+            }
+            continue;
+        }
+        auto direct = read.compression == DStorageCompression::None && !read.texture;
+        auto dst = read.destination;
+        if (!direct) {
+            read.fetched.resize(read.source_size);
+            read.source_data = read.fetched.data();
+            dst = read.fetched.data();
+        }
+        for (size_t offset = 0u; offset < read.source_size; offset += detail::dstorage_read_piece_size) {
+            auto n = std::min(detail::dstorage_read_piece_size, read.source_size - offset);
+            tasks.emplace_back([&read, dst, offset, n] {
+                read.source_file->read(dst + offset, n, read.source_offset + offset);
+            });
+        }
+    }
+    _run(tasks);
+
+    // decode: chunks decompress in parallel into the destination or the staged pixels
+    for (auto &&read : reads) {
+        if (read.texture) {
+            if (read.compression == DStorageCompression::None) { continue; }
+            read.pixels.resize(read.size_bytes);
+            read.destination = read.pixels.data();
+        }
+        if (read.compression == DStorageCompression::None) { continue; }
+        LUISA_ASSERT(read.source_size >= sizeof(CPUCompressionFileHeader),
+                     "Invalid compressed DStorage source.");
+        // the source may be unaligned user memory, so the header is copied out
+        CPUCompressionFileHeader header{};
+        std::memcpy(&header, read.source_data, sizeof(header));
+        LUISA_ASSERT(header.magic == CPUCompressionFileHeader::cpu_compression_magic &&
+                         header.chunk_size != 0u &&
+                         header.chunk_count == (read.size_bytes + header.chunk_size - 1u) / header.chunk_size &&
+                         sizeof(CPUCompressionFileHeader) +
+                                 header.chunk_count * sizeof(CPUCompressionChunkMetadata) <=
+                             read.source_size,
+                     "Invalid compressed DStorage source.");
+        for (size_t chunk = 0u; chunk < header.chunk_count; chunk++) {
+            tasks.emplace_back([&read, header, chunk] {
+                CPUCompressionChunkMetadata metadata{};
+                std::memcpy(&metadata,
+                            read.source_data + sizeof(CPUCompressionFileHeader) +
+                                chunk * sizeof(CPUCompressionChunkMetadata),
+                            sizeof(metadata));
+                auto offset = chunk * header.chunk_size;
+                auto size = std::min(header.chunk_size, read.size_bytes - offset);
+                LUISA_ASSERT(metadata.file_offset <= read.source_size &&
+                                 metadata.compressed_size <= read.source_size - metadata.file_offset,
+                             "Invalid compressed DStorage chunk.");
+                auto src = read.source_data + metadata.file_offset;
+                auto dst = read.destination + offset;
+                if (metadata.is_compressed) {
+                    auto ok = deflate_decompress(luisa::span<const std::byte>{src, metadata.compressed_size},
+                                                 luisa::span<std::byte>{dst, size});
+                    LUISA_ASSERT(ok, "Failed to decompress DStorage chunk {}.", chunk);
+                } else {
+                    LUISA_ASSERT(metadata.compressed_size == size, "Invalid compressed DStorage chunk.");
+                    std::memcpy(dst, src, size);
+                }
+            });
+        }
+    }
+    _run(tasks);
+
+    // swizzle the staged pixels into textures, a few rows per task
+    for (auto &&read : reads) {
+        if (!read.texture) { continue; }
+        auto pixels = read.compression == DStorageCompression::None ?
+                          read.source_data :
+                          read.destination;
+        auto size = read.texture_size;
+        auto row_count = size.y * size.z;
+        constexpr auto rows_per_task = 16u;
+        for (auto first = 0u; first < row_count; first += rows_per_task) {
+            tasks.emplace_back([&read, pixels, size, first, last = std::min(first + rows_per_task, row_count)] {
+                auto &&layout = *read.texture;
+                auto pixel_size = layout.pixel_size();
+                auto b = detail::dstorage_texture_block_size;
+                for (auto row = first; row < last; row++) {
+                    auto y = read.texture_offset.y + row % size.y;
+                    auto z = read.texture_offset.z + row / size.y;
+                    auto src = pixels + static_cast<size_t>(row) * size.x * pixel_size;
+                    // pixels within a block row are contiguous
+                    for (auto x = 0u; x < size.x;) {
+                        auto tx = read.texture_offset.x + x;
+                        auto n = std::min(b - tx % b, size.x - x);
+                        std::memcpy(layout.texel(tx, y, z), src + x * pixel_size, n * pixel_size);
+                        x += n;
+                    }
+                }
+            });
+        }
+    }
+    _run(tasks);
+}
+
+void CPUDStorageExt::compress(const void *data, size_t size_bytes,
+                              Compression algorithm, CompressionQuality quality,
+                              luisa::vector<std::byte> &result) noexcept {
+
+    Clock clk;
+
+    if (size_bytes == 0u) {
+        LUISA_WARNING_WITH_LOCATION("Empty data to compress.");
+        return;
+    }
+
+    if (algorithm == DStorageCompression::None) {
+        LUISA_WARNING_WITH_LOCATION("No compression algorithm specified. "
+                                    "The data will be copied as-is.");
+        result.resize(size_bytes);
+        std::memcpy(result.data(), data, size_bytes);
+        return;
+    }
+
+    LUISA_ASSERT(algorithm == DStorageCompression::GDeflate,
+                 "Unsupported compression algorithm: {}.",
+                 to_string(algorithm));
+
+    auto chunk_size = CPUCompressionFileHeader::default_chunk_size;
+    auto chunk_count = (size_bytes + chunk_size - 1u) / chunk_size;
+    auto level = detail::dstorage_compression_level(quality);
+
+    luisa::vector<luisa::vector<std::byte>> chunks(chunk_count);
+    luisa::vector<luisa::move_only_function<void()>> tasks;
+    tasks.reserve(chunk_count);
+    for (size_t chunk = 0u; chunk < chunk_count; chunk++) {
+        tasks.emplace_back([&, chunk] {
+            auto offset = chunk * chunk_size;
+            auto size = std::min(chunk_size, size_bytes - offset);
+            deflate_compress(luisa::span<const std::byte>{static_cast<const std::byte *>(data) + offset, size},
+                             level, chunks[chunk]);
+        });
+    }
+    _run(tasks);
+
+    result.resize(sizeof(CPUCompressionFileHeader) +
+                  sizeof(CPUCompressionChunkMetadata) * chunk_count);
+    CPUCompressionFileHeader header{
+        .magic = CPUCompressionFileHeader::cpu_compression_magic,
+        .padding = 0u,
+        .chunk_size = chunk_size,
+        .chunk_count = chunk_count};
+    std::memcpy(result.data(), &header, sizeof(header));
+    for (size_t chunk = 0u; chunk < chunk_count; chunk++) {
+        auto offset = chunk * chunk_size;
+        auto size = std::min(chunk_size, size_bytes - offset);
+        auto file_offset = result.size();
+        // incompressible chunks are stored as-is
+        auto is_compressed = chunks[chunk].size() < size;
+        if (is_compressed) {
+            result.insert(result.end(), chunks[chunk].cbegin(), chunks[chunk].cend());
+        } else {
+            auto p = static_cast<const std::byte *>(data) + offset;
+            result.insert(result.end(), p, p + size);
+        }
+        CPUCompressionChunkMetadata metadata{
+            .is_compressed = is_compressed ? 1u : 0u,
+            .file_offset = file_offset,
+            .compressed_size = result.size() - file_offset};
+        std::memcpy(result.data() + sizeof(CPUCompressionFileHeader) +
+                        chunk * sizeof(CPUCompressionChunkMetadata),
+                    &metadata, sizeof(metadata));
+    }
+
+    auto ratio = static_cast<double>(result.size_bytes()) / static_cast<double>(size_bytes);
+    LUISA_VERBOSE("Compressed {} bytes to {} bytes (ratio = {}) with {} in {} ms.",
+                  size_bytes, result.size_bytes(), ratio, to_string(algorithm), clk.toc());
+}
+
+}// namespace luisa::compute::cpu
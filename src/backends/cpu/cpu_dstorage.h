@@ -0,0 +1,80 @@
+#pragma once
+
+#include <mutex>
+
+#include <luisa/core/thread_pool.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/runtime/rhi/pixel.h>
+#include <luisa/backends/ext/dstorage_ext_interface.h>
+
+namespace luisa::compute {
+class DStorageReadCommand;
+}// namespace luisa::compute
+
+namespace luisa::compute::cpu {
+
+/**
+ * @brief DStorageExt of the CPU backend
+ *
+ * Reads are split into pieces that a private worker pool issues as concurrent
+ * positional reads, straight into the host memory behind buffers. Textures are
+ * staged and then swizzled into the block layout of the CPU backend. GDeflate
+ * sources are chunked DEFLATE streams that are decoded in parallel.
+ *
+ * The device executes the reads of a command list on the thread of the
+ * stream they are dispatched to, so they complete in stream order.
+ */
+class CPUDStorageExt final : public DStorageExt {
+
+public:
+    struct BufferMemory {
+        std::byte *data;
+        size_t size_bytes;
+    };
+
+    struct TextureMemory {
+        std::byte *data;
+        PixelStorage storage;
+        uint dimension;
+        uint3 size;
+        uint mipmap_levels;
+        // sparse textures store their 64KB tiles one after another (see cpu_sparse.h)
+        bool tiled{false};
+    };
+
+private:
+    DeviceInterface *_device;
+    ThreadPool _pool;
+    std::mutex _mutex;
+    luisa::unordered_map<uint64_t, BufferMemory> _buffers;
+    luisa::unordered_map<uint64_t, TextureMemory> _textures;
+
+private:
+    void _run(luisa::vector<luisa::move_only_function<void()>> &tasks) noexcept;
+
+protected:
+    [[nodiscard]] DeviceInterface *device() const noexcept override { return _device; }
+    [[nodiscard]] ResourceCreationInfo create_stream_handle(const DStorageStreamOption &option) noexcept override;
+    [[nodiscard]] FileCreationInfo open_file_handle(luisa::string_view path) noexcept override;
+    void close_file_handle(uint64_t handle) noexcept override;
+    [[nodiscard]] PinnedMemoryInfo pin_host_memory(void *ptr, size_t size_bytes) noexcept override;
+    void unpin_host_memory(uint64_t handle) noexcept override;
+
+public:
+    explicit CPUDStorageExt(DeviceInterface *device) noexcept;
+    ~CPUDStorageExt() noexcept;
+    void register_buffer(uint64_t handle, BufferMemory memory) noexcept;
+    void register_texture(uint64_t handle, TextureMemory memory) noexcept;
+    void unregister_buffer(uint64_t handle) noexcept;
+    void unregister_texture(uint64_t handle) noexcept;
+    // the host memory behind the resources, also used by the other host-side extensions
+    [[nodiscard]] BufferMemory buffer_memory(uint64_t handle) noexcept;
+    [[nodiscard]] TextureMemory texture_memory(uint64_t handle) noexcept;
+    // blocks until all the reads are completed
+    void execute(luisa::span<const DStorageReadCommand *const> commands) noexcept;
+    void compress(const void *data, size_t size_bytes,
+                  Compression algorithm, CompressionQuality quality,
+                  luisa::vector<std::byte> &result) noexcept override;
+};
+
+}// namespace luisa::compute::cpu
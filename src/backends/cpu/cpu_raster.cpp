@@ -0,0 +1,580 @@
+#ifdef LUISA_ENABLE_DSL
+
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include <luisa/core/mathematics.h>
+#include <luisa/runtime/rhi/command_encoder.h>
+#include <luisa/backends/ext/raster_cmd.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/sugar.h>
+#include <luisa/dsl/raster/raster_kernel.h>
+
+#include "cpu_dstorage.h"
+#include "cpu_raster.h"
+
+namespace luisa::compute::cpu {
+
+struct CPURasterExt::Shader {
+    // keep the wrapper kernels alive as long as their shaders
+    luisa::shared_ptr<const detail::FunctionBuilder> vertex_kernel;
+    luisa::shared_ptr<const detail::FunctionBuilder> pixel_kernel;
+    ShaderCreationInfo vertex_shader;
+    ShaderCreationInfo pixel_shader;
+    size_t vertex_uniform_size;
+    size_t pixel_uniform_size;
+    size_t vertex_stream_count;
+    // the output of the vertex stage
+    const Type *vertex_type;
+    // whether each argument of the draw commands is bound to the stages, vertex stage first
+    luisa::vector<bool> bound_arguments;
+    size_t vertex_argument_count;
+};
+
+namespace {
+
+// the blend op passed to the pixel kernel for draws without blending
+constexpr auto blend_disabled = ~0u;
+
+// decodes a half stored in the lower 16 bits, by rescaling the exponent of its float bits
+[[nodiscard]] Float half_to_float(Expr<uint> h) noexcept {
+    auto magnitude = (h & 0x7fffu) << 13u;
+    auto f = as<float>(magnitude) * 0x1p112f;
+    f = ite((h & 0x7c00u) == 0x7c00u, as<float>(magnitude | 0x7f800000u), f);
+    return ite((h & 0x8000u) != 0u, -f, f);
+}
+
+// missing components are filled with (0, 0, 0, 1) like the vertex fetch of GPUs
+[[nodiscard]] Float4 decode_vertex_element(Expr<ByteBuffer> stream, Expr<uint> offset,
+                                           VertexElementFormat format) noexcept {
+    auto word = [&](uint i) noexcept { return stream.read<uint>(offset + i * 4u); };
+    auto component = [&](uint i) noexcept { return stream.read<float>(offset + i * 4u); };
+    switch (format) {
+        case VertexElementFormat::XYZW8UNorm: {
+            auto w = word(0u);
+            return make_float4(make_uint4(w & 0xffu, (w >> 8u) & 0xffu, (w >> 16u) & 0xffu, w >> 24u)) * (1.f / 255.f);
+        }
+        case VertexElementFormat::XY16UNorm: {
+            auto w = word(0u);
+            return make_float4(make_float2(make_uint2(w & 0xffffu, w >> 16u)) * (1.f / 65535.f), 0.f, 1.f);
+        }
+        case VertexElementFormat::XYZW16UNorm: {
+            auto w0 = word(0u);
+            auto w1 = word(1u);
+            return make_float4(make_uint4(w0 & 0xffffu, w0 >> 16u, w1 & 0xffffu, w1 >> 16u)) * (1.f / 65535.f);
+        }
+        case VertexElementFormat::XY16Float: {
+            auto w = word(0u);
+            return make_float4(half_to_float(w & 0xffffu), half_to_float(w >> 16u), 0.f, 1.f);
+        }
+        case VertexElementFormat::XYZW16Float: {
+            auto w0 = word(0u);
+            auto w1 = word(1u);
+            return make_float4(half_to_float(w0 & 0xffffu), half_to_float(w0 >> 16u),
+                               half_to_float(w1 & 0xffffu), half_to_float(w1 >> 16u));
+        }
+        case VertexElementFormat::X32Float: return make_float4(component(0u), 0.f, 0.f, 1.f);
+        case VertexElementFormat::XY32Float: return make_float4(component(0u), component(1u), 0.f, 1.f);
+        case VertexElementFormat::XYZ32Float: return make_float4(component(0u), component(1u), component(2u), 1.f);
+        case VertexElementFormat::XYZW32Float: return make_float4(component(0u), component(1u), component(2u), component(3u));
+        default: break;
+    }
+    LUISA_ERROR_WITH_LOCATION("Unsupported vertex element format {}.", luisa::to_string(format));
+}
+
+// declares kernel arguments for the unbound arguments of the stage except the first one
+[[nodiscard]] luisa::vector<const Expression *> mirror_stage_arguments(Function stage) noexcept {
+    auto fb = detail::FunctionBuilder::current();
+    luisa::vector<const Expression *> args;
+    auto arguments = stage.arguments();
+    auto bindings = stage.bound_arguments();
+    for (auto i = 1u; i < arguments.size(); i++) {
+        auto &&arg = arguments[i];
+        if (arg.is_builtin() || !luisa::holds_alternative<luisa::monostate>(bindings[i])) { continue; }
+        switch (arg.tag()) {
+            case Variable::Tag::BUFFER: args.emplace_back(fb->buffer(arg.type())); break;
+            case Variable::Tag::TEXTURE: args.emplace_back(fb->texture(arg.type())); break;
+            case Variable::Tag::BINDLESS_ARRAY: args.emplace_back(fb->bindless_array()); break;
+            case Variable::Tag::ACCEL: args.emplace_back(fb->accel()); break;
+            default: args.emplace_back(fb->argument(arg.type())); break;
+        }
+    }
+    return args;
+}
+
+void check_raster_stage(Function stage, luisa::string_view name) noexcept {
+    for (auto &&v : stage.builtin_variables()) {
+        if (v.tag() == Variable::Tag::OBJECT_ID) {
+            LUISA_ERROR_WITH_LOCATION("The {} stage uses object_id(), "
+                                      "which is not supported on the CPU backend.",
+                                      name);
+        }
+    }
+}
+
+// the texture element type written for an output of the pixel stage
+[[nodiscard]] const Type *render_target_type(const Type *output) noexcept {
+    auto elem = output->is_vector() ? output->element() : output;
+    switch (elem->tag()) {
+        case Type::Tag::FLOAT32: return Type::of<Image<float>>();
+        case Type::Tag::INT32: return Type::of<Image<int>>();
+        case Type::Tag::UINT32: return Type::of<Image<uint>>();
+        default: break;
+    }
+    LUISA_ERROR_WITH_LOCATION("Unsupported pixel stage output type {}.", output->description());
+}
+
+[[nodiscard]] luisa::shared_ptr<const detail::FunctionBuilder>
+make_vertex_kernel(const MeshFormat &mesh_format, Function vert) noexcept {
+    return detail::FunctionBuilder::define_kernel([&] {
+        auto fb = detail::FunctionBuilder::current();
+        fb->allow_raster_stage_calls();
+        luisa::vector<Var<ByteBuffer>> streams;
+        luisa::vector<Var<uint>> strides;
+        for (auto s = 0u; s < mesh_format.vertex_stream_count(); s++) { streams.emplace_back(detail::ArgumentCreation{}); }
+        for (auto s = 0u; s < mesh_format.vertex_stream_count(); s++) { strides.emplace_back(detail::ArgumentCreation{}); }
+        auto vertices = fb->buffer(Type::buffer(vert.return_type()));
+        Var<uint> vertex_count{detail::ArgumentCreation{}};
+        auto args = mirror_stage_arguments(vert);
+        auto vertex_id = dispatch_x();
+        auto instance_id = dispatch_y();
+        Var<AppData> app;
+        app.position = make_float3(0.f);
+        app.normal = make_float3(0.f);
+        app.tangent = make_float4(0.f);
+        app.color = make_float4(0.f);
+        for (auto i = 0u; i < 4u; i++) { app.uv[i] = make_float2(0.f); }
+        app.vertex_id = vertex_id;
+        app.instance_id = instance_id;
+        for (auto s = 0u; s < mesh_format.vertex_stream_count(); s++) {
+            auto offset = 0u;
+            for (auto attribute : mesh_format.attributes(s)) {
+                auto v = decode_vertex_element(streams[s], vertex_id * strides[s] + offset, attribute.format);
+                switch (attribute.type) {
+                    case VertexAttributeType::Position: app.position = v.xyz(); break;
+                    case VertexAttributeType::Normal: app.normal = v.xyz(); break;
+                    case VertexAttributeType::Tangent: app.tangent = v; break;
+                    case VertexAttributeType::Color: app.color = v; break;
+                    case VertexAttributeType::UV0: app.uv[0u] = v.xy(); break;
+                    case VertexAttributeType::UV1: app.uv[1u] = v.xy(); break;
+                    case VertexAttributeType::UV2: app.uv[2u] = v.xy(); break;
+                    case VertexAttributeType::UV3: app.uv[3u] = v.xy(); break;
+                }
+                offset += static_cast<uint>(VertexElementFormatStride(attribute.format));
+            }
+        }
+        args.insert(args.begin(), app.expression());
+        auto output = fb->call(vert.return_type(), vert, args);
+        auto index = instance_id * vertex_count + vertex_id;
+        fb->call(CallOp::BUFFER_WRITE, {vertices, index.expression(), output});
+    });
+}
+
+[[nodiscard]] luisa::shared_ptr<const detail::FunctionBuilder>
+make_pixel_kernel(Function vert, Function pixel) noexcept {
+    return detail::FunctionBuilder::define_kernel([&] {
+        auto fb = detail::FunctionBuilder::current();
+        fb->allow_raster_stage_calls();
+        auto vertex_type = vert.return_type();
+        auto pixel_type = pixel.return_type();
+        BufferVar<uint4> fragments{detail::ArgumentCreation{}};
+        BufferVar<uint4> triangles{detail::ArgumentCreation{}};
+        auto vertices = fb->buffer(Type::buffer(vertex_type));
+        Var<uint> fragment_offset{detail::ArgumentCreation{}};
+        // blending weights are c.x * prim + c.y * img + c.z * prim.a + c.w * img.a + bias
+        Var<uint> blend_op{detail::ArgumentCreation{}};
+        Var<float4> prim_weight{detail::ArgumentCreation{}};
+        Var<float4> img_weight{detail::ArgumentCreation{}};
+        Var<float2> weight_bias{detail::ArgumentCreation{}};
+        luisa::vector<const Type *> outputs;
+        if (pixel_type->is_structure()) {
+            outputs.assign(pixel_type->members().begin(), pixel_type->members().end());
+        } else {
+            outputs.emplace_back(pixel_type);
+        }
+        luisa::vector<const RefExpr *> images;
+        for (auto output : outputs) { images.emplace_back(fb->texture(render_target_type(output))); }
+        auto args = mirror_stage_arguments(pixel);
+
+        // interpolate the outputs of the vertex stage at the fragment
+        auto fragment = fragments.read(fragment_offset + dispatch_x());
+        auto p = make_uint2(fragment.x & 0xffffu, fragment.x >> 16u);
+        auto triangle = triangles.read(fragment.y);
+        auto b1 = as<float>(fragment.z);
+        auto b2 = as<float>(fragment.w);
+        auto b0 = 1.f - b1 - b2;
+        std::array<const Expression *, 3u> v{};
+        std::array<const Expression *, 3u> indices{triangle.x.expression(), triangle.y.expression(), triangle.z.expression()};
+        for (auto i = 0u; i < 3u; i++) {
+            auto local = fb->local(vertex_type);
+            fb->assign(local, fb->call(vertex_type, CallOp::BUFFER_READ, {vertices, indices[i]}));
+            v[i] = local;
+        }
+        auto interpolate = [&](const Type *t, const Expression *v0, const Expression *v1, const Expression *v2) noexcept {
+            auto elem = t->is_vector() ? t->element() : t;
+            if (elem->tag() != Type::Tag::FLOAT32) { return v0; }
+            auto sum = fb->binary(t, BinaryOp::ADD,
+                                  fb->binary(t, BinaryOp::MUL, v0, b0.expression()),
+                                  fb->binary(t, BinaryOp::MUL, v1, b1.expression()));
+            return static_cast<const Expression *>(
+                fb->binary(t, BinaryOp::ADD, sum, fb->binary(t, BinaryOp::MUL, v2, b2.expression())));
+        };
+        auto input = fb->local(vertex_type);
+        const Expression *position = input;
+        if (vertex_type->is_structure()) {
+            auto members = vertex_type->members();
+            for (auto i = 0u; i < members.size(); i++) {
+                auto m = members[i];
+                fb->assign(fb->member(m, input, i),
+                           interpolate(m, fb->member(m, v[0], i), fb->member(m, v[1], i), fb->member(m, v[2], i)));
+            }
+            position = fb->member(Type::of<float4>(), input, 0u);
+        } else {
+            fb->assign(input, interpolate(vertex_type, v[0], v[1], v[2]));
+        }
+        // the position holds the pixel center, the depth and the clip-space w
+        Expr<float4> clip{position};
+        Float4 frag_coord = make_float4(make_float2(p) + .5f, clip.z / clip.w, clip.w);
+        fb->assign(position, frag_coord.expression());
+
+        args.insert(args.begin(), input);
+        auto result = fb->local(pixel_type);
+        fb->assign(result, fb->call(pixel_type, pixel, args));
+        for (auto i = 0u; i < outputs.size(); i++) {
+            auto output = outputs[i];
+            auto value = pixel_type->is_structure() ?
+                             static_cast<const Expression *>(fb->member(output, result, i)) :
+                             static_cast<const Expression *>(result);
+            // pad the output to 4 components
+            auto elem = output->is_vector() ? output->element() : output;
+            auto dim = output->is_vector() ? output->dimension() : 1u;
+            auto is_float = elem->tag() == Type::Tag::FLOAT32;
+            std::array<const Expression *, 4u> c{};
+            for (auto k = 0u; k < 4u; k++) {
+                if (k < dim) {
+                    c[k] = output->is_vector() ? fb->swizzle(elem, value, 1u, k) : value;
+                } else if (is_float) {
+                    c[k] = fb->literal(elem, k == 3u ? 1.f : 0.f);
+                } else if (elem->tag() == Type::Tag::INT32) {
+                    c[k] = fb->literal(elem, 0);
+                } else {
+                    c[k] = fb->literal(elem, 0u);
+                }
+            }
+            auto vector_type = Type::vector(elem, 4u);
+            auto make_op = is_float ? CallOp::MAKE_FLOAT4 :
+                           elem->tag() == Type::Tag::INT32 ? CallOp::MAKE_INT4 :
+                                                             CallOp::MAKE_UINT4;
+            const Expression *color = fb->call(vector_type, make_op, {c[0], c[1], c[2], c[3]});
+            if (is_float) {
+                Float4 prim = def<float4>(color);
+                $if (blend_op != blend_disabled) {
+                    Float4 img = def<float4>(fb->call(Type::of<float4>(), CallOp::TEXTURE_READ, {images[i], p.expression()}));
+                    auto wp = prim_weight.x * prim + prim_weight.y * img + prim_weight.z * prim.w + prim_weight.w * img.w + weight_bias.x;
+                    auto wi = img_weight.x * prim + img_weight.y * img + img_weight.z * prim.w + img_weight.w * img.w + weight_bias.y;
+                    $switch (blend_op) {
+                        $case (static_cast<uint>(BlendOp::Add)) { prim = prim * wp + img * wi; };
+                        $case (static_cast<uint>(BlendOp::Subtract)) { prim = prim * wp - img * wi; };
+                        $case (static_cast<uint>(BlendOp::Min)) { prim = min(prim, img); };
+                        $default { prim = max(prim, img); };
+                    };
+                };
+                color = prim.expression();
+            }
+            fb->call(CallOp::TEXTURE_WRITE, {images[i], p.expression(), color});
+        }
+    });
+}
+
+// coefficients of the blending weight over (prim, img, prim.a, img.a) and its bias
+[[nodiscard]] std::pair<float4, float> blend_weight(BlendWeight w) noexcept {
+    switch (w) {
+        case BlendWeight::Zero: return {make_float4(0.f), 0.f};
+        case BlendWeight::One: return {make_float4(0.f), 1.f};
+        case BlendWeight::PrimColor: return {make_float4(1.f, 0.f, 0.f, 0.f), 0.f};
+        case BlendWeight::ImgColor: return {make_float4(0.f, 1.f, 0.f, 0.f), 0.f};
+        case BlendWeight::PrimAlpha: return {make_float4(0.f, 0.f, 1.f, 0.f), 0.f};
+        case BlendWeight::ImgAlpha: return {make_float4(0.f, 0.f, 0.f, 1.f), 0.f};
+        case BlendWeight::OneMinusPrimColor: return {make_float4(-1.f, 0.f, 0.f, 0.f), 1.f};
+        case BlendWeight::OneMinusImgColor: return {make_float4(0.f, -1.f, 0.f, 0.f), 1.f};
+        case BlendWeight::OneMinusPrimAlpha: return {make_float4(0.f, 0.f, -1.f, 0.f), 1.f};
+        case BlendWeight::OneMinusImgAlpha: return {make_float4(0.f, 0.f, 0.f, -1.f), 1.f};
+    }
+    LUISA_ERROR_WITH_LOCATION("Unsupported blend weight {}.", luisa::to_string(w));
+}
+
+[[nodiscard]] PixelFormat depth_texture_format(DepthFormat format) noexcept {
+    switch (format) {
+        case DepthFormat::D16: return PixelFormat::R16UNorm;
+        case DepthFormat::D24S8:
+        case DepthFormat::D32: return PixelFormat::R32F;
+        case DepthFormat::D32S8A24: return PixelFormat::RG32F;
+        default: break;
+    }
+    LUISA_ERROR_WITH_LOCATION("Unsupported depth format {}.", luisa::to_string(format));
+}
+
+}// namespace
+
+CPURasterExt::CPURasterExt(DeviceInterface *device, CPUDStorageExt *dstorage_ext) noexcept
+    : _device{device}, _dstorage_ext{dstorage_ext} {}
+
+CPURasterExt::~CPURasterExt() noexcept {
+    for (auto buffer : {_vertices, _triangles, _fragments}) {
+        if (buffer.valid()) { _device->destroy_buffer(buffer.handle); }
+    }
+    if (_stream != invalid_resource_handle) { _device->destroy_stream(_stream); }
+}
+
+std::byte *CPURasterExt::_reserve(BufferCreationInfo &buffer, size_t size_bytes) noexcept {
+    if (!buffer.valid() || buffer.total_size_bytes < size_bytes) {
+        auto capacity = std::max(size_bytes, buffer.valid() ? buffer.total_size_bytes * 2u : 0u);
+        if (buffer.valid()) { _device->destroy_buffer(buffer.handle); }
+        buffer = _device->create_buffer(Type::of<uint>(), std::max<size_t>((capacity + 3u) / 4u, 1024u));
+    }
+    return static_cast<std::byte *>(buffer.native_handle);
+}
+
+ResourceCreationInfo CPURasterExt::create_raster_shader(const MeshFormat &mesh_format,
+                                                        Function vert, Function pixel,
+                                                        const ShaderOption &option) noexcept {
+    check_raster_stage(vert, "vertex");
+    check_raster_stage(pixel, "pixel");
+    auto shader = luisa::new_with_allocator<Shader>();
+    shader->vertex_kernel = make_vertex_kernel(mesh_format, vert);
+    shader->pixel_kernel = make_pixel_kernel(vert, pixel);
+    // the wrappers are internal, so they are cached by their hashes rather than saved by name
+    auto wrapper_option = option;
+    wrapper_option.name.clear();
+    auto vertex_kernel = Function{shader->vertex_kernel.get()};
+    auto pixel_kernel = Function{shader->pixel_kernel.get()};
+    shader->vertex_shader = _device->create_shader(wrapper_option, vertex_kernel);
+    shader->pixel_shader = _device->create_shader(wrapper_option, pixel_kernel);
+    shader->vertex_uniform_size = ShaderDispatchCmdEncoder::compute_uniform_size(vertex_kernel.unbound_arguments());
+    shader->pixel_uniform_size = ShaderDispatchCmdEncoder::compute_uniform_size(pixel_kernel.unbound_arguments());
+    shader->vertex_stream_count = mesh_format.vertex_stream_count();
+    shader->vertex_type = vert.return_type();
+    for (auto stage : {vert, pixel}) {
+        for (auto &&binding : stage.bound_arguments().subspan(1u)) {
+            shader->bound_arguments.emplace_back(!luisa::holds_alternative<luisa::monostate>(binding));
+        }
+    }
+    shader->vertex_argument_count = vert.arguments().size() - 1u;
+    ResourceCreationInfo info{};
+    info.handle = reinterpret_cast<uint64_t>(shader);
+    info.native_handle = shader;
+    return info;
+}
+
+ResourceCreationInfo CPURasterExt::load_raster_shader(const MeshFormat &mesh_format,
+                                                      luisa::span<Type const *const> types,
+                                                      luisa::string_view ser_path) noexcept {
+    LUISA_WARNING_WITH_LOCATION("Loading raster shader '{}' is not supported on the CPU backend.", ser_path);
+    return ResourceCreationInfo::make_invalid();
+}
+
+void CPURasterExt::destroy_raster_shader(uint64_t handle) noexcept {
+    auto shader = reinterpret_cast<Shader *>(handle);
+    _device->destroy_shader(shader->vertex_shader.handle);
+    _device->destroy_shader(shader->pixel_shader.handle);
+    luisa::delete_with_allocator(shader);
+}
+
+ResourceCreationInfo CPURasterExt::create_depth_buffer(DepthFormat format, uint width, uint height) noexcept {
+    return _device->create_texture(depth_texture_format(format), 2u, width, height, 1u, 1u, false);
+}
+
+void CPURasterExt::destroy_depth_buffer(uint64_t handle) noexcept {
+    _device->destroy_texture(handle);
+}
+
+void CPURasterExt::clear_depth(const ClearDepthCommand *command) noexcept {
+    auto memory = _dstorage_ext->texture_memory(command->handle());
+    CPURasterizer::clear_depth(memory.data, memory.storage, make_uint2(memory.size.x, memory.size.y), command->value());
+}
+
+void CPURasterExt::draw(const DrawRasterSceneCommand *command) noexcept {
+
+    auto &&state = command->raster_state();
+    if (state.topology != TopologyType::Triangle) {
+        LUISA_WARNING_WITH_LOCATION("Only triangles can be rasterized on the CPU backend. The draw is ignored.");
+        return;
+    }
+    if (state.fill_mode == FillMode::WireFrame) {
+        static std::once_flag warned;
+        std::call_once(warned, [] {
+            LUISA_WARNING_WITH_LOCATION("Wireframes are not supported on the CPU backend "
+                                        "and are filled instead.");
+        });
+    }
+    if (state.stencil_state.enable_stencil) {
+        static std::once_flag warned;
+        std::call_once(warned, [] {
+            LUISA_WARNING_WITH_LOCATION("Stencil tests are not supported on the CPU backend "
+                                        "and are ignored.");
+        });
+    }
+
+    std::scoped_lock lock{_mutex};
+    if (_pool == nullptr) {
+        _pool = luisa::make_unique<ThreadPool>();
+        _rasterizer = luisa::make_unique<CPURasterizer>(*_pool);
+        _stream = _device->create_stream(StreamTag::COMPUTE).handle;
+    }
+    auto shader = reinterpret_cast<const Shader *>(command->handle());
+    auto arguments = command->arguments();
+    LUISA_ASSERT(arguments.size() == shader->bound_arguments.size(),
+                 "Raster shader expects {} arguments but {} are given.",
+                 shader->bound_arguments.size(), arguments.size());
+    auto encode_stage_arguments = [&](ComputeDispatchCmdEncoder &encoder, size_t begin, size_t end) noexcept {
+        for (auto i = begin; i < end; i++) {
+            if (shader->bound_arguments[i]) { continue; }
+            auto &&arg = arguments[i];
+            switch (arg.tag) {
+                case Argument::Tag::BUFFER: encoder.encode_buffer(arg.buffer.handle, arg.buffer.offset, arg.buffer.size); break;
+                case Argument::Tag::TEXTURE: encoder.encode_texture(arg.texture.handle, arg.texture.level); break;
+                case Argument::Tag::UNIFORM: {
+                    auto data = command->uniform(arg.uniform);
+                    encoder.encode_uniform(data.data(), data.size());
+                    break;
+                }
+                case Argument::Tag::BINDLESS_ARRAY: encoder.encode_bindless_array(arg.bindless_array.handle); break;
+                case Argument::Tag::ACCEL: encoder.encode_accel(arg.accel.handle); break;
+            }
+        }
+    };
+
+    // the render area is the intersection of the render targets
+    CPURasterizer::Target target{};
+    auto rtvs = command->rtv_texs();
+    auto size = make_uint2(std::numeric_limits<uint>::max());
+    for (auto &&rtv : rtvs) {
+        auto memory = _dstorage_ext->texture_memory(rtv.handle);
+        size = min(size, make_uint2(std::max(memory.size.x >> rtv.level, 1u),
+                                    std::max(memory.size.y >> rtv.level, 1u)));
+    }
+    if (auto dsv = command->dsv_tex(); dsv.handle != invalid_resource_handle) {
+        auto memory = _dstorage_ext->texture_memory(dsv.handle);
+        target.depth = memory.data;
+        target.depth_storage = memory.storage;
+        target.depth_size = make_uint2(memory.size.x, memory.size.y);
+        if (rtvs.empty()) { size = target.depth_size; }
+    }
+    if (rtvs.empty() && target.depth == nullptr) { return; }
+    auto viewport = command->viewport();
+    target.size = size;
+    target.viewport_offset = viewport.start * make_float2(size);
+    target.viewport_size = viewport.size * make_float2(size);
+
+    auto [prim_weight, prim_bias] = blend_weight(state.blend_state.prim_op);
+    auto [img_weight, img_bias] = blend_weight(state.blend_state.img_op);
+    auto weight_bias = make_float2(prim_bias, img_bias);
+    auto blend_op = state.blend_state.enable_blend ? static_cast<uint>(state.blend_state.op) : blend_disabled;
+    auto vertex_stride = shader->vertex_type->size();
+
+    for (auto &&mesh : command->scene()) {
+        auto streams = mesh.vertex_buffers();
+        LUISA_ASSERT(streams.size() == shader->vertex_stream_count,
+                     "Mesh has {} vertex streams but the raster shader expects {}.",
+                     streams.size(), shader->vertex_stream_count);
+        auto vertex_count = std::numeric_limits<size_t>::max();
+        for (auto &&s : streams) { vertex_count = std::min(vertex_count, s.size() / s.stride()); }
+        luisa::span<const uint> indices;
+        luisa::visit(
+            [&]<typename T>(T index) noexcept {
+                if constexpr (std::is_same_v<T, uint>) {
+                    LUISA_ASSERT(streams.empty() || index <= vertex_count,
+                                 "Draw of {} vertices exceeds the vertex buffers ({} vertices).",
+                                 index, vertex_count);
+                    vertex_count = index;
+                } else {
+                    auto memory = _dstorage_ext->buffer_memory(index.handle());
+                    indices = {reinterpret_cast<const uint *>(memory.data + index.offset_bytes()), index.size()};
+                }
+            },
+            mesh.index());
+        auto instance_count = static_cast<size_t>(mesh.instance_count());
+        if (vertex_count == 0u || vertex_count == std::numeric_limits<size_t>::max() || instance_count == 0u) { continue; }
+
+        // run the vertex stage of all instances
+        auto total_vertex_count = vertex_count * instance_count;
+        auto vertices = _reserve(_vertices, total_vertex_count * vertex_stride);
+        {
+            ComputeDispatchCmdEncoder encoder{shader->vertex_shader.handle,
+                                              Function{shader->vertex_kernel.get()}.unbound_arguments().size(),
+                                              shader->vertex_uniform_size};
+            for (auto &&s : streams) { encoder.encode_buffer(s.handle(), s.offset(), s.size()); }
+            for (auto &&s : streams) {
+                auto stride = static_cast<uint>(s.stride());
+                encoder.encode_uniform(&stride, sizeof(stride));
+            }
+            encoder.encode_buffer(_vertices.handle, 0u, total_vertex_count * vertex_stride);
+            auto n = static_cast<uint>(vertex_count);
+            encoder.encode_uniform(&n, sizeof(n));
+            encode_stage_arguments(encoder, 0u, shader->vertex_argument_count);
+            encoder.set_dispatch_size(make_uint3(n, static_cast<uint>(instance_count), 1u));
+            CommandList list;
+            list << std::move(encoder).build();
+            _device->dispatch(_stream, list.commit().command_list());
+            _device->synchronize_stream(_stream);
+        }
+
+        // assemble the triangles, with invalid indices for out-of-range ones so that they are dropped
+        _host_triangles.clear();
+        auto triangle_count = (indices.empty() ? vertex_count : indices.size()) / 3u;
+        _host_triangles.reserve(triangle_count * instance_count);
+        for (auto instance = 0u; instance < instance_count; instance++) {
+            auto base = static_cast<uint>(instance * vertex_count);
+            auto remap = [&](uint i) noexcept { return i < vertex_count ? base + i : ~0u; };
+            for (auto t = 0u; t < triangle_count; t++) {
+                auto i0 = indices.empty() ? t * 3u : indices[t * 3u];
+                auto i1 = indices.empty() ? t * 3u + 1u : indices[t * 3u + 1u];
+                auto i2 = indices.empty() ? t * 3u + 2u : indices[t * 3u + 2u];
+                _host_triangles.emplace_back(make_uint4(remap(i0), remap(i1), remap(i2), 0u));
+            }
+        }
+
+        // blending must see the fragments of each pixel in primitive order
+        auto ordered = state.blend_state.enable_blend;
+        auto stats = _rasterizer->rasterize(target, state, ordered, vertices, vertex_stride, total_vertex_count,
+                                            _host_triangles, _host_fragments, _layer_offsets);
+        LUISA_VERBOSE("Rasterized {} triangles into {} fragments in {} layers.",
+                      stats.triangles, stats.fragments, stats.layers);
+        if (stats.fragments == 0u) { continue; }
+
+        // run the pixel stage on the fragments, a dispatch per layer
+        auto triangle_bytes = _host_triangles.size() * sizeof(uint4);
+        auto fragment_bytes = _host_fragments.size() * sizeof(CPURasterFragment);
+        std::memcpy(_reserve(_triangles, triangle_bytes), _host_triangles.data(), triangle_bytes);
+        std::memcpy(_reserve(_fragments, fragment_bytes), _host_fragments.data(), fragment_bytes);
+        CommandList list;
+        for (auto layer = 0u; layer + 1u < _layer_offsets.size(); layer++) {
+            ComputeDispatchCmdEncoder encoder{shader->pixel_shader.handle,
+                                              Function{shader->pixel_kernel.get()}.unbound_arguments().size(),
+                                              shader->pixel_uniform_size};
+            encoder.encode_buffer(_fragments.handle, 0u, fragment_bytes);
+            encoder.encode_buffer(_triangles.handle, 0u, triangle_bytes);
+            encoder.encode_buffer(_vertices.handle, 0u, total_vertex_count * vertex_stride);
+            auto offset = static_cast<uint>(_layer_offsets[layer]);
+            encoder.encode_uniform(&offset, sizeof(offset));
+            encoder.encode_uniform(&blend_op, sizeof(blend_op));
+            encoder.encode_uniform(&prim_weight, sizeof(prim_weight));
+            encoder.encode_uniform(&img_weight, sizeof(img_weight));
+            encoder.encode_uniform(&weight_bias, sizeof(weight_bias));
+            for (auto &&rtv : rtvs) { encoder.encode_texture(rtv.handle, rtv.level); }
+            encode_stage_arguments(encoder, shader->vertex_argument_count, arguments.size());
+            auto count = static_cast<uint>(_layer_offsets[layer + 1u] - _layer_offsets[layer]);
+            encoder.set_dispatch_size(make_uint3(count, 1u, 1u));
+            list << std::move(encoder).build();
+        }
+        _device->dispatch(_stream, list.commit().command_list());
+        _device->synchronize_stream(_stream);
+    }
+}
+
+}// namespace luisa::compute::cpu
+
+#endif
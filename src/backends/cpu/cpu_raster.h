@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mutex>
+
+#include <luisa/core/thread_pool.h>
+#include <luisa/core/stl/memory.h>
+#include <luisa/backends/ext/raster_ext_interface.h>
+
+#include "cpu_rasterizer.h"
+
+namespace luisa::compute {
+class DrawRasterSceneCommand;
+class ClearDepthCommand;
+}// namespace luisa::compute
+
+namespace luisa::compute::cpu {
+
+class CPUDStorageExt;
+
+/**
+ * @brief RasterExt of the CPU backend
+ *
+ * The vertex and pixel stages are wrapped into compute kernels: one shades the
+ * vertices of all instances into a buffer, and the other interpolates the
+ * outputs of the vertex stage at the fragments, calls the pixel stage, blends
+ * and writes the render targets. The fragments in between are produced on the
+ * host by CPURasterizer, which also tests and writes the depth buffer.
+ *
+ * Draws are host commands: they run on the thread of the stream they are
+ * dispatched to, and the wrapper kernels are dispatched to a private stream
+ * that is synchronized before the draw completes. Depth buffers are textures
+ * with the storage of DepthBuffer::to_img(), so they can be read by kernels.
+ *
+ * Wireframes, points, lines, the stencil test and object_id() are not supported.
+ */
+class CPURasterExt final : public RasterExt {
+
+public:
+    struct Shader;
+
+private:
+    DeviceInterface *_device;
+    CPUDStorageExt *_dstorage_ext;
+    // created on the first draw, as they own a worker pool and a stream
+    std::mutex _mutex;
+    luisa::unique_ptr<ThreadPool> _pool;
+    luisa::unique_ptr<CPURasterizer> _rasterizer;
+    uint64_t _stream{invalid_resource_handle};
+    // growable scratch buffers shared by the draws
+    BufferCreationInfo _vertices{BufferCreationInfo::make_invalid()};
+    BufferCreationInfo _triangles{BufferCreationInfo::make_invalid()};
+    BufferCreationInfo _fragments{BufferCreationInfo::make_invalid()};
+    luisa::vector<uint4> _host_triangles;
+    luisa::vector<CPURasterFragment> _host_fragments;
+    luisa::vector<size_t> _layer_offsets;
+
+private:
+    [[nodiscard]] std::byte *_reserve(BufferCreationInfo &buffer, size_t size_bytes) noexcept;
+
+public:
+    CPURasterExt(DeviceInterface *device, CPUDStorageExt *dstorage_ext) noexcept;
+    ~CPURasterExt() noexcept;
+    [[nodiscard]] ResourceCreationInfo create_raster_shader(const MeshFormat &mesh_format,
+                                                            Function vert, Function pixel,
+                                                            const ShaderOption &option) noexcept override;
+    [[nodiscard]] ResourceCreationInfo load_raster_shader(const MeshFormat &mesh_format,
+                                                          luisa::span<Type const *const> types,
+                                                          luisa::string_view ser_path) noexcept override;
+    void warm_up_pipeline_cache(uint64_t shader_handle,
+                                luisa::span<PixelFormat const> render_target_formats,
+                                DepthFormat depth_format,
+                                const RasterState &state) noexcept override {}
+    void destroy_raster_shader(uint64_t handle) noexcept override;
+    [[nodiscard]] ResourceCreationInfo create_depth_buffer(DepthFormat format, uint width, uint height) noexcept override;
+    void destroy_depth_buffer(uint64_t handle) noexcept override;
+    // host commands, blocking until they are done
+    void draw(const DrawRasterSceneCommand *command) noexcept;
+    void clear_depth(const ClearDepthCommand *command) noexcept;
+};
+
+}// namespace luisa::compute::cpu
@@ -0,0 +1,490 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+
+#include "cpu_rasterizer.h"
+
+namespace luisa::compute::cpu {
+
+namespace {
+
+constexpr auto quad_pixels = CPURasterizer::quad_size * CPURasterizer::quad_size;
+constexpr auto tile_quads = CPURasterizer::tile_size / CPURasterizer::quad_size;
+constexpr auto tile_pixels = CPURasterizer::tile_size * CPURasterizer::tile_size;
+constexpr auto min_chunk_triangles = 1024u;
+constexpr auto invalid_triangle = ~0u;
+// vertices closer than this to the eye plane are clipped away before the perspective division
+constexpr auto min_clip_w = 1e-5f;
+
+// offsets of the lanes in a quad, whose pixels are in row-major order like the texture blocks
+constexpr auto quad_lane_x = [] {
+    std::array<int, quad_pixels> x{};
+    for (auto i = 0u; i < quad_pixels; i++) { x[i] = static_cast<int>(i % CPURasterizer::quad_size); }
+    return x;
+}();
+
+constexpr auto quad_lane_y = [] {
+    std::array<int, quad_pixels> y{};
+    for (auto i = 0u; i < quad_pixels; i++) { y[i] = static_cast<int>(i / CPURasterizer::quad_size); }
+    return y;
+}();
+
+[[nodiscard]] float load_depth(const std::byte *texel, PixelStorage storage) noexcept {
+    switch (storage) {
+        case PixelStorage::SHORT1: {
+            uint16_t d;
+            std::memcpy(&d, texel, sizeof(d));
+            return static_cast<float>(d) * (1.f / 65535.f);
+        }
+        case PixelStorage::FLOAT1:
+        case PixelStorage::FLOAT2: {
+            float d;
+            std::memcpy(&d, texel, sizeof(d));
+            return d;
+        }
+        default: break;
+    }
+    LUISA_ERROR_WITH_LOCATION("Unsupported depth storage {}.", luisa::to_string(storage));
+}
+
+void store_depth(std::byte *texel, PixelStorage storage, float d) noexcept {
+    switch (storage) {
+        case PixelStorage::SHORT1: {
+            auto q = static_cast<uint16_t>(std::clamp(d, 0.f, 1.f) * 65535.f + .5f);
+            std::memcpy(texel, &q, sizeof(q));
+            break;
+        }
+        case PixelStorage::FLOAT1:
+        case PixelStorage::FLOAT2: std::memcpy(texel, &d, sizeof(d)); break;
+        default: LUISA_ERROR_WITH_LOCATION("Unsupported depth storage {}.", luisa::to_string(storage));
+    }
+}
+
+// clears the mask of the lanes that fail the depth test
+void depth_test(Comparison comparison, const float *z, const float *depth, uint *mask) noexcept {
+    switch (comparison) {
+        case Comparison::Never:
+            for (auto i = 0u; i < quad_pixels; i++) { mask[i] = 0u; }
+            break;
+        case Comparison::Less:
+            for (auto i = 0u; i < quad_pixels; i++) { mask[i] &= static_cast<uint>(z[i] < depth[i]); }
+            break;
+        case Comparison::Equal:
+            for (auto i = 0u; i < quad_pixels; i++) { mask[i] &= static_cast<uint>(z[i] == depth[i]); }
+            break;
+        case Comparison::LessEqual:
+            for (auto i = 0u; i < quad_pixels; i++) { mask[i] &= static_cast<uint>(z[i] <= depth[i]); }
+            break;
+        case Comparison::Greater:
+            for (auto i = 0u; i < quad_pixels; i++) { mask[i] &= static_cast<uint>(z[i] > depth[i]); }
+            break;
+        case Comparison::NotEqual:
+            for (auto i = 0u; i < quad_pixels; i++) { mask[i] &= static_cast<uint>(z[i] != depth[i]); }
+            break;
+        case Comparison::GreaterEqual:
+            for (auto i = 0u; i < quad_pixels; i++) { mask[i] &= static_cast<uint>(z[i] >= depth[i]); }
+            break;
+        case Comparison::Always: break;
+    }
+}
+
+}// namespace
+
+void CPURasterizer::_setup(const Target &target, const RasterState &state, int4 scissor,
+                           const std::array<float4, 3u> &positions,
+                           const std::array<float3, 3u> &barycentrics,
+                           uint triangle, luisa::vector<Setup> &setups) const noexcept {
+
+    // to the screen space, whose y axis points downwards
+    std::array<double, 3u> x{}, y{}, z{}, inv_w{};
+    auto b = barycentrics;
+    for (auto i = 0u; i < 3u; i++) {
+        auto p = positions[i];
+        inv_w[i] = 1.0 / p.w;
+        x[i] = target.viewport_offset.x + (p.x * inv_w[i] * .5 + .5) * target.viewport_size.x;
+        y[i] = target.viewport_offset.y + (.5 - p.y * inv_w[i] * .5) * target.viewport_size.y;
+        z[i] = p.z * inv_w[i];
+    }
+
+    // positive if the triangle is clockwise on the screen; also rejects NaNs
+    auto area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (!(std::abs(area) > 0.0)) { return; }
+    auto front = state.front_counter_clockwise ? area < 0.0 : area > 0.0;
+    if ((state.cull_mode == CullMode::Back && !front) ||
+        (state.cull_mode == CullMode::Front && front)) { return; }
+    // make the triangle clockwise, so that the edge functions are positive inside
+    if (area < 0.0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(z[1], z[2]);
+        std::swap(inv_w[1], inv_w[2]);
+        std::swap(b[1], b[2]);
+        area = -area;
+    }
+
+    // pixels whose centers fall into the bounding box
+    auto min_x = std::max(std::ceil(std::min({x[0], x[1], x[2]}) - .5), static_cast<double>(scissor.x));
+    auto min_y = std::max(std::ceil(std::min({y[0], y[1], y[2]}) - .5), static_cast<double>(scissor.y));
+    auto max_x = std::min(std::floor(std::max({x[0], x[1], x[2]}) - .5), static_cast<double>(scissor.z));
+    auto max_y = std::min(std::floor(std::max({y[0], y[1], y[2]}) - .5), static_cast<double>(scissor.w));
+    if (!(min_x <= max_x && min_y <= max_y)) { return; }
+
+    Setup s{};
+    s.bounds = make_int4(static_cast<int>(min_x), static_cast<int>(min_y),
+                         static_cast<int>(max_x), static_cast<int>(max_y));
+    s.origin = make_int2(s.bounds.x, s.bounds.y);
+    s.triangle = triangle;
+    // the planes are relative to the origin to keep their constant terms small
+    auto ox = static_cast<double>(s.origin.x);
+    auto oy = static_cast<double>(s.origin.y);
+    std::array<std::array<double, 3u>, 3u> e{};
+    for (auto i = 0u; i < 3u; i++) {
+        // the barycentric of vertex i is the edge function of the opposite edge (j -> k) over the area
+        auto j = (i + 1u) % 3u;
+        auto k = (i + 2u) % 3u;
+        auto dx = x[k] - x[j];
+        auto dy = y[k] - y[j];
+        e[i] = {-dy / area, dx / area, (dx * (oy - y[j]) - dy * (ox - x[j])) / area};
+        s.edges[i] = Plane{static_cast<float>(e[i][0]), static_cast<float>(e[i][1]), static_cast<float>(e[i][2])};
+        // pixel centers exactly on an edge belong to the triangle only if it is a top or left edge
+        if ((dy == 0.0 && dx > 0.0) || dy < 0.0) { s.top_left |= 1u << i; }
+    }
+    auto plane = [&e](std::array<double, 3u> q) noexcept {
+        std::array<double, 3u> p{};
+        for (auto i = 0u; i < 3u; i++) {
+            for (auto c = 0u; c < 3u; c++) { p[c] += e[i][c] * q[i]; }
+        }
+        return Plane{static_cast<float>(p[0]), static_cast<float>(p[1]), static_cast<float>(p[2])};
+    };
+    s.z = plane(z);
+    s.inv_w = plane(inv_w);
+    s.b1_over_w = plane({b[0].y * inv_w[0], b[1].y * inv_w[1], b[2].y * inv_w[2]});
+    s.b2_over_w = plane({b[0].z * inv_w[0], b[1].z * inv_w[1], b[2].z * inv_w[2]});
+    setups.emplace_back(s);
+}
+
+void CPURasterizer::_clip_and_setup(const Target &target, const RasterState &state, int4 scissor,
+                                    const std::array<float4, 3u> &positions,
+                                    uint triangle, luisa::vector<Setup> &setups) const noexcept {
+
+    auto all = [&positions](auto &&outside) noexcept {
+        return outside(positions[0]) && outside(positions[1]) && outside(positions[2]);
+    };
+    if (all([](float4 p) noexcept { return p.x < -p.w; }) ||
+        all([](float4 p) noexcept { return p.x > p.w; }) ||
+        all([](float4 p) noexcept { return p.y < -p.w; }) ||
+        all([](float4 p) noexcept { return p.y > p.w; }) ||
+        all([](float4 p) noexcept { return p.w < min_clip_w; })) { return; }
+    if (state.depth_clip &&
+        (all([](float4 p) noexcept { return p.z < 0.f; }) ||
+         all([](float4 p) noexcept { return p.z > p.w; }))) { return; }
+
+    constexpr std::array identity{make_float3(1.f, 0.f, 0.f),
+                                  make_float3(0.f, 1.f, 0.f),
+                                  make_float3(0.f, 0.f, 1.f)};
+    if (positions[0].w >= min_clip_w && positions[1].w >= min_clip_w && positions[2].w >= min_clip_w) {
+        _setup(target, state, scissor, positions, identity, triangle, setups);
+        return;
+    }
+    // only the eye plane needs clipping; the other planes are handled by the
+    // scissor and the per-pixel depth clipping. This leaves a triangle or a quad,
+    // whose vertices keep their barycentrics w.r.t. the original triangle.
+    std::array<float4, 4u> p{};
+    std::array<float3, 4u> b{};
+    auto n = 0u;
+    for (auto i = 0u; i < 3u; i++) {
+        auto j = (i + 1u) % 3u;
+        auto di = positions[i].w - min_clip_w;
+        auto dj = positions[j].w - min_clip_w;
+        if (di >= 0.f) {
+            p[n] = positions[i];
+            b[n] = identity[i];
+            n++;
+        }
+        if ((di >= 0.f) != (dj >= 0.f)) {
+            auto t = di / (di - dj);
+            p[n] = positions[i] + t * (positions[j] - positions[i]);
+            b[n] = identity[i] + t * (identity[j] - identity[i]);
+            n++;
+        }
+    }
+    for (auto k = 1u; k + 1u < n; k++) {
+        _setup(target, state, scissor,
+               {p[0], p[k], p[k + 1u]},
+               {b[0], b[k], b[k + 1u]},
+               triangle, setups);
+    }
+}
+
+void CPURasterizer::_rasterize_tile(const Target &target, const RasterState &state, bool ordered,
+                                    int4 scissor, luisa::span<const Chunk> chunks,
+                                    uint2 tile, uint tile_index, Tile &output) const noexcept {
+
+    output.fragments.clear();
+    output.layers.clear();
+    auto tile_min = make_int2(tile * tile_size);
+    auto tile_max = tile_min + static_cast<int>(tile_size) - 1;
+    auto rect = make_int4(std::max(tile_min.x, scissor.x), std::max(tile_min.y, scissor.y),
+                          std::min(tile_max.x, scissor.z), std::min(tile_max.y, scissor.w));
+    if (rect.x > rect.z || rect.y > rect.w) { return; }
+    auto empty = std::all_of(chunks.begin(), chunks.end(), [tile_index](auto &&chunk) noexcept {
+        return chunk.bins[tile_index].empty();
+    });
+    if (empty) { return; }
+
+    // quads of the tile that intersect the scissor
+    auto q_min = make_uint2(make_int2(rect.x, rect.y) - tile_min) / quad_size;
+    auto q_max = make_uint2(make_int2(rect.z, rect.w) - tile_min) / quad_size;
+    auto for_each_quad = [&](auto &&f) noexcept {
+        for (auto qy = q_min.y; qy <= q_max.y; qy++) {
+            for (auto qx = q_min.x; qx <= q_max.x; qx++) { f(qx, qy, qy * tile_quads + qx); }
+        }
+    };
+
+    // the depth of the tile is loaded into quad-major order, like the texture blocks
+    auto depth_test_enabled = target.depth != nullptr && state.depth_state.enable_depth;
+    auto depth_write_enabled = depth_test_enabled && state.depth_state.write;
+    auto depth_written = false;
+    auto depth_texel_size = depth_test_enabled ? pixel_storage_size(target.depth_storage, make_uint3(1u)) : 0u;
+    auto depth_grid_width = (target.depth_size.x + quad_size - 1u) / quad_size;
+    auto depth_block = [&](uint qx, uint qy) noexcept {
+        auto block = static_cast<size_t>(tile.y * tile_quads + qy) * depth_grid_width + tile.x * tile_quads + qx;
+        return target.depth + block * quad_pixels * depth_texel_size;
+    };
+    alignas(64) std::array<float, tile_pixels> depth;
+    if (depth_test_enabled) {
+        for_each_quad([&](uint qx, uint qy, uint q) noexcept {
+            auto block = depth_block(qx, qy);
+            for (auto i = 0u; i < quad_pixels; i++) {
+                depth[q * quad_pixels + i] = load_depth(block + i * depth_texel_size, target.depth_storage);
+            }
+        });
+    }
+
+    // the last fragment of each pixel, or the number of fragments of each pixel if ordered
+    std::array<uint, tile_pixels> pixel_triangles;
+    std::array<float2, tile_pixels> pixel_barycentrics;
+    std::array<uint, tile_pixels> &pixel_counts = pixel_triangles;
+    std::fill(pixel_triangles.begin(), pixel_triangles.end(), ordered ? 0u : invalid_triangle);
+
+    for (auto &&chunk : chunks) {
+        for (auto index : chunk.bins[tile_index]) {
+            auto &&s = chunk.setups[index];
+            auto r = make_int4(std::max(rect.x, s.bounds.x), std::max(rect.y, s.bounds.y),
+                               std::min(rect.z, s.bounds.z), std::min(rect.w, s.bounds.w));
+            if (r.x > r.z || r.y > r.w) { continue; }
+            auto sq_min = make_uint2(make_int2(r.x, r.y) - tile_min) / quad_size;
+            auto sq_max = make_uint2(make_int2(r.z, r.w) - tile_min) / quad_size;
+            for (auto qy = sq_min.y; qy <= sq_max.y; qy++) {
+                for (auto qx = sq_min.x; qx <= sq_max.x; qx++) {
+                    auto px = tile_min.x + static_cast<int>(qx * quad_size);
+                    auto py = tile_min.y + static_cast<int>(qy * quad_size);
+                    // pixel centers relative to the origin of the triangle
+                    auto fx = static_cast<float>(px - s.origin.x) + .5f;
+                    auto fy = static_cast<float>(py - s.origin.y) + .5f;
+                    // trivially reject the quad if any edge function is negative at all its pixels
+                    auto outside = false;
+                    for (auto &&e : s.edges) {
+                        auto max_x = fx + (e.a > 0.f ? static_cast<float>(quad_size - 1u) : 0.f);
+                        auto max_y = fy + (e.b > 0.f ? static_cast<float>(quad_size - 1u) : 0.f);
+                        outside |= e.a * max_x + e.b * max_y + e.c < 0.f;
+                    }
+                    if (outside) { continue; }
+                    alignas(64) std::array<float, quad_pixels> z;
+                    alignas(64) std::array<uint, quad_pixels> mask;
+                    auto tl0 = static_cast<uint>((s.top_left >> 0u) & 1u);
+                    auto tl1 = static_cast<uint>((s.top_left >> 1u) & 1u);
+                    auto tl2 = static_cast<uint>((s.top_left >> 2u) & 1u);
+                    for (auto i = 0u; i < quad_pixels; i++) {
+                        auto x = fx + static_cast<float>(quad_lane_x[i]);
+                        auto y = fy + static_cast<float>(quad_lane_y[i]);
+                        auto e0 = s.edges[0].a * x + s.edges[0].b * y + s.edges[0].c;
+                        auto e1 = s.edges[1].a * x + s.edges[1].b * y + s.edges[1].c;
+                        auto e2 = s.edges[2].a * x + s.edges[2].b * y + s.edges[2].c;
+                        auto inside = (static_cast<uint>(e0 > 0.f) | (static_cast<uint>(e0 == 0.f) & tl0)) &
+                                      (static_cast<uint>(e1 > 0.f) | (static_cast<uint>(e1 == 0.f) & tl1)) &
+                                      (static_cast<uint>(e2 > 0.f) | (static_cast<uint>(e2 == 0.f) & tl2));
+                        auto lx = px + quad_lane_x[i];
+                        auto ly = py + quad_lane_y[i];
+                        auto in_rect = static_cast<uint>(lx >= r.x) & static_cast<uint>(lx <= r.z) &
+                                       static_cast<uint>(ly >= r.y) & static_cast<uint>(ly <= r.w);
+                        auto zi = s.z.a * x + s.z.b * y + s.z.c;
+                        auto in_depth = static_cast<uint>(!state.depth_clip) |
+                                        (static_cast<uint>(zi >= 0.f) & static_cast<uint>(zi <= 1.f));
+                        z[i] = std::clamp(zi, 0.f, 1.f);
+                        mask[i] = inside & in_rect & in_depth;
+                    }
+                    auto q = qy * tile_quads + qx;
+                    auto quad_depth = depth.data() + q * quad_pixels;
+                    if (depth_test_enabled) {
+                        depth_test(state.depth_state.comparison, z.data(), quad_depth, mask.data());
+                    }
+                    for (auto i = 0u; i < quad_pixels; i++) {
+                        if (!mask[i]) { continue; }
+                        if (depth_write_enabled) {
+                            quad_depth[i] = z[i];
+                            depth_written = true;
+                        }
+                        auto x = fx + static_cast<float>(quad_lane_x[i]);
+                        auto y = fy + static_cast<float>(quad_lane_y[i]);
+                        auto w = 1.f / (s.inv_w.a * x + s.inv_w.b * y + s.inv_w.c);
+                        auto b1 = (s.b1_over_w.a * x + s.b1_over_w.b * y + s.b1_over_w.c) * w;
+                        auto b2 = (s.b2_over_w.a * x + s.b2_over_w.b * y + s.b2_over_w.c) * w;
+                        auto local = q * quad_pixels + i;
+                        if (ordered) {
+                            auto pixel = static_cast<uint>(px + quad_lane_x[i]) |
+                                         (static_cast<uint>(py + quad_lane_y[i]) << 16u);
+                            output.fragments.emplace_back(CPURasterFragment{pixel, s.triangle, b1, b2});
+                            output.layers.emplace_back(pixel_counts[local]++);
+                        } else {
+                            pixel_triangles[local] = s.triangle;
+                            pixel_barycentrics[local] = make_float2(b1, b2);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (depth_written) {
+        for_each_quad([&](uint qx, uint qy, uint q) noexcept {
+            auto block = depth_block(qx, qy);
+            for (auto i = 0u; i < quad_pixels; i++) {
+                store_depth(block + i * depth_texel_size, target.depth_storage, depth[q * quad_pixels + i]);
+            }
+        });
+    }
+    if (!ordered) {
+        for_each_quad([&](uint qx, uint qy, uint q) noexcept {
+            for (auto i = 0u; i < quad_pixels; i++) {
+                if (auto t = pixel_triangles[q * quad_pixels + i]; t != invalid_triangle) {
+                    auto x = static_cast<uint>(tile_min.x + quad_lane_x[i]) + qx * quad_size;
+                    auto y = static_cast<uint>(tile_min.y + quad_lane_y[i]) + qy * quad_size;
+                    auto b = pixel_barycentrics[q * quad_pixels + i];
+                    output.fragments.emplace_back(CPURasterFragment{x | (y << 16u), t, b.x, b.y});
+                }
+            }
+        });
+    }
+}
+
+void CPURasterizer::clear_depth(std::byte *depth, PixelStorage storage, uint2 size, float value) noexcept {
+    auto grid = (size + quad_size - 1u) / quad_size;
+    auto texel_count = static_cast<size_t>(grid.x) * grid.y * quad_pixels;
+    auto texel_size = pixel_storage_size(storage, make_uint3(1u));
+    // the padding of the blocks is cleared as well
+    for (auto i = static_cast<size_t>(0u); i < texel_count; i++) {
+        store_depth(depth + i * texel_size, storage, value);
+    }
+}
+
+CPURasterizer::Statistics CPURasterizer::rasterize(const Target &target, const RasterState &state, bool ordered,
+                                                   const std::byte *vertices, size_t vertex_stride, size_t vertex_count,
+                                                   luisa::span<const uint4> triangles,
+                                                   luisa::vector<CPURasterFragment> &fragments,
+                                                   luisa::vector<size_t> &layer_offsets) noexcept {
+
+    LUISA_ASSERT(all(target.size <= 65536u), "Render target size {} is too large for rasterization.", target.size);
+    fragments.clear();
+    layer_offsets.clear();
+    layer_offsets.emplace_back(0u);
+
+    // the scissor is the viewport clamped to the render targets
+    auto size = target.size;
+    if (target.depth != nullptr && state.depth_state.enable_depth) { size = min(size, target.depth_size); }
+    auto viewport_min = floor(target.viewport_offset);
+    auto viewport_max = ceil(target.viewport_offset + target.viewport_size);
+    auto scissor = make_int4(static_cast<int>(std::max(viewport_min.x, 0.f)),
+                             static_cast<int>(std::max(viewport_min.y, 0.f)),
+                             static_cast<int>(std::min(viewport_max.x, static_cast<float>(size.x))) - 1,
+                             static_cast<int>(std::min(viewport_max.y, static_cast<float>(size.y))) - 1);
+    if (triangles.empty() || scissor.x > scissor.z || scissor.y > scissor.w) { return {}; }
+
+    // set up and bin the triangles in chunks
+    auto tiles = (target.size + tile_size - 1u) / tile_size;
+    auto tile_count = tiles.x * tiles.y;
+    auto triangle_count = static_cast<uint>(triangles.size());
+    auto chunk_count = std::clamp((triangle_count + min_chunk_triangles - 1u) / min_chunk_triangles,
+                                  1u, std::max(_pool.size(), 1u) * 4u);
+    auto chunk_size = (triangle_count + chunk_count - 1u) / chunk_count;
+    if (_chunks.size() < chunk_count) { _chunks.resize(chunk_count); }
+    auto setup_chunk = [&](uint c) noexcept {
+        auto &&chunk = _chunks[c];
+        chunk.setups.clear();
+        chunk.bins.resize(tile_count);
+        for (auto &&bin : chunk.bins) { bin.clear(); }
+        auto begin = c * chunk_size;
+        auto end = std::min(begin + chunk_size, triangle_count);
+        for (auto t = begin; t < end; t++) {
+            auto tri = triangles[t];
+            // triangles with out-of-range indices are dropped
+            if (tri.x >= vertex_count || tri.y >= vertex_count || tri.z >= vertex_count) { continue; }
+            std::array<float4, 3u> p{};
+            std::memcpy(&p[0], vertices + tri.x * vertex_stride, sizeof(float4));
+            std::memcpy(&p[1], vertices + tri.y * vertex_stride, sizeof(float4));
+            std::memcpy(&p[2], vertices + tri.z * vertex_stride, sizeof(float4));
+            auto first = chunk.setups.size();
+            _clip_and_setup(target, state, scissor, p, t, chunk.setups);
+            for (auto i = first; i < chunk.setups.size(); i++) {
+                auto &&b = chunk.setups[i].bounds;
+                for (auto ty = b.y / tile_size; ty <= b.w / tile_size; ty++) {
+                    for (auto tx = b.x / tile_size; tx <= b.z / tile_size; tx++) {
+                        chunk.bins[ty * tiles.x + tx].emplace_back(static_cast<uint>(i));
+                    }
+                }
+            }
+        }
+    };
+    if (chunk_count == 1u) {
+        setup_chunk(0u);
+    } else {
+        _pool.parallel(chunk_count, setup_chunk);
+        _pool.synchronize();
+    }
+
+    // rasterize the tiles
+    auto chunks = luisa::span<const Chunk>{_chunks.data(), chunk_count};
+    if (_tiles.size() < tile_count) { _tiles.resize(tile_count); }
+    _pool.parallel(tile_count, [&](uint i) noexcept {
+        _rasterize_tile(target, state, ordered, scissor, chunks,
+                        make_uint2(i % tiles.x, i / tiles.x), i, _tiles[i]);
+    });
+    _pool.synchronize();
+
+    // gather the fragments, sorted by their layers if ordered
+    Statistics stats{};
+    for (auto &&chunk : chunks) { stats.triangles += chunk.setups.size(); }
+    auto tile_outputs = luisa::span<const Tile>{_tiles.data(), tile_count};
+    for (auto &&t : tile_outputs) { stats.fragments += t.fragments.size(); }
+    fragments.resize(stats.fragments);
+    if (!ordered) {
+        auto offset = static_cast<size_t>(0u);
+        for (auto &&t : tile_outputs) {
+            std::copy(t.fragments.cbegin(), t.fragments.cend(), fragments.begin() + offset);
+            offset += t.fragments.size();
+        }
+        if (offset != 0u) { layer_offsets.emplace_back(offset); }
+    } else {
+        luisa::vector<size_t> counts;
+        for (auto &&t : tile_outputs) {
+            for (auto l : t.layers) {
+                if (l >= counts.size()) { counts.resize(l + 1u, 0u); }
+                counts[l]++;
+            }
+        }
+        for (auto c : counts) { layer_offsets.emplace_back(layer_offsets.back() + c); }
+        luisa::vector<size_t> cursors{layer_offsets.cbegin(), layer_offsets.cend() - 1};
+        for (auto &&t : tile_outputs) {
+            for (auto i = 0u; i < t.fragments.size(); i++) {
+                fragments[cursors[t.layers[i]]++] = t.fragments[i];
+            }
+        }
+    }
+    stats.layers = layer_offsets.size() - 1u;
+    return stats;
+}
+
+}// namespace luisa::compute::cpu
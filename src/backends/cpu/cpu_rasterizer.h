@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+
+#include <luisa/core/basic_types.h>
+#include <luisa/core/thread_pool.h>
+#include <luisa/core/stl/memory.h>
+#include <luisa/core/stl/vector.h>
+#include <luisa/runtime/rhi/pixel.h>
+#include <luisa/runtime/raster/raster_state.h>
+
+namespace luisa::compute::cpu {
+
+// a covered pixel handed to the pixel stage, which reads it as an uint4
+struct CPURasterFragment {
+    uint pixel;   // x | (y << 16)
+    uint triangle;// index into the triangle list of the draw
+    float b1;     // perspective-correct barycentrics of the
+    float b2;     // second and the third vertex of the triangle
+};
+
+static_assert(sizeof(CPURasterFragment) == sizeof(uint4));
+
+/**
+ * @brief Tiled software rasterizer of the CPU backend
+ *
+ * Triangles are clipped, culled and set up in parallel chunks, each of which
+ * bins its triangles into screen tiles. The tiles are then rasterized in
+ * parallel, each walking the bins of all chunks in primitive order. Edge
+ * functions, depth planes and the early depth test are evaluated on 4x4 pixel
+ * quads in fixed-size lanes that the compiler vectorizes; the quads match the
+ * block-linear layout of textures, so the depth buffer is accessed in place.
+ *
+ * Unless the fragments must be shaded in order (e.g., for blending), only the
+ * last fragment that passes the depth test is kept for each pixel, like the
+ * hidden surface removal of tile-based GPUs. Otherwise, the fragments are
+ * grouped into layers, such that no two fragments in a layer cover the same
+ * pixel and shading the layers in turn respects the primitive order.
+ */
+class CPURasterizer {
+
+public:
+    static constexpr auto tile_size = 64u;
+    static constexpr auto quad_size = 4u;
+
+    struct Target {
+        uint2 size;
+        float2 viewport_offset;// in pixels
+        float2 viewport_size;  // in pixels
+        // level 0 of a block-linear depth texture, or nullptr if no depth buffer is bound
+        std::byte *depth;
+        PixelStorage depth_storage;
+        uint2 depth_size;
+    };
+
+    struct Statistics {
+        size_t triangles;// that survive clipping and culling
+        size_t fragments;
+        size_t layers;
+    };
+
+private:
+    // a plane equation a * x + b * y + c over the screen, relative to the origin of the triangle
+    struct Plane {
+        float a;
+        float b;
+        float c;
+    };
+
+    struct Setup {
+        std::array<Plane, 3u> edges;// normalized to the barycentrics of the vertices
+        uint top_left;              // bit i is set if edge i is a top or left edge
+        Plane z;
+        Plane inv_w;
+        Plane b1_over_w;
+        Plane b2_over_w;
+        int2 origin;
+        int4 bounds;// inclusive pixel bounds (min x, min y, max x, max y)
+        uint triangle;
+    };
+
+    struct Chunk {
+        luisa::vector<Setup> setups;
+        luisa::vector<luisa::vector<uint>> bins;
+    };
+
+    struct Tile {
+        luisa::vector<CPURasterFragment> fragments;
+        luisa::vector<uint> layers;
+    };
+
+private:
+    ThreadPool &_pool;
+    luisa::vector<Chunk> _chunks;
+    luisa::vector<Tile> _tiles;
+
+private:
+    void _setup(const Target &target, const RasterState &state, int4 scissor,
+                const std::array<float4, 3u> &positions,
+                const std::array<float3, 3u> &barycentrics,
+                uint triangle, luisa::vector<Setup> &setups) const noexcept;
+    void _clip_and_setup(const Target &target, const RasterState &state, int4 scissor,
+                         const std::array<float4, 3u> &positions,
+                         uint triangle, luisa::vector<Setup> &setups) const noexcept;
+    void _rasterize_tile(const Target &target, const RasterState &state, bool ordered,
+                         int4 scissor, luisa::span<const Chunk> chunks,
+                         uint2 tile, uint tile_index, Tile &output) const noexcept;
+
+public:
+    explicit CPURasterizer(ThreadPool &pool) noexcept : _pool{pool} {}
+    // fills level 0 of a block-linear depth texture
+    static void clear_depth(std::byte *depth, PixelStorage storage, uint2 size, float value) noexcept;
+    // The clip-space position of each vertex is the first float4 in each `vertex_stride` bytes of `vertices`.
+    // Fragments of layer i are in [layer_offsets[i], layer_offsets[i + 1]); there is a single layer unless ordered.
+    Statistics rasterize(const Target &target, const RasterState &state, bool ordered,
+                         const std::byte *vertices, size_t vertex_stride, size_t vertex_count,
+                         luisa::span<const uint4> triangles,
+                         luisa::vector<CPURasterFragment> &fragments,
+                         luisa::vector<size_t> &layer_offsets) noexcept;
+};
+
+}// namespace luisa::compute::cpu
@@ -0,0 +1,101 @@
+#include <cstring>
+
+#include <luisa/core/logging.h>
+#include <luisa/core/basic_traits.h>
+
+#include "cpu_shader_bundle.h"
+
+namespace luisa::compute::cpu {
+
+namespace detail {
+
+static constexpr char shader_bundle_magic[8] = {'L', 'C', 'C', 'P', 'U', 'S', 'B', '1'};
+
+template<typename T>
+void shader_bundle_write(luisa::vector<std::byte> &data, T value) noexcept {
+    static_assert(std::is_integral_v<T>);
+    for (auto i = 0u; i < sizeof(T); i++) {
+        data.emplace_back(static_cast<std::byte>((value >> (i * 8u)) & 0xffu));
+    }
+}
+
+class ShaderBundleReader {
+
+private:
+    luisa::span<const std::byte> _data;
+
+public:
+    explicit ShaderBundleReader(luisa::span<const std::byte> data) noexcept : _data{data} {}
+    [[nodiscard]] luisa::optional<luisa::span<const std::byte>> bytes(size_t n) noexcept {
+        if (n > _data.size()) { return luisa::nullopt; }
+        auto bytes = _data.subspan(0u, n);
+        _data = _data.subspan(n);
+        return bytes;
+    }
+    template<typename T>
+    [[nodiscard]] luisa::optional<T> read() noexcept {
+        auto bytes = this->bytes(sizeof(T));
+        if (!bytes) { return luisa::nullopt; }
+        auto value = static_cast<T>(0);
+        for (auto i = 0u; i < sizeof(T); i++) {
+            value |= static_cast<T>(static_cast<T>((*bytes)[i]) << (i * 8u));
+        }
+        return value;
+    }
+    [[nodiscard]] auto empty() const noexcept { return _data.empty(); }
+};
+
+}// namespace detail
+
+luisa::vector<std::byte> CPUShaderBundle::serialize() const noexcept {
+    LUISA_ASSERT(argument_types.size() == argument_usages.size(),
+                 "Shader bundle has {} argument types but {} usages.",
+                 argument_types.size(), argument_usages.size());
+    luisa::vector<std::byte> data;
+    auto types_size = static_cast<size_t>(0u);
+    for (auto &&t : argument_types) { types_size += t.size(); }
+    data.reserve(sizeof(detail::shader_bundle_magic) + 12u +
+                 argument_types.size() * 8u + types_size + artifact.size());
+    for (auto c : detail::shader_bundle_magic) { data.emplace_back(static_cast<std::byte>(c)); }
+    detail::shader_bundle_write(data, static_cast<uint32_t>(argument_types.size()));
+    for (auto i = 0u; i < argument_types.size(); i++) {
+        auto &&type = argument_types[i];
+        detail::shader_bundle_write(data, luisa::to_underlying(argument_usages[i]));
+        detail::shader_bundle_write(data, static_cast<uint32_t>(type.size()));
+        for (auto c : type) { data.emplace_back(static_cast<std::byte>(c)); }
+    }
+    detail::shader_bundle_write(data, static_cast<uint64_t>(artifact.size()));
+    data.insert(data.end(), artifact.cbegin(), artifact.cend());
+    return data;
+}
+
+luisa::optional<CPUShaderBundle> CPUShaderBundle::deserialize(luisa::span<const std::byte> data) noexcept {
+    detail::ShaderBundleReader reader{data};
+    auto magic = reader.bytes(sizeof(detail::shader_bundle_magic));
+    if (!magic || std::memcmp(magic->data(), detail::shader_bundle_magic,
+                              sizeof(detail::shader_bundle_magic)) != 0) {
+        return luisa::nullopt;
+    }
+    auto arg_count = reader.read<uint32_t>();
+    if (!arg_count) { return luisa::nullopt; }
+    CPUShaderBundle bundle;
+    bundle.argument_types.reserve(*arg_count);
+    bundle.argument_usages.reserve(*arg_count);
+    for (auto i = 0u; i < *arg_count; i++) {
+        auto usage = reader.read<uint32_t>();
+        auto type_size = reader.read<uint32_t>();
+        if (!usage || !type_size) { return luisa::nullopt; }
+        auto type = reader.bytes(*type_size);
+        if (!type) { return luisa::nullopt; }
+        bundle.argument_usages.emplace_back(static_cast<Usage>(*usage));
+        bundle.argument_types.emplace_back(reinterpret_cast<const char *>(type->data()), type->size());
+    }
+    auto artifact_size = reader.read<uint64_t>();
+    if (!artifact_size) { return luisa::nullopt; }
+    auto artifact = reader.bytes(*artifact_size);
+    if (!artifact || !reader.empty()) { return luisa::nullopt; }
+    bundle.artifact.assign(artifact->begin(), artifact->end());
+    return bundle;
+}
+
+}// namespace luisa::compute::cpu
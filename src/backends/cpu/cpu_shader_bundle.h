@@ -0,0 +1,32 @@
+#pragma once
+
+#include <luisa/core/stl/string.h>
+#include <luisa/core/stl/vector.h>
+#include <luisa/core/stl/optional.h>
+#include <luisa/ast/usage.h>
+
+namespace luisa::compute::cpu {
+
+/**
+ * @brief Ahead-of-time compiled shader of the CPU backend
+ *
+ * A bundle is the shader artifact of the backend (LLVM IR and launch
+ * information) together with the types and usages of the kernel arguments,
+ * so that the shader can be loaded by name without tracing the kernel or
+ * invoking clang. Artifacts are only accepted by the LLVM that built them.
+ *
+ * Layout: magic | argument count (u32) | per argument: usage (u32), type
+ * description size (u32), type description | artifact size (u64) | artifact.
+ * All integers are little endian.
+ */
+struct CPUShaderBundle {
+    luisa::vector<luisa::string> argument_types;
+    luisa::vector<Usage> argument_usages;
+    luisa::vector<std::byte> artifact;
+
+    [[nodiscard]] luisa::vector<std::byte> serialize() const noexcept;
+    // returns nullopt if the data is not a valid bundle
+    [[nodiscard]] static luisa::optional<CPUShaderBundle> deserialize(luisa::span<const std::byte> data) noexcept;
+};
+
+}// namespace luisa::compute::cpu
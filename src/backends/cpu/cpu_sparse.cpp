@@ -0,0 +1,312 @@
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include <luisa/core/logging.h>
+#include <luisa/core/platform.h>
+#include <luisa/core/mathematics.h>
+#include <luisa/core/stl/variant.h>
+#include <luisa/runtime/rhi/resource.h>
+
+#include "cpu_sparse.h"
+
+namespace luisa::compute::cpu {
+
+namespace detail {
+#ifndef _WIN32
+// the shared memory behind all unmapped pages, mapped over them in chunks of this size
+static constexpr auto sparse_scratch_size_bytes = static_cast<size_t>(32u) << 20u;
+
+[[nodiscard]] static int sparse_scratch_file() noexcept {
+    static auto fd = [] {
+#ifdef __linux__
+        auto fd = memfd_create("luisa-sparse-scratch", MFD_CLOEXEC);
+#else
+        auto name = luisa::format("/luisa-sparse-scratch-{}", getpid());
+        auto fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) { shm_unlink(name.c_str()); }
+#endif
+        LUISA_ASSERT(fd >= 0 && ftruncate(fd, sparse_scratch_size_bytes) == 0,
+                     "Failed to create the scratch memory of sparse resources: {}.",
+                     strerror(errno));
+        return fd;
+    }();
+    return fd;
+}
+#endif
+}// namespace detail
+
+CPUSparseResource::CPUSparseResource(size_t size_bytes) noexcept
+    : _page_size{pagesize()} {
+    _size_bytes = (size_bytes + _page_size - 1u) / _page_size * _page_size;
+#ifdef _WIN32
+    _data = static_cast<std::byte *>(VirtualAlloc(nullptr, _size_bytes, MEM_RESERVE, PAGE_NOACCESS));
+    LUISA_ASSERT(_data != nullptr, "Failed to reserve {} bytes for sparse resource (error = {}).",
+                 _size_bytes, GetLastError());
+#else
+    // NORESERVE keeps the range out of the commit charge
+    auto p = mmap(nullptr, _size_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    LUISA_ASSERT(p != MAP_FAILED, "Failed to reserve {} bytes for sparse resource: {}.",
+                 _size_bytes, strerror(errno));
+    _data = static_cast<std::byte *>(p);
+    LUISA_ASSERT(_map_scratch(0u, _size_bytes / _page_size),
+                 "Failed to map the scratch memory for sparse resource.");
+#endif
+}
+
+#ifndef _WIN32
+bool CPUSparseResource::_map_scratch(size_t first_page, size_t page_count) noexcept {
+    // every chunk aliases the start of the scratch memory, so the writes to
+    // unmapped pages are discarded into it instead of faulting
+    auto p = _data + first_page * _page_size;
+    auto n = page_count * _page_size;
+    for (auto offset = static_cast<size_t>(0u); offset < n; offset += detail::sparse_scratch_size_bytes) {
+        auto chunk = luisa::min(n - offset, detail::sparse_scratch_size_bytes);
+        auto q = mmap(p + offset, chunk, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                      detail::sparse_scratch_file(), 0);
+        if (q == MAP_FAILED) {
+            LUISA_WARNING_WITH_LOCATION("Failed to map {} bytes of scratch memory for sparse resource: {}.",
+                                        chunk, strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+CPUSparseResource::~CPUSparseResource() noexcept {
+#ifdef _WIN32
+    VirtualFree(_data, 0u, MEM_RELEASE);
+#else
+    munmap(_data, _size_bytes);
+#endif
+}
+
+bool CPUSparseResource::_commit(size_t first_page, size_t page_count) noexcept {
+    auto p = _data + first_page * _page_size;
+    auto n = page_count * _page_size;
+#ifdef _WIN32
+    if (VirtualAlloc(p, n, MEM_COMMIT, PAGE_READWRITE) == nullptr) {
+        LUISA_WARNING_WITH_LOCATION("Failed to commit {} bytes of sparse resource (error = {}).",
+                                    n, GetLastError());
+        return false;
+    }
+#else
+    // replaces the scratch memory with zero pages, which are populated lazily on first write
+    if (mmap(p, n, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0) == MAP_FAILED) {
+        LUISA_WARNING_WITH_LOCATION("Failed to commit {} bytes of sparse resource: {}.",
+                                    n, strerror(errno));
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool CPUSparseResource::_decommit(size_t first_page, size_t page_count) noexcept {
+    auto p = _data + first_page * _page_size;
+    auto n = page_count * _page_size;
+#ifdef _WIN32
+    if (VirtualFree(p, n, MEM_DECOMMIT) == 0) {
+        LUISA_WARNING_WITH_LOCATION("Failed to decommit {} bytes of sparse resource (error = {}).",
+                                    n, GetLastError());
+        return false;
+    }
+    return true;
+#else
+    // mapping the scratch memory over the pages returns them to the system
+    return _map_scratch(first_page, page_count);
+#endif
+}
+
+bool CPUSparseResource::_map(uint64_t tile, Range range) noexcept {
+    std::scoped_lock lock{_mutex};
+    if (range.size_bytes == 0u || !_tiles.emplace(tile).second) { return true; }
+    LUISA_ASSERT(range.offset + range.size_bytes <= _size_bytes, "Sparse tile out of range.");
+    auto first = range.offset / _page_size;
+    auto last = (range.offset + range.size_bytes - 1u) / _page_size;
+    // commit the runs of pages that are not touched by other mapped tiles
+    luisa::vector<std::pair<size_t, size_t>> runs;
+    for (auto page = first; page <= last; page++) {
+        if (_page_refs.contains(page)) { continue; }
+        if (!runs.empty() && runs.back().first + runs.back().second == page) {
+            runs.back().second++;
+        } else {
+            runs.emplace_back(page, 1u);
+        }
+    }
+    for (auto i = 0u; i < runs.size(); i++) {
+        if (!_commit(runs[i].first, runs[i].second)) {
+            // roll back, so that the tile stays unmapped as a whole
+            for (auto j = 0u; j <= i; j++) {
+                static_cast<void>(_decommit(runs[j].first, runs[j].second));
+            }
+            _tiles.erase(tile);
+            return false;
+        }
+    }
+    for (auto page = first; page <= last; page++) { _page_refs[page]++; }
+    return true;
+}
+
+bool CPUSparseResource::_unmap(uint64_t tile, Range range) noexcept {
+    std::scoped_lock lock{_mutex};
+    if (range.size_bytes == 0u || _tiles.erase(tile) == 0u) { return true; }
+    auto first = range.offset / _page_size;
+    auto last = (range.offset + range.size_bytes - 1u) / _page_size;
+    auto ok = true;
+    auto run = first;
+    for (auto page = first; page <= last; page++) {
+        auto iter = _page_refs.find(page);
+        LUISA_ASSERT(iter != _page_refs.end(), "Sparse page {} is not committed.", page);
+        if (--iter->second == 0u) {
+            _page_refs.erase(iter);
+        } else {
+            if (run < page) { ok &= _decommit(run, page - run); }
+            run = page + 1u;
+        }
+    }
+    if (run <= last) { ok &= _decommit(run, last + 1u - run); }
+    return ok;
+}
+
+const CPUSparseResource::Heap *CPUSparseResource::_heap(uint64_t handle) noexcept {
+    LUISA_ASSERT(handle != 0u && handle != invalid_resource_handle, "Invalid sparse heap.");
+    return reinterpret_cast<const Heap *>(handle);
+}
+
+size_t CPUSparseResource::resident_size_bytes() noexcept {
+    std::scoped_lock lock{_mutex};
+    return _page_refs.size() * _page_size;
+}
+
+CPUSparseBuffer::CPUSparseBuffer(size_t size_bytes) noexcept
+    : CPUSparseResource{(size_bytes + tile_size_bytes - 1u) / tile_size_bytes * tile_size_bytes} {}
+
+bool CPUSparseBuffer::update(const SparseOperation &operation) noexcept {
+    auto tile_count = size_bytes() / tile_size_bytes;
+    auto ok = true;
+    luisa::visit(
+        [&]<typename T>(const T &op) noexcept {
+            if constexpr (std::is_same_v<T, SparseBufferMapOperation>) {
+                auto heap = _heap(op.allocated_heap);
+                LUISA_ASSERT(op.tile_count * tile_size_bytes <= heap->size_bytes,
+                             "Sparse buffer heap ({} bytes) is too small for {} tiles.",
+                             heap->size_bytes, op.tile_count);
+                LUISA_ASSERT(op.start_tile + op.tile_count <= tile_count,
+                             "Sparse buffer tiles [{}, {}) out of range {}.",
+                             op.start_tile, op.start_tile + op.tile_count, tile_count);
+                for (auto i = 0u; i < op.tile_count; i++) {
+                    auto tile = static_cast<size_t>(op.start_tile) + i;
+                    ok &= _map(tile, Range{tile * tile_size_bytes, tile_size_bytes});
+                }
+            } else if constexpr (std::is_same_v<T, SparseBufferUnMapOperation>) {
+                auto end = luisa::min(static_cast<size_t>(op.start_tile) + op.tile_count, tile_count);
+                for (auto tile = static_cast<size_t>(op.start_tile); tile < end; tile++) {
+                    ok &= _unmap(tile, Range{tile * tile_size_bytes, tile_size_bytes});
+                }
+            } else {
+                LUISA_ERROR_WITH_LOCATION("Invalid sparse texture operation on buffer.");
+            }
+        },
+        operation);
+    return ok;
+}
+
+uint3 CPUSparseTexture::tile_size(PixelStorage storage, uint dimension) noexcept {
+    auto pixel_size = static_cast<uint>(pixel_storage_size(storage, make_uint3(1u)));
+    return dimension == 2u ? make_uint3(1024u / pixel_size, 64u, 1u) :
+                             make_uint3(256u / pixel_size, 16u, 16u);
+}
+
+size_t CPUSparseTexture::data_size_bytes(PixelStorage storage, uint dimension, uint3 size, uint mipmap_levels) noexcept {
+    auto tile = tile_size(storage, dimension);
+    auto size_bytes = static_cast<size_t>(0u);
+    for (auto l = 0u; l < mipmap_levels; l++) {
+        auto tiles = (luisa::max(size >> l, 1u) + tile - 1u) / tile;
+        size_bytes += static_cast<size_t>(tiles.x) * tiles.y * tiles.z * tile_size_bytes;
+    }
+    return size_bytes;
+}
+
+CPUSparseTexture::CPUSparseTexture(PixelStorage storage, uint dimension, uint3 size, uint mipmap_levels) noexcept
+    : CPUSparseResource{data_size_bytes(storage, dimension, size, mipmap_levels)},
+      _storage{storage}, _dimension{dimension}, _size{size}, _mipmap_levels{mipmap_levels},
+      _tile_size{tile_size(storage, dimension)} {
+    _level_offsets.reserve(mipmap_levels);
+    for (auto l = 0u; l < mipmap_levels; l++) {
+        _level_offsets.emplace_back(data_size_bytes(storage, dimension, size, l));
+    }
+}
+
+uint64_t CPUSparseTexture::_tile_index(uint level, uint3 tile) const noexcept {
+    return (static_cast<uint64_t>(level) << 60u) |
+           (static_cast<uint64_t>(tile.z) << 40u) |
+           (static_cast<uint64_t>(tile.y) << 20u) |
+           static_cast<uint64_t>(tile.x);
+}
+
+CPUSparseTexture::Range CPUSparseTexture::_tile_range(uint level, uint3 tile) const noexcept {
+    // tiles are stored one after another in row-major order within each level
+    auto tiles = (luisa::max(_size >> level, 1u) + _tile_size - 1u) / _tile_size;
+    if (any(tile >= tiles)) { return {}; }
+    auto index = tile.x + (tile.y + static_cast<size_t>(tile.z) * tiles.y) * tiles.x;
+    return Range{_level_offsets[level] + index * tile_size_bytes, tile_size_bytes};
+}
+
+bool CPUSparseTexture::update(const SparseOperation &operation) noexcept {
+    auto ok = true;
+    luisa::visit(
+        [&]<typename T>(const T &op) noexcept {
+            if constexpr (std::is_same_v<T, SparseTextureMapOperation> ||
+                          std::is_same_v<T, SparseTextureUnMapOperation>) {
+                LUISA_ASSERT(op.mip_level < _mipmap_levels, "Sparse texture mip level {} out of range {}.",
+                             op.mip_level, _mipmap_levels);
+                auto start = op.start_tile;
+                auto count = op.tile_count;
+                // images may leave the depth of the region as zero
+                if (_dimension == 2u) {
+                    start.z = 0u;
+                    count.z = 1u;
+                }
+                if constexpr (std::is_same_v<T, SparseTextureMapOperation>) {
+                    auto heap = _heap(op.allocated_heap);
+                    auto n = static_cast<size_t>(count.x) * count.y * count.z;
+                    LUISA_ASSERT(n * tile_size_bytes <= heap->size_bytes,
+                                 "Sparse texture heap ({} bytes) is too small for {} tiles.",
+                                 heap->size_bytes, n);
+                }
+                for (auto z = start.z; z < start.z + count.z; z++) {
+                    for (auto y = start.y; y < start.y + count.y; y++) {
+                        for (auto x = start.x; x < start.x + count.x; x++) {
+                            auto tile = make_uint3(x, y, z);
+                            auto range = _tile_range(op.mip_level, tile);
+                            if constexpr (std::is_same_v<T, SparseTextureMapOperation>) {
+                                ok &= _map(_tile_index(op.mip_level, tile), range);
+                            } else {
+                                ok &= _unmap(_tile_index(op.mip_level, tile), range);
+                            }
+                        }
+                    }
+                }
+            } else {
+                LUISA_ERROR_WITH_LOCATION("Invalid sparse buffer operation on texture.");
+            }
+        },
+        operation);
+    return ok;
+}
+
+}// namespace luisa::compute::cpu
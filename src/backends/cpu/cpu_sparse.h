@@ -0,0 +1,116 @@
+#pragma once
+
+#include <mutex>
+
+#include <luisa/core/stl/vector.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/runtime/rhi/pixel.h>
+#include <luisa/runtime/rhi/tile_modification.h>
+
+namespace luisa::compute::cpu {
+
+/**
+ * @brief Virtual memory behind a sparse buffer or texture of the CPU backend
+ *
+ * The whole resource is reserved as an address range when it is created, and
+ * only the pages under mapped tiles are committed, so the memory footprint is
+ * proportional to the resident tiles. Pages that are shared by neighbouring
+ * tiles are reference counted and stay committed while any of them is mapped.
+ *
+ * On POSIX systems, unmapped pages alias a process-wide shared scratch memory,
+ * so writes to unmapped tiles are discarded into it and reads return zero until
+ * such writes happen, and undefined values afterwards, as on GPUs without strict
+ * residency. Newly mapped tiles always read as zero. On Windows, unmapped tiles
+ * are inaccessible.
+ *
+ * Heaps are budgets rather than memory: a mapping is checked against the size
+ * of its heap, but tiles are never aliased through a shared heap.
+ *
+ * Every tile is a single contiguous range, so it takes one memory mapping of
+ * the system. If the system refuses to map it (e.g., too many mappings), the
+ * tile stays unmapped and the update reports the failure.
+ */
+class CPUSparseResource {
+
+public:
+    // 64KB, as the standard tile size of D3D12 and Vulkan
+    static constexpr size_t tile_size_bytes = 64u * 1024u;
+
+    struct Heap {
+        size_t size_bytes;
+    };
+
+protected:
+    struct Range {
+        size_t offset;
+        size_t size_bytes;
+    };
+
+private:
+    std::byte *_data{nullptr};
+    size_t _size_bytes{0u};
+    size_t _page_size{0u};
+    std::mutex _mutex;
+    luisa::unordered_set<uint64_t> _tiles;
+    // committed pages -> number of mapped tiles that touch them
+    luisa::unordered_map<size_t, uint> _page_refs;
+
+private:
+    [[nodiscard]] bool _commit(size_t first_page, size_t page_count) noexcept;
+    [[nodiscard]] bool _decommit(size_t first_page, size_t page_count) noexcept;
+#ifndef _WIN32
+    [[nodiscard]] bool _map_scratch(size_t first_page, size_t page_count) noexcept;
+#endif
+
+protected:
+    explicit CPUSparseResource(size_t size_bytes) noexcept;
+    // both are no-ops if the tile is already (un)mapped, and return false if the system fails
+    // to (de)commit its pages, in which case a tile to map stays unmapped and the pages of a
+    // tile to unmap stay committed until the resource is destroyed
+    [[nodiscard]] bool _map(uint64_t tile, Range range) noexcept;
+    [[nodiscard]] bool _unmap(uint64_t tile, Range range) noexcept;
+    [[nodiscard]] static const Heap *_heap(uint64_t handle) noexcept;
+
+public:
+    CPUSparseResource(const CPUSparseResource &) noexcept = delete;
+    CPUSparseResource &operator=(const CPUSparseResource &) noexcept = delete;
+    virtual ~CPUSparseResource() noexcept;
+    [[nodiscard]] auto data() const noexcept { return _data; }
+    [[nodiscard]] auto size_bytes() const noexcept { return _size_bytes; }
+    [[nodiscard]] size_t resident_size_bytes() noexcept;
+    // returns false if any of the tiles could not be (un)mapped, the others are still updated
+    [[nodiscard]] virtual bool update(const SparseOperation &operation) noexcept = 0;
+};
+
+class CPUSparseBuffer final : public CPUSparseResource {
+
+public:
+    explicit CPUSparseBuffer(size_t size_bytes) noexcept;
+    [[nodiscard]] bool update(const SparseOperation &operation) noexcept override;
+};
+
+class CPUSparseTexture final : public CPUSparseResource {
+
+private:
+    PixelStorage _storage;
+    uint _dimension;
+    uint3 _size;
+    uint _mipmap_levels;
+    uint3 _tile_size;
+    luisa::vector<size_t> _level_offsets;
+
+private:
+    [[nodiscard]] Range _tile_range(uint level, uint3 tile) const noexcept;
+    [[nodiscard]] uint64_t _tile_index(uint level, uint3 tile) const noexcept;
+
+public:
+    CPUSparseTexture(PixelStorage storage, uint dimension, uint3 size, uint mipmap_levels) noexcept;
+    // the tiles are 64KB, stored one after another and block-linear within each tile
+    [[nodiscard]] static uint3 tile_size(PixelStorage storage, uint dimension) noexcept;
+    // mirrors the tiled layout of sparse textures in the CPU backend (cpu/texture.rs)
+    [[nodiscard]] static size_t data_size_bytes(PixelStorage storage, uint dimension, uint3 size, uint mipmap_levels) noexcept;
+    [[nodiscard]] auto tile_size() const noexcept { return _tile_size; }
+    [[nodiscard]] bool update(const SparseOperation &operation) noexcept override;
+};
+
+}// namespace luisa::compute::cpu
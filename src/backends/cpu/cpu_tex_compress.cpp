@@ -0,0 +1,749 @@
+#include <latch>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include <luisa/runtime/image.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/runtime/stream.h>
+
+#include "cpu_tex_compress.h"
+
+namespace luisa::compute::cpu {
+
+namespace {
+
+// interpolation weights of the 4-bit and 3-bit indices, shared by BC6H and BC7
+constexpr std::array<int, 16> bc_weights4{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+constexpr std::array<int, 8> bc_weights3{0, 9, 18, 27, 37, 46, 55, 64};
+
+// BC7 two-subset partitions: pixel i belongs to the second subset if bit i is set
+constexpr std::array<uint16_t, 64> bc7_partitions{
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+    0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+    0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+    0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+    0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+    0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+    0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+    0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22};
+
+// the partitions above as 0/1 weights of the pixels, for vectorized masked sums
+constexpr auto bc7_partition_weights = [] {
+    std::array<std::array<float, 16>, 64> w{};
+    for (auto p = 0u; p < 64u; p++) {
+        for (auto i = 0u; i < 16u; i++) { w[p][i] = static_cast<float>((bc7_partitions[p] >> i) & 1u); }
+    }
+    return w;
+}();
+
+// anchor pixel of the second subset, whose index has an implicit zero MSB
+constexpr std::array<uint8_t, 64> bc7_anchors{
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+    15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+    6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15};
+
+// number of mode 1 partitions that are fully evaluated after the estimation
+constexpr auto bc7_partition_candidates = 4u;
+
+// the pixels of a block in channel-major order, so that loops over pixels vectorize
+struct Block {
+    std::array<std::array<float, 16>, 4> c;
+};
+
+struct BlockWriter {
+    std::array<uint64_t, 2> bits{};
+    uint offset{0u};
+    void write(uint value, uint count) noexcept {
+        for (auto i = 0u; i < count; i++) {
+            bits[offset >> 6u] |= static_cast<uint64_t>((value >> i) & 1u) << (offset & 63u);
+            offset++;
+        }
+    }
+    void store(std::byte *block) const noexcept {
+        LUISA_ASSERT(offset == 128u, "Invalid block size {} bits.", offset);
+        std::memcpy(block, bits.data(), sizeof(bits));
+    }
+};
+
+[[nodiscard]] float half_to_float(uint16_t h) noexcept {
+    auto sign = static_cast<uint>(h & 0x8000u) << 16u;
+    auto exponent = (h >> 10u) & 0x1fu;
+    auto mantissa = static_cast<uint>(h & 0x3ffu);
+    if (exponent == 0u) {
+        auto x = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -x : x;
+    }
+    auto bits = sign | (exponent == 0x1fu ? 0x7f800000u | (mantissa << 13u) :
+                                             ((exponent + 112u) << 23u) | (mantissa << 13u));
+    return luisa::bit_cast<float>(bits);
+}
+
+// the same rounding as the builtin BC6H encoder of the DirectX backend
+[[nodiscard]] uint float_to_half(float f) noexcept {
+    auto x = luisa::bit_cast<uint>(f);
+    auto sign = (x & 0x80000000u) >> 16u;
+    x &= 0x7fffffffu;
+    if (x > 0x47ffefffu) { return sign | 0x7fffu; }
+    if (x < 0x38800000u) {
+        auto shift = 113u - (x >> 23u);
+        x = shift < 32u ? (0x800000u | (x & 0x7fffffu)) >> shift : 0u;
+    } else {
+        x += 0xc8000000u;
+    }
+    return sign | (((x + 0x0fffu + ((x >> 13u) & 1u)) >> 13u) & 0x7fffu);
+}
+
+[[nodiscard]] constexpr auto is_supported_storage(PixelStorage storage) noexcept {
+    switch (storage) {
+        case PixelStorage::BYTE1:
+        case PixelStorage::BYTE2:
+        case PixelStorage::BYTE4:
+        case PixelStorage::SHORT1:
+        case PixelStorage::SHORT2:
+        case PixelStorage::SHORT4:
+        case PixelStorage::HALF1:
+        case PixelStorage::HALF2:
+        case PixelStorage::HALF4:
+        case PixelStorage::FLOAT1:
+        case PixelStorage::FLOAT2:
+        case PixelStorage::FLOAT4: return true;
+        default: break;
+    }
+    return false;
+}
+
+[[nodiscard]] float4 load_texel(const std::byte *p, PixelStorage storage) noexcept {
+    auto n = pixel_storage_channel_count(storage);
+    auto v = make_float4(0.f, 0.f, 0.f, 1.f);
+    for (auto i = 0u; i < n; i++) {
+        switch (storage) {
+            case PixelStorage::BYTE1:
+            case PixelStorage::BYTE2:
+            case PixelStorage::BYTE4:
+                v[i] = static_cast<float>(reinterpret_cast<const uint8_t *>(p)[i]) * (1.f / 255.f);
+                break;
+            case PixelStorage::SHORT1:
+            case PixelStorage::SHORT2:
+            case PixelStorage::SHORT4: {
+                uint16_t s;
+                std::memcpy(&s, p + i * sizeof(s), sizeof(s));
+                v[i] = static_cast<float>(s) * (1.f / 65535.f);
+                break;
+            }
+            case PixelStorage::HALF1:
+            case PixelStorage::HALF2:
+            case PixelStorage::HALF4: {
+                uint16_t h;
+                std::memcpy(&h, p + i * sizeof(h), sizeof(h));
+                v[i] = half_to_float(h);
+                break;
+            }
+            default:
+                std::memcpy(&v[i], p + i * sizeof(float), sizeof(float));
+                break;
+        }
+    }
+    return v;
+}
+
+// loads a 4x4 block and replicates the edge texels for partial blocks
+void load_block(const std::byte *pixels, PixelStorage storage, uint2 size,
+                uint bx, uint by, std::array<float4, 16> &texels) noexcept {
+    auto pixel_size = pixel_storage_size(storage, make_uint3(1u));
+    for (auto i = 0u; i < 16u; i++) {
+        auto x = std::min(bx * 4u + (i & 3u), size.x - 1u);
+        auto y = std::min(by * 4u + (i >> 2u), size.y - 1u);
+        texels[i] = load_texel(pixels + (static_cast<size_t>(y) * size.x + x) * pixel_size, storage);
+    }
+}
+
+// endpoints along the principal axis of the selected pixels, weighted per channel
+template<uint channels>
+void fit_line(const Block &b, uint mask, const float *weights,
+               std::array<float, 4> &e0, std::array<float, 4> &e1) noexcept {
+    auto count = 0.f;
+    std::array<float, 4> mean{};
+    for (auto i = 0u; i < 16u; i++) {
+        auto m = static_cast<float>((mask >> i) & 1u);
+        count += m;
+        for (auto c = 0u; c < channels; c++) { mean[c] += m * b.c[c][i]; }
+    }
+    for (auto c = 0u; c < channels; c++) { mean[c] /= std::max(count, 1.f); }
+    std::array<std::array<float, 4>, 4> cov{};
+    for (auto i = 0u; i < 16u; i++) {
+        if (!((mask >> i) & 1u)) { continue; }
+        std::array<float, 4> d{};
+        for (auto c = 0u; c < channels; c++) { d[c] = (b.c[c][i] - mean[c]) * weights[c]; }
+        for (auto r = 0u; r < channels; r++) {
+            for (auto c = 0u; c < channels; c++) { cov[r][c] += d[r] * d[c]; }
+        }
+    }
+    // power iteration, starting from the channel with the largest variance
+    std::array<float, 4> axis{};
+    auto largest = 0u;
+    for (auto c = 1u; c < channels; c++) {
+        if (cov[c][c] > cov[largest][largest]) { largest = c; }
+    }
+    axis[largest] = 1.f;
+    for (auto iter = 0u; iter < 8u; iter++) {
+        std::array<float, 4> next{};
+        for (auto r = 0u; r < channels; r++) {
+            for (auto c = 0u; c < channels; c++) { next[r] += cov[r][c] * axis[c]; }
+        }
+        auto norm = 0.f;
+        for (auto c = 0u; c < channels; c++) { norm += next[c] * next[c]; }
+        norm = std::sqrt(norm);
+        if (norm < 1e-12f) { break; }
+        for (auto c = 0u; c < channels; c++) { axis[c] = next[c] / norm; }
+    }
+    // back to the unweighted space
+    for (auto c = 0u; c < channels; c++) {
+        axis[c] = weights[c] > 0.f ? axis[c] / weights[c] : 0.f;
+    }
+    auto t_min = std::numeric_limits<float>::max();
+    auto t_max = std::numeric_limits<float>::lowest();
+    for (auto i = 0u; i < 16u; i++) {
+        if (!((mask >> i) & 1u)) { continue; }
+        auto t = 0.f;
+        for (auto c = 0u; c < channels; c++) { t += (b.c[c][i] - mean[c]) * axis[c] * weights[c] * weights[c]; }
+        t_min = std::min(t_min, t);
+        t_max = std::max(t_max, t);
+    }
+    if (t_min > t_max) { t_min = t_max = 0.f; }
+    auto axis_norm = 0.f;
+    for (auto c = 0u; c < channels; c++) { axis_norm += axis[c] * axis[c] * weights[c] * weights[c]; }
+    axis_norm = axis_norm > 0.f ? 1.f / axis_norm : 0.f;
+    for (auto c = 0u; c < channels; c++) {
+        e0[c] = mean[c] + axis[c] * t_min * axis_norm;
+        e1[c] = mean[c] + axis[c] * t_max * axis_norm;
+    }
+}
+
+// Least-squares endpoints for fixed interpolation weights (in 1/64).
+template<uint channels>
+void refine_line(const Block &b, uint mask, const std::array<int, 16> &w,
+                 std::array<float, 4> &e0, std::array<float, 4> &e1) noexcept {
+    auto aa = 0.f, ab = 0.f, bb = 0.f;
+    std::array<float, 4> ax{}, bx{};
+    for (auto i = 0u; i < 16u; i++) {
+        if (!((mask >> i) & 1u)) { continue; }
+        auto t = static_cast<float>(w[i]) * (1.f / 64.f);
+        auto s = 1.f - t;
+        aa += s * s;
+        ab += s * t;
+        bb += t * t;
+        for (auto c = 0u; c < channels; c++) {
+            ax[c] += s * b.c[c][i];
+            bx[c] += t * b.c[c][i];
+        }
+    }
+    auto det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f) { return; }
+    auto inv_det = 1.f / det;
+    for (auto c = 0u; c < channels; c++) {
+        e0[c] = (ax[c] * bb - bx[c] * ab) * inv_det;
+        e1[c] = (bx[c] * aa - ax[c] * ab) * inv_det;
+    }
+}
+
+// Picks the nearest palette entry for each selected pixel and returns the
+// weighted squared error. The endpoints are integers in the decoded range.
+template<uint channels, size_t levels>
+float assign_indices(const Block &b, uint mask, const float *weights,
+                     const std::array<int, 4> &a, const std::array<int, 4> &z,
+                     const std::array<int, levels> &palette_weights,
+                     std::array<int, 16> &indices) noexcept {
+    std::array<float, 16> best;
+    best.fill(std::numeric_limits<float>::max());
+    for (auto k = 0u; k < levels; k++) {
+        auto w = palette_weights[k];
+        std::array<float, 4> p{};
+        for (auto c = 0u; c < channels; c++) {
+            p[c] = static_cast<float>((a[c] * (64 - w) + z[c] * w + 32) >> 6);
+        }
+        for (auto i = 0u; i < 16u; i++) {
+            auto e = 0.f;
+            for (auto c = 0u; c < channels; c++) {
+                auto d = b.c[c][i] - p[c];
+                e += d * d * weights[c];
+            }
+            // selects instead of branches to keep the loop vectorized
+            auto better = e < best[i];
+            best[i] = better ? e : best[i];
+            indices[i] = better ? static_cast<int>(k) : indices[i];
+        }
+    }
+    auto error = 0.f;
+    for (auto i = 0u; i < 16u; i++) {
+        error += ((mask >> i) & 1u) ? best[i] : 0.f;
+    }
+    return error;
+}
+
+template<size_t levels>
+void index_weights(const std::array<int, 16> &indices,
+                   const std::array<int, levels> &palette_weights,
+                   std::array<int, 16> &w) noexcept {
+    for (auto i = 0u; i < 16u; i++) { w[i] = palette_weights[indices[i]]; }
+}
+
+/* BC7 */
+
+struct BC7Encoder {
+
+    Block block;
+    std::array<float, 4> weights;
+    bool opaque;
+
+    struct Mode6 {
+        std::array<int, 4> a, b;// 8-bit endpoints with the p-bit as LSB
+        std::array<int, 16> indices;
+        float error;
+    };
+
+    struct Mode1 {
+        uint partition;
+        std::array<std::array<int, 4>, 4> endpoints;// 7-bit endpoints with the p-bit as LSB
+        std::array<int, 16> indices;
+        float error;
+    };
+
+    [[nodiscard]] static int quantize_mode6(float v, int p) noexcept {
+        auto q = static_cast<int>(std::lround((v - static_cast<float>(p)) * .5f));
+        return std::clamp(q, 0, 127) * 2 + p;
+    }
+
+    [[nodiscard]] static int quantize_mode1(float v, int p) noexcept {
+        auto q = static_cast<int>(std::lround((v * .5f - static_cast<float>(p)) * .5f));
+        return std::clamp(q, 0, 63) * 2 + p;
+    }
+
+    [[nodiscard]] static int expand7(int v) noexcept { return (v << 1) | (v >> 6); }
+
+    [[nodiscard]] Mode6 encode_mode6() const noexcept {
+        std::array<float, 4> e0{}, e1{};
+        fit_line<4u>(block, 0xffffu, weights.data(), e0, e1);
+        Mode6 best{.error = std::numeric_limits<float>::max()};
+        for (auto iter = 0u; iter < 2u; iter++) {
+            for (auto p = 0; p < 4; p++) {
+                Mode6 m{};
+                for (auto c = 0u; c < 4u; c++) {
+                    m.a[c] = quantize_mode6(e0[c], p & 1);
+                    m.b[c] = quantize_mode6(e1[c], p >> 1);
+                }
+                m.error = assign_indices<4u>(block, 0xffffu, weights.data(), m.a, m.b, bc_weights4, m.indices);
+                if (m.error < best.error) { best = m; }
+            }
+            std::array<int, 16> w{};
+            index_weights(best.indices, bc_weights4, w);
+            refine_line<4u>(block, 0xffffu, w, e0, e1);
+        }
+        return best;
+    }
+
+    // the alpha of mode 1 is always opaque
+    [[nodiscard]] float alpha_error() const noexcept {
+        auto e = 0.f;
+        for (auto i = 0u; i < 16u; i++) {
+            auto d = block.c[3][i] - 255.f;
+            e += d * d * weights[3];
+        }
+        return e;
+    }
+
+    [[nodiscard]] Mode1 encode_mode1(uint partition) const noexcept {
+        Mode1 m{.partition = partition, .error = alpha_error()};
+        auto second = static_cast<uint>(bc7_partitions[partition]);
+        for (auto s = 0u; s < 2u; s++) {
+            auto mask = s == 0u ? (~second & 0xffffu) : second;
+            std::array<float, 4> e0{}, e1{};
+            fit_line<3u>(block, mask, weights.data(), e0, e1);
+            auto best_error = std::numeric_limits<float>::max();
+            std::array<int, 4> best_a{}, best_b{};
+            std::array<int, 16> best_indices{};
+            for (auto iter = 0u; iter < 2u; iter++) {
+                for (auto p = 0; p < 2; p++) {
+                    std::array<int, 4> a{}, b{}, qa{}, qb{};
+                    for (auto c = 0u; c < 3u; c++) {
+                        qa[c] = quantize_mode1(e0[c], p);
+                        qb[c] = quantize_mode1(e1[c], p);
+                        a[c] = expand7(qa[c]);
+                        b[c] = expand7(qb[c]);
+                    }
+                    std::array<int, 16> indices{};
+                    auto error = assign_indices<3u>(block, mask, weights.data(), a, b, bc_weights3, indices);
+                    if (error < best_error) {
+                        best_error = error;
+                        best_a = qa;
+                        best_b = qb;
+                        best_indices = indices;
+                    }
+                }
+                std::array<int, 16> w{};
+                index_weights(best_indices, bc_weights3, w);
+                refine_line<3u>(block, mask, w, e0, e1);
+            }
+            m.endpoints[s * 2u] = best_a;
+            m.endpoints[s * 2u + 1u] = best_b;
+            for (auto i = 0u; i < 16u; i++) {
+                if ((mask >> i) & 1u) { m.indices[i] = best_indices[i]; }
+            }
+            m.error += best_error;
+        }
+        return m;
+    }
+
+    // per-pixel moments 1, r, g, b, rr, rg, rb, gg, gb and bb of the colors
+    using Moments = std::array<std::array<float, 16>, 10>;
+
+    [[nodiscard]] Moments moments() const noexcept {
+        Moments m;
+        for (auto i = 0u; i < 16u; i++) {
+            auto r = block.c[0][i], g = block.c[1][i], b = block.c[2][i];
+            m[0][i] = 1.f;
+            m[1][i] = r, m[2][i] = g, m[3][i] = b;
+            m[4][i] = r * r, m[5][i] = r * g, m[6][i] = r * b;
+            m[7][i] = g * g, m[8][i] = g * b, m[9][i] = b * b;
+        }
+        return m;
+    }
+
+    // squared distance of the pixels to their principal axis, from the summed moments
+    [[nodiscard]] static float line_error(const std::array<float, 10> &s) noexcept {
+        if (s[0] < 1.f) { return 0.f; }
+        auto inv_n = 1.f / s[0];
+        std::array<std::array<float, 3>, 3> cov{};
+        cov[0][0] = s[4] - s[1] * s[1] * inv_n;
+        cov[0][1] = cov[1][0] = s[5] - s[1] * s[2] * inv_n;
+        cov[0][2] = cov[2][0] = s[6] - s[1] * s[3] * inv_n;
+        cov[1][1] = s[7] - s[2] * s[2] * inv_n;
+        cov[1][2] = cov[2][1] = s[8] - s[2] * s[3] * inv_n;
+        cov[2][2] = s[9] - s[3] * s[3] * inv_n;
+        auto trace = cov[0][0] + cov[1][1] + cov[2][2];
+        // power iteration rescaled by the largest component, then the Rayleigh quotient
+        std::array<float, 3> v{1.f, 1.f, 1.f};
+        for (auto iter = 0u; iter < 4u; iter++) {
+            std::array<float, 3> next{};
+            for (auto r = 0u; r < 3u; r++) {
+                next[r] = cov[r][0] * v[0] + cov[r][1] * v[1] + cov[r][2] * v[2];
+            }
+            auto scale = std::max({std::abs(next[0]), std::abs(next[1]), std::abs(next[2])});
+            if (scale < 1e-12f) { return trace; }
+            for (auto c = 0u; c < 3u; c++) { v[c] = next[c] / scale; }
+        }
+        auto vcv = 0.f;
+        for (auto r = 0u; r < 3u; r++) {
+            vcv += v[r] * (cov[r][0] * v[0] + cov[r][1] * v[1] + cov[r][2] * v[2]);
+        }
+        auto eigenvalue = vcv / (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        return std::max(trace - eigenvalue, 0.f);
+    }
+
+    [[nodiscard]] static float estimate_mode1(const Moments &m, const std::array<float, 10> &total,
+                                              uint partition) noexcept {
+        auto &second = bc7_partition_weights[partition];
+        std::array<float, 10> s{}, rest{};
+        for (auto k = 0u; k < 10u; k++) {
+            for (auto i = 0u; i < 16u; i++) { s[k] += second[i] * m[k][i]; }
+            rest[k] = total[k] - s[k];
+        }
+        return line_error(s) + line_error(rest);
+    }
+
+    static void pack(const Mode6 &mode, std::byte *output) noexcept {
+        auto m = mode;
+        // the MSB of the index of pixel 0 is implicitly zero
+        if (m.indices[0] >= 8) {
+            std::swap(m.a, m.b);
+            for (auto &i : m.indices) { i = 15 - i; }
+        }
+        BlockWriter w;
+        w.write(1u << 6u, 7u);
+        for (auto c = 0u; c < 4u; c++) {
+            w.write(m.a[c] >> 1, 7u);
+            w.write(m.b[c] >> 1, 7u);
+        }
+        w.write(m.a[0] & 1, 1u);
+        w.write(m.b[0] & 1, 1u);
+        for (auto i = 0u; i < 16u; i++) { w.write(m.indices[i], i == 0u ? 3u : 4u); }
+        w.store(output);
+    }
+
+    static void pack(const Mode1 &mode, std::byte *output) noexcept {
+        auto m = mode;
+        auto second = static_cast<uint>(bc7_partitions[m.partition]);
+        auto anchor = static_cast<uint>(bc7_anchors[m.partition]);
+        for (auto s = 0u; s < 2u; s++) {
+            auto a = s == 0u ? 0u : anchor;
+            if (m.indices[a] >= 4) {
+                std::swap(m.endpoints[s * 2u], m.endpoints[s * 2u + 1u]);
+                for (auto i = 0u; i < 16u; i++) {
+                    if (((second >> i) & 1u) == s) { m.indices[i] = 7 - m.indices[i]; }
+                }
+            }
+        }
+        BlockWriter w;
+        w.write(2u, 2u);
+        w.write(m.partition, 6u);
+        for (auto c = 0u; c < 3u; c++) {
+            for (auto e = 0u; e < 4u; e++) { w.write(m.endpoints[e][c] >> 1, 6u); }
+        }
+        w.write(m.endpoints[0][0] & 1, 1u);
+        w.write(m.endpoints[2][0] & 1, 1u);
+        for (auto i = 0u; i < 16u; i++) {
+            w.write(m.indices[i], i == 0u || i == anchor ? 2u : 3u);
+        }
+        w.store(output);
+    }
+
+    void encode(std::byte *output) const noexcept {
+        auto mode6 = encode_mode6();
+        // two subsets only pay off if the alpha can be dropped
+        if (opaque && mode6.error > 0.f) {
+            // rank the partitions by the line errors of their subsets
+            auto m = moments();
+            std::array<float, 10> total{};
+            for (auto k = 0u; k < 10u; k++) {
+                for (auto i = 0u; i < 16u; i++) { total[k] += m[k][i]; }
+            }
+            std::array<std::pair<float, uint>, 64> estimates;
+            for (auto p = 0u; p < 64u; p++) { estimates[p] = {estimate_mode1(m, total, p), p}; }
+            std::partial_sort(estimates.begin(), estimates.begin() + bc7_partition_candidates,
+                              estimates.end());
+            Mode1 best_mode1{.error = std::numeric_limits<float>::max()};
+            for (auto i = 0u; i < bc7_partition_candidates; i++) {
+                auto candidate = encode_mode1(estimates[i].second);
+                if (candidate.error < best_mode1.error) { best_mode1 = candidate; }
+            }
+            if (best_mode1.error < mode6.error) {
+                pack(best_mode1, output);
+                return;
+            }
+        }
+        pack(mode6, output);
+    }
+};
+
+void encode_bc7_block(const std::array<float4, 16> &texels, float alpha_importance, std::byte *output) noexcept {
+    BC7Encoder encoder{.weights = {1.f, 1.f, 1.f, alpha_importance}, .opaque = true};
+    for (auto i = 0u; i < 16u; i++) {
+        for (auto c = 0u; c < 4u; c++) {
+            auto v = std::clamp(texels[i][c], 0.f, 1.f) * 255.f;
+            encoder.block.c[c][i] = std::isnan(v) ? 0.f : v;
+        }
+        if (alpha_importance > 0.f && encoder.block.c[3][i] < 254.5f) { encoder.opaque = false; }
+    }
+    encoder.encode(output);
+}
+
+/* BC6H */
+
+struct BC6HMode {
+    uint bits;        // mode bits
+    uint precision;   // endpoint precision
+    uint delta;       // precision of the second endpoint, as delta if transformed
+    bool transformed;
+};
+
+// the single-region modes 11 to 14
+constexpr std::array<BC6HMode, 4> bc6h_modes{
+    BC6HMode{0x03u, 10u, 10u, false},
+    BC6HMode{0x07u, 11u, 9u, true},
+    BC6HMode{0x0bu, 12u, 8u, true},
+    BC6HMode{0x0fu, 16u, 4u, true}};
+
+[[nodiscard]] int bc6h_unquantize(int q, uint precision) noexcept {
+    if (precision >= 15u) { return q; }
+    if (q == 0) { return 0; }
+    if (q == (1 << precision) - 1) { return 0xffff; }
+    return ((q << 16) + 0x8000) >> precision;
+}
+
+[[nodiscard]] int bc6h_quantize(float v, uint precision) noexcept {
+    auto max = (1 << precision) - 1;
+    if (precision >= 15u) { return std::clamp(static_cast<int>(std::lround(v)), 0, max); }
+    auto q = std::clamp(static_cast<int>(v * static_cast<float>(1 << precision) / 65536.f), 0, max);
+    auto q1 = std::min(q + 1, max);
+    return std::abs(static_cast<float>(bc6h_unquantize(q1, precision)) - v) <
+                   std::abs(static_cast<float>(bc6h_unquantize(q, precision)) - v) ?
+               q1 :
+               q;
+}
+
+struct BC6HEncoder {
+
+    // half bits scaled by 64/31, which interpolation works on
+    Block block;
+
+    struct Encoding {
+        const BC6HMode *mode;
+        std::array<int, 4> a, b;// quantized endpoints
+        std::array<int, 16> indices;
+        float error;
+    };
+
+    [[nodiscard]] float evaluate(Encoding &e) const noexcept {
+        constexpr std::array<float, 4> weights{1.f, 1.f, 1.f, 0.f};
+        std::array<int, 4> a{}, b{};
+        for (auto c = 0u; c < 3u; c++) {
+            a[c] = bc6h_unquantize(e.a[c], e.mode->precision);
+            b[c] = bc6h_unquantize(e.b[c], e.mode->precision);
+        }
+        e.error = assign_indices<3u>(block, 0xffffu, weights.data(), a, b, bc_weights4, e.indices);
+        return e.error;
+    }
+
+    // swaps the endpoints so that the MSB of the index of pixel 0 is zero
+    static void fix_anchor(Encoding &e) noexcept {
+        if (e.indices[0] >= 8) {
+            std::swap(e.a, e.b);
+            for (auto &i : e.indices) { i = 15 - i; }
+        }
+    }
+
+    [[nodiscard]] Encoding encode_mode(const BC6HMode &mode) const noexcept {
+        constexpr std::array<float, 4> weights{1.f, 1.f, 1.f, 0.f};
+        std::array<float, 4> e0{}, e1{};
+        fit_line<3u>(block, 0xffffu, weights.data(), e0, e1);
+        Encoding best{.mode = &mode, .error = std::numeric_limits<float>::max()};
+        for (auto iter = 0u; iter < 2u; iter++) {
+            Encoding e{.mode = &mode};
+            for (auto c = 0u; c < 3u; c++) {
+                e.a[c] = bc6h_quantize(e0[c], mode.precision);
+                e.b[c] = bc6h_quantize(e1[c], mode.precision);
+            }
+            if (evaluate(e) < best.error) { best = e; }
+            std::array<int, 16> w{};
+            index_weights(best.indices, bc_weights4, w);
+            refine_line<3u>(block, 0xffffu, w, e0, e1);
+        }
+        fix_anchor(best);
+        if (mode.transformed) {
+            // clamp the deltas symmetrically, so that they still fit after another swap
+            auto limit = (1 << (mode.delta - 1u)) - 1;
+            auto clamped = false;
+            for (auto c = 0u; c < 3u; c++) {
+                auto d = best.b[c] - best.a[c];
+                if (d < -limit || d > limit) {
+                    best.b[c] = best.a[c] + std::clamp(d, -limit, limit);
+                    clamped = true;
+                }
+            }
+            if (clamped) {
+                static_cast<void>(evaluate(best));
+                fix_anchor(best);
+            }
+        }
+        return best;
+    }
+
+    static void pack(const Encoding &e, std::byte *output) noexcept {
+        auto &mode = *e.mode;
+        BlockWriter w;
+        w.write(mode.bits, 5u);
+        for (auto c = 0u; c < 3u; c++) { w.write(e.a[c], 10u); }
+        for (auto c = 0u; c < 3u; c++) {
+            auto b = mode.transformed ? e.b[c] - e.a[c] : e.b[c];
+            w.write(static_cast<uint>(b) & ((1u << mode.delta) - 1u), mode.delta);
+            // the high bits of the first endpoint are stored in reverse order
+            for (auto bit = static_cast<int>(mode.precision) - 1; bit >= 10; bit--) {
+                w.write(static_cast<uint>(e.a[c]) >> bit, 1u);
+            }
+        }
+        for (auto i = 0u; i < 16u; i++) { w.write(e.indices[i], i == 0u ? 3u : 4u); }
+        w.store(output);
+    }
+
+    void encode(std::byte *output) const noexcept {
+        Encoding best{.error = std::numeric_limits<float>::max()};
+        for (auto &mode : bc6h_modes) {
+            auto e = encode_mode(mode);
+            if (e.error < best.error) { best = e; }
+            if (best.error == 0.f) { break; }
+        }
+        pack(best, output);
+    }
+};
+
+void encode_bc6h_block(const std::array<float4, 16> &texels, std::byte *output) noexcept {
+    BC6HEncoder encoder{};
+    for (auto i = 0u; i < 16u; i++) {
+        for (auto c = 0u; c < 3u; c++) {
+            // unsigned: negative values and NaNs become zero, infinities the largest half
+            auto v = texels[i][c];
+            auto h = v > 0.f ? std::min(float_to_half(v), 0x7bffu) : 0u;
+            encoder.block.c[c][i] = static_cast<float>((h << 6u) / 31u);
+        }
+    }
+    encoder.encode(output);
+}
+
+template<typename Encode>
+TexCompressExt::Result compress_blocks(ThreadPool &pool, Stream &stream,
+                                       Image<float> const &src, BufferView<uint> const &result,
+                                       luisa::string_view format, Encode &&encode) noexcept {
+    auto view = src.view(0u);
+    auto storage = view.storage();
+    if (!is_supported_storage(storage)) {
+        LUISA_WARNING_WITH_LOCATION("Unsupported pixel storage {} for {} compression.",
+                                    luisa::to_string(storage), format);
+        return TexCompressExt::Result::Failed;
+    }
+    auto size = view.size();
+    auto blocks = (size + 3u) / 4u;
+    auto size_bytes = static_cast<size_t>(blocks.x) * blocks.y * 16u;
+    if (result.size_bytes() < size_bytes) {
+        LUISA_WARNING_WITH_LOCATION("Buffer of {} bytes is too small for the {} "
+                                    "compression of a {}x{} image ({} bytes).",
+                                    result.size_bytes(), format, size.x, size.y, size_bytes);
+        return TexCompressExt::Result::Failed;
+    }
+    luisa::vector<std::byte> pixels(view.size_bytes());
+    auto pixel_data = pixels.data();
+    auto output = static_cast<std::byte *>(result.native_handle()) + result.offset_bytes();
+    stream << view.copy_to(pixel_data)
+           << [&pool, pixels = std::move(pixels), storage, size, blocks, output,
+               encode = std::forward<Encode>(encode)]() noexcept {
+                  // one task per row of blocks
+                  std::latch latch{static_cast<std::ptrdiff_t>(blocks.y)};
+                  pool.parallel(blocks.y, [&](uint by) noexcept {
+                      std::array<float4, 16> texels;
+                      for (auto bx = 0u; bx < blocks.x; bx++) {
+                          load_block(pixels.data(), storage, size, bx, by, texels);
+                          encode(texels, output + (static_cast<size_t>(by) * blocks.x + bx) * 16u);
+                      }
+                      latch.count_down();
+                  });
+                  latch.wait();
+              };
+    return TexCompressExt::Result::Success;
+}
+
+}// namespace
+
+CPUTexCompressExt::CPUTexCompressExt() noexcept = default;
+CPUTexCompressExt::~CPUTexCompressExt() noexcept = default;
+
+TexCompressExt::Result CPUTexCompressExt::compress_bc6h(Stream &stream, Image<float> const &src,
+                                                        BufferView<uint> const &result) noexcept {
+    return compress_blocks(_pool, stream, src, result, "BC6H", [](auto &texels, auto output) noexcept {
+        encode_bc6h_block(texels, output);
+    });
+}
+
+TexCompressExt::Result CPUTexCompressExt::compress_bc7(Stream &stream, Image<float> const &src,
+                                                       BufferView<uint> const &result,
+                                                       float alpha_importance) noexcept {
+    alpha_importance = std::max(alpha_importance, 0.f);
+    return compress_blocks(_pool, stream, src, result, "BC7", [alpha_importance](auto &texels, auto output) noexcept {
+        encode_bc7_block(texels, alpha_importance, output);
+    });
+}
+
+}// namespace luisa::compute::cpu
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <luisa/core/thread_pool.h>
+#include <luisa/backends/ext/tex_compress_ext.h>
+
+namespace luisa::compute::cpu {
+
+/**
+ * @brief TexCompressExt of the CPU backend
+ *
+ * The source image is downloaded in stream order and then encoded by a
+ * stream callback, so the result buffer is ready for any command that is
+ * enqueued after the compression. Blocks are encoded in parallel by a
+ * private worker pool, and the 16 pixels of a block are processed in
+ * fixed-size lanes that the compiler vectorizes.
+ *
+ * BC7 blocks are encoded with mode 6 (single subset with alpha) or mode 1
+ * (two subsets, opaque). BC6H blocks are unsigned (UF16) and encoded with
+ * the single-region modes 11 to 14.
+ */
+class CPUTexCompressExt final : public TexCompressExt {
+
+private:
+    ThreadPool _pool;
+
+public:
+    CPUTexCompressExt() noexcept;
+    ~CPUTexCompressExt() noexcept;
+    Result compress_bc6h(Stream &stream, Image<float> const &src, BufferView<uint> const &result) noexcept override;
+    Result compress_bc7(Stream &stream, Image<float> const &src, BufferView<uint> const &result, float alpha_importance) noexcept override;
+    Result check_builtin_shader() noexcept override { return Result::Success; }
+};
+
+}// namespace luisa::compute::cpu
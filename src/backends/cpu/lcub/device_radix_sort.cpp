@@ -0,0 +1,189 @@
+#include <luisa/backends/ext/cpu/lcub/device_radix_sort.h>
+#include "lcub_utils.h"
+
+namespace luisa::compute::cpu::lcub {
+// DOC:  https://nvlabs.github.io/cub/structcub_1_1_device_radix_sort.html
+
+void DeviceRadixSort::SortPairs(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<int32_t> d_values_in, BufferView<int32_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, int32_t>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairs(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<int32_t> d_values_in, BufferView<int32_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<false>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairs(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<uint32_t> d_values_in, BufferView<uint32_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, uint32_t>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairs(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<uint32_t> d_values_in, BufferView<uint32_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<false>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairs(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<int64_t> d_values_in, BufferView<int64_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, int64_t>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairs(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<int64_t> d_values_in, BufferView<int64_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<false>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairs(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<uint64_t> d_values_in, BufferView<uint64_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, uint64_t>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairs(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<uint64_t> d_values_in, BufferView<uint64_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<false>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairs(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<float> d_values_in, BufferView<float> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, float>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairs(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<float> d_values_in, BufferView<float> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<false>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairs(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<double> d_values_in, BufferView<double> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, double>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairs(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<double> d_values_in, BufferView<double> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<false>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairsDescending(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<int32_t> d_values_in, BufferView<int32_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, int32_t>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairsDescending(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<int32_t> d_values_in, BufferView<int32_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<true>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairsDescending(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<uint32_t> d_values_in, BufferView<uint32_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, uint32_t>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairsDescending(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<uint32_t> d_values_in, BufferView<uint32_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<true>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairsDescending(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<int64_t> d_values_in, BufferView<int64_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, int64_t>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairsDescending(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<int64_t> d_values_in, BufferView<int64_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<true>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairsDescending(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<uint64_t> d_values_in, BufferView<uint64_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, uint64_t>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairsDescending(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<uint64_t> d_values_in, BufferView<uint64_t> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<true>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairsDescending(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<float> d_values_in, BufferView<float> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, float>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairsDescending(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<float> d_values_in, BufferView<float> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<true>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortPairsDescending(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<double> d_values_in, BufferView<double> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, double>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortPairsDescending(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, BufferView<double> d_values_in, BufferView<double> d_values_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<true>(temp, raw(d_keys_in), raw(d_keys_out), raw(d_values_in), raw(d_values_out), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortKeys(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, void>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortKeys(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<false>(temp, raw(d_keys_in), raw(d_keys_out), static_cast<const void *>(nullptr), static_cast<void *>(nullptr), num_items, begin_bit, end_bit);
+    });
+}
+
+void DeviceRadixSort::SortKeysDescending(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(radix_sort_temp_storage_bytes<int32_t, void>(num_items));
+}
+
+DeviceRadixSort::UCommand DeviceRadixSort::SortKeysDescending(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_keys_out, int num_items, int begin_bit, int end_bit) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        radix_sort<true>(temp, raw(d_keys_in), raw(d_keys_out), static_cast<const void *>(nullptr), static_cast<void *>(nullptr), num_items, begin_bit, end_bit);
+    });
+}
+
+}// namespace luisa::compute::cpu::lcub
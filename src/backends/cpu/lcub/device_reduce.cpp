@@ -0,0 +1,427 @@
+#include <luisa/backends/ext/cpu/lcub/device_reduce.h>
+#include "lcub_utils.h"
+
+namespace luisa::compute::cpu::lcub {
+// DOC:  https://nvlabs.github.io/cub/structcub_1_1_device_reduce.html
+
+void DeviceReduce::Sum(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Sum(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, int32_t{}, [](auto a, auto b) noexcept { return a + b; });
+    });
+}
+
+void DeviceReduce::Sum(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Sum(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, uint32_t{}, [](auto a, auto b) noexcept { return a + b; });
+    });
+}
+
+void DeviceReduce::Sum(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Sum(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, int64_t{}, [](auto a, auto b) noexcept { return a + b; });
+    });
+}
+
+void DeviceReduce::Sum(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Sum(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, uint64_t{}, [](auto a, auto b) noexcept { return a + b; });
+    });
+}
+
+void DeviceReduce::Sum(size_t &temp_storage_size, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<float>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Sum(BufferView<int> d_temp_storage, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, float{}, [](auto a, auto b) noexcept { return a + b; });
+    });
+}
+
+void DeviceReduce::Sum(size_t &temp_storage_size, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<double>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Sum(BufferView<int> d_temp_storage, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, double{}, [](auto a, auto b) noexcept { return a + b; });
+    });
+}
+
+void DeviceReduce::Max(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Max(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<int32_t>::lowest(), [](auto a, auto b) noexcept { return std::max(a, b); });
+    });
+}
+
+void DeviceReduce::Max(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Max(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<uint32_t>::lowest(), [](auto a, auto b) noexcept { return std::max(a, b); });
+    });
+}
+
+void DeviceReduce::Max(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Max(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<int64_t>::lowest(), [](auto a, auto b) noexcept { return std::max(a, b); });
+    });
+}
+
+void DeviceReduce::Max(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Max(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<uint64_t>::lowest(), [](auto a, auto b) noexcept { return std::max(a, b); });
+    });
+}
+
+void DeviceReduce::Max(size_t &temp_storage_size, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<float>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Max(BufferView<int> d_temp_storage, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<float>::lowest(), [](auto a, auto b) noexcept { return std::max(a, b); });
+    });
+}
+
+void DeviceReduce::Max(size_t &temp_storage_size, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<double>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Max(BufferView<int> d_temp_storage, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<double>::lowest(), [](auto a, auto b) noexcept { return std::max(a, b); });
+    });
+}
+
+void DeviceReduce::Min(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Min(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<int32_t>::max(), [](auto a, auto b) noexcept { return std::min(a, b); });
+    });
+}
+
+void DeviceReduce::Min(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Min(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<uint32_t>::max(), [](auto a, auto b) noexcept { return std::min(a, b); });
+    });
+}
+
+void DeviceReduce::Min(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Min(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<int64_t>::max(), [](auto a, auto b) noexcept { return std::min(a, b); });
+    });
+}
+
+void DeviceReduce::Min(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Min(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<uint64_t>::max(), [](auto a, auto b) noexcept { return std::min(a, b); });
+    });
+}
+
+void DeviceReduce::Min(size_t &temp_storage_size, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<float>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Min(BufferView<int> d_temp_storage, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<float>::max(), [](auto a, auto b) noexcept { return std::min(a, b); });
+    });
+}
+
+void DeviceReduce::Min(size_t &temp_storage_size, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<double>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::Min(BufferView<int> d_temp_storage, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = reduce(temp, raw(d_in), num_items, std::numeric_limits<double>::max(), [](auto a, auto b) noexcept { return std::min(a, b); });
+    });
+}
+
+void DeviceReduce::ArgMin(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<KeyValuePair<int32_t, int32_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, int32_t>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMin(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<KeyValuePair<int32_t, int32_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<int32_t>::max(), [](auto a, auto b) noexcept { return a < b; });
+    });
+}
+
+void DeviceReduce::ArgMin(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<KeyValuePair<int32_t, uint32_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, uint32_t>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMin(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<KeyValuePair<int32_t, uint32_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<uint32_t>::max(), [](auto a, auto b) noexcept { return a < b; });
+    });
+}
+
+void DeviceReduce::ArgMin(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<KeyValuePair<int32_t, int64_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, int64_t>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMin(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<KeyValuePair<int32_t, int64_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<int64_t>::max(), [](auto a, auto b) noexcept { return a < b; });
+    });
+}
+
+void DeviceReduce::ArgMin(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<KeyValuePair<int32_t, uint64_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, uint64_t>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMin(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<KeyValuePair<int32_t, uint64_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<uint64_t>::max(), [](auto a, auto b) noexcept { return a < b; });
+    });
+}
+
+void DeviceReduce::ArgMin(size_t &temp_storage_size, BufferView<float> d_in, BufferView<KeyValuePair<int32_t, float>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, float>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMin(BufferView<int> d_temp_storage, BufferView<float> d_in, BufferView<KeyValuePair<int32_t, float>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<float>::max(), [](auto a, auto b) noexcept { return a < b; });
+    });
+}
+
+void DeviceReduce::ArgMin(size_t &temp_storage_size, BufferView<double> d_in, BufferView<KeyValuePair<int32_t, double>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, double>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMin(BufferView<int> d_temp_storage, BufferView<double> d_in, BufferView<KeyValuePair<int32_t, double>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<double>::max(), [](auto a, auto b) noexcept { return a < b; });
+    });
+}
+
+void DeviceReduce::ArgMax(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<KeyValuePair<int32_t, int32_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, int32_t>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMax(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<KeyValuePair<int32_t, int32_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<int32_t>::lowest(), [](auto a, auto b) noexcept { return a > b; });
+    });
+}
+
+void DeviceReduce::ArgMax(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<KeyValuePair<int32_t, uint32_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, uint32_t>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMax(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<KeyValuePair<int32_t, uint32_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<uint32_t>::lowest(), [](auto a, auto b) noexcept { return a > b; });
+    });
+}
+
+void DeviceReduce::ArgMax(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<KeyValuePair<int32_t, int64_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, int64_t>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMax(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<KeyValuePair<int32_t, int64_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<int64_t>::lowest(), [](auto a, auto b) noexcept { return a > b; });
+    });
+}
+
+void DeviceReduce::ArgMax(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<KeyValuePair<int32_t, uint64_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, uint64_t>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMax(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<KeyValuePair<int32_t, uint64_t>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<uint64_t>::lowest(), [](auto a, auto b) noexcept { return a > b; });
+    });
+}
+
+void DeviceReduce::ArgMax(size_t &temp_storage_size, BufferView<float> d_in, BufferView<KeyValuePair<int32_t, float>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, float>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMax(BufferView<int> d_temp_storage, BufferView<float> d_in, BufferView<KeyValuePair<int32_t, float>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<float>::lowest(), [](auto a, auto b) noexcept { return a > b; });
+    });
+}
+
+void DeviceReduce::ArgMax(size_t &temp_storage_size, BufferView<double> d_in, BufferView<KeyValuePair<int32_t, double>> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(reduce_temp_storage_bytes<KeyValuePair<int32_t, double>>(num_items));
+}
+
+DeviceReduce::UCommand DeviceReduce::ArgMax(BufferView<int> d_temp_storage, BufferView<double> d_in, BufferView<KeyValuePair<int32_t, double>> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto out = raw(d_out);
+        *out = arg_reduce(temp, raw(d_in), num_items, std::numeric_limits<double>::lowest(), [](auto a, auto b) noexcept { return a > b; });
+    });
+}
+
+}// namespace luisa::compute::cpu::lcub
@@ -0,0 +1,187 @@
+#include <luisa/backends/ext/cpu/lcub/device_run_length_encode.h>
+#include "lcub_utils.h"
+
+namespace luisa::compute::cpu::lcub {
+// DOC:  https://nvlabs.github.io/cub/structcub_1_1_device_run_length_encode.html
+
+void DeviceRunLengthEncode::Encode(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<int32_t> d_unique_out, BufferView<int32_t> d_counts_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(run_length_encode_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceRunLengthEncode::UCommand DeviceRunLengthEncode::Encode(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<int32_t> d_unique_out, BufferView<int32_t> d_counts_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_runs_out = raw(d_num_runs_out);
+        auto in = raw(d_in);
+        auto unique_out = raw(d_unique_out);
+        auto counts_out = raw(d_counts_out);
+        *num_runs_out = static_cast<int32_t>(for_each_run(
+            temp, in, num_items, [](size_t) noexcept { return true; },
+            [=](size_t run, size_t begin, size_t end) noexcept {
+                unique_out[run] = in[begin];
+                counts_out[run] = static_cast<int32_t>(end - begin);
+            }));
+    });
+}
+
+void DeviceRunLengthEncode::Encode(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<uint32_t> d_unique_out, BufferView<int32_t> d_counts_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(run_length_encode_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceRunLengthEncode::UCommand DeviceRunLengthEncode::Encode(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<uint32_t> d_unique_out, BufferView<int32_t> d_counts_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_runs_out = raw(d_num_runs_out);
+        auto in = raw(d_in);
+        auto unique_out = raw(d_unique_out);
+        auto counts_out = raw(d_counts_out);
+        *num_runs_out = static_cast<int32_t>(for_each_run(
+            temp, in, num_items, [](size_t) noexcept { return true; },
+            [=](size_t run, size_t begin, size_t end) noexcept {
+                unique_out[run] = in[begin];
+                counts_out[run] = static_cast<int32_t>(end - begin);
+            }));
+    });
+}
+
+void DeviceRunLengthEncode::Encode(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<int64_t> d_unique_out, BufferView<int32_t> d_counts_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(run_length_encode_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceRunLengthEncode::UCommand DeviceRunLengthEncode::Encode(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<int64_t> d_unique_out, BufferView<int32_t> d_counts_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_runs_out = raw(d_num_runs_out);
+        auto in = raw(d_in);
+        auto unique_out = raw(d_unique_out);
+        auto counts_out = raw(d_counts_out);
+        *num_runs_out = static_cast<int32_t>(for_each_run(
+            temp, in, num_items, [](size_t) noexcept { return true; },
+            [=](size_t run, size_t begin, size_t end) noexcept {
+                unique_out[run] = in[begin];
+                counts_out[run] = static_cast<int32_t>(end - begin);
+            }));
+    });
+}
+
+void DeviceRunLengthEncode::Encode(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<uint64_t> d_unique_out, BufferView<int32_t> d_counts_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(run_length_encode_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceRunLengthEncode::UCommand DeviceRunLengthEncode::Encode(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<uint64_t> d_unique_out, BufferView<int32_t> d_counts_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_runs_out = raw(d_num_runs_out);
+        auto in = raw(d_in);
+        auto unique_out = raw(d_unique_out);
+        auto counts_out = raw(d_counts_out);
+        *num_runs_out = static_cast<int32_t>(for_each_run(
+            temp, in, num_items, [](size_t) noexcept { return true; },
+            [=](size_t run, size_t begin, size_t end) noexcept {
+                unique_out[run] = in[begin];
+                counts_out[run] = static_cast<int32_t>(end - begin);
+            }));
+    });
+}
+
+void DeviceRunLengthEncode::NonTrivialRuns(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<int32_t> d_offsets_out, BufferView<int32_t> d_lengths_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(run_length_encode_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceRunLengthEncode::UCommand DeviceRunLengthEncode::NonTrivialRuns(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<int32_t> d_offsets_out, BufferView<int32_t> d_lengths_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_runs_out = raw(d_num_runs_out);
+        auto in = raw(d_in);
+        auto n = static_cast<size_t>(num_items);
+        auto offsets_out = raw(d_offsets_out);
+        auto lengths_out = raw(d_lengths_out);
+        *num_runs_out = static_cast<int32_t>(for_each_run(
+            temp, in, n, [in, n](size_t head) noexcept { return head + 1u < n && in[head + 1u] == in[head]; },
+            [=](size_t run, size_t begin, size_t end) noexcept {
+                offsets_out[run] = static_cast<int32_t>(begin);
+                lengths_out[run] = static_cast<int32_t>(end - begin);
+            }));
+    });
+}
+
+void DeviceRunLengthEncode::NonTrivialRuns(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<int32_t> d_offsets_out, BufferView<int32_t> d_lengths_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(run_length_encode_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceRunLengthEncode::UCommand DeviceRunLengthEncode::NonTrivialRuns(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<int32_t> d_offsets_out, BufferView<int32_t> d_lengths_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_runs_out = raw(d_num_runs_out);
+        auto in = raw(d_in);
+        auto n = static_cast<size_t>(num_items);
+        auto offsets_out = raw(d_offsets_out);
+        auto lengths_out = raw(d_lengths_out);
+        *num_runs_out = static_cast<int32_t>(for_each_run(
+            temp, in, n, [in, n](size_t head) noexcept { return head + 1u < n && in[head + 1u] == in[head]; },
+            [=](size_t run, size_t begin, size_t end) noexcept {
+                offsets_out[run] = static_cast<int32_t>(begin);
+                lengths_out[run] = static_cast<int32_t>(end - begin);
+            }));
+    });
+}
+
+void DeviceRunLengthEncode::NonTrivialRuns(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<int32_t> d_offsets_out, BufferView<int32_t> d_lengths_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(run_length_encode_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceRunLengthEncode::UCommand DeviceRunLengthEncode::NonTrivialRuns(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<int32_t> d_offsets_out, BufferView<int32_t> d_lengths_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_runs_out = raw(d_num_runs_out);
+        auto in = raw(d_in);
+        auto n = static_cast<size_t>(num_items);
+        auto offsets_out = raw(d_offsets_out);
+        auto lengths_out = raw(d_lengths_out);
+        *num_runs_out = static_cast<int32_t>(for_each_run(
+            temp, in, n, [in, n](size_t head) noexcept { return head + 1u < n && in[head + 1u] == in[head]; },
+            [=](size_t run, size_t begin, size_t end) noexcept {
+                offsets_out[run] = static_cast<int32_t>(begin);
+                lengths_out[run] = static_cast<int32_t>(end - begin);
+            }));
+    });
+}
+
+void DeviceRunLengthEncode::NonTrivialRuns(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<int32_t> d_offsets_out, BufferView<int32_t> d_lengths_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(run_length_encode_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceRunLengthEncode::UCommand DeviceRunLengthEncode::NonTrivialRuns(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<int32_t> d_offsets_out, BufferView<int32_t> d_lengths_out, BufferView<int32_t> d_num_runs_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_runs_out = raw(d_num_runs_out);
+        auto in = raw(d_in);
+        auto n = static_cast<size_t>(num_items);
+        auto offsets_out = raw(d_offsets_out);
+        auto lengths_out = raw(d_lengths_out);
+        *num_runs_out = static_cast<int32_t>(for_each_run(
+            temp, in, n, [in, n](size_t head) noexcept { return head + 1u < n && in[head + 1u] == in[head]; },
+            [=](size_t run, size_t begin, size_t end) noexcept {
+                offsets_out[run] = static_cast<int32_t>(begin);
+                lengths_out[run] = static_cast<int32_t>(end - begin);
+            }));
+    });
+}
+
+}// namespace luisa::compute::cpu::lcub
@@ -0,0 +1,319 @@
+#include <luisa/backends/ext/cpu/lcub/device_scan.h>
+#include "lcub_utils.h"
+
+namespace luisa::compute::cpu::lcub {
+// DOC:  https://nvlabs.github.io/cub/structcub_1_1_device_scan.html
+
+void DeviceScan::ExclusiveSum(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSum(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<false>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSum(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSum(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<false>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSum(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSum(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<false>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSum(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSum(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<false>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSum(size_t &temp_storage_size, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<float>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSum(BufferView<int> d_temp_storage, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<false>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSum(size_t &temp_storage_size, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<double>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSum(BufferView<int> d_temp_storage, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<false>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSum(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSum(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<int32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<true>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSum(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSum(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<uint32_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<true>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSum(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSum(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<int64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<true>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSum(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSum(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<uint64_t> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<true>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSum(size_t &temp_storage_size, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<float>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSum(BufferView<int> d_temp_storage, BufferView<float> d_in, BufferView<float> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<true>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSum(size_t &temp_storage_size, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_temp_storage_bytes<double>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSum(BufferView<int> d_temp_storage, BufferView<double> d_in, BufferView<double> d_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan<true>(temp, raw(d_in), raw(d_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_values_in, BufferView<int32_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_values_in, BufferView<int32_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<false>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<uint32_t> d_values_in, BufferView<uint32_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<uint32_t> d_values_in, BufferView<uint32_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<false>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int64_t> d_values_in, BufferView<int64_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int64_t> d_values_in, BufferView<int64_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<false>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<uint64_t> d_values_in, BufferView<uint64_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<uint64_t> d_values_in, BufferView<uint64_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<false>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<float> d_values_in, BufferView<float> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<float>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<float> d_values_in, BufferView<float> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<false>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::ExclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<double> d_values_in, BufferView<double> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<double>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::ExclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<double> d_values_in, BufferView<double> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<false>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_values_in, BufferView<int32_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int32_t> d_values_in, BufferView<int32_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<true>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<uint32_t> d_values_in, BufferView<uint32_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<uint32_t> d_values_in, BufferView<uint32_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<true>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<int64_t> d_values_in, BufferView<int64_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<int64_t> d_values_in, BufferView<int64_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<true>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<uint64_t> d_values_in, BufferView<uint64_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<uint64_t> d_values_in, BufferView<uint64_t> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<true>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<float> d_values_in, BufferView<float> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<float>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<float> d_values_in, BufferView<float> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<true>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+void DeviceScan::InclusiveSumByKey(size_t &temp_storage_size, BufferView<int32_t> d_keys_in, BufferView<double> d_values_in, BufferView<double> d_values_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(scan_by_key_temp_storage_bytes<double>(num_items));
+}
+
+DeviceScan::UCommand DeviceScan::InclusiveSumByKey(BufferView<int> d_temp_storage, BufferView<int32_t> d_keys_in, BufferView<double> d_values_in, BufferView<double> d_values_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        scan_by_key<true>(temp, raw(d_keys_in), raw(d_values_in), raw(d_values_out), num_items);
+    });
+}
+
+}// namespace luisa::compute::cpu::lcub
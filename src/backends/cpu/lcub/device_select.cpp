@@ -0,0 +1,112 @@
+#include <luisa/backends/ext/cpu/lcub/device_select.h>
+#include "lcub_utils.h"
+
+namespace luisa::compute::cpu::lcub {
+// DOC:  https://nvlabs.github.io/cub/structcub_1_1_device_select.html
+
+void DeviceSelect::Flagged(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<int32_t> d_flags, BufferView<int32_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(select_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceSelect::UCommand DeviceSelect::Flagged(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<int32_t> d_flags, BufferView<int32_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_selected_out = raw(d_num_selected_out);
+        auto flags = raw(d_flags);
+        *num_selected_out = static_cast<int32_t>(select_if(temp, raw(d_in), raw(d_out), num_items, [flags](size_t i) noexcept { return flags[i] != 0; }));
+    });
+}
+
+void DeviceSelect::Flagged(size_t &temp_storage_size, BufferView<uint32_t> d_in, BufferView<int32_t> d_flags, BufferView<uint32_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(select_temp_storage_bytes<uint32_t>(num_items));
+}
+
+DeviceSelect::UCommand DeviceSelect::Flagged(BufferView<int> d_temp_storage, BufferView<uint32_t> d_in, BufferView<int32_t> d_flags, BufferView<uint32_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_selected_out = raw(d_num_selected_out);
+        auto flags = raw(d_flags);
+        *num_selected_out = static_cast<int32_t>(select_if(temp, raw(d_in), raw(d_out), num_items, [flags](size_t i) noexcept { return flags[i] != 0; }));
+    });
+}
+
+void DeviceSelect::Flagged(size_t &temp_storage_size, BufferView<int64_t> d_in, BufferView<int32_t> d_flags, BufferView<int64_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(select_temp_storage_bytes<int64_t>(num_items));
+}
+
+DeviceSelect::UCommand DeviceSelect::Flagged(BufferView<int> d_temp_storage, BufferView<int64_t> d_in, BufferView<int32_t> d_flags, BufferView<int64_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_selected_out = raw(d_num_selected_out);
+        auto flags = raw(d_flags);
+        *num_selected_out = static_cast<int32_t>(select_if(temp, raw(d_in), raw(d_out), num_items, [flags](size_t i) noexcept { return flags[i] != 0; }));
+    });
+}
+
+void DeviceSelect::Flagged(size_t &temp_storage_size, BufferView<uint64_t> d_in, BufferView<int32_t> d_flags, BufferView<uint64_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(select_temp_storage_bytes<uint64_t>(num_items));
+}
+
+DeviceSelect::UCommand DeviceSelect::Flagged(BufferView<int> d_temp_storage, BufferView<uint64_t> d_in, BufferView<int32_t> d_flags, BufferView<uint64_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_selected_out = raw(d_num_selected_out);
+        auto flags = raw(d_flags);
+        *num_selected_out = static_cast<int32_t>(select_if(temp, raw(d_in), raw(d_out), num_items, [flags](size_t i) noexcept { return flags[i] != 0; }));
+    });
+}
+
+void DeviceSelect::Flagged(size_t &temp_storage_size, BufferView<float> d_in, BufferView<int32_t> d_flags, BufferView<float> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(select_temp_storage_bytes<float>(num_items));
+}
+
+DeviceSelect::UCommand DeviceSelect::Flagged(BufferView<int> d_temp_storage, BufferView<float> d_in, BufferView<int32_t> d_flags, BufferView<float> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_selected_out = raw(d_num_selected_out);
+        auto flags = raw(d_flags);
+        *num_selected_out = static_cast<int32_t>(select_if(temp, raw(d_in), raw(d_out), num_items, [flags](size_t i) noexcept { return flags[i] != 0; }));
+    });
+}
+
+void DeviceSelect::Flagged(size_t &temp_storage_size, BufferView<double> d_in, BufferView<int32_t> d_flags, BufferView<double> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(select_temp_storage_bytes<double>(num_items));
+}
+
+DeviceSelect::UCommand DeviceSelect::Flagged(BufferView<int> d_temp_storage, BufferView<double> d_in, BufferView<int32_t> d_flags, BufferView<double> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_selected_out = raw(d_num_selected_out);
+        auto flags = raw(d_flags);
+        *num_selected_out = static_cast<int32_t>(select_if(temp, raw(d_in), raw(d_out), num_items, [flags](size_t i) noexcept { return flags[i] != 0; }));
+    });
+}
+
+void DeviceSelect::Unique(size_t &temp_storage_size, BufferView<int32_t> d_in, BufferView<int32_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    temp_storage_size = cpu_to_lc_buffer_size(select_temp_storage_bytes<int32_t>(num_items));
+}
+
+DeviceSelect::UCommand DeviceSelect::Unique(BufferView<int> d_temp_storage, BufferView<int32_t> d_in, BufferView<int32_t> d_out, BufferView<int32_t> d_num_selected_out, int num_items) noexcept {
+    using namespace details;
+    return make_command([=] {
+        TempStorage temp{d_temp_storage};
+        auto num_selected_out = raw(d_num_selected_out);
+        auto in = raw(d_in);
+        *num_selected_out = static_cast<int32_t>(select_if(temp, in, raw(d_out), num_items, [in](size_t i) noexcept { return i == 0u || in[i] != in[i - 1u]; }));
+    });
+}
+
+}// namespace luisa::compute::cpu::lcub
@@ -0,0 +1,10 @@
+#include "lcub_utils.h"
+
+namespace luisa::compute::cpu::lcub::details {
+
+ThreadPool &thread_pool() noexcept {
+    static ThreadPool pool;
+    return pool;
+}
+
+}// namespace luisa::compute::cpu::lcub::details
@@ -0,0 +1,466 @@
+#pragma once
+
+#include <latch>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#include <luisa/core/logging.h>
+#include <luisa/core/thread_pool.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/backends/ext/cpu/lcub/lcub_common.h>
+#include <luisa/backends/ext/cpu/lcub/cpu_lcub_command.h>
+
+namespace luisa::compute::cpu::lcub {
+
+namespace details {
+
+template<typename T>
+inline T *raw(luisa::compute::BufferView<T> buffer_view) noexcept {
+    if (!buffer_view) return nullptr;
+    return reinterpret_cast<T *>(buffer_view.native_handle()) + buffer_view.offset();
+}
+
+inline size_t cpu_to_lc_buffer_size(size_t size_bytes) noexcept {
+    constexpr auto unit = sizeof(int);
+    // CUB reports at least one byte, so the buffer can always be created
+    return std::max((size_bytes + unit - 1) / unit, static_cast<size_t>(1u));
+}
+
+template<typename F>
+[[nodiscard]] inline auto make_command(F &&f) noexcept {
+    return luisa::make_unique<luisa::compute::cpu::CPULCubCommand>(std::forward<F>(f));
+}
+
+// the worker threads shared by all the algorithms
+[[nodiscard]] ThreadPool &thread_pool() noexcept;
+
+// items of a tile are processed by a single task, so tiles
+// are large enough to amortize the scheduling overhead
+static constexpr auto min_tile_size = static_cast<size_t>(16u * 1024u);
+static constexpr auto temp_storage_alignment = static_cast<size_t>(64u);
+
+// deterministic for a given number of items, so that the temporary
+// storage queried before the dispatch matches the one used by it
+[[nodiscard]] inline uint tile_count(size_t n) noexcept {
+    auto max_tiles = static_cast<size_t>(thread_pool().size()) * 4u;
+    auto tiles = (n + min_tile_size - 1u) / min_tile_size;
+    return static_cast<uint>(std::clamp(tiles, static_cast<size_t>(1u), max_tiles));
+}
+
+struct Tile {
+    size_t begin;
+    size_t end;
+};
+
+[[nodiscard]] inline Tile tile_range(size_t n, uint tiles, uint i) noexcept {
+    return Tile{n * i / tiles, n * (i + 1u) / tiles};
+}
+
+// runs f(i) for i in [0, n) on the pool and waits for them; the pool may be
+// shared by other streams, so only our own tasks are waited for
+template<typename F>
+inline void parallel(uint n, F &&f) noexcept {
+    if (n == 0u) { return; }
+    if (n == 1u) {
+        f(0u);
+        return;
+    }
+    std::latch latch{static_cast<std::ptrdiff_t>(n)};
+    thread_pool().parallel(n, [&f, &latch](uint i) noexcept {
+        f(i);
+        latch.count_down();
+    });
+    latch.wait();
+}
+
+template<typename T>
+[[nodiscard]] constexpr size_t temp_bytes(size_t count) noexcept {
+    return count * sizeof(T) + temp_storage_alignment;
+}
+
+// bump allocator over the temporary storage passed to the command
+class TempStorage {
+
+private:
+    std::byte *_data;
+    size_t _size;
+    size_t _offset{0u};
+
+public:
+    explicit TempStorage(luisa::compute::BufferView<int> view) noexcept
+        : _data{reinterpret_cast<std::byte *>(raw(view))},
+          _size{view.size_bytes()} {}
+
+    template<typename T>
+    [[nodiscard]] T *allocate(size_t count) noexcept {
+        auto address = reinterpret_cast<size_t>(_data) + _offset;
+        auto aligned = (address + temp_storage_alignment - 1u) & ~(temp_storage_alignment - 1u);
+        auto offset = aligned - reinterpret_cast<size_t>(_data);
+        LUISA_ASSERT(offset + count * sizeof(T) <= _size,
+                     "Insufficient temporary storage for lcub "
+                     "(required at least {} bytes, got {}).",
+                     offset + count * sizeof(T), _size);
+        _offset = offset + count * sizeof(T);
+        return reinterpret_cast<T *>(_data + offset);
+    }
+};
+
+/* reduce */
+
+// independent lanes let the compiler vectorize the loop
+template<typename T, typename Op>
+[[nodiscard]] inline T reduce_serial(const T *in, size_t n, T init, Op op) noexcept {
+    constexpr auto lanes = 8u;
+    T acc[lanes];
+    std::fill_n(acc, lanes, init);
+    auto i = static_cast<size_t>(0u);
+    for (; i + lanes <= n; i += lanes) {
+        for (auto l = 0u; l < lanes; l++) { acc[l] = op(acc[l], in[i + l]); }
+    }
+    for (; i < n; i++) { acc[0] = op(acc[0], in[i]); }
+    auto result = acc[0];
+    for (auto l = 1u; l < lanes; l++) { result = op(result, acc[l]); }
+    return result;
+}
+
+template<typename T>
+[[nodiscard]] inline size_t reduce_temp_storage_bytes(size_t n) noexcept {
+    return temp_bytes<T>(tile_count(n));
+}
+
+template<typename T, typename Op>
+[[nodiscard]] inline T reduce(TempStorage temp, const T *in, size_t n, T init, Op op) noexcept {
+    auto tiles = tile_count(n);
+    auto partials = temp.allocate<T>(tiles);
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        partials[i] = reduce_serial(in + begin, end - begin, init, op);
+    });
+    auto result = init;
+    for (auto i = 0u; i < tiles; i++) { result = op(result, partials[i]); }
+    return result;
+}
+
+// the first of the equal extrema wins, as in CUB
+template<typename T, typename Compare>
+[[nodiscard]] inline KeyValuePair<int32_t, T> arg_reduce(TempStorage temp, const T *in, size_t n,
+                                                         T init, Compare better) noexcept {
+    using Pair = KeyValuePair<int32_t, T>;
+    if (n == 0u) { return Pair{1, init}; }
+    auto tiles = tile_count(n);
+    auto partials = temp.allocate<Pair>(tiles);
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        auto best = begin;
+        for (auto j = begin + 1u; j < end; j++) {
+            if (better(in[j], in[best])) { best = j; }
+        }
+        partials[i] = Pair{static_cast<int32_t>(best), in[best]};
+    });
+    auto result = partials[0];
+    for (auto i = 1u; i < tiles; i++) {
+        if (better(partials[i].value, result.value)) { result = partials[i]; }
+    }
+    return result;
+}
+
+/* scan */
+
+template<bool inclusive, typename T>
+inline void scan_serial(const T *in, T *out, size_t n, T acc) noexcept {
+    for (auto i = static_cast<size_t>(0u); i < n; i++) {
+        auto v = in[i];
+        if constexpr (inclusive) {
+            acc += v;
+            out[i] = acc;
+        } else {
+            out[i] = acc;
+            acc += v;
+        }
+    }
+}
+
+template<typename T>
+[[nodiscard]] inline size_t scan_temp_storage_bytes(size_t n) noexcept {
+    return temp_bytes<T>(tile_count(n));
+}
+
+// reduce-then-scan: the tiles are summed in parallel, the sums are scanned
+// serially and then each tile is scanned from its offset in parallel
+template<bool inclusive, typename T>
+inline void scan(TempStorage temp, const T *in, T *out, size_t n) noexcept {
+    auto tiles = tile_count(n);
+    if (tiles == 1u) {
+        scan_serial<inclusive>(in, out, n, T{});
+        return;
+    }
+    auto sums = temp.allocate<T>(tiles);
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        sums[i] = reduce_serial(in + begin, end - begin, T{}, [](T a, T b) noexcept { return a + b; });
+    });
+    auto acc = T{};
+    for (auto i = 0u; i < tiles; i++) {
+        auto s = sums[i];
+        sums[i] = acc;
+        acc += s;
+    }
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        scan_serial<inclusive>(in + begin, out + begin, end - begin, sums[i]);
+    });
+}
+
+template<typename T>
+[[nodiscard]] inline size_t scan_by_key_temp_storage_bytes(size_t n) noexcept {
+    return temp_bytes<T>(tile_count(n)) + temp_bytes<bool>(tile_count(n));
+}
+
+// the scan restarts whenever the key changes
+template<bool inclusive, typename K, typename T>
+inline void scan_by_key(TempStorage temp, const K *keys, const T *in, T *out, size_t n) noexcept {
+    auto tiles = tile_count(n);
+    auto carries = temp.allocate<T>(tiles);
+    auto uniform = temp.allocate<bool>(tiles);
+    // the sum of the trailing run of each tile, and whether that run is the whole tile
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        auto run_begin = end;
+        if (begin < end) {
+            run_begin = end - 1u;
+            while (run_begin > begin && keys[run_begin - 1u] == keys[end - 1u]) { run_begin--; }
+        }
+        auto tail = T{};
+        for (auto j = run_begin; j < end; j++) { tail += in[j]; }
+        carries[i] = tail;
+        uniform[i] = run_begin == begin;
+    });
+    // carries[i] becomes the sum of the run that ends right before tile i
+    auto carry = T{};
+    for (auto i = 0u; i < tiles; i++) {
+        auto [begin, end] = tile_range(n, tiles, i);
+        auto tail = carries[i];
+        carries[i] = carry;
+        auto continued = i > 0u && begin < end && keys[begin] == keys[begin - 1u];
+        carry = uniform[i] && continued ? carry + tail : tail;
+    }
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        auto acc = i > 0u && begin < end && keys[begin] == keys[begin - 1u] ? carries[i] : T{};
+        for (auto j = begin; j < end; j++) {
+            if (j > begin && keys[j] != keys[j - 1u]) { acc = T{}; }
+            auto v = in[j];
+            if constexpr (inclusive) {
+                acc += v;
+                out[j] = acc;
+            } else {
+                out[j] = acc;
+                acc += v;
+            }
+        }
+    });
+}
+
+/* select */
+
+template<typename T>
+[[nodiscard]] inline size_t select_temp_storage_bytes(size_t n) noexcept {
+    return temp_bytes<size_t>(tile_count(n));
+}
+
+// stable compaction of the items for which pred(i) holds; returns the number of selected items
+template<typename T, typename Pred>
+inline size_t select_if(TempStorage temp, const T *in, T *out, size_t n, Pred pred) noexcept {
+    auto tiles = tile_count(n);
+    auto offsets = temp.allocate<size_t>(tiles);
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        auto count = static_cast<size_t>(0u);
+        for (auto j = begin; j < end; j++) { count += pred(j) ? 1u : 0u; }
+        offsets[i] = count;
+    });
+    auto total = static_cast<size_t>(0u);
+    for (auto i = 0u; i < tiles; i++) {
+        auto count = offsets[i];
+        offsets[i] = total;
+        total += count;
+    }
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        auto offset = offsets[i];
+        for (auto j = begin; j < end; j++) {
+            if (pred(j)) { out[offset++] = in[j]; }
+        }
+    });
+    return total;
+}
+
+/* run-length encode */
+
+template<typename T>
+[[nodiscard]] inline size_t run_length_encode_temp_storage_bytes(size_t n) noexcept {
+    return 2u * temp_bytes<size_t>(tile_count(n));
+}
+
+// Visits the runs in order with visit(run_index, run_begin, run_end) for the runs
+// whose head satisfies pred(head). The end of the last run of a tile is the first
+// head in the following tiles, which is found from the heads counted per tile.
+template<typename T, typename Pred, typename Visit>
+inline size_t for_each_run(TempStorage temp, const T *in, size_t n, Pred pred, Visit visit) noexcept {
+    auto tiles = tile_count(n);
+    auto offsets = temp.allocate<size_t>(tiles);
+    auto next_heads = temp.allocate<size_t>(tiles);
+    auto is_head = [in](size_t i) noexcept { return i == 0u || in[i] != in[i - 1u]; };
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        auto count = static_cast<size_t>(0u);
+        auto first_head = n;
+        for (auto j = begin; j < end; j++) {
+            if (is_head(j)) {
+                first_head = std::min(first_head, j);
+                if (pred(j)) { count++; }
+            }
+        }
+        offsets[i] = count;
+        next_heads[i] = first_head;
+    });
+    auto total = static_cast<size_t>(0u);
+    for (auto i = 0u; i < tiles; i++) {
+        auto count = offsets[i];
+        offsets[i] = total;
+        total += count;
+    }
+    // next_heads[i] becomes the first head after tile i
+    auto next = n;
+    for (auto i = tiles; i > 0u; i--) {
+        auto first = next_heads[i - 1u];
+        next_heads[i - 1u] = next;
+        next = std::min(next, first);
+    }
+    parallel(tiles, [&](uint i) noexcept {
+        auto [begin, end] = tile_range(n, tiles, i);
+        auto run = offsets[i];
+        auto head = n;
+        for (auto j = begin; j < end; j++) {
+            if (is_head(j)) {
+                if (head != n && pred(head)) { visit(run++, head, j); }
+                head = j;
+            }
+        }
+        if (head != n && pred(head)) { visit(run, head, next_heads[i]); }
+    });
+    return total;
+}
+
+/* radix sort */
+
+template<typename K>
+struct RadixTraits {
+    using Bits = std::conditional_t<sizeof(K) == 8u, uint64_t, uint32_t>;
+    static constexpr auto sign_bit = static_cast<Bits>(1u) << (sizeof(K) * 8u - 1u);
+    // maps the keys to unsigned integers with the same order
+    [[nodiscard]] static Bits twiddle(K key) noexcept {
+        Bits bits;
+        std::memcpy(&bits, &key, sizeof(K));
+        if constexpr (std::is_floating_point_v<K>) {
+            return (bits & sign_bit) ? ~bits : bits ^ sign_bit;
+        } else if constexpr (std::is_signed_v<K>) {
+            return bits ^ sign_bit;
+        } else {
+            return bits;
+        }
+    }
+};
+
+static constexpr auto radix_bits = 8u;
+static constexpr auto radix_digits = 1u << radix_bits;
+
+template<typename K, typename V>
+[[nodiscard]] inline size_t radix_sort_temp_storage_bytes(size_t n) noexcept {
+    auto bytes = temp_bytes<K>(n) + temp_bytes<uint32_t>(tile_count(n) * radix_digits);
+    if constexpr (!std::is_void_v<V>) { bytes += temp_bytes<V>(n); }
+    return bytes;
+}
+
+// LSD radix sort with 8-bit digits: each pass counts the digits per tile in
+// parallel, computes the stable offsets of each (digit, tile) pair and then
+// scatters the tiles in parallel. Passes in which all the keys share the
+// digit are skipped. Keys and values ping-pong between the output and the
+// temporary storage; the input is never modified. V = void sorts keys only.
+template<bool descending, typename K, typename V>
+inline void radix_sort(TempStorage temp, const K *keys_in, K *keys_out,
+                       const V *values_in, V *values_out, size_t n,
+                       int begin_bit, int end_bit) noexcept {
+    using Traits = RadixTraits<K>;
+    constexpr auto has_values = !std::is_void_v<V>;
+    LUISA_ASSERT(0 <= begin_bit && begin_bit <= end_bit &&
+                     end_bit <= static_cast<int>(sizeof(K) * 8u),
+                 "Invalid bit range [{}, {}) for radix sort.", begin_bit, end_bit);
+    auto tiles = tile_count(n);
+    auto temp_keys = temp.allocate<K>(n);
+    auto histograms = temp.allocate<uint32_t>(tiles * radix_digits);
+    using ValuePointer = std::conditional_t<has_values, V *, std::nullptr_t>;
+    ValuePointer temp_values{};
+    if constexpr (has_values) { temp_values = temp.allocate<V>(n); }
+
+    auto src_keys = keys_in;
+    auto src_values = values_in;
+    auto passes = (end_bit - begin_bit + static_cast<int>(radix_bits) - 1) / static_cast<int>(radix_bits);
+    // with all passes executed, the last one writes to the output
+    auto write_output = passes % 2 == 1;
+    for (auto bit = begin_bit; bit < end_bit; bit += static_cast<int>(radix_bits)) {
+        auto digit_bits = std::min(static_cast<int>(radix_bits), end_bit - bit);
+        auto mask = (static_cast<typename Traits::Bits>(1u) << digit_bits) - 1u;
+        auto digit = [bit, mask](K key) noexcept {
+            auto bits = Traits::twiddle(key);
+            if constexpr (descending) { bits = ~bits; }
+            return static_cast<uint>((bits >> bit) & mask);
+        };
+        parallel(tiles, [&](uint i) noexcept {
+            auto [begin, end] = tile_range(n, tiles, i);
+            auto histogram = histograms + i * radix_digits;
+            std::fill_n(histogram, radix_digits, 0u);
+            for (auto j = begin; j < end; j++) { histogram[digit(src_keys[j])]++; }
+        });
+        auto offset = static_cast<uint32_t>(0u);
+        auto trivial = false;
+        for (auto d = 0u; d < radix_digits; d++) {
+            auto digit_begin = offset;
+            for (auto t = 0u; t < tiles; t++) {
+                auto count = histograms[t * radix_digits + d];
+                histograms[t * radix_digits + d] = offset;
+                offset += count;
+            }
+            if (offset - digit_begin == n) { trivial = true; }
+        }
+        if (trivial) { continue; }
+        auto dst_keys = write_output ? keys_out : temp_keys;
+        auto dst_values = write_output ? values_out : temp_values;
+        parallel(tiles, [&](uint i) noexcept {
+            auto [begin, end] = tile_range(n, tiles, i);
+            auto offsets = histograms + i * radix_digits;
+            for (auto j = begin; j < end; j++) {
+                auto index = offsets[digit(src_keys[j])]++;
+                dst_keys[index] = src_keys[j];
+                if constexpr (has_values) { dst_values[index] = src_values[j]; }
+            }
+        });
+        src_keys = dst_keys;
+        src_values = dst_values;
+        write_output = !write_output;
+    }
+    // skipped passes or an empty bit range may leave the result elsewhere
+    if (src_keys != keys_out) {
+        parallel(tiles, [&](uint i) noexcept {
+            auto [begin, end] = tile_range(n, tiles, i);
+            std::copy(src_keys + begin, src_keys + end, keys_out + begin);
+            if constexpr (has_values) { std::copy(src_values + begin, src_values + end, values_out + begin); }
+        });
+    }
+}
+
+}// namespace details
+
+}// namespace luisa::compute::cpu::lcub
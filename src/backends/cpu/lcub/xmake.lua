@@ -0,0 +1,7 @@
+target("lc-backend-cpu-ext-lcub")
+    set_languages("cxx20")
+    set_kind("shared")
+	add_deps("lc-runtime")
+	add_defines("LC_BACKEND_EXPORT_DLL")
+    add_files("*.cpp")
+target_end()
@@ -8,6 +8,10 @@ on_load(function(target)
 	end
 	target:add("defines", "LC_IR_EXPORT_DLL")
 	target:add("deps", "lc-runtime", "lc-ir", "lc-ast", "lc-rust")
+	-- the raster extension builds its wrapper kernels with the DSL
+	if get_config("enable_dsl") then
+		target:add("deps", "lc-dsl")
+	end
 	target:set("features", "cpu")
 	if is_plat("windows") then
 		target:add("syslinks", "Ws2_32", "Advapi32", "Bcrypt", "Userenv")
@@ -86,5 +90,7 @@ after_build(function(target)
 		copy_dll("release")
 	end
 end)
-add_files("**.cpp", "../common/rust_device_common.cpp")
+add_files("*.cpp", "../common/rust_device_common.cpp", "../common/default_binary_io.cpp")
 target_end()
+
+includes("lcub")
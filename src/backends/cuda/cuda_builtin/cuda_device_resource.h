@@ -1356,6 +1356,36 @@ __device__ inline float atomicMax(float *a, float v) noexcept {
 #define lc_atomic_fetch_or(atomic_ref, value) atomicOr(&(atomic_ref), value)
 #define lc_atomic_fetch_xor(atomic_ref, value) atomicXor(&(atomic_ref), value)
 
+// memory orders of the explicit atomic operations, see luisa::compute::MemoryOrder;
+// the atomic functions above are relaxed, so the stronger orders are enforced with fences
+#define LC_MEMORY_ORDER_RELAXED 0u
+#define LC_MEMORY_ORDER_ACQUIRE 1u
+#define LC_MEMORY_ORDER_RELEASE 2u
+#define LC_MEMORY_ORDER_ACQ_REL 3u
+#define LC_MEMORY_ORDER_SEQ_CST 4u
+
+template<typename F>
+__device__ inline auto lc_atomic_explicit(lc_uint order, F &&f) noexcept {
+    if (order == LC_MEMORY_ORDER_RELEASE ||
+        order == LC_MEMORY_ORDER_ACQ_REL ||
+        order == LC_MEMORY_ORDER_SEQ_CST) { __threadfence(); }
+    auto old = f();
+    if (order == LC_MEMORY_ORDER_ACQUIRE ||
+        order == LC_MEMORY_ORDER_ACQ_REL ||
+        order == LC_MEMORY_ORDER_SEQ_CST) { __threadfence(); }
+    return old;
+}
+
+#define lc_atomic_exchange_explicit(atomic_ref, value, order) lc_atomic_explicit(order, [&] { return lc_atomic_exchange(atomic_ref, value); })
+#define lc_atomic_compare_exchange_explicit(atomic_ref, cmp, value, order) lc_atomic_explicit(order, [&] { return lc_atomic_compare_exchange(atomic_ref, cmp, value); })
+#define lc_atomic_fetch_add_explicit(atomic_ref, value, order) lc_atomic_explicit(order, [&] { return lc_atomic_fetch_add(atomic_ref, value); })
+#define lc_atomic_fetch_sub_explicit(atomic_ref, value, order) lc_atomic_explicit(order, [&] { return lc_atomic_fetch_sub(atomic_ref, value); })
+#define lc_atomic_fetch_min_explicit(atomic_ref, value, order) lc_atomic_explicit(order, [&] { return lc_atomic_fetch_min(atomic_ref, value); })
+#define lc_atomic_fetch_max_explicit(atomic_ref, value, order) lc_atomic_explicit(order, [&] { return lc_atomic_fetch_max(atomic_ref, value); })
+#define lc_atomic_fetch_and_explicit(atomic_ref, value, order) lc_atomic_explicit(order, [&] { return lc_atomic_fetch_and(atomic_ref, value); })
+#define lc_atomic_fetch_or_explicit(atomic_ref, value, order) lc_atomic_explicit(order, [&] { return lc_atomic_fetch_or(atomic_ref, value); })
+#define lc_atomic_fetch_xor_explicit(atomic_ref, value, order) lc_atomic_explicit(order, [&] { return lc_atomic_fetch_xor(atomic_ref, value); })
+
 // static block size
 [[nodiscard]] __device__ constexpr lc_uint3 lc_block_size() noexcept {
     return LC_BLOCK_SIZE;
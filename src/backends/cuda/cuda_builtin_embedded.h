@@ -2,4 +2,4 @@
 
 extern "C" const char luisa_cuda_builtin_cuda_builtin_kernels[5293];
 extern "C" const char luisa_cuda_builtin_cuda_device_math[415880];
-extern "C" const char luisa_cuda_builtin_cuda_device_resource[107464];
+extern "C" const char luisa_cuda_builtin_cuda_device_resource[109571];
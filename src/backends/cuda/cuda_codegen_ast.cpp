@@ -8,6 +8,7 @@
 #include <luisa/runtime/dispatch_buffer.h>
 #include <luisa/dsl/rtx/ray_query.h>
 
+#include "../common/codegen_cache.h"
 #include "cuda_texture.h"
 #include "cuda_codegen_ast.h"
 
@@ -15,6 +16,10 @@ namespace luisa::compute::cuda {
 
 namespace detail {
 
+// generated code shared across kernels, see CodegenCache
+static CodegenCache type_decl_cache;
+static CodegenCache callable_cache;
+
 [[nodiscard]] static auto glob_variables_with_grad(Function f) noexcept {
     luisa::unordered_set<Variable> gradient_variables;
     traverse_expressions<true>(
@@ -430,11 +435,11 @@ private:
                     auto binding = f.bound_arguments()[i];
                     if (auto b = luisa::get_if<Function::TextureBinding>(&binding);
                         b != nullptr && f.arguments()[i] == v) {
-                        auto surf = reinterpret_cast<CUDATexture *>(b->handle)->binding(b->level);
+                        auto storage = reinterpret_cast<CUDATexture *>(b->handle)->storage();
                         _codegen->_emit_indent();
                         _codegen->_scratch << "lc_assume(";
                         _codegen->_emit_variable_name(v);
-                        _codegen->_scratch << ".surface.storage == " << surf.storage << ");\n";
+                        _codegen->_scratch << ".surface.storage == " << luisa::to_underlying(storage) << ");\n";
                     }
                 }
             }
@@ -869,6 +874,15 @@ void CUDACodegenAST::visit(const CallExpr *expr) {
         case CallOp::ATOMIC_FETCH_XOR: _scratch << "lc_atomic_fetch_xor"; break;
         case CallOp::ATOMIC_FETCH_MIN: _scratch << "lc_atomic_fetch_min"; break;
         case CallOp::ATOMIC_FETCH_MAX: _scratch << "lc_atomic_fetch_max"; break;
+        case CallOp::ATOMIC_EXCHANGE_EXPLICIT: _scratch << "lc_atomic_exchange_explicit"; break;
+        case CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT: _scratch << "lc_atomic_compare_exchange_explicit"; break;
+        case CallOp::ATOMIC_FETCH_ADD_EXPLICIT: _scratch << "lc_atomic_fetch_add_explicit"; break;
+        case CallOp::ATOMIC_FETCH_SUB_EXPLICIT: _scratch << "lc_atomic_fetch_sub_explicit"; break;
+        case CallOp::ATOMIC_FETCH_AND_EXPLICIT: _scratch << "lc_atomic_fetch_and_explicit"; break;
+        case CallOp::ATOMIC_FETCH_OR_EXPLICIT: _scratch << "lc_atomic_fetch_or_explicit"; break;
+        case CallOp::ATOMIC_FETCH_XOR_EXPLICIT: _scratch << "lc_atomic_fetch_xor_explicit"; break;
+        case CallOp::ATOMIC_FETCH_MIN_EXPLICIT: _scratch << "lc_atomic_fetch_min_explicit"; break;
+        case CallOp::ATOMIC_FETCH_MAX_EXPLICIT: _scratch << "lc_atomic_fetch_max_explicit"; break;
         case CallOp::BUFFER_READ: _scratch << "lc_buffer_read"; break;
         case CallOp::BUFFER_WRITE: _scratch << "lc_buffer_write"; break;
         case CallOp::BUFFER_SIZE: _scratch << "lc_buffer_size"; break;
@@ -1013,10 +1027,7 @@ void CUDACodegenAST::visit(const CallExpr *expr) {
         // lower access chain to atomic operation
         auto args = expr->arguments();
         auto access_chain = args.subspan(
-            0u,
-            op == CallOp::ATOMIC_COMPARE_EXCHANGE ?
-                args.size() - 2u :
-                args.size() - 1u);
+            0u, args.size() - atomic_operation_value_count(op));
         _emit_access_chain(access_chain);
         for (auto extra : args.subspan(access_chain.size())) {
             _scratch << ", ";
@@ -1209,6 +1220,9 @@ void CUDACodegenAST::visit(const AutoDiffStmt *stmt) {
 void CUDACodegenAST::emit(Function f,
                           luisa::string_view device_lib,
                           luisa::string_view native_include) {
+    // the device library and native include dominate short kernels, so
+    // reserve for them and some headroom for the kernel upfront
+    _scratch.reserve(_scratch.size() + device_lib.size() + native_include.size() + 64_k);
     if (f.requires_raytracing()) {
         _scratch << "#define LUISA_ENABLE_OPTIX\n";
         if (f.propagated_builtin_callables().test(CallOp::RAY_TRACING_TRACE_CLOSEST)) {
@@ -1244,10 +1258,7 @@ void CUDACodegenAST::emit(Function f,
 
 void CUDACodegenAST::_emit_function(Function f) noexcept {
 
-    if (auto iter = std::find_if(_generated_functions.cbegin(),
-                                 _generated_functions.cend(), [&](auto &&other) noexcept { return other.hash() == f.hash(); });
-        iter != _generated_functions.cend()) { return; }
-    _generated_functions.emplace_back(f);
+    if (!_generated_functions.emplace(f.hash()).second) { return; }
 
     // ray tracing kernels use __constant__ args
     // note: this must go before any other
@@ -1294,6 +1305,12 @@ void CUDACodegenAST::_emit_function(Function f) noexcept {
     // outline ray query functions
     if (has_ray_query) { _ray_query_lowering->outline(f); }
 
+    // callables without ray queries only depend on themselves,
+    // so their code is shared by all kernels calling them
+    auto cacheable = f.tag() == Function::Tag::CALLABLE && !has_ray_query;
+    if (cacheable && detail::callable_cache.replay(f.hash(), _scratch)) { return; }
+    auto offset = _scratch.size();
+
     // signature
     if (f.tag() == Function::Tag::KERNEL) {
         _scratch << "extern \"C\" __global__ void "
@@ -1333,11 +1350,11 @@ void CUDACodegenAST::_emit_function(Function f) noexcept {
         for (auto i = 0u; i < f.bound_arguments().size(); i++) {
             auto binding = f.bound_arguments()[i];
             if (auto b = luisa::get_if<Function::TextureBinding>(&binding)) {
-                auto surface = reinterpret_cast<CUDATexture *>(b->handle)->binding(b->level);
                 // inform the compiler of the underlying storage
+                auto storage = reinterpret_cast<CUDATexture *>(b->handle)->storage();
                 _scratch << "\n  lc_assume(";
                 _emit_variable_name(f.arguments()[i]);
-                _scratch << ".surface.storage == " << surface.storage << ");";
+                _scratch << ".surface.storage == " << luisa::to_underlying(storage) << ");";
             }
         }
     } else {
@@ -1363,6 +1380,7 @@ void CUDACodegenAST::_emit_function(Function f) noexcept {
     _indent = 0;
     _emit_statements(f.body()->statements());
     _scratch << "}\n\n";
+    if (cacheable) { detail::callable_cache.record(f.hash(), _scratch, offset); }
 
     if (_allow_indirect_dispatch) {
         // generate meta-function that launches the kernel with dynamic parallelism
@@ -1507,8 +1525,10 @@ void CUDACodegenAST::_emit_type_decl(Function kernel) noexcept {
 }
 
 void CUDACodegenAST::visit(const Type *type) noexcept {
-    if (type->is_structure() &&
-        type != _ray_type &&
+    if (!type->is_structure()) { return; }
+    if (detail::type_decl_cache.replay(type->hash(), _scratch)) { return; }
+    auto offset = _scratch.size();
+    if (type != _ray_type &&
         type != _triangle_hit_type &&
         type != _procedural_hit_type &&
         type != _committed_hit_type &&
@@ -1524,36 +1544,35 @@ void CUDACodegenAST::visit(const Type *type) noexcept {
         }
         _scratch << "};\n\n";
     }
-    if (type->is_structure()) {
-        // lc_zero and lc_one
-        auto lc_make_value = [&](luisa::string_view name) noexcept {
-            _scratch << "template<> __device__ inline auto " << name << "<";
-            _emit_type_name(type);
-            _scratch << ">() noexcept {\n"
-                     << "  return ";
-            _emit_type_name(type);
-            _scratch << "{\n";
-            for (auto i = 0u; i < type->members().size(); i++) {
-                _scratch << "    " << name << "<";
-                _emit_type_name(type->members()[i]);
-                _scratch << ">(),\n";
-            }
-            _scratch << "  };\n"
-                     << "}\n\n";
-        };
-        lc_make_value("lc_zero");
-        lc_make_value("lc_one");
-        // lc_accumulate_grad
-        _scratch << "__device__ inline void lc_accumulate_grad(";
+    // lc_zero and lc_one
+    auto lc_make_value = [&](luisa::string_view name) noexcept {
+        _scratch << "template<> __device__ inline auto " << name << "<";
         _emit_type_name(type);
-        _scratch << " *dst, ";
+        _scratch << ">() noexcept {\n"
+                 << "  return ";
         _emit_type_name(type);
-        _scratch << " grad) noexcept {\n";
+        _scratch << "{\n";
         for (auto i = 0u; i < type->members().size(); i++) {
-            _scratch << "  lc_accumulate_grad(&dst->m" << i << ", grad.m" << i << ");\n";
+            _scratch << "    " << name << "<";
+            _emit_type_name(type->members()[i]);
+            _scratch << ">(),\n";
         }
-        _scratch << "}\n\n";
+        _scratch << "  };\n"
+                 << "}\n\n";
+    };
+    lc_make_value("lc_zero");
+    lc_make_value("lc_one");
+    // lc_accumulate_grad
+    _scratch << "__device__ inline void lc_accumulate_grad(";
+    _emit_type_name(type);
+    _scratch << " *dst, ";
+    _emit_type_name(type);
+    _scratch << " grad) noexcept {\n";
+    for (auto i = 0u; i < type->members().size(); i++) {
+        _scratch << "  lc_accumulate_grad(&dst->m" << i << ", grad.m" << i << ");\n";
     }
+    _scratch << "}\n\n";
+    detail::type_decl_cache.record(type->hash(), _scratch, offset);
 }
 
 void CUDACodegenAST::_emit_type_name(const Type *type) noexcept {
@@ -1781,10 +1800,7 @@ protected:
 
 void CUDACodegenAST::_emit_constant(Function::Constant c) noexcept {
 
-    if (auto iter = std::find(_generated_constants.cbegin(),
-                              _generated_constants.cend(), c.hash());
-        iter != _generated_constants.cend()) { return; }
-    _generated_constants.emplace_back(c.hash());
+    if (!_generated_constants.emplace(c.hash()).second) { return; }
 
     _scratch << "__constant__ LC_CONSTANT auto c"
              << hash_to_string(c.hash())
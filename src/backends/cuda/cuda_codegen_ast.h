@@ -3,6 +3,7 @@
 #include <luisa/ast/function.h>
 #include <luisa/ast/statement.h>
 #include <luisa/ast/expression.h>
+#include <luisa/core/stl/unordered_map.h>
 
 #include "../common/string_scratch.h"
 
@@ -23,8 +24,8 @@ public:
 private:
     StringScratch &_scratch;
     Function _function;
-    luisa::vector<Function> _generated_functions;
-    luisa::vector<uint64_t> _generated_constants;
+    luisa::unordered_set<uint64_t> _generated_functions;
+    luisa::unordered_set<uint64_t> _generated_constants;
     luisa::unique_ptr<RayQueryLowering> _ray_query_lowering;
     uint32_t _indent{0u};
     bool _allow_indirect_dispatch;
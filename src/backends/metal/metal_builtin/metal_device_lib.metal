@@ -347,13 +347,56 @@ inline auto atomic_fetch_sub_explicit(threadgroup atomic_float *object, float op
     return atomic_fetch_add_explicit(object, -operand, memory_order_relaxed);
 }
 
-#define LC_ATOMIC_OP2(op, addr_space, type)                                   \
-    inline auto lc_atomic_##op(addr_space type &a, type x) {                  \
-        return atomic_##op##_explicit(as_atomic(a), x, memory_order_relaxed); \
+// memory orders of the explicit atomic operations, see luisa::compute::MemoryOrder;
+// atomic operations in Metal are relaxed, so the stronger orders are enforced with
+// fences, which are only available since Metal 3.2
+#define LC_MEMORY_ORDER_RELAXED 0u
+#define LC_MEMORY_ORDER_ACQUIRE 1u
+#define LC_MEMORY_ORDER_RELEASE 2u
+#define LC_MEMORY_ORDER_ACQ_REL 3u
+#define LC_MEMORY_ORDER_SEQ_CST 4u
+
+inline void lc_atomic_fence_release(uint order) {
+#if __METAL_VERSION__ >= 320
+    if (order == LC_MEMORY_ORDER_RELEASE ||
+        order == LC_MEMORY_ORDER_ACQ_REL ||
+        order == LC_MEMORY_ORDER_SEQ_CST) {
+        atomic_thread_fence(mem_flags::mem_device | mem_flags::mem_threadgroup,
+                            memory_order_release, thread_scope_device);
     }
-#define LC_ATOMIC_OP3(op, addr_space, type)                                      \
-    inline auto lc_atomic_##op(addr_space type &a, type x, type y) {             \
-        return atomic_##op##_explicit(as_atomic(a), x, y, memory_order_relaxed); \
+#endif
+}
+
+inline void lc_atomic_fence_acquire(uint order) {
+#if __METAL_VERSION__ >= 320
+    if (order == LC_MEMORY_ORDER_ACQUIRE ||
+        order == LC_MEMORY_ORDER_ACQ_REL ||
+        order == LC_MEMORY_ORDER_SEQ_CST) {
+        atomic_thread_fence(mem_flags::mem_device | mem_flags::mem_threadgroup,
+                            memory_order_acquire, thread_scope_device);
+    }
+#endif
+}
+
+#define LC_ATOMIC_OP2(op, addr_space, type)                                             \
+    inline auto lc_atomic_##op(addr_space type &a, type x) {                            \
+        return atomic_##op##_explicit(as_atomic(a), x, memory_order_relaxed);           \
+    }                                                                                   \
+    inline auto lc_atomic_##op##_explicit(addr_space type &a, type x, uint order) {     \
+        lc_atomic_fence_release(order);                                                 \
+        auto old = lc_atomic_##op(a, x);                                                \
+        lc_atomic_fence_acquire(order);                                                 \
+        return old;                                                                     \
+    }
+#define LC_ATOMIC_OP3(op, addr_space, type)                                                 \
+    inline auto lc_atomic_##op(addr_space type &a, type x, type y) {                        \
+        return atomic_##op##_explicit(as_atomic(a), x, y, memory_order_relaxed);            \
+    }                                                                                       \
+    inline auto lc_atomic_##op##_explicit(addr_space type &a, type x, type y, uint order) { \
+        lc_atomic_fence_release(order);                                                     \
+        auto old = lc_atomic_##op(a, x, y);                                                 \
+        lc_atomic_fence_acquire(order);                                                     \
+        return old;                                                                         \
     }
 
 #define LC_ATOMIC_OP2_INT(op)           \
@@ -1,4 +1,4 @@
 #pragma once
 
 extern "C" const char luisa_metal_builtin_metal_builtin_kernels[7161];
-extern "C" const char luisa_metal_builtin_metal_device_lib[55122];
+extern "C" const char luisa_metal_builtin_metal_device_lib[57444];
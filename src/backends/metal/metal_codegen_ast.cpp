@@ -4,6 +4,7 @@
 #include <luisa/runtime/rtx/hit.h>
 #include <luisa/dsl/rtx/ray_query.h>
 #include <luisa/runtime/dispatch_buffer.h>
+#include "../common/codegen_cache.h"
 #include "metal_builtin_embedded.h"
 #include "metal_codegen_ast.h"
 
@@ -11,6 +12,10 @@ namespace luisa::compute::metal {
 
 namespace detail {
 
+// struct declarations and callables emitted for previous kernels
+static CodegenCache type_decl_cache;
+static CodegenCache callable_cache;
+
 class LiteralPrinter {
 
 private:
@@ -178,8 +183,10 @@ void MetalCodegenAST::_emit_type_decls(Function kernel) noexcept {
     });
 
     auto do_emit = [this](const Type *type) noexcept {
-        if (type->is_structure() &&
-            type != _ray_type &&
+        if (!type->is_structure()) { return; }
+        if (detail::type_decl_cache.replay(type->hash(), _scratch)) { return; }
+        auto offset = _scratch.size();
+        if (type != _ray_type &&
             type != _triangle_hit_type &&
             type != _procedural_hit_type &&
             type != _committed_hit_type &&
@@ -196,36 +203,35 @@ void MetalCodegenAST::_emit_type_decls(Function kernel) noexcept {
             }
             _scratch << "};\n\n";
         }
-        if (type->is_structure()) {
-            // lc_zero and lc_one
-            auto lc_make_value = [&](luisa::string_view name) noexcept {
-                _scratch << "template<> inline auto " << name << "<";
-                _emit_type_name(type);
-                _scratch << ">() {\n"
-                         << "  return ";
-                _emit_type_name(type);
-                _scratch << "{\n";
-                for (auto i = 0u; i < type->members().size(); i++) {
-                    _scratch << "    " << name << "<";
-                    _emit_type_name(type->members()[i]);
-                    _scratch << ">(),\n";
-                }
-                _scratch << "  };\n"
-                         << "}\n\n";
-            };
-            lc_make_value("lc_zero");
-            lc_make_value("lc_one");
-            // lc_accumulate_grad
-            _scratch << "inline void lc_accumulate_grad(thread ";
+        // lc_zero and lc_one
+        auto lc_make_value = [&](luisa::string_view name) noexcept {
+            _scratch << "template<> inline auto " << name << "<";
             _emit_type_name(type);
-            _scratch << " *dst, ";
+            _scratch << ">() {\n"
+                     << "  return ";
             _emit_type_name(type);
-            _scratch << " grad) {\n";
+            _scratch << "{\n";
             for (auto i = 0u; i < type->members().size(); i++) {
-                _scratch << "  lc_accumulate_grad(&dst->m" << i << ", grad.m" << i << ");\n";
+                _scratch << "    " << name << "<";
+                _emit_type_name(type->members()[i]);
+                _scratch << ">(),\n";
             }
-            _scratch << "}\n\n";
+            _scratch << "  };\n"
+                     << "}\n\n";
+        };
+        lc_make_value("lc_zero");
+        lc_make_value("lc_one");
+        // lc_accumulate_grad
+        _scratch << "inline void lc_accumulate_grad(thread ";
+        _emit_type_name(type);
+        _scratch << " *dst, ";
+        _emit_type_name(type);
+        _scratch << " grad) {\n";
+        for (auto i = 0u; i < type->members().size(); i++) {
+            _scratch << "  lc_accumulate_grad(&dst->m" << i << ", grad.m" << i << ");\n";
         }
+        _scratch << "}\n\n";
+        detail::type_decl_cache.record(type->hash(), _scratch, offset);
     };
 
     // process types in topological order
@@ -376,6 +382,12 @@ void MetalCodegenAST::_emit_function() noexcept {
                  "Invalid function type '{}'",
                  luisa::to_string(_function.tag()));
 
+    // the code of a callable is generated from its own AST
+    // only, so reuse what earlier kernels have emitted
+    auto is_callable = _function.tag() == Function::Tag::CALLABLE;
+    if (is_callable && detail::callable_cache.replay(_function.hash(), _scratch)) { return; }
+    auto offset = _scratch.size();
+
     if (_function.tag() == Function::Tag::KERNEL) {
 
         // emit argument buffer struct
@@ -508,6 +520,7 @@ void MetalCodegenAST::_emit_function() noexcept {
     for (auto s : _function.body()->statements()) { s->accept(*this); }
     _scratch << "\n  /* function body end */\n";
     _scratch << "}\n\n";
+    if (is_callable) { detail::callable_cache.record(_function.hash(), _scratch, offset); }
 
     auto emit_shared_variable_decls = [&] {
         if (_function.tag() == Function::Tag::KERNEL &&
@@ -658,6 +671,12 @@ void MetalCodegenAST::_emit_constant(const Function::Constant &c) noexcept {
 
 void MetalCodegenAST::emit(Function kernel, luisa::string_view native_include) noexcept {
 
+    // the device library dominates short kernels, so reserve
+    // for it and some headroom for the kernel upfront
+    _scratch.reserve(_scratch.size() +
+                     sizeof(luisa_metal_builtin_metal_device_lib) +
+                     native_include.size() + 64_k);
+
     // emit device library
     _scratch << luisa::string_view{luisa_metal_builtin_metal_device_lib,
                                    sizeof(luisa_metal_builtin_metal_device_lib)}
@@ -923,6 +942,15 @@ void MetalCodegenAST::visit(const CallExpr *expr) noexcept {
         case CallOp::ATOMIC_FETCH_XOR: _scratch << "lc_atomic_fetch_xor"; break;
         case CallOp::ATOMIC_FETCH_MIN: _scratch << "lc_atomic_fetch_min"; break;
         case CallOp::ATOMIC_FETCH_MAX: _scratch << "lc_atomic_fetch_max"; break;
+        case CallOp::ATOMIC_EXCHANGE_EXPLICIT: _scratch << "lc_atomic_exchange_explicit"; break;
+        case CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT: _scratch << "lc_atomic_compare_exchange_explicit"; break;
+        case CallOp::ATOMIC_FETCH_ADD_EXPLICIT: _scratch << "lc_atomic_fetch_add_explicit"; break;
+        case CallOp::ATOMIC_FETCH_SUB_EXPLICIT: _scratch << "lc_atomic_fetch_sub_explicit"; break;
+        case CallOp::ATOMIC_FETCH_AND_EXPLICIT: _scratch << "lc_atomic_fetch_and_explicit"; break;
+        case CallOp::ATOMIC_FETCH_OR_EXPLICIT: _scratch << "lc_atomic_fetch_or_explicit"; break;
+        case CallOp::ATOMIC_FETCH_XOR_EXPLICIT: _scratch << "lc_atomic_fetch_xor_explicit"; break;
+        case CallOp::ATOMIC_FETCH_MIN_EXPLICIT: _scratch << "lc_atomic_fetch_min_explicit"; break;
+        case CallOp::ATOMIC_FETCH_MAX_EXPLICIT: _scratch << "lc_atomic_fetch_max_explicit"; break;
         case CallOp::BUFFER_READ: _scratch << "buffer_read"; break;
         case CallOp::BUFFER_WRITE: _scratch << "buffer_write"; break;
         case CallOp::BUFFER_SIZE: _scratch << "buffer_size"; break;
@@ -1073,10 +1101,7 @@ void MetalCodegenAST::visit(const CallExpr *expr) noexcept {
         // lower access chain to atomic operation
         auto args = expr->arguments();
         auto access_chain = args.subspan(
-            0u,
-            op == CallOp::ATOMIC_COMPARE_EXCHANGE ?
-                args.size() - 2u :
-                args.size() - 1u);
+            0u, args.size() - atomic_operation_value_count(op));
         _scratch << "as_ref(";
         _emit_access_chain(access_chain);
         _scratch << ")";
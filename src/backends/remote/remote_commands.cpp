@@ -0,0 +1,533 @@
+#include <algorithm>
+
+#include <luisa/core/basic_traits.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/rhi/command.h>
+#include "remote_commands.h"
+
+namespace luisa::compute::remote {
+
+namespace detail {
+
+class RemoteCommandEncoder final : public CommandVisitor {
+
+private:
+    RemoteWriter &_writer;
+    luisa::vector<RemoteDownload> &_downloads;
+    bool _compress;
+
+private:
+    void _tag(const Command *command) noexcept {
+        _writer.write(command->tag());
+    }
+
+public:
+    RemoteCommandEncoder(RemoteWriter &writer, bool compress,
+                         luisa::vector<RemoteDownload> &downloads) noexcept
+        : _writer{writer}, _downloads{downloads}, _compress{compress} {}
+
+    void visit(const BufferUploadCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->handle())
+            .write(command->offset())
+            .write(command->size())
+            .write_payload(command->data(), command->size(), _compress);
+    }
+    void visit(const BufferDownloadCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->handle())
+            .write(command->offset())
+            .write(command->size());
+        _downloads.emplace_back(RemoteDownload{command->data(), command->size()});
+    }
+    void visit(const BufferCopyCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->src_handle())
+            .write(command->dst_handle())
+            .write(command->src_offset())
+            .write(command->dst_offset())
+            .write(command->size());
+    }
+    void visit(const BufferToTextureCopyCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->buffer())
+            .write(command->buffer_offset())
+            .write(command->texture())
+            .write(command->storage())
+            .write(command->level())
+            .write(command->size())
+            .write(command->texture_offset());
+    }
+    void visit(const ShaderDispatchCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->handle())
+            .write(command->is_indirect());
+        if (command->is_indirect()) {
+            _writer.write(command->indirect_dispatch());
+        } else {
+            _writer.write(command->dispatch_size());
+        }
+        auto args = command->arguments();
+        _writer.write_bytes(args.data(), args.size_bytes());
+        for (auto &&arg : args) {
+            if (arg.tag == Argument::Tag::UNIFORM) {
+                auto uniform = command->uniform(arg.uniform);
+                _writer.write_bytes(uniform.data(), uniform.size_bytes());
+            }
+        }
+    }
+    void visit(const TextureUploadCommand *command) noexcept override {
+        _tag(command);
+        auto size_bytes = pixel_storage_size(command->storage(), command->size());
+        _writer.write(command->handle())
+            .write(command->storage())
+            .write(command->level())
+            .write(command->size())
+            .write(command->offset())
+            .write_payload(command->data(), size_bytes, _compress);
+    }
+    void visit(const TextureDownloadCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->handle())
+            .write(command->storage())
+            .write(command->level())
+            .write(command->size())
+            .write(command->offset());
+        auto size_bytes = pixel_storage_size(command->storage(), command->size());
+        _downloads.emplace_back(RemoteDownload{command->data(), size_bytes});
+    }
+    void visit(const TextureCopyCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->storage())
+            .write(command->src_handle())
+            .write(command->dst_handle())
+            .write(command->src_level())
+            .write(command->dst_level())
+            .write(command->size())
+            .write(command->src_offset())
+            .write(command->dst_offset());
+    }
+    void visit(const TextureToBufferCopyCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->buffer())
+            .write(command->buffer_offset())
+            .write(command->texture())
+            .write(command->storage())
+            .write(command->level())
+            .write(command->size())
+            .write(command->texture_offset());
+    }
+    void visit(const AccelBuildCommand *command) noexcept override {
+        _tag(command);
+        auto mods = command->modifications();
+        _writer.write(command->handle())
+            .write(command->instance_count())
+            .write(command->request())
+            .write(command->update_instance_buffer_only())
+            .write(mods.size())
+            .write_payload(mods.data(), mods.size_bytes(), _compress);
+    }
+    void visit(const MeshBuildCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->handle())
+            .write(command->request())
+            .write(command->vertex_buffer())
+            .write(command->vertex_buffer_offset())
+            .write(command->vertex_buffer_size())
+            .write(command->vertex_stride())
+            .write(command->triangle_buffer())
+            .write(command->triangle_buffer_offset())
+            .write(command->triangle_buffer_size());
+    }
+    void visit(const ProceduralPrimitiveBuildCommand *command) noexcept override {
+        _tag(command);
+        _writer.write(command->handle())
+            .write(command->request())
+            .write(command->aabb_buffer())
+            .write(command->aabb_buffer_offset())
+            .write(command->aabb_buffer_size());
+    }
+    void visit(const BindlessArrayUpdateCommand *command) noexcept override {
+        _tag(command);
+        auto mods = command->modifications();
+        _writer.write(command->handle())
+            .write(mods.size())
+            .write_payload(mods.data(), mods.size_bytes(), _compress);
+    }
+    void visit(const CustomCommand *command) noexcept override {
+        LUISA_ERROR_WITH_LOCATION(
+            "Custom command (uuid = {}) is not supported by the remote backend.",
+            command->uuid());
+    }
+};
+
+// modifications have no default constructor, so they are rebuilt one by one;
+// more than `max_count` of them fail the reader
+template<typename Modification>
+[[nodiscard]] luisa::vector<Modification> read_modifications(RemoteReader &reader, size_t max_count) noexcept {
+    auto count = reader.read<size_t>();
+    if (count > max_count || !reader.fits_payload(count * sizeof(Modification))) {
+        reader.fail();
+        return {};
+    }
+    luisa::vector<std::byte> bytes(count * sizeof(Modification));
+    reader.read_payload(bytes.data(), bytes.size());
+    if (reader.failed()) { return {}; }
+    luisa::vector<Modification> mods;
+    mods.reserve(count);
+    for (auto i = 0u; i < count; i++) {
+        auto &&m = mods.emplace_back(0u);
+        std::memcpy(static_cast<void *>(&m), bytes.data() + i * sizeof(Modification), sizeof(Modification));
+    }
+    return mods;
+}
+
+[[nodiscard]] bool valid_argument(const RemoteResourceTable &resources, const Argument &arg,
+                                  const Type *type, size_t uniform_size) noexcept {
+    switch (arg.tag) {
+        case Argument::Tag::BUFFER:
+            return type->is_buffer() &&
+                   resources.buffer_range(arg.buffer.handle, arg.buffer.offset, arg.buffer.size);
+        case Argument::Tag::TEXTURE:
+            return type->is_texture() && resources.texture_level(arg.texture.handle, arg.texture.level);
+        case Argument::Tag::UNIFORM:
+            return !type->is_resource() && !type->is_custom() && uniform_size == type->size();
+        case Argument::Tag::BINDLESS_ARRAY:
+            return type->is_bindless_array() &&
+                   resources.contains(Resource::Tag::BINDLESS_ARRAY, arg.bindless_array.handle);
+        case Argument::Tag::ACCEL:
+            return type->is_accel() && resources.contains(Resource::Tag::ACCEL, arg.accel.handle);
+    }
+    return false;
+}
+
+[[nodiscard]] luisa::unique_ptr<Command> decode_shader_dispatch(RemoteReader &reader,
+                                                                const RemoteResourceTable &resources) noexcept {
+    auto handle = reader.read<uint64_t>();
+    auto is_indirect = reader.read<bool>();
+    ShaderDispatchCommand::DispatchSize dispatch_size;
+    if (is_indirect) {
+        auto indirect = reader.read<IndirectDispatchArg>();
+        if (!resources.contains(Resource::Tag::BUFFER, indirect.handle)) { reader.fail(); }
+        dispatch_size = indirect;
+    } else {
+        dispatch_size = reader.read<uint3>();
+    }
+    auto arg_bytes = reader.read_bytes();
+    auto arg_count = arg_bytes.size() / sizeof(Argument);
+    auto arg_types = resources.shader_arguments(handle);
+    if (arg_types == nullptr || arg_bytes.size() != arg_types->size() * sizeof(Argument)) {
+        reader.fail();
+    }
+    if (reader.failed()) { return nullptr; }
+    // arguments come first, followed by the uniforms at 16-byte aligned offsets
+    luisa::vector<std::byte> buffer(arg_bytes.begin(), arg_bytes.end());
+    auto args = reinterpret_cast<Argument *>(buffer.data());
+    for (auto i = 0u; i < arg_count; i++) {
+        auto uniform_size = static_cast<size_t>(0u);
+        if (args[i].tag == Argument::Tag::UNIFORM) {
+            auto uniform = reader.read_bytes();
+            auto offset = (buffer.size() + 15u) & ~static_cast<size_t>(15u);
+            buffer.resize(offset + uniform.size());
+            // resizing may move the arguments
+            args = reinterpret_cast<Argument *>(buffer.data());
+            if (!uniform.empty()) { std::memcpy(buffer.data() + offset, uniform.data(), uniform.size()); }
+            args[i].uniform.offset = offset;
+            args[i].uniform.size = uniform.size();
+            uniform_size = uniform.size();
+        }
+        if (reader.failed() || !valid_argument(resources, args[i], (*arg_types)[i], uniform_size)) {
+            reader.fail();
+            return nullptr;
+        }
+    }
+    return luisa::make_unique<ShaderDispatchCommand>(
+        handle, std::move(buffer), arg_count, dispatch_size);
+}
+
+}// namespace detail
+
+void encode_command_list(RemoteWriter &writer, const CommandList &list, bool compress,
+                         luisa::vector<RemoteDownload> &downloads) noexcept {
+    auto commands = list.commands();
+    writer.write(commands.size());
+    detail::RemoteCommandEncoder encoder{writer, compress, downloads};
+    for (auto &&command : commands) { command->accept(encoder); }
+}
+
+bool RemoteResourceTable::remove(Resource::Tag tag, uint64_t handle) noexcept {
+    if (!contains(tag, handle)) { return false; }
+    switch (tag) {
+        case Resource::Tag::BUFFER: _buffers.erase(handle); break;
+        case Resource::Tag::TEXTURE: _textures.erase(handle); break;
+        case Resource::Tag::BINDLESS_ARRAY: _bindless_arrays.erase(handle); break;
+        case Resource::Tag::SHADER: _shaders.erase(handle); break;
+        default: _others.erase(handle); break;
+    }
+    return true;
+}
+
+bool RemoteResourceTable::contains(Resource::Tag tag, uint64_t handle) const noexcept {
+    switch (tag) {
+        case Resource::Tag::BUFFER: return _buffers.contains(handle);
+        case Resource::Tag::TEXTURE: return _textures.contains(handle);
+        case Resource::Tag::BINDLESS_ARRAY: return _bindless_arrays.contains(handle);
+        case Resource::Tag::SHADER: return _shaders.contains(handle);
+        default: break;
+    }
+    auto iter = _others.find(handle);
+    return iter != _others.end() && iter->second == tag;
+}
+
+bool RemoteResourceTable::buffer_range(uint64_t handle, size_t offset, size_t size) const noexcept {
+    auto iter = _buffers.find(handle);
+    return iter != _buffers.end() && offset <= iter->second && size <= iter->second - offset;
+}
+
+bool RemoteResourceTable::texture_level(uint64_t handle, uint level) const noexcept {
+    auto iter = _textures.find(handle);
+    return iter != _textures.end() && level < iter->second.levels;
+}
+
+bool RemoteResourceTable::texture_region(uint64_t handle, PixelStorage storage, uint level,
+                                         uint3 offset, uint3 size) const noexcept {
+    auto iter = _textures.find(handle);
+    if (iter == _textures.end()) { return false; }
+    auto &&t = iter->second;
+    if (storage != t.storage || level >= t.levels) { return false; }
+    auto fits = [level](uint offset, uint size, uint extent) noexcept {
+        extent = std::max(extent >> level, 1u);
+        return offset <= extent && size <= extent - offset;
+    };
+    return fits(offset.x, size.x, t.size.x) &&
+           fits(offset.y, size.y, t.size.y) &&
+           fits(offset.z, size.z, t.size.z);
+}
+
+size_t RemoteResourceTable::bindless_array_size(uint64_t handle) const noexcept {
+    auto iter = _bindless_arrays.find(handle);
+    return iter == _bindless_arrays.end() ? 0u : iter->second;
+}
+
+const luisa::vector<const Type *> *RemoteResourceTable::shader_arguments(uint64_t handle) const noexcept {
+    auto iter = _shaders.find(handle);
+    return iter == _shaders.end() ? nullptr : &iter->second;
+}
+
+CommandList decode_command_list(RemoteReader &reader, RemoteCommandStaging &staging,
+                                const RemoteResourceTable &resources) noexcept {
+    auto command_count = reader.read<size_t>();
+    // every command takes at least its tag
+    if (command_count > remote_max_message_size / sizeof(Command::Tag)) {
+        reader.fail();
+        return {};
+    }
+    auto list = CommandList::create(command_count);
+    // the sizes are checked against the resources before the data is allocated
+    auto upload = [&](size_t size) noexcept {
+        if (!reader.fits_payload(size)) {
+            reader.fail();
+            return static_cast<const void *>(nullptr);
+        }
+        auto &&data = staging.uploads.emplace_back(size);
+        reader.read_payload(data.data(), data.size());
+        return static_cast<const void *>(data.data());
+    };
+    auto download = [&](size_t size) noexcept {
+        return static_cast<void *>(staging.downloads.emplace_back(size).data());
+    };
+    auto check = [&](bool valid) noexcept {
+        if (!valid) { reader.fail(); }
+        return !reader.failed();
+    };
+    auto check_bindless_modifications = [&](const luisa::vector<BindlessArrayUpdateCommand::Modification> &mods,
+                                            size_t slots) noexcept {
+        using Op = BindlessArrayUpdateCommand::Modification::Operation;
+        for (auto &&m : mods) {
+            if (m.slot >= slots ||
+                (m.buffer.op == Op::EMPLACE && !resources.buffer_range(m.buffer.handle, m.buffer.offset_bytes, 0u)) ||
+                (m.tex2d.op == Op::EMPLACE && !resources.contains(Resource::Tag::TEXTURE, m.tex2d.handle)) ||
+                (m.tex3d.op == Op::EMPLACE && !resources.contains(Resource::Tag::TEXTURE, m.tex3d.handle))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto check_accel_modifications = [&](const luisa::vector<AccelBuildCommand::Modification> &mods,
+                                         uint instance_count) noexcept {
+        using Mod = AccelBuildCommand::Modification;
+        for (auto &&m : mods) {
+            if (m.index >= instance_count ||
+                ((m.flags & Mod::flag_primitive) != 0u &&
+                 !resources.contains(Resource::Tag::MESH, m.primitive) &&
+                 !resources.contains(Resource::Tag::PROCEDURAL_PRIMITIVE, m.primitive))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (auto i = 0u; i < command_count && !reader.failed(); i++) {
+        auto tag = reader.read<Command::Tag>();
+        switch (tag) {
+            case Command::Tag::EBufferUploadCommand: {
+                auto handle = reader.read<uint64_t>();
+                auto offset = reader.read<size_t>();
+                auto size = reader.read<size_t>();
+                if (!check(resources.buffer_range(handle, offset, size))) { break; }
+                auto data = upload(size);
+                if (reader.failed()) { break; }
+                list << luisa::make_unique<BufferUploadCommand>(handle, offset, size, data);
+                break;
+            }
+            case Command::Tag::EBufferDownloadCommand: {
+                auto handle = reader.read<uint64_t>();
+                auto offset = reader.read<size_t>();
+                auto size = reader.read<size_t>();
+                if (!check(resources.buffer_range(handle, offset, size))) { break; }
+                list << luisa::make_unique<BufferDownloadCommand>(handle, offset, size, download(size));
+                break;
+            }
+            case Command::Tag::EBufferCopyCommand: {
+                auto src = reader.read<uint64_t>();
+                auto dst = reader.read<uint64_t>();
+                auto src_offset = reader.read<size_t>();
+                auto dst_offset = reader.read<size_t>();
+                auto size = reader.read<size_t>();
+                if (!check(resources.buffer_range(src, src_offset, size) &&
+                           resources.buffer_range(dst, dst_offset, size))) { break; }
+                list << luisa::make_unique<BufferCopyCommand>(src, dst, src_offset, dst_offset, size);
+                break;
+            }
+            case Command::Tag::EBufferToTextureCopyCommand: {
+                auto buffer = reader.read<uint64_t>();
+                auto buffer_offset = reader.read<size_t>();
+                auto texture = reader.read<uint64_t>();
+                auto storage = reader.read<PixelStorage>();
+                auto level = reader.read<uint>();
+                auto size = reader.read<uint3>();
+                auto texture_offset = reader.read<uint3>();
+                if (!check(resources.texture_region(texture, storage, level, texture_offset, size) &&
+                           resources.buffer_range(buffer, buffer_offset, pixel_storage_size(storage, size)))) { break; }
+                list << luisa::make_unique<BufferToTextureCopyCommand>(
+                    buffer, buffer_offset, texture, storage, level, size, texture_offset);
+                break;
+            }
+            case Command::Tag::EShaderDispatchCommand: {
+                if (auto command = detail::decode_shader_dispatch(reader, resources)) {
+                    list << std::move(command);
+                }
+                break;
+            }
+            case Command::Tag::ETextureUploadCommand: {
+                auto handle = reader.read<uint64_t>();
+                auto storage = reader.read<PixelStorage>();
+                auto level = reader.read<uint>();
+                auto size = reader.read<uint3>();
+                auto offset = reader.read<uint3>();
+                if (!check(resources.texture_region(handle, storage, level, offset, size))) { break; }
+                auto data = upload(pixel_storage_size(storage, size));
+                if (reader.failed()) { break; }
+                list << luisa::make_unique<TextureUploadCommand>(handle, storage, level, size, data, offset);
+                break;
+            }
+            case Command::Tag::ETextureDownloadCommand: {
+                auto handle = reader.read<uint64_t>();
+                auto storage = reader.read<PixelStorage>();
+                auto level = reader.read<uint>();
+                auto size = reader.read<uint3>();
+                auto offset = reader.read<uint3>();
+                if (!check(resources.texture_region(handle, storage, level, offset, size))) { break; }
+                auto data = download(pixel_storage_size(storage, size));
+                list << luisa::make_unique<TextureDownloadCommand>(handle, storage, level, size, data, offset);
+                break;
+            }
+            case Command::Tag::ETextureCopyCommand: {
+                auto storage = reader.read<PixelStorage>();
+                auto src = reader.read<uint64_t>();
+                auto dst = reader.read<uint64_t>();
+                auto src_level = reader.read<uint>();
+                auto dst_level = reader.read<uint>();
+                auto size = reader.read<uint3>();
+                auto src_offset = reader.read<uint3>();
+                auto dst_offset = reader.read<uint3>();
+                if (!check(resources.texture_region(src, storage, src_level, src_offset, size) &&
+                           resources.texture_region(dst, storage, dst_level, dst_offset, size))) { break; }
+                list << luisa::make_unique<TextureCopyCommand>(
+                    storage, src, dst, src_level, dst_level, size, src_offset, dst_offset);
+                break;
+            }
+            case Command::Tag::ETextureToBufferCopyCommand: {
+                auto buffer = reader.read<uint64_t>();
+                auto buffer_offset = reader.read<size_t>();
+                auto texture = reader.read<uint64_t>();
+                auto storage = reader.read<PixelStorage>();
+                auto level = reader.read<uint>();
+                auto size = reader.read<uint3>();
+                auto texture_offset = reader.read<uint3>();
+                if (!check(resources.texture_region(texture, storage, level, texture_offset, size) &&
+                           resources.buffer_range(buffer, buffer_offset, pixel_storage_size(storage, size)))) { break; }
+                list << luisa::make_unique<TextureToBufferCopyCommand>(
+                    buffer, buffer_offset, texture, storage, level, size, texture_offset);
+                break;
+            }
+            case Command::Tag::EAccelBuildCommand: {
+                auto handle = reader.read<uint64_t>();
+                auto instance_count = reader.read<uint32_t>();
+                auto request = reader.read<AccelBuildRequest>();
+                auto update_instance_buffer_only = reader.read<bool>();
+                if (!check(resources.contains(Resource::Tag::ACCEL, handle) &&
+                           request <= AccelBuildRequest::FORCE_BUILD)) { break; }
+                auto mods = detail::read_modifications<AccelBuildCommand::Modification>(reader, instance_count);
+                if (!check(check_accel_modifications(mods, instance_count))) { break; }
+                list << luisa::make_unique<AccelBuildCommand>(
+                    handle, instance_count, request, std::move(mods), update_instance_buffer_only);
+                break;
+            }
+            case Command::Tag::EMeshBuildCommand: {
+                auto handle = reader.read<uint64_t>();
+                auto request = reader.read<AccelBuildRequest>();
+                auto vertex_buffer = reader.read<uint64_t>();
+                auto vertex_buffer_offset = reader.read<size_t>();
+                auto vertex_buffer_size = reader.read<size_t>();
+                auto vertex_stride = reader.read<size_t>();
+                auto triangle_buffer = reader.read<uint64_t>();
+                auto triangle_buffer_offset = reader.read<size_t>();
+                auto triangle_buffer_size = reader.read<size_t>();
+                if (!check(resources.contains(Resource::Tag::MESH, handle) &&
+                           request <= AccelBuildRequest::FORCE_BUILD && vertex_stride != 0u &&
+                           resources.buffer_range(vertex_buffer, vertex_buffer_offset, vertex_buffer_size) &&
+                           resources.buffer_range(triangle_buffer, triangle_buffer_offset, triangle_buffer_size))) { break; }
+                list << luisa::make_unique<MeshBuildCommand>(
+                    handle, request, vertex_buffer, vertex_buffer_offset, vertex_buffer_size,
+                    vertex_stride, triangle_buffer, triangle_buffer_offset, triangle_buffer_size);
+                break;
+            }
+            case Command::Tag::EProceduralPrimitiveBuildCommand: {
+                auto handle = reader.read<uint64_t>();
+                auto request = reader.read<AccelBuildRequest>();
+                auto aabb_buffer = reader.read<uint64_t>();
+                auto aabb_buffer_offset = reader.read<size_t>();
+                auto aabb_buffer_size = reader.read<size_t>();
+                if (!check(resources.contains(Resource::Tag::PROCEDURAL_PRIMITIVE, handle) &&
+                           request <= AccelBuildRequest::FORCE_BUILD &&
+                           resources.buffer_range(aabb_buffer, aabb_buffer_offset, aabb_buffer_size))) { break; }
+                list << luisa::make_unique<ProceduralPrimitiveBuildCommand>(
+                    handle, request, aabb_buffer, aabb_buffer_offset, aabb_buffer_size);
+                break;
+            }
+            case Command::Tag::EBindlessArrayUpdateCommand: {
+                auto handle = reader.read<uint64_t>();
+                auto slots = resources.bindless_array_size(handle);
+                if (!check(slots != 0u)) { break; }
+                auto mods = detail::read_modifications<BindlessArrayUpdateCommand::Modification>(reader, slots);
+                if (!check(check_bindless_modifications(mods, slots))) { break; }
+                list << luisa::make_unique<BindlessArrayUpdateCommand>(handle, std::move(mods));
+                break;
+            }
+            default: reader.fail(); break;
+        }
+    }
+    return list;
+}
+
+}// namespace luisa::compute::remote
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/runtime/command_list.h>
+#include <luisa/runtime/rhi/resource.h>
+#include <luisa/runtime/rhi/pixel.h>
+#include "remote_protocol.h"
+
+namespace luisa::compute::remote {
+
+// host memory a download command writes into when the dispatch completes
+struct RemoteDownload {
+    void *data;
+    size_t size;
+};
+
+// client side: appends the commands of `list` to `writer`, uploads are copied
+// (and compressed if requested) so the list may be recycled right away
+void encode_command_list(RemoteWriter &writer, const CommandList &list, bool compress,
+                         luisa::vector<RemoteDownload> &downloads) noexcept;
+
+// server side: the resources a client created, so that its requests and
+// commands may only refer to those and stay within their bounds
+class RemoteResourceTable {
+
+public:
+    struct Texture {
+        PixelStorage storage;
+        uint3 size;
+        uint levels;
+    };
+
+private:
+    luisa::unordered_map<uint64_t, size_t> _buffers;// size in bytes
+    luisa::unordered_map<uint64_t, Texture> _textures;
+    luisa::unordered_map<uint64_t, size_t> _bindless_arrays;// slot count
+    luisa::unordered_map<uint64_t, luisa::vector<const Type *>> _shaders;// unbound arguments
+    luisa::unordered_map<uint64_t, Resource::Tag> _others;
+
+public:
+    void add_buffer(uint64_t handle, size_t size_bytes) noexcept { _buffers.insert_or_assign(handle, size_bytes); }
+    void add_texture(uint64_t handle, Texture texture) noexcept { _textures.insert_or_assign(handle, texture); }
+    void add_bindless_array(uint64_t handle, size_t slots) noexcept { _bindless_arrays.insert_or_assign(handle, slots); }
+    void add_shader(uint64_t handle, luisa::vector<const Type *> arguments) noexcept { _shaders.insert_or_assign(handle, std::move(arguments)); }
+    // meshes, procedural primitives, accels, streams and events
+    void add(Resource::Tag tag, uint64_t handle) noexcept { _others.insert_or_assign(handle, tag); }
+    // returns false if the client does not own the resource
+    [[nodiscard]] bool remove(Resource::Tag tag, uint64_t handle) noexcept;
+    [[nodiscard]] bool contains(Resource::Tag tag, uint64_t handle) const noexcept;
+    [[nodiscard]] bool buffer_range(uint64_t handle, size_t offset, size_t size) const noexcept;
+    [[nodiscard]] bool texture_level(uint64_t handle, uint level) const noexcept;
+    [[nodiscard]] bool texture_region(uint64_t handle, PixelStorage storage, uint level,
+                                      uint3 offset, uint3 size) const noexcept;
+    // zero for unknown bindless arrays
+    [[nodiscard]] size_t bindless_array_size(uint64_t handle) const noexcept;
+    [[nodiscard]] const luisa::vector<const Type *> *shader_arguments(uint64_t handle) const noexcept;
+};
+
+// server side: rebuilds the command list, pointing uploads and downloads into
+// `staging`, which must be kept alive until the list completes; commands that
+// refer to resources outside of `resources` or out of their bounds fail the reader
+struct RemoteCommandStaging {
+    luisa::vector<luisa::vector<std::byte>> uploads;
+    luisa::vector<luisa::vector<std::byte>> downloads;
+};
+
+[[nodiscard]] CommandList decode_command_list(RemoteReader &reader, RemoteCommandStaging &staging,
+                                              const RemoteResourceTable &resources) noexcept;
+
+}// namespace luisa::compute::remote
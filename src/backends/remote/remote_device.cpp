@@ -1,17 +1,500 @@
-#include "../common/rust_device_common.h"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char **environ;
+#endif
+
+#include <cstdlib>
+#include <luisa/core/clock.h>
+#include <luisa/core/basic_traits.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/stl/filesystem.h>
+#include <luisa/ast/callable_library.h>
+#include <luisa/runtime/context.h>
 #include "remote_device.h"
 
+namespace luisa::compute::remote {
+
+namespace detail {
+
+[[nodiscard]] static luisa::string read_env(const char *name) noexcept {
+    auto value = std::getenv(name);
+    return value == nullptr ? luisa::string{} : luisa::string{value};
+}
+
+}// namespace detail
+
+RemoteDevice::RemoteDevice(Context &&ctx, luisa::string_view address) noexcept
+    : DeviceInterface{std::move(ctx)} {
+    luisa::string addr{address};
+    auto spawned = addr.empty();
+    if (spawned) { addr = _spawn_local_server(); }
+    // a freshly spawned server may not be listening yet
+    Clock clock;
+    for (;;) {
+        _socket = RemoteSocket::connect(addr);
+        if (_socket || !spawned || clock.toc() > 10e3) { break; }
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    LUISA_ASSERT(_socket, "Failed to connect to remote server at '{}'.", addr);
+    // compression pays off on real networks but not on local sockets
+    _compress = _socket.is_tcp();
+    if (auto env = detail::read_env("LUISA_REMOTE_COMPRESSION"); !env.empty()) {
+        _compress = env != "0";
+    }
+    _sender = std::thread{[this] { _send_loop(); }};
+    _receiver = std::thread{[this] { _receive_loop(); }};
+    // servers reachable from other machines drop clients without the token
+    auto hello = _writer(RemoteOp::HELLO);
+    hello.write(protocol_version).write(_compress).write_string(detail::read_env("LUISA_REMOTE_TOKEN"));
+    auto reply = _request(std::move(hello));
+    RemoteReader reader{reply};
+    auto version = reader.read<uint32_t>();
+    LUISA_ASSERT(version == protocol_version,
+                 "Remote server speaks protocol version {} (expected {}).",
+                 version, protocol_version);
+    _warp_size = reader.read<uint>();
+    auto backend = reader.read_string();
+    LUISA_ASSERT(!reader.failed(), "Invalid handshake from the remote server.");
+    LUISA_INFO("Connected to remote '{}' device at '{}' (compression {}).",
+               backend, addr, _compress ? "on" : "off");
+}
+
+RemoteDevice::~RemoteDevice() noexcept {
+    {
+        std::scoped_lock lock{_send_mutex};
+        _stop = true;
+    }
+    _send_cv.notify_one();
+    // the sender drains the queue, so all pending destroys reach the server
+    _sender.join();
+    _socket.shutdown();
+    _receiver.join();
+    _socket.close();
+    if (_server_process != 0u) {
+#ifdef _WIN32
+        auto process = reinterpret_cast<HANDLE>(_server_process);
+        if (WaitForSingleObject(process, 10000u) != WAIT_OBJECT_0) {
+            TerminateProcess(process, 1u);
+        }
+        CloseHandle(process);
+#else
+        auto status = 0;
+        waitpid(static_cast<pid_t>(_server_process), &status, 0);
+#endif
+    }
+}
+
+luisa::string RemoteDevice::_spawn_local_server() noexcept {
+    auto backend = detail::read_env("LUISA_REMOTE_BACKEND");
+    if (backend.empty()) {
+        for (auto &&b : context().installed_backends()) {
+            if (b != "remote") {
+                backend = b;
+                break;
+            }
+        }
+    }
+    LUISA_ASSERT(!backend.empty(), "No backend available for the local remote server.");
+    static std::atomic_uint instance_counter{0u};
+#ifdef _WIN32
+    auto pid = static_cast<uint64_t>(GetCurrentProcessId());
+#else
+    auto pid = static_cast<uint64_t>(getpid());
+#endif
+    auto socket_path = luisa::filesystem::temp_directory_path() /
+                       luisa::format("luisa-remote-{}-{}.sock", pid, instance_counter++);
+    auto address = luisa::format("unix://{}", luisa::to_string(socket_path));
+#ifdef _WIN32
+    auto executable = context().runtime_directory() / "lc-remote-server.exe";
+    auto command_line = luisa::format("\"{}\" --backend {} --address {} --once",
+                                      luisa::to_string(executable), backend, address);
+    STARTUPINFOA startup_info{};
+    startup_info.cb = sizeof(startup_info);
+    PROCESS_INFORMATION process_info{};
+    if (!CreateProcessA(nullptr, command_line.data(), nullptr, nullptr, FALSE, 0,
+                        nullptr, nullptr, &startup_info, &process_info)) {
+        LUISA_ERROR_WITH_LOCATION("Failed to launch '{}' (error {}).",
+                                  luisa::to_string(executable), GetLastError());
+    }
+    CloseHandle(process_info.hThread);
+    _server_process = reinterpret_cast<uint64_t>(process_info.hProcess);
+#else
+    auto executable = luisa::to_string(context().runtime_directory() / "lc-remote-server");
+    luisa::string args[]{executable, "--backend", backend, "--address", address, "--once"};
+    char *argv[]{args[0].data(), args[1].data(), args[2].data(),
+                 args[3].data(), args[4].data(), args[5].data(), nullptr};
+    pid_t child{};
+    if (auto ret = posix_spawn(&child, executable.c_str(), nullptr, nullptr, argv, environ); ret != 0) {
+        LUISA_ERROR_WITH_LOCATION("Failed to launch '{}' (error {}).", executable, ret);
+    }
+    _server_process = static_cast<uint64_t>(child);
+#endif
+    LUISA_INFO("Launched local remote server with backend '{}' at '{}'.", backend, address);
+    return address;
+}
+
+RemoteWriter RemoteDevice::_writer(RemoteOp op) noexcept {
+    return RemoteWriter{op, ++_request_counter};
+}
+
+void RemoteDevice::_post(RemoteWriter &&writer) noexcept {
+    auto message = std::move(writer).finish();
+    {
+        std::scoped_lock lock{_send_mutex};
+        _send_queue.emplace_back(std::move(message));
+    }
+    _send_cv.notify_one();
+}
+
+luisa::vector<std::byte> RemoteDevice::_request(RemoteWriter &&writer) noexcept {
+    auto request = writer.request();
+    _post(std::move(writer));
+    std::unique_lock lock{_reply_mutex};
+    _reply_cv.wait(lock, [&] { return _disconnected || _replies.contains(request); });
+    auto iter = _replies.find(request);
+    if (iter == _replies.end()) [[unlikely]] {
+        LUISA_ERROR_WITH_LOCATION("Lost connection to the remote server.");
+    }
+    auto reply = std::move(iter->second);
+    _replies.erase(iter);
+    return reply;
+}
+
+void RemoteDevice::_send_loop() noexcept {
+    // small messages are coalesced so a burst of commands costs one syscall
+    static constexpr auto batch_size = static_cast<size_t>(64u * 1024u);
+    luisa::vector<luisa::vector<std::byte>> queue;
+    luisa::vector<std::byte> batch;
+    batch.reserve(batch_size);
+    auto flush = [&] {
+        auto ok = batch.empty() || _socket.send(batch.data(), batch.size());
+        batch.clear();
+        return ok;
+    };
+    for (;;) {
+        {
+            std::unique_lock lock{_send_mutex};
+            _send_cv.wait(lock, [this] { return _stop || !_send_queue.empty(); });
+            if (_send_queue.empty()) { return; }
+            queue.swap(_send_queue);
+        }
+        for (auto &&message : queue) {
+            if (message.size() >= batch_size) {
+                if (!flush() || !_socket.send(message.data(), message.size())) { return; }
+            } else {
+                if (batch.size() + message.size() > batch_size && !flush()) { return; }
+                batch.insert(batch.end(), message.cbegin(), message.cend());
+            }
+        }
+        queue.clear();
+        if (!flush()) { return; }
+    }
+}
+
+void RemoteDevice::_receive_loop() noexcept {
+    for (;;) {
+        RemoteMessageHeader header{};
+        if (!_socket.receive(&header, sizeof(header))) { break; }
+        if (header.size > remote_max_message_size) {
+            LUISA_WARNING_WITH_LOCATION("Oversized message from the remote server "
+                                        "(op = {}, size = {}).",
+                                        luisa::to_underlying(header.op), header.size);
+            break;
+        }
+        luisa::vector<std::byte> payload(header.size);
+        if (!_socket.receive(payload.data(), payload.size())) { break; }
+        switch (header.op) {
+            case RemoteOp::REPLY: {
+                {
+                    std::scoped_lock lock{_reply_mutex};
+                    _replies.emplace(header.request, std::move(payload));
+                }
+                _reply_cv.notify_all();
+                break;
+            }
+            case RemoteOp::DISPATCH_COMPLETED: {
+                RemoteReader reader{payload};
+                _complete_dispatch(header.request, reader);
+                break;
+            }
+            default: LUISA_ERROR_WITH_LOCATION(
+                "Unexpected remote message (op = {}).",
+                luisa::to_underlying(header.op));
+        }
+    }
+    {
+        std::scoped_lock lock{_reply_mutex};
+        _disconnected = true;
+    }
+    _reply_cv.notify_all();
+}
+
+void RemoteDevice::_complete_dispatch(uint64_t request, RemoteReader &reader) noexcept {
+    PendingDispatch dispatch;
+    {
+        std::scoped_lock lock{_dispatch_mutex};
+        auto iter = _dispatches.find(request);
+        LUISA_ASSERT(iter != _dispatches.end(), "Unknown remote dispatch #{}.", request);
+        dispatch = std::move(iter->second);
+        _dispatches.erase(iter);
+    }
+    for (auto &&d : dispatch.downloads) { reader.read_payload(d.data, d.size); }
+    LUISA_ASSERT(!reader.failed(), "Invalid completion of remote dispatch #{}.", request);
+    for (auto &&callback : dispatch.callbacks) { callback(); }
+}
+
+ResourceCreationInfo RemoteDevice::_create_resource(RemoteWriter &&writer) noexcept {
+    auto reply = _request(std::move(writer));
+    RemoteReader reader{reply};
+    return ResourceCreationInfo{reader.read<uint64_t>(), nullptr};
+}
+
+BufferCreationInfo RemoteDevice::create_buffer(const Type *element, size_t elem_count) noexcept {
+    auto w = _writer(RemoteOp::CREATE_BUFFER);
+    w.write_string(element == nullptr ? luisa::string_view{} : element->description())
+        .write(elem_count);
+    auto reply = _request(std::move(w));
+    RemoteReader reader{reply};
+    BufferCreationInfo info{};
+    info.handle = reader.read<uint64_t>();
+    info.native_handle = nullptr;
+    info.element_stride = reader.read<size_t>();
+    info.total_size_bytes = reader.read<size_t>();
+    return info;
+}
+
+BufferCreationInfo RemoteDevice::create_buffer(const ir::CArc<ir::Type> *element, size_t elem_count) noexcept {
+    LUISA_ERROR_WITH_LOCATION("Buffers of IR types are not supported by the remote backend.");
+}
+
+void RemoteDevice::destroy_buffer(uint64_t handle) noexcept {
+    _post(std::move(_writer(RemoteOp::DESTROY_BUFFER).write(handle)));
+}
+
+ResourceCreationInfo RemoteDevice::create_texture(PixelFormat format, uint dimension,
+                                                  uint width, uint height, uint depth,
+                                                  uint mipmap_levels, bool simultaneous_access) noexcept {
+    auto w = _writer(RemoteOp::CREATE_TEXTURE);
+    w.write(format).write(dimension).write(make_uint3(width, height, depth))
+        .write(mipmap_levels).write(simultaneous_access);
+    return _create_resource(std::move(w));
+}
+
+void RemoteDevice::destroy_texture(uint64_t handle) noexcept {
+    _post(std::move(_writer(RemoteOp::DESTROY_TEXTURE).write(handle)));
+}
+
+ResourceCreationInfo RemoteDevice::create_bindless_array(size_t size) noexcept {
+    auto w = _writer(RemoteOp::CREATE_BINDLESS_ARRAY);
+    w.write(size);
+    return _create_resource(std::move(w));
+}
+
+void RemoteDevice::destroy_bindless_array(uint64_t handle) noexcept {
+    _post(std::move(_writer(RemoteOp::DESTROY_BINDLESS_ARRAY).write(handle)));
+}
+
+ResourceCreationInfo RemoteDevice::create_stream(StreamTag stream_tag) noexcept {
+    auto w = _writer(RemoteOp::CREATE_STREAM);
+    w.write(stream_tag);
+    return _create_resource(std::move(w));
+}
+
+void RemoteDevice::destroy_stream(uint64_t handle) noexcept {
+    _post(std::move(_writer(RemoteOp::DESTROY_STREAM).write(handle)));
+}
+
+void RemoteDevice::synchronize_stream(uint64_t stream_handle) noexcept {
+    // answered only after the completions of earlier dispatches are sent
+    static_cast<void>(_request(std::move(_writer(RemoteOp::SYNCHRONIZE_STREAM).write(stream_handle))));
+}
+
+void RemoteDevice::dispatch(uint64_t stream_handle, CommandList &&list) noexcept {
+    auto w = _writer(RemoteOp::DISPATCH);
+    PendingDispatch pending;
+    w.write(stream_handle);
+    encode_command_list(w, list, _compress, pending.downloads);
+    pending.callbacks = list.steal_callbacks();
+    // lists without downloads or callbacks need no completion message
+    auto notify = !pending.downloads.empty() || !pending.callbacks.empty();
+    w.write(notify);
+    if (notify) {
+        std::scoped_lock lock{_dispatch_mutex};
+        _dispatches.emplace(w.request(), std::move(pending));
+    }
+    list.clear();
+    _post(std::move(w));
+}
+
+SwapchainCreationInfo RemoteDevice::create_swapchain(uint64_t window_handle, uint64_t stream_handle,
+                                                     uint width, uint height, bool allow_hdr,
+                                                     bool vsync, uint back_buffer_size) noexcept {
+    LUISA_ERROR_WITH_LOCATION("Swapchains are not supported by the remote backend.");
+}
+
+void RemoteDevice::destroy_swap_chain(uint64_t handle) noexcept {
+    LUISA_ERROR_WITH_LOCATION("Swapchains are not supported by the remote backend.");
+}
+
+void RemoteDevice::present_display_in_stream(uint64_t stream_handle, uint64_t swapchain_handle, uint64_t image_handle) noexcept {
+    LUISA_ERROR_WITH_LOCATION("Swapchains are not supported by the remote backend.");
+}
+
+ShaderCreationInfo RemoteDevice::create_shader(const ShaderOption &option, Function kernel) noexcept {
+    // kernels travel as serialized AST and are compiled by the server's backend
+    auto binary = CallableLibrary::serialize_kernel(kernel);
+    auto w = _writer(RemoteOp::CREATE_SHADER);
+    w.write(option.enable_cache)
+        .write(option.enable_fast_math)
+        .write(option.enable_debug_info)
+        .write(option.compile_only)
+        .write_string(option.name)
+        .write_string(option.native_include)
+        .write(binary.size())
+        .write_payload(binary.data(), binary.size(), _compress);
+    auto reply = _request(std::move(w));
+    RemoteReader reader{reply};
+    ShaderCreationInfo info{};
+    info.handle = reader.read<uint64_t>();
+    info.native_handle = nullptr;
+    info.block_size = reader.read<uint3>();
+    if (info.valid()) {
+        luisa::vector<Usage> usages;
+        usages.reserve(kernel.arguments().size());
+        for (auto &&arg : kernel.arguments()) {
+            usages.emplace_back(kernel.variable_usage(arg.uid()));
+        }
+        std::scoped_lock lock{_shader_mutex};
+        _argument_usages.insert_or_assign(info.handle, std::move(usages));
+    }
+    return info;
+}
+
+ShaderCreationInfo RemoteDevice::create_shader(const ShaderOption &option, const ir::KernelModule *kernel) noexcept {
+    LUISA_ERROR_WITH_LOCATION("IR kernels are not supported by the remote backend.");
+}
+
+ShaderCreationInfo RemoteDevice::load_shader(luisa::string_view name, luisa::span<const Type *const> arg_types) noexcept {
+    auto w = _writer(RemoteOp::LOAD_SHADER);
+    w.write_string(name).write(arg_types.size());
+    for (auto t : arg_types) { w.write_string(t->description()); }
+    auto reply = _request(std::move(w));
+    RemoteReader reader{reply};
+    ShaderCreationInfo info{};
+    info.handle = reader.read<uint64_t>();
+    info.native_handle = nullptr;
+    info.block_size = reader.read<uint3>();
+    if (info.valid()) {
+        // the server reports the usages of loaded shaders along with the handle
+        luisa::vector<Usage> usages(arg_types.size());
+        for (auto &&u : usages) { u = reader.read<Usage>(); }
+        std::scoped_lock lock{_shader_mutex};
+        _argument_usages.insert_or_assign(info.handle, std::move(usages));
+    }
+    return info;
+}
+
+Usage RemoteDevice::shader_argument_usage(uint64_t handle, size_t index) noexcept {
+    std::scoped_lock lock{_shader_mutex};
+    auto iter = _argument_usages.find(handle);
+    LUISA_ASSERT(iter != _argument_usages.end() && index < iter->second.size(),
+                 "Invalid argument #{} of remote shader {}.", index, handle);
+    return iter->second[index];
+}
+
+void RemoteDevice::destroy_shader(uint64_t handle) noexcept {
+    {
+        std::scoped_lock lock{_shader_mutex};
+        _argument_usages.erase(handle);
+    }
+    _post(std::move(_writer(RemoteOp::DESTROY_SHADER).write(handle)));
+}
+
+ResourceCreationInfo RemoteDevice::create_event() noexcept {
+    return _create_resource(_writer(RemoteOp::CREATE_EVENT));
+}
+
+void RemoteDevice::destroy_event(uint64_t handle) noexcept {
+    _post(std::move(_writer(RemoteOp::DESTROY_EVENT).write(handle)));
+}
+
+void RemoteDevice::signal_event(uint64_t handle, uint64_t stream_handle, uint64_t fence_value) noexcept {
+    _post(std::move(_writer(RemoteOp::SIGNAL_EVENT).write(handle).write(stream_handle).write(fence_value)));
+}
+
+void RemoteDevice::wait_event(uint64_t handle, uint64_t stream_handle, uint64_t fence_value) noexcept {
+    _post(std::move(_writer(RemoteOp::WAIT_EVENT).write(handle).write(stream_handle).write(fence_value)));
+}
+
+bool RemoteDevice::is_event_completed(uint64_t handle, uint64_t fence_value) const noexcept {
+    auto self = const_cast<RemoteDevice *>(this);
+    auto reply = self->_request(std::move(self->_writer(RemoteOp::IS_EVENT_COMPLETED).write(handle).write(fence_value)));
+    RemoteReader reader{reply};
+    return reader.read<bool>();
+}
+
+void RemoteDevice::synchronize_event(uint64_t handle, uint64_t fence_value) noexcept {
+    static_cast<void>(_request(std::move(_writer(RemoteOp::SYNCHRONIZE_EVENT).write(handle).write(fence_value))));
+}
+
+ResourceCreationInfo RemoteDevice::create_mesh(const AccelOption &option) noexcept {
+    return _create_resource(std::move(_writer(RemoteOp::CREATE_MESH).write(option)));
+}
+
+void RemoteDevice::destroy_mesh(uint64_t handle) noexcept {
+    _post(std::move(_writer(RemoteOp::DESTROY_MESH).write(handle)));
+}
+
+ResourceCreationInfo RemoteDevice::create_procedural_primitive(const AccelOption &option) noexcept {
+    return _create_resource(std::move(_writer(RemoteOp::CREATE_PROCEDURAL_PRIMITIVE).write(option)));
+}
+
+void RemoteDevice::destroy_procedural_primitive(uint64_t handle) noexcept {
+    _post(std::move(_writer(RemoteOp::DESTROY_PROCEDURAL_PRIMITIVE).write(handle)));
+}
+
+ResourceCreationInfo RemoteDevice::create_accel(const AccelOption &option) noexcept {
+    return _create_resource(std::move(_writer(RemoteOp::CREATE_ACCEL).write(option)));
+}
+
+void RemoteDevice::destroy_accel(uint64_t handle) noexcept {
+    _post(std::move(_writer(RemoteOp::DESTROY_ACCEL).write(handle)));
+}
+
+luisa::string RemoteDevice::query(luisa::string_view property) noexcept {
+    auto reply = _request(std::move(_writer(RemoteOp::QUERY).write_string(property)));
+    RemoteReader reader{reply};
+    return reader.read_string();
+}
+
+void RemoteDevice::set_name(luisa::compute::Resource::Tag resource_tag, uint64_t resource_handle, luisa::string_view name) noexcept {
+    _post(std::move(_writer(RemoteOp::SET_NAME).write(resource_tag).write(resource_handle).write_string(name)));
+}
+
+}// namespace luisa::compute::remote
+
 LUISA_EXPORT_API luisa::compute::DeviceInterface *create(luisa::compute::Context &&ctx,
                                                          const luisa::compute::DeviceConfig *config) noexcept {
-    return luisa::compute::rust::create(std::move(ctx), config, "remote");
+    // connect to LUISA_REMOTE_SERVER if set, otherwise host a local server
+    auto address = luisa::compute::remote::detail::read_env("LUISA_REMOTE_SERVER");
+    return luisa::new_with_allocator<luisa::compute::remote::RemoteDevice>(std::move(ctx), address);
 }
 
 LUISA_EXPORT_API void destroy(luisa::compute::DeviceInterface *device) noexcept {
-    return luisa::compute::rust::destroy(device);
+    auto p = dynamic_cast<luisa::compute::remote::RemoteDevice *>(device);
+    LUISA_ASSERT(p != nullptr, "Deleting a null remote device.");
+    luisa::delete_with_allocator(p);
 }
 
 LUISA_EXPORT_API void backend_device_names(luisa::vector<luisa::string> &names) noexcept {
     names.clear();
-    names.emplace_back("Unknown");// TODO
+    auto address = luisa::compute::remote::detail::read_env("LUISA_REMOTE_SERVER");
+    names.emplace_back(address.empty() ? luisa::string{"local"} : address);
 }
-
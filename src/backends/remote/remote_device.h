@@ -1,3 +1,115 @@
 #pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include <luisa/core/stl/unordered_map.h>
 #include <luisa/runtime/rhi/device_interface.h>
+#include "remote_protocol.h"
+#include "remote_socket.h"
+#include "remote_commands.h"
+
+namespace luisa::compute::remote {
+
+/**
+ * @brief Client of a device hosted by lc-remote-server
+ *
+ * Resource creation and queries are synchronous round trips and return the
+ * handles of the server, so commands are forwarded without translation.
+ * Everything else is queued and flushed by a sender thread in batches, while
+ * a receiver thread dispatches the replies and completions coming back.
+ */
+class RemoteDevice final : public DeviceInterface {
+
+private:
+    struct PendingDispatch {
+        luisa::vector<RemoteDownload> downloads;
+        CommandList::CallbackContainer callbacks;
+    };
+
+private:
+    RemoteSocket _socket;
+    uint64_t _server_process{0u};// spawned local server, if any
+    bool _compress{false};
+    uint _warp_size{0u};
+    std::atomic_uint64_t _request_counter{0u};
+
+    // sender
+    std::mutex _send_mutex;
+    std::condition_variable _send_cv;
+    luisa::vector<luisa::vector<std::byte>> _send_queue;
+    bool _stop{false};
+    std::thread _sender;
+
+    // receiver
+    std::thread _receiver;
+    std::mutex _reply_mutex;
+    std::condition_variable _reply_cv;
+    luisa::unordered_map<uint64_t, luisa::vector<std::byte>> _replies;
+    bool _disconnected{false};
+    std::mutex _dispatch_mutex;
+    luisa::unordered_map<uint64_t, PendingDispatch> _dispatches;
+
+    // argument usages of shaders created on this device
+    std::mutex _shader_mutex;
+    luisa::unordered_map<uint64_t, luisa::vector<Usage>> _argument_usages;
+
+private:
+    [[nodiscard]] luisa::string _spawn_local_server() noexcept;
+    void _send_loop() noexcept;
+    void _receive_loop() noexcept;
+    void _post(RemoteWriter &&writer) noexcept;
+    [[nodiscard]] luisa::vector<std::byte> _request(RemoteWriter &&writer) noexcept;
+    [[nodiscard]] RemoteWriter _writer(RemoteOp op) noexcept;
+    void _complete_dispatch(uint64_t request, RemoteReader &reader) noexcept;
+    [[nodiscard]] ResourceCreationInfo _create_resource(RemoteWriter &&writer) noexcept;
+
+public:
+    RemoteDevice(Context &&ctx, luisa::string_view address) noexcept;
+    ~RemoteDevice() noexcept override;
+    void *native_handle() const noexcept override { return nullptr; }
+    uint compute_warp_size() const noexcept override { return _warp_size; }
+
+public:
+    BufferCreationInfo create_buffer(const Type *element, size_t elem_count) noexcept override;
+    BufferCreationInfo create_buffer(const ir::CArc<ir::Type> *element, size_t elem_count) noexcept override;
+    void destroy_buffer(uint64_t handle) noexcept override;
+    ResourceCreationInfo create_texture(PixelFormat format, uint dimension,
+                                        uint width, uint height, uint depth,
+                                        uint mipmap_levels, bool simultaneous_access) noexcept override;
+    void destroy_texture(uint64_t handle) noexcept override;
+    ResourceCreationInfo create_bindless_array(size_t size) noexcept override;
+    void destroy_bindless_array(uint64_t handle) noexcept override;
+    ResourceCreationInfo create_stream(StreamTag stream_tag) noexcept override;
+    void destroy_stream(uint64_t handle) noexcept override;
+    void synchronize_stream(uint64_t stream_handle) noexcept override;
+    void dispatch(uint64_t stream_handle, CommandList &&list) noexcept override;
+    SwapchainCreationInfo create_swapchain(uint64_t window_handle, uint64_t stream_handle,
+                                           uint width, uint height, bool allow_hdr,
+                                           bool vsync, uint back_buffer_size) noexcept override;
+    void destroy_swap_chain(uint64_t handle) noexcept override;
+    void present_display_in_stream(uint64_t stream_handle, uint64_t swapchain_handle, uint64_t image_handle) noexcept override;
+    ShaderCreationInfo create_shader(const ShaderOption &option, Function kernel) noexcept override;
+    ShaderCreationInfo create_shader(const ShaderOption &option, const ir::KernelModule *kernel) noexcept override;
+    ShaderCreationInfo load_shader(luisa::string_view name, luisa::span<const Type *const> arg_types) noexcept override;
+    Usage shader_argument_usage(uint64_t handle, size_t index) noexcept override;
+    void destroy_shader(uint64_t handle) noexcept override;
+    ResourceCreationInfo create_event() noexcept override;
+    void destroy_event(uint64_t handle) noexcept override;
+    void signal_event(uint64_t handle, uint64_t stream_handle, uint64_t fence_value) noexcept override;
+    void wait_event(uint64_t handle, uint64_t stream_handle, uint64_t fence_value) noexcept override;
+    bool is_event_completed(uint64_t handle, uint64_t fence_value) const noexcept override;
+    void synchronize_event(uint64_t handle, uint64_t fence_value) noexcept override;
+    ResourceCreationInfo create_mesh(const AccelOption &option) noexcept override;
+    void destroy_mesh(uint64_t handle) noexcept override;
+    ResourceCreationInfo create_procedural_primitive(const AccelOption &option) noexcept override;
+    void destroy_procedural_primitive(uint64_t handle) noexcept override;
+    ResourceCreationInfo create_accel(const AccelOption &option) noexcept override;
+    void destroy_accel(uint64_t handle) noexcept override;
+    luisa::string query(luisa::string_view property) noexcept override;
+    void set_name(luisa::compute::Resource::Tag resource_tag, uint64_t resource_handle, luisa::string_view name) noexcept override;
+};
 
+}// namespace luisa::compute::remote
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include "remote_protocol.h"
+
+namespace luisa::compute::remote {
+
+namespace detail {
+
+static constexpr auto lz_min_match = 4u;
+static constexpr auto lz_max_offset = 65535u;
+static constexpr auto lz_hash_bits = 16u;
+// the last bytes are always emitted as literals so matches never overrun
+static constexpr auto lz_tail_literals = 8u;
+
+[[nodiscard]] inline uint32_t lz_load32(const std::byte *p) noexcept {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+[[nodiscard]] inline uint32_t lz_hash(uint32_t v) noexcept {
+    return (v * 2654435761u) >> (32u - lz_hash_bits);
+}
+
+inline void lz_write_length(luisa::vector<std::byte> &out, size_t length) noexcept {
+    for (; length >= 255u; length -= 255u) { out.emplace_back(static_cast<std::byte>(255u)); }
+    out.emplace_back(static_cast<std::byte>(length));
+}
+
+inline void lz_emit(luisa::vector<std::byte> &out,
+                    const std::byte *literals, size_t literal_count,
+                    size_t offset, size_t match_length) noexcept {
+    auto token = static_cast<uint8_t>(std::min<size_t>(literal_count, 15u) << 4u);
+    if (match_length != 0u) {
+        token |= static_cast<uint8_t>(std::min<size_t>(match_length - lz_min_match, 15u));
+    }
+    out.emplace_back(static_cast<std::byte>(token));
+    if (literal_count >= 15u) { lz_write_length(out, literal_count - 15u); }
+    out.insert(out.end(), literals, literals + literal_count);
+    if (match_length != 0u) {
+        out.emplace_back(static_cast<std::byte>(offset & 0xffu));
+        out.emplace_back(static_cast<std::byte>(offset >> 8u));
+        if (match_length - lz_min_match >= 15u) {
+            lz_write_length(out, match_length - lz_min_match - 15u);
+        }
+    }
+}
+
+// returns false if the length runs past the end of the data
+[[nodiscard]] inline bool lz_read_length(const std::byte *&p, const std::byte *end, size_t &length) noexcept {
+    for (;;) {
+        if (p >= end) { return false; }
+        auto b = static_cast<uint8_t>(*p++);
+        length += b;
+        if (b != 255u) { return true; }
+    }
+}
+
+}// namespace detail
+
+size_t remote_compress(const std::byte *data, size_t size, luisa::vector<std::byte> &out) noexcept {
+    using namespace detail;
+    auto begin = out.size();
+    out.reserve(begin + size + size / 255u + 16u);
+    auto anchor = static_cast<size_t>(0u);
+    if (size > lz_tail_literals + lz_min_match) {
+        luisa::vector<uint32_t> table(1u << lz_hash_bits, ~0u);
+        auto limit = size - lz_tail_literals;
+        auto i = static_cast<size_t>(0u);
+        while (i + lz_min_match <= limit) {
+            auto seq = lz_load32(data + i);
+            auto h = lz_hash(seq);
+            auto candidate = table[h];
+            table[h] = static_cast<uint32_t>(i);
+            if (candidate != ~0u && i - candidate <= lz_max_offset &&
+                lz_load32(data + candidate) == seq) {
+                auto length = static_cast<size_t>(lz_min_match);
+                while (i + length < limit && data[candidate + length] == data[i + length]) { length++; }
+                lz_emit(out, data + anchor, i - anchor, i - candidate, length);
+                i += length;
+                anchor = i;
+            } else {
+                // skip faster through incompressible data
+                i += 1u + ((i - anchor) >> 6u);
+            }
+        }
+    }
+    lz_emit(out, data + anchor, size - anchor, 0u, 0u);
+    return out.size() - begin;
+}
+
+bool remote_decompress(const std::byte *data, size_t size, std::byte *out, size_t out_size) noexcept {
+    using namespace detail;
+    auto p = data;
+    auto end = data + size;
+    auto o = out;
+    auto o_end = out + out_size;
+    while (p < end) {
+        auto token = static_cast<uint8_t>(*p++);
+        auto literal_count = static_cast<size_t>(token >> 4u);
+        if (literal_count == 15u && !lz_read_length(p, end, literal_count)) { return false; }
+        if (literal_count > static_cast<size_t>(end - p) ||
+            literal_count > static_cast<size_t>(o_end - o)) { return false; }
+        if (literal_count != 0u) { std::memcpy(o, p, literal_count); }
+        p += literal_count;
+        o += literal_count;
+        if (p == end) { break; }
+        if (end - p < 2) { return false; }
+        auto offset = static_cast<size_t>(static_cast<uint8_t>(p[0])) |
+                      (static_cast<size_t>(static_cast<uint8_t>(p[1])) << 8u);
+        p += 2;
+        auto length = static_cast<size_t>(token & 15u) + lz_min_match;
+        if ((token & 15u) == 15u && !lz_read_length(p, end, length)) { return false; }
+        if (offset == 0u || offset > static_cast<size_t>(o - out) ||
+            length > static_cast<size_t>(o_end - o)) { return false; }
+        // the match may overlap with the bytes it produces
+        auto match = o - offset;
+        for (auto i = 0u; i < length; i++) { o[i] = match[i]; }
+        o += length;
+    }
+    return o == o_end;
+}
+
+RemoteWriter &RemoteWriter::write_payload(const void *data, size_t size, bool compress) noexcept {
+    auto bytes = static_cast<const std::byte *>(data);
+    if (compress && size >= remote_compression_threshold) {
+        write(true);
+        auto size_offset = _bytes.size();
+        write(static_cast<size_t>(0u));
+        auto compressed_size = remote_compress(bytes, size, _bytes);
+        // keep the compressed form only if it saves at least 1/8
+        if (compressed_size < size - size / 8u) {
+            std::memcpy(_bytes.data() + size_offset, &compressed_size, sizeof(compressed_size));
+            return *this;
+        }
+        _bytes.resize(size_offset - sizeof(bool));
+    }
+    write(false);
+    return write_bytes(bytes, size);
+}
+
+void RemoteReader::read_payload(void *data, size_t size) noexcept {
+    auto compressed = read<bool>();
+    auto bytes = read_bytes();
+    if (_failed) { return; }
+    if (compressed) {
+        if (!remote_decompress(bytes.data(), bytes.size(), static_cast<std::byte *>(data), size)) {
+            _failed = true;
+        }
+    } else if (bytes.size() != size) {
+        _failed = true;
+    } else if (size != 0u) {
+        std::memcpy(data, bytes.data(), size);
+    }
+}
+
+}// namespace luisa::compute::remote
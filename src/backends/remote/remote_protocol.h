@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <luisa/core/basic_types.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/stl/vector.h>
+#include <luisa/core/stl/string.h>
+
+namespace luisa::compute::remote {
+
+// bumped on every incompatible change of the wire format
+static constexpr uint32_t protocol_version = 2u;
+
+// Every message is a RemoteMessageHeader followed by `size` bytes of payload.
+// Requests that create resources or query state are answered by a REPLY with
+// the same request id; all other requests are pipelined without an answer.
+enum struct RemoteOp : uint32_t {
+    // client -> server, must come first and carry the token the server expects
+    HELLO,
+    CREATE_BUFFER,
+    DESTROY_BUFFER,
+    CREATE_TEXTURE,
+    DESTROY_TEXTURE,
+    CREATE_BINDLESS_ARRAY,
+    DESTROY_BINDLESS_ARRAY,
+    CREATE_STREAM,
+    DESTROY_STREAM,
+    SYNCHRONIZE_STREAM,
+    DISPATCH,
+    CREATE_SHADER,
+    LOAD_SHADER,
+    DESTROY_SHADER,
+    CREATE_EVENT,
+    DESTROY_EVENT,
+    SIGNAL_EVENT,
+    WAIT_EVENT,
+    IS_EVENT_COMPLETED,
+    SYNCHRONIZE_EVENT,
+    CREATE_MESH,
+    DESTROY_MESH,
+    CREATE_PROCEDURAL_PRIMITIVE,
+    DESTROY_PROCEDURAL_PRIMITIVE,
+    CREATE_ACCEL,
+    DESTROY_ACCEL,
+    SET_NAME,
+    QUERY,
+    // server -> client
+    REPLY,
+    // a DISPATCH has completed, carries the data of its downloads
+    DISPATCH_COMPLETED,
+};
+
+struct RemoteMessageHeader {
+    RemoteOp op;
+    uint32_t reserved;
+    uint64_t request;
+    uint64_t size;
+};
+
+static_assert(sizeof(RemoteMessageHeader) == 24u);
+
+// larger messages are rejected before their payload is allocated; the server
+// accepts no more than the HELLO limit until the client is authenticated
+static constexpr uint64_t remote_max_message_size = 4ull << 30u;
+static constexpr uint64_t remote_max_hello_size = 4096u;
+
+// payloads smaller than this are never compressed
+static constexpr size_t remote_compression_threshold = 4096u;
+
+// LZ77 block codec in the LZ4 sequence format, returns the compressed size
+size_t remote_compress(const std::byte *data, size_t size, luisa::vector<std::byte> &out) noexcept;
+// returns false if the data is corrupted or does not decompress to exactly `out_size` bytes
+[[nodiscard]] bool remote_decompress(const std::byte *data, size_t size, std::byte *out, size_t out_size) noexcept;
+
+class RemoteWriter {
+
+private:
+    luisa::vector<std::byte> _bytes;
+
+public:
+    RemoteWriter(RemoteOp op, uint64_t request) noexcept {
+        _bytes.reserve(256u);
+        write(RemoteMessageHeader{op, 0u, request, 0u});
+    }
+    template<typename T>
+        requires std::is_trivially_copyable_v<T>
+    RemoteWriter &write(const T &value) noexcept {
+        auto offset = _bytes.size();
+        _bytes.resize(offset + sizeof(T));
+        std::memcpy(_bytes.data() + offset, &value, sizeof(T));
+        return *this;
+    }
+    RemoteWriter &write_bytes(const void *data, size_t size) noexcept {
+        write(size);
+        auto offset = _bytes.size();
+        _bytes.resize(offset + size);
+        if (size != 0u) { std::memcpy(_bytes.data() + offset, data, size); }
+        return *this;
+    }
+    RemoteWriter &write_string(luisa::string_view s) noexcept {
+        return write_bytes(s.data(), s.size());
+    }
+    // host data of uploads and downloads, optionally compressed
+    RemoteWriter &write_payload(const void *data, size_t size, bool compress) noexcept;
+    [[nodiscard]] auto request() const noexcept {
+        RemoteMessageHeader header{};
+        std::memcpy(&header, _bytes.data(), sizeof(header));
+        return header.request;
+    }
+    [[nodiscard]] luisa::vector<std::byte> finish() && noexcept {
+        auto size = static_cast<uint64_t>(_bytes.size() - sizeof(RemoteMessageHeader));
+        std::memcpy(_bytes.data() + offsetof(RemoteMessageHeader, size), &size, sizeof(size));
+        return std::move(_bytes);
+    }
+};
+
+// Reading past the end of a message or a corrupted payload fails the reader instead of
+// aborting, later reads return zeros, so the server can drop clients sending bad input.
+class RemoteReader {
+
+private:
+    const std::byte *_ptr;
+    const std::byte *_end;
+    bool _failed{false};
+
+private:
+    [[nodiscard]] bool _check(size_t size) noexcept {
+        if (_failed || size > static_cast<size_t>(_end - _ptr)) { _failed = true; }
+        return !_failed;
+    }
+
+public:
+    explicit RemoteReader(luisa::span<const std::byte> payload) noexcept
+        : _ptr{payload.data()}, _end{payload.data() + payload.size()} {}
+    template<typename T>
+        requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] T read() noexcept {
+        T value{};
+        if (_check(sizeof(T))) {
+            if constexpr (std::is_same_v<T, bool>) {
+                // any other byte would be an invalid bool
+                auto byte = static_cast<uint8_t>(*_ptr);
+                if (byte > 1u) { _failed = true; }
+                value = byte == 1u;
+            } else {
+                std::memcpy(&value, _ptr, sizeof(T));
+            }
+            _ptr += sizeof(T);
+        }
+        return value;
+    }
+    [[nodiscard]] luisa::span<const std::byte> read_bytes() noexcept {
+        auto size = read<size_t>();
+        if (!_check(size)) { return {}; }
+        luisa::span<const std::byte> bytes{_ptr, size};
+        _ptr += size;
+        return bytes;
+    }
+    [[nodiscard]] luisa::string read_string() noexcept {
+        auto bytes = read_bytes();
+        return luisa::string{reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+    }
+    // reads a payload written by write_payload into `size` bytes at `data`
+    void read_payload(void *data, size_t size) noexcept;
+    // whether the rest of the message could hold a payload of `size` bytes, even compressed,
+    // so that the receiver does not allocate for sizes that cannot be valid
+    [[nodiscard]] bool fits_payload(size_t size) const noexcept {
+        // a sequence of the codec expands to at most 255 bytes per byte
+        return size / 255u <= remaining();
+    }
+    // marks the message as invalid, e.g. when a value read is out of range
+    void fail() noexcept { _failed = true; }
+    [[nodiscard]] auto failed() const noexcept { return _failed; }
+    [[nodiscard]] auto remaining() const noexcept { return static_cast<size_t>(_end - _ptr); }
+    [[nodiscard]] auto empty() const noexcept { return _ptr == _end; }
+};
+
+}// namespace luisa::compute::remote
@@ -0,0 +1,559 @@
+#include <mutex>
+#include <thread>
+#include <cstdlib>
+#include <algorithm>
+#include <condition_variable>
+
+#include <luisa/core/basic_traits.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/stl/map.h>
+#include <luisa/core/stl/optional.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/ast/callable_library.h>
+#include <luisa/ast/function_builder.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include "remote_protocol.h"
+#include "remote_socket.h"
+#include "remote_commands.h"
+
+using namespace luisa;
+using namespace luisa::compute;
+using namespace luisa::compute::remote;
+
+namespace {
+
+// Serves one client on its own device. Requests are handled in order on the
+// session thread; completions of dispatches are sent from backend callbacks.
+class RemoteSession {
+
+private:
+    struct SignalRecord {
+        uint64_t stream;
+        uint64_t dispatch_count;
+    };
+
+private:
+    RemoteSocket _socket;
+    std::mutex _send_mutex;
+    bool _compress{false};
+    // requests other than HELLO are only accepted after the client presented the token
+    luisa::string _token;
+    bool _authenticated{false};
+    // what the client may refer to, touched only by the session thread
+    RemoteResourceTable _resources;
+
+    // dispatches that notify the client, per stream
+    std::mutex _progress_mutex;
+    std::condition_variable _progress_cv;
+    luisa::unordered_map<uint64_t, uint64_t> _submitted;
+    luisa::unordered_map<uint64_t, uint64_t> _completed;
+    // event -> fence -> stream progress when the signal was enqueued
+    luisa::unordered_map<uint64_t, luisa::map<uint64_t, SignalRecord>> _signals;
+
+    // the backend may refer to the kernel for the lifetime of the shader
+    luisa::unordered_map<uint64_t, luisa::shared_ptr<const luisa::compute::detail::FunctionBuilder>> _kernels;
+
+    // destroyed first, so no callback outlives the members above
+    Device _device;
+
+private:
+    void _send(RemoteWriter &&writer) noexcept {
+        auto message = std::move(writer).finish();
+        std::scoped_lock lock{_send_mutex};
+        static_cast<void>(_socket.send(message.data(), message.size()));
+    }
+    [[nodiscard]] static RemoteWriter _reply(uint64_t request) noexcept {
+        return RemoteWriter{RemoteOp::REPLY, request};
+    }
+    [[nodiscard]] auto _device_impl() const noexcept { return _device.impl(); }
+
+    // waits until the client got the completions of the first `count` notifying dispatches
+    void _wait_progress(uint64_t stream, uint64_t count) noexcept {
+        std::unique_lock lock{_progress_mutex};
+        _progress_cv.wait(lock, [&] { return _completed[stream] >= count; });
+    }
+    [[nodiscard]] uint64_t _submitted_count(uint64_t stream) noexcept {
+        std::scoped_lock lock{_progress_mutex};
+        return _submitted[stream];
+    }
+    [[nodiscard]] luisa::optional<SignalRecord> _find_signal(uint64_t event, uint64_t fence) noexcept {
+        std::scoped_lock lock{_progress_mutex};
+        auto iter = _signals.find(event);
+        if (iter == _signals.end()) { return luisa::nullopt; }
+        auto record = iter->second.lower_bound(fence);
+        if (record == iter->second.end()) { return luisa::nullopt; }
+        return record->second;
+    }
+
+    void _dispatch(uint64_t request, RemoteReader &reader) noexcept {
+        auto stream = reader.read<uint64_t>();
+        if (!_resources.contains(Resource::Tag::STREAM, stream)) {
+            reader.fail();
+            return;
+        }
+        auto staging = luisa::make_unique<RemoteCommandStaging>();
+        auto list = decode_command_list(reader, *staging, _resources);
+        auto notify = reader.read<bool>();
+        if (reader.failed()) { return; }
+        if (notify) {
+            {
+                std::scoped_lock lock{_progress_mutex};
+                _submitted[stream]++;
+            }
+            list.add_callback([this, request, stream, staging = std::move(staging)] {
+                RemoteWriter w{RemoteOp::DISPATCH_COMPLETED, request};
+                for (auto &&d : staging->downloads) {
+                    w.write_payload(d.data(), d.size(), _compress);
+                }
+                _send(std::move(w));
+                {
+                    std::scoped_lock lock{_progress_mutex};
+                    _completed[stream]++;
+                }
+                _progress_cv.notify_all();
+            });
+        } else if (!staging->uploads.empty()) {
+            // keep the uploaded data alive until the list is executed
+            list.add_callback([staging = std::move(staging)] {});
+        }
+        _device_impl()->dispatch(stream, std::move(list));
+    }
+
+    // names become file names in the shader cache, so they must not leave it
+    [[nodiscard]] static bool _valid_shader_name(luisa::string_view name) noexcept {
+        using namespace std::string_view_literals;
+        return name.find_first_of("/\\:"sv) == luisa::string_view::npos &&
+               name.find(".."sv) == luisa::string_view::npos;
+    }
+
+    [[nodiscard]] bool _valid_binding(const Function::Binding &binding) const noexcept {
+        return luisa::visit(
+            [this]<typename T>(const T &b) noexcept {
+                if constexpr (std::is_same_v<T, Function::BufferBinding>) {
+                    return _resources.buffer_range(b.handle, b.offset, b.size);
+                } else if constexpr (std::is_same_v<T, Function::TextureBinding>) {
+                    return _resources.texture_level(b.handle, b.level);
+                } else if constexpr (std::is_same_v<T, Function::BindlessArrayBinding>) {
+                    return _resources.contains(Resource::Tag::BINDLESS_ARRAY, b.handle);
+                } else if constexpr (std::is_same_v<T, Function::AccelBinding>) {
+                    return _resources.contains(Resource::Tag::ACCEL, b.handle);
+                } else {
+                    return true;
+                }
+            },
+            binding);
+    }
+
+    void _create_shader(uint64_t request, RemoteReader &reader) noexcept {
+        ShaderOption option;
+        option.enable_cache = reader.read<bool>();
+        option.enable_fast_math = reader.read<bool>();
+        option.enable_debug_info = reader.read<bool>();
+        option.compile_only = reader.read<bool>();
+        option.name = reader.read_string();
+        option.native_include = reader.read_string();
+        auto binary_size = reader.read<size_t>();
+        if (!_valid_shader_name(option.name) || !reader.fits_payload(binary_size)) { reader.fail(); }
+        if (reader.failed()) { return; }
+        luisa::vector<std::byte> binary(binary_size);
+        reader.read_payload(binary.data(), binary.size());
+        if (reader.failed()) { return; }
+        // the AST deserializer trusts its input, which is why only authenticated clients get here
+        auto kernel = CallableLibrary::deserialize_kernel(binary);
+        auto function = kernel->function();
+        for (auto &&binding : function.bound_arguments()) {
+            if (!_valid_binding(binding)) {
+                reader.fail();
+                return;
+            }
+        }
+        auto info = _device_impl()->create_shader(option, function);
+        if (info.valid() && !option.compile_only) {
+            luisa::vector<const Type *> arg_types;
+            for (auto &&arg : function.unbound_arguments()) { arg_types.emplace_back(arg.type()); }
+            _resources.add_shader(info.handle, std::move(arg_types));
+            _kernels.insert_or_assign(info.handle, std::move(kernel));
+        }
+        _send(std::move(_reply(request).write(info.handle).write(info.block_size)));
+    }
+
+    void _load_shader(uint64_t request, RemoteReader &reader) noexcept {
+        auto name = reader.read_string();
+        auto arg_count = reader.read<size_t>();
+        // every type description takes at least its size
+        if (!_valid_shader_name(name) || arg_count > reader.remaining() / sizeof(size_t)) { reader.fail(); }
+        if (reader.failed()) { return; }
+        luisa::vector<const Type *> arg_types(arg_count);
+        for (auto &&t : arg_types) { t = Type::from(reader.read_string()); }
+        if (reader.failed()) { return; }
+        auto info = _device_impl()->load_shader(name, arg_types);
+        auto w = _reply(request);
+        w.write(info.handle).write(info.block_size);
+        if (info.valid()) {
+            for (auto i = 0u; i < arg_types.size(); i++) {
+                w.write(_device_impl()->shader_argument_usage(info.handle, i));
+            }
+            _resources.add_shader(info.handle, std::move(arg_types));
+        }
+        _send(std::move(w));
+    }
+
+    [[nodiscard]] static bool _valid_accel_option(const AccelOption &option) noexcept {
+        return option.hint <= AccelOption::UsageHint::FAST_BUILD;
+    }
+
+    // tokens are compared without an early exit, so that timing does not leak their bytes
+    [[nodiscard]] bool _check_token(luisa::string_view token) const noexcept {
+        auto diff = static_cast<size_t>(token.size() ^ _token.size());
+        for (auto i = 0u; i < std::min(token.size(), _token.size()); i++) {
+            diff |= static_cast<uint8_t>(token[i] ^ _token[i]);
+        }
+        return diff == 0u;
+    }
+
+    void _hello(uint64_t request, RemoteReader &reader) noexcept {
+        auto device = _device_impl();
+        auto version = reader.read<uint32_t>();
+        if (version != protocol_version) {
+            // the client reports the mismatch, the rest of its message may be laid out differently
+            LUISA_WARNING("Client speaks protocol version {} (expected {}).",
+                          version, protocol_version);
+            _send(std::move(_reply(request).write(protocol_version)));
+            reader.fail();
+            return;
+        }
+        _compress = reader.read<bool>();
+        auto token = reader.read_string();
+        if (reader.failed() || !_check_token(token)) {
+            reader.fail();
+            return;
+        }
+        _authenticated = true;
+        _send(std::move(_reply(request)
+                            .write(protocol_version)
+                            .write(device->compute_warp_size())
+                            .write_string(device->backend_name())));
+    }
+
+    // returns false to drop the client, as does a failed reader
+    [[nodiscard]] bool _destroy(Resource::Tag tag, RemoteReader &reader) noexcept {
+        auto device = _device_impl();
+        auto handle = reader.read<uint64_t>();
+        if (reader.failed() || !_resources.remove(tag, handle)) { return false; }
+        switch (tag) {
+            case Resource::Tag::BUFFER: device->destroy_buffer(handle); break;
+            case Resource::Tag::TEXTURE: device->destroy_texture(handle); break;
+            case Resource::Tag::BINDLESS_ARRAY: device->destroy_bindless_array(handle); break;
+            case Resource::Tag::MESH: device->destroy_mesh(handle); break;
+            case Resource::Tag::PROCEDURAL_PRIMITIVE: device->destroy_procedural_primitive(handle); break;
+            case Resource::Tag::ACCEL: device->destroy_accel(handle); break;
+            case Resource::Tag::SHADER: {
+                device->destroy_shader(handle);
+                _kernels.erase(handle);
+                break;
+            }
+            case Resource::Tag::STREAM: {
+                device->destroy_stream(handle);
+                std::scoped_lock lock{_progress_mutex};
+                _submitted.erase(handle);
+                _completed.erase(handle);
+                break;
+            }
+            case Resource::Tag::EVENT: {
+                device->destroy_event(handle);
+                std::scoped_lock lock{_progress_mutex};
+                _signals.erase(handle);
+                break;
+            }
+            default: return false;
+        }
+        return true;
+    }
+
+    // registers a created resource and replies with its handle
+    void _created(Resource::Tag tag, uint64_t request, const ResourceCreationInfo &info) noexcept {
+        if (info.valid()) { _resources.add(tag, info.handle); }
+        _send(std::move(_reply(request).write(info.handle)));
+    }
+
+    // returns false to drop the client, as does a failed reader
+    [[nodiscard]] bool _handle(const RemoteMessageHeader &header, RemoteReader &reader) noexcept {
+        auto device = _device_impl();
+        auto request = header.request;
+        if (header.op == RemoteOp::HELLO) {
+            if (_authenticated) { return false; }
+            _hello(request, reader);
+            return true;
+        }
+        if (!_authenticated) { return false; }
+        switch (header.op) {
+            case RemoteOp::CREATE_BUFFER: {
+                auto desc = reader.read_string();
+                auto count = reader.read<size_t>();
+                if (reader.failed()) { return false; }
+                auto type = desc.empty() ? nullptr : Type::from(desc);
+                auto info = device->create_buffer(type, count);
+                if (info.valid()) { _resources.add_buffer(info.handle, info.total_size_bytes); }
+                _send(std::move(_reply(request)
+                                    .write(info.handle)
+                                    .write(info.element_stride)
+                                    .write(info.total_size_bytes)));
+                return true;
+            }
+            case RemoteOp::DESTROY_BUFFER: return _destroy(Resource::Tag::BUFFER, reader);
+            case RemoteOp::CREATE_TEXTURE: {
+                auto format = reader.read<PixelFormat>();
+                auto dimension = reader.read<uint>();
+                auto size = reader.read<uint3>();
+                auto mipmap_levels = reader.read<uint>();
+                auto simultaneous_access = reader.read<bool>();
+                if (reader.failed() ||
+                    luisa::to_underlying(format) >= pixel_format_count ||
+                    (dimension != 2u && dimension != 3u) ||
+                    size.x == 0u || size.y == 0u || size.z == 0u ||
+                    (dimension == 2u && size.z != 1u) ||
+                    mipmap_levels == 0u || mipmap_levels > 32u) { return false; }
+                auto info = device->create_texture(format, dimension, size.x, size.y, size.z,
+                                                   mipmap_levels, simultaneous_access);
+                if (info.valid()) {
+                    _resources.add_texture(info.handle, RemoteResourceTable::Texture{
+                                                            .storage = pixel_format_to_storage(format),
+                                                            .size = size,
+                                                            .levels = mipmap_levels});
+                }
+                _send(std::move(_reply(request).write(info.handle)));
+                return true;
+            }
+            case RemoteOp::DESTROY_TEXTURE: return _destroy(Resource::Tag::TEXTURE, reader);
+            case RemoteOp::CREATE_BINDLESS_ARRAY: {
+                auto size = reader.read<size_t>();
+                if (reader.failed() || size == 0u) { return false; }
+                auto info = device->create_bindless_array(size);
+                if (info.valid()) { _resources.add_bindless_array(info.handle, size); }
+                _send(std::move(_reply(request).write(info.handle)));
+                return true;
+            }
+            case RemoteOp::DESTROY_BINDLESS_ARRAY: return _destroy(Resource::Tag::BINDLESS_ARRAY, reader);
+            case RemoteOp::CREATE_STREAM: {
+                auto tag = reader.read<StreamTag>();
+                if (reader.failed() || tag > StreamTag::CUSTOM) { return false; }
+                _created(Resource::Tag::STREAM, request, device->create_stream(tag));
+                return true;
+            }
+            case RemoteOp::DESTROY_STREAM: return _destroy(Resource::Tag::STREAM, reader);
+            case RemoteOp::SYNCHRONIZE_STREAM: {
+                auto stream = reader.read<uint64_t>();
+                if (!_resources.contains(Resource::Tag::STREAM, stream)) { return false; }
+                device->synchronize_stream(stream);
+                // backends may run callbacks after the stream is idle
+                _wait_progress(stream, _submitted_count(stream));
+                _send(_reply(request));
+                return true;
+            }
+            case RemoteOp::DISPATCH: _dispatch(request, reader); return true;
+            case RemoteOp::CREATE_SHADER: _create_shader(request, reader); return true;
+            case RemoteOp::LOAD_SHADER: _load_shader(request, reader); return true;
+            case RemoteOp::DESTROY_SHADER: return _destroy(Resource::Tag::SHADER, reader);
+            case RemoteOp::CREATE_EVENT: _created(Resource::Tag::EVENT, request, device->create_event()); return true;
+            case RemoteOp::DESTROY_EVENT: return _destroy(Resource::Tag::EVENT, reader);
+            case RemoteOp::SIGNAL_EVENT: {
+                auto handle = reader.read<uint64_t>();
+                auto stream = reader.read<uint64_t>();
+                auto fence = reader.read<uint64_t>();
+                if (!_resources.contains(Resource::Tag::EVENT, handle) ||
+                    !_resources.contains(Resource::Tag::STREAM, stream)) { return false; }
+                {
+                    std::scoped_lock lock{_progress_mutex};
+                    _signals[handle].insert_or_assign(fence, SignalRecord{stream, _submitted[stream]});
+                }
+                device->signal_event(handle, stream, fence);
+                return true;
+            }
+            case RemoteOp::WAIT_EVENT: {
+                auto handle = reader.read<uint64_t>();
+                auto stream = reader.read<uint64_t>();
+                auto fence = reader.read<uint64_t>();
+                if (!_resources.contains(Resource::Tag::EVENT, handle) ||
+                    !_resources.contains(Resource::Tag::STREAM, stream)) { return false; }
+                device->wait_event(handle, stream, fence);
+                return true;
+            }
+            case RemoteOp::IS_EVENT_COMPLETED: {
+                auto handle = reader.read<uint64_t>();
+                auto fence = reader.read<uint64_t>();
+                if (!_resources.contains(Resource::Tag::EVENT, handle)) { return false; }
+                auto completed = device->is_event_completed(handle, fence);
+                if (completed) {
+                    if (auto signal = _find_signal(handle, fence)) {
+                        std::scoped_lock lock{_progress_mutex};
+                        completed = _completed[signal->stream] >= signal->dispatch_count;
+                    }
+                }
+                _send(std::move(_reply(request).write(completed)));
+                return true;
+            }
+            case RemoteOp::SYNCHRONIZE_EVENT: {
+                auto handle = reader.read<uint64_t>();
+                auto fence = reader.read<uint64_t>();
+                if (!_resources.contains(Resource::Tag::EVENT, handle)) { return false; }
+                device->synchronize_event(handle, fence);
+                if (auto signal = _find_signal(handle, fence)) {
+                    _wait_progress(signal->stream, signal->dispatch_count);
+                    // earlier fences are covered from now on
+                    std::scoped_lock lock{_progress_mutex};
+                    auto &&records = _signals[handle];
+                    records.erase(records.begin(), records.lower_bound(fence));
+                }
+                _send(_reply(request));
+                return true;
+            }
+            case RemoteOp::CREATE_MESH: {
+                auto option = reader.read<AccelOption>();
+                if (reader.failed() || !_valid_accel_option(option)) { return false; }
+                _created(Resource::Tag::MESH, request, device->create_mesh(option));
+                return true;
+            }
+            case RemoteOp::DESTROY_MESH: return _destroy(Resource::Tag::MESH, reader);
+            case RemoteOp::CREATE_PROCEDURAL_PRIMITIVE: {
+                auto option = reader.read<AccelOption>();
+                if (reader.failed() || !_valid_accel_option(option)) { return false; }
+                _created(Resource::Tag::PROCEDURAL_PRIMITIVE, request, device->create_procedural_primitive(option));
+                return true;
+            }
+            case RemoteOp::DESTROY_PROCEDURAL_PRIMITIVE: return _destroy(Resource::Tag::PROCEDURAL_PRIMITIVE, reader);
+            case RemoteOp::CREATE_ACCEL: {
+                auto option = reader.read<AccelOption>();
+                if (reader.failed() || !_valid_accel_option(option)) { return false; }
+                _created(Resource::Tag::ACCEL, request, device->create_accel(option));
+                return true;
+            }
+            case RemoteOp::DESTROY_ACCEL: return _destroy(Resource::Tag::ACCEL, reader);
+            case RemoteOp::SET_NAME: {
+                auto tag = reader.read<Resource::Tag>();
+                auto handle = reader.read<uint64_t>();
+                auto name = reader.read_string();
+                if (reader.failed() || !_resources.contains(tag, handle)) { return false; }
+                device->set_name(tag, handle, name);
+                return true;
+            }
+            case RemoteOp::QUERY: {
+                auto result = device->query(reader.read_string());
+                _send(std::move(_reply(request).write_string(result)));
+                return true;
+            }
+            default: break;
+        }
+        return false;
+    }
+
+public:
+    RemoteSession(Context &context, luisa::string_view backend,
+                  RemoteSocket socket, luisa::string token) noexcept
+        : _socket{std::move(socket)},
+          _token{std::move(token)},
+          _device{context.create_device(backend)} {}
+
+    void run() noexcept {
+        luisa::vector<std::byte> payload;
+        for (;;) {
+            RemoteMessageHeader header{};
+            if (!_socket.receive(&header, sizeof(header))) { break; }
+            // nothing is allocated for clients that have not presented the token yet
+            auto max_size = _authenticated ? remote_max_message_size : remote_max_hello_size;
+            if (header.size > max_size) {
+                LUISA_WARNING("Dropping remote client after an oversized message "
+                              "(op = {}, size = {}).",
+                              luisa::to_underlying(header.op), header.size);
+                break;
+            }
+            payload.resize(header.size);
+            if (!_socket.receive(payload.data(), payload.size())) { break; }
+            RemoteReader reader{payload};
+            if (!_handle(header, reader) || reader.failed()) {
+                LUISA_WARNING("Dropping remote client after an invalid request (op = {}).",
+                              luisa::to_underlying(header.op));
+                break;
+            }
+        }
+        _socket.shutdown();
+    }
+};
+
+void print_usage(const char *program) noexcept {
+    LUISA_INFO("Usage: {} --backend <backend> [--address <tcp://host:port | unix:///path>] "
+               "[--allow-external] [--once]. The address defaults to tcp://127.0.0.1:17385; "
+               "addresses other than loopback or unix sockets need --allow-external and a "
+               "token in LUISA_REMOTE_TOKEN, which clients must present in the same variable.",
+               program);
+}
+
+}// namespace
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    luisa::string backend;
+    luisa::string address{"tcp://127.0.0.1:17385"};
+    auto allow_external = false;
+    auto once = false;
+    for (auto i = 1; i < argc; i++) {
+        luisa::string_view arg{argv[i]};
+        if (arg == "--backend" && i + 1 < argc) {
+            backend = argv[++i];
+        } else if (arg == "--address" && i + 1 < argc) {
+            address = argv[++i];
+        } else if (arg == "--allow-external") {
+            allow_external = true;
+        } else if (arg == "--once") {
+            once = true;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (backend.empty() || backend == "remote") {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // read from the environment rather than the command line, which other users may see
+    luisa::string token;
+    if (auto env = std::getenv("LUISA_REMOTE_TOKEN")) { token = env; }
+
+    Context context{argv[0]};
+    auto listener = RemoteSocket::listen(address);
+    if (!listener) {
+        LUISA_WARNING("Failed to listen on '{}'.", address);
+        return 1;
+    }
+    // clients run arbitrary kernels on the hosted device, so it is
+    // only exposed beyond this machine when asked for and with a token
+    if (!listener.is_local()) {
+        if (!allow_external) {
+            LUISA_WARNING("Refusing to listen on '{}', which is reachable from other machines, "
+                          "without --allow-external.",
+                          address);
+            return 1;
+        }
+        if (token.empty()) {
+            LUISA_WARNING("Listening on '{}' requires a token in LUISA_REMOTE_TOKEN.", address);
+            return 1;
+        }
+    }
+    LUISA_INFO("Serving '{}' devices on '{}'{}.", backend, address,
+               token.empty() ? "" : " (token required)");
+    for (;;) {
+        auto client = listener.accept();
+        if (!client) { continue; }
+        if (once) {
+            // launched by a client for its own use, exit with it
+            RemoteSession{context, backend, std::move(client), token}.run();
+            break;
+        }
+        std::thread{[context, backend, token, client = std::move(client)]() mutable noexcept {
+            RemoteSession{context, backend, std::move(client), std::move(token)}.run();
+        }}.detach();
+    }
+}
@@ -0,0 +1,295 @@
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <luisa/core/logging.h>
+#include "remote_socket.h"
+
+namespace luisa::compute::remote {
+
+namespace detail {
+
+#ifdef _WIN32
+static constexpr auto invalid_socket = static_cast<RemoteSocket::native_type>(INVALID_SOCKET);
+inline void close_socket(RemoteSocket::native_type s) noexcept { ::closesocket(static_cast<SOCKET>(s)); }
+#else
+static constexpr auto invalid_socket = -1;
+inline void close_socket(RemoteSocket::native_type s) noexcept { ::close(s); }
+#endif
+
+static void initialize_sockets() noexcept {
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+#ifdef _WIN32
+        WSADATA data{};
+        if (auto ret = WSAStartup(MAKEWORD(2, 2), &data); ret != 0) {
+            LUISA_WARNING_WITH_LOCATION("Failed to initialize Winsock (error {}).", ret);
+        }
+#else
+        // a peer going away must surface as a failed send rather than a signal
+        std::signal(SIGPIPE, SIG_IGN);
+#endif
+    });
+}
+
+struct ParsedAddress {
+    bool is_tcp{false};
+    luisa::string host;
+    luisa::string port;
+    luisa::string path;
+};
+
+[[nodiscard]] static bool parse_address(luisa::string_view address, ParsedAddress &parsed) noexcept {
+    using namespace std::string_view_literals;
+    if (address.starts_with("unix://"sv)) {
+        parsed.path = address.substr(7u);
+        return !parsed.path.empty() && parsed.path.size() < sizeof(sockaddr_un::sun_path);
+    }
+    if (address.starts_with("tcp://"sv)) { address.remove_prefix(6u); }
+    auto colon = address.rfind(':');
+    if (colon == luisa::string_view::npos) { return false; }
+    parsed.is_tcp = true;
+    parsed.host = address.substr(0u, colon);
+    parsed.port = address.substr(colon + 1u);
+    // strip brackets around IPv6 literals
+    if (parsed.host.size() >= 2u && parsed.host.front() == '[' && parsed.host.back() == ']') {
+        parsed.host = parsed.host.substr(1u, parsed.host.size() - 2u);
+    }
+    return !parsed.port.empty();
+}
+
+[[nodiscard]] static sockaddr_un make_unix_address(luisa::string_view path) noexcept {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    return addr;
+}
+
+[[nodiscard]] static bool is_loopback(const sockaddr *addr) noexcept {
+    if (addr->sa_family == AF_INET) {
+        auto ip = ntohl(reinterpret_cast<const sockaddr_in *>(addr)->sin_addr.s_addr);
+        return (ip >> 24u) == 127u;
+    }
+    if (addr->sa_family == AF_INET6) {
+        auto &&ip = reinterpret_cast<const sockaddr_in6 *>(addr)->sin6_addr;
+        // also accepts IPv4-mapped loopback addresses
+        return IN6_IS_ADDR_LOOPBACK(&ip) ||
+               (IN6_IS_ADDR_V4MAPPED(&ip) && reinterpret_cast<const uint8_t *>(&ip)[12] == 127u);
+    }
+    return false;
+}
+
+static void set_no_delay(RemoteSocket::native_type s) noexcept {
+    // messages are batched by the sender, so Nagle only adds latency
+    int flag = 1;
+    ::setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&flag), sizeof(flag));
+}
+
+}// namespace detail
+
+RemoteSocket::RemoteSocket() noexcept : _socket{detail::invalid_socket} {}
+
+RemoteSocket::RemoteSocket(native_type s, bool is_tcp) noexcept
+    : _socket{s}, _is_tcp{is_tcp} {}
+
+RemoteSocket::~RemoteSocket() noexcept { close(); }
+
+RemoteSocket::RemoteSocket(RemoteSocket &&another) noexcept
+    : _socket{std::exchange(another._socket, detail::invalid_socket)},
+      _is_tcp{another._is_tcp},
+      _is_local{another._is_local},
+      _unix_path{std::move(another._unix_path)} {}
+
+RemoteSocket &RemoteSocket::operator=(RemoteSocket &&rhs) noexcept {
+    if (this != &rhs) {
+        close();
+        _socket = std::exchange(rhs._socket, detail::invalid_socket);
+        _is_tcp = rhs._is_tcp;
+        _is_local = rhs._is_local;
+        _unix_path = std::move(rhs._unix_path);
+    }
+    return *this;
+}
+
+bool RemoteSocket::valid() const noexcept { return _socket != detail::invalid_socket; }
+
+RemoteSocket RemoteSocket::connect(luisa::string_view address) noexcept {
+    detail::initialize_sockets();
+    detail::ParsedAddress parsed;
+    if (!detail::parse_address(address, parsed)) {
+        LUISA_WARNING_WITH_LOCATION("Invalid remote address '{}'.", address);
+        return {};
+    }
+    if (!parsed.is_tcp) {
+        auto s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (s == detail::invalid_socket) { return {}; }
+        auto addr = detail::make_unix_address(parsed.path);
+        if (::connect(s, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) {
+            detail::close_socket(s);
+            return {};
+        }
+        return RemoteSocket{static_cast<native_type>(s), false};
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    if (::getaddrinfo(parsed.host.c_str(), parsed.port.c_str(), &hints, &result) != 0) { return {}; }
+    RemoteSocket socket;
+    for (auto p = result; p != nullptr; p = p->ai_next) {
+        auto s = ::socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+        if (s == detail::invalid_socket) { continue; }
+        if (::connect(s, p->ai_addr, static_cast<int>(p->ai_addrlen)) == 0) {
+            detail::set_no_delay(s);
+            socket = RemoteSocket{static_cast<native_type>(s), true};
+            break;
+        }
+        detail::close_socket(s);
+    }
+    ::freeaddrinfo(result);
+    return socket;
+}
+
+RemoteSocket RemoteSocket::listen(luisa::string_view address) noexcept {
+    detail::initialize_sockets();
+    detail::ParsedAddress parsed;
+    if (!detail::parse_address(address, parsed)) {
+        LUISA_WARNING_WITH_LOCATION("Invalid remote address '{}'.", address);
+        return {};
+    }
+    if (!parsed.is_tcp) {
+        auto s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (s == detail::invalid_socket) { return {}; }
+        auto addr = detail::make_unix_address(parsed.path);
+        // remove the stale socket file left by a crashed server
+#ifdef _WIN32
+        ::DeleteFileA(parsed.path.c_str());
+#else
+        ::unlink(parsed.path.c_str());
+#endif
+        if (::bind(s, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) {
+            detail::close_socket(s);
+            return {};
+        }
+#ifndef _WIN32
+        // only the owner may connect
+        ::chmod(parsed.path.c_str(), S_IRUSR | S_IWUSR);
+#endif
+        if (::listen(s, SOMAXCONN) != 0) {
+            detail::close_socket(s);
+            return {};
+        }
+        RemoteSocket socket{static_cast<native_type>(s), false};
+        socket._is_local = true;
+        socket._unix_path = parsed.path;
+        return socket;
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo *result = nullptr;
+    auto host = parsed.host.empty() ? nullptr : parsed.host.c_str();
+    if (::getaddrinfo(host, parsed.port.c_str(), &hints, &result) != 0) { return {}; }
+    RemoteSocket socket;
+    for (auto p = result; p != nullptr; p = p->ai_next) {
+        auto s = ::socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+        if (s == detail::invalid_socket) { continue; }
+        int reuse = 1;
+        ::setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+        if (::bind(s, p->ai_addr, static_cast<int>(p->ai_addrlen)) == 0 &&
+            ::listen(s, SOMAXCONN) == 0) {
+            socket = RemoteSocket{static_cast<native_type>(s), true};
+            socket._is_local = detail::is_loopback(p->ai_addr);
+            break;
+        }
+        detail::close_socket(s);
+    }
+    ::freeaddrinfo(result);
+    return socket;
+}
+
+RemoteSocket RemoteSocket::accept() const noexcept {
+    auto s = ::accept(_socket, nullptr, nullptr);
+    if (s == detail::invalid_socket) { return {}; }
+    if (_is_tcp) { detail::set_no_delay(s); }
+    return RemoteSocket{static_cast<native_type>(s), _is_tcp};
+}
+
+bool RemoteSocket::send(const void *data, size_t size) noexcept {
+    auto p = static_cast<const char *>(data);
+    while (size != 0u) {
+        // keep each call below INT_MAX for Winsock
+        auto chunk = static_cast<int>(std::min<size_t>(size, 1u << 30u));
+#ifdef _WIN32
+        auto n = ::send(_socket, p, chunk, 0);
+#else
+        auto n = ::send(_socket, p, chunk, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) { continue; }
+#endif
+        if (n <= 0) { return false; }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool RemoteSocket::receive(void *data, size_t size) noexcept {
+    auto p = static_cast<char *>(data);
+    while (size != 0u) {
+        auto chunk = static_cast<int>(std::min<size_t>(size, 1u << 30u));
+        auto n = ::recv(_socket, p, chunk, 0);
+#ifndef _WIN32
+        if (n < 0 && errno == EINTR) { continue; }
+#endif
+        if (n <= 0) { return false; }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void RemoteSocket::shutdown() noexcept {
+    if (valid()) {
+#ifdef _WIN32
+        ::shutdown(_socket, SD_BOTH);
+#else
+        ::shutdown(_socket, SHUT_RDWR);
+#endif
+    }
+}
+
+void RemoteSocket::close() noexcept {
+    if (valid()) {
+        detail::close_socket(_socket);
+        _socket = detail::invalid_socket;
+    }
+    if (!_unix_path.empty()) {
+#ifdef _WIN32
+        ::DeleteFileA(_unix_path.c_str());
+#else
+        ::unlink(_unix_path.c_str());
+#endif
+        _unix_path.clear();
+    }
+}
+
+}// namespace luisa::compute::remote
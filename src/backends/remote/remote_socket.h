@@ -0,0 +1,55 @@
+#pragma once
+
+#include <luisa/core/basic_types.h>
+#include <luisa/core/stl/string.h>
+
+namespace luisa::compute::remote {
+
+// A blocking stream socket bound to either `tcp://host:port` or `unix:///path`.
+// Sending and receiving may happen concurrently on different threads.
+class RemoteSocket {
+
+public:
+#ifdef _WIN32
+    using native_type = uint64_t;
+#else
+    using native_type = int;
+#endif
+
+private:
+    native_type _socket;
+    bool _is_tcp{false};
+    bool _is_local{false};
+    luisa::string _unix_path;// unlinked when a listening socket is closed
+
+private:
+    RemoteSocket(native_type s, bool is_tcp) noexcept;
+
+public:
+    RemoteSocket() noexcept;
+    ~RemoteSocket() noexcept;
+    RemoteSocket(RemoteSocket &&another) noexcept;
+    RemoteSocket &operator=(RemoteSocket &&rhs) noexcept;
+    RemoteSocket(const RemoteSocket &) noexcept = delete;
+    RemoteSocket &operator=(const RemoteSocket &) noexcept = delete;
+
+    // returns an invalid socket on failure
+    [[nodiscard]] static RemoteSocket connect(luisa::string_view address) noexcept;
+    [[nodiscard]] static RemoteSocket listen(luisa::string_view address) noexcept;
+    [[nodiscard]] RemoteSocket accept() const noexcept;
+
+    [[nodiscard]] bool valid() const noexcept;
+    [[nodiscard]] explicit operator bool() const noexcept { return valid(); }
+    [[nodiscard]] auto is_tcp() const noexcept { return _is_tcp; }
+    // whether a listening socket is only reachable from this machine (unix or loopback)
+    [[nodiscard]] auto is_local() const noexcept { return _is_local; }
+
+    // return false if the connection is closed
+    [[nodiscard]] bool send(const void *data, size_t size) noexcept;
+    [[nodiscard]] bool receive(void *data, size_t size) noexcept;
+    // wakes up the threads blocked in send/receive
+    void shutdown() noexcept;
+    void close() noexcept;
+};
+
+}// namespace luisa::compute::remote
@@ -0,0 +1,29 @@
+target("lc-remote-common")
+_config_project({
+	project_kind = "object"
+})
+add_deps("lc-runtime")
+add_files("remote_protocol.cpp", "remote_socket.cpp", "remote_commands.cpp")
+if is_plat("windows") then
+	add_syslinks("Ws2_32", {
+		public = true
+	})
+end
+target_end()
+
+target("lc-backend-remote")
+_config_project({
+	project_kind = "shared"
+})
+add_deps("lc-runtime", "lc-ast", "lc-remote-common")
+add_files("remote_device.cpp")
+add_headerfiles("*.h")
+target_end()
+
+target("lc-remote-server")
+_config_project({
+	project_kind = "binary"
+})
+add_deps("lc-runtime", "lc-ast", "lc-remote-common")
+add_files("remote_server.cpp")
+target_end()
@@ -17,6 +17,7 @@
 #include <luisa/core/logging.h>
 #include <luisa/runtime/rhi/command.h>
 #include <luisa/backends/ext/registry.h>
+#include <cstdlib>
 namespace lc::validation {
 static vstd::unordered_map<uint64_t, StreamOption> stream_options;
 static std::mutex stream_mtx;
@@ -24,6 +25,15 @@ static std::mutex stream_mtx;
 Device::Device(Context &&ctx, luisa::shared_ptr<DeviceInterface> &&native) noexcept
     : DeviceInterface{std::move(ctx)},
       _native{std::move(native)} {
+    // validate only every N-th command list of each stream, e.g. to
+    // keep the layer enabled under production load
+    if (auto env = std::getenv("LUISA_VALIDATION_SAMPLE_INTERVAL")) {
+        auto interval = std::strtoul(env, nullptr, 10);
+        _sample_interval = std::max<uint>(static_cast<uint>(interval), 1u);
+        if (_sample_interval > 1u) {
+            LUISA_INFO("Validating 1 in every {} command lists.", _sample_interval);
+        }
+    }
     auto raster_ext = static_cast<RasterExt *>(_native->extension(RasterExt::name));
     auto dstorage_ext = static_cast<DStorageExt *>(_native->extension(DStorageExt::name));
     if (raster_ext) {
@@ -142,8 +152,12 @@ void Device::synchronize_stream(uint64_t stream_handle) noexcept {
 void Device::dispatch(
     uint64_t stream_handle, CommandList &&list) noexcept {
     auto str = RWResource::get<Stream>(stream_handle);
-    str->dispatch(_native.get(), list);
-    str->check_compete();
+    if (str->sample(_sample_interval)) {
+        str->dispatch(_native.get(), list);
+        str->check_compete();
+    } else {
+        str->track(list);
+    }
     list._callbacks.emplace(
         list._callbacks.begin(),
         [str, executed_layer = str->executed_layer()]() {
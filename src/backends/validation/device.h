@@ -29,6 +29,7 @@ class Device : public DeviceInterface, public vstd::IOperatorNewBase {
 
 private:
     luisa::shared_ptr<DeviceInterface> _native;
+    uint _sample_interval{1u};
     using ExtPtr = vstd::unique_ptr<DeviceExtension, detail::ext_deleter<DeviceExtension>>;
     vstd::unordered_map<vstd::string, ExtPtr> exts;
 
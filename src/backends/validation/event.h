@@ -1,6 +1,7 @@
 #pragma once
 #include "rw_resource.h"
 #include <luisa/vstl/common.h>
+#include <mutex>
 namespace lc::validation {
 class Stream;
 class Event : public RWResource {
@@ -9,6 +10,7 @@ public:
         uint64_t event_fence;
         uint64_t stream_fence;
     };
+    std::mutex mtx;
     vstd::unordered_map<Stream *, Signaled> signaled;
     Event(uint64_t handle) : RWResource{handle, Tag::EVENT, false} {}
     void sync(uint64_t fence);
@@ -1,12 +1,21 @@
 #pragma once
 #include <stdint.h>
 #include <numeric>
+#include <utility>
+#include <luisa/core/stl/map.h>
+#include <luisa/core/stl/optional.h>
 namespace lc::validation {
 struct Range {
     uint64_t min;
     uint64_t max;
     Range() : min{0}, max{std::numeric_limits<uint64_t>::max()} {}
     Range(uint64_t min, uint64_t size) : min{min}, max{min + size} {}
+    static Range bounds(uint64_t min, uint64_t max) {
+        Range r;
+        r.min = min;
+        r.max = max;
+        return r;
+    }
     static bool collide(Range const& l, Range const &r) {
         return l.min < r.max && r.min < l.max;
     }
@@ -15,4 +24,60 @@ struct Range {
     }
     bool operator!=(Range const &r) const { return !operator==(r); }
 };
+// Interval tree of disjoint ranges ordered by their lower bound. Insertion
+// coalesces every overlapping or adjacent node, so a node can only collide
+// with its in-order neighbours and both operations are O(log n).
+class RangeSet {
+    // min -> max
+    luisa::map<uint64_t, uint64_t> _nodes;
+
+public:
+    // the first recorded range colliding with `range`, if any
+    luisa::optional<Range> collide(Range const &range) const {
+        if (range.min >= range.max) return luisa::nullopt;
+        auto iter = _nodes.upper_bound(range.min);
+        if (iter != _nodes.begin()) {
+            auto prev = std::prev(iter);
+            if (prev->second > range.min) return Range::bounds(prev->first, prev->second);
+        }
+        if (iter != _nodes.end() && iter->first < range.max) {
+            return Range::bounds(iter->first, iter->second);
+        }
+        return luisa::nullopt;
+    }
+    // a pair of colliding ranges of the two sets, if any; queries the larger set with
+    // every range of the smaller one
+    luisa::optional<std::pair<Range, Range>> collide(RangeSet const &other) const {
+        auto const &small = _nodes.size() <= other._nodes.size() ? *this : other;
+        auto const &large = &small == this ? other : *this;
+        for (auto &&i : small._nodes) {
+            auto range = Range::bounds(i.first, i.second);
+            if (auto collided = large.collide(range)) {
+                if (&small == this) return std::pair{range, *collided};
+                return std::pair{*collided, range};
+            }
+        }
+        return luisa::nullopt;
+    }
+    void insert(Range range) {
+        if (range.min >= range.max) return;
+        auto iter = _nodes.upper_bound(range.min);
+        if (iter != _nodes.begin()) {
+            auto prev = std::prev(iter);
+            if (prev->second >= range.min) {
+                if (prev->second >= range.max) return;
+                range.min = prev->first;
+                iter = prev;
+            }
+        }
+        while (iter != _nodes.end() && iter->first <= range.max) {
+            range.max = std::max(range.max, iter->second);
+            iter = _nodes.erase(iter);
+        }
+        _nodes.emplace_hint(iter, range.min, range.max);
+    }
+    auto size() const { return _nodes.size(); }
+    auto empty() const { return _nodes.empty(); }
+    void clear() { _nodes.clear(); }
+};
 }// namespace lc::validation
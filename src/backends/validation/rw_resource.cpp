@@ -2,47 +2,61 @@
 #include "stream.h"
 #include <luisa/core/basic_traits.h>
 #include <luisa/core/logging.h>
+#include <array>
+#include <mutex>
 namespace lc::validation {
-static std::recursive_mutex mtx;
 struct ResMap {
-    vstd::unordered_map<uint64_t, RWResource *> map;
+    // handles are looked up for every command, so the map is sharded
+    // to keep streams on different threads from serializing on one lock
+    static constexpr size_t shard_count = 16;
+    struct Shard {
+        std::mutex mtx;
+        vstd::unordered_map<uint64_t, RWResource *> map;
+    };
+    std::array<Shard, shard_count> shards;
+    static size_t shard_index(uint64_t handle) {
+        // handles are usually pointers, mix the bits above the alignment
+        return ((handle >> 4u) ^ (handle >> 12u) ^ (handle >> 20u)) % shard_count;
+    }
+    Shard &shard(uint64_t handle) { return shards[shard_index(handle)]; }
     ~ResMap() {
-        std::lock_guard lck{mtx};
-        for (auto &&i : map) {
-            delete i.second;
+        for (auto &&s : shards) {
+            for (auto &&i : s.map) {
+                delete i.second;
+            }
+            s.map.clear();
         }
     }
 };
 static ResMap res_map;
 RWResource::RWResource(uint64_t handle, Tag tag, bool non_simultaneous)
     : Resource{tag}, _non_simultaneous{non_simultaneous}, _handle{handle} {
-    std::lock_guard lck{mtx};
-    res_map.map.force_emplace(handle, this);
+    auto &s = res_map.shard(handle);
+    std::lock_guard lck{s.mtx};
+    s.map.force_emplace(handle, this);
 }
 void RWResource::set_usage(Stream *stream, RWResource *res, Usage usage, Range range) {
-    std::lock_guard lck{mtx};
     if (usage == Usage::NONE) [[likely]]
         return;
+    // res_usages belongs to the submitting thread of the stream
     {
         auto iter = stream->res_usages.try_emplace(res);
         auto &ite_usage = iter.first->second;
         ite_usage.usage = static_cast<Usage>(luisa::to_underlying(ite_usage.usage) | luisa::to_underlying(usage));
-        [&] {
-            for (auto &&i : ite_usage.ranges) {
-                if (i == range) return;
-            }
-            ite_usage.ranges.emplace_back(range);
-        }();
+        ite_usage.ranges.insert(range);
     }
     {
+        std::lock_guard lck{res->_info_mtx};
         auto iter = res->_info.try_emplace(stream->handle());
         auto &info = iter.first->second;
         if (stream->executed_layer() > info.last_frame) {
             info.last_frame = stream->executed_layer();
             info.usage = usage;
+            info.ranges.clear();
         } else {
             info.usage = static_cast<Usage>(luisa::to_underlying(info.usage) | luisa::to_underlying(usage));
         }
+        info.ranges.insert(range);
     }
 }
 RWResource::~RWResource() {
@@ -55,17 +69,23 @@ RWResource::~RWResource() {
     _info.clear();
 }
 void RWResource::dispose(uint64_t handle) {
-    std::lock_guard lck{mtx};
-    auto iter = res_map.map.find(handle);
-    if (iter != res_map.map.end()) {
-        delete iter->second;
-        res_map.map.erase(iter);
+    RWResource *res{nullptr};
+    {
+        auto &s = res_map.shard(handle);
+        std::lock_guard lck{s.mtx};
+        auto iter = s.map.find(handle);
+        if (iter == s.map.end()) return;
+        res = iter->second;
+        s.map.erase(iter);
     }
+    // the destructor looks up streams, which may live in the same shard
+    delete res;
 }
 RWResource *RWResource::_get(uint64_t handle) {
-    std::lock_guard lck{mtx};
-    auto iter = res_map.map.find(handle);
-    if (iter != res_map.map.end()) {
+    auto &s = res_map.shard(handle);
+    std::lock_guard lck{s.mtx};
+    auto iter = s.map.find(handle);
+    if (iter != s.map.end()) {
         return iter->second;
     }
     return nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 #include "resource.h"
 #include <luisa/ast/usage.h>
+#include <luisa/core/spin_mutex.h>
 #include "range.h"
 namespace lc::validation {
 class Stream;
@@ -8,10 +9,14 @@ using namespace luisa::compute;
 struct RWInfo {
     Usage usage{Usage::NONE};
     uint64_t last_frame{0};
+    // accessed ranges in the last frame
+    RangeSet ranges;
 };
 class RWResource : public Resource {
     friend struct ResMap;
     vstd::unordered_map<uint64_t , RWInfo> _info;
+    // streams on different threads record their usages concurrently
+    mutable luisa::spin_mutex _info_mtx;
     bool _non_simultaneous;
     uint64_t _handle;
 
@@ -27,6 +32,7 @@ public:
     }
     auto non_simultaneous() const { return _non_simultaneous; }
     auto const &info() const { return _info; }
+    auto &info_mutex() const { return _info_mtx; }
     RWResource(RWResource &&) = delete;
     RWResource(RWResource const &) = delete;
     RWResource(uint64_t handle, Tag tag, bool non_simultaneous);
@@ -18,10 +18,9 @@
 
 namespace lc::validation {
 Stream::Stream(uint64_t handle, StreamTag stream_tag) : RWResource{handle, Tag::STREAM, false}, _stream_tag{stream_tag} {}
-std::recursive_mutex stream_global_lock;
 void Stream::signal(Event *evt, uint64_t fence) {
-    std::lock_guard lck{stream_global_lock};
-    evt->signaled.force_emplace(this, Event::Signaled{fence, _executed_layer});
+    std::lock_guard lck{evt->mtx};
+    evt->signaled.force_emplace(this, Event::Signaled{fence, executed_layer()});
 }
 uint64_t Stream::stream_synced_frame(Stream *stream) const {
     auto iter = waited_stream.find(stream);
@@ -32,7 +31,7 @@ uint64_t Stream::stream_synced_frame(Stream *stream) const {
     }
 }
 void Stream::wait(Event *evt, uint64_t fence) {
-    std::lock_guard lck{stream_global_lock};
+    std::scoped_lock lck{evt->mtx, _waited_mtx};
     for (auto &&i : evt->signaled) {
         if (fence >= i.second.event_fence) {
             waited_stream.force_emplace(i.first, i.second.stream_fence);
@@ -54,39 +53,45 @@ static vstd::string usage_name(Usage usage) {
 }
 }// namespace detail
 void Stream::check_compete() {
-    std::lock_guard lck{stream_global_lock};
+    std::lock_guard lck{_waited_mtx};
     for (auto &&iter : res_usages) {
         auto res = iter.first;
+        std::lock_guard info_lck{res->info_mutex()};
         for (auto &&stream_iter : res->info()) {
             auto other_stream = RWResource::get<Stream>(stream_iter.first);
             if (!other_stream || other_stream == this) continue;
             auto synced_frame = stream_synced_frame(other_stream);
-            if (stream_iter.second.last_frame > synced_frame) {
-                // Texture type
-                if (res->non_simultaneous()) {
-                    LUISA_ERROR(
-                        "Non simultaneous-accessible resource {} is not allowed to be {} by {} and {} by {} simultaneously.",
-                        res->get_name(),
-                        detail::usage_name(stream_iter.second.usage),
-                        other_stream->get_name(),
-                        detail::usage_name(iter.second.usage),
-                        get_name());
-                } else {
-                    LUISA_WARNING(
-                        "Simultaneous-accessible resource {} is used to be {} by {} and {} by {} simultaneously.",
-                        res->get_name(),
-                        detail::usage_name(stream_iter.second.usage),
-                        other_stream->get_name(),
-                        detail::usage_name(iter.second.usage),
-                        get_name());
-                }
+            if (stream_iter.second.last_frame <= synced_frame) continue;
+            // byte ranges of buffers and levels of textures used by both streams
+            auto collided = iter.second.ranges.collide(stream_iter.second.ranges);
+            if (!collided) continue;
+            // Texture type
+            if (res->non_simultaneous()) {
+                LUISA_ERROR(
+                    "Non simultaneous-accessible resource {} is not allowed to be {} by {} in range ({}, {}) and {} by {} in range ({}, {}) simultaneously.",
+                    res->get_name(),
+                    detail::usage_name(stream_iter.second.usage),
+                    other_stream->get_name(),
+                    collided->second.min, collided->second.max,
+                    detail::usage_name(iter.second.usage),
+                    get_name(),
+                    collided->first.min, collided->first.max);
+            } else {
+                LUISA_WARNING(
+                    "Simultaneous-accessible resource {} is used to be {} by {} in range ({}, {}) and {} by {} in range ({}, {}) simultaneously.",
+                    res->get_name(),
+                    detail::usage_name(stream_iter.second.usage),
+                    other_stream->get_name(),
+                    collided->second.min, collided->second.max,
+                    detail::usage_name(iter.second.usage),
+                    get_name(),
+                    collided->first.min, collided->first.max);
             }
         }
     }
 }
 void Stream::dispatch() {
-    std::lock_guard lck{stream_global_lock};
-    _executed_layer++;
+    _executed_layer.fetch_add(1u, std::memory_order_acq_rel);
     res_usages.clear();
 }
 void Stream::mark_shader_dispatch(DeviceInterface *dev, ShaderDispatchCommandBase *cmd, bool contain_bindings) {
@@ -210,15 +215,11 @@ void Stream::custom(DeviceInterface *dev, Command *cmd) {
         case to_underlying(CustomCommandUUID::DSTORAGE_READ): {
             auto c = static_cast<DStorageReadCommand *>(cmd);
             auto check_range = [&](uint64_t handle, Range range) -> vstd::optional<std::pair<Range, Range>> {
-                auto add_range = vstd::scope_exit([&] {
-                    dstorage_range_check.try_emplace(handle).first->second.emplace_back(range);
-                });
-                auto iter = dstorage_range_check.find(handle);
-                if (iter == dstorage_range_check.end()) return {};
-                for (auto &&i : iter->second) {
-                    if (Range::collide(i, range)) return std::pair<Range, Range>{i, range};
-                }
-                return {};
+                auto &ranges = dstorage_range_check.try_emplace(handle).first->second;
+                auto collided = ranges.collide(range);
+                ranges.insert(range);
+                if (!collided) return {};
+                return std::pair<Range, Range>{*collided, range};
             };
             luisa::visit(
                 [&](auto t) {
@@ -257,9 +258,50 @@ void Stream::custom(DeviceInterface *dev, Command *cmd) {
         default: break;
     }
 }
+void Stream::update_build_state(Command *cmd) {
+    using CmdTag = luisa::compute::Command::Tag;
+    switch (cmd->tag()) {
+        case CmdTag::EAccelBuildCommand: {
+            auto c = static_cast<AccelBuildCommand *>(cmd);
+            auto accel = RWResource::get<Accel>(c->handle());
+            if (c->update_instance_buffer_only()) {
+                if (!accel->init_build) [[unlikely]] {
+                    LUISA_ERROR("Accel should been fully build before any other operations.");
+                }
+            } else {
+                accel->init_build = true;
+            }
+            accel->modify(c->instance_count(), this, c->modifications());
+        } break;
+        case CmdTag::EMeshBuildCommand: {
+            auto c = static_cast<MeshBuildCommand *>(cmd);
+            auto mesh = RWResource::get<Mesh>(c->handle());
+            mesh->vert = RWResource::get<Buffer>(c->vertex_buffer());
+            mesh->index = RWResource::get<Buffer>(c->triangle_buffer());
+            mesh->vert_range = Range{c->vertex_buffer_offset(), c->vertex_buffer_size()};
+            mesh->index_range = Range{c->triangle_buffer_offset(), c->triangle_buffer_size()};
+        } break;
+        case CmdTag::EProceduralPrimitiveBuildCommand: {
+            auto c = static_cast<ProceduralPrimitiveBuildCommand *>(cmd);
+            auto prim = RWResource::get<ProceduralPrimitives>(c->handle());
+            prim->range = Range{c->aabb_buffer_offset(), c->aabb_buffer_size()};
+            prim->bbox = RWResource::get<Buffer>(c->aabb_buffer());
+        } break;
+        default: break;
+    }
+}
+bool Stream::sample(uint32_t interval) {
+    return interval <= 1u || _submitted_lists++ % interval == 0u;
+}
+void Stream::track(CommandList &cmd_list) {
+    // skipped lists are not checked, but later ones still need
+    // the geometry referenced by meshes and accels
+    for (auto &&cmd_ptr : cmd_list.commands()) {
+        update_build_state(cmd_ptr.get());
+    }
+}
 void Stream::dispatch(DeviceInterface *dev, CommandList &cmd_list) {
-    std::lock_guard lck{stream_global_lock};
-    _executed_layer++;
+    _executed_layer.fetch_add(1u, std::memory_order_acq_rel);
     res_usages.clear();
     dstorage_range_check.clear();
     using CmdTag = luisa::compute::Command::Tag;
@@ -319,33 +361,19 @@ void Stream::dispatch(DeviceInterface *dev, CommandList &cmd_list) {
             case CmdTag::EAccelBuildCommand: {
                 Device::check_stream(handle(), StreamFunc::Compute);
                 auto c = static_cast<AccelBuildCommand *>(cmd);
-                auto accel = RWResource::get<Accel>(c->handle());
-                if (c->update_instance_buffer_only()) {
-                    if (!accel->init_build) [[unlikely]] {
-                        LUISA_ERROR("Accel should been fully build before any other operations.");
-                    }
-                } else {
-                    accel->init_build = true;
-                }
-                accel->modify(c->instance_count(), this, c->modifications());
+                update_build_state(c);
                 mark_handle(c->handle(), Usage::WRITE, Range{});
             } break;
             case CmdTag::EMeshBuildCommand: {
                 Device::check_stream(handle(), StreamFunc::Compute);
                 auto c = static_cast<MeshBuildCommand *>(cmd);
-                auto mesh = RWResource::get<Mesh>(c->handle());
-                mesh->vert = RWResource::get<Buffer>(c->vertex_buffer());
-                mesh->index = RWResource::get<Buffer>(c->triangle_buffer());
-                mesh->vert_range = Range{c->vertex_buffer_offset(), c->vertex_buffer_size()};
-                mesh->index_range = Range{c->triangle_buffer_offset(), c->triangle_buffer_size()};
+                update_build_state(c);
                 mark_handle(c->handle(), Usage::WRITE, Range{});
             } break;
             case CmdTag::EProceduralPrimitiveBuildCommand: {
                 Device::check_stream(handle(), StreamFunc::Compute);
                 auto c = static_cast<ProceduralPrimitiveBuildCommand *>(cmd);
-                auto prim = RWResource::get<ProceduralPrimitives>(c->handle());
-                prim->range = Range{c->aabb_buffer_offset(), c->aabb_buffer_size()};
-                prim->bbox = RWResource::get<Buffer>(c->aabb_buffer());
+                update_build_state(c);
                 mark_handle(c->handle(), Usage::WRITE, Range{});
             } break;
             case CmdTag::EBindlessArrayUpdateCommand: {
@@ -371,33 +399,43 @@ void Stream::dispatch(DeviceInterface *dev, CommandList &cmd_list) {
     }
 }
 void Stream::sync_layer(uint64_t layer) {
-    std::lock_guard lck{stream_global_lock};
-    if (_synced_layer >= layer) return;
-    _synced_layer = layer;
-    for (auto &&i : waited_stream) {
+    auto synced = _synced_layer.load(std::memory_order_acquire);
+    do {
+        if (synced >= layer) return;
+    } while (!_synced_layer.compare_exchange_weak(synced, layer, std::memory_order_acq_rel));
+    // propagate without holding the lock, streams may have waited for each other
+    vstd::unordered_map<Stream *, uint64_t> waited;
+    {
+        std::lock_guard lck{_waited_mtx};
+        std::swap(waited, waited_stream);
+    }
+    for (auto &&i : waited) {
         i.first->sync_layer(i.second);
     }
-    waited_stream.clear();
 }
 void Stream::sync() {
-    sync_layer(_executed_layer);
+    sync_layer(executed_layer());
 }
 void Event::sync(uint64_t fence) {
-    std::lock_guard lck{stream_global_lock};
-    vstd::vector<Stream *> removed_stream;
-    for (auto &&i : signaled) {
-        if (fence >= i.second.event_fence) {
-            i.first->sync_layer(i.second.stream_fence);
-            removed_stream.emplace_back(i.first);
+    vstd::vector<std::pair<Stream *, uint64_t>> synced_stream;
+    {
+        std::lock_guard lck{mtx};
+        for (auto &&i : signaled) {
+            if (fence >= i.second.event_fence) {
+                synced_stream.emplace_back(i.first, i.second.stream_fence);
+            }
         }
-    }
-    if (removed_stream.size() == signaled.size()) {
-        signaled.clear();
-    } else {
-        for (auto &&i : removed_stream) {
-            signaled.erase(i);
+        if (synced_stream.size() == signaled.size()) {
+            signaled.clear();
+        } else {
+            for (auto &&i : synced_stream) {
+                signaled.erase(i.first);
+            }
         }
     }
+    for (auto &&i : synced_stream) {
+        i.first->sync_layer(i.second);
+    }
 }
 vstd::string Stream::stream_tag() const {
     switch (_stream_tag) {
@@ -4,6 +4,8 @@
 #include <luisa/vstl/common.h>
 #include <luisa/runtime/rhi/command.h>
 #include <luisa/runtime/command_list.h>
+#include <atomic>
+#include <mutex>
 #include "range.h"
 namespace lc::validation {
 using namespace luisa::compute;
@@ -12,7 +14,7 @@ class RWResource;
 class Stream;
 struct CompeteResource {
     Usage usage{Usage::NONE};
-    vstd::vector<Range> ranges;
+    RangeSet ranges;
 };
 
 class CustomDispatchArgumentVisitor;
@@ -23,24 +25,34 @@ class Stream : public RWResource {
 
 private:
     StreamTag _stream_tag;
-    uint64_t _executed_layer{0};
-    uint64_t _synced_layer{0};
+    // written by the submitting thread, read by other streams and completion callbacks
+    std::atomic<uint64_t> _executed_layer{0};
+    std::atomic<uint64_t> _synced_layer{0};
+    uint64_t _submitted_lists{0};
+    // guards waited_stream, which is cleared when any thread syncs this stream
+    std::mutex _waited_mtx;
     // other streams waiting for this stream
     vstd::unordered_map<Stream *, uint64_t> waited_stream;
-    vstd::unordered_map<uint64_t, vstd::vector<Range>> dstorage_range_check;
+    vstd::unordered_map<uint64_t, RangeSet> dstorage_range_check;
     uint64_t stream_synced_frame(Stream *stream) const;
     void mark_handle(uint64_t v, Usage usage, Range range);
     void custom(DeviceInterface *dev, Command *cmd);
     void mark_shader_dispatch(DeviceInterface *dev, ShaderDispatchCommandBase *cmd, bool contain_bindings);
+    void update_build_state(Command *cmd);
 
 public:
+    // only touched by the thread submitting to this stream
     vstd::unordered_map<RWResource *, CompeteResource> res_usages;
-    auto executed_layer() const { return _executed_layer; }
-    auto synced_layer() const { return _synced_layer; }
+    auto executed_layer() const { return _executed_layer.load(std::memory_order_acquire); }
+    auto synced_layer() const { return _synced_layer.load(std::memory_order_acquire); }
     vstd::string stream_tag() const;
     Stream(uint64_t handle, StreamTag stream_tag);
     void dispatch();
     void dispatch(DeviceInterface *dev, CommandList &cmd_list);
+    // whether the next command list is validated, when every `interval`-th one is
+    bool sample(uint32_t interval);
+    // keeps the resource state of an unvalidated command list up to date
+    void track(CommandList &cmd_list);
     void sync();
     void sync_layer(uint64_t layer);
     void signal(Event *evt, uint64_t fence);
@@ -0,0 +1,107 @@
+#include "bindless_array.h"
+#include "bindless_heap.h"
+#include "texture.h"
+#include "device.h"
+#include <luisa/core/logging.h>
+namespace lc::vk {
+BindlessArray::BindlessArray(Device *device, uint size)
+    : Resource{device},
+      _buffer{device, size * sizeof(BindlessStruct)} {
+    _binded.resize(size);
+}
+BindlessArray::~BindlessArray() {
+    auto &&buffer_heap = device()->bindless_buffer_heap();
+    auto &&texture_heap = device()->bindless_texture_heap();
+    for (auto &&i : _binded) {
+        if (i.buffer != BindlessStruct::n_pos) { buffer_heap.return_index(i.buffer); }
+        if (i.tex2D != BindlessStruct::n_pos) { texture_heap.return_index(i.tex2D & BindlessStruct::mask); }
+        if (i.tex3D != BindlessStruct::n_pos) { texture_heap.return_index(i.tex3D & BindlessStruct::mask); }
+    }
+    return_indices(device(), _retired);
+}
+void BindlessArray::bind(vstd::span<const BindlessArrayUpdateCommand::Modification> mods, BindlessStruct *slots) {
+    using Ope = BindlessArrayUpdateCommand::Modification::Operation;
+    std::lock_guard lck{_mtx};
+    auto &&buffer_heap = device()->bindless_buffer_heap();
+    auto &&texture_heap = device()->bindless_texture_heap();
+    auto alignment = device()->properties().limits.minStorageBufferOffsetAlignment;
+    auto retire_buffer = [&](uint &index) {
+        if (index != BindlessStruct::n_pos) {
+            _retired.buffers.emplace_back(index);
+            index = BindlessStruct::n_pos;
+        }
+    };
+    auto retire_texture = [&](uint &index) {
+        if (index != BindlessStruct::n_pos) {
+            _retired.textures.emplace_back(index & BindlessStruct::mask);
+            index = BindlessStruct::n_pos;
+        }
+    };
+    // 2D and 3D textures share the indices of one heap, and each index only holds views of its own dimension
+    auto emplace_texture = [&](uint &index, BindlessArrayUpdateCommand::Modification::Texture const &tex) {
+        retire_texture(index);
+        auto texture = reinterpret_cast<Texture const *>(tex.handle);
+        auto tex_index = texture_heap.allocate_index();
+        texture_heap.write_image(tex_index, texture->view());
+        auto sampler_index = luisa::to_underlying(tex.sampler.address()) * 4u +
+                             luisa::to_underlying(tex.sampler.filter());
+        index = tex_index | (sampler_index << 28u);
+    };
+    for (auto &&mod : mods) {
+        auto &slot = _binded[mod.slot];
+        switch (mod.buffer.op) {
+            case Ope::REMOVE:
+                retire_buffer(slot.buffer);
+                break;
+            case Ope::EMPLACE: {
+                retire_buffer(slot.buffer);
+                if (mod.buffer.offset_bytes % alignment != 0) [[unlikely]] {
+                    LUISA_ERROR_WITH_LOCATION(
+                        "Buffer offset {} in bindless array is not aligned to {} bytes required by the Vulkan device.",
+                        mod.buffer.offset_bytes, alignment);
+                }
+                auto buffer = reinterpret_cast<Buffer const *>(mod.buffer.handle);
+                auto index = buffer_heap.allocate_index();
+                buffer_heap.write_buffer(index, buffer->vk_buffer(), mod.buffer.offset_bytes);
+                slot.buffer = index;
+            } break;
+            default: break;
+        }
+        switch (mod.tex2d.op) {
+            case Ope::REMOVE:
+                retire_texture(slot.tex2D);
+                break;
+            case Ope::EMPLACE:
+                emplace_texture(slot.tex2D, mod.tex2d);
+                break;
+            default: break;
+        }
+        switch (mod.tex3d.op) {
+            case Ope::REMOVE:
+                retire_texture(slot.tex3D);
+                break;
+            case Ope::EMPLACE:
+                emplace_texture(slot.tex3D, mod.tex3d);
+                break;
+            default: break;
+        }
+    }
+    for (auto &&mod : mods) {
+        *slots++ = _binded[mod.slot];
+    }
+}
+BindlessArray::RetiredIndices BindlessArray::steal_retired_indices() {
+    std::lock_guard lck{_mtx};
+    auto indices = std::move(_retired);
+    _retired = {};
+    return indices;
+}
+void BindlessArray::return_indices(Device *device, RetiredIndices const &indices) {
+    for (auto &&i : indices.buffers) {
+        device->bindless_buffer_heap().return_index(i);
+    }
+    for (auto &&i : indices.textures) {
+        device->bindless_texture_heap().return_index(i);
+    }
+}
+}// namespace lc::vk
@@ -0,0 +1,47 @@
+#pragma once
+#include <mutex>
+#include "resource.h"
+#include "default_buffer.h"
+#include <luisa/runtime/rhi/command.h>
+namespace lc::vk {
+using namespace luisa::compute;
+class BindlessArray : public Resource {
+public:
+    // the same slot layout as the DirectX backend, read by the bindless functions of the HLSL codegen
+    struct BindlessStruct {
+        static constexpr auto n_pos = std::numeric_limits<uint>::max();
+        static constexpr auto mask = (1u << 28u) - 1;
+        uint buffer = n_pos;
+        uint tex2D = n_pos;
+        uint tex3D = n_pos;
+        void write_samp2d(uint tex, uint s) {
+            tex2D = tex | (s << 28);
+        }
+        void write_samp3d(uint tex, uint s) {
+            tex3D = tex | (s << 28);
+        }
+    };
+    // descriptor indices replaced by updates, which commands in flight may still read
+    struct RetiredIndices {
+        vstd::vector<uint> buffers;
+        vstd::vector<uint> textures;
+        bool empty() const { return buffers.empty() && textures.empty(); }
+    };
+
+private:
+    vstd::vector<BindlessStruct> _binded;
+    DefaultBuffer _buffer;
+    mutable std::mutex _mtx;
+    RetiredIndices _retired;
+
+public:
+    BindlessArray(Device *device, uint size);
+    ~BindlessArray();
+    auto buffer() const { return &_buffer; }
+    // writes the descriptors of the modifications and copies the modified slots to slots
+    void bind(vstd::span<const BindlessArrayUpdateCommand::Modification> mods, BindlessStruct *slots);
+    // the indices retired since the last call, to be returned to the heaps once the update completes
+    RetiredIndices steal_retired_indices();
+    static void return_indices(Device *device, RetiredIndices const &indices);
+};
+}// namespace lc::vk
@@ -0,0 +1,97 @@
+#include "bindless_heap.h"
+#include "device.h"
+#include "log.h"
+#include <luisa/core/logging.h>
+namespace lc::vk {
+BindlessHeap::BindlessHeap(Device *device, VkDescriptorType type, uint capacity)
+    : _device{device}, _type{type}, _capacity{capacity} {
+    // descriptors are written while the set is bound by commands in flight, and only the ones in use must be valid
+    VkDescriptorBindingFlags binding_flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                             VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_ci{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = 1,
+        .pBindingFlags = &binding_flags};
+    VkDescriptorSetLayoutBinding binding{
+        .binding = 0,
+        .descriptorType = type,
+        .descriptorCount = capacity,
+        .stageFlags = VK_SHADER_STAGE_ALL,
+        .pImmutableSamplers = nullptr};
+    VkDescriptorSetLayoutCreateInfo layout_ci{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &binding_flags_ci,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount = 1,
+        .pBindings = &binding};
+    VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device->logic_device(), &layout_ci, nullptr, &_layout));
+    VkDescriptorPoolSize pool_size{type, capacity};
+    VkDescriptorPoolCreateInfo pool_ci{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = 1,
+        .pPoolSizes = &pool_size};
+    VK_CHECK_RESULT(vkCreateDescriptorPool(device->logic_device(), &pool_ci, nullptr, &_pool));
+    VkDescriptorSetAllocateInfo alloc_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = _pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &_layout};
+    VK_CHECK_RESULT(vkAllocateDescriptorSets(device->logic_device(), &alloc_info, &_set));
+    // lower indices are handed out first
+    _free_indices.reserve(capacity);
+    for (auto i = capacity; i > 0; --i) {
+        _free_indices.emplace_back(i - 1);
+    }
+}
+BindlessHeap::~BindlessHeap() {
+    vkDestroyDescriptorPool(_device->logic_device(), _pool, nullptr);
+    vkDestroyDescriptorSetLayout(_device->logic_device(), _layout, nullptr);
+}
+uint BindlessHeap::allocate_index() {
+    std::lock_guard lck{_mtx};
+    if (_free_indices.empty()) [[unlikely]] {
+        LUISA_ERROR("Bindless descriptor heap of {} descriptors is full.", _capacity);
+    }
+    auto index = _free_indices.back();
+    _free_indices.pop_back();
+    return index;
+}
+void BindlessHeap::return_index(uint index) {
+    std::lock_guard lck{_mtx};
+    _free_indices.emplace_back(index);
+}
+void BindlessHeap::write_buffer(uint index, VkBuffer buffer, size_t offset) {
+    VkDescriptorBufferInfo info{
+        .buffer = buffer,
+        .offset = offset,
+        .range = VK_WHOLE_SIZE};
+    VkWriteDescriptorSet write{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = _set,
+        .dstBinding = 0,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = _type,
+        .pBufferInfo = &info};
+    // writes to the same set must be externally synchronized
+    std::lock_guard lck{_mtx};
+    vkUpdateDescriptorSets(_device->logic_device(), 1, &write, 0, nullptr);
+}
+void BindlessHeap::write_image(uint index, VkImageView view) {
+    VkDescriptorImageInfo info{
+        .imageView = view,
+        .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+    VkWriteDescriptorSet write{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = _set,
+        .dstBinding = 0,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = _type,
+        .pImageInfo = &info};
+    std::lock_guard lck{_mtx};
+    vkUpdateDescriptorSets(_device->logic_device(), 1, &write, 0, nullptr);
+}
+}// namespace lc::vk
@@ -0,0 +1,33 @@
+#pragma once
+#include <mutex>
+#include <vulkan/vulkan.h>
+#include <luisa/vstl/common.h>
+namespace lc::vk {
+class Device;
+// a device-wide descriptor array indexed by the slots of bindless arrays,
+// bound as the "bdls[]" or "_BindlessTex[]" / "_BindlessTex3D[]" space of every shader using them
+class BindlessHeap : public vstd::IOperatorNewBase {
+    Device *_device;
+    VkDescriptorType _type;
+    uint _capacity;
+    VkDescriptorSetLayout _layout{};
+    VkDescriptorPool _pool{};
+    VkDescriptorSet _set{};
+    std::mutex _mtx;
+    vstd::vector<uint> _free_indices;
+
+public:
+    BindlessHeap(Device *device, VkDescriptorType type, uint capacity);
+    BindlessHeap(BindlessHeap const &) = delete;
+    BindlessHeap(BindlessHeap &&) = delete;
+    ~BindlessHeap();
+    auto layout() const { return _layout; }
+    auto set() const { return _set; }
+    auto capacity() const { return _capacity; }
+    uint allocate_index();
+    // the descriptor must not be used by commands in flight
+    void return_index(uint index);
+    void write_buffer(uint index, VkBuffer buffer, size_t offset);
+    void write_image(uint index, VkImageView view);
+};
+}// namespace lc::vk
@@ -0,0 +1,125 @@
+#include "bottom_accel.h"
+#include "top_accel.h"
+#include "device.h"
+#include "log.h"
+#include <luisa/core/logging.h>
+namespace lc::vk {
+AccelStorage::AccelStorage(Device *device, VkAccelerationStructureTypeKHR type)
+    : _device{device}, _type{type} {}
+AccelStorage::~AccelStorage() {
+    if (_handle) {
+        _device->accel_functions().vkDestroyAccelerationStructureKHR(_device->logic_device(), _handle, nullptr);
+    }
+}
+bool AccelStorage::reserve(size_t size_bytes, AccelBuildContext const &ctx) {
+    if (_buffer && _buffer->byte_size() >= size_bytes) return false;
+    auto &&functions = _device->accel_functions();
+    if (_buffer) {
+        (*ctx.execute_after_complete)([device = _device, buffer = _buffer.release(), handle = _handle] {
+            device->accel_functions().vkDestroyAccelerationStructureKHR(device->logic_device(), handle, nullptr);
+            delete buffer;
+        });
+    }
+    _buffer = vstd::make_unique<DefaultBuffer>(_device, size_bytes);
+    VkAccelerationStructureCreateInfoKHR create_info{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
+        .buffer = _buffer->vk_buffer(),
+        .offset = 0,
+        .size = size_bytes,
+        .type = _type};
+    VK_CHECK_RESULT(functions.vkCreateAccelerationStructureKHR(_device->logic_device(), &create_info, nullptr, &_handle));
+    VkAccelerationStructureDeviceAddressInfoKHR address_info{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR,
+        .accelerationStructure = _handle};
+    _address = functions.vkGetAccelerationStructureDeviceAddressKHR(_device->logic_device(), &address_info);
+    return true;
+}
+VkBuildAccelerationStructureFlagsKHR AccelStorage::build_flags(AccelOption const &option) {
+    // compaction is not supported yet, the same as the top-level structures of the DirectX backend
+    VkBuildAccelerationStructureFlagsKHR flags = [&] {
+        switch (option.hint) {
+            case AccelOption::UsageHint::FAST_TRACE:
+                return VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+            case AccelOption::UsageHint::FAST_BUILD:
+                return VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_BUILD_BIT_KHR;
+        }
+        LUISA_ERROR_WITH_LOCATION("Unreachable.");
+    }();
+    if (option.allow_update) {
+        flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
+    }
+    return flags;
+}
+BottomAccel::BottomAccel(Device *device, AccelOption const &option)
+    : Resource{device},
+      _flags{AccelStorage::build_flags(option)},
+      _storage{device, VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR} {}
+BottomAccel::~BottomAccel() {
+    for (auto &&i : _copy_accels()) {
+        i->remove_mesh(this);
+    }
+}
+vstd::vector<TopAccel *> BottomAccel::_copy_accels() {
+    // top-level structures lock themselves and then their meshes, so they are called without the lock
+    std::lock_guard lck{_mtx};
+    vstd::vector<TopAccel *> accels;
+    accels.reserve(_accels.size());
+    for (auto &&i : _accels) {
+        accels.emplace_back(i);
+    }
+    return accels;
+}
+void BottomAccel::add_accel(TopAccel *accel) {
+    std::lock_guard lck{_mtx};
+    _accels.emplace(accel);
+}
+void BottomAccel::remove_accel(TopAccel *accel) {
+    std::lock_guard lck{_mtx};
+    _accels.erase(accel);
+}
+void BottomAccel::build(AccelBuildContext const &ctx, VkAccelerationStructureGeometryKHR const &geometry,
+                        uint primitive_count, uint vertex_count, bool prefer_update) {
+    auto &&functions = device()->accel_functions();
+    VkAccelerationStructureBuildGeometryInfoKHR build_info{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
+        .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
+        .flags = _flags,
+        .mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR,
+        .geometryCount = 1,
+        .pGeometries = &geometry};
+    VkAccelerationStructureBuildSizesInfoKHR sizes{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR};
+    functions.vkGetAccelerationStructureBuildSizesKHR(
+        device()->logic_device(), VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+        &build_info, &primitive_count, &sizes);
+    auto update = prefer_update &&
+                  (_flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR) != 0 &&
+                  _storage.handle() != VK_NULL_HANDLE &&
+                  primitive_count == _primitive_count &&
+                  vertex_count == _vertex_count;
+    if (_storage.reserve(sizes.accelerationStructureSize, ctx)) {
+        update = false;
+        for (auto &&i : _copy_accels()) {
+            i->mark_moved(this);
+        }
+    }
+    _primitive_count = primitive_count;
+    _vertex_count = vertex_count;
+    auto scratch = ctx.scratch->allocate(
+        update ? sizes.updateScratchSize : sizes.buildScratchSize,
+        device()->accel_scratch_alignment());
+    if (update) {
+        build_info.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+        build_info.srcAccelerationStructure = _storage.handle();
+    }
+    build_info.dstAccelerationStructure = _storage.handle();
+    build_info.scratchData.deviceAddress = scratch.buffer->device_address() + scratch.offset;
+    // the inputs are added by the stream
+    ctx.barrier->add_buffer(_storage.buffer(), 0, std::numeric_limits<size_t>::max(), true);
+    ctx.barrier->update(ctx.cmd);
+    VkAccelerationStructureBuildRangeInfoKHR range{
+        .primitiveCount = primitive_count};
+    auto ranges = &range;
+    functions.vkCmdBuildAccelerationStructuresKHR(ctx.cmd, 1, &build_info, &ranges);
+}
+}// namespace lc::vk
@@ -0,0 +1,59 @@
+#pragma once
+#include <mutex>
+#include "resource.h"
+#include "default_buffer.h"
+#include "stream.h"
+#include <luisa/runtime/rhi/resource.h>
+namespace lc::vk {
+using namespace luisa::compute;
+class TopAccel;
+// what the building commands of a stream provide to acceleration structures
+struct AccelBuildContext {
+    VkCommandBuffer cmd;
+    ResourceBarrier *barrier;
+    StagingAllocator<DefaultBuffer> *scratch;
+    vstd::function<void(vstd::function<void()> &&)> *execute_after_complete;
+};
+// the buffer and the handle of an acceleration structure, reallocated when a build outgrows them
+class AccelStorage {
+    Device *_device;
+    VkAccelerationStructureTypeKHR _type;
+    vstd::unique_ptr<DefaultBuffer> _buffer;
+    VkAccelerationStructureKHR _handle{};
+    VkDeviceAddress _address{0};
+
+public:
+    AccelStorage(Device *device, VkAccelerationStructureTypeKHR type);
+    AccelStorage(AccelStorage const &) = delete;
+    AccelStorage(AccelStorage &&) = delete;
+    ~AccelStorage();
+    auto buffer() const { return _buffer.get(); }
+    auto handle() const { return _handle; }
+    auto address() const { return _address; }
+    // returns whether a new structure is allocated, the old one is destroyed once the commands in flight complete
+    bool reserve(size_t size_bytes, AccelBuildContext const &ctx);
+    static VkBuildAccelerationStructureFlagsKHR build_flags(AccelOption const &option);
+};
+// the structure of a mesh or of procedural primitives
+class BottomAccel : public Resource {
+    VkBuildAccelerationStructureFlagsKHR _flags;
+    AccelStorage _storage;
+    uint _primitive_count{0};
+    uint _vertex_count{0};
+    // top-level structures with instances of this one, which are told when it moves
+    std::mutex _mtx;
+    vstd::unordered_set<TopAccel *> _accels;
+    vstd::vector<TopAccel *> _copy_accels();
+
+public:
+    BottomAccel(Device *device, AccelOption const &option);
+    ~BottomAccel();
+    auto buffer() const { return _storage.buffer(); }
+    auto address() const { return _storage.address(); }
+    void add_accel(TopAccel *accel);
+    void remove_accel(TopAccel *accel);
+    // vertex_count is 0 for procedural primitives, an update keeps the counts of the last build
+    void build(AccelBuildContext const &ctx, VkAccelerationStructureGeometryKHR const &geometry,
+               uint primitive_count, uint vertex_count, bool prefer_update);
+};
+}// namespace lc::vk
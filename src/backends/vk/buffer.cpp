@@ -10,10 +10,17 @@ UploadBuffer::UploadBuffer(Device *device, size_t size_bytes)
           device->allocator()
               .allocate_buffer(
                   size_bytes,
-                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                  // also bound as the uniform arguments of dispatches
+                  static_cast<VkBufferUsageFlagBits>(
+                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT),
                   AccessType::Upload)} {
+    // staging buffers stay mapped for their whole lifetime
+    VK_CHECK_RESULT(vmaMapMemory(device->allocator().allocator(), _res.allocation, &_mapped_ptr));
 }
 UploadBuffer::~UploadBuffer() {
+    vmaUnmapMemory(device()->allocator().allocator(), _res.allocation);
     device()->allocator().destroy_buffer(_res);
 }
 ReadbackBuffer::ReadbackBuffer(Device *device, size_t size_bytes)
@@ -24,39 +31,25 @@ ReadbackBuffer::ReadbackBuffer(Device *device, size_t size_bytes)
                   size_bytes,
                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                   AccessType::ReadBack)} {
+    VK_CHECK_RESULT(vmaMapMemory(device->allocator().allocator(), _res.allocation, &_mapped_ptr));
 }
 ReadbackBuffer::~ReadbackBuffer() {
+    vmaUnmapMemory(device()->allocator().allocator(), _res.allocation);
     device()->allocator().destroy_buffer(_res);
 }
 void UploadBuffer::copy_from(void const *data, size_t offset, size_t size) {
-    void *mapped_ptr;
-    VK_CHECK_RESULT(vmaMapMemory(
-        device()->allocator().allocator(),
-        _res.allocation,
-        &mapped_ptr));
-    memcpy(reinterpret_cast<std::byte *>(mapped_ptr) + offset, data, size);
+    memcpy(reinterpret_cast<std::byte *>(_mapped_ptr) + offset, data, size);
     vmaFlushAllocation(
         device()->allocator().allocator(),
         _res.allocation,
         offset, size);
-    vmaUnmapMemory(
-        device()->allocator().allocator(),
-        _res.allocation);
 }
 void ReadbackBuffer::copy_to(void *data, size_t offset, size_t size) {
-    void *mapped_ptr;
-    VK_CHECK_RESULT(vmaMapMemory(
-        device()->allocator().allocator(),
-        _res.allocation,
-        &mapped_ptr));
-    memcpy(data, reinterpret_cast<std::byte *>(mapped_ptr) + offset, size);
-    vmaFlushAllocation(
+    vmaInvalidateAllocation(
         device()->allocator().allocator(),
         _res.allocation,
         offset, size);
-    vmaUnmapMemory(
-        device()->allocator().allocator(),
-        _res.allocation);
+    memcpy(data, reinterpret_cast<std::byte const *>(_mapped_ptr) + offset, size);
 }
 DefaultBuffer::DefaultBuffer(Device *device, size_t size_bytes)
     : Buffer{device, size_bytes},
@@ -64,15 +57,28 @@ DefaultBuffer::DefaultBuffer(Device *device, size_t size_bytes)
           device->allocator()
               .allocate_buffer(
                   size_bytes,
+                  // also bound as the dsp_c constants of indirect dispatches
                   static_cast<VkBufferUsageFlagBits>(
                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                      VK_BUFFER_USAGE_TRANSFER_DST_BIT |
                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
                       VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
-                      VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-                      VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
-                      VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR),
+                      (device->ray_tracing_enabled() ?
+                           VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+                               VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+                               VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
+                               VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR :
+                           0)),
                   AccessType::None)} {
 }
+VkDeviceAddress Buffer::device_address() const {
+    VkBufferDeviceAddressInfo info{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = vk_buffer()};
+    return vkGetBufferDeviceAddress(device()->logic_device(), &info);
+}
 DefaultBuffer::~DefaultBuffer() {
     device()->allocator().destroy_buffer(_res);
 }
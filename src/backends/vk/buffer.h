@@ -12,5 +12,7 @@ public:
     auto byte_size() const { return _byte_size; }
     virtual ~Buffer() = default;
     virtual VkBuffer vk_buffer() const = 0;
+    // only valid for the default buffers of devices with ray tracing
+    VkDeviceAddress device_address() const;
 };
 }// namespace lc::vk
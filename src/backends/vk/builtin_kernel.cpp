@@ -0,0 +1,127 @@
+#include "builtin_kernel.h"
+#include "device.h"
+#include "../common/hlsl/shader_compiler.h"
+#include <luisa/core/logging.h>
+namespace lc::vk {
+namespace detail {
+// compute pipelines have neither count buffers nor per-command constants in Vulkan,
+// so every entry gets its own VkDispatchIndirectCommand (zero groups past the count) and dsp_c
+static constexpr vstd::string_view indirect_kernel_code = R"(
+struct Params {
+    uint offset;
+    uint count;
+    uint constant_stride;
+    uint padding;
+};
+[[vk::binding(0)]] StructuredBuffer<Params> _Global;
+[[vk::binding(1)]] StructuredBuffer<uint> _Dispatch;
+[[vk::binding(2)]] RWStructuredBuffer<uint> _Args;
+[[vk::binding(3)]] RWStructuredBuffer<uint4> _Constants;
+[numthreads(64, 1, 1)]
+void main(uint id : SV_DispatchThreadID) {
+    Params p = _Global[0];
+    if (id >= p.count) return;
+    uint src = 1 + (p.offset + id) * 7;
+    _Constants[id * p.constant_stride] = uint4(_Dispatch[src], _Dispatch[src + 1], _Dispatch[src + 2], _Dispatch[src + 3]);
+    bool valid = id < _Dispatch[0];
+    _Args[id * 3] = valid ? _Dispatch[src + 4] : 0;
+    _Args[id * 3 + 1] = valid ? _Dispatch[src + 5] : 0;
+    _Args[id * 3 + 2] = valid ? _Dispatch[src + 6] : 0;
+}
+)";
+// the same as the accel_process kernel of the DirectX backend, with the bit fields of the instances packed by hand
+static constexpr vstd::string_view accel_set_kernel_code = R"(
+struct Params {
+    uint count;
+    uint instance_count;
+    uint2 padding;
+};
+struct Modification {
+    uint index;
+    uint flags;
+    uint2 primitive;
+    float4 affine[3];
+};
+struct Instance {
+    float4 transform[3];
+    uint index_mask;
+    uint offset_flags;
+    uint2 accel;
+};
+[[vk::binding(0)]] StructuredBuffer<Params> _Global;
+[[vk::binding(1)]] StructuredBuffer<Modification> _Modifications;
+[[vk::binding(2)]] RWStructuredBuffer<Instance> _Instances;
+[numthreads(64, 1, 1)]
+void main(uint id : SV_DispatchThreadID) {
+    const uint flag_primitive = 1u << 0u;
+    const uint flag_transform = 1u << 1u;
+    const uint flag_opaque_on = 1u << 2u;
+    const uint flag_opaque_off = 1u << 3u;
+    const uint flag_visibility = 1u << 4u;
+    const uint flag_opaque = flag_opaque_on | flag_opaque_off;
+    Params p = _Global[0];
+    if (id >= p.count) return;
+    Modification m = _Modifications[id];
+    if (m.index >= p.instance_count) return;
+    Instance r = _Instances[m.index];
+    if ((m.flags & flag_transform) != 0) {
+        r.transform = m.affine;
+    }
+    uint mask = (m.flags & flag_visibility) != 0 ? (m.flags >> 24) : (r.index_mask >> 24);
+    r.index_mask = (m.index & 0xffffffu) | (mask << 24);
+    // VK_GEOMETRY_INSTANCE_FORCE_OPAQUE_BIT_KHR or VK_GEOMETRY_INSTANCE_FORCE_NO_OPAQUE_BIT_KHR, and no SBT offset
+    uint instance_flags = r.offset_flags >> 24;
+    if ((m.flags & flag_opaque) != 0) {
+        instance_flags = (m.flags & flag_opaque_on) != 0 ? 4u : 8u;
+    }
+    r.offset_flags = instance_flags << 24;
+    if ((m.flags & flag_primitive) != 0) {
+        r.accel = m.primitive;
+    }
+    _Instances[m.index] = r;
+}
+)";
+static ComputeShader *load_kernel(Device *device, vstd::string_view code, vstd::span<hlsl::Property const> properties) {
+    auto comp_result = Device::Compiler()->compile_compute(
+        code,
+        true,
+        65u,
+        false,
+        true);
+    return comp_result.multi_visit_or(
+        vstd::UndefEval<ComputeShader *>{},
+        [&](vstd::unique_ptr<hlsl::DxcByteBlob> const &buffer) {
+            return new ComputeShader(
+                device,
+                properties,
+                {reinterpret_cast<const uint *>(buffer->data()), buffer->size() / sizeof(uint)},
+                {},
+                {},
+                uint3(64, 1, 1),
+                {});
+        },
+        [](auto &&err) {
+            LUISA_ERROR("Compile Error: {}", err);
+            return nullptr;
+        });
+}
+// the bindings of the kernels are all buffers in space 0, read-only ones first
+static vstd::vector<hlsl::Property> buffer_properties(uint read_count, uint write_count) {
+    vstd::vector<hlsl::Property> properties;
+    for (auto i = 0u; i < read_count + write_count; ++i) {
+        properties.emplace_back(hlsl::Property{
+            .type = i < read_count ? hlsl::ShaderVariableType::StructuredBuffer : hlsl::ShaderVariableType::RWStructuredBuffer,
+            .space_index = 0,
+            .register_index = i,
+            .array_size = 1});
+    }
+    return properties;
+}
+}// namespace detail
+ComputeShader *BuiltinKernel::load_indirect_kernel(Device *device) {
+    return detail::load_kernel(device, detail::indirect_kernel_code, detail::buffer_properties(2, 2));
+}
+ComputeShader *BuiltinKernel::load_accel_set_kernel(Device *device) {
+    return detail::load_kernel(device, detail::accel_set_kernel_code, detail::buffer_properties(2, 1));
+}
+}// namespace lc::vk
@@ -0,0 +1,13 @@
+#pragma once
+#include "compute_shader.h"
+namespace lc::vk {
+class BuiltinKernel {
+public:
+    // the stride of the entries of indirect dispatch buffers: size.xyz, kernel id and groups.xyz
+    static constexpr size_t dispatch_indirect_stride = 28u;
+    // converts the entries of an indirect dispatch buffer to VkDispatchIndirectCommand and the dsp_c constants
+    static ComputeShader *load_indirect_kernel(Device *device);
+    // applies AccelBuildCommand::Modification to the VkAccelerationStructureInstanceKHR of top-level structures
+    static ComputeShader *load_accel_set_kernel(Device *device);
+};
+}// namespace lc::vk
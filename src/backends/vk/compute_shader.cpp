@@ -15,8 +15,11 @@ ComputeShader::ComputeShader(
     vstd::span<hlsl::Property const> binds,
     vstd::span<uint const> spv_code,
     vstd::vector<Argument> &&captured,
+    vstd::vector<SavedArgument> &&args,
+    uint3 block_size,
     vstd::span<std::byte const> cache_code)
-    : Shader{device, ShaderTag::ComputeShader, std::move(captured), binds} {
+    : Shader{device, ShaderTag::ComputeShader, std::move(captured), std::move(args), binds},
+      _block_size{block_size} {
     VkPipelineCacheCreateInfo pso_ci{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
     if (!cache_code.empty()) {
@@ -73,7 +76,11 @@ ComputeShader *ComputeShader::compile(
     uint shader_model,
     bool unsafe_math) {
 
-    auto result = ShaderSerializer::try_deser_compute(device, code_md5, std::move(bindings), file_name, serde_type, bin_io);
+    vstd::vector<SavedArgument> args;
+    vstd::push_back_func(args, kernel.arguments().size(), [&](size_t i) {
+        return SavedArgument(kernel, kernel.arguments()[i]);
+    });
+    auto result = ShaderSerializer::try_deser_compute(device, code_md5, std::move(bindings), std::move(args), file_name, serde_type, bin_io);
     // cache invalid, need compile
     bool write_cache = !file_name.empty();
     if (!result.shader) {
@@ -105,6 +112,8 @@ ComputeShader *ComputeShader::compile(
                     str.properties,
                     {reinterpret_cast<const uint *>(buffer->data()), buffer->size() / sizeof(uint)},
                     std::move(bindings),
+                    std::move(args),
+                    blockSize,
                     {});
                 if (write_cache) {
                     ShaderSerializer::serialize_bytecode(
@@ -18,15 +18,19 @@ using namespace luisa::compute;
 class ComputeShader : public Shader {
     VkPipelineCache _pipe_cache{};
     VkPipeline _pipeline;
+    uint3 _block_size;
 
 public:
     auto pipeline() const { return _pipeline; }
+    auto block_size() const { return _block_size; }
     bool serialize_pso(vstd::vector<std::byte> &result) const override;
     ComputeShader(
         Device *device,
         vstd::span<hlsl::Property const> binds,
         vstd::span<uint const> spv_code,
         vstd::vector<Argument> &&captured,
+        vstd::vector<SavedArgument> &&args,
+        uint3 block_size,
         vstd::span<std::byte const> cache_code);
     ~ComputeShader();
     static ComputeShader *compile(
@@ -8,8 +8,19 @@
 #include "serde_type.h"
 #include "../common/hlsl/binding_to_arg.h"
 #include <luisa/runtime/context.h>
+#include <luisa/runtime/rhi/sampler.h>
 #include "../common/hlsl/shader_compiler.h"
 #include "shader_serializer.h"
+#include "stream.h"
+#include "event.h"
+#include "default_buffer.h"
+#include "texture.h"
+#include "bindless_heap.h"
+#include "bindless_array.h"
+#include "builtin_kernel.h"
+#include "bottom_accel.h"
+#include "top_accel.h"
+#include <luisa/runtime/dispatch_buffer.h>
 
 namespace lc::vk {
 static std::mutex gDxcMutex;
@@ -136,6 +147,12 @@ VkInstance create_instance(bool enableValidation) {
             }
         }
     }
+    // surfaces are only needed by swap chains, and headless implementations (e.g. lavapipe) may lack them
+    instance_exts.erase(
+        std::remove_if(instance_exts.begin(), instance_exts.end(), [&](const char *ext) {
+            return supported_instance_exts.find(ext) == supported_instance_exts.end();
+        }),
+        instance_exts.end());
 #if (defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK))
     // SRS - When running on iOS/macOS with MoltenVK, enable VK_KHR_get_physical_device_properties2 if not already enabled by the example (required by VK_KHR_portability_subset)
     if (std::find(enable_inst_ext.begin(), enable_inst_ext.end(), VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == enable_inst_ext.end()) {
@@ -209,28 +226,38 @@ VkInstance create_instance(bool enableValidation) {
 //////////////// Not implemented area
 ResourceCreationInfo Device::create_mesh(
     const AccelOption &option) noexcept {
-    LUISA_ERROR("mesh not implemented.");
-    return ResourceCreationInfo::make_invalid();
+    if (!_ray_tracing_enabled) [[unlikely]] {
+        LUISA_ERROR("Ray tracing is not supported by this device.");
+    }
+    // the structure is allocated on its first build
+    auto res = new BottomAccel(this, option);
+    return ResourceCreationInfo{
+        .handle = reinterpret_cast<uint64_t>(res),
+        .native_handle = nullptr};
 }
 void Device::destroy_mesh(uint64_t handle) noexcept {
-    LUISA_ERROR("mesh not implemented.");
+    delete reinterpret_cast<BottomAccel *>(handle);
 }
 
 ResourceCreationInfo Device::create_procedural_primitive(
     const AccelOption &option) noexcept {
-    LUISA_ERROR("procedural primitive not implemented.");
-    return ResourceCreationInfo::make_invalid();
+    return create_mesh(option);
 }
 void Device::destroy_procedural_primitive(uint64_t handle) noexcept {
-    LUISA_ERROR("procedural primitive not implemented.");
+    delete reinterpret_cast<BottomAccel *>(handle);
 }
 
 ResourceCreationInfo Device::create_accel(const AccelOption &option) noexcept {
-    LUISA_ERROR("accel not implemented.");
-    return ResourceCreationInfo::make_invalid();
+    if (!_ray_tracing_enabled) [[unlikely]] {
+        LUISA_ERROR("Ray tracing is not supported by this device.");
+    }
+    auto res = new TopAccel(this, option);
+    return ResourceCreationInfo{
+        .handle = reinterpret_cast<uint64_t>(res),
+        .native_handle = nullptr};
 }
 void Device::destroy_accel(uint64_t handle) noexcept {
-    LUISA_ERROR("accel not implemented.");
+    delete reinterpret_cast<TopAccel *>(handle);
 }
 //////////////// Not implemented area
 Device::Device(Context &&ctx, DeviceConfig const *configs)
@@ -242,21 +269,20 @@ Device::Device(Context &&ctx, DeviceConfig const *configs)
         device_idx = configs->device_index;
         _binary_io = configs->binary_io;
     }
-    if (!headless) {
-        // init instance
-        {
-            std::lock_guard lck{detail::instance_mtx};
-            if (!detail::vk_instance) {
+    // init instance
+    {
+        std::lock_guard lck{detail::instance_mtx};
+        if (!detail::vk_instance) {
 #ifdef NDEBUG
-                constexpr bool enableValidation = false;
+            constexpr bool enableValidation = false;
 #else
-                constexpr bool enableValidation = true;
+            constexpr bool enableValidation = true;
 #endif
-                detail::vk_instance = detail::create_instance(enableValidation);
-            }
+            detail::vk_instance = detail::create_instance(enableValidation);
         }
-        _init_device(device_idx);
     }
+    // headless devices only skip the swap chain
+    _init_device(device_idx, headless);
     // auto exts = detail::supported_exts(physical_device());
     // for(auto&& i : exts){
     //     LUISA_INFO("{}", i.extensionName);
@@ -274,7 +300,7 @@ Device::Device(Context &&ctx, DeviceConfig const *configs)
         _binary_io = _default_file_io.get();
     }
 }
-void Device::_init_device(uint32_t selectedDevice) {
+void Device::_init_device(uint32_t selectedDevice, bool headless) {
     VkResult err;
 
     // If requested, we enable the default validation layers for debugging
@@ -317,34 +343,46 @@ void Device::_init_device(uint32_t selectedDevice) {
     // This is handled by a separate class that gets a logical device representation
     // and encapsulates functions related to a device
     _vk_device.create(physicalDevice);
-    _enable_device_exts.emplace_back(VK_KHR_RAY_QUERY_EXTENSION_NAME);
-    _enable_device_exts.emplace_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
-    _enable_device_exts.emplace_back(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME);
-    _enable_device_exts.emplace_back(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME);
-
-    VkPhysicalDeviceDescriptorIndexingFeatures enableBindlessFeatures{
-        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
-        .shaderInputAttachmentArrayDynamicIndexing = VK_TRUE,
-        .shaderUniformTexelBufferArrayDynamicIndexing = VK_TRUE,
-        .shaderStorageTexelBufferArrayDynamicIndexing = VK_TRUE,
-        .shaderUniformBufferArrayNonUniformIndexing = VK_TRUE,
-        .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
-        .shaderStorageBufferArrayNonUniformIndexing = VK_TRUE,
-        .shaderStorageImageArrayNonUniformIndexing = VK_TRUE,
-        .shaderInputAttachmentArrayNonUniformIndexing = VK_TRUE,
-        .shaderUniformTexelBufferArrayNonUniformIndexing = VK_TRUE,
-        .shaderStorageTexelBufferArrayNonUniformIndexing = VK_TRUE,
-        .runtimeDescriptorArray = VK_TRUE};
+    if (_device_properties.apiVersion < VK_API_VERSION_1_2) {
+        LUISA_ERROR("Vulkan device \"{}\" does not support Vulkan 1.2.", _device_properties.deviceName);
+    }
+    VkPhysicalDeviceVulkan12Features supported_features12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    VkPhysicalDeviceFeatures2 supported_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &supported_features12};
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &supported_features);
+    // streams and events are built on timeline semaphores
+    if (!supported_features12.timelineSemaphore) {
+        LUISA_ERROR("Vulkan device \"{}\" does not support timeline semaphores.", _device_properties.deviceName);
+    }
+    // descriptor indexing is core in Vulkan 1.2, so bindless resources are enabled with the rest of the supported features
+    VkPhysicalDeviceVulkan12Features enabled_features12 = supported_features12;
+    enabled_features12.pNext = nullptr;
+
+    // ray queries are optional, software implementations do not have them
     VkPhysicalDeviceRayQueryFeaturesKHR enabledRayQueryFeatures{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
-        .pNext = &enableBindlessFeatures,
+        .pNext = &enabled_features12,
         .rayQuery = VK_TRUE};
     VkPhysicalDeviceAccelerationStructureFeaturesKHR enabledAccelerationStructureFeatures{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR,
         .pNext = &enabledRayQueryFeatures,
         .accelerationStructure = VK_TRUE};
-
-    VK_CHECK_RESULT(_vk_device->createLogicalDevice(_device_features, _enable_device_exts, &enabledAccelerationStructureFeatures));
+    _ray_tracing_enabled = supported_features12.bufferDeviceAddress &&
+                           _vk_device->extensionSupported(VK_KHR_RAY_QUERY_EXTENSION_NAME) &&
+                           _vk_device->extensionSupported(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME) &&
+                           _vk_device->extensionSupported(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME);
+    if (_ray_tracing_enabled) {
+        _enable_device_exts.emplace_back(VK_KHR_RAY_QUERY_EXTENSION_NAME);
+        _enable_device_exts.emplace_back(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME);
+        _enable_device_exts.emplace_back(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME);
+    }
+    void *features_chain = _ray_tracing_enabled ?
+                               static_cast<void *>(&enabledAccelerationStructureFeatures) :
+                               static_cast<void *>(&enabled_features12);
+    auto use_swap_chain = !headless && _vk_device->extensionSupported(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    VK_CHECK_RESULT(_vk_device->createLogicalDevice(_device_features, _enable_device_exts, features_chain, use_swap_chain));
     auto device = _vk_device->logicalDevice;
     // Get a graphics queue from the device
     vkGetDeviceQueue(device, _vk_device->queueFamilyIndices.graphics, 0, &_graphics_queue);
@@ -356,38 +394,262 @@ void Device::_init_device(uint32_t selectedDevice) {
     _pso_header.deviceID = _vk_device->properties.deviceID;
     memcpy(_pso_header.pipelineCacheUUID, _vk_device->properties.pipelineCacheUUID, VK_UUID_SIZE);
     _allocator.create(*this);
+    _init_samplers();
+    if (_ray_tracing_enabled) {
+        _init_ray_tracing();
+    }
+    VkCommandPoolCreateInfo pool_ci{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = compute_queue_index()};
+    VK_CHECK_RESULT(vkCreateCommandPool(device, &pool_ci, nullptr, &_immediate_pool));
+    VkFenceCreateInfo fence_ci{
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    VK_CHECK_RESULT(vkCreateFence(device, &fence_ci, nullptr, &_immediate_fence));
+    _init_bindless_heaps(enabled_features12);
+}
+void Device::_init_bindless_heaps(VkPhysicalDeviceVulkan12Features const &features) {
+    if (!features.runtimeDescriptorArray ||
+        !features.descriptorBindingPartiallyBound ||
+        !features.descriptorBindingStorageBufferUpdateAfterBind ||
+        !features.descriptorBindingSampledImageUpdateAfterBind ||
+        !features.shaderStorageBufferArrayNonUniformIndexing ||
+        !features.shaderSampledImageArrayNonUniformIndexing) {
+        LUISA_WARNING("Vulkan device \"{}\" does not support the descriptor indexing features of bindless arrays.",
+                      _device_properties.deviceName);
+        return;
+    }
+    VkPhysicalDeviceVulkan12Properties properties12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES};
+    VkPhysicalDeviceProperties2 properties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &properties12};
+    vkGetPhysicalDeviceProperties2(physical_device(), &properties);
+    // the same size as the global descriptor heap of the DirectX backend, leaving room for
+    // the descriptors of the arguments, which count towards the same per-stage limits
+    constexpr uint heap_capacity = 262144u;
+    constexpr uint reserved = 64u;
+    auto capacity = [&](uint per_stage_limit, uint set_limit) {
+        return std::min(heap_capacity, std::max(std::min(per_stage_limit, set_limit), reserved * 2u) - reserved);
+    };
+    _bindless_buffer_heap = vstd::make_unique<BindlessHeap>(
+        this, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        capacity(properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                 properties12.maxDescriptorSetUpdateAfterBindStorageBuffers));
+    _bindless_texture_heap = vstd::make_unique<BindlessHeap>(
+        this, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+        capacity(properties12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                 properties12.maxDescriptorSetUpdateAfterBindSampledImages));
+}
+BindlessHeap &Device::bindless_buffer_heap() const {
+    if (!_bindless_buffer_heap) [[unlikely]] {
+        LUISA_ERROR("Bindless arrays are not supported by Vulkan device \"{}\".", _device_properties.deviceName);
+    }
+    return *_bindless_buffer_heap;
+}
+BindlessHeap &Device::bindless_texture_heap() const {
+    if (!_bindless_texture_heap) [[unlikely]] {
+        LUISA_ERROR("Bindless arrays are not supported by Vulkan device \"{}\".", _device_properties.deviceName);
+    }
+    return *_bindless_texture_heap;
+}
+void Device::_init_ray_tracing() {
+    auto load = [&]<typename T>(T &func, char const *name) {
+        func = reinterpret_cast<T>(vkGetDeviceProcAddr(logic_device(), name));
+        if (func == nullptr) [[unlikely]] {
+            LUISA_ERROR("Failed to load {} of Vulkan device \"{}\".", name, _device_properties.deviceName);
+        }
+    };
+    load(_accel_functions.vkCreateAccelerationStructureKHR, "vkCreateAccelerationStructureKHR");
+    load(_accel_functions.vkDestroyAccelerationStructureKHR, "vkDestroyAccelerationStructureKHR");
+    load(_accel_functions.vkGetAccelerationStructureBuildSizesKHR, "vkGetAccelerationStructureBuildSizesKHR");
+    load(_accel_functions.vkGetAccelerationStructureDeviceAddressKHR, "vkGetAccelerationStructureDeviceAddressKHR");
+    load(_accel_functions.vkCmdBuildAccelerationStructuresKHR, "vkCmdBuildAccelerationStructuresKHR");
+    VkPhysicalDeviceAccelerationStructurePropertiesKHR accel_properties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
+    VkPhysicalDeviceProperties2 properties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &accel_properties};
+    vkGetPhysicalDeviceProperties2(physical_device(), &properties);
+    _accel_scratch_alignment = accel_properties.minAccelerationStructureScratchOffsetAlignment;
+}
+void Device::_init_samplers() {
+    for (auto address = 0u; address < 4u; ++address) {
+        for (auto filter = 0u; filter < 4u; ++filter) {
+            auto address_mode = [&] {
+                switch (static_cast<Sampler::Address>(address)) {
+                    case Sampler::Address::EDGE: return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+                    case Sampler::Address::REPEAT: return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+                    case Sampler::Address::MIRROR: return VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+                    default: return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+                }
+            }();
+            auto linear = static_cast<Sampler::Filter>(filter) != Sampler::Filter::POINT;
+            auto mip_linear = static_cast<Sampler::Filter>(filter) == Sampler::Filter::LINEAR_LINEAR ||
+                              static_cast<Sampler::Filter>(filter) == Sampler::Filter::ANISOTROPIC;
+            auto anisotropic = static_cast<Sampler::Filter>(filter) == Sampler::Filter::ANISOTROPIC &&
+                               _device_features.samplerAnisotropy;
+            VkSamplerCreateInfo sampler_ci{
+                .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+                .magFilter = linear ? VK_FILTER_LINEAR : VK_FILTER_NEAREST,
+                .minFilter = linear ? VK_FILTER_LINEAR : VK_FILTER_NEAREST,
+                .mipmapMode = mip_linear ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST,
+                .addressModeU = address_mode,
+                .addressModeV = address_mode,
+                .addressModeW = address_mode,
+                .anisotropyEnable = anisotropic ? VK_TRUE : VK_FALSE,
+                .maxAnisotropy = anisotropic ? 16.f : 1.f,
+                .minLod = 0.f,
+                .maxLod = 16.f,
+                .borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK};
+            VK_CHECK_RESULT(vkCreateSampler(logic_device(), &sampler_ci, nullptr, &_samplers[address * 4u + filter]));
+        }
+    }
+}
+VkQueue Device::queue(StreamTag tag) const {
+    switch (tag) {
+        case StreamTag::GRAPHICS: return _graphics_queue;
+        case StreamTag::COMPUTE: return _compute_queue;
+        case StreamTag::COPY: return _copy_queue;
+        default: LUISA_ERROR_WITH_LOCATION("Illegal stream tag.");
+    }
+}
+uint Device::queue_family_index(StreamTag tag) const {
+    switch (tag) {
+        case StreamTag::GRAPHICS: return graphics_queue_index();
+        case StreamTag::COMPUTE: return compute_queue_index();
+        case StreamTag::COPY: return copy_queue_index();
+        default: LUISA_ERROR_WITH_LOCATION("Illegal stream tag.");
+    }
+}
+void Device::execute_immediately(vstd::function<void(VkCommandBuffer)> const &func) {
+    std::lock_guard lck{_immediate_mtx};
+    VkCommandBufferAllocateInfo cb_ci{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = _immediate_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1};
+    VkCommandBuffer cmd;
+    VK_CHECK_RESULT(vkAllocateCommandBuffers(logic_device(), &cb_ci, &cmd));
+    VkCommandBufferBeginInfo begin_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+    VK_CHECK_RESULT(vkBeginCommandBuffer(cmd, &begin_info));
+    func(cmd);
+    VK_CHECK_RESULT(vkEndCommandBuffer(cmd));
+    VkSubmitInfo submit_info{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &cmd};
+    {
+        std::lock_guard queue_lck{_queue_mtx};
+        VK_CHECK_RESULT(vkQueueSubmit(_compute_queue, 1, &submit_info, _immediate_fence));
+    }
+    VK_CHECK_RESULT(vkWaitForFences(logic_device(), 1, &_immediate_fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+    VK_CHECK_RESULT(vkResetFences(logic_device(), 1, &_immediate_fence));
+    VK_CHECK_RESULT(vkResetCommandPool(logic_device(), _immediate_pool, 0));
+}
+ComputeShader *Device::indirect_kernel() {
+    std::lock_guard lck{_builtin_mtx};
+    if (!_indirect_kernel) {
+        _indirect_kernel = vstd::unique_ptr<ComputeShader>{BuiltinKernel::load_indirect_kernel(this)};
+    }
+    return _indirect_kernel.get();
+}
+ComputeShader *Device::accel_set_kernel() {
+    std::lock_guard lck{_builtin_mtx};
+    if (!_accel_set_kernel) {
+        _accel_set_kernel = vstd::unique_ptr<ComputeShader>{BuiltinKernel::load_accel_set_kernel(this)};
+    }
+    return _accel_set_kernel.get();
 }
 bool Device::is_pso_same(VkPipelineCacheHeaderVersionOne const &pso) {
     return memcmp(&pso, &_pso_header, sizeof(VkPipelineCacheHeaderVersionOne)) == 0;
 }
 Device::~Device() {
+    _indirect_kernel.reset();
+    _accel_set_kernel.reset();
+    _bindless_buffer_heap.reset();
+    _bindless_texture_heap.reset();
+    vkDestroyFence(logic_device(), _immediate_fence, nullptr);
+    vkDestroyCommandPool(logic_device(), _immediate_pool, nullptr);
+    for (auto &&i : _samplers) {
+        vkDestroySampler(logic_device(), i, nullptr);
+    }
     std::lock_guard lck(gDxcMutex);
     if (--gDxcRefCount == 0) {
         gDxcCompiler.destroy();
     }
 }
 void *Device::native_handle() const noexcept { return _vk_device->logicalDevice; }
-BufferCreationInfo Device::create_buffer(const Type *element, size_t elem_count) noexcept { return BufferCreationInfo::make_invalid(); }
+BufferCreationInfo Device::create_buffer(const Type *element, size_t elem_count) noexcept {
+    BufferCreationInfo info{};
+    if (element == Type::of<void>()) {
+        info.total_size_bytes = elem_count;
+        info.element_stride = 1u;
+    } else if (element == Type::of<IndirectKernelDispatch>()) {
+        // the count, then the entries of BuiltinKernel::dispatch_indirect_stride bytes, the same as the DirectX backend
+        info.total_size_bytes = sizeof(uint) + BuiltinKernel::dispatch_indirect_stride * elem_count;
+        info.element_stride = BuiltinKernel::dispatch_indirect_stride;
+    } else if (element->is_custom()) {
+        LUISA_ERROR("Buffers of {} are not supported by the Vulkan backend yet.", element->description());
+    } else {
+        info.total_size_bytes = element->size() * elem_count;
+        info.element_stride = element->size();
+    }
+    auto res = new DefaultBuffer(this, info.total_size_bytes);
+    info.handle = reinterpret_cast<uint64_t>(res);
+    info.native_handle = res->vk_buffer();
+    return info;
+}
 BufferCreationInfo Device::create_buffer(const ir::CArc<ir::Type> *element, size_t elem_count) noexcept { return BufferCreationInfo::make_invalid(); }
-void Device::destroy_buffer(uint64_t handle) noexcept {}
+void Device::destroy_buffer(uint64_t handle) noexcept {
+    delete reinterpret_cast<Buffer *>(handle);
+}
 
 // texture
 ResourceCreationInfo Device::create_texture(
     PixelFormat format, uint dimension,
     uint width, uint height, uint depth,
-    uint mipmap_levels, bool simultaneous_access) noexcept { return ResourceCreationInfo::make_invalid(); }
-void Device::destroy_texture(uint64_t handle) noexcept {}
+    uint mipmap_levels, bool simultaneous_access) noexcept {
+    // textures are always in the general layout, so simultaneous access needs nothing more
+    auto res = new Texture(this, format, dimension, make_uint3(width, height, depth), mipmap_levels);
+    return ResourceCreationInfo{
+        .handle = reinterpret_cast<uint64_t>(res),
+        .native_handle = res->vk_image()};
+}
+void Device::destroy_texture(uint64_t handle) noexcept {
+    delete reinterpret_cast<Texture *>(handle);
+}
 
 // bindless array
-ResourceCreationInfo Device::create_bindless_array(size_t size) noexcept { return ResourceCreationInfo::make_invalid(); }
-void Device::destroy_bindless_array(uint64_t handle) noexcept {}
+ResourceCreationInfo Device::create_bindless_array(size_t size) noexcept {
+    auto res = new BindlessArray(this, size);
+    return ResourceCreationInfo{
+        .handle = reinterpret_cast<uint64_t>(res),
+        .native_handle = res->buffer()->vk_buffer()};
+}
+void Device::destroy_bindless_array(uint64_t handle) noexcept {
+    delete reinterpret_cast<BindlessArray *>(handle);
+}
 
 // stream
-ResourceCreationInfo Device::create_stream(StreamTag stream_tag) noexcept { return ResourceCreationInfo::make_invalid(); }
-void Device::destroy_stream(uint64_t handle) noexcept {}
-void Device::synchronize_stream(uint64_t stream_handle) noexcept {}
+ResourceCreationInfo Device::create_stream(StreamTag stream_tag) noexcept {
+    auto res = new Stream(this, stream_tag);
+    return ResourceCreationInfo{
+        .handle = reinterpret_cast<uint64_t>(res),
+        .native_handle = res->queue()};
+}
+void Device::destroy_stream(uint64_t handle) noexcept {
+    delete reinterpret_cast<Stream *>(handle);
+}
+void Device::synchronize_stream(uint64_t stream_handle) noexcept {
+    reinterpret_cast<Stream *>(stream_handle)->synchronize();
+}
 void Device::dispatch(
-    uint64_t stream_handle, CommandList &&list) noexcept {}
+    uint64_t stream_handle, CommandList &&list) noexcept {
+    reinterpret_cast<Stream *>(stream_handle)->dispatch(std::move(list));
+}
 
 // swap chain
 SwapchainCreationInfo Device::create_swapchain(
@@ -469,19 +731,36 @@ ShaderCreationInfo Device::create_shader(const ShaderOption &option, Function ke
 }
 ShaderCreationInfo Device::create_shader(const ShaderOption &option, const ir::KernelModule *kernel) noexcept { return ShaderCreationInfo::make_invalid(); }
 ShaderCreationInfo Device::load_shader(luisa::string_view name, luisa::span<const Type *const> arg_types) noexcept { return ShaderCreationInfo::make_invalid(); }
-Usage Device::shader_argument_usage(uint64_t handle, size_t index) noexcept { return Usage::NONE; }
+Usage Device::shader_argument_usage(uint64_t handle, size_t index) noexcept {
+    return reinterpret_cast<ComputeShader *>(handle)->args()[index].varUsage;
+}
 void Device::destroy_shader(uint64_t handle) noexcept {
     delete reinterpret_cast<ComputeShader *>(handle);
 }
 
 // event
-ResourceCreationInfo Device::create_event() noexcept { return ResourceCreationInfo::make_invalid(); }
-void Device::destroy_event(uint64_t handle) noexcept {}
-void Device::signal_event(uint64_t handle, uint64_t stream_handle, uint64_t fence_value) noexcept {}
-void Device::wait_event(uint64_t handle, uint64_t stream_handle, uint64_t fence_value) noexcept {}
-void Device::synchronize_event(uint64_t handle, uint64_t fence_value) noexcept {}
+ResourceCreationInfo Device::create_event() noexcept {
+    auto res = new Event(this);
+    return ResourceCreationInfo{
+        .handle = reinterpret_cast<uint64_t>(res),
+        .native_handle = res->semaphore()};
+}
+void Device::destroy_event(uint64_t handle) noexcept {
+    delete reinterpret_cast<Event *>(handle);
+}
+void Device::signal_event(uint64_t handle, uint64_t stream_handle, uint64_t fence_value) noexcept {
+    reinterpret_cast<Stream *>(stream_handle)->signal(reinterpret_cast<Event *>(handle), fence_value);
+}
+void Device::wait_event(uint64_t handle, uint64_t stream_handle, uint64_t fence_value) noexcept {
+    reinterpret_cast<Stream *>(stream_handle)->wait(reinterpret_cast<Event *>(handle), fence_value);
+}
+void Device::synchronize_event(uint64_t handle, uint64_t fence_value) noexcept {
+    reinterpret_cast<Event *>(handle)->synchronize(fence_value);
+}
 void Device::set_name(luisa::compute::Resource::Tag resource_tag, uint64_t resource_handle, luisa::string_view name) noexcept {}
-bool Device::is_event_completed(uint64_t handle, uint64_t fence_value) const noexcept {return false;}
+bool Device::is_event_completed(uint64_t handle, uint64_t fence_value) const noexcept {
+    return reinterpret_cast<Event *>(handle)->is_completed(fence_value);
+}
 VSTL_EXPORT_C void backend_device_names(luisa::vector<luisa::string> &r) {
     {
         std::lock_guard lck{detail::instance_mtx};
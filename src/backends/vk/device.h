@@ -1,8 +1,10 @@
 #pragma once
+#include <mutex>
 #include <vulkan/vulkan.h>
 #include <luisa/runtime/device.h>
 #include "VulkanDevice.h"
 #include <luisa/vstl/common.h>
+#include <luisa/vstl/functional.h>
 #include "../common/default_binary_io.h"
 #include "vk_allocator.h"
 namespace lc::hlsl {
@@ -11,6 +13,8 @@ class ShaderCompiler;
 namespace lc::vk {
 using namespace luisa;
 using namespace luisa::compute;
+class BindlessHeap;
+class ComputeShader;
 class Device : public DeviceInterface, public vstd::IOperatorNewBase {
     vstd::optional<vks::VulkanDevice> _vk_device;
     VkPhysicalDeviceProperties _device_properties{};
@@ -24,7 +28,40 @@ class Device : public DeviceInterface, public vstd::IOperatorNewBase {
     vstd::optional<VkAllocator> _allocator;
     BinaryIO const *_binary_io{};
     vstd::unique_ptr<DefaultBinaryIO> _default_file_io;
-    void _init_device(uint32_t selectedDevice);
+    bool _ray_tracing_enabled{false};
+    VkDeviceSize _accel_scratch_alignment{0};
+    // queues may be shared by streams, and submissions to a queue must be externally synchronized
+    std::mutex _queue_mtx;
+    // the 16 combinations of Sampler::Filter and Sampler::Address, indexed by address * 4 + filter
+    std::array<VkSampler, 16> _samplers{};
+    // one-off commands of resource creation (e.g. the initial layouts of textures)
+    std::mutex _immediate_mtx;
+    VkCommandPool _immediate_pool{};
+    VkFence _immediate_fence{};
+    // descriptors of the buffers and of the (2D and 3D) textures in bindless arrays, empty without descriptor indexing
+    vstd::unique_ptr<BindlessHeap> _bindless_buffer_heap;
+    vstd::unique_ptr<BindlessHeap> _bindless_texture_heap;
+    // built-in kernels, compiled on first use
+    std::mutex _builtin_mtx;
+    vstd::unique_ptr<ComputeShader> _indirect_kernel;
+    vstd::unique_ptr<ComputeShader> _accel_set_kernel;
+    void _init_device(uint32_t selectedDevice, bool headless);
+    void _init_ray_tracing();
+    void _init_samplers();
+    void _init_bindless_heaps(VkPhysicalDeviceVulkan12Features const &features);
+
+public:
+    // entry points of VK_KHR_acceleration_structure, which the loader does not export
+    struct AccelFunctions {
+        PFN_vkCreateAccelerationStructureKHR vkCreateAccelerationStructureKHR{};
+        PFN_vkDestroyAccelerationStructureKHR vkDestroyAccelerationStructureKHR{};
+        PFN_vkGetAccelerationStructureBuildSizesKHR vkGetAccelerationStructureBuildSizesKHR{};
+        PFN_vkGetAccelerationStructureDeviceAddressKHR vkGetAccelerationStructureDeviceAddressKHR{};
+        PFN_vkCmdBuildAccelerationStructuresKHR vkCmdBuildAccelerationStructuresKHR{};
+    };
+
+private:
+    AccelFunctions _accel_functions;
 
 public:
     static hlsl::ShaderCompiler *Compiler();
@@ -39,6 +76,19 @@ public:
     auto graphics_queue_index() const { return _vk_device->queueFamilyIndices.graphics; }
     auto compute_queue_index() const { return _vk_device->queueFamilyIndices.compute; }
     auto copy_queue_index() const { return _vk_device->queueFamilyIndices.transfer; }
+    VkQueue queue(StreamTag tag) const;
+    uint queue_family_index(StreamTag tag) const;
+    auto &queue_mutex() { return _queue_mtx; }
+    auto ray_tracing_enabled() const { return _ray_tracing_enabled; }
+    auto const &accel_functions() const { return _accel_functions; }
+    auto accel_scratch_alignment() const { return _accel_scratch_alignment; }
+    auto samplers() const { return vstd::span<const VkSampler>{_samplers}; }
+    BindlessHeap &bindless_buffer_heap() const;
+    BindlessHeap &bindless_texture_heap() const;
+    // records the commands with func, submits them to the compute queue and waits for them
+    void execute_immediately(vstd::function<void(VkCommandBuffer)> const &func);
+    ComputeShader *indirect_kernel();
+    ComputeShader *accel_set_kernel();
     Device(Context &&ctx, DeviceConfig const *configs);
     ~Device();
     void *native_handle() const noexcept override;
@@ -1 +1,32 @@
-
+#include "event.h"
+#include "device.h"
+#include "log.h"
+namespace lc::vk {
+Event::Event(Device *device)
+    : Resource{device} {
+    VkSemaphoreTypeCreateInfo type_ci{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0};
+    VkSemaphoreCreateInfo ci{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type_ci};
+    VK_CHECK_RESULT(vkCreateSemaphore(device->logic_device(), &ci, nullptr, &_semaphore));
+}
+Event::~Event() {
+    vkDestroySemaphore(device()->logic_device(), _semaphore, nullptr);
+}
+void Event::synchronize(uint64_t value) const {
+    VkSemaphoreWaitInfo wait_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &_semaphore,
+        .pValues = &value};
+    VK_CHECK_RESULT(vkWaitSemaphores(device()->logic_device(), &wait_info, std::numeric_limits<uint64_t>::max()));
+}
+bool Event::is_completed(uint64_t value) const {
+    uint64_t counter{};
+    VK_CHECK_RESULT(vkGetSemaphoreCounterValue(device()->logic_device(), _semaphore, &counter));
+    return counter >= value;
+}
+}// namespace lc::vk
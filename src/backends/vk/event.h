@@ -1,4 +1,16 @@
 #pragma once
-namespace lc::vk{
-    
-}
+#include "resource.h"
+#include <vulkan/vulkan.h>
+namespace lc::vk {
+// events are timeline semaphores: signaling fence value n sets the counter to n
+class Event : public Resource {
+    VkSemaphore _semaphore;
+
+public:
+    auto semaphore() const { return _semaphore; }
+    explicit Event(Device *device);
+    ~Event();
+    void synchronize(uint64_t value) const;
+    [[nodiscard]] bool is_completed(uint64_t value) const;
+};
+}// namespace lc::vk
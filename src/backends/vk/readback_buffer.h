@@ -4,6 +4,7 @@
 namespace lc::vk {
 class ReadbackBuffer : public Buffer {
     AllocatedBuffer _res;
+    void *_mapped_ptr{};
 
 public:
     ReadbackBuffer(Device *device, size_t size_bytes);
@@ -1,8 +1,92 @@
 #include "resource_barrier.h"
+#include "buffer.h"
+#include "texture.h"
 namespace lc::vk {
-ResourceBarrier::ResourceBarrier() {}
-void ResourceBarrier::add_buffer(Buffer const *buffer, size_t offset, size_t size) {
-    
+ResourceBarrier::ResourceBarrier(bool ray_tracing) : _ray_tracing{ray_tracing} {}
+void ResourceBarrier::add_buffer(Buffer const *buffer, size_t offset, size_t size, bool write) {
+    _pending.emplace_back(PendingAccess{
+        .resource = buffer,
+        .range = size == std::numeric_limits<size_t>::max() ?
+                     Range{} :
+                     Range{static_cast<int64_t>(offset), static_cast<int64_t>(size)},
+        .write = write});
+}
+void ResourceBarrier::add_texture(Texture const *texture, uint level, bool write) {
+    _pending.emplace_back(PendingAccess{
+        .resource = texture,
+        .range = level == std::numeric_limits<uint>::max() ?
+                     Range{} :
+                     Range{static_cast<int64_t>(level)},
+        .write = write});
+}
+void ResourceBarrier::add_read_all() {
+    _pending_read_all = true;
+}
+void ResourceBarrier::update(VkCommandBuffer cmd) {
+    auto collide = [](vstd::vector<Range> const &ranges, Range const &range) {
+        for (auto &&r : ranges) {
+            if (r.collide(range)) return true;
+        }
+        return false;
+    };
+    bool hazard = false;
+    if (_pending_read_all) {
+        for (auto &&i : resource_ranges) {
+            if (!i.second.writes.empty()) {
+                hazard = true;
+                break;
+            }
+        }
+    }
+    for (auto &&i : _pending) {
+        if (hazard) break;
+        if (i.write && _read_all) {
+            hazard = true;
+            break;
+        }
+        auto iter = resource_ranges.find(i.resource);
+        if (iter == resource_ranges.end()) continue;
+        auto &access = iter->second;
+        // read-after-write, write-after-read and write-after-write
+        if (collide(access.writes, i.range) || (i.write && collide(access.reads, i.range))) {
+            hazard = true;
+            break;
+        }
+    }
+    if (hazard) {
+        // a global memory barrier is cheaper than per-resource barriers on most drivers,
+        // and textures never change their layouts
+        VkMemoryBarrier barrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                             VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT};
+        VkPipelineStageFlags stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+        if (_ray_tracing) {
+            barrier.srcAccessMask |= VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+            barrier.dstAccessMask |= VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR |
+                                     VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+            stages |= VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+        }
+        vkCmdPipelineBarrier(
+            cmd, stages, stages,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+        resource_ranges.clear();
+        _read_all = false;
+    }
+    for (auto &&i : _pending) {
+        auto &access = resource_ranges.try_emplace(i.resource).first->second;
+        (i.write ? access.writes : access.reads).emplace_back(i.range);
+    }
+    _read_all |= _pending_read_all;
+    _pending_read_all = false;
+    _pending.clear();
+}
+void ResourceBarrier::clear() {
+    resource_ranges.clear();
+    _pending.clear();
+    _read_all = false;
+    _pending_read_all = false;
 }
 ResourceBarrier::~ResourceBarrier() {}
 }// namespace lc::vk
@@ -2,7 +2,11 @@
 #include <vulkan/vulkan.h>
 #include <luisa/vstl/common.h>
 namespace lc::vk {
+class Resource;
 class Buffer;
+class Texture;
+// tracks the buffer ranges and texture levels accessed since the last barrier in a command buffer,
+// so that a barrier is only recorded when a command depends on a previous one
 class ResourceBarrier {
     struct Range {
         int64_t min;
@@ -25,11 +29,34 @@ class ResourceBarrier {
         }
         bool operator!=(Range const &r) const { return !operator==(r); }
     };
-    vstd::unordered_map<Buffer const*, vstd::vector<Range>> buffer_ranges;
+    struct Access {
+        vstd::vector<Range> reads;
+        vstd::vector<Range> writes;
+    };
+    struct PendingAccess {
+        Resource const *resource;
+        Range range;
+        bool write;
+    };
+    vstd::unordered_map<Resource const *, Access> resource_ranges;
+    vstd::vector<PendingAccess> _pending;
+    // resources in bindless arrays are not tracked one by one, so reading a bindless array reads everything
+    bool _read_all{false};
+    bool _pending_read_all{false};
+    // acceleration structure builds also read and write resources
+    bool _ray_tracing;
 
 public:
-    ResourceBarrier();
-    void add_buffer(Buffer const *buffer, size_t offset, size_t size);
+    explicit ResourceBarrier(bool ray_tracing);
+    // adds an access of the next command, size = ~0 covers the whole buffer
+    void add_buffer(Buffer const *buffer, size_t offset, size_t size, bool write);
+    // adds an access of a mip level of the next command, level = ~0 covers all levels
+    void add_texture(Texture const *texture, uint level, bool write);
+    // adds a read of every resource by the next command, e.g. through bindless arrays
+    void add_read_all();
+    // records a barrier if the accesses of the next command depend on earlier ones
+    void update(VkCommandBuffer cmd);
+    void clear();
     ~ResourceBarrier();
 };
 }// namespace lc::vk
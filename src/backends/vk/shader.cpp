@@ -1,13 +1,23 @@
 #include "shader.h"
 #include "log.h"
 #include "device.h"
+#include "bindless_heap.h"
 namespace lc::vk {
+SavedArgument::SavedArgument(Function kernel, Variable const &var)
+    : tag{var.type()->tag()},
+      varUsage{kernel.variable_usage(var.uid())},
+      structSize{0u} {
+    if (luisa::to_underlying(tag) < luisa::to_underlying(Type::Tag::BUFFER)) {
+        structSize = var.type()->size();
+    }
+}
 Shader::Shader(
     Device *device,
     ShaderTag tag,
     vstd::vector<Argument> &&captured,
+    vstd::vector<SavedArgument> &&args,
     vstd::span<hlsl::Property const> binds)
-    : Resource{device}, _captured{std::move(captured)} {
+    : Resource{device}, _captured{std::move(captured)}, _args{std::move(args)} {
     VkShaderStageFlagBits stage_bits = [&]() -> VkShaderStageFlagBits {
         switch (tag) {
             case ShaderTag::ComputeShader:
@@ -20,67 +30,121 @@ Shader::Shader(
                 return VK_SHADER_STAGE_ALL;
         }
     }();
-    vstd::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+    // the codegen types the acceleration structure of a read-only accel argument as a buffer,
+    // which is the first of the two properties of the argument
+    vstd::vector<bool> accel_binds(binds.size(), false);
+    {
+        // dsp_c, the samplers, _Global (register 0) and the bindless heaps come before the arguments
+        auto index = 0u;
+        while (index < binds.size() &&
+               (binds[index].type == hlsl::ShaderVariableType::ConstantValue ||
+                binds[index].type == hlsl::ShaderVariableType::SamplerHeap ||
+                binds[index].array_size == std::numeric_limits<uint>::max() ||
+                (binds[index].space_index == 0 && binds[index].register_index == 0))) {
+            ++index;
+        }
+        for (auto &&arg : _args) {
+            switch (arg.tag) {
+                case Type::Tag::ACCEL:
+                    if ((luisa::to_underlying(arg.varUsage) & luisa::to_underlying(Usage::WRITE)) != 0) {
+                        index += 1;
+                    } else {
+                        if (index < binds.size()) accel_binds[index] = true;
+                        index += 2;
+                    }
+                    break;
+                case Type::Tag::BUFFER:
+                case Type::Tag::TEXTURE:
+                case Type::Tag::BINDLESS_ARRAY:
+                case Type::Tag::CUSTOM:
+                    index += 1;
+                    break;
+                default: break;
+            }
+        }
+    }
     vstd::vector<vstd::vector<VkDescriptorSetLayoutBinding>> bindings;
     for (auto &&i : binds) {
         bindings.resize(std::max<size_t>(bindings.size(), i.space_index + 1));
+        _bindless_heaps.resize(bindings.size(), nullptr);
+        // unbounded arrays are the bindless spaces, which use the layouts of the device's heaps
+        if (i.array_size == std::numeric_limits<uint>::max()) {
+            _bindless_heaps[i.space_index] = i.type == hlsl::ShaderVariableType::SRVBufferHeap ?
+                                                 &device->bindless_buffer_heap() :
+                                                 &device->bindless_texture_heap();
+            continue;
+        }
         auto &vec = bindings[i.space_index];
         vec.resize(std::max<size_t>(vec.size(), i.register_index + 1));
         auto &v = vec[i.register_index];
         v.binding = i.register_index;
-        switch (i.type) {
-            case hlsl::ShaderVariableType::ConstantBuffer:
-            case hlsl::ShaderVariableType::ConstantValue:
-            case hlsl::ShaderVariableType::CBVBufferHeap:
-                v.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                break;
-            case hlsl::ShaderVariableType::SRVTextureHeap:
-                v.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-                break;
-            case hlsl::ShaderVariableType::UAVTextureHeap:
-                v.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-                break;
-            case hlsl::ShaderVariableType::StructuredBuffer:
-            case hlsl::ShaderVariableType::RWStructuredBuffer:
-            case hlsl::ShaderVariableType::UAVBufferHeap:
-            case hlsl::ShaderVariableType::SRVBufferHeap:
-                v.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                break;
-            case hlsl::ShaderVariableType::SamplerHeap:
-                v.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-                break;
-            default:
-                assert(false);
-                break;
+        if (accel_binds[&i - binds.data()]) {
+            v.descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+        } else {
+            switch (i.type) {
+                // dsp_c is bound with a dynamic offset, which indirect dispatches move per entry
+                case hlsl::ShaderVariableType::ConstantValue:
+                    v.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                    break;
+                case hlsl::ShaderVariableType::ConstantBuffer:
+                case hlsl::ShaderVariableType::CBVBufferHeap:
+                    v.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                    break;
+                case hlsl::ShaderVariableType::SRVTextureHeap:
+                    v.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                    break;
+                case hlsl::ShaderVariableType::UAVTextureHeap:
+                    v.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                    break;
+                case hlsl::ShaderVariableType::StructuredBuffer:
+                case hlsl::ShaderVariableType::RWStructuredBuffer:
+                case hlsl::ShaderVariableType::UAVBufferHeap:
+                case hlsl::ShaderVariableType::SRVBufferHeap:
+                    v.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    break;
+                case hlsl::ShaderVariableType::SamplerHeap:
+                    v.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+                    break;
+                default:
+                    assert(false);
+                    break;
+            }
         }
         v.descriptorCount = i.array_size;
         v.stageFlags = stage_bits;
         v.pImmutableSamplers = nullptr;
-        vstd::push_back_all(_binds, binds);
     }
+    vstd::push_back_all(_binds, binds);
 
-    descriptorSetLayouts.reserve(bindings.size());
-    for (auto &&i : bindings) {
+    _descriptor_set_layouts.reserve(bindings.size());
+    for (auto set = 0u; set < bindings.size(); ++set) {
+        if (auto heap = _bindless_heaps[set]) {
+            _descriptor_set_layouts.emplace_back(heap->layout());
+            continue;
+        }
+        auto &i = bindings[set];
+        // registers skipped by the codegen leave holes without descriptors
+        auto end = std::remove_if(i.begin(), i.end(), [](auto &&v) { return v.descriptorCount == 0; });
+        i.erase(end, i.end());
         VkDescriptorSetLayoutCreateInfo descriptorLayout{
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
             .bindingCount = static_cast<uint>(i.size()),
             .pBindings = i.data()};
-        auto &r = descriptorSetLayouts.emplace_back();
+        auto &r = _descriptor_set_layouts.emplace_back();
         VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device->logic_device(), &descriptorLayout, nullptr, &r));
     }
 
-    auto disposer = vstd::scope_exit([&] {
-        for (auto &&i : descriptorSetLayouts) {
-            vkDestroyDescriptorSetLayout(device->logic_device(), i, nullptr);
-        }
-    });
     VkPipelineLayoutCreateInfo pPipelineLayoutCreateInfo{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount = static_cast<uint>(descriptorSetLayouts.size()),
-        .pSetLayouts = descriptorSetLayouts.data()};
+        .setLayoutCount = static_cast<uint>(_descriptor_set_layouts.size()),
+        .pSetLayouts = _descriptor_set_layouts.data()};
     VK_CHECK_RESULT(vkCreatePipelineLayout(device->logic_device(), &pPipelineLayoutCreateInfo, nullptr, &_pipeline_layout));
 }
 Shader::~Shader() {
     vkDestroyPipelineLayout(device()->logic_device(), _pipeline_layout, nullptr);
+    for (auto set = 0u; set < _descriptor_set_layouts.size(); ++set) {
+        if (_bindless_heaps[set]) continue;
+        vkDestroyDescriptorSetLayout(device()->logic_device(), _descriptor_set_layouts[set], nullptr);
+    }
 }
 }// namespace lc::vk
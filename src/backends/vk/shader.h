@@ -3,8 +3,17 @@
 #include <vulkan/vulkan.h>
 #include "../common/hlsl/shader_property.h"
 #include <luisa/runtime/rhi/argument.h>
+#include <luisa/ast/function.h>
 namespace lc::vk {
 using namespace luisa::compute;
+class BindlessHeap;
+struct SavedArgument {
+    Type::Tag tag;
+    Usage varUsage;
+    uint structSize;
+    SavedArgument() {}
+    SavedArgument(Function kernel, Variable const &var);
+};
 class Shader : public Resource {
 public:
     enum class ShaderTag : uint {
@@ -14,17 +23,28 @@ public:
 
 protected:
     VkPipelineLayout _pipeline_layout;
+    // kept alive to allocate the descriptor sets of dispatches
+    vstd::vector<VkDescriptorSetLayout> _descriptor_set_layouts;
+    // the device-wide heaps bound to the sets of bindless descriptor arrays, nullptr for the other sets
+    vstd::vector<BindlessHeap *> _bindless_heaps;
     vstd::vector<hlsl::Property> _binds;
     vstd::vector<Argument> _captured;
+    vstd::vector<SavedArgument> _args;
 
 public:
     auto pipeline_layout() const { return _pipeline_layout; }
+    auto descriptor_set_layouts() const { return vstd::span<const VkDescriptorSetLayout>{_descriptor_set_layouts}; }
+    auto bindless_heaps() const { return vstd::span<BindlessHeap *const>{_bindless_heaps}; }
     virtual bool serialize_pso(vstd::vector<std::byte> &result) const { return false; }
     auto binds() const { return vstd::span<const hlsl::Property>{_binds}; }
+    auto captured() const { return vstd::span<const Argument>{_captured}; }
+    // bound arguments first, then the arguments of the dispatch commands
+    auto args() const { return vstd::span<const SavedArgument>{_args}; }
     Shader(
         Device *device,
         ShaderTag tag,
         vstd::vector<Argument> &&captured,
+        vstd::vector<SavedArgument> &&args,
         vstd::span<hlsl::Property const> binds);
     virtual ~Shader();
 };
@@ -81,11 +81,13 @@ ShaderSerializer::DeserResult ShaderSerializer::try_deser_compute(
     // invalid md5 for AOT
     vstd::optional<vstd::MD5> shader_md5,
     vstd::vector<Argument> &&captured,
+    vstd::vector<SavedArgument> &&args,
     vstd::string_view file_name,
     SerdeType serde_type,
     BinaryIO const *bin_io) {
     using namespace detail;
     vstd::vector<hlsl::Property> properties;
+    uint3 block_size;
     vstd::vector<uint> spv;
     DeserResult result{
         .shader = nullptr};
@@ -109,6 +111,7 @@ ShaderSerializer::DeserResult ShaderSerializer::try_deser_compute(
         if (shader_md5 && *shader_md5 != header.md5)
             return result;
         result.type_md5 = header.type_md5;
+        block_size = header.block_size;
         properties.push_back_uninitialized(header.property_size);
         read_stream->read({reinterpret_cast<std::byte *>(properties.data()), properties.size_bytes()});
         spv.push_back_uninitialized(header.spv_byte_size / sizeof(uint));
@@ -143,6 +146,8 @@ ShaderSerializer::DeserResult ShaderSerializer::try_deser_compute(
         properties,
         spv,
         std::move(captured),
+        std::move(args),
+        block_size,
         pso_data};
     if (pso_data.empty() &&
         shader->serialize_pso(pso_data)) {
@@ -12,6 +12,7 @@ namespace lc::vk {
 using namespace luisa;
 class Shader;
 class ComputeShader;
+struct SavedArgument;
 class ShaderSerializer {
 public:
     static void serialize_bytecode(
@@ -38,6 +39,7 @@ public:
         // invalid md5 for AOT
         vstd::optional<vstd::MD5> shader_md5,
         vstd::vector<Argument> &&captured,
+        vstd::vector<SavedArgument> &&args,
         vstd::string_view file_name,
         SerdeType serde_type,
         BinaryIO const *bin_io);
@@ -1 +1,824 @@
+#include "stream.h"
+#include "device.h"
+#include "event.h"
+#include "default_buffer.h"
+#include "texture.h"
+#include "bindless_array.h"
+#include "bindless_heap.h"
+#include "compute_shader.h"
+#include "builtin_kernel.h"
+#include "top_accel.h"
+#include "log.h"
+#include <luisa/vstl/functional.h>
+#include <luisa/runtime/rhi/command.h>
+namespace lc::vk {
+namespace detail {
+static constexpr uint32_t descriptor_pool_set_count = 64u;
+class StreamVisitor final : public CommandVisitor {
+public:
+    Device *device;
+    ResourceBarrier *barrier;
+    VkCommandBuffer cmd;
+    vstd::function<VkDescriptorSet(VkDescriptorSetLayout)> allocate_set;
+    StagingAllocator<UploadBuffer> *upload;
+    StagingAllocator<ReadbackBuffer> *readback;
+    StagingAllocator<DefaultBuffer> *scratch;
+    vstd::function<void(ReadbackBuffer *, size_t, void *, size_t)> add_readback;
+    vstd::function<void(vstd::function<void()> &&)> execute_after_complete;
+    vstd::vector<VkBufferCopy> copy_regions;
+    vstd::vector<BindlessArray::BindlessStruct> bindless_slots;
+    vstd::vector<std::byte> uniform_data;
+    vstd::vector<VkDescriptorBufferInfo> buffer_infos;
+    vstd::vector<VkDescriptorImageInfo> sampler_infos;
+    vstd::vector<VkDescriptorImageInfo> image_infos;
+    vstd::vector<VkWriteDescriptorSet> writes;
+    vstd::vector<VkDescriptorSet> sets;
+    vstd::vector<VkAccelerationStructureKHR> accel_handles;
+    vstd::vector<VkWriteDescriptorSetAccelerationStructureKHR> accel_infos;
+    vstd::vector<AccelBuildCommand::Modification> accel_modifications;
 
+    AccelBuildContext accel_build_context() {
+        return AccelBuildContext{
+            .cmd = this->cmd,
+            .barrier = barrier,
+            .scratch = scratch,
+            .execute_after_complete = &execute_after_complete};
+    }
+
+    void visit(const BufferUploadCommand *cmd) noexcept override {
+        if (cmd->size() == 0) return;
+        auto dst = reinterpret_cast<Buffer const *>(cmd->handle());
+        auto staging = upload->allocate(cmd->size(), 16);
+        staging.buffer->copy_from(cmd->data(), staging.offset, cmd->size());
+        barrier->add_buffer(dst, cmd->offset(), cmd->size(), true);
+        barrier->update(this->cmd);
+        VkBufferCopy region{
+            .srcOffset = staging.offset,
+            .dstOffset = cmd->offset(),
+            .size = cmd->size()};
+        vkCmdCopyBuffer(this->cmd, staging.buffer->vk_buffer(), dst->vk_buffer(), 1, &region);
+    }
+    void visit(const BufferDownloadCommand *cmd) noexcept override {
+        if (cmd->size() == 0) return;
+        auto src = reinterpret_cast<Buffer const *>(cmd->handle());
+        auto staging = readback->allocate(cmd->size(), 16);
+        barrier->add_buffer(src, cmd->offset(), cmd->size(), false);
+        barrier->update(this->cmd);
+        VkBufferCopy region{
+            .srcOffset = cmd->offset(),
+            .dstOffset = staging.offset,
+            .size = cmd->size()};
+        vkCmdCopyBuffer(this->cmd, src->vk_buffer(), staging.buffer->vk_buffer(), 1, &region);
+        add_readback(staging.buffer, staging.offset, cmd->data(), cmd->size());
+    }
+    void visit(const BufferCopyCommand *cmd) noexcept override {
+        if (cmd->size() == 0) return;
+        auto src = reinterpret_cast<Buffer const *>(cmd->src_handle());
+        auto dst = reinterpret_cast<Buffer const *>(cmd->dst_handle());
+        barrier->add_buffer(src, cmd->src_offset(), cmd->size(), false);
+        barrier->add_buffer(dst, cmd->dst_offset(), cmd->size(), true);
+        barrier->update(this->cmd);
+        VkBufferCopy region{
+            .srcOffset = cmd->src_offset(),
+            .dstOffset = cmd->dst_offset(),
+            .size = cmd->size()};
+        vkCmdCopyBuffer(this->cmd, src->vk_buffer(), dst->vk_buffer(), 1, &region);
+    }
+    void visit(const ShaderDispatchCommand *cmd) noexcept override;
+    struct IndirectDispatch {
+        StagingAllocator<DefaultBuffer>::View args{};
+        StagingAllocator<DefaultBuffer>::View constants{};
+        size_t constant_stride{0};
+        uint count{0};
+    };
+    // converts the entries of an indirect dispatch buffer to the arguments and dsp_c of each dispatch
+    IndirectDispatch prepare_indirect_dispatch(IndirectDispatchArg const &arg);
+    void copy_buffer_texture(Buffer const *buffer, size_t buffer_offset, Texture const *texture,
+                             uint level, uint3 offset, uint3 size, bool to_texture) {
+        VkBufferImageCopy region{
+            .bufferOffset = buffer_offset,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = texture->subresource_layers(level),
+            .imageOffset = {static_cast<int32_t>(offset.x), static_cast<int32_t>(offset.y), static_cast<int32_t>(offset.z)},
+            .imageExtent = {size.x, size.y, size.z}};
+        if (to_texture) {
+            vkCmdCopyBufferToImage(this->cmd, buffer->vk_buffer(), texture->vk_image(), VK_IMAGE_LAYOUT_GENERAL, 1, &region);
+        } else {
+            vkCmdCopyImageToBuffer(this->cmd, texture->vk_image(), VK_IMAGE_LAYOUT_GENERAL, buffer->vk_buffer(), 1, &region);
+        }
+    }
+    void visit(const BufferToTextureCopyCommand *cmd) noexcept override {
+        auto src = reinterpret_cast<Buffer const *>(cmd->buffer());
+        auto dst = reinterpret_cast<Texture const *>(cmd->texture());
+        barrier->add_buffer(src, cmd->buffer_offset(), pixel_storage_size(cmd->storage(), cmd->size()), false);
+        barrier->add_texture(dst, cmd->level(), true);
+        barrier->update(this->cmd);
+        copy_buffer_texture(src, cmd->buffer_offset(), dst, cmd->level(), cmd->texture_offset(), cmd->size(), true);
+    }
+    void visit(const TextureUploadCommand *cmd) noexcept override {
+        auto dst = reinterpret_cast<Texture const *>(cmd->handle());
+        auto size_bytes = pixel_storage_size(cmd->storage(), cmd->size());
+        // offsets of buffer-image copies must be multiples of the texel block size, which divides 16
+        auto staging = upload->allocate(size_bytes, 16);
+        staging.buffer->copy_from(cmd->data(), staging.offset, size_bytes);
+        barrier->add_texture(dst, cmd->level(), true);
+        barrier->update(this->cmd);
+        copy_buffer_texture(staging.buffer, staging.offset, dst, cmd->level(), cmd->offset(), cmd->size(), true);
+    }
+    void visit(const TextureDownloadCommand *cmd) noexcept override {
+        auto src = reinterpret_cast<Texture const *>(cmd->handle());
+        auto size_bytes = pixel_storage_size(cmd->storage(), cmd->size());
+        auto staging = readback->allocate(size_bytes, 16);
+        barrier->add_texture(src, cmd->level(), false);
+        barrier->update(this->cmd);
+        copy_buffer_texture(staging.buffer, staging.offset, src, cmd->level(), cmd->offset(), cmd->size(), false);
+        add_readback(staging.buffer, staging.offset, cmd->data(), size_bytes);
+    }
+    void visit(const TextureCopyCommand *cmd) noexcept override {
+        auto src = reinterpret_cast<Texture const *>(cmd->src_handle());
+        auto dst = reinterpret_cast<Texture const *>(cmd->dst_handle());
+        barrier->add_texture(src, cmd->src_level(), false);
+        barrier->add_texture(dst, cmd->dst_level(), true);
+        barrier->update(this->cmd);
+        auto src_offset = cmd->src_offset();
+        auto dst_offset = cmd->dst_offset();
+        auto size = cmd->size();
+        VkImageCopy region{
+            .srcSubresource = src->subresource_layers(cmd->src_level()),
+            .srcOffset = {static_cast<int32_t>(src_offset[0]), static_cast<int32_t>(src_offset[1]), static_cast<int32_t>(src_offset[2])},
+            .dstSubresource = dst->subresource_layers(cmd->dst_level()),
+            .dstOffset = {static_cast<int32_t>(dst_offset[0]), static_cast<int32_t>(dst_offset[1]), static_cast<int32_t>(dst_offset[2])},
+            .extent = {size.x, size.y, size.z}};
+        vkCmdCopyImage(this->cmd, src->vk_image(), VK_IMAGE_LAYOUT_GENERAL, dst->vk_image(), VK_IMAGE_LAYOUT_GENERAL, 1, &region);
+    }
+    void visit(const TextureToBufferCopyCommand *cmd) noexcept override {
+        auto src = reinterpret_cast<Texture const *>(cmd->texture());
+        auto dst = reinterpret_cast<Buffer const *>(cmd->buffer());
+        barrier->add_texture(src, cmd->level(), false);
+        barrier->add_buffer(dst, cmd->buffer_offset(), pixel_storage_size(cmd->storage(), cmd->size()), true);
+        barrier->update(this->cmd);
+        copy_buffer_texture(dst, cmd->buffer_offset(), src, cmd->level(), cmd->texture_offset(), cmd->size(), false);
+    }
+    void visit(const AccelBuildCommand *cmd) noexcept override {
+        auto accel = reinterpret_cast<TopAccel *>(cmd->handle());
+        auto ctx = accel_build_context();
+        accel->prepare(ctx, cmd->instance_count(), cmd->modifications(), accel_modifications);
+        if (!accel_modifications.empty()) {
+            set_accel_instances(accel);
+        }
+        if (!cmd->update_instance_buffer_only()) {
+            accel->build(ctx, cmd->request() == AccelBuildRequest::PREFER_UPDATE);
+        }
+    }
+    void visit(const MeshBuildCommand *cmd) noexcept override {
+        auto mesh = reinterpret_cast<BottomAccel *>(cmd->handle());
+        auto vertex_buffer = reinterpret_cast<Buffer const *>(cmd->vertex_buffer());
+        auto triangle_buffer = reinterpret_cast<Buffer const *>(cmd->triangle_buffer());
+        auto vertex_count = static_cast<uint>(cmd->vertex_buffer_size() / cmd->vertex_stride());
+        barrier->add_buffer(vertex_buffer, cmd->vertex_buffer_offset(), cmd->vertex_buffer_size(), false);
+        barrier->add_buffer(triangle_buffer, cmd->triangle_buffer_offset(), cmd->triangle_buffer_size(), false);
+        VkAccelerationStructureGeometryKHR geometry{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+            .geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR,
+            .geometry = {.triangles = {
+                             .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR,
+                             .vertexFormat = VK_FORMAT_R32G32B32_SFLOAT,
+                             .vertexData = {.deviceAddress = vertex_buffer->device_address() + cmd->vertex_buffer_offset()},
+                             .vertexStride = cmd->vertex_stride(),
+                             .maxVertex = std::max(vertex_count, 1u) - 1u,
+                             .indexType = VK_INDEX_TYPE_UINT32,
+                             .indexData = {.deviceAddress = triangle_buffer->device_address() + cmd->triangle_buffer_offset()}}},
+            .flags = VK_GEOMETRY_OPAQUE_BIT_KHR};
+        mesh->build(accel_build_context(), geometry,
+                    static_cast<uint>(cmd->triangle_buffer_size() / (3u * sizeof(uint))), vertex_count,
+                    cmd->request() == AccelBuildRequest::PREFER_UPDATE);
+    }
+    void visit(const ProceduralPrimitiveBuildCommand *cmd) noexcept override {
+        // the AABBs are pairs of float3, the same as D3D12_RAYTRACING_AABB
+        static constexpr size_t aabb_stride = 6u * sizeof(float);
+        auto mesh = reinterpret_cast<BottomAccel *>(cmd->handle());
+        auto aabb_buffer = reinterpret_cast<Buffer const *>(cmd->aabb_buffer());
+        barrier->add_buffer(aabb_buffer, cmd->aabb_buffer_offset(), cmd->aabb_buffer_size(), false);
+        VkAccelerationStructureGeometryKHR geometry{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+            .geometryType = VK_GEOMETRY_TYPE_AABBS_KHR,
+            .geometry = {.aabbs = {
+                             .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_AABBS_DATA_KHR,
+                             .data = {.deviceAddress = aabb_buffer->device_address() + cmd->aabb_buffer_offset()},
+                             .stride = aabb_stride}}};
+        mesh->build(accel_build_context(), geometry,
+                    static_cast<uint>(cmd->aabb_buffer_size() / aabb_stride), 0u,
+                    cmd->request() == AccelBuildRequest::PREFER_UPDATE);
+    }
+    // writes accel_modifications to the instances with the accel set kernel
+    void set_accel_instances(TopAccel *accel);
+    void visit(const BindlessArrayUpdateCommand *cmd) noexcept override {
+        auto mods = cmd->modifications();
+        if (mods.empty()) return;
+        auto array = reinterpret_cast<BindlessArray *>(cmd->handle());
+        // descriptors are written now to indices no command in flight uses, and the slots are copied in stream order
+        bindless_slots.resize_uninitialized(mods.size());
+        array->bind(mods, bindless_slots.data());
+        auto slot_size = sizeof(BindlessArray::BindlessStruct);
+        auto staging = upload->allocate(bindless_slots.size() * slot_size, 16);
+        staging.buffer->copy_from(bindless_slots.data(), staging.offset, bindless_slots.size() * slot_size);
+        copy_regions.clear();
+        for (auto i = 0u; i < mods.size(); ++i) {
+            barrier->add_buffer(array->buffer(), mods[i].slot * slot_size, slot_size, true);
+            copy_regions.emplace_back(VkBufferCopy{
+                .srcOffset = staging.offset + i * slot_size,
+                .dstOffset = mods[i].slot * slot_size,
+                .size = slot_size});
+        }
+        barrier->update(this->cmd);
+        vkCmdCopyBuffer(this->cmd, staging.buffer->vk_buffer(), array->buffer()->vk_buffer(),
+                        static_cast<uint>(copy_regions.size()), copy_regions.data());
+        auto retired = array->steal_retired_indices();
+        if (!retired.empty()) {
+            execute_after_complete([device = device, retired = std::move(retired)] {
+                BindlessArray::return_indices(device, retired);
+            });
+        }
+    }
+    void visit(const CustomCommand *) noexcept override {
+        LUISA_ERROR_WITH_LOCATION("Custom commands are not supported by the Vulkan backend.");
+    }
+};
+void StreamVisitor::visit(const ShaderDispatchCommand *cmd) noexcept {
+    auto shader = reinterpret_cast<ComputeShader const *>(cmd->handle());
+    auto &&limits = device->properties().limits;
+    // dsp_c of every dispatch: one constant of a direct dispatch, or one per entry of an indirect one
+    VkBuffer dsp_c_buffer{};
+    size_t dsp_c_offset{0};
+    size_t dsp_c_stride{0};
+    IndirectDispatch indirect{};
+    if (cmd->is_indirect()) {
+        indirect = prepare_indirect_dispatch(cmd->indirect_dispatch());
+        if (indirect.count == 0) return;
+        dsp_c_buffer = indirect.constants.buffer->vk_buffer();
+        dsp_c_offset = indirect.constants.offset;
+        dsp_c_stride = indirect.constant_stride;
+    } else {
+        auto dispatch_size = cmd->dispatch_size();
+        if (any(dispatch_size == 0u)) return;
+        auto dsp_c = make_uint4(dispatch_size, 0u);
+        auto staging = upload->allocate(sizeof(uint4), limits.minUniformBufferOffsetAlignment);
+        staging.buffer->copy_from(&dsp_c, staging.offset, sizeof(uint4));
+        dsp_c_buffer = staging.buffer->vk_buffer();
+        dsp_c_offset = staging.offset;
+    }
+    // pack the uniforms as the _Args structure of the codegen, the same as the DirectX backend
+    uniform_data.clear();
+    auto saved_arg = shader->args().data();
+    auto pack_uniforms = [&](vstd::span<const Argument> args) {
+        for (auto &&arg : args) {
+            if (arg.tag == Argument::Tag::UNIFORM) {
+                auto bf = cmd->uniform(arg.uniform);
+                auto offset = uniform_data.size();
+                if (bf.size() < 4) {
+                    uniform_data.push_back_uninitialized(sizeof(uint));
+                    uint value = static_cast<bool>(bf[0]) ? std::numeric_limits<uint>::max() : 0u;
+                    memcpy(uniform_data.data() + offset, &value, sizeof(uint));
+                } else {
+                    uniform_data.push_back_uninitialized(saved_arg->structSize);
+                    memcpy(uniform_data.data() + offset, bf.data(), saved_arg->structSize);
+                }
+            }
+            ++saved_arg;
+        }
+    };
+    pack_uniforms(shader->captured());
+    pack_uniforms(cmd->arguments());
+    uniform_data.resize_uninitialized((uniform_data.size() + 15u) & ~static_cast<size_t>(15u));
+
+    sets.clear();
+    auto layouts = shader->descriptor_set_layouts();
+    for (auto i = 0u; i < layouts.size(); ++i) {
+        if (auto heap = shader->bindless_heaps()[i]) {
+            sets.emplace_back(heap->set());
+        } else {
+            sets.emplace_back(allocate_set(layouts[i]));
+        }
+    }
+    buffer_infos.clear();
+    sampler_infos.clear();
+    image_infos.clear();
+    writes.clear();
+    // the infos are referenced by the writes and must not be reallocated
+    buffer_infos.reserve(shader->binds().size());
+    image_infos.reserve(shader->binds().size());
+    accel_handles.clear();
+    accel_infos.clear();
+    accel_handles.reserve(shader->binds().size());
+    accel_infos.reserve(shader->binds().size());
+    auto write_buffer = [&](hlsl::Property const &prop, VkBuffer buffer, size_t offset, size_t size) {
+        auto &info = buffer_infos.emplace_back(VkDescriptorBufferInfo{
+            .buffer = buffer,
+            .offset = offset,
+            .range = size});
+        writes.emplace_back(VkWriteDescriptorSet{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = sets[prop.space_index],
+            .dstBinding = prop.register_index,
+            .descriptorCount = 1,
+            .descriptorType = prop.type == hlsl::ShaderVariableType::ConstantValue ?
+                                  VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC :
+                              prop.type == hlsl::ShaderVariableType::ConstantBuffer ?
+                                  VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER :
+                                  VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &info});
+    };
+    // properties of the SPIR-V codegen: dsp_c, samplers, _Global (uniforms), bindless heaps, then the arguments
+    auto binds = shader->binds();
+    auto bind = binds.begin();
+    auto has_dsp_c = false;
+    for (; bind != binds.end(); ++bind) {
+        auto &&prop = *bind;
+        if (prop.type == hlsl::ShaderVariableType::ConstantValue) {
+            // the offset is given when binding the set
+            write_buffer(prop, dsp_c_buffer, 0, sizeof(uint4));
+            has_dsp_c = true;
+        } else if (prop.type == hlsl::ShaderVariableType::SamplerHeap) {
+            auto samplers = device->samplers();
+            sampler_infos.reserve(samplers.size());
+            for (auto &&s : samplers) {
+                sampler_infos.emplace_back(VkDescriptorImageInfo{.sampler = s});
+            }
+            writes.emplace_back(VkWriteDescriptorSet{
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = sets[prop.space_index],
+                .dstBinding = prop.register_index,
+                .descriptorCount = static_cast<uint>(samplers.size()),
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+                .pImageInfo = sampler_infos.data()});
+        } else if (prop.space_index == 0 && prop.register_index == 0) {
+            // arguments start from register 2 in SPIR-V, so register 0 can only be _Global
+            auto staging = upload->allocate(uniform_data.size(), limits.minStorageBufferOffsetAlignment);
+            staging.buffer->copy_from(uniform_data.data(), staging.offset, uniform_data.size());
+            write_buffer(prop, staging.buffer->vk_buffer(), staging.offset, uniform_data.size());
+        } else if (prop.space_index >= 2) {
+            // the bindless heaps are written by the updates of bindless arrays
+            continue;
+        } else {
+            break;
+        }
+    }
+    saved_arg = shader->args().data();
+    auto bind_resources = [&](vstd::span<const Argument> args) {
+        for (auto &&arg : args) {
+            switch (arg.tag) {
+                case Argument::Tag::BUFFER: {
+                    auto buffer = reinterpret_cast<Buffer const *>(arg.buffer.handle);
+                    if (arg.buffer.offset % limits.minStorageBufferOffsetAlignment != 0) [[unlikely]] {
+                        LUISA_ERROR_WITH_LOCATION(
+                            "Buffer offset {} is not aligned to {} bytes required by the Vulkan device.",
+                            arg.buffer.offset, limits.minStorageBufferOffsetAlignment);
+                    }
+                    barrier->add_buffer(buffer, arg.buffer.offset, arg.buffer.size,
+                                        (luisa::to_underlying(saved_arg->varUsage) & luisa::to_underlying(Usage::WRITE)) != 0);
+                    LUISA_ASSERT(bind != binds.end(), "Shader has fewer bindings than arguments.");
+                    write_buffer(*bind++, buffer->vk_buffer(), arg.buffer.offset, arg.buffer.size);
+                } break;
+                case Argument::Tag::UNIFORM:
+                    break;
+                case Argument::Tag::TEXTURE: {
+                    auto texture = reinterpret_cast<Texture const *>(arg.texture.handle);
+                    LUISA_ASSERT(bind != binds.end(), "Shader has fewer bindings than arguments.");
+                    auto &&prop = *bind++;
+                    // writable textures are storage images, read-only ones are sampled images read with Load
+                    auto writable = prop.type == hlsl::ShaderVariableType::UAVTextureHeap;
+                    if (writable && !texture->is_storage()) [[unlikely]] {
+                        LUISA_ERROR_WITH_LOCATION("Pixel format {} cannot be written by shaders on this Vulkan device.",
+                                                  luisa::to_underlying(texture->format()));
+                    }
+                    barrier->add_texture(texture, arg.texture.level,
+                                         (luisa::to_underlying(saved_arg->varUsage) & luisa::to_underlying(Usage::WRITE)) != 0);
+                    auto &info = image_infos.emplace_back(VkDescriptorImageInfo{
+                        .imageView = texture->level_view(arg.texture.level),
+                        .imageLayout = VK_IMAGE_LAYOUT_GENERAL});
+                    writes.emplace_back(VkWriteDescriptorSet{
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                        .dstSet = sets[prop.space_index],
+                        .dstBinding = prop.register_index,
+                        .descriptorCount = 1,
+                        .descriptorType = writable ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                        .pImageInfo = &info});
+                } break;
+                case Argument::Tag::BINDLESS_ARRAY: {
+                    auto array = reinterpret_cast<BindlessArray const *>(arg.bindless_array.handle);
+                    barrier->add_buffer(array->buffer(), 0, std::numeric_limits<size_t>::max(), false);
+                    barrier->add_read_all();
+                    LUISA_ASSERT(bind != binds.end(), "Shader has fewer bindings than arguments.");
+                    write_buffer(*bind++, array->buffer()->vk_buffer(), 0, VK_WHOLE_SIZE);
+                } break;
+                case Argument::Tag::ACCEL: {
+                    auto accel = reinterpret_cast<TopAccel const *>(arg.accel.handle);
+                    LUISA_ASSERT(bind != binds.end(), "Shader has fewer bindings than arguments.");
+                    if ((luisa::to_underlying(saved_arg->varUsage) & luisa::to_underlying(Usage::WRITE)) != 0) {
+                        // writable accels are only their instances
+                        barrier->add_buffer(accel->instance_buffer(), 0, std::numeric_limits<size_t>::max(), true);
+                        write_buffer(*bind++, accel->instance_buffer()->vk_buffer(), 0, VK_WHOLE_SIZE);
+                        break;
+                    }
+                    if (accel->handle() == VK_NULL_HANDLE || !accel->instance_buffer()) [[unlikely]] {
+                        LUISA_ERROR_WITH_LOCATION("Acceleration structure is used before it is built.");
+                    }
+                    // the bottom-level structures of the instances are not tracked one by one
+                    barrier->add_buffer(accel->buffer(), 0, std::numeric_limits<size_t>::max(), false);
+                    barrier->add_buffer(accel->instance_buffer(), 0, std::numeric_limits<size_t>::max(), false);
+                    barrier->add_read_all();
+                    auto &&prop = *bind++;
+                    auto &handle = accel_handles.emplace_back(accel->handle());
+                    auto &info = accel_infos.emplace_back(VkWriteDescriptorSetAccelerationStructureKHR{
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR,
+                        .accelerationStructureCount = 1,
+                        .pAccelerationStructures = &handle});
+                    writes.emplace_back(VkWriteDescriptorSet{
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                        .pNext = &info,
+                        .dstSet = sets[prop.space_index],
+                        .dstBinding = prop.register_index,
+                        .descriptorCount = 1,
+                        .descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR});
+                    // followed by the instances of the structure
+                    LUISA_ASSERT(bind != binds.end(), "Shader has fewer bindings than arguments.");
+                    write_buffer(*bind++, accel->instance_buffer()->vk_buffer(), 0, VK_WHOLE_SIZE);
+                } break;
+                default:
+                    LUISA_ERROR_WITH_LOCATION("Invalid argument.");
+            }
+            ++saved_arg;
+        }
+    };
+    bind_resources(shader->captured());
+    bind_resources(cmd->arguments());
+    barrier->update(this->cmd);
+    vkUpdateDescriptorSets(device->logic_device(), static_cast<uint>(writes.size()), writes.data(), 0, nullptr);
+    vkCmdBindPipeline(this->cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shader->pipeline());
+    auto dynamic_offset = static_cast<uint>(dsp_c_offset);
+    vkCmdBindDescriptorSets(
+        this->cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shader->pipeline_layout(),
+        0, static_cast<uint>(sets.size()), sets.data(), has_dsp_c ? 1u : 0u, &dynamic_offset);
+    if (!cmd->is_indirect()) {
+        auto block_size = shader->block_size();
+        auto blocks = (cmd->dispatch_size() + block_size - 1u) / block_size;
+        vkCmdDispatch(this->cmd, blocks.x, blocks.y, blocks.z);
+        return;
+    }
+    for (auto i = 0u; i < indirect.count; ++i) {
+        // dsp_c is in set 0, the only set with a dynamic descriptor
+        if (i != 0 && has_dsp_c) {
+            dynamic_offset = static_cast<uint>(dsp_c_offset + i * dsp_c_stride);
+            vkCmdBindDescriptorSets(
+                this->cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shader->pipeline_layout(),
+                0, 1, sets.data(), 1, &dynamic_offset);
+        }
+        vkCmdDispatchIndirect(this->cmd, indirect.args.buffer->vk_buffer(),
+                              indirect.args.offset + i * sizeof(VkDispatchIndirectCommand));
+    }
+}
+StreamVisitor::IndirectDispatch StreamVisitor::prepare_indirect_dispatch(IndirectDispatchArg const &arg) {
+    IndirectDispatch result;
+    auto buffer = reinterpret_cast<Buffer const *>(arg.handle);
+    auto capacity = (buffer->byte_size() - sizeof(uint)) / BuiltinKernel::dispatch_indirect_stride;
+    // at most max_dispatch_size entries from the offset, the same as the DirectX backend
+    if (arg.offset >= capacity) return result;
+    result.count = static_cast<uint>(std::min<size_t>(arg.max_dispatch_size, capacity - arg.offset));
+    if (result.count == 0) return result;
+    auto &&limits = device->properties().limits;
+    auto alignment = std::max(limits.minStorageBufferOffsetAlignment, limits.minUniformBufferOffsetAlignment);
+    result.constant_stride = (sizeof(uint4) + limits.minUniformBufferOffsetAlignment - 1) /
+                             limits.minUniformBufferOffsetAlignment * limits.minUniformBufferOffsetAlignment;
+    result.args = scratch->allocate(result.count * sizeof(VkDispatchIndirectCommand), alignment);
+    result.constants = scratch->allocate(result.count * result.constant_stride, alignment);
+    auto params = make_uint4(arg.offset, result.count, static_cast<uint>(result.constant_stride / sizeof(uint4)), 0u);
+    auto staging = upload->allocate(sizeof(uint4), limits.minStorageBufferOffsetAlignment);
+    staging.buffer->copy_from(&params, staging.offset, sizeof(uint4));
+    // the entries are usually written by an earlier kernel
+    barrier->add_buffer(buffer, 0, std::numeric_limits<size_t>::max(), false);
+    barrier->update(this->cmd);
+    auto kernel = device->indirect_kernel();
+    auto set = allocate_set(kernel->descriptor_set_layouts()[0]);
+    VkDescriptorBufferInfo infos[] = {
+        {staging.buffer->vk_buffer(), staging.offset, sizeof(uint4)},
+        {buffer->vk_buffer(), 0, VK_WHOLE_SIZE},
+        {result.args.buffer->vk_buffer(), result.args.offset, result.count * sizeof(VkDispatchIndirectCommand)},
+        {result.constants.buffer->vk_buffer(), result.constants.offset, result.count * result.constant_stride}};
+    VkWriteDescriptorSet kernel_writes[4];
+    for (auto i = 0u; i < 4u; ++i) {
+        kernel_writes[i] = VkWriteDescriptorSet{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = set,
+            .dstBinding = i,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &infos[i]};
+    }
+    vkUpdateDescriptorSets(device->logic_device(), 4, kernel_writes, 0, nullptr);
+    vkCmdBindPipeline(this->cmd, VK_PIPELINE_BIND_POINT_COMPUTE, kernel->pipeline());
+    vkCmdBindDescriptorSets(
+        this->cmd, VK_PIPELINE_BIND_POINT_COMPUTE, kernel->pipeline_layout(),
+        0, 1, &set, 0, nullptr);
+    auto block_size = kernel->block_size().x;
+    vkCmdDispatch(this->cmd, (result.count + block_size - 1u) / block_size, 1, 1);
+    // the arguments are read by the indirect dispatches, and the constants by their kernels
+    VkMemoryBarrier mem_barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT};
+    vkCmdPipelineBarrier(
+        this->cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &mem_barrier, 0, nullptr, 0, nullptr);
+    return result;
+}
+void StreamVisitor::set_accel_instances(TopAccel *accel) {
+    auto &&limits = device->properties().limits;
+    auto count = static_cast<uint>(accel_modifications.size());
+    auto mods_size = accel_modifications.size() * sizeof(AccelBuildCommand::Modification);
+    auto params = make_uint4(count, accel->instance_count(), 0u, 0u);
+    auto staging = upload->allocate(sizeof(uint4), limits.minStorageBufferOffsetAlignment);
+    staging.buffer->copy_from(&params, staging.offset, sizeof(uint4));
+    auto mods = upload->allocate(mods_size, limits.minStorageBufferOffsetAlignment);
+    mods.buffer->copy_from(accel_modifications.data(), mods.offset, mods_size);
+    auto instance_buffer = accel->instance_buffer();
+    barrier->add_buffer(instance_buffer, 0, std::numeric_limits<size_t>::max(), true);
+    barrier->update(this->cmd);
+    auto kernel = device->accel_set_kernel();
+    auto set = allocate_set(kernel->descriptor_set_layouts()[0]);
+    VkDescriptorBufferInfo infos[] = {
+        {staging.buffer->vk_buffer(), staging.offset, sizeof(uint4)},
+        {mods.buffer->vk_buffer(), mods.offset, mods_size},
+        {instance_buffer->vk_buffer(), 0, VK_WHOLE_SIZE}};
+    VkWriteDescriptorSet kernel_writes[3];
+    for (auto i = 0u; i < 3u; ++i) {
+        kernel_writes[i] = VkWriteDescriptorSet{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = set,
+            .dstBinding = i,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &infos[i]};
+    }
+    vkUpdateDescriptorSets(device->logic_device(), 3, kernel_writes, 0, nullptr);
+    vkCmdBindPipeline(this->cmd, VK_PIPELINE_BIND_POINT_COMPUTE, kernel->pipeline());
+    vkCmdBindDescriptorSets(
+        this->cmd, VK_PIPELINE_BIND_POINT_COMPUTE, kernel->pipeline_layout(),
+        0, 1, &set, 0, nullptr);
+    auto block_size = kernel->block_size().x;
+    vkCmdDispatch(this->cmd, (count + block_size - 1u) / block_size, 1, 1);
+}
+}// namespace detail
+Stream::Stream(Device *device, StreamTag tag)
+    : Resource{device}, _queue{device->queue(tag)}, _barrier{device->ray_tracing_enabled()} {
+    VkCommandPoolCreateInfo pool_ci{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = device->queue_family_index(tag)};
+    VK_CHECK_RESULT(vkCreateCommandPool(device->logic_device(), &pool_ci, nullptr, &_pool));
+    VkSemaphoreTypeCreateInfo type_ci{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0};
+    VkSemaphoreCreateInfo semaphore_ci{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type_ci};
+    VK_CHECK_RESULT(vkCreateSemaphore(device->logic_device(), &semaphore_ci, nullptr, &_timeline));
+    _thread = std::thread{[this] { _complete_frames(); }};
+}
+Stream::~Stream() {
+    synchronize();
+    {
+        std::lock_guard lck{_mtx};
+        _stop = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+    auto logic_device = device()->logic_device();
+    for (auto &&frame : _free_frames) {
+        for (auto &&pool : frame->descriptor_pools) {
+            vkDestroyDescriptorPool(logic_device, pool, nullptr);
+        }
+        vkFreeCommandBuffers(logic_device, _pool, 1, &frame->cmd);
+    }
+    _free_frames.clear();
+    vkDestroyCommandPool(logic_device, _pool, nullptr);
+    vkDestroySemaphore(logic_device, _timeline, nullptr);
+}
+vstd::unique_ptr<Stream::Frame> Stream::_acquire_frame() {
+    vstd::unique_ptr<Frame> frame;
+    {
+        std::lock_guard lck{_mtx};
+        if (!_free_frames.empty()) {
+            frame = std::move(_free_frames.back());
+            _free_frames.pop_back();
+        }
+    }
+    if (!frame) {
+        frame = vstd::make_unique<Frame>(device());
+        VkCommandBufferAllocateInfo cb_ci{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = _pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1};
+        VK_CHECK_RESULT(vkAllocateCommandBuffers(device()->logic_device(), &cb_ci, &frame->cmd));
+    }
+    // everything of a free frame has been consumed by the completion thread
+    for (auto &&pool : frame->descriptor_pools) {
+        VK_CHECK_RESULT(vkResetDescriptorPool(device()->logic_device(), pool, 0));
+    }
+    frame->descriptor_pool_index = 0;
+    frame->upload.reset();
+    frame->readback.reset();
+    frame->scratch.reset();
+    return frame;
+}
+VkDescriptorSet Stream::_allocate_descriptor_set(Frame &frame, VkDescriptorSetLayout layout) {
+    VkDescriptorSetAllocateInfo alloc_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &layout};
+    for (;; ++frame.descriptor_pool_index) {
+        auto new_pool = frame.descriptor_pool_index == frame.descriptor_pools.size();
+        if (new_pool) {
+            using namespace detail;
+            VkDescriptorPoolSize sizes[] = {
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, descriptor_pool_set_count * 16u},
+                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, descriptor_pool_set_count},
+                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, descriptor_pool_set_count},
+                {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, descriptor_pool_set_count * 8u},
+                {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, descriptor_pool_set_count * 8u},
+                {VK_DESCRIPTOR_TYPE_SAMPLER, descriptor_pool_set_count * 16u},
+                {VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, descriptor_pool_set_count}};
+            // the last size is only valid with the acceleration structure extension
+            auto size_count = vstd::array_count(sizes) - (device()->ray_tracing_enabled() ? 0u : 1u);
+            VkDescriptorPoolCreateInfo pool_ci{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                .maxSets = descriptor_pool_set_count,
+                .poolSizeCount = static_cast<uint>(size_count),
+                .pPoolSizes = sizes};
+            VK_CHECK_RESULT(vkCreateDescriptorPool(device()->logic_device(), &pool_ci, nullptr, &frame.descriptor_pools.emplace_back()));
+        }
+        alloc_info.descriptorPool = frame.descriptor_pools[frame.descriptor_pool_index];
+        VkDescriptorSet set;
+        auto result = vkAllocateDescriptorSets(device()->logic_device(), &alloc_info, &set);
+        if (result == VK_SUCCESS) return set;
+        if (new_pool || (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)) [[unlikely]] {
+            LUISA_ERROR("Failed to allocate descriptor set: {}.", vks::tools::errorString(result));
+        }
+    }
+}
+uint64_t Stream::_submit(VkCommandBuffer cmd, VkSemaphore signal_semaphore, uint64_t signal_value) {
+    auto wait_value = _last_fence;
+    auto fence = ++_last_fence;
+    vstd::fixed_vector<VkSemaphore, 4> wait_semaphores;
+    vstd::fixed_vector<uint64_t, 4> wait_values;
+    vstd::fixed_vector<VkPipelineStageFlags, 4> wait_stages;
+    wait_semaphores.emplace_back(_timeline);
+    wait_values.emplace_back(wait_value);
+    for (auto &&i : _waits) {
+        wait_semaphores.emplace_back(i.semaphore);
+        wait_values.emplace_back(i.value);
+    }
+    _waits.clear();
+    for (auto i = 0u; i < wait_semaphores.size(); ++i) {
+        wait_stages.emplace_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    }
+    VkSemaphore signal_semaphores[] = {_timeline, signal_semaphore};
+    uint64_t signal_values[] = {fence, signal_value};
+    uint signal_count = signal_semaphore == VK_NULL_HANDLE ? 1u : 2u;
+    VkTimelineSemaphoreSubmitInfo timeline_info{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = static_cast<uint>(wait_values.size()),
+        .pWaitSemaphoreValues = wait_values.data(),
+        .signalSemaphoreValueCount = signal_count,
+        .pSignalSemaphoreValues = signal_values};
+    VkSubmitInfo submit_info{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timeline_info,
+        .waitSemaphoreCount = static_cast<uint>(wait_semaphores.size()),
+        .pWaitSemaphores = wait_semaphores.data(),
+        .pWaitDstStageMask = wait_stages.data(),
+        .commandBufferCount = cmd == VK_NULL_HANDLE ? 0u : 1u,
+        .pCommandBuffers = &cmd,
+        .signalSemaphoreCount = signal_count,
+        .pSignalSemaphores = signal_semaphores};
+    // queues are shared by the streams of the same family
+    std::lock_guard lck{device()->queue_mutex()};
+    VK_CHECK_RESULT(vkQueueSubmit(_queue, 1, &submit_info, VK_NULL_HANDLE));
+    return fence;
+}
+void Stream::dispatch(CommandList &&list) {
+    if (list.empty()) return;
+    std::lock_guard record_lck{_record_mtx};
+    auto frame = _acquire_frame();
+    VkCommandBufferBeginInfo begin_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+    VK_CHECK_RESULT(vkBeginCommandBuffer(frame->cmd, &begin_info));
+    {
+        detail::StreamVisitor visitor;
+        visitor.device = device();
+        visitor.barrier = &_barrier;
+        visitor.cmd = frame->cmd;
+        visitor.allocate_set = [&](VkDescriptorSetLayout layout) { return _allocate_descriptor_set(*frame, layout); };
+        visitor.upload = &frame->upload;
+        visitor.readback = &frame->readback;
+        visitor.scratch = &frame->scratch;
+        visitor.add_readback = [&](ReadbackBuffer *buffer, size_t offset, void *data, size_t size) {
+            frame->readbacks.emplace_back(Frame::Readback{buffer, offset, data, size});
+        };
+        visitor.execute_after_complete = [&](vstd::function<void()> &&func) {
+            frame->completions.emplace_back(std::move(func));
+        };
+        // the whole list is recorded into one command buffer,
+        // with barriers only between dependent commands
+        for (auto &&command : list.commands()) {
+            command->accept(visitor);
+        }
+        _barrier.clear();
+    }
+    if (!frame->readbacks.empty()) {
+        // make the copies visible to the host after the fence is signaled
+        VkMemoryBarrier barrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT};
+        vkCmdPipelineBarrier(
+            frame->cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+    VK_CHECK_RESULT(vkEndCommandBuffer(frame->cmd));
+    frame->callbacks = std::move(list).steal_callbacks();
+    frame->fence = _submit(frame->cmd, VK_NULL_HANDLE, 0);
+    {
+        std::lock_guard lck{_mtx};
+        _executing_frames.push(std::move(frame));
+    }
+    _cv.notify_all();
+}
+void Stream::_complete_frames() {
+    for (;;) {
+        Frame *frame;
+        {
+            std::unique_lock lck{_mtx};
+            _cv.wait(lck, [&] { return _stop || !_executing_frames.empty(); });
+            if (_executing_frames.empty()) return;
+            frame = _executing_frames.front().get();
+        }
+        VkSemaphoreWaitInfo wait_info{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores = &_timeline,
+            .pValues = &frame->fence};
+        VK_CHECK_RESULT(vkWaitSemaphores(device()->logic_device(), &wait_info, std::numeric_limits<uint64_t>::max()));
+        for (auto &&i : frame->readbacks) {
+            i.buffer->copy_to(i.data, i.offset, i.size);
+        }
+        frame->readbacks.clear();
+        for (auto &&i : frame->completions) {
+            i();
+        }
+        frame->completions.clear();
+        for (auto &&i : frame->callbacks) {
+            i();
+        }
+        frame->callbacks.clear();
+        {
+            std::lock_guard lck{_mtx};
+            _free_frames.emplace_back(std::move(_executing_frames.front()));
+            _executing_frames.pop();
+        }
+        _cv.notify_all();
+    }
+}
+void Stream::synchronize() {
+    {
+        std::unique_lock lck{_mtx};
+        _cv.wait(lck, [&] { return _executing_frames.empty(); });
+    }
+    // submissions without command buffers (event signals) are not tracked by frames
+    uint64_t fence;
+    {
+        std::lock_guard record_lck{_record_mtx};
+        fence = _last_fence;
+    }
+    VkSemaphoreWaitInfo wait_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &_timeline,
+        .pValues = &fence};
+    VK_CHECK_RESULT(vkWaitSemaphores(device()->logic_device(), &wait_info, std::numeric_limits<uint64_t>::max()));
+}
+void Stream::signal(Event *event, uint64_t value) {
+    std::lock_guard record_lck{_record_mtx};
+    _submit(VK_NULL_HANDLE, event->semaphore(), value);
+}
+void Stream::wait(Event *event, uint64_t value) {
+    std::lock_guard record_lck{_record_mtx};
+    // applied to the next submission, which every later submission waits for
+    _waits.emplace_back(Wait{event->semaphore(), value});
+}
+}// namespace lc::vk
@@ -1,4 +1,111 @@
 #pragma once
-namespace lc::vk{
-    
-}
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vulkan/vulkan.h>
+#include <luisa/runtime/command_list.h>
+#include <luisa/runtime/rhi/stream_tag.h>
+#include <luisa/core/stl/queue.h>
+#include <luisa/vstl/functional.h>
+#include "resource.h"
+#include "resource_barrier.h"
+#include "upload_buffer.h"
+#include "readback_buffer.h"
+#include "default_buffer.h"
+namespace lc::vk {
+using namespace luisa::compute;
+class Event;
+// temporary buffers of a submission, sub-allocated linearly and reused once the submission completes
+template<typename T>
+class StagingAllocator {
+public:
+    static constexpr size_t chunk_size = 4ull * 1024ull * 1024ull;
+    struct View {
+        T *buffer;
+        size_t offset;
+    };
+
+private:
+    Device *_device;
+    vstd::vector<vstd::unique_ptr<T>> _chunks;
+    size_t _chunk_index{0};
+    size_t _offset{0};
+
+public:
+    explicit StagingAllocator(Device *device) : _device{device} {}
+    View allocate(size_t size, size_t alignment) {
+        for (; _chunk_index < _chunks.size(); ++_chunk_index, _offset = 0) {
+            auto offset = (_offset + alignment - 1) / alignment * alignment;
+            if (offset + size <= _chunks[_chunk_index]->byte_size()) {
+                _offset = offset + size;
+                return {_chunks[_chunk_index].get(), offset};
+            }
+        }
+        // large requests get a chunk of their own
+        auto &chunk = _chunks.emplace_back(vstd::make_unique<T>(_device, std::max(size, chunk_size)));
+        _offset = size;
+        return {chunk.get(), 0};
+    }
+    void reset() {
+        _chunk_index = 0;
+        _offset = 0;
+    }
+};
+class Stream : public Resource {
+    // everything a submitted command list holds until it completes
+    struct Frame {
+        struct Readback {
+            ReadbackBuffer *buffer;
+            size_t offset;
+            void *data;
+            size_t size;
+        };
+        VkCommandBuffer cmd{};
+        vstd::vector<VkDescriptorPool> descriptor_pools;
+        size_t descriptor_pool_index{0};
+        StagingAllocator<UploadBuffer> upload;
+        StagingAllocator<ReadbackBuffer> readback;
+        // device memory written and read by the commands themselves (e.g. the arguments of indirect dispatches)
+        StagingAllocator<DefaultBuffer> scratch;
+        vstd::vector<Readback> readbacks;
+        // backend work after completion (e.g. returning descriptor indices), before the callbacks of the user
+        vstd::vector<vstd::function<void()>> completions;
+        CommandList::CallbackContainer callbacks;
+        uint64_t fence{0};
+        explicit Frame(Device *device) : upload{device}, readback{device}, scratch{device} {}
+    };
+    struct Wait {
+        VkSemaphore semaphore;
+        uint64_t value;
+    };
+    VkQueue _queue;
+    VkCommandPool _pool;
+    // every submission waits for the previous one and signals the next value
+    VkSemaphore _timeline;
+    uint64_t _last_fence{0};
+    vstd::vector<Wait> _waits;
+    ResourceBarrier _barrier;
+    std::mutex _record_mtx;
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    vstd::vector<vstd::unique_ptr<Frame>> _free_frames;
+    luisa::queue<vstd::unique_ptr<Frame>> _executing_frames;
+    bool _stop{false};
+    std::thread _thread;
+
+    vstd::unique_ptr<Frame> _acquire_frame();
+    VkDescriptorSet _allocate_descriptor_set(Frame &frame, VkDescriptorSetLayout layout);
+    // returns the value of the stream timeline signaled by the submission
+    uint64_t _submit(VkCommandBuffer cmd, VkSemaphore signal_semaphore, uint64_t signal_value);
+    void _complete_frames();
+
+public:
+    auto queue() const { return _queue; }
+    Stream(Device *device, StreamTag tag);
+    ~Stream();
+    void dispatch(CommandList &&list);
+    void synchronize();
+    void signal(Event *event, uint64_t value);
+    void wait(Event *event, uint64_t value);
+};
+}// namespace lc::vk
@@ -0,0 +1,144 @@
+#include "texture.h"
+#include "device.h"
+#include "log.h"
+#include <luisa/core/logging.h>
+namespace lc::vk {
+VkFormat Texture::to_vk_format(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::R8SInt: return VK_FORMAT_R8_SINT;
+        case PixelFormat::R8UInt: return VK_FORMAT_R8_UINT;
+        case PixelFormat::R8UNorm: return VK_FORMAT_R8_UNORM;
+        case PixelFormat::RG8SInt: return VK_FORMAT_R8G8_SINT;
+        case PixelFormat::RG8UInt: return VK_FORMAT_R8G8_UINT;
+        case PixelFormat::RG8UNorm: return VK_FORMAT_R8G8_UNORM;
+        case PixelFormat::RGBA8SInt: return VK_FORMAT_R8G8B8A8_SINT;
+        case PixelFormat::RGBA8UInt: return VK_FORMAT_R8G8B8A8_UINT;
+        case PixelFormat::RGBA8UNorm: return VK_FORMAT_R8G8B8A8_UNORM;
+        case PixelFormat::R16SInt: return VK_FORMAT_R16_SINT;
+        case PixelFormat::R16UInt: return VK_FORMAT_R16_UINT;
+        case PixelFormat::R16UNorm: return VK_FORMAT_R16_UNORM;
+        case PixelFormat::RG16SInt: return VK_FORMAT_R16G16_SINT;
+        case PixelFormat::RG16UInt: return VK_FORMAT_R16G16_UINT;
+        case PixelFormat::RG16UNorm: return VK_FORMAT_R16G16_UNORM;
+        case PixelFormat::RGBA16SInt: return VK_FORMAT_R16G16B16A16_SINT;
+        case PixelFormat::RGBA16UInt: return VK_FORMAT_R16G16B16A16_UINT;
+        case PixelFormat::RGBA16UNorm: return VK_FORMAT_R16G16B16A16_UNORM;
+        case PixelFormat::R32SInt: return VK_FORMAT_R32_SINT;
+        case PixelFormat::R32UInt: return VK_FORMAT_R32_UINT;
+        case PixelFormat::RG32SInt: return VK_FORMAT_R32G32_SINT;
+        case PixelFormat::RG32UInt: return VK_FORMAT_R32G32_UINT;
+        case PixelFormat::RGBA32SInt: return VK_FORMAT_R32G32B32A32_SINT;
+        case PixelFormat::RGBA32UInt: return VK_FORMAT_R32G32B32A32_UINT;
+        case PixelFormat::R16F: return VK_FORMAT_R16_SFLOAT;
+        case PixelFormat::RG16F: return VK_FORMAT_R16G16_SFLOAT;
+        case PixelFormat::RGBA16F: return VK_FORMAT_R16G16B16A16_SFLOAT;
+        case PixelFormat::R32F: return VK_FORMAT_R32_SFLOAT;
+        case PixelFormat::RG32F: return VK_FORMAT_R32G32_SFLOAT;
+        case PixelFormat::RGBA32F: return VK_FORMAT_R32G32B32A32_SFLOAT;
+        // the packed formats of Vulkan list the channels from the most significant bits,
+        // so these have the same memory layout as DXGI_FORMAT_R10G10B10A2 and R11G11B10
+        case PixelFormat::R10G10B10A2UInt: return VK_FORMAT_A2B10G10R10_UINT_PACK32;
+        case PixelFormat::R10G10B10A2UNorm: return VK_FORMAT_A2B10G10R10_UNORM_PACK32;
+        case PixelFormat::R11G11B10F: return VK_FORMAT_B10G11R11_UFLOAT_PACK32;
+        case PixelFormat::BC1UNorm: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case PixelFormat::BC2UNorm: return VK_FORMAT_BC2_UNORM_BLOCK;
+        case PixelFormat::BC3UNorm: return VK_FORMAT_BC3_UNORM_BLOCK;
+        case PixelFormat::BC4UNorm: return VK_FORMAT_BC4_UNORM_BLOCK;
+        case PixelFormat::BC5UNorm: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case PixelFormat::BC6HUF16: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+        case PixelFormat::BC7UNorm: return VK_FORMAT_BC7_UNORM_BLOCK;
+    }
+    LUISA_ERROR_WITH_LOCATION("Unreachable.");
+}
+Texture::Texture(Device *device, PixelFormat format, uint dimension, uint3 size, uint mip_levels)
+    : Resource{device},
+      _format{format},
+      _vk_format{to_vk_format(format)},
+      _dimension{dimension},
+      _size{size},
+      _mip_levels{mip_levels} {
+    LUISA_ASSERT(dimension == 2u || dimension == 3u, "Invalid texture dimension {}.", dimension);
+    VkFormatProperties format_props;
+    vkGetPhysicalDeviceFormatProperties(device->physical_device(), _vk_format, &format_props);
+    auto features = format_props.optimalTilingFeatures;
+    if ((features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == 0) [[unlikely]] {
+        LUISA_ERROR("Pixel format {} is not supported by Vulkan device \"{}\".",
+                    luisa::to_underlying(format), device->properties().deviceName);
+    }
+    _storage = (features & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                              VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                              VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (_storage) { usage |= VK_IMAGE_USAGE_STORAGE_BIT; }
+    _res = device->allocator().allocate_image(
+        dimension == 2u ? VK_IMAGE_TYPE_2D : VK_IMAGE_TYPE_3D,
+        _vk_format,
+        dimension == 2u ? make_uint3(size.xy(), 1u) : size,
+        mip_levels,
+        usage);
+    auto create_view = [&](uint base_level, uint level_count) {
+        VkImageViewCreateInfo view_ci{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = _res.image,
+            .viewType = dimension == 2u ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_3D,
+            .format = _vk_format,
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = base_level,
+                .levelCount = level_count,
+                .baseArrayLayer = 0,
+                .layerCount = 1}};
+        VkImageView view;
+        VK_CHECK_RESULT(vkCreateImageView(device->logic_device(), &view_ci, nullptr, &view));
+        return view;
+    };
+    _level_views.reserve(mip_levels);
+    for (auto level = 0u; level < mip_levels; ++level) {
+        _level_views.emplace_back(create_view(level, 1u));
+    }
+    _view = create_view(0u, mip_levels);
+    device->execute_immediately([&](VkCommandBuffer cmd) {
+        VkImageMemoryBarrier barrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = 0,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                             VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = _res.image,
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = mip_levels,
+                .baseArrayLayer = 0,
+                .layerCount = 1}};
+        vkCmdPipelineBarrier(
+            cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+    });
+}
+Texture::~Texture() {
+    auto logic_device = device()->logic_device();
+    for (auto &&i : _level_views) {
+        vkDestroyImageView(logic_device, i, nullptr);
+    }
+    vkDestroyImageView(logic_device, _view, nullptr);
+    device()->allocator().destroy_image(_res);
+}
+uint3 Texture::level_size(uint level) const {
+    auto size = make_uint3(
+        std::max(_size.x >> level, 1u),
+        std::max(_size.y >> level, 1u),
+        _dimension == 2u ? 1u : std::max(_size.z >> level, 1u));
+    return size;
+}
+VkImageSubresourceLayers Texture::subresource_layers(uint level) const {
+    return VkImageSubresourceLayers{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .mipLevel = level,
+        .baseArrayLayer = 0,
+        .layerCount = 1};
+}
+}// namespace lc::vk
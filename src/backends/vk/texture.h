@@ -0,0 +1,38 @@
+#pragma once
+#include "resource.h"
+#include "vk_allocator.h"
+#include <luisa/runtime/rhi/pixel.h>
+namespace lc::vk {
+using namespace luisa::compute;
+// textures stay in VK_IMAGE_LAYOUT_GENERAL for their whole lifetime,
+// so copies and dispatches only need memory barriers, the same as buffers
+class Texture : public Resource {
+    AllocatedImage _res;
+    PixelFormat _format;
+    VkFormat _vk_format;
+    uint _dimension;
+    uint3 _size;
+    uint _mip_levels;
+    bool _storage;
+    // one view per level for the arguments of dispatches, and one of all levels for bindless arrays
+    vstd::vector<VkImageView> _level_views;
+    VkImageView _view{};
+
+public:
+    Texture(Device *device, PixelFormat format, uint dimension, uint3 size, uint mip_levels);
+    ~Texture();
+    static VkFormat to_vk_format(PixelFormat format);
+    auto vk_image() const { return _res.image; }
+    auto format() const { return _format; }
+    auto vk_format() const { return _vk_format; }
+    auto dimension() const { return _dimension; }
+    auto size() const { return _size; }
+    auto mip_levels() const { return _mip_levels; }
+    // false for formats without storage image support (e.g. block compressed ones), which cannot be written by shaders
+    auto is_storage() const { return _storage; }
+    auto level_view(uint level) const { return _level_views[level]; }
+    auto view() const { return _view; }
+    uint3 level_size(uint level) const;
+    VkImageSubresourceLayers subresource_layers(uint level) const;
+};
+}// namespace lc::vk
@@ -0,0 +1,159 @@
+#include "top_accel.h"
+#include "device.h"
+#include "log.h"
+#include <luisa/core/logging.h>
+namespace lc::vk {
+TopAccel::TopAccel(Device *device, AccelOption const &option)
+    : Resource{device},
+      _flags{AccelStorage::build_flags(option)},
+      _storage{device, VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR} {}
+TopAccel::~TopAccel() {
+    for (auto &&i : _mesh_refs) {
+        i.first->remove_accel(this);
+    }
+}
+void TopAccel::_set_mesh(uint index, BottomAccel *mesh) {
+    auto &old = _meshes[index];
+    if (old == mesh) return;
+    if (old) {
+        auto iter = _mesh_refs.find(old);
+        if (--iter->second == 0) {
+            _mesh_refs.erase(iter);
+            old->remove_accel(this);
+        }
+    }
+    if (mesh) {
+        auto iter = _mesh_refs.try_emplace(mesh, 0u).first;
+        if (iter->second++ == 0) {
+            mesh->add_accel(this);
+        }
+    }
+    old = mesh;
+}
+void TopAccel::mark_moved(BottomAccel *mesh) {
+    std::lock_guard lck{_mtx};
+    _moved.emplace(mesh);
+}
+void TopAccel::remove_mesh(BottomAccel *mesh) {
+    std::lock_guard lck{_mtx};
+    for (auto &&i : _meshes) {
+        if (i == mesh) i = nullptr;
+    }
+    _mesh_refs.erase(mesh);
+    _moved.erase(mesh);
+    _updatable = false;
+}
+void TopAccel::prepare(AccelBuildContext const &ctx, uint instance_count,
+                       vstd::span<AccelBuildCommand::Modification const> modifications,
+                       vstd::vector<AccelBuildCommand::Modification> &resolved) {
+    using Modification = AccelBuildCommand::Modification;
+    std::lock_guard lck{_mtx};
+    if (instance_count != _instance_count) {
+        _updatable = false;
+    }
+    auto size_bytes = std::max(instance_count, 1u) * instance_stride;
+    if (!_instance_buffer || _instance_buffer->byte_size() < size_bytes) {
+        auto buffer = vstd::make_unique<DefaultBuffer>(device(), size_bytes);
+        if (_instance_buffer) {
+            // instances without modifications keep their descriptions
+            auto copy_size = std::min(instance_count, _instance_count) * instance_stride;
+            if (copy_size != 0) {
+                ctx.barrier->add_buffer(_instance_buffer.get(), 0, copy_size, false);
+                ctx.barrier->add_buffer(buffer.get(), 0, copy_size, true);
+                ctx.barrier->update(ctx.cmd);
+                VkBufferCopy region{
+                    .srcOffset = 0,
+                    .dstOffset = 0,
+                    .size = copy_size};
+                vkCmdCopyBuffer(ctx.cmd, _instance_buffer->vk_buffer(), buffer->vk_buffer(), 1, &region);
+            }
+            (*ctx.execute_after_complete)([buffer = _instance_buffer.release()] { delete buffer; });
+        }
+        _instance_buffer = std::move(buffer);
+    }
+    for (auto i = instance_count; i < _meshes.size(); ++i) {
+        _set_mesh(i, nullptr);
+    }
+    _meshes.resize(instance_count, nullptr);
+    _instance_count = instance_count;
+    resolved.clear();
+    for (auto &&m : modifications) {
+        // the same as the accel set kernel, which skips them
+        if (m.index >= instance_count) continue;
+        auto &r = resolved.emplace_back(m);
+        if ((r.flags & Modification::flag_primitive) != 0) {
+            auto mesh = reinterpret_cast<BottomAccel *>(r.primitive);
+            _set_mesh(r.index, mesh);
+            r.primitive = mesh->address();
+            _updatable = false;
+        }
+    }
+    if (_moved.empty()) return;
+    _updatable = false;
+    // every instance is written by at most one modification, which the kernel applies in parallel
+    vstd::unordered_set<uint> modified;
+    for (auto &&r : resolved) {
+        modified.emplace(r.index);
+        auto mesh = _meshes[r.index];
+        if ((r.flags & Modification::flag_primitive) == 0 && mesh && _moved.contains(mesh)) {
+            r.primitive = mesh->address();
+            r.flags |= Modification::flag_primitive;
+        }
+    }
+    for (auto i = 0u; i < _meshes.size(); ++i) {
+        auto mesh = _meshes[i];
+        if (mesh && _moved.contains(mesh) && !modified.contains(i)) {
+            auto &r = resolved.emplace_back(i);
+            r.primitive = mesh->address();
+            r.flags = Modification::flag_primitive;
+        }
+    }
+    _moved.clear();
+}
+void TopAccel::build(AccelBuildContext const &ctx, bool prefer_update) {
+    std::lock_guard lck{_mtx};
+    auto &&functions = device()->accel_functions();
+    VkAccelerationStructureGeometryKHR geometry{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+        .geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR,
+        .geometry = {.instances = {
+                         .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR,
+                         .arrayOfPointers = VK_FALSE,
+                         .data = {.deviceAddress = _instance_buffer->device_address()}}}};
+    VkAccelerationStructureBuildGeometryInfoKHR build_info{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
+        .type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR,
+        .flags = _flags,
+        .mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR,
+        .geometryCount = 1,
+        .pGeometries = &geometry};
+    VkAccelerationStructureBuildSizesInfoKHR sizes{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR};
+    functions.vkGetAccelerationStructureBuildSizesKHR(
+        device()->logic_device(), VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+        &build_info, &_instance_count, &sizes);
+    auto update = prefer_update && _updatable;
+    if (_storage.reserve(sizes.accelerationStructureSize, ctx)) {
+        update = false;
+    }
+    auto scratch = ctx.scratch->allocate(
+        update ? sizes.updateScratchSize : sizes.buildScratchSize,
+        device()->accel_scratch_alignment());
+    if (update) {
+        build_info.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+        build_info.srcAccelerationStructure = _storage.handle();
+    }
+    build_info.dstAccelerationStructure = _storage.handle();
+    build_info.scratchData.deviceAddress = scratch.buffer->device_address() + scratch.offset;
+    // the bottom-level structures of the instances are not tracked one by one
+    ctx.barrier->add_buffer(_instance_buffer.get(), 0, std::numeric_limits<size_t>::max(), false);
+    ctx.barrier->add_read_all();
+    ctx.barrier->add_buffer(_storage.buffer(), 0, std::numeric_limits<size_t>::max(), true);
+    ctx.barrier->update(ctx.cmd);
+    VkAccelerationStructureBuildRangeInfoKHR range{
+        .primitiveCount = _instance_count};
+    auto ranges = &range;
+    functions.vkCmdBuildAccelerationStructuresKHR(ctx.cmd, 1, &build_info, &ranges);
+    _updatable = (_flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR) != 0;
+}
+}// namespace lc::vk
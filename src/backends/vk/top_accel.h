@@ -0,0 +1,38 @@
+#pragma once
+#include "bottom_accel.h"
+#include <luisa/runtime/rhi/command.h>
+namespace lc::vk {
+class TopAccel : public Resource {
+    VkBuildAccelerationStructureFlagsKHR _flags;
+    AccelStorage _storage;
+    // VkAccelerationStructureInstanceKHR of each instance, written by the accel set kernel
+    vstd::unique_ptr<DefaultBuffer> _instance_buffer;
+    uint _instance_count{0};
+    // whether the structure is built from the current instances and bottom-level structures, so that it may be updated
+    bool _updatable{false};
+    std::mutex _mtx;
+    // the bottom-level structure of each instance, and the number of instances of each one
+    vstd::vector<BottomAccel *> _meshes;
+    vstd::unordered_map<BottomAccel *, uint> _mesh_refs;
+    // bottom-level structures reallocated since the last build, whose instances need their new addresses
+    vstd::unordered_set<BottomAccel *> _moved;
+    void _set_mesh(uint index, BottomAccel *mesh);
+
+public:
+    static constexpr size_t instance_stride = sizeof(VkAccelerationStructureInstanceKHR);
+    TopAccel(Device *device, AccelOption const &option);
+    ~TopAccel();
+    auto handle() const { return _storage.handle(); }
+    auto buffer() const { return _storage.buffer(); }
+    auto instance_buffer() const { return _instance_buffer.get(); }
+    auto instance_count() const { return _instance_count; }
+    void mark_moved(BottomAccel *mesh);
+    void remove_mesh(BottomAccel *mesh);
+    // resizes the instances and copies the modifications to resolved, with the addresses of their
+    // bottom-level structures, and with the new addresses of the instances of moved ones
+    void prepare(AccelBuildContext const &ctx, uint instance_count,
+                 vstd::span<AccelBuildCommand::Modification const> modifications,
+                 vstd::vector<AccelBuildCommand::Modification> &resolved);
+    void build(AccelBuildContext const &ctx, bool prefer_update);
+};
+}// namespace lc::vk
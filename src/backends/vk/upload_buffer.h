@@ -4,6 +4,7 @@
 namespace lc::vk {
 class UploadBuffer : public Buffer {
     AllocatedBuffer _res;
+    void *_mapped_ptr{};
 
 public:
     UploadBuffer(Device *device, size_t size_bytes);
@@ -25,8 +25,14 @@ AllocatedBuffer VkAllocator::allocate_buffer(size_t byte_size, VkBufferUsageFlag
     return r;
 }
 VkAllocator::VkAllocator(Device &device) {
+    // VMA loads the functions of its api version, which must not exceed the device's
+    auto device_version = device.properties().apiVersion;
+    auto api_version = std::min<uint32_t>(
+        VK_MAKE_API_VERSION(0, VK_API_VERSION_MAJOR(device_version), VK_API_VERSION_MINOR(device_version), 0),
+        VK_API_VERSION_1_3);
     VmaAllocatorCreateInfo createInfo{
-        .flags = {},
+        // acceleration structures are built from the device addresses of buffers
+        .flags = device.ray_tracing_enabled() ? VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT : 0u,
         .physicalDevice = device.physical_device(),
         .device = device.logic_device(),
         .preferredLargeHeapBlockSize = 0,
@@ -35,7 +41,7 @@ VkAllocator::VkAllocator(Device &device) {
         .pHeapSizeLimit = nullptr,
         .pVulkanFunctions = nullptr,
         .instance = device.instance(),
-        .vulkanApiVersion = VK_API_VERSION_1_3,
+        .vulkanApiVersion = api_version,
         .pTypeExternalMemoryHandleTypes = nullptr};
     VK_CHECK_RESULT(vmaCreateAllocator(&createInfo, &_allocator));
 }
@@ -54,7 +60,12 @@ AllocatedImage VkAllocator::allocate_image(
             .height = size.y,
             .depth = size.z},
         .mipLevels = mip_level,
-        .usage = usage};
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED};
     VmaAllocationCreateInfo allocInfo = {
         .flags = VMA_ALLOCATION_CREATE_STRATEGY_BEST_FIT_BIT,
         .usage = VMA_MEMORY_USAGE_AUTO};
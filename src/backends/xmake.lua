@@ -39,4 +39,7 @@ end
 if get_config("cpu_backend") then
     add_deps("lc-backend-cpu", { inherit = false })
 end
+if LCRemoteBackend then
+    add_deps("lc-backend-remote", "lc-remote-server", { inherit = false })
+end
 target_end()
\ No newline at end of file
@@ -1,8 +1,145 @@
+#include <thread>
+#include <condition_variable>
+
+#include <luisa/core/stl/queue.h>
 #include <luisa/runtime/device.h>
 #include <luisa/dsl/printer.h>
 
 namespace luisa::compute {
 
+class Printer::AsyncRetriever {
+
+public:
+    struct Slot {
+        Buffer<uint> records;// device snapshot of the printer buffer
+        luisa::vector<uint> host;
+        uint count{0u};// downloaded before the printer is reset
+        uint64_t fence{0u};
+        bool abort_on_error{false};
+        bool busy{false};
+    };
+
+private:
+    Printer *_printer;
+    Stream _stream;// downloads the snapshots, independent of the user's streams
+    TimelineEvent _event;
+    uint64_t _fence{0u};
+    std::array<Slot, 2u> _slots;
+    uint _next_slot{0u};
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    luisa::queue<uint> _ready;
+    bool _stop{false};
+    std::thread _worker;
+
+private:
+    void _run() noexcept {
+        for (;;) {
+            uint index{};
+            {
+                std::unique_lock lock{_mutex};
+                _cv.wait(lock, [this] { return _stop || !_ready.empty(); });
+                if (_ready.empty()) { return; }
+                index = _ready.front();
+                _ready.pop();
+            }
+            auto &&slot = _slots[index];
+            auto capacity = static_cast<uint>(slot.records.size() - 1u);
+            auto size = std::min(slot.count, capacity);
+            if (size != 0u) {
+                _stream << _event.wait(slot.fence)
+                        << slot.records.view(0u, size).copy_to(slot.host.data())
+                        << synchronize();
+            }
+            _printer->_print(slot.host.data(), size, slot.count, slot.abort_on_error);
+            {
+                std::scoped_lock lock{_mutex};
+                slot.busy = false;
+            }
+            _cv.notify_all();
+        }
+    }
+
+public:
+    AsyncRetriever(Printer *printer, Device &device) noexcept
+        : _printer{printer},
+          _stream{device.create_stream(StreamTag::COPY)},
+          _event{device.create_timeline_event()} {
+        auto capacity = printer->_buffer.size();
+        for (auto &&slot : _slots) {
+            slot.records = device.create_buffer<uint>(capacity);
+            slot.host.resize(capacity);
+        }
+        _worker = std::thread{[this] { _run(); }};
+    }
+    ~AsyncRetriever() noexcept {
+        {
+            std::unique_lock lock{_mutex};
+            _cv.wait(lock, [this] {
+                return std::none_of(_slots.cbegin(), _slots.cend(),
+                                    [](auto &&s) { return s.busy; });
+            });
+            _stop = true;
+        }
+        _cv.notify_all();
+        _worker.join();
+    }
+    // waits for a free slot if both snapshots are still being printed
+    [[nodiscard]] uint acquire(bool abort_on_error) noexcept {
+        std::unique_lock lock{_mutex};
+        auto index = _next_slot;
+        _next_slot = (_next_slot + 1u) % static_cast<uint>(_slots.size());
+        _cv.wait(lock, [&] { return !_slots[index].busy; });
+        auto &&slot = _slots[index];
+        slot.busy = true;
+        slot.count = 0u;
+        slot.fence = ++_fence;
+        slot.abort_on_error = abort_on_error;
+        return index;
+    }
+    void notify(uint index) noexcept {
+        {
+            std::scoped_lock lock{_mutex};
+            _ready.push(index);
+        }
+        _cv.notify_all();
+    }
+    // frees a slot whose commands were dropped without being submitted
+    void release(uint index) noexcept {
+        {
+            std::scoped_lock lock{_mutex};
+            _slots[index].busy = false;
+        }
+        _cv.notify_all();
+    }
+
+    // hands an acquired slot to the worker when the retrieval completes on the stream,
+    // or frees it if the callback is destroyed without ever running
+    class Ticket {
+
+    private:
+        AsyncRetriever *_async;
+        uint _index;
+
+    public:
+        Ticket(AsyncRetriever *async, uint index) noexcept
+            : _async{async}, _index{index} {}
+        Ticket(Ticket &&other) noexcept
+            : _async{std::exchange(other._async, nullptr)}, _index{other._index} {}
+        Ticket(const Ticket &) noexcept = delete;
+        Ticket &operator=(Ticket &&) noexcept = delete;
+        Ticket &operator=(const Ticket &) noexcept = delete;
+        ~Ticket() noexcept {
+            if (_async != nullptr) { _async->release(_index); }
+        }
+        void notify() noexcept {
+            if (auto async = std::exchange(_async, nullptr)) { async->notify(_index); }
+        }
+    };
+    [[nodiscard]] auto &slot(uint index) noexcept { return _slots[index]; }
+    [[nodiscard]] auto signal(uint index) const noexcept { return _event.signal(_slots[index].fence); }
+};
+
 Printer::Printer(Device &device, luisa::string_view name, size_t capacity) noexcept
     : _buffer{device.create_buffer<uint>(next_pow2(capacity))},
       _host_buffer(next_pow2(capacity)),
@@ -12,12 +149,34 @@ Printer::Printer(Device &device, luisa::string_view name, size_t capacity) noexc
     _logger.set_level(spdlog::level::trace);
 }
 
+// the retriever prints through this printer, so it must go first
+Printer::~Printer() noexcept { _async = nullptr; }
+
 luisa::unique_ptr<Command> Printer::reset() noexcept {
     _reset_called.store(true);
     static const auto zero = 0u;
     return _buffer.view(_buffer.size() - 1u, 1u).copy_from(&zero);
 }
 
+void Printer::_print(const uint *data, uint size, uint count, bool abort_on_error) noexcept {
+    std::scoped_lock lock{_items_mutex};
+    auto offset = 0u;
+    auto truncated = count > size;
+    while (offset < size) {
+        auto record = data + offset;
+        auto &&item = _items[record[0u]];
+        offset += item.size;
+        if (offset > size) {
+            truncated = true;
+        } else {
+            item.f(record, abort_on_error);
+        }
+    }
+    if (truncated) [[unlikely]] {
+        LUISA_WARNING_WITH_LOCATION("Kernel log truncated.");
+    }
+}
+
 std::tuple<luisa::unique_ptr<Command>,
            luisa::move_only_function<void()>,
            luisa::unique_ptr<Command>,
@@ -32,24 +191,37 @@ Printer::retrieve(bool abort_on_error) noexcept {
         auto size = std::min(
             static_cast<uint>(_buffer.size() - 1u),
             _host_buffer.back());
-        auto offset = 0u;
-        auto truncated = _host_buffer.back() > size;
-        while (offset < size) {
-            auto data = _host_buffer.data() + offset;
-            auto &&item = _items[data[0u]];
-            offset += item.size;
-            if (offset > size) {
-                truncated = true;
-            } else {
-                item.f(data, abort_on_error);
-            }
-        }
-        if (truncated) [[unlikely]] {
-            LUISA_WARNING_WITH_LOCATION("Kernel log truncated.");
-        }
+        _print(_host_buffer.data(), size, _host_buffer.back(), abort_on_error);
     };
     auto copy = _buffer.copy_to(_host_buffer.data());
     return {std::move(copy), print, reset(), synchronize()};
 }
 
+std::tuple<luisa::unique_ptr<Command>,
+           luisa::unique_ptr<Command>,
+           luisa::unique_ptr<Command>,
+           luisa::move_only_function<void()>,
+           Event::Signal>
+Printer::retrieve_async(bool abort_on_error) noexcept {
+    if (!_reset_called.load()) [[unlikely]] {
+        LUISA_ERROR_WITH_LOCATION(
+            "Printer results cannot be "
+            "retrieved if never reset.");
+    }
+    if (_async == nullptr) {
+        Device device{_buffer.device()->shared_from_this()};
+        _async = luisa::make_unique<AsyncRetriever>(this, device);
+    }
+    auto index = _async->acquire(abort_on_error);
+    auto &&slot = _async->slot(index);
+    // the snapshot is a device-local copy, only the counter crosses the bus here
+    auto snapshot = slot.records.copy_from(_buffer.view());
+    auto download_count = slot.records.view(slot.records.size() - 1u, 1u).copy_to(&slot.count);
+    auto notify = [ticket = AsyncRetriever::Ticket{_async.get(), index}]() mutable noexcept {
+        ticket.notify();
+    };
+    return {std::move(snapshot), reset(), std::move(download_count),
+            std::move(notify), _async->signal(index)};
+}
+
 }// namespace luisa::compute
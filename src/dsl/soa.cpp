@@ -1,4 +1,8 @@
+#include <cstring>
+#include <algorithm>
+
 #include <luisa/core/logging.h>
+#include <luisa/core/thread_pool.h>
 #include <luisa/dsl/soa.h>
 
 namespace luisa::compute::detail {
@@ -15,4 +19,252 @@ void error_soa_index_out_of_range() noexcept {
     LUISA_ERROR_WITH_LOCATION("SOAView::operator[] out of range.");
 }
 
+void error_soa_block_as_argument() noexcept {
+    LUISA_ERROR_WITH_LOCATION("AoSoA blocks cannot be passed to callables as SOA arguments.");
+}
+
+void error_aosoa_invalid_block_size(uint block_size) noexcept {
+    LUISA_ERROR_WITH_LOCATION("Invalid AoSoA block size {} (must be a power of two).", block_size);
+}
+
+void error_aosoa_subview_out_of_range() noexcept {
+    LUISA_ERROR_WITH_LOCATION("AoSoAView::subview out of range.");
+}
+
+namespace {
+
+// a leaf of the SOA layout, i.e., a column of `stride` words per element in each block
+struct SOAColumn {
+    size_t aos_offset;
+    size_t size;
+    size_t stride;
+    size_t block_offset;// in words
+    size_t stride_prefix;// sum of the strides of the previous columns
+};
+
+// mirrors the splitting rules of the Expr<SOA<T>> specializations
+void flatten_soa_columns(const Type *type, size_t aos_offset, luisa::vector<SOAColumn> &columns) noexcept {
+    auto leaf = [&] {
+        auto stride = (type->size() + sizeof(uint) - 1u) / sizeof(uint);
+        columns.emplace_back(SOAColumn{aos_offset, type->size(), stride, 0u, 0u});
+    };
+    switch (type->tag()) {
+        case Type::Tag::VECTOR:
+        case Type::Tag::ARRAY: {
+            auto elem = type->element();
+            if (elem->size() < sizeof(uint)) {
+                leaf();
+            } else {
+                for (auto i = 0u; i < type->dimension(); i++) {
+                    flatten_soa_columns(elem, aos_offset + i * elem->size(), columns);
+                }
+            }
+            break;
+        }
+        case Type::Tag::MATRIX: {
+            auto n = type->dimension();
+            auto column_size = type->size() / n;
+            for (auto c = 0u; c < n; c++) {
+                for (auto r = 0u; r < n; r++) {
+                    flatten_soa_columns(type->element(), aos_offset + c * column_size + r * sizeof(float), columns);
+                }
+            }
+            break;
+        }
+        case Type::Tag::STRUCTURE: {
+            auto offset = aos_offset;
+            for (auto m : type->members()) {
+                offset = (offset + m->alignment() - 1u) / m->alignment() * m->alignment();
+                flatten_soa_columns(m, offset, columns);
+                offset += m->size();
+            }
+            break;
+        }
+        default: leaf(); break;
+    }
+}
+
+[[nodiscard]] ThreadPool &soa_thread_pool() noexcept {
+    static ThreadPool pool;
+    return pool;
+}
+
+// Maps the elements [elem_offset, elem_offset + elem_count) of the SOA blocks to a compact staging
+// buffer holding the touched words in device order. Fully covered blocks are staged as a whole,
+// while the partially covered first and last blocks only keep the touched lanes of each column.
+class SOATransposer {
+
+private:
+    static constexpr auto chunk_size = 16384u;
+
+private:
+    luisa::vector<SOAColumn> _columns;
+    size_t _aos_stride;
+    size_t _block_size;
+    size_t _block_words;
+    size_t _elem_offset;
+    size_t _elem_count;
+    size_t _total_stride{0u};
+
+public:
+    SOATransposer(const Type *type, size_t block_size, size_t block_words,
+                  size_t elem_offset, size_t elem_count) noexcept
+        : _aos_stride{type->size()},
+          _block_size{block_size},
+          _block_words{block_words},
+          _elem_offset{elem_offset},
+          _elem_count{elem_count} {
+        flatten_soa_columns(type, 0u, _columns);
+        auto offset = static_cast<size_t>(0u);
+        for (auto &c : _columns) {
+            c.block_offset = offset;
+            c.stride_prefix = _total_stride;
+            offset += align_to_soa_cache_line(block_size * c.stride);
+            _total_stride += c.stride;
+        }
+        LUISA_ASSERT(offset == block_words,
+                     "SOA layout of type {} ({} words per block) "
+                     "mismatches the device layout ({} words per block).",
+                     type->description(), offset, block_words);
+    }
+
+private:
+    [[nodiscard]] auto _first_block() const noexcept { return _elem_offset / _block_size; }
+    [[nodiscard]] auto _last_block() const noexcept { return (_elem_offset + _elem_count - 1u) / _block_size; }
+    [[nodiscard]] auto _lanes(size_t b) const noexcept {
+        auto begin = b == _first_block() ? _elem_offset % _block_size : 0u;
+        auto end = b == _last_block() ? _elem_offset + _elem_count - b * _block_size : _block_size;
+        return std::make_pair(begin, end);
+    }
+    [[nodiscard]] auto _is_full(size_t b) const noexcept {
+        auto [begin, end] = _lanes(b);
+        return begin == 0u && end == _block_size;
+    }
+    [[nodiscard]] auto _footprint(size_t b) const noexcept {
+        auto [begin, end] = _lanes(b);
+        return _is_full(b) ? _block_words : (end - begin) * _total_stride;
+    }
+    [[nodiscard]] auto _staging_base(size_t b) const noexcept {
+        auto first = _first_block();
+        return b == first ? 0u : _footprint(first) + (b - first - 1u) * _block_words;
+    }
+    [[nodiscard]] auto _column_base(size_t b, const SOAColumn &c) const noexcept {
+        auto [begin, end] = _lanes(b);
+        return _is_full(b) ? c.block_offset : (end - begin) * c.stride_prefix;
+    }
+
+    // visits the runs of the elements [begin, end) falling into the same block
+    template<typename F>
+    void _for_each_run(size_t begin, size_t end, F &&f) const noexcept {
+        for (auto i = begin; i < end;) {
+            auto e = _elem_offset + i;
+            auto b = e / _block_size;
+            auto lane = e % _block_size;
+            auto n = std::min(end - i, _block_size - lane);
+            auto lane_begin = _lanes(b).first;
+            for (auto &&c : _columns) {
+                auto staging = _staging_base(b) + _column_base(b, c) + (lane - lane_begin) * c.stride;
+                f(c, i, staging, n);
+            }
+            i += n;
+        }
+    }
+
+    template<typename F>
+    void _parallel(F &&f) const noexcept {
+        auto chunk_count = (_elem_count + chunk_size - 1u) / chunk_size;
+        auto process = [&](size_t chunk) noexcept {
+            auto begin = chunk * chunk_size;
+            auto end = std::min(begin + chunk_size, _elem_count);
+            _for_each_run(begin, end, f);
+        };
+        if (chunk_count <= 1u) {
+            for (auto chunk = 0u; chunk < chunk_count; chunk++) { process(chunk); }
+        } else {
+            auto &pool = soa_thread_pool();
+            pool.parallel(static_cast<uint>(chunk_count), process);
+            pool.synchronize();
+        }
+    }
+
+public:
+    [[nodiscard]] auto staging_size() const noexcept {
+        if (_elem_count == 0u) { return static_cast<size_t>(0u); }
+        return _staging_base(_last_block()) + _footprint(_last_block());
+    }
+
+    void encode(const std::byte *aos, uint *staging) const noexcept {
+        _parallel([&](const SOAColumn &c, size_t i, size_t s, size_t n) noexcept {
+            for (auto k = 0u; k < n; k++) {
+                std::memcpy(staging + s + k * c.stride, aos + (i + k) * _aos_stride + c.aos_offset, c.size);
+            }
+        });
+    }
+
+    void decode(const uint *staging, std::byte *aos) const noexcept {
+        _parallel([&](const SOAColumn &c, size_t i, size_t s, size_t n) noexcept {
+            for (auto k = 0u; k < n; k++) {
+                std::memcpy(aos + (i + k) * _aos_stride + c.aos_offset, staging + s + k * c.stride, c.size);
+            }
+        });
+    }
+
+    // visits the contiguous word ranges to copy between the device and the staging buffer
+    template<typename F>
+    void for_each_range(F &&f) const noexcept {
+        if (_elem_count == 0u) { return; }
+        auto first = _first_block();
+        auto last = _last_block();
+        for (auto b = first; b <= last;) {
+            if (_is_full(b)) {
+                // merge the consecutive full blocks
+                auto end = b + 1u;
+                while (end <= last && _is_full(end)) { end++; }
+                f(b * _block_words, _staging_base(b), (end - b) * _block_words);
+                b = end;
+            } else {
+                auto [lane_begin, lane_end] = _lanes(b);
+                for (auto &&c : _columns) {
+                    f(b * _block_words + c.block_offset + lane_begin * c.stride,
+                      _staging_base(b) + _column_base(b, c),
+                      (lane_end - lane_begin) * c.stride);
+                }
+                b++;
+            }
+        }
+    }
+};
+
+}// namespace
+
+CommandList soa_upload(const Type *type, BufferView<uint> buffer,
+                       size_t soa_offset, size_t block_size, size_t block_words,
+                       size_t elem_offset, size_t elem_count, const void *data) noexcept {
+    SOATransposer transposer{type, block_size, block_words, elem_offset, elem_count};
+    luisa::vector<uint> staging(transposer.staging_size());
+    transposer.encode(static_cast<const std::byte *>(data), staging.data());
+    auto list = CommandList::create();
+    transposer.for_each_range([&](size_t offset, size_t staging_offset, size_t size) noexcept {
+        list << buffer.subview(soa_offset + offset, size).copy_from(staging.data() + staging_offset);
+    });
+    // keep the staging buffer alive until the uploads are done
+    list.add_callback([staging = std::move(staging)] {});
+    return list;
+}
+
+CommandList soa_download(const Type *type, BufferView<uint> buffer,
+                         size_t soa_offset, size_t block_size, size_t block_words,
+                         size_t elem_offset, size_t elem_count, void *data) noexcept {
+    SOATransposer transposer{type, block_size, block_words, elem_offset, elem_count};
+    luisa::vector<uint> staging(transposer.staging_size());
+    auto list = CommandList::create();
+    transposer.for_each_range([&](size_t offset, size_t staging_offset, size_t size) noexcept {
+        list << buffer.subview(soa_offset + offset, size).copy_to(staging.data() + staging_offset);
+    });
+    list.add_callback([transposer = std::move(transposer), staging = std::move(staging), data] {
+        transposer.decode(staging.data(), static_cast<std::byte *>(data));
+    });
+    return list;
+}
+
 }// namespace luisa::compute::detail
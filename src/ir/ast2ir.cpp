@@ -1,6 +1,11 @@
 #include <fstream>
+#include <atomic>
+#include <algorithm>
+#include <shared_mutex>
 #include <luisa/core/logging.h>
 #include <luisa/core/magic_enum.h>
+#include <luisa/core/stl/optional.h>
+#include <luisa/core/thread_pool.h>
 #include <luisa/ir/ast2ir.h>
 #include <luisa/ast/function_builder.h>
 
@@ -9,6 +14,119 @@
 
 namespace luisa::compute {
 
+namespace detail {
+
+// A table of interned values with a capacity; when it is exceeded, the least
+// recently used quarter is evicted. Evicted values stay alive in the modules using them.
+template<typename T>
+class AST2IRInternTable {
+
+private:
+    struct Entry {
+        T value;
+        mutable std::atomic<uint64_t> last_use;
+        Entry(T value, uint64_t use) noexcept
+            : value{std::move(value)}, last_use{use} {}
+    };
+
+private:
+    mutable std::shared_mutex _mutex;
+    mutable std::atomic<uint64_t> _clock{0u};
+    luisa::unordered_map<uint64_t, luisa::unique_ptr<Entry>> _entries;
+    size_t _capacity;
+
+private:
+    void _evict() noexcept {
+        if (_entries.size() <= _capacity) { return; }
+        luisa::vector<std::pair<uint64_t, uint64_t>> uses;// (last use, key)
+        uses.reserve(_entries.size());
+        for (auto &&[key, entry] : _entries) {
+            uses.emplace_back(entry->last_use.load(std::memory_order_relaxed), key);
+        }
+        auto target = _capacity - _capacity / 4u;
+        auto evicted = uses.begin() + static_cast<ptrdiff_t>(_entries.size() - target);
+        std::nth_element(uses.begin(), evicted, uses.end());
+        for (auto iter = uses.begin(); iter != evicted; iter++) {
+            _entries.erase(iter->second);
+        }
+    }
+
+public:
+    explicit AST2IRInternTable(size_t capacity) noexcept : _capacity{capacity} {}
+    [[nodiscard]] luisa::optional<T> find(uint64_t key) const noexcept {
+        std::shared_lock lock{_mutex};
+        if (auto iter = _entries.find(key); iter != _entries.end()) {
+            iter->second->last_use.store(_clock.fetch_add(1u, std::memory_order_relaxed),
+                                         std::memory_order_relaxed);
+            return iter->second->value;
+        }
+        return luisa::nullopt;
+    }
+    // returns the already interned value if another thread won the race
+    [[nodiscard]] T intern(uint64_t key, T value) noexcept {
+        std::scoped_lock lock{_mutex};
+        auto use = _clock.fetch_add(1u, std::memory_order_relaxed);
+        if (auto iter = _entries.find(key); iter != _entries.end()) {
+            iter->second->last_use.store(use, std::memory_order_relaxed);
+            return iter->second->value;
+        }
+        auto entry = luisa::make_unique<Entry>(std::move(value), use);
+        auto result = entry->value;
+        _entries.emplace(key, std::move(entry));
+        _evict();
+        return result;
+    }
+    void set_capacity(size_t capacity) noexcept {
+        std::scoped_lock lock{_mutex};
+        _capacity = std::max<size_t>(capacity, 1u);
+        _evict();
+    }
+    void clear() noexcept {
+        luisa::unordered_map<uint64_t, luisa::unique_ptr<Entry>> entries;
+        {
+            std::scoped_lock lock{_mutex};
+            entries.swap(_entries);
+        }
+    }
+};
+
+// Process-wide interning shared by all AST2IR instances, possibly on different threads.
+// Constants are not shared here since IR constant nodes belong to the module pools
+// of the function they are built in; their types go through the struct-type cache.
+class AST2IRSharedCache {
+
+public:
+    using CallableHandle = luisa::shared_ptr<ir::CArc<ir::CallableModule>>;
+
+private:
+    AST2IRInternTable<ir::CArc<ir::Type>> _struct_types{16384u};// maps Type::hash() to ir::Type
+    AST2IRInternTable<CallableHandle> _callables{4096u};         // maps Function::hash() to converted modules
+
+public:
+    // intentionally leaked: the cached modules must not be released
+    // after the Rust runtime has been torn down at exit
+    [[nodiscard]] static auto &instance() noexcept {
+        static auto cache = new AST2IRSharedCache;
+        return *cache;
+    }
+    [[nodiscard]] luisa::optional<ir::CArc<ir::Type>> struct_type(uint64_t hash) const noexcept {
+        return _struct_types.find(hash);
+    }
+    [[nodiscard]] ir::CArc<ir::Type> intern_struct_type(uint64_t hash, ir::CArc<ir::Type> t) noexcept {
+        return _struct_types.intern(hash, std::move(t));
+    }
+    [[nodiscard]] CallableHandle callable(uint64_t hash) const noexcept {
+        return _callables.find(hash).value_or(nullptr);
+    }
+    [[nodiscard]] CallableHandle intern_callable(uint64_t hash, CallableHandle m) noexcept {
+        return _callables.intern(hash, std::move(m));
+    }
+    void set_callable_capacity(size_t capacity) noexcept { _callables.set_capacity(capacity); }
+    void clear_callables() noexcept { _callables.clear(); }
+};
+
+}// namespace detail
+
 AST2IR::AST2IR() noexcept
     : _pools{ir::CppOwnedCArc{ir::luisa_compute_ir_new_module_pools()}} {}
 
@@ -52,19 +170,14 @@ ir::Module AST2IR::_convert_body() noexcept {
 }
 
 luisa::shared_ptr<ir::CArc<ir::KernelModule>>
-AST2IR::_convert_kernel(Function function) noexcept {
+AST2IR::_convert_kernel(Function function, luisa::ThreadPool *pool) noexcept {
     LUISA_ASSERT(function.tag() == Function::Tag::KERNEL,
                  "Invalid function tag.");
-    LUISA_ASSERT(_struct_types.empty() && _constants.empty() &&
-                     _variables.empty() && _builder_stack.empty() &&
-                     !_function,
+    LUISA_ASSERT(_constants.empty() && _variables.empty() &&
+                     _builder_stack.empty() && !_function,
                  "Invalid state.");
-    for (auto &&c : function.custom_callables()) {
-        static_cast<void>(_convert_callable(c->function()));
-    }
+    _convert_callables(function, pool);
     _function = function;
-    _constants.clear();
-    _variables.clear();
     auto m = _with_builder([this](auto builder) noexcept {
         auto total_args = _function.builder()->arguments();
         auto bound_args = _function.builder()->bound_arguments();
@@ -150,19 +263,102 @@ AST2IR::_convert_kernel(Function function) noexcept {
 }
 
 luisa::shared_ptr<ir::CArc<ir::CallableModule>>
-AST2IR::_convert_callable(Function function) noexcept {
-    LUISA_ASSERT(function.tag() == Function::Tag::CALLABLE,
-                 "Invalid function tag.");
+AST2IR::_find_callable(Function function) const noexcept {
+    // not looked up in the shared cache, which may have evicted the callable by now
     if (auto iter = _converted_callables.find(function);
         iter != _converted_callables.end()) {
         return iter->second;
     }
+    return nullptr;
+}
+
+void AST2IR::_convert_callables(Function function, luisa::ThreadPool *pool) noexcept {
+    // collect the callables that are not converted yet, in post-order
+    luisa::vector<Function> pending;
+    luisa::unordered_map<Function, uint> levels;// 0 for converted callables
+    auto &&cache = detail::AST2IRSharedCache::instance();
+    // only the kernels that emulate the raster pipeline may call raster stages
+    auto check_callee = [](Function caller, Function callee) noexcept {
+        LUISA_ASSERT(callee.tag() == Function::Tag::CALLABLE ||
+                         (callee.tag() == Function::Tag::RASTER_STAGE &&
+                          caller.builder()->allows_raster_stage_calls()),
+                     "Invalid callee tag.");
+    };
+    auto visit = [&](auto &&self, Function f) noexcept -> uint {
+        if (auto iter = levels.find(f); iter != levels.end()) {
+            return iter->second;
+        }
+        auto level = 0u;
+        if (auto m = cache.callable(f.hash())) {
+            _converted_callables.emplace(f, std::move(m));
+        } else {
+            for (auto &&c : f.custom_callables()) {
+                check_callee(f, c->function());
+                level = std::max(level, self(self, c->function()));
+            }
+            level++;
+            pending.emplace_back(f);
+        }
+        levels.emplace(f, level);
+        return level;
+    };
+    auto max_level = 0u;
     for (auto &&c : function.custom_callables()) {
-        static_cast<void>(_convert_callable(c->function()));
+        check_callee(function, c->function());
+        max_level = std::max(max_level, visit(visit, c->function()));
     }
+    // each callable is converted with the handles of its callees, which are
+    // resolved on this thread before the callable is and so are never evicted
+    using CalleeMap = luisa::unordered_map<Function, luisa::shared_ptr<ir::CArc<ir::CallableModule>>>;
+    auto callees = [this](Function f) noexcept {
+        CalleeMap m;
+        for (auto &&c : f.custom_callables()) {
+            auto callee = c->function();
+            m.emplace(callee, _converted_callables.at(callee));
+        }
+        return m;
+    };
+    auto convert = [&cache](Function f, CalleeMap m) noexcept {
+        AST2IR converter;
+        converter._converted_callables = std::move(m);
+        return cache.intern_callable(f.hash(), converter._convert_callable_module(f));
+    };
+    if (pool == nullptr || pending.size() <= 1u) {
+        for (auto f : pending) {
+            _converted_callables.emplace(f, convert(f, callees(f)));
+        }
+        return;
+    }
+    // callables on the same level do not call each other, so
+    // they can be converted concurrently, each with its own pools
+    using Converted = std::pair<Function, luisa::shared_ptr<ir::CArc<ir::CallableModule>>>;
+    luisa::vector<std::shared_future<Converted>> futures;
+    for (auto level = 1u; level <= max_level; level++) {
+        futures.clear();
+        for (auto f : pending) {
+            if (levels.find(f)->second != level) { continue; }
+            futures.emplace_back(pool->async([f, m = callees(f), &convert]() mutable noexcept {
+                return std::make_pair(f, convert(f, std::move(m)));
+            }));
+        }
+        for (auto &&future : futures) {
+            auto [f, m] = future.get();
+            _converted_callables.emplace(f, std::move(m));
+        }
+    }
+}
+
+luisa::shared_ptr<ir::CArc<ir::CallableModule>>
+AST2IR::_convert_callable_module(Function function) noexcept {
+    // raster stages called from kernels are converted like callables,
+    // the callers are checked in _convert_callables
+    LUISA_ASSERT(function.tag() == Function::Tag::CALLABLE ||
+                     function.tag() == Function::Tag::RASTER_STAGE,
+                 "Invalid function tag.");
+    LUISA_ASSERT(_constants.empty() && _variables.empty() &&
+                     _builder_stack.empty() && !_function,
+                 "Invalid state.");
     _function = function;
-    _constants.clear();
-    _variables.clear();
     auto m = _with_builder([this](auto builder) noexcept {
         auto args = _function.arguments();
         auto arguments = _boxed_slice<ir::NodeRef>(args.size());
@@ -178,14 +374,21 @@ AST2IR::_convert_callable(Function function) noexcept {
         m.pools = _pools.clone();
         return ir::luisa_compute_ir_new_callable_module(m);
     });
-    // TODO: who owns this?
-    auto callable = luisa::shared_ptr<ir::CArc<ir::CallableModule>>{
-        luisa::new_with_allocator<ir::CArc<ir::CallableModule>>(m),
-        [](ir::CArc<ir::CallableModule> *p) noexcept {
-            p->release();
-            luisa::delete_with_allocator(p);
-        }};
-    return _converted_callables.emplace(function, std::move(callable)).first->second;
+    return {luisa::new_with_allocator<ir::CArc<ir::CallableModule>>(m),
+            [](ir::CArc<ir::CallableModule> *p) noexcept {
+                p->release();
+                luisa::delete_with_allocator(p);
+            }};
+}
+
+luisa::shared_ptr<ir::CArc<ir::CallableModule>>
+AST2IR::_convert_callable(Function function, luisa::ThreadPool *pool) noexcept {
+    LUISA_ASSERT(function.tag() == Function::Tag::CALLABLE,
+                 "Invalid function tag.");
+    // the requested callable itself is not taken from or put into the shared
+    // cache, since callers may transform the returned module in place
+    _convert_callables(function, pool);
+    return _convert_callable_module(function);
 }
 
 ir::NodeRef AST2IR::_convert_expr(const Expression *expr, bool is_lvalue) noexcept {
@@ -294,8 +497,8 @@ ir::CArc<ir::Type> AST2IR::_convert_type(const Type *type) noexcept {
                          .array = {{.element = elem, .length = type->dimension()}}});
         }
         case Type::Tag::STRUCTURE: {
-            if (auto iter = _struct_types.find(type->hash());
-                iter != _struct_types.end()) { return iter->second; }
+            auto &&cache = detail::AST2IRSharedCache::instance();
+            if (auto t = cache.struct_type(type->hash())) { return *t; }
             auto m = type->members();
             auto members = _boxed_slice<ir::CArc<ir::Type>>(m.size());
             for (auto i = 0u; i < m.size(); i++) {
@@ -306,9 +509,8 @@ ir::CArc<ir::Type> AST2IR::_convert_type(const Type *type) noexcept {
                          .struct_ = {{.fields = members,
                                       .alignment = type->alignment(),
                                       .size = type->size()}}});
-            _struct_types.emplace(type->hash(), t);
             ir::destroy_boxed_slice(members);
-            return t;
+            return cache.intern_struct_type(type->hash(), t);
         }
         case Type::Tag::CUSTOM: {
             auto type_desc = type->description();
@@ -570,12 +772,10 @@ ir::NodeRef AST2IR::_convert(const ConstantExpr *expr) noexcept {
 ir::NodeRef AST2IR::_convert(const CallExpr *expr) noexcept {
     // custom callable
     if (!expr->is_builtin()) {
-        AST2IR cvt;
         auto callable = expr->custom();
-        auto iter = _converted_callables.find(callable);
-        LUISA_ASSERT(iter != _converted_callables.end(),
+        auto cvted_callable = _find_callable(callable);
+        LUISA_ASSERT(cvted_callable != nullptr,
                      "Custom callable not found.");
-        auto cvted_callable = iter->second;
         luisa::vector<ir::NodeRef> args;
         args.reserve(expr->arguments().size());
         for (auto i = 0u; i < expr->arguments().size(); i++) {
@@ -682,6 +882,15 @@ ir::NodeRef AST2IR::_convert(const CallExpr *expr) noexcept {
             case CallOp::ATOMIC_FETCH_XOR: return ir::Func::Tag::AtomicFetchXor;
             case CallOp::ATOMIC_FETCH_MIN: return ir::Func::Tag::AtomicFetchMin;
             case CallOp::ATOMIC_FETCH_MAX: return ir::Func::Tag::AtomicFetchMax;
+            case CallOp::ATOMIC_EXCHANGE_EXPLICIT: return ir::Func::Tag::AtomicExchangeExplicit;
+            case CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT: return ir::Func::Tag::AtomicCompareExchangeExplicit;
+            case CallOp::ATOMIC_FETCH_ADD_EXPLICIT: return ir::Func::Tag::AtomicFetchAddExplicit;
+            case CallOp::ATOMIC_FETCH_SUB_EXPLICIT: return ir::Func::Tag::AtomicFetchSubExplicit;
+            case CallOp::ATOMIC_FETCH_AND_EXPLICIT: return ir::Func::Tag::AtomicFetchAndExplicit;
+            case CallOp::ATOMIC_FETCH_OR_EXPLICIT: return ir::Func::Tag::AtomicFetchOrExplicit;
+            case CallOp::ATOMIC_FETCH_XOR_EXPLICIT: return ir::Func::Tag::AtomicFetchXorExplicit;
+            case CallOp::ATOMIC_FETCH_MIN_EXPLICIT: return ir::Func::Tag::AtomicFetchMinExplicit;
+            case CallOp::ATOMIC_FETCH_MAX_EXPLICIT: return ir::Func::Tag::AtomicFetchMaxExplicit;
             case CallOp::BUFFER_READ: return ir::Func::Tag::BufferRead;
             case CallOp::BUFFER_WRITE: return ir::Func::Tag::BufferWrite;
             case CallOp::TEXTURE_READ: {
@@ -1208,7 +1417,8 @@ ir::NodeRef AST2IR::_convert(const AutoDiffStmt *stmt) noexcept {
     auto instr = ir::luisa_compute_ir_new_instruction(ir::Instruction{
         .tag = ir::Instruction::Tag::AdScope,
         .ad_scope = ir::Instruction::AdScope_Body{
-            .body = body}});
+            .body = body,
+            .checkpoint_interval = stmt->checkpoint_interval()}});
     auto node = ir::luisa_compute_ir_new_node(
         _pools.clone(),
         ir::Node{.type_ = _convert_type(nullptr).clone(),
@@ -1330,7 +1540,7 @@ ir::NodeRef AST2IR::_convert_builtin_variable(Variable v) noexcept {
             case Variable::Tag::DISPATCH_SIZE:
                 return ir::Func::Tag::DispatchSize;
             case Variable::Tag::KERNEL_ID:
-                LUISA_NOT_IMPLEMENTED();
+                return ir::Func::Tag::KernelId;
             case Variable::Tag::WARP_LANE_COUNT:
                 return ir::Func::Tag::WarpSize;
             case Variable::Tag::WARP_LANE_ID:
@@ -1444,18 +1654,26 @@ ir::NodeRef AST2IR::_literal(const Type *type, LiteralExpr::Value value) noexcep
         value);
 }
 
-[[nodiscard]] luisa::shared_ptr<ir::CArc<ir::KernelModule>> AST2IR::build_kernel(Function function) noexcept {
-    return AST2IR{}._convert_kernel(function);
+[[nodiscard]] luisa::shared_ptr<ir::CArc<ir::KernelModule>> AST2IR::build_kernel(Function function, luisa::ThreadPool *pool) noexcept {
+    return AST2IR{}._convert_kernel(function, pool);
 }
 
-[[nodiscard]] luisa::shared_ptr<ir::CArc<ir::CallableModule>> AST2IR::build_callable(Function function) noexcept {
-    return AST2IR{}._convert_callable(function);
+[[nodiscard]] luisa::shared_ptr<ir::CArc<ir::CallableModule>> AST2IR::build_callable(Function function, luisa::ThreadPool *pool) noexcept {
+    return AST2IR{}._convert_callable(function, pool);
 }
 
 ir::CArc<ir::Type> AST2IR::build_type(const Type *type) noexcept {
     return AST2IR{}._convert_type(type);
 }
 
+void AST2IR::set_callable_cache_capacity(size_t capacity) noexcept {
+    detail::AST2IRSharedCache::instance().set_callable_capacity(capacity);
+}
+
+void AST2IR::clear_callable_cache() noexcept {
+    detail::AST2IRSharedCache::instance().clear_callables();
+}
+
 }// namespace luisa::compute
 
 #pragma clang diagnostic pop
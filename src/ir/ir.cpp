@@ -70,6 +70,7 @@ luisa::span<const SwitchCase> Instruction::Switch::cases() const noexcept {
 }
 
 const Pooled<BasicBlock> &Instruction::AdScope::body() const noexcept { return detail::from_inner_ref(_inner.body); }
+const uint32_t &Instruction::AdScope::checkpoint_interval() const noexcept { return detail::from_inner_ref(_inner.checkpoint_interval); }
 const NodeRef &Instruction::RayQuery::ray_query() const noexcept { return detail::from_inner_ref(_inner.ray_query); }
 const Pooled<BasicBlock> &Instruction::RayQuery::on_triangle_hit() const noexcept { return detail::from_inner_ref(_inner.on_triangle_hit); }
 const Pooled<BasicBlock> &Instruction::RayQuery::on_procedural_hit() const noexcept { return detail::from_inner_ref(_inner.on_procedural_hit); }
@@ -444,6 +444,10 @@ const Expression *IR2AST::_convert_instr_call(const ir::Node *node) noexcept {
             LUISA_ASSERT(args.empty(), "`DispatchSize` takes no arguments.");
             return _ctx->function_builder->dispatch_size();
         }
+        case ir::Func::Tag::KernelId: {
+            LUISA_ASSERT(args.empty(), "`KernelId` takes no arguments.");
+            return _ctx->function_builder->kernel_id();
+        }
         case ir::Func::Tag::WarpSize: {
             LUISA_ASSERT(args.empty(), "`WarpSize` takes no arguments.");
             return _ctx->function_builder->warp_lane_count();
@@ -618,6 +622,15 @@ const Expression *IR2AST::_convert_instr_call(const ir::Node *node) noexcept {
         case ir::Func::Tag::AtomicFetchXor: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_XOR);
         case ir::Func::Tag::AtomicFetchMin: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_MIN);
         case ir::Func::Tag::AtomicFetchMax: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_MAX);
+        case ir::Func::Tag::AtomicExchangeExplicit: return builtin_func(args.size(), CallOp::ATOMIC_EXCHANGE_EXPLICIT);
+        case ir::Func::Tag::AtomicCompareExchangeExplicit: return builtin_func(args.size(), CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT);
+        case ir::Func::Tag::AtomicFetchAddExplicit: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_ADD_EXPLICIT);
+        case ir::Func::Tag::AtomicFetchSubExplicit: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_SUB_EXPLICIT);
+        case ir::Func::Tag::AtomicFetchAndExplicit: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_AND_EXPLICIT);
+        case ir::Func::Tag::AtomicFetchOrExplicit: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_OR_EXPLICIT);
+        case ir::Func::Tag::AtomicFetchXorExplicit: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_XOR_EXPLICIT);
+        case ir::Func::Tag::AtomicFetchMinExplicit: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_MIN_EXPLICIT);
+        case ir::Func::Tag::AtomicFetchMaxExplicit: return builtin_func(args.size(), CallOp::ATOMIC_FETCH_MAX_EXPLICIT);
         case ir::Func::Tag::BufferRead: return builtin_func(2, CallOp::BUFFER_READ);
         case ir::Func::Tag::BufferWrite: return builtin_func(3, CallOp::BUFFER_WRITE);
         case ir::Func::Tag::BufferSize: return builtin_func(1, CallOp::BUFFER_SIZE);
@@ -0,0 +1,24 @@
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/ir/ast2ir.h>
+#include <luisa/ir/ir2ast.h>
+#include <luisa/ir/transform.h>
+
+namespace luisa::compute {
+
+luisa::shared_ptr<const detail::FunctionBuilder>
+transform_kernel(Function kernel, luisa::span<const char *const> transforms) noexcept {
+    LUISA_ASSERT(kernel.tag() == Function::Tag::KERNEL,
+                 "Only kernels can be transformed.");
+    Clock clk;
+    auto m = AST2IR::build_kernel(kernel);
+    auto pipeline = ir::luisa_compute_ir_transform_pipeline_new();
+    for (auto t : transforms) { ir::luisa_compute_ir_transform_pipeline_add_transform(pipeline, t); }
+    m->get()->module = ir::luisa_compute_ir_transform_pipeline_transform(pipeline, m->get()->module);
+    ir::luisa_compute_ir_transform_pipeline_destroy(pipeline);
+    auto converted = IR2AST::build(m->get());
+    LUISA_VERBOSE("Transformed kernel with hash {:016x} in {} ms.", kernel.hash(), clk.toc());
+    return converted;
+}
+
+}// namespace luisa::compute
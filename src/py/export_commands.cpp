@@ -1,12 +1,119 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/functional.h>
 #include <pybind11/stl.h>
+#include <luisa/core/logging.h>
 #include <luisa/runtime/rhi/command_encoder.h>
+#include <luisa/runtime/dispatch_buffer.h>
+#include "py_stream.h"
 
 namespace py = pybind11;
 using namespace luisa;
 using namespace luisa::compute;
 constexpr auto pyref = py::return_value_policy::reference;// object lifetime is managed on C++ side
+
+// Argument layout of a compiled kernel, computed once at compile time,
+// so that a dispatch encodes the whole Python argument tuple in one call
+class ShaderLauncher {
+
+public:
+    enum struct Kind : uint8_t {
+        BASIC,
+        AGGREGATE,
+        BUFFER,
+        TEXTURE,
+        BINDLESS_ARRAY,
+        ACCEL
+    };
+
+    struct Slot {
+        Kind kind;
+        const Type *type;
+    };
+
+private:
+    uint64_t _handle;
+    size_t _uniform_size;
+    luisa::vector<Slot> _slots;
+
+public:
+    ShaderLauncher(uint64_t handle, Function func) noexcept
+        : _handle{handle},
+          _uniform_size{ComputeDispatchCmdEncoder::compute_uniform_size(func.arguments())} {
+        auto args = func.unbound_arguments();
+        _slots.reserve(args.size());
+        for (auto &&arg : args) {
+            auto type = arg.type();
+            auto kind = [type] {
+                if (type->is_basic()) { return Kind::BASIC; }
+                if (type->is_array() || type->is_structure()) { return Kind::AGGREGATE; }
+                if (type->is_buffer() || type == Type::of<IndirectDispatchBuffer>()) { return Kind::BUFFER; }
+                if (type->is_texture()) { return Kind::TEXTURE; }
+                if (type->is_bindless_array()) { return Kind::BINDLESS_ARRAY; }
+                if (type->is_accel()) { return Kind::ACCEL; }
+                LUISA_ERROR_WITH_LOCATION("Unsupported kernel argument type: {}.", type->description());
+            }();
+            _slots.emplace_back(Slot{kind, type});
+        }
+    }
+
+    [[nodiscard]] ComputeDispatchCmdEncoder encode(const py::tuple &args) const {
+        if (args.size() != _slots.size()) {
+            throw py::type_error(luisa::format(
+                                     "Kernel expects {} arguments, got {}.",
+                                     _slots.size(), args.size())
+                                     .c_str());
+        }
+        ComputeDispatchCmdEncoder encoder{_handle, _slots.size(), _uniform_size};
+        for (auto i = 0u; i < _slots.size(); i++) {
+            auto slot = _slots[i];
+            auto arg = args[i];
+            switch (slot.kind) {
+                case Kind::BASIC: {
+                    auto value = arg.cast<LiteralExpr::Value>();
+                    luisa::visit(
+                        [&](auto x) {
+                            using T = decltype(x);
+                            if (Type::of<T>() != slot.type) {
+                                throw py::type_error(luisa::format(
+                                                         "Kernel argument {} expects {}, got {}.",
+                                                         i, slot.type->description(), Type::of<T>()->description())
+                                                         .c_str());
+                            }
+                            encoder.encode_uniform(&x, sizeof(T));
+                        },
+                        value);
+                    break;
+                }
+                case Kind::AGGREGATE: {
+                    auto bytes = arg.attr("to_bytes")().cast<std::string_view>();
+                    if (bytes.size() < slot.type->size()) {
+                        throw py::type_error(luisa::format(
+                                                 "Kernel argument {} expects {} ({} bytes), got {} bytes.",
+                                                 i, slot.type->description(), slot.type->size(), bytes.size())
+                                                 .c_str());
+                    }
+                    encoder.encode_uniform(bytes.data(), slot.type->size());
+                    break;
+                }
+                case Kind::BUFFER:
+                    encoder.encode_buffer(arg.attr("handle").cast<uint64_t>(), 0u,
+                                          arg.attr("bytesize").cast<size_t>());
+                    break;
+                case Kind::TEXTURE:
+                    encoder.encode_texture(arg.attr("handle").cast<uint64_t>(), 0u);
+                    break;
+                case Kind::BINDLESS_ARRAY:
+                    encoder.encode_bindless_array(arg.attr("handle").cast<uint64_t>());
+                    break;
+                case Kind::ACCEL:
+                    encoder.encode_accel(arg.attr("handle").cast<uint64_t>());
+                    break;
+            }
+        }
+        return encoder;
+    }
+};
+
 void export_commands(py::module &m) {
     // commands
     py::class_<Command>(m, "Command");
@@ -27,6 +134,18 @@ void export_commands(py::module &m) {
         .def("encode_accel", &ComputeDispatchCmdEncoder::encode_accel)
         .def(
             "build", [](ComputeDispatchCmdEncoder &c) { return std::move(c).build().release(); }, pyref);
+    py::class_<ShaderLauncher>(m, "ShaderLauncher")
+        .def(py::init<uint64_t, Function>())
+        .def("dispatch", [](const ShaderLauncher &self, PyStream &stream, const py::tuple &args, uint32_t sx, uint32_t sy, uint32_t sz) {
+            auto encoder = self.encode(args);
+            encoder.set_dispatch_size(uint3{sx, sy, sz});
+            stream.add(std::move(encoder).build());
+        })
+        .def("dispatch_indirect", [](const ShaderLauncher &self, PyStream &stream, const py::tuple &args, uint64_t handle, uint32_t offset, uint32_t size) {
+            auto encoder = self.encode(args);
+            encoder.set_dispatch_size(IndirectDispatchArg{handle, offset, size});
+            stream.add(std::move(encoder).build());
+        });
     // buffer operation commands
     // Pybind can't deduce argument list of the create function, so using lambda to inform it
     py::class_<BufferUploadCommand, Command>(m, "BufferUploadCommand")
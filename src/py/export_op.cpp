@@ -127,6 +127,15 @@ void export_op(py::module &m) {
         .value("ATOMIC_FETCH_XOR", CallOp::ATOMIC_FETCH_XOR)              /// [(atomic_ref, val) -> old]: stores (old ^ val), returns old.
         .value("ATOMIC_FETCH_MIN", CallOp::ATOMIC_FETCH_MIN)              /// [(atomic_ref, val) -> old]: stores min(old, val), returns old.
         .value("ATOMIC_FETCH_MAX", CallOp::ATOMIC_FETCH_MAX)              /// [(atomic_ref, val) -> old]: stores max(old, val), returns old.
+        .value("ATOMIC_EXCHANGE_EXPLICIT", CallOp::ATOMIC_EXCHANGE_EXPLICIT)/// [(atomic_ref, desired, order) -> old]: same as ATOMIC_EXCHANGE, with the memory order.
+        .value("ATOMIC_COMPARE_EXCHANGE_EXPLICIT", CallOp::ATOMIC_COMPARE_EXCHANGE_EXPLICIT)/// [(atomic_ref, expected, desired, order) -> old]: same as ATOMIC_COMPARE_EXCHANGE, with the memory order.
+        .value("ATOMIC_FETCH_ADD_EXPLICIT", CallOp::ATOMIC_FETCH_ADD_EXPLICIT)/// [(atomic_ref, val, order) -> old]: same as ATOMIC_FETCH_ADD, with the memory order.
+        .value("ATOMIC_FETCH_SUB_EXPLICIT", CallOp::ATOMIC_FETCH_SUB_EXPLICIT)/// [(atomic_ref, val, order) -> old]: same as ATOMIC_FETCH_SUB, with the memory order.
+        .value("ATOMIC_FETCH_AND_EXPLICIT", CallOp::ATOMIC_FETCH_AND_EXPLICIT)/// [(atomic_ref, val, order) -> old]: same as ATOMIC_FETCH_AND, with the memory order.
+        .value("ATOMIC_FETCH_OR_EXPLICIT", CallOp::ATOMIC_FETCH_OR_EXPLICIT)/// [(atomic_ref, val, order) -> old]: same as ATOMIC_FETCH_OR, with the memory order.
+        .value("ATOMIC_FETCH_XOR_EXPLICIT", CallOp::ATOMIC_FETCH_XOR_EXPLICIT)/// [(atomic_ref, val, order) -> old]: same as ATOMIC_FETCH_XOR, with the memory order.
+        .value("ATOMIC_FETCH_MIN_EXPLICIT", CallOp::ATOMIC_FETCH_MIN_EXPLICIT)/// [(atomic_ref, val, order) -> old]: same as ATOMIC_FETCH_MIN, with the memory order.
+        .value("ATOMIC_FETCH_MAX_EXPLICIT", CallOp::ATOMIC_FETCH_MAX_EXPLICIT)/// [(atomic_ref, val, order) -> old]: same as ATOMIC_FETCH_MAX, with the memory order.
 
         .value("BUFFER_READ", CallOp::BUFFER_READ)  /// [(buffer, index) -> value]: reads the index-th element in buffer
         .value("BUFFER_WRITE", CallOp::BUFFER_WRITE)/// [(buffer, index, value) -> void]: writes value into the index-th element of buffer
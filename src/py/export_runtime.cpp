@@ -181,6 +181,7 @@ void export_runtime(py::module &m) {
             "create_stream", [](ManagedDevice &self, bool support_window) { return PyStream(self.device, support_window); })
         .def(
             "impl", [](ManagedDevice &s) { return s.device.impl(); }, pyref)
+        .def("backend_name", [](ManagedDevice &self) { return luisa::string{self.device.backend_name()}; })
         .def("create_accel", [](ManagedDevice &device, AccelOption::UsageHint hint, bool allow_compact, bool allow_update) {
             return ManagedAccel(device.device.create_accel(AccelOption{
                 .hint = hint,
@@ -606,7 +607,7 @@ void export_runtime(py::module &m) {
                 return ptr;
             },
             pyref)
-        .def("autodiff_", &FunctionBuilder::autodiff_, pyref)
+        .def("autodiff_", &FunctionBuilder::autodiff_, py::arg("checkpoint_interval") = 1u, pyref)
         // .def("meta") // unused
         .def("function", &FunctionBuilder::function);// returning object
 
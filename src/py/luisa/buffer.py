@@ -6,10 +6,22 @@ from .types import vector_dtypes, matrix_dtypes, element_of, length_of
 from functools import cache
 from .mathtypes import *
 from .builtin import check_exact_signature
-from .types import uint, uint, uint3, short, ushort, long, ulong
+from .types import uint, uint, uint3, short, ushort, long, ulong, half
 from .struct import CustomType
 from .atomic import int_atomic_functions, float_atomic_functions
 
+# backends whose buffer native handles are plain host pointers
+_host_visible_backends = {'cpu'}
+_numpy_scalar_types = {'bool': 'bool', 'short': 'int16', 'ushort': 'uint16', 'int': 'int32', 'uint': 'uint32',
+                       'long': 'int64', 'ulong': 'uint64', 'half': 'float16', 'float': 'float32'}
+_scalar_dtypes_of_numpy = {'bool': bool, 'int16': short, 'uint16': ushort, 'int32': int, 'uint32': uint,
+                           'int64': long, 'uint64': ulong, 'float16': half, 'float32': float}
+
+
+def is_host_visible():
+    device = get_global_device()
+    return device is not None and device.backend_name() in _host_visible_backends
+
 
 class Buffer:
     def __init__(self, size, dtype):
@@ -63,6 +75,23 @@ class Buffer:
         buf.copy_from_array(arr)
         return buf
 
+    @staticmethod
+    def from_dlpack(tensor, dtype=None, stream=None):
+        # the device does not adopt foreign memory, so the tensor is copied once into a new buffer;
+        # np.from_dlpack aliases the producer's host memory, so the upload reads it without a staging copy
+        import numpy as np
+        arr = np.ascontiguousarray(np.from_dlpack(tensor))
+        if dtype is None:
+            if arr.dtype.name not in _scalar_dtypes_of_numpy:
+                raise TypeError(f"Buffer from unsupported DLPack dtype: {arr.dtype}")
+            dtype = _scalar_dtypes_of_numpy[arr.dtype.name]
+        stride = to_lctype(dtype).size()
+        if arr.nbytes == 0 or arr.nbytes % stride != 0:
+            raise ValueError(f"DLPack tensor of {arr.nbytes} bytes does not hold whole {to_lctype(dtype).description()} elements")
+        buf = Buffer(arr.nbytes // stride, dtype)
+        buf.copy_from_array(arr, stream=stream)
+        return buf
+
     def copy_from_list(self, arr, sync=False, stream=None):
         if stream is None:
             stream = globalvars.vars.stream
@@ -115,13 +144,60 @@ class Buffer:
         if sync:
             stream.synchronize()
 
-    def numpy(self, stream=None):  # only supports scalar
+    def numpy(self, stream=None, zero_copy=False):  # only supports scalar unless zero_copy
         import numpy as np
+        if zero_copy:
+            return self.host_view(stream)
         npf = {int: np.int32, float: np.float32, bool: bool}[self.dtype]
         arr = np.empty(self.size, dtype=npf)
         self.copy_to(arr, sync=True, stream=stream)
         return arr
 
+    # numpy array aliasing the buffer memory on host-visible backends;
+    # the stream is synchronized first, later commands on it are not ordered against host accesses
+    def host_view(self, stream=None):
+        import ctypes
+        import numpy as np
+        if not is_host_visible():
+            raise BufferError(f"buffer memory is not host visible on backend '{get_global_device().backend_name()}'")
+        if stream is None:
+            stream = globalvars.vars.stream
+        stream.synchronize()
+        storage = (ctypes.c_byte * self.bytesize).from_address(self.native_handle)
+        storage.owner = self  # the view keeps the device buffer alive
+        lctype = to_lctype(self.dtype)
+        if lctype.is_scalar():
+            npf = _numpy_scalar_types[lctype.description()]
+            shape, strides = (self.size,), (self.stride,)
+        elif lctype.is_vector():
+            element = lctype.element()
+            npf = _numpy_scalar_types[element.description()]
+            shape, strides = (self.size, lctype.dimension()), (self.stride, element.size())
+        elif lctype.is_matrix():
+            n = lctype.dimension()
+            npf = _numpy_scalar_types[lctype.element().description()]
+            shape, strides = (self.size, n, n), (self.stride, self.stride // n, lctype.element().size())
+        else:  # structures and arrays are exposed as raw bytes
+            npf = np.uint8
+            shape, strides = (self.size, self.stride), (self.stride, 1)
+        return np.ndarray(shape, dtype=npf, buffer=storage, strides=strides)
+
+    def __dlpack__(self, stream=None, **kwargs):
+        # the only host-visible device is the CPU, for which DLPack requires stream to be None
+        if stream is not None:
+            raise BufferError("Buffer.__dlpack__ does not support consumer streams")
+        return self.host_view().__dlpack__()
+
+    def __dlpack_device__(self):
+        if not is_host_visible():
+            raise BufferError(f"buffer memory is not host visible on backend '{get_global_device().backend_name()}'")
+        return 1, 0  # kDLCPU
+
+    # buffer protocol from Python (PEP 688), so memoryview(buffer) only works on Python 3.12+;
+    # older versions use host_view() or np.from_dlpack(buffer) for the same zero-copy view
+    def __buffer__(self, flags):
+        return memoryview(self.host_view())
+
     def to_list(self, stream=None):
         packed_bytes = bytes(self.bytesize)
         dlcmd = lcapi.BufferDownloadCommand.create(
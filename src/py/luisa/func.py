@@ -17,6 +17,25 @@ from pathlib import Path
 import sys
 
 
+# attributes holding the dtype of argument classes whose dtype is not the class itself
+_dtype_attributes = {
+    "Buffer": "bufferType",
+    "ByteBuffer": "bufferType",
+    "Array": "arrayType",
+    "Struct": "structType",
+    "RayQuery": "queryType",
+    "Image2D": "texture2DType",
+    "Image3D": "texture3DType",
+}
+
+
+# a cheap key that determines dtype_of(val), for the kernel dispatch cache
+def _dispatch_key(val):
+    cls = type(val)
+    attr = _dtype_attributes.get(cls.__name__)
+    return cls if attr is None else (cls, getattr(val, attr))
+
+
 def create_arg_expr(dtype, allow_ref):
     # Note: scalars are always passed by value
     #       vectors/matrices/arrays/structs are passed by reference if (allow_ref==True)
@@ -79,6 +98,7 @@ class FuncInstanceInfo:
         self.local_variable = {}  # dict: name -> VariableInfo(dtype, expr, is_arg)
         self.function = None
         self.shader_handle = None
+        self.launcher = None
 
     def __del__(self):
         if self.shader_handle is not None:
@@ -120,6 +140,7 @@ class func:
         self.pyfunc = pyfunc
         self.__name__ = pyfunc.__name__
         self.compiled_results = {}  # maps (arg_type_tuple) to (function, shader_handle)
+        self.dispatch_cache = {}  # maps dispatch keys of the arguments to kernel instances
         frameinfo = inspect.getframeinfo(inspect.stack()[1][0])
         self.filename = frameinfo.filename
         self.lineno = frameinfo.lineno
@@ -327,6 +348,7 @@ class func:
         if call_from_host:
             globalvars.saved_shader_count += 1
             f.shader_handle = get_global_device().impl().create_shader(f.function)
+            f.launcher = lcapi.ShaderLauncher(f.shader_handle, f.function)
         return f
 
     # looks up arg_type_tuple; compile if not existing
@@ -335,6 +357,7 @@ class func:
         if custom_key != None and self.fence_idx < custom_key:
             self.fence_idx = custom_key
             self.compiled_results.clear()
+            self.dispatch_cache.clear()
 
         arg_features = (func_type,) + argtypes
         if arg_features not in self.compiled_results:
@@ -363,35 +386,44 @@ class func:
             dispatch_size = (*dispatch_size, *[1] * (3 - len(dispatch_size)))
         else:
             is_buffer = True
-        # get types of arguments and compile
-        argtypes = tuple(dtype_of(a) for a in args)
-        f = self.get_compiled(func_type=0, allow_ref=False, argtypes=argtypes)
-        # create command
-        command = lcapi.ComputeDispatchCmdEncoder.create(f.function.argument_size(), f.shader_handle, f.function)
-        # push arguments
-        for a in args:
-            lctype = to_lctype(dtype_of(a))
-            if lctype.is_basic():
-                command.encode_uniform(lcapi.to_bytes(a), lctype.size())
-            elif lctype.is_array() or lctype.is_structure():
-                command.encode_uniform(a.to_bytes(), lctype.size())
-            elif lctype.is_buffer() or lctype.is_custom_buffer():
-                command.encode_buffer(a.handle, 0, a.bytesize)
-            elif lctype.is_texture():
-                command.encode_texture(a.handle, 0)
-            elif lctype.is_bindless_array():
-                command.encode_bindless_array(a.handle)
-            elif lctype.is_accel():
-                command.encode_accel(a.handle)
-            else:
-                assert False
-        # dispatch
+        # look up the kernel instance by the argument types, compiling it on the first dispatch
+        key = tuple(_dispatch_key(a) for a in args)
+        f = self.dispatch_cache.get(key)
+        if f is None:
+            argtypes = tuple(dtype_of(a) for a in args)
+            f = self.get_compiled(func_type=0, allow_ref=False, argtypes=argtypes)
+            self.dispatch_cache[key] = f
+        # encode & dispatch in a single native call
         if is_buffer:
-            command.set_dispatch_buffer(dispatch_size.handle, dispatch_buffer_offset, max_dispatch_size)
+            f.launcher.dispatch_indirect(stream, args, dispatch_size.handle, dispatch_buffer_offset, max_dispatch_size)
         else:
-            command.set_dispatch_size(*dispatch_size)
-        stream.add(command.build())
+            f.launcher.dispatch(stream, args, *dispatch_size)
         if f.uses_printer:  # assume that this property doesn't change with argtypes
             globalvars.printer.final_print()
             # Note: printing will FORCE synchronize (#21)
             globalvars.printer.reset()
+
+    # returns a launcher specialized for the types of the example arguments.
+    # Calling it skips the per-call type deduction and specialization lookup,
+    # so the arguments passed to it must have the same types as the examples.
+    def launcher(self, *example_args):
+        get_global_device()  # check device is initialized
+        argtypes = tuple(dtype_of(a) for a in example_args)
+        return FuncLauncher(self.get_compiled(func_type=0, allow_ref=False, argtypes=argtypes))
+
+
+class FuncLauncher:
+    def __init__(self, instance: FuncInstanceInfo):
+        self.instance = instance
+        self.launcher = instance.launcher
+
+    def __call__(self, *args, dispatch_size, stream=None):
+        if stream is None:
+            stream = globalvars.vars.stream
+        if type(dispatch_size) is int:
+            self.launcher.dispatch(stream, args, dispatch_size, 1, 1)
+        else:
+            self.launcher.dispatch(stream, args, *dispatch_size, *[1] * (3 - len(dispatch_size)))
+        if self.instance.uses_printer:
+            globalvars.printer.final_print()
+            globalvars.printer.reset()
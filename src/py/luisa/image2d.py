@@ -71,6 +71,17 @@ class Image2D:
         tex.copy_from_array(arr)
         return tex
 
+    # textures are block-tiled on host-visible backends, so they cannot be aliased and the tensor
+    # is copied once into the new texture; the producer's memory is uploaded without a staging copy
+    @staticmethod
+    def from_dlpack(tensor, dtype=None, storage=None):
+        import numpy as np
+        arr = np.from_dlpack(tensor)
+        assert len(arr.shape) == 3 and arr.shape[0] > 0 and arr.shape[1] > 0 and arr.shape[2] in (1, 2, 4)
+        tex = Image2D.empty(arr.shape[0], arr.shape[1], arr.shape[2], dtype_of(arr[0][0][0].item()) if dtype is None else dtype, storage)
+        tex.copy_from_dlpack(arr)
+        return tex
+
     # use manually load temporarily
 
     @staticmethod
@@ -149,6 +160,10 @@ class Image2D:
         if sync:
             stream.synchronize()
 
+    def copy_from_dlpack(self, tensor, sync=False, stream=None):
+        import numpy as np
+        self.copy_from_array(np.ascontiguousarray(np.from_dlpack(tensor)), sync, stream)
+
     def copy_to(self, arr, sync=True, stream=None):  # arr: numpy array
         if stream is None:
             stream = globalvars.vars.stream
@@ -1,3 +1,5 @@
+#include <atomic>
+
 #include <luisa/core/dynamic_module.h>
 #include <luisa/core/logging.h>
 #include <luisa/core/platform.h>
@@ -37,6 +39,8 @@ public:
     ValidationLayer validation_layer;
     luisa::unordered_map<luisa::string, luisa::unique_ptr<std::filesystem::path>> runtime_subdir_paths;
     std::mutex runtime_subdir_mutex;
+    std::atomic<uint64_t> shader_cache_hit_count{0u};
+    std::atomic<uint64_t> shader_cache_miss_count{0u};
 
     const BackendModule &create_module(const luisa::string &backend_name) noexcept {
         auto create_new = [&]() {
@@ -188,4 +192,18 @@ const luisa::filesystem::path &Context::create_runtime_subdir(luisa::string_view
     return *iter.first->second;
 }
 
+ShaderCacheStatistics Context::shader_cache_statistics() const noexcept {
+    return ShaderCacheStatistics{
+        .hit_count = _impl->shader_cache_hit_count.load(std::memory_order_relaxed),
+        .miss_count = _impl->shader_cache_miss_count.load(std::memory_order_relaxed)};
+}
+
+void Context::_report_shader_cache_hit() const noexcept {
+    _impl->shader_cache_hit_count.fetch_add(1u, std::memory_order_relaxed);
+}
+
+void Context::_report_shader_cache_miss() const noexcept {
+    _impl->shader_cache_miss_count.fetch_add(1u, std::memory_order_relaxed);
+}
+
 }// namespace luisa::compute
@@ -12,5 +12,13 @@ Context DeviceInterface::context() const noexcept {
     return Context{_ctx_impl};
 }
 
+void DeviceInterface::report_shader_cache_hit() const noexcept {
+    context()._report_shader_cache_hit();
+}
+
+void DeviceInterface::report_shader_cache_miss() const noexcept {
+    context()._report_shader_cache_miss();
+}
+
 }// namespace luisa::compute
 
@@ -23,6 +23,7 @@ void Stream::_dispatch(CommandList &&list) noexcept {
                          to_string(i->stream_tag()), to_string(_stream_tag));
         }
 #endif
+        if (_profiler != nullptr) { _profiler->on_dispatch(handle(), list); }
         device()->dispatch(handle(), std::move(list));
     }
 }
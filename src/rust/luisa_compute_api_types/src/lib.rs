@@ -3,6 +3,18 @@ use serde::{Deserialize, Serialize};
 use std::ffi::{c_char, c_void};
 pub const INVALID_RESOURCE_HANDLE: u64 = u64::MAX;
 pub type DispatchCallback = extern "C" fn(*mut u8);
+// reported by a profiled stream in submission order: `WorkBegin`/`WorkEnd` around
+// every enqueued item (command list, event signal/wait, present) and
+// `CommandBegin`/`CommandEnd` with the command index inside command lists.
+#[repr(C)]
+#[derive(Debug, Copy, Clone, PartialOrd, PartialEq, Ord, Eq, Hash)]
+pub enum ProfilingMark {
+    WorkBegin,
+    WorkEnd,
+    CommandBegin,
+    CommandEnd,
+}
+pub type ProfilingCallback = extern "C" fn(*mut u8, ProfilingMark, usize);
 #[repr(C)]
 #[derive(Debug, Copy, Clone, PartialOrd, PartialEq, Ord, Eq, Hash)]
 pub struct CreatedResourceInfo {
@@ -58,6 +70,17 @@ pub struct CreatedShaderInfo {
 }
 unsafe impl Send for CreatedShaderInfo {}
 unsafe impl Sync for CreatedShaderInfo {}
+
+// opaque, backend-defined serialized form of a compiled shader.
+// returned by `shader_artifact` and released with `free_shader_artifact`.
+#[repr(C)]
+#[derive(Debug, Copy, Clone, PartialOrd, PartialEq, Ord, Eq, Hash)]
+pub struct ShaderArtifact {
+    pub data: *mut u8,
+    pub size: usize,
+}
+unsafe impl Send for ShaderArtifact {}
+unsafe impl Sync for ShaderArtifact {}
 #[repr(C)]
 #[derive(Debug, Copy, Clone, PartialOrd, PartialEq, Ord, Eq, Hash)]
 pub struct ShaderOption {
@@ -493,6 +516,14 @@ pub struct TextureCopyCommand {
     pub src_level: u32,
     pub dst_level: u32,
 }
+#[repr(C)]
+#[derive(Debug, Copy, Clone, PartialOrd, PartialEq, Ord, Eq, Hash)]
+pub struct IndirectDispatchArgument {
+    pub buffer: Buffer,
+    pub offset: u32,
+    pub max_dispatch_count: u32,
+}
+
 #[repr(C)]
 #[derive(Debug, Copy, Clone, PartialOrd, PartialEq, Ord, Eq, Hash)]
 pub struct ShaderDispatchCommand {
@@ -500,6 +531,9 @@ pub struct ShaderDispatchCommand {
     pub dispatch_size: [u32; 3],
     pub args: *const Argument,
     pub args_count: usize,
+    // the dispatch sizes are read from this buffer at execution time
+    // if its handle is valid, and `dispatch_size` is ignored
+    pub indirect: IndirectDispatchArgument,
 }
 
 #[repr(C)]
@@ -650,8 +684,12 @@ pub struct DeviceInterface {
     pub destroy_device: unsafe extern "C" fn(DeviceInterface),
     pub create_buffer: unsafe extern "C" fn(Device, *const c_void, usize) -> CreatedBufferInfo,
     pub destroy_buffer: unsafe extern "C" fn(Device, Buffer),
+    pub create_buffer_from_memory:
+        unsafe extern "C" fn(Device, *const c_void, usize, *mut c_void) -> CreatedBufferInfo,
     pub create_texture:
         unsafe extern "C" fn(Device, PixelFormat, u32, u32, u32, u32, u32, bool) -> CreatedResourceInfo,
+    pub create_texture_from_memory:
+        unsafe extern "C" fn(Device, PixelFormat, u32, u32, u32, u32, u32, *mut c_void) -> CreatedResourceInfo,
     pub native_handle: unsafe extern "C" fn(Device) -> *mut c_void,
     pub compute_warp_size: unsafe extern "C" fn(Device) -> u32,
     pub destroy_texture: unsafe extern "C" fn(Device, Texture),
@@ -661,6 +699,8 @@ pub struct DeviceInterface {
     pub destroy_stream: unsafe extern "C" fn(Device, Stream),
     pub synchronize_stream: unsafe extern "C" fn(Device, Stream),
     pub dispatch: unsafe extern "C" fn(Device, Stream, CommandList, DispatchCallback, *mut u8),
+    pub set_stream_profiling:
+        unsafe extern "C" fn(Device, Stream, Option<ProfilingCallback>, *mut u8) -> bool,
     pub create_swapchain: unsafe extern "C" fn(
         Device,
         u64,
@@ -676,6 +716,15 @@ pub struct DeviceInterface {
     pub create_shader:
         unsafe extern "C" fn(Device, KernelModule, &ShaderOption) -> CreatedShaderInfo,
     pub destroy_shader: unsafe extern "C" fn(Device, Shader),
+    pub shader_artifact: unsafe extern "C" fn(Device, Shader) -> ShaderArtifact,
+    pub free_shader_artifact: unsafe extern "C" fn(Device, ShaderArtifact),
+    pub create_shader_from_artifact: unsafe extern "C" fn(
+        Device,
+        *const u8,
+        usize,
+        *const Argument,
+        usize,
+    ) -> CreatedShaderInfo,
     pub create_event: unsafe extern "C" fn(Device) -> CreatedResourceInfo,
     pub destroy_event: unsafe extern "C" fn(Device, Event),
     pub signal_event: unsafe extern "C" fn(Device, Event, Stream, u64),
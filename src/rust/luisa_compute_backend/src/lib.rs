@@ -122,7 +122,7 @@ impl Context {
 
     pub fn create_device(&self, device: &str, config: serde_json::Value) -> ProxyBackend {
         match device {
-            "cpu" | "remote" => match &self.rust {
+            "cpu" => match &self.rust {
                 Ok(provider) => ProxyBackend::new(provider, device, config),
                 Err(err) => {
                     let libname = if cfg!(target_os = "windows") {
@@ -139,7 +139,7 @@ impl Context {
                     panic!("device {0} not found. {0} device may not be enabled or {1} is not found. detailed error: {2}", device, libname, err);
                 }
             },
-            "cuda" | "dx" | "metal" => match &self.cpp {
+            "cuda" | "dx" | "metal" | "remote" => match &self.cpp {
                 Ok(provider) => ProxyBackend::new(provider, device, config),
                 Err(err) => {
                     let libname = if cfg!(target_os = "windows") {
@@ -173,6 +173,20 @@ pub trait Backend: Sync + Send {
     fn compute_warp_size(&self) -> u32;
     fn create_buffer(&self, ty: &CArc<ir::Type>, count: usize) -> api::CreatedBufferInfo;
     fn destroy_buffer(&self, buffer: api::Buffer);
+    // wraps caller-owned memory (e.g. the reserved range of a sparse resource),
+    // returns an invalid handle if the backend cannot access host memory
+    fn create_buffer_from_memory(
+        &self,
+        _ty: &CArc<ir::Type>,
+        _count: usize,
+        _data: *mut c_void,
+    ) -> api::CreatedBufferInfo {
+        api::CreatedBufferInfo {
+            resource: api::CreatedResourceInfo::INVALID,
+            element_stride: 0,
+            total_size_bytes: 0,
+        }
+    }
     fn create_texture(
         &self,
         format: PixelFormat,
@@ -183,6 +197,20 @@ pub trait Backend: Sync + Send {
         mipmap_levels: u32,
         allow_simultaneous_access: bool,
     ) -> api::CreatedResourceInfo;
+    // wraps caller-owned memory of a sparse texture, laid out in 64KB tiles
+    // that are stored one after another so that each tile maps as a whole
+    fn create_texture_from_memory(
+        &self,
+        _format: PixelFormat,
+        _dimension: u32,
+        _width: u32,
+        _height: u32,
+        _depth: u32,
+        _mipmap_levels: u32,
+        _data: *mut c_void,
+    ) -> api::CreatedResourceInfo {
+        api::CreatedResourceInfo::INVALID
+    }
     fn destroy_texture(&self, texture: api::Texture);
     fn create_bindless_array(&self, size: usize) -> api::CreatedResourceInfo;
     fn destroy_bindless_array(&self, array: api::BindlessArray);
@@ -195,6 +223,14 @@ pub trait Backend: Sync + Send {
         command_list: &[api::Command],
         callback: (extern "C" fn(*mut u8), *mut u8),
     );
+    // returns false if the backend cannot report per-command progress
+    fn set_stream_profiling(
+        &self,
+        _stream: api::Stream,
+        _profiler: Option<(api::ProfilingCallback, *mut u8)>,
+    ) -> bool {
+        false
+    }
     fn create_swapchain(
         &self,
         window_handle: u64,
@@ -218,6 +254,16 @@ pub trait Backend: Sync + Send {
         options: &api::ShaderOption,
     ) -> api::CreatedShaderInfo;
     fn shader_cache_dir(&self, shader: api::Shader) -> Option<PathBuf>;
+    fn shader_artifact(&self, _shader: api::Shader) -> Option<Vec<u8>> {
+        None
+    }
+    fn create_shader_from_artifact(
+        &self,
+        _artifact: &[u8],
+        _captures: &[api::Argument],
+    ) -> Option<api::CreatedShaderInfo> {
+        None
+    }
     fn destroy_shader(&self, shader: api::Shader);
     fn create_event(&self) -> api::CreatedResourceInfo;
     fn destroy_event(&self, event: api::Event);
@@ -274,6 +320,17 @@ pub extern "C" fn destroy_buffer<B: Backend>(backend: api::Device, buffer: api::
     backend.destroy_buffer(buffer)
 }
 
+extern "C" fn create_buffer_from_memory<B: Backend>(
+    backend: api::Device,
+    ty: *const c_void,
+    count: usize,
+    data: *mut c_void,
+) -> api::CreatedBufferInfo {
+    let backend: &B = get_backend(backend);
+    let ty = unsafe { &*(ty as *const CArc<ir::Type>) };
+    backend.create_buffer_from_memory(ty, count, data)
+}
+
 //
 pub extern "C" fn create_texture<B: Backend>(
     backend: api::Device,
@@ -289,6 +346,21 @@ pub extern "C" fn create_texture<B: Backend>(
     backend.create_texture(format, dimension, width, height, depth,
                            mipmap_levels, allow_simultaneous_access)
 }
+
+extern "C" fn create_texture_from_memory<B: Backend>(
+    backend: api::Device,
+    format: PixelFormat,
+    dimension: u32,
+    width: u32,
+    height: u32,
+    depth: u32,
+    mipmap_levels: u32,
+    data: *mut c_void,
+) -> api::CreatedResourceInfo {
+    let backend: &B = get_backend(backend);
+    backend.create_texture_from_memory(format, dimension, width, height, depth,
+                                       mipmap_levels, data)
+}
 //
 
 extern "C" fn destroy_texture<B: Backend>(backend: api::Device, texture: api::Texture) {
@@ -335,10 +407,24 @@ extern "C" fn dispatch<B: Backend>(
     user_data: *mut u8,
 ) {
     let backend: &B = get_backend(backend);
-    let command_list =
-        unsafe { std::slice::from_raw_parts(command_list.commands, command_list.commands_count) };
+    // empty lists (e.g. sparse updates that only need the callback) may have no storage
+    let command_list = if command_list.commands_count == 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(command_list.commands, command_list.commands_count) }
+    };
     backend.dispatch(stream, command_list, (callback, user_data))
 }
+
+extern "C" fn set_stream_profiling<B: Backend>(
+    backend: api::Device,
+    stream: api::Stream,
+    callback: Option<api::ProfilingCallback>,
+    user_data: *mut u8,
+) -> bool {
+    let backend: &B = get_backend(backend);
+    backend.set_stream_profiling(stream, callback.map(|callback| (callback, user_data)))
+}
 //
 
 unsafe extern "C" fn create_shader<B: Backend>(
@@ -356,6 +442,63 @@ extern "C" fn destroy_shader<B: Backend>(backend: api::Device, shader: api::Shad
     backend.destroy_shader(shader)
 }
 
+extern "C" fn shader_artifact<B: Backend>(
+    backend: api::Device,
+    shader: api::Shader,
+) -> api::ShaderArtifact {
+    let backend: &B = get_backend(backend);
+    match backend.shader_artifact(shader) {
+        Some(artifact) => {
+            let artifact = artifact.into_boxed_slice();
+            let size = artifact.len();
+            api::ShaderArtifact {
+                data: Box::into_raw(artifact) as *mut u8,
+                size,
+            }
+        }
+        None => api::ShaderArtifact {
+            data: std::ptr::null_mut(),
+            size: 0,
+        },
+    }
+}
+
+extern "C" fn free_shader_artifact<B: Backend>(
+    _backend: api::Device,
+    artifact: api::ShaderArtifact,
+) {
+    if !artifact.data.is_null() {
+        unsafe {
+            drop(Box::from_raw(std::ptr::slice_from_raw_parts_mut(
+                artifact.data,
+                artifact.size,
+            )));
+        }
+    }
+}
+
+unsafe extern "C" fn create_shader_from_artifact<B: Backend>(
+    backend: api::Device,
+    data: *const u8,
+    size: usize,
+    captures: *const api::Argument,
+    captures_count: usize,
+) -> api::CreatedShaderInfo {
+    let backend: &B = get_backend(backend);
+    let artifact = std::slice::from_raw_parts(data, size);
+    let captures = if captures_count == 0 {
+        &[]
+    } else {
+        std::slice::from_raw_parts(captures, captures_count)
+    };
+    backend
+        .create_shader_from_artifact(artifact, captures)
+        .unwrap_or(api::CreatedShaderInfo {
+            resource: api::CreatedResourceInfo::INVALID,
+            block_size: [0, 0, 0],
+        })
+}
+
 extern "C" fn create_event<B: Backend>(backend: api::Device) -> api::CreatedResourceInfo {
     let backend: &B = get_backend(backend);
     backend.create_event()
@@ -518,7 +661,9 @@ pub fn create_device_interface<B: Backend>(backend: B) -> api::DeviceInterface {
         destroy_device: destroy_device::<B>,
         create_buffer: create_buffer::<B>,
         destroy_buffer: destroy_buffer::<B>,
+        create_buffer_from_memory: create_buffer_from_memory::<B>,
         create_texture: create_texture::<B>,
+        create_texture_from_memory: create_texture_from_memory::<B>,
         destroy_texture: destroy_texture::<B>,
         create_bindless_array: create_bindless_array::<B>,
         destroy_bindless_array: destroy_bindless_array::<B>,
@@ -526,11 +671,15 @@ pub fn create_device_interface<B: Backend>(backend: B) -> api::DeviceInterface {
         destroy_stream: destroy_stream::<B>,
         synchronize_stream: synchronize_stream::<B>,
         dispatch: dispatch::<B>,
+        set_stream_profiling: set_stream_profiling::<B>,
         create_swapchain: create_swapchain::<B>,
         present_display_in_stream: present_display_in_stream::<B>,
         destroy_swapchain: destroy_swapchain::<B>,
         create_shader: create_shader::<B>,
         destroy_shader: destroy_shader::<B>,
+        shader_artifact: shader_artifact::<B>,
+        free_shader_artifact: free_shader_artifact::<B>,
+        create_shader_from_artifact: create_shader_from_artifact::<B>,
         create_event: create_event::<B>,
         destroy_event: destroy_event::<B>,
         signal_event: signal_event::<B>,
@@ -111,6 +111,22 @@ impl Backend for ProxyBackend {
         })
     }
     #[inline]
+    fn create_buffer_from_memory(
+        &self,
+        ty: &CArc<Type>,
+        count: usize,
+        data: *mut c_void,
+    ) -> api::CreatedBufferInfo {
+        catch_abort!({
+            (self.device.create_buffer_from_memory)(
+                self.device.device,
+                ty as *const _ as *const c_void,
+                count,
+                data,
+            )
+        })
+    }
+    #[inline]
     fn create_texture(
         &self,
         format: api::PixelFormat,
@@ -135,6 +151,30 @@ impl Backend for ProxyBackend {
         })
     }
     #[inline]
+    fn create_texture_from_memory(
+        &self,
+        format: api::PixelFormat,
+        dimension: u32,
+        width: u32,
+        height: u32,
+        depth: u32,
+        mipmap_levels: u32,
+        data: *mut c_void,
+    ) -> api::CreatedResourceInfo {
+        catch_abort!({
+            (self.device.create_texture_from_memory)(
+                self.device.device,
+                std::mem::transmute(format),
+                dimension,
+                width,
+                height,
+                depth,
+                mipmap_levels,
+                data,
+            )
+        })
+    }
+    #[inline]
     fn destroy_texture(&self, texture: api::Texture) {
         catch_abort!({ (self.device.destroy_texture)(self.device.device, texture,) })
     }
@@ -179,6 +219,20 @@ impl Backend for ProxyBackend {
         })
     }
     #[inline]
+    fn set_stream_profiling(
+        &self,
+        stream: api::Stream,
+        profiler: Option<(api::ProfilingCallback, *mut u8)>,
+    ) -> bool {
+        catch_abort!({
+            let (callback, user_data) = match profiler {
+                Some((callback, user_data)) => (Some(callback), user_data),
+                None => (None, std::ptr::null_mut()),
+            };
+            (self.device.set_stream_profiling)(self.device.device, stream, callback, user_data)
+        })
+    }
+    #[inline]
     fn create_swapchain(
         &self,
         window_handle: u64,
@@ -243,6 +297,39 @@ impl Backend for ProxyBackend {
         Some(".cache".into())
     }
     #[inline]
+    fn shader_artifact(&self, shader: api::Shader) -> Option<Vec<u8>> {
+        catch_abort!({
+            let artifact = (self.device.shader_artifact)(self.device.device, shader);
+            if artifact.data.is_null() {
+                return None;
+            }
+            let data = std::slice::from_raw_parts(artifact.data, artifact.size).to_vec();
+            (self.device.free_shader_artifact)(self.device.device, artifact);
+            Some(data)
+        })
+    }
+    #[inline]
+    fn create_shader_from_artifact(
+        &self,
+        artifact: &[u8],
+        captures: &[api::Argument],
+    ) -> Option<api::CreatedShaderInfo> {
+        catch_abort!({
+            let info = (self.device.create_shader_from_artifact)(
+                self.device.device,
+                artifact.as_ptr(),
+                artifact.len(),
+                captures.as_ptr(),
+                captures.len(),
+            );
+            if info.resource.handle == api::INVALID_RESOURCE_HANDLE {
+                None
+            } else {
+                Some(info)
+            }
+        })
+    }
+    #[inline]
     fn destroy_shader(&self, shader: api::Shader) {
         catch_abort!({ (self.device.destroy_shader)(self.device.device, shader) })
     }
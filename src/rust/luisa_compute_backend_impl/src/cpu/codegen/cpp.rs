@@ -673,6 +673,24 @@ impl<'a> FunctionEmitter<'a> {
                 .unwrap();
                 true
             }
+            Func::IndirectDispatchSetCount => {
+                writeln!(
+                    &mut self.body,
+                    "lc_indirect_set_dispatch_count(k_args, {}, {});",
+                    args_v[0], args_v[1]
+                )
+                .unwrap();
+                true
+            }
+            Func::IndirectDispatchSetKernel => {
+                writeln!(
+                    &mut self.body,
+                    "lc_indirect_set_dispatch_kernel(k_args, {}, {}, {}, {}, {});",
+                    args_v[0], args_v[1], args_v[2], args_v[3], args_v[4]
+                )
+                .unwrap();
+                true
+            }
             Func::BufferRead => {
                 let buffer_ty = self.type_gen.gen_c_type(args[0].type_());
                 writeln!(
@@ -1043,6 +1061,10 @@ impl<'a> FunctionEmitter<'a> {
                 writeln!(self.body, "const {} {} = lc_block_id();", node_ty_s, var).unwrap();
                 true
             }
+            Func::KernelId => {
+                writeln!(self.body, "const {} {} = lc_kernel_id();", node_ty_s, var).unwrap();
+                true
+            }
             Func::ThreadId => {
                 writeln!(self.body, "const {} {} = lc_thread_id();", node_ty_s, var).unwrap();
                 true
@@ -1277,6 +1299,106 @@ impl<'a> FunctionEmitter<'a> {
                 self.atomic_chain_op(var, node_ty_s, args, args_v, "lc_atomic_fetch_xor", 1);
                 true
             }
+            // the memory order is passed on as the last operand
+            Func::AtomicExchangeExplicit => {
+                self.atomic_chain_op(
+                    var,
+                    node_ty_s,
+                    args,
+                    args_v,
+                    "lc_atomic_exchange_explicit",
+                    2,
+                );
+                true
+            }
+            Func::AtomicCompareExchangeExplicit => {
+                self.atomic_chain_op(
+                    var,
+                    node_ty_s,
+                    args,
+                    args_v,
+                    "lc_atomic_compare_exchange_explicit",
+                    3,
+                );
+                true
+            }
+            Func::AtomicFetchAddExplicit => {
+                self.atomic_chain_op(
+                    var,
+                    node_ty_s,
+                    args,
+                    args_v,
+                    "lc_atomic_fetch_add_explicit",
+                    2,
+                );
+                true
+            }
+            Func::AtomicFetchSubExplicit => {
+                self.atomic_chain_op(
+                    var,
+                    node_ty_s,
+                    args,
+                    args_v,
+                    "lc_atomic_fetch_sub_explicit",
+                    2,
+                );
+                true
+            }
+            Func::AtomicFetchMinExplicit => {
+                self.atomic_chain_op(
+                    var,
+                    node_ty_s,
+                    args,
+                    args_v,
+                    "lc_atomic_fetch_min_explicit",
+                    2,
+                );
+                true
+            }
+            Func::AtomicFetchMaxExplicit => {
+                self.atomic_chain_op(
+                    var,
+                    node_ty_s,
+                    args,
+                    args_v,
+                    "lc_atomic_fetch_max_explicit",
+                    2,
+                );
+                true
+            }
+            Func::AtomicFetchAndExplicit => {
+                self.atomic_chain_op(
+                    var,
+                    node_ty_s,
+                    args,
+                    args_v,
+                    "lc_atomic_fetch_and_explicit",
+                    2,
+                );
+                true
+            }
+            Func::AtomicFetchOrExplicit => {
+                self.atomic_chain_op(
+                    var,
+                    node_ty_s,
+                    args,
+                    args_v,
+                    "lc_atomic_fetch_or_explicit",
+                    2,
+                );
+                true
+            }
+            Func::AtomicFetchXorExplicit => {
+                self.atomic_chain_op(
+                    var,
+                    node_ty_s,
+                    args,
+                    args_v,
+                    "lc_atomic_fetch_xor_explicit",
+                    2,
+                );
+                true
+            }
             Func::CpuCustomOp(op) => {
                 let i = *self
                     .globals
@@ -1711,7 +1833,7 @@ impl<'a> FunctionEmitter<'a> {
                 self.write_ident();
                 writeln!(&mut self.body, "}}").unwrap();
             }
-            Instruction::AdScope { body } => {
+            Instruction::AdScope { body, .. } => {
                 writeln!(&mut self.body, "/* AdScope */").unwrap();
                 self.gen_block(*body);
                 self.write_ident();
@@ -47,6 +47,7 @@ inline int __float_as_int(float x) {
 #define lc_dispatch_size() lc_make_uint3(k_args->dispatch_size[0], k_args->dispatch_size[1], k_args->dispatch_size[2])
 #define lc_thread_id() lc_make_uint3(k_args->thread_id[0], k_args->thread_id[1], k_args->thread_id[2])
 #define lc_block_id() lc_make_uint3(k_args->block_id[0], k_args->block_id[1], k_args->block_id[2])
+#define lc_kernel_id() (k_args->kernel_id)
 #ifdef _WIN32
 #define lc_kernel extern "C" __declspec(dllexport)
 #else
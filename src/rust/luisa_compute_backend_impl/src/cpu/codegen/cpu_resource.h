@@ -68,6 +68,46 @@ inline void lc_byte_buffer_write(const KernelFnArgs *k_args, const BufferView &b
     *(reinterpret_cast<T *>(buffer.data + i)) = value;
 }
 
+// indirect dispatch buffers: a header with the dispatch count followed by the dispatches,
+// read by the stream when the buffer is dispatched (see read_indirect_dispatches in stream.rs)
+struct alignas(16) LCIndirectHeader {
+    lc_uint size;
+};
+
+struct alignas(16) LCIndirectDispatch {
+    lc_uint3 block_size;
+    lc_uint4 dispatch_size_and_kernel_id;
+};
+
+static_assert(sizeof(LCIndirectHeader) == 16 && sizeof(LCIndirectDispatch) == 32);
+
+inline lc_uint lc_indirect_capacity(const BufferView &buffer) noexcept {
+    return static_cast<lc_uint>((buffer.size - sizeof(LCIndirectHeader)) / sizeof(LCIndirectDispatch));
+}
+
+inline void lc_indirect_set_dispatch_count(const KernelFnArgs *k_args, const BufferView &buffer, lc_uint count) noexcept {
+#ifdef LUISA_DEBUG
+    if (count > lc_indirect_capacity(buffer)) {
+        lc_abort_and_print_sll(k_args->internal_data, "Indirect dispatch count out of bounds: {} > {}", count,
+                               lc_indirect_capacity(buffer));
+    }
+#endif
+    reinterpret_cast<LCIndirectHeader *>(buffer.data)->size = count;
+}
+
+inline void lc_indirect_set_dispatch_kernel(const KernelFnArgs *k_args, const BufferView &buffer, lc_uint index,
+                                            lc_uint3 block_size, lc_uint3 dispatch_size, lc_uint kernel_id) noexcept {
+#ifdef LUISA_DEBUG
+    if (index >= lc_indirect_capacity(buffer)) {
+        lc_abort_and_print_sll(k_args->internal_data, "Indirect dispatch index out of bounds: {} >= {}", index,
+                               lc_indirect_capacity(buffer));
+    }
+#endif
+    auto dispatches = reinterpret_cast<LCIndirectDispatch *>(buffer.data + sizeof(LCIndirectHeader));
+    dispatches[index] = LCIndirectDispatch{
+        block_size, lc_make_uint4(dispatch_size, kernel_id)};
+}
+
 inline BufferView lc_buffer_arg(const KernelFnArgs *k_args, size_t i) noexcept {
 #ifdef LUISA_DEBUG
     if (i >= k_args->args_count) {
@@ -237,6 +277,85 @@ inline T lc_atomic_fetch_max(T *ptr, T value) noexcept {
     }
 }
 
+// maps luisa::compute::MemoryOrder to the __ATOMIC_* orders; the order is a
+// constant in the generated code, so the switch folds away after inlining
+inline int lc_memory_order(uint32_t order) noexcept {
+    switch (order) {
+        case 0u: return __ATOMIC_RELAXED;
+        case 1u: return __ATOMIC_ACQUIRE;
+        case 2u: return __ATOMIC_RELEASE;
+        case 3u: return __ATOMIC_ACQ_REL;
+        default: return __ATOMIC_SEQ_CST;
+    }
+}
+
+// the order of the load of a failed compare exchange or of a min/max that does not
+// store, which may not release
+inline int lc_memory_order_failure(uint32_t order) noexcept {
+    switch (order) {
+        case 0u: return __ATOMIC_RELAXED;
+        case 1u: return __ATOMIC_ACQUIRE;
+        case 2u: return __ATOMIC_RELAXED;
+        case 3u: return __ATOMIC_ACQUIRE;
+        default: return __ATOMIC_SEQ_CST;
+    }
+}
+
+template<class T>
+inline T lc_atomic_compare_exchange_explicit(T *ptr, T expected, T desired, uint32_t order) noexcept {
+    auto old = expected;
+    __atomic_compare_exchange_n(ptr, &old, desired, false, lc_memory_order(order), lc_memory_order_failure(order));
+    return old;
+}
+
+template<class T>
+inline T lc_atomic_exchange_explicit(T *ptr, T desired, uint32_t order) noexcept {
+    return __atomic_exchange_n(ptr, desired, lc_memory_order(order));
+}
+
+template<class T>
+inline T lc_atomic_fetch_add_explicit(T *ptr, T value, uint32_t order) noexcept {
+    return __atomic_fetch_add(ptr, value, lc_memory_order(order));
+}
+
+template<class T>
+inline T lc_atomic_fetch_sub_explicit(T *ptr, T value, uint32_t order) noexcept {
+    return __atomic_fetch_sub(ptr, value, lc_memory_order(order));
+}
+
+template<class T>
+inline T lc_atomic_fetch_and_explicit(T *ptr, T value, uint32_t order) noexcept {
+    return __atomic_fetch_and(ptr, value, lc_memory_order(order));
+}
+
+template<class T>
+inline T lc_atomic_fetch_or_explicit(T *ptr, T value, uint32_t order) noexcept {
+    return __atomic_fetch_or(ptr, value, lc_memory_order(order));
+}
+
+template<class T>
+inline T lc_atomic_fetch_xor_explicit(T *ptr, T value, uint32_t order) noexcept {
+    return __atomic_fetch_xor(ptr, value, lc_memory_order(order));
+}
+
+template<class T>
+inline T lc_atomic_fetch_min_explicit(T *ptr, T value, uint32_t order) noexcept {
+    while (true) {
+        auto old = __atomic_load_n(ptr, lc_memory_order_failure(order));
+        if (old <= value) return old;
+        if (lc_atomic_compare_exchange_explicit(ptr, old, value, order) == old) return old;
+    }
+}
+
+template<class T>
+inline T lc_atomic_fetch_max_explicit(T *ptr, T value, uint32_t order) noexcept {
+    while (true) {
+        auto old = __atomic_load_n(ptr, lc_memory_order_failure(order));
+        if (old >= value) return old;
+        if (lc_atomic_compare_exchange_explicit(ptr, old, value, order) == old) return old;
+    }
+}
+
 inline Hit lc_trace_closest(const Accel &accel, const Ray &ray, uint8_t mask) noexcept {
     return accel.trace_closest(accel.handle, &ray, mask);
 }
@@ -370,73 +489,77 @@ __device__ inline T lc_unpack_from(BufferView array, lc_uint idx) {
         return x.value;
     }
 }
-inline bool warp_is_first_active_lane() {
+// a CPU thread is a warp of a single lane
+inline bool lc_warp_is_first_active_lane() {
     return true;
 }
+inline lc_uint lc_warp_first_active_lane() {
+    return 0u;
+}
 template<class T>
-inline bool warp_active_all_equal(T && v) {
+inline bool lc_warp_active_all_equal(T v) {
     return true;
 }
 template<class T>
-inline T warp_active_bit_and(T && v) {
+inline T lc_warp_active_bit_and(T v) {
     return v;
 }
 template<class T>
-inline T warp_active_bit_or(T && v) {
+inline T lc_warp_active_bit_or(T v) {
     return v;
 }
 template<class T>
-inline T warp_active_bit_xor(T && v) {
+inline T lc_warp_active_bit_xor(T v) {
     return v;
 }
-inline lc_uint warp_active_count_bits() {
-    return 1;
+inline lc_uint lc_warp_active_count_bits(bool v) {
+    return v ? 1u : 0u;
 }
 template<class T>
-inline T warp_active_max(T v) {
+inline T lc_warp_active_max(T v) {
     return v;
 }
 template<class T>
-inline T warp_active_min(T v) {
+inline T lc_warp_active_min(T v) {
     return v;
 }
 template<class T>
-inline T warp_active_product(T v) {
+inline T lc_warp_active_product(T v) {
     return v;
 }
 template<class T>
-inline T warp_active_sum(T v) {
+inline T lc_warp_active_sum(T v) {
     return v;
 }
 
-inline lc_uint warp_all(bool v) {
+inline bool lc_warp_active_all(bool v) {
     return v;
 }
 
-inline lc_uint warp_any(bool v) {
+inline bool lc_warp_active_any(bool v) {
     return v;
 }
 
-inline lc_uint4 warp_active_bit_mask() {
-    return lc_make_uint4(1u, 0, 0, 0);
+inline lc_uint4 lc_warp_active_bit_mask(bool v) {
+    return lc_make_uint4(v ? 1u : 0u, 0u, 0u, 0u);
 }
-inline lc_uint warp_prefix_count_bits() {
-    return 0;
+inline lc_uint lc_warp_prefix_count_bits(bool v) {
+    return 0u;
 }
 template<class T>
-inline T warp_prefix_sum(T &&) {
+inline T lc_warp_prefix_sum(T v) {
     return lc_zero<T>();
 }
 template<class T>
-inline T warp_prefix_product(T &&) {
+inline T lc_warp_prefix_product(T v) {
     return lc_one<T>();
 }
 template<class T>
-inline T warp_read_lane_at(T && v, lc_uint index) {
+inline T lc_warp_read_lane_at(T v, lc_uint index) {
     return v;
 }
 template<class T>
-inline T read_first_lane(T && v) {
+inline T lc_warp_read_first_lane(T v) {
     return v;
 }
 inline void lc_shader_execution_reorder(lc_uint hint, lc_uint hint_bits) noexcept {}
@@ -290,6 +290,69 @@ namespace detail {
         }
     }
 
+    // clang vector extensions, lowered to SSE/AVX on x86-64 and NEON on ARM64 by -march=native
+    typedef float lc_simd_float4 __attribute__((ext_vector_type(4)));
+    typedef uint8_t lc_simd_uchar4 __attribute__((ext_vector_type(4)));
+    typedef uint16_t lc_simd_ushort4 __attribute__((ext_vector_type(4)));
+    typedef __fp16 lc_simd_half4 __attribute__((ext_vector_type(4)));
+
+    // same as pixel_to_float4, but converts all channels at once; missing channels are zero
+    template<typename T, lc_uint dim>
+    [[nodiscard]] inline lc_simd_float4 decode_texel(const uint8_t *pixel) noexcept {
+        if constexpr (lc_is_same_v<T, uint8_t>) {
+            lc_simd_uchar4 v{};
+            __builtin_memcpy(&v, pixel, sizeof(T) * dim);
+            return __builtin_convertvector(v, lc_simd_float4) / 255.f;
+        } else if constexpr (lc_is_same_v<T, uint16_t>) {
+            lc_simd_ushort4 v{};
+            __builtin_memcpy(&v, pixel, sizeof(T) * dim);
+            return __builtin_convertvector(v, lc_simd_float4) / 65535.f;
+        } else if constexpr (lc_is_same_v<T, float16_t>) {
+            lc_simd_half4 v{};
+            __builtin_memcpy(&v, pixel, sizeof(T) * dim);
+            return __builtin_convertvector(v, lc_simd_float4);
+        } else if constexpr (lc_is_same_v<T, float>) {
+            lc_simd_float4 v{};
+            __builtin_memcpy(&v, pixel, sizeof(T) * dim);
+            return v;
+        } else {
+            return lc_simd_float4{};
+        }
+    }
+
+    [[nodiscard]] inline lc_simd_float4 simd_lerp(lc_simd_float4 a, lc_simd_float4 b, float t) noexcept {
+        return t * (b - a) + a;
+    }
+
+    [[nodiscard]] inline lc_float4 simd_to_float4(lc_simd_float4 v) noexcept {
+        return lc_make_float4(v.x, v.y, v.z, v.w);
+    }
+
+    // calls f.template operator()<T, dim>() with the channel type and count of the storage,
+    // so that filters decode every texel of their footprint without switching on the format
+    template<typename F>
+    [[nodiscard]] inline lc_float4 with_texel_format(LCPixelStorage storage, F &&f) noexcept {
+        switch (storage) {
+            case LC_PIXEL_STORAGE_BYTE1: return f.template operator()<uint8_t, 1u>();
+            case LC_PIXEL_STORAGE_BYTE2: return f.template operator()<uint8_t, 2u>();
+            case LC_PIXEL_STORAGE_BYTE4: return f.template operator()<uint8_t, 4u>();
+            case LC_PIXEL_STORAGE_SHORT1: return f.template operator()<uint16_t, 1u>();
+            case LC_PIXEL_STORAGE_SHORT2: return f.template operator()<uint16_t, 2u>();
+            case LC_PIXEL_STORAGE_SHORT4: return f.template operator()<uint16_t, 4u>();
+            case LC_PIXEL_STORAGE_INT1: return f.template operator()<uint32_t, 1u>();
+            case LC_PIXEL_STORAGE_INT2: return f.template operator()<uint32_t, 2u>();
+            case LC_PIXEL_STORAGE_INT4: return f.template operator()<uint32_t, 4u>();
+            case LC_PIXEL_STORAGE_HALF1: return f.template operator()<float16_t, 1u>();
+            case LC_PIXEL_STORAGE_HALF2: return f.template operator()<float16_t, 2u>();
+            case LC_PIXEL_STORAGE_HALF4: return f.template operator()<float16_t, 4u>();
+            case LC_PIXEL_STORAGE_FLOAT1: return f.template operator()<float, 1u>();
+            case LC_PIXEL_STORAGE_FLOAT2: return f.template operator()<float, 2u>();
+            case LC_PIXEL_STORAGE_FLOAT4: return f.template operator()<float, 4u>();
+            default: break;
+        }
+        return {};
+    }
+
 // MIP-Map EWA filtering LUT from PBRT-v4
     static constexpr const float ewa_filter_weight_lut[] = {
             0.8646647330f, 0.8490400310f, 0.8336595300f, 0.8185192940f, 0.8036156300f, 0.78894478100f, 0.7745032310f,
@@ -335,28 +398,72 @@ struct TextureView {
     uint32_t depth;
     uint8_t storage;
     uint8_t pixel_stride_shift;
+    uint8_t tiled;
+
+    static constexpr auto block_size = 4u;
+    static constexpr auto tile_size_bytes = 64u * 1024u;
+
+    // Sparse textures store their 64KB tiles one after another, block-linear within each tile.
+    template<lc_uint dim>
+    [[nodiscard]] inline lc_uint3 _tile_size() const noexcept {
+        return dim == 2u ? lc_make_uint3(1024u >> pixel_stride_shift, 64u, 1u) :
+                           lc_make_uint3(256u >> pixel_stride_shift, 16u, 16u);
+    }
+
+    // The index of a texel in the block-linear layout is the sum of the offsets of its
+    // column, row and slice, so filters compute them once for the whole footprint.
+    template<lc_uint dim>
+    [[nodiscard]] inline lc_uint _column_offset(lc_uint x) const noexcept {
+        constexpr auto block_pixels = dim == 2u ? block_size * block_size : block_size * block_size * block_size;
+        if (tiled) {
+            auto t = _tile_size<dim>();
+            auto tile_pixels = tile_size_bytes >> pixel_stride_shift;
+            return x / t.x * tile_pixels + x % t.x / block_size * block_pixels + x % block_size;
+        }
+        return x / block_size * block_pixels + x % block_size;
+    }
+
+    template<lc_uint dim>
+    [[nodiscard]] inline lc_uint _row_offset(lc_uint y) const noexcept {
+        constexpr auto block_pixels = dim == 2u ? block_size * block_size : block_size * block_size * block_size;
+        if (tiled) {
+            auto t = _tile_size<dim>();
+            auto tile_pixels = tile_size_bytes >> pixel_stride_shift;
+            auto tiles_x = (width + t.x - 1u) / t.x;
+            return y / t.y * tiles_x * tile_pixels +
+                   y % t.y / block_size * (t.x / block_size) * block_pixels +
+                   y % block_size * block_size;
+        }
+        auto grid_width = (width + block_size - 1u) / block_size;
+        return grid_width * (y / block_size) * block_pixels + y % block_size * block_size;
+    }
+
+    [[nodiscard]] inline lc_uint _slice_offset(lc_uint z) const noexcept {
+        constexpr auto block_pixels = block_size * block_size * block_size;
+        if (tiled) {
+            auto t = _tile_size<3u>();
+            auto tile_pixels = tile_size_bytes >> pixel_stride_shift;
+            auto tiles_x = (width + t.x - 1u) / t.x;
+            auto tiles_y = (height + t.y - 1u) / t.y;
+            return z / t.z * tiles_x * tiles_y * tile_pixels +
+                   z % t.z / block_size * (t.x / block_size) * (t.y / block_size) * block_pixels +
+                   z % block_size * block_size * block_size;
+        }
+        auto grid_width = (width + block_size - 1u) / block_size;
+        auto grid_height = (height + block_size - 1u) / block_size;
+        return grid_width * grid_height * (z / block_size) * block_pixels + z % block_size * block_size * block_size;
+    }
 
-    static constexpr auto block_size = 4;
+    [[nodiscard]] inline uint8_t *_texel(lc_uint index) const noexcept {
+        return data + (static_cast<size_t>(index) << pixel_stride_shift);
+    }
 
     [[nodiscard]] inline uint8_t *_pixel2d(lc_uint2 xy) const noexcept {
-        auto block = xy / block_size;
-        auto pixel = xy % block_size;
-        auto grid_width = (width + block_size - 1u) / block_size;
-        auto block_index = grid_width * block.y + block.x;
-        auto pixel_index = block_index * block_size * block_size +
-                           pixel.y * block_size + pixel.x;
-        return data + (static_cast<size_t>(pixel_index) << pixel_stride_shift);
+        return _texel(_row_offset<2u>(xy.y) + _column_offset<2u>(xy.x));
     }
 
     [[nodiscard]] inline uint8_t *_pixel3d(lc_uint3 xyz) const noexcept {
-        auto block = xyz / block_size;
-        auto pixel = xyz % block_size;
-        auto grid_width = (width + block_size - 1u) / block_size;
-        auto grid_height = (height + block_size - 1u) / block_size;
-        auto block_index = grid_width * grid_height * block.z + grid_width * block.y + block.x;
-        auto pixel_index = block_index * block_size * block_size * block_size +
-                           (pixel.z * block_size + pixel.y) * block_size + pixel.x;
-        return data + (static_cast<size_t>(pixel_index) << pixel_stride_shift);
+        return _texel(_slice_offset(xyz.z) + _row_offset<3u>(xyz.y) + _column_offset<3u>(xyz.x));
     }
 
     [[nodiscard]] inline auto _out_of_bounds(lc_uint2 xy) const noexcept {
@@ -399,6 +506,56 @@ struct TextureView {
 };
 
 
+namespace detail {
+    template<typename T, lc_uint dim>
+    [[nodiscard]] inline lc_simd_float4 fetch_texel(const TextureView &view, lc_uint index, bool valid) noexcept {
+        return valid ? decode_texel<T, dim>(view._texel(index)) : lc_simd_float4{};
+    }
+
+    template<typename T, lc_uint dim>
+    [[nodiscard]] inline lc_float4 sample_linear_2d(const TextureView &view, lc_uint2 c0, lc_uint2 c1, lc_float2 t) noexcept {
+        auto x0 = view._column_offset<2u>(c0.x);
+        auto x1 = view._column_offset<2u>(c1.x);
+        auto y0 = view._row_offset<2u>(c0.y);
+        auto y1 = view._row_offset<2u>(c1.y);
+        auto in_x0 = c0.x < view.width, in_x1 = c1.x < view.width;
+        auto in_y0 = c0.y < view.height, in_y1 = c1.y < view.height;
+        auto v00 = fetch_texel<T, dim>(view, y0 + x0, in_x0 & in_y0);
+        auto v01 = fetch_texel<T, dim>(view, y0 + x1, in_x1 & in_y0);
+        auto v10 = fetch_texel<T, dim>(view, y1 + x0, in_x0 & in_y1);
+        auto v11 = fetch_texel<T, dim>(view, y1 + x1, in_x1 & in_y1);
+        return simd_to_float4(simd_lerp(simd_lerp(v00, v01, t.x),
+                                        simd_lerp(v10, v11, t.x), t.y));
+    }
+
+    template<typename T, lc_uint dim>
+    [[nodiscard]] inline lc_float4 sample_linear_3d(const TextureView &view, lc_uint3 c0, lc_uint3 c1, lc_float3 t) noexcept {
+        auto x0 = view._column_offset<3u>(c0.x);
+        auto x1 = view._column_offset<3u>(c1.x);
+        auto y0 = view._row_offset<3u>(c0.y);
+        auto y1 = view._row_offset<3u>(c1.y);
+        auto z0 = view._slice_offset(c0.z);
+        auto z1 = view._slice_offset(c1.z);
+        auto in_x0 = c0.x < view.width, in_x1 = c1.x < view.width;
+        auto in_y0 = c0.y < view.height, in_y1 = c1.y < view.height;
+        auto in_z0 = c0.z < view.depth, in_z1 = c1.z < view.depth;
+        auto v000 = fetch_texel<T, dim>(view, z0 + y0 + x0, in_x0 & in_y0 & in_z0);
+        auto v001 = fetch_texel<T, dim>(view, z0 + y0 + x1, in_x1 & in_y0 & in_z0);
+        auto v010 = fetch_texel<T, dim>(view, z0 + y1 + x0, in_x0 & in_y1 & in_z0);
+        auto v011 = fetch_texel<T, dim>(view, z0 + y1 + x1, in_x1 & in_y1 & in_z0);
+        auto v100 = fetch_texel<T, dim>(view, z1 + y0 + x0, in_x0 & in_y0 & in_z1);
+        auto v101 = fetch_texel<T, dim>(view, z1 + y0 + x1, in_x1 & in_y0 & in_z1);
+        auto v110 = fetch_texel<T, dim>(view, z1 + y1 + x0, in_x0 & in_y1 & in_z1);
+        auto v111 = fetch_texel<T, dim>(view, z1 + y1 + x1, in_x1 & in_y1 & in_z1);
+        return simd_to_float4(simd_lerp(
+            simd_lerp(simd_lerp(v000, v001, t.x),
+                      simd_lerp(v010, v011, t.x), t.y),
+            simd_lerp(simd_lerp(v100, v101, t.x),
+                      simd_lerp(v110, v111, t.x), t.y),
+            t.z));
+    }
+}// namespace detail
+
 #define LUISA_MAKE_TEXTURE_RW(dim, type)                               \
     [[nodiscard]] inline lc_##type##4 texture_read_##dim##d_##type(    \
         TextureView view, lc_##lc_uint##dim c) noexcept {                 \
@@ -457,12 +614,9 @@ texture_sample_linear(TextureView view, LCSamplerAddress address, lc_float2 uv)
     auto t = lc_fract(st_max);
     auto c0 = lc_make_uint2(st_min);
     auto c1 = lc_make_uint2(st_max);
-    auto v00 = view.read2d<lc_float4, float>(c0);
-    auto v01 = view.read2d<lc_float4, float>(lc_make_uint2(c1.x, c0.y));
-    auto v10 = view.read2d<lc_float4, float>(lc_make_uint2(c0.x, c1.y));
-    auto v11 = view.read2d<lc_float4, float>(c1);
-    return lc_lerp(lc_lerp(v00, v01, lc_float4(t.x)),
-                   lc_lerp(v10, v11, lc_float4(t.x)), lc_float4(t.y));
+    return detail::with_texel_format(LCPixelStorage(view.storage), [&]<typename T, lc_uint dim>() noexcept {
+        return detail::sample_linear_2d<T, dim>(view, c0, c1, t);
+    });
 }
 
 [[nodiscard]] inline lc_float4
@@ -472,20 +626,9 @@ texture_sample_linear(TextureView view, LCSamplerAddress address, lc_float3 uvw)
     auto t = lc_fract(st_max);
     auto c0 = lc_make_uint3(st_min);
     auto c1 = lc_make_uint3(st_max);
-    auto v000 = view.read3d<lc_float4, float>(lc_make_uint3(c0.x, c0.y, c0.z));
-    auto v001 = view.read3d<lc_float4, float>(lc_make_uint3(c1.x, c0.y, c0.z));
-    auto v010 = view.read3d<lc_float4, float>(lc_make_uint3(c0.x, c1.y, c0.z));
-    auto v011 = view.read3d<lc_float4, float>(lc_make_uint3(c1.x, c1.y, c0.z));
-    auto v100 = view.read3d<lc_float4, float>(lc_make_uint3(c0.x, c0.y, c1.z));
-    auto v101 = view.read3d<lc_float4, float>(lc_make_uint3(c1.x, c0.y, c1.z));
-    auto v110 = view.read3d<lc_float4, float>(lc_make_uint3(c0.x, c1.y, c1.z));
-    auto v111 = view.read3d<lc_float4, float>(lc_make_uint3(c1.x, c1.y, c1.z));
-    return lc_lerp(
-            lc_lerp(lc_lerp(v000, v001, lc_float4(t.x)),
-                    lc_lerp(v010, v011, lc_float4(t.x)), lc_float4(t.y)),
-            lc_lerp(lc_lerp(v100, v101, lc_float4(t.x)),
-                    lc_lerp(v110, v111, lc_float4(t.x)), lc_float4(t.y)),
-            lc_float4(t.z));
+    return detail::with_texel_format(LCPixelStorage(view.storage), [&]<typename T, lc_uint dim>() noexcept {
+        return detail::sample_linear_3d<T, dim>(view, c0, c1, t);
+    });
 }
 
 [[nodiscard]] inline lc_float4 texture_sample_point(TextureView view, LCSamplerAddress address, lc_float2 uv) noexcept {
@@ -531,26 +674,32 @@ texture_sample_point(TextureView view, LCSamplerAddress address, lc_float3 uvw)
     auto t_min = static_cast<int>(ceilf(st.y - 2.f * inv_det * sqrt_v));
     auto t_max = static_cast<int>(floorf(st.y + 2.f * inv_det * sqrt_v));
 
-    // Scan over ellipse bound and evaluate quadratic equation to filter image
-    auto sum = lc_make_float4();
-    auto sum_w = 0.f;
+    // Scan over ellipse bound and evaluate quadratic equation to filter image; the addressing
+    // is separable, so the row of the texels is only resolved once per scanline
     auto inv_size = 1.f / size;
-    for (auto t = t_min; t <= t_max; t++) {
-        for (auto s = s_min; s <= s_max; s++) {
-            auto ss = static_cast<float>(s) - st.x;
+    return detail::with_texel_format(LCPixelStorage(view.storage), [&]<typename T, lc_uint dim>() noexcept {
+        auto sum = detail::lc_simd_float4{};
+        auto sum_w = 0.f;
+        for (auto t = t_min; t <= t_max; t++) {
             auto tt = static_cast<float>(t) - st.y;
-            // Compute squared radius and filter texel if it is inside the ellipse
-            if (auto rr = A * sqr(ss) + B * ss * tt + C * sqr(tt); rr < 1.f) {
-                constexpr auto lut_size = static_cast<float>(detail::ewa_filter_weight_lut_size);
-                auto index = lc_clamp(rr * lut_size, 0.f, lut_size - 1.f);
-                auto weight = detail::ewa_filter_weight_lut[static_cast<int>(index)];
-                auto p = texture_coord_point(address, uv + lc_make_float2(ss, tt) * inv_size, size);
-                sum += weight * view.read2d<lc_float4, float>(lc_make_uint2(p));
-                sum_w += weight;
+            auto py = static_cast<lc_uint>(texture_coord_point(address, uv.y + tt * inv_size.y, size.y));
+            auto row = view._row_offset<2u>(py);
+            auto in_y = py < view.height;
+            for (auto s = s_min; s <= s_max; s++) {
+                auto ss = static_cast<float>(s) - st.x;
+                // Compute squared radius and filter texel if it is inside the ellipse
+                if (auto rr = A * sqr(ss) + B * ss * tt + C * sqr(tt); rr < 1.f) {
+                    constexpr auto lut_size = static_cast<float>(detail::ewa_filter_weight_lut_size);
+                    auto index = lc_clamp(rr * lut_size, 0.f, lut_size - 1.f);
+                    auto weight = detail::ewa_filter_weight_lut[static_cast<int>(index)];
+                    auto px = static_cast<lc_uint>(texture_coord_point(address, uv.x + ss * inv_size.x, size.x));
+                    sum += weight * detail::fetch_texel<T, dim>(view, row + view._column_offset<2u>(px), in_y & (px < view.width));
+                    sum_w += weight;
+                }
             }
         }
-    }
-    return lc_select(sum / sum_w, lc_make_float4(0.f), sum_w <= 0.f);
+        return sum_w <= 0.f ? lc_make_float4(0.f) : detail::simd_to_float4(sum / sum_w);
+    });
 }
 
 [[nodiscard]] inline auto texture_sample_ewa(TextureView view, LCSamplerAddress address,
@@ -562,7 +711,7 @@ texture_sample_point(TextureView view, LCSamplerAddress address, lc_float3 uvw)
 [[nodiscard]] inline TextureView lc_texture_view(const Texture *tex, lc_uint level) noexcept {
     auto size = lc_max(lc_make_uint3(tex->width, tex->height, tex->depth) >> level, lc_make_uint3(1u));
     return TextureView{tex->data + (static_cast<size_t>(tex->mip_offsets[level]) << tex->pixel_stride_shift),
-                       tex->dimension, size.x, size.y, size.z, tex->storage, tex->pixel_stride_shift};
+                       tex->dimension, size.x, size.y, size.z, tex->storage, tex->pixel_stride_shift, tex->tiled};
 }
 
 struct LCSampler {
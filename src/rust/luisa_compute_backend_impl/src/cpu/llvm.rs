@@ -358,20 +358,22 @@ impl LLVMPaths {
             let file = File::open(&cur).unwrap();
             let reader = BufReader::new(file);
             let mut paths: LLVMPaths = serde_json::from_reader(reader).unwrap();
+            if paths.clang.is_empty() {
+                paths.clang = find_clang().unwrap_or_default();
+            }
             paths.override_from_env();
             paths
         } else {
             let mut paths = LLVMPaths {
+                // clang is only required to compile kernels, not to load shader artifacts
                 clang: find_clang().map(|s| {
                     log::info!("Found clang: {}", s);
                     s
                 }).unwrap_or_else(|| {
-                    match var("LUISA_CLANG_PATH") {
-                        Ok(s) => s,
-                        Err(_) => {
-                            panic_abort!("Could not find clang. Please set LUISA_CLANG_PATH to the path of clang++ executable")
-                        }
-                    }
+                    var("LUISA_CLANG_PATH").unwrap_or_else(|_| {
+                        log::warn!("Could not find clang. Only precompiled shaders can be loaded");
+                        String::new()
+                    })
                 }),
                 llvm: find_llvm().map(|s| {
                     log::info!("Found LLVM: {}", s);
@@ -0,0 +1,328 @@
+// Allocation of buffers and textures: huge pages and NUMA placement for large resources.
+use std::alloc::Layout;
+
+use log::warn;
+use serde::Deserialize;
+
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Deserialize)]
+#[serde(rename_all = "snake_case")]
+pub(super) enum HugePages {
+    None,
+    // madvise(MADV_HUGEPAGE), promoted by khugepaged or on fault
+    Transparent,
+    // MAP_HUGETLB from the reserved pool, falls back to transparent ones if it is exhausted
+    Explicit,
+}
+
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Deserialize)]
+#[serde(rename_all = "snake_case")]
+pub(super) enum Placement {
+    // pages land on the node of the thread that touches them first, usually the uploading one
+    Default,
+    // pages are interleaved across all the nodes
+    Interleaved,
+    // pages are left untouched until a dispatch or a parallel upload, which split the work
+    // statically across the workers, so each page lands on the node of the worker using it
+    FirstTouch,
+}
+
+#[derive(Clone, Copy, Debug, Deserialize)]
+#[serde(default)]
+pub(super) struct MemoryPolicy {
+    pub(super) huge_pages: HugePages,
+    pub(super) placement: Placement,
+    // pins each worker of the shared pool to the CPUs of a node
+    pub(super) pin_workers: bool,
+    // smaller resources always come from the heap
+    pub(super) large_threshold: usize,
+}
+
+impl Default for MemoryPolicy {
+    fn default() -> Self {
+        Self {
+            huge_pages: HugePages::None,
+            placement: Placement::Default,
+            pin_workers: false,
+            large_threshold: HUGE_PAGE_SIZE,
+        }
+    }
+}
+
+impl MemoryPolicy {
+    // reads the "memory" object of the device config, keeping the defaults on errors
+    pub(super) fn from_config(config: &serde_json::Value) -> Self {
+        match config.get("memory") {
+            Some(memory) => serde_json::from_value(memory.clone()).unwrap_or_else(|e| {
+                warn!("invalid memory policy {}: {}", memory, e);
+                Self::default()
+            }),
+            None => Self::default(),
+        }
+    }
+    fn maps_large(&self) -> bool {
+        self.huge_pages != HugePages::None || self.placement != Placement::Default
+    }
+    pub(super) fn is_large(&self, size: usize) -> bool {
+        self.maps_large() && size >= self.large_threshold
+    }
+    // whether dispatches and large uploads should split their work statically across workers
+    pub(super) fn node_local(&self) -> bool {
+        self.placement == Placement::FirstTouch
+    }
+}
+
+const HUGE_PAGE_SIZE: usize = 2 << 20;
+
+pub(super) struct Node {
+    pub(super) id: usize,
+    pub(super) cpus: Vec<usize>,
+}
+
+// the NUMA nodes, or a single node of all CPUs if the topology is unknown
+pub(super) struct Topology {
+    pub(super) nodes: Vec<Node>,
+}
+
+impl Topology {
+    pub(super) fn detect() -> Self {
+        let mut nodes = Vec::new();
+        if let Ok(entries) = std::fs::read_dir("/sys/devices/system/node") {
+            for entry in entries.flatten() {
+                let name = entry.file_name();
+                let id = match name
+                    .to_str()
+                    .and_then(|n| n.strip_prefix("node"))
+                    .and_then(|n| n.parse::<usize>().ok())
+                {
+                    Some(id) => id,
+                    None => continue,
+                };
+                let cpus = std::fs::read_to_string(entry.path().join("cpulist"))
+                    .map(|list| parse_cpu_list(&list))
+                    .unwrap_or_default();
+                // memory-only nodes have no workers to place pages for
+                if !cpus.is_empty() {
+                    nodes.push(Node { id, cpus });
+                }
+            }
+        }
+        nodes.sort_by_key(|node| node.id);
+        if nodes.is_empty() {
+            let count = std::thread::available_parallelism().map_or(1, |n| n.get());
+            nodes.push(Node {
+                id: 0,
+                cpus: (0..count).collect(),
+            });
+        }
+        Self { nodes }
+    }
+    // the node of a worker, so that consecutive workers share a node
+    pub(super) fn node_of_worker(&self, worker: usize, workers: usize) -> usize {
+        worker * self.nodes.len() / workers.max(1)
+    }
+    pub(super) fn pin_worker(&self, worker: usize, workers: usize) {
+        if self.nodes.len() < 2 {
+            return;
+        }
+        let cpus = &self.nodes[self.node_of_worker(worker, workers)].cpus;
+        #[cfg(target_os = "linux")]
+        unsafe {
+            let mut set: libc::cpu_set_t = std::mem::zeroed();
+            for &cpu in cpus {
+                libc::CPU_SET(cpu, &mut set);
+            }
+            if libc::sched_setaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), &set) != 0 {
+                warn!(
+                    "failed to pin worker {}: {}",
+                    worker,
+                    std::io::Error::last_os_error()
+                );
+            }
+        }
+        #[cfg(not(target_os = "linux"))]
+        let _ = cpus;
+    }
+}
+
+// e.g. "0-15,32-47"
+fn parse_cpu_list(list: &str) -> Vec<usize> {
+    let mut cpus = Vec::new();
+    for range in list.trim().split(',').filter(|r| !r.is_empty()) {
+        let mut bounds = range.splitn(2, '-').map(|b| b.trim().parse::<usize>());
+        match (bounds.next(), bounds.next()) {
+            (Some(Ok(first)), None) => cpus.push(first),
+            (Some(Ok(first)), Some(Ok(last))) => cpus.extend(first..=last),
+            _ => {}
+        }
+    }
+    cpus
+}
+
+enum Kind {
+    Heap(Layout),
+    Mapped(usize),
+}
+
+// memory owned by a buffer or a texture, released on drop
+pub(super) struct Allocation {
+    data: *mut u8,
+    kind: Kind,
+}
+
+unsafe impl Send for Allocation {}
+
+unsafe impl Sync for Allocation {}
+
+impl Allocation {
+    pub(super) fn data(&self) -> *mut u8 {
+        self.data
+    }
+}
+
+impl Drop for Allocation {
+    fn drop(&mut self) {
+        unsafe {
+            match self.kind {
+                Kind::Heap(layout) => std::alloc::dealloc(self.data, layout),
+                #[cfg(unix)]
+                Kind::Mapped(length) => {
+                    libc::munmap(self.data as *mut libc::c_void, length);
+                }
+                #[cfg(not(unix))]
+                Kind::Mapped(_) => unreachable!(),
+            }
+        }
+    }
+}
+
+pub(super) struct MemoryAllocator {
+    policy: MemoryPolicy,
+    topology: Topology,
+}
+
+impl MemoryAllocator {
+    pub(super) fn new(policy: MemoryPolicy, topology: Topology) -> Self {
+        Self { policy, topology }
+    }
+    pub(super) fn policy(&self) -> &MemoryPolicy {
+        &self.policy
+    }
+    pub(super) fn topology(&self) -> &Topology {
+        &self.topology
+    }
+    // the memory is zeroed if `zeroed` is set, mapped memory is always zeroed
+    pub(super) fn allocate(&self, size: usize, align: usize, zeroed: bool) -> Allocation {
+        #[cfg(target_os = "linux")]
+        if self.policy.is_large(size) && align <= HUGE_PAGE_SIZE {
+            if let Some(allocation) = unsafe { self.map(size) } {
+                return allocation;
+            }
+        }
+        let layout = Layout::from_size_align(size.max(1), align).unwrap();
+        let data = unsafe {
+            if zeroed {
+                std::alloc::alloc_zeroed(layout)
+            } else {
+                std::alloc::alloc(layout)
+            }
+        };
+        if data.is_null() {
+            std::alloc::handle_alloc_error(layout);
+        }
+        Allocation {
+            data,
+            kind: Kind::Heap(layout),
+        }
+    }
+    #[cfg(target_os = "linux")]
+    unsafe fn map(&self, size: usize) -> Option<Allocation> {
+        let length = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        let protection = libc::PROT_READ | libc::PROT_WRITE;
+        // no MAP_NORESERVE, so that a short huge page pool fails here rather than on the first touch
+        let flags = libc::MAP_PRIVATE | libc::MAP_ANONYMOUS;
+        let mut huge_pages = self.policy.huge_pages;
+        let mut data = libc::MAP_FAILED;
+        if huge_pages == HugePages::Explicit {
+            data = libc::mmap(
+                std::ptr::null_mut(),
+                length,
+                protection,
+                flags | libc::MAP_HUGETLB,
+                -1,
+                0,
+            );
+            if data == libc::MAP_FAILED {
+                warn!(
+                    "failed to map {} bytes of explicit huge pages ({}), using transparent ones",
+                    length,
+                    std::io::Error::last_os_error()
+                );
+                huge_pages = HugePages::Transparent;
+            }
+        }
+        if data == libc::MAP_FAILED {
+            // over-allocates by a huge page to align the mapping, so that it can be backed by them
+            let mapped = length + HUGE_PAGE_SIZE;
+            let base = libc::mmap(std::ptr::null_mut(), mapped, protection, flags, -1, 0);
+            if base == libc::MAP_FAILED {
+                return None;
+            }
+            let head = (HUGE_PAGE_SIZE - base as usize % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+            if head > 0 {
+                libc::munmap(base, head);
+            }
+            libc::munmap(
+                (base as *mut u8).add(head + length) as *mut libc::c_void,
+                HUGE_PAGE_SIZE - head,
+            );
+            data = (base as *mut u8).add(head) as *mut libc::c_void;
+            if huge_pages == HugePages::Transparent
+                && libc::madvise(data, length, libc::MADV_HUGEPAGE) != 0
+            {
+                warn!(
+                    "transparent huge pages are unavailable: {}",
+                    std::io::Error::last_os_error()
+                );
+            }
+        }
+        if self.policy.placement == Placement::Interleaved {
+            self.interleave(data, length);
+        }
+        Some(Allocation {
+            data: data as *mut u8,
+            kind: Kind::Mapped(length),
+        })
+    }
+    // set before any page is touched, as mbind does not move pages that are already there
+    #[cfg(target_os = "linux")]
+    unsafe fn interleave(&self, data: *mut libc::c_void, length: usize) {
+        let nodes = &self.topology.nodes;
+        if nodes.len() < 2 {
+            return;
+        }
+        const MPOL_INTERLEAVE: libc::c_long = 3;
+        let max_id = nodes.iter().map(|node| node.id).max().unwrap();
+        let mut mask = vec![0u64; max_id / 64 + 1];
+        for node in nodes {
+            mask[node.id / 64] |= 1 << (node.id % 64);
+        }
+        // the kernel reads one bit less than `maxnode`
+        let max_node = mask.len() * 64 + 1;
+        if libc::syscall(
+            libc::SYS_mbind,
+            data,
+            length,
+            MPOL_INTERLEAVE,
+            mask.as_ptr(),
+            max_node,
+            0 as libc::c_uint,
+        ) != 0
+        {
+            warn!(
+                "failed to interleave {} bytes: {}",
+                length,
+                std::io::Error::last_os_error()
+            );
+        }
+    }
+}
@@ -4,8 +4,9 @@ use std::sync::Arc;
 
 use self::{
     accel::{AccelImpl, GeometryImpl},
+    memory::{MemoryAllocator, MemoryPolicy, Topology},
     resource::{BindlessArrayImpl, BufferImpl, EventImpl},
-    stream::{convert_capture, StreamImpl},
+    stream::{block_in_place, convert_arg, convert_capture, Scheduler, StreamImpl},
     texture::TextureImpl,
 };
 use super::Backend;
@@ -22,12 +23,16 @@ mod codegen;
 use codegen::sha256_short;
 mod accel;
 mod llvm;
+mod memory;
 mod resource;
 mod shader;
 mod stream;
 mod texture;
 pub struct RustBackend {
     shared_pool: Arc<rayon::ThreadPool>,
+    // executors of the streams, which only orchestrate as kernels run on the shared pool
+    stream_scheduler: Arc<Scheduler>,
+    memory: Arc<MemoryAllocator>,
     swapchain_context: RwLock<Option<Arc<SwapChainForCpuContext>>>,
 }
 impl RustBackend {
@@ -61,7 +66,7 @@ impl Backend for RustBackend {
         } else {
             ty.alignment()
         };
-        let buffer = Box::new(BufferImpl::new(size_bytes, alignment, type_hash(&ty)));
+        let buffer = Box::new(BufferImpl::new(&self.memory, size_bytes, alignment, type_hash(&ty)));
         let data = buffer.data;
         let ptr = Box::into_raw(buffer);
         CreatedBufferInfo {
@@ -73,6 +78,38 @@ impl Backend for RustBackend {
             total_size_bytes: size_bytes,
         }
     }
+    fn create_buffer_from_memory(
+        &self,
+        ty: &CArc<ir::Type>,
+        count: usize,
+        data: *mut std::ffi::c_void,
+    ) -> luisa_compute_api_types::CreatedBufferInfo {
+        let size_bytes = if ty == &ir::Type::void() {
+            count
+        } else {
+            ty.size() * count
+        };
+        let alignment = if ty == &ir::Type::void() {
+            16
+        } else {
+            ty.alignment()
+        };
+        let buffer = Box::new(BufferImpl::from_memory(
+            data as *mut u8,
+            size_bytes,
+            alignment,
+            type_hash(&ty),
+        ));
+        let ptr = Box::into_raw(buffer);
+        CreatedBufferInfo {
+            resource: CreatedResourceInfo {
+                handle: ptr as u64,
+                native_handle: data,
+            },
+            element_stride: ty.size(),
+            total_size_bytes: size_bytes,
+        }
+    }
     fn destroy_buffer(&self, buffer: luisa_compute_api_types::Buffer) {
         unsafe {
             let ptr = buffer.0 as *mut BufferImpl;
@@ -93,6 +130,7 @@ impl Backend for RustBackend {
         let storage = format.storage();
 
         let texture = TextureImpl::new(
+            &self.memory,
             dimension as u8,
             [width, height, depth],
             storage,
@@ -107,6 +145,30 @@ impl Backend for RustBackend {
         }
     }
 
+    fn create_texture_from_memory(
+        &self,
+        format: luisa_compute_api_types::PixelFormat,
+        dimension: u32,
+        width: u32,
+        height: u32,
+        depth: u32,
+        mipmap_levels: u32,
+        data: *mut std::ffi::c_void,
+    ) -> luisa_compute_api_types::CreatedResourceInfo {
+        let texture = TextureImpl::from_memory(
+            dimension as u8,
+            [width, height, depth],
+            format.storage(),
+            mipmap_levels as u8,
+            data as *mut u8,
+        );
+        let ptr = Box::into_raw(Box::new(texture));
+        CreatedResourceInfo {
+            handle: ptr as u64,
+            native_handle: data,
+        }
+    }
+
     fn destroy_texture(&self, texture: luisa_compute_api_types::Texture) {
         unsafe {
             let texture = texture.0 as *mut TextureImpl;
@@ -134,7 +196,11 @@ impl Backend for RustBackend {
     }
 
     fn create_stream(&self, _tag: api::StreamTag) -> luisa_compute_api_types::CreatedResourceInfo {
-        let stream = Box::into_raw(Box::new(StreamImpl::new(self.shared_pool.clone())));
+        let stream = Box::into_raw(Box::new(StreamImpl::new(
+            self.shared_pool.clone(),
+            self.stream_scheduler.clone(),
+            self.memory.policy().node_local(),
+        )));
         CreatedResourceInfo {
             handle: stream as u64,
             native_handle: stream as *mut std::ffi::c_void,
@@ -165,8 +231,23 @@ impl Backend for RustBackend {
             let stream = &*(stream_.0 as *mut StreamImpl);
             let command_list = command_list.to_vec();
             let sb = stream.allocate_staging_buffers(&command_list);
-            stream.enqueue(move || stream.dispatch(sb, &command_list), callback);
+            stream.enqueue(
+                move |profiler| stream.dispatch(sb, &command_list, profiler),
+                callback,
+            );
+        }
+    }
+
+    fn set_stream_profiling(
+        &self,
+        stream: api::Stream,
+        profiler: Option<(api::ProfilingCallback, *mut u8)>,
+    ) -> bool {
+        unsafe {
+            let stream = &*(stream.0 as *mut StreamImpl);
+            stream.set_profiler(profiler);
         }
+        true
     }
 
     fn create_swapchain(
@@ -230,7 +311,7 @@ impl Backend for RustBackend {
 
             let present = ctx.cpu_swapchain_present;
             stream.enqueue(
-                move || {
+                move |_| {
                     let pixels = img.view(0).copy_to_vec_par_2d();
 
                     present(
@@ -324,6 +405,34 @@ impl Backend for RustBackend {
         }
     }
 
+    fn shader_artifact(&self, shader: luisa_compute_api_types::Shader) -> Option<Vec<u8>> {
+        unsafe {
+            let shader = &*(shader.0 as *mut shader::ShaderImpl);
+            shader.serialize()
+        }
+    }
+
+    fn create_shader_from_artifact(
+        &self,
+        artifact: &[u8],
+        captures: &[api::Argument],
+    ) -> Option<luisa_compute_api_types::CreatedShaderInfo> {
+        let captures = captures
+            .iter()
+            .map(|c| unsafe { convert_arg(*c) })
+            .collect::<Vec<_>>();
+        let shader = shader::ShaderImpl::deserialize(artifact, captures)?;
+        let block_size = shader.block_size;
+        let shader = Box::into_raw(Box::new(shader));
+        Some(luisa_compute_api_types::CreatedShaderInfo {
+            resource: CreatedResourceInfo {
+                handle: shader as u64,
+                native_handle: shader as *mut std::ffi::c_void,
+            },
+            block_size,
+        })
+    }
+
     fn destroy_shader(&self, shader: luisa_compute_api_types::Shader) {
         unsafe {
             let shader = shader.0 as *mut shader::ShaderImpl;
@@ -352,7 +461,7 @@ impl Backend for RustBackend {
             let event = &*(event.0 as *mut EventImpl);
             let stream = &*(stream.0 as *mut StreamImpl);
             stream.enqueue(
-                move || {
+                move |_| {
                     event.signal(value);
                 },
                 (empty_callback, std::ptr::null_mut()),
@@ -363,18 +472,13 @@ impl Backend for RustBackend {
         unsafe {
             let event = &*(event.0 as *mut EventImpl);
             let stream = &*(stream.0 as *mut StreamImpl);
-            stream.enqueue(
-                move || {
-                    event.wait(value);
-                },
-                (empty_callback, std::ptr::null_mut()),
-            );
+            stream.wait(event, value);
         }
     }
     fn synchronize_event(&self, event: luisa_compute_api_types::Event, value: u64) {
         unsafe {
             let event = &*(event.0 as *mut EventImpl);
-            event.synchronize(value);
+            block_in_place(|| event.synchronize(value));
         }
     }
     fn is_event_completed(&self, event: luisa_compute_api_types::Event, value: u64) -> bool {
@@ -447,17 +551,29 @@ impl Backend for RustBackend {
     }
 }
 impl RustBackend {
-    pub fn new() -> Self {
+    pub fn new(config: &serde_json::Value) -> Self {
         let num_threads = match std::env::var("LUISA_NUM_THREADS") {
             Ok(s) => s.parse::<usize>().unwrap(),
             Err(_) => std::thread::available_parallelism().unwrap().get(),
         };
+        let num_executors = match std::env::var("LUISA_NUM_STREAM_EXECUTORS") {
+            Ok(s) => s.parse::<usize>().unwrap(),
+            Err(_) => num_threads.clamp(2, 4),
+        };
+        let memory = Arc::new(MemoryAllocator::new(
+            MemoryPolicy::from_config(config),
+            Topology::detect(),
+        ));
+        let worker_memory = memory.clone();
 
         RustBackend {
             shared_pool: Arc::new(
                 rayon::ThreadPoolBuilder::new()
                     .num_threads(num_threads)
-                    .start_handler(|_| {
+                    .start_handler(move |index| {
+                        if worker_memory.policy().pin_workers {
+                            worker_memory.topology().pin_worker(index, num_threads);
+                        }
                         #[cfg(target_arch = "x86_64")]
                         {
                             unsafe {
@@ -475,8 +591,15 @@ impl RustBackend {
                     .build()
                     .unwrap(),
             ),
+            stream_scheduler: Scheduler::new(num_executors),
+            memory,
             swapchain_context: RwLock::new(None),
         }
     }
 }
+impl Drop for RustBackend {
+    fn drop(&mut self) {
+        self.stream_scheduler.shutdown();
+    }
+}
 extern "C" fn empty_callback(_: *mut u8) {}
@@ -1,31 +1,45 @@
-use std::{
-    alloc::Layout,
-    sync::atomic::{AtomicU64},
-};
+use std::sync::atomic::AtomicU64;
 
 use luisa_compute_api_types::{BindlessArrayUpdateModification, BindlessArrayUpdateOperation};
 use luisa_compute_cpu_kernel_defs as defs;
 use parking_lot::{Condvar, Mutex};
 
+use super::memory::{Allocation, MemoryAllocator};
 use super::texture::TextureImpl;
 
+// resumes a stream parked on an event
+type Resume = Box<dyn FnOnce() + Send>;
 pub struct EventImpl {
-    pub mutex: Mutex<u64>,
+    // streams parked until the event reaches their tickets
+    pub mutex: Mutex<Vec<(u64, Resume)>>,
     pub device: AtomicU64,
     pub on_signal: Condvar,
 }
 impl EventImpl {
     pub fn new() -> Self {
         Self {
-            mutex: Mutex::new(0),
+            mutex: Mutex::new(Vec::new()),
             device: AtomicU64::new(0),
             on_signal: Condvar::new(),
         }
     }
     pub fn signal(&self, ticket: u64) {
-        let _lk = self.mutex.lock();
-        self.device.fetch_max(ticket, std::sync::atomic::Ordering::SeqCst);
-        self.on_signal.notify_all();
+        let resumed = {
+            let mut waiters = self.mutex.lock();
+            let value = self
+                .device
+                .fetch_max(ticket, std::sync::atomic::Ordering::SeqCst)
+                .max(ticket);
+            self.on_signal.notify_all();
+            let (resumed, parked): (Vec<_>, Vec<_>) = std::mem::take(&mut *waiters)
+                .into_iter()
+                .partition(|(t, _)| *t <= value);
+            *waiters = parked;
+            resumed
+        };
+        for (_, resume) in resumed {
+            resume();
+        }
     }
     pub fn wait(&self, ticket: u64) {
         let mut lk = self.mutex.lock();
@@ -36,6 +50,16 @@ impl EventImpl {
             self.on_signal.wait(&mut lk);
         }
     }
+    // Returns false if the event has reached the ticket already; otherwise `resume` is
+    // called by the signal that makes it reach the ticket.
+    pub fn wait_async(&self, ticket: u64, resume: impl FnOnce() + Send + 'static) -> bool {
+        let mut waiters = self.mutex.lock();
+        if self.device.load(std::sync::atomic::Ordering::SeqCst) >= ticket {
+            return false;
+        }
+        waiters.push((ticket, Box::new(resume)));
+        true
+    }
     pub fn synchronize(&self, ticket: u64) {
         self.wait(ticket);
     }
@@ -49,6 +73,8 @@ pub struct BufferImpl {
     pub size: usize,
     pub align: usize,
     pub ty: u64,
+    // None if the memory is owned by the caller, e.g. a sparse buffer
+    allocation: Option<Allocation>,
 }
 #[repr(C)]
 pub struct BindlessArrayImpl {
@@ -92,6 +118,7 @@ impl BindlessArrayImpl {
                         pixel_stride_shift: tex.pixel_stride_shift.try_into().unwrap(),
                         mip_offsets: tex.mip_offsets,
                         sampler: m.tex2d.sampler.encode(),
+                        tiled: tex.tiled as u8,
                     };
                 }
                 BindlessArrayUpdateOperation::Remove => {
@@ -113,6 +140,7 @@ impl BindlessArrayImpl {
                         pixel_stride_shift: tex.pixel_stride_shift.try_into().unwrap(),
                         mip_offsets: tex.mip_offsets,
                         sampler: m.tex2d.sampler.encode(),
+                        tiled: tex.tiled as u8,
                     };
                 }
                 BindlessArrayUpdateOperation::Remove => {
@@ -123,21 +151,24 @@ impl BindlessArrayImpl {
     }
 }
 impl BufferImpl {
-    pub(super) fn new(size: usize, align: usize, ty: u64) -> Self {
-        let layout = Layout::from_size_align(size, align).unwrap();
-        let data = unsafe { std::alloc::alloc_zeroed(layout) };
+    pub(super) fn new(memory: &MemoryAllocator, size: usize, align: usize, ty: u64) -> Self {
+        let allocation = memory.allocate(size, align, true);
         Self {
-            data,
+            data: allocation.data(),
             size,
             align,
             ty,
+            allocation: Some(allocation),
         }
     }
-}
-
-impl Drop for BufferImpl {
-    fn drop(&mut self) {
-        let layout = Layout::from_size_align(self.size, self.align).unwrap();
-        unsafe { std::alloc::dealloc(self.data, layout) };
+    pub(super) fn from_memory(data: *mut u8, size: usize, align: usize, ty: u64) -> Self {
+        assert_eq!(data as usize % align, 0);
+        Self {
+            data,
+            size,
+            align,
+            ty,
+            allocation: None,
+        }
     }
 }
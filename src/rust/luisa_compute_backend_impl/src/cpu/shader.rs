@@ -2,6 +2,7 @@ use crate::cpu::llvm::LLVM_PATH;
 use crate::panic_abort;
 use luisa_compute_cpu_kernel_defs as defs;
 use luisa_compute_cpu_kernel_defs::KernelFnArgs;
+use serde::{Deserialize, Serialize};
 use std::{
     env::{self, current_exe},
     fs::{canonicalize},
@@ -65,11 +66,7 @@ pub(super) fn clang_args() -> Vec<&'static str> {
     args.push("-fno-stack-protector");
     args
 }
-pub(super) fn compile(
-    target: &String,
-    source: &String,
-    force_recompile: bool,
-) -> std::io::Result<PathBuf> {
+fn build_dir() -> std::io::Result<PathBuf> {
     let self_path = current_exe().map_err(|e| {
         eprintln!("current_exe() failed");
         e
@@ -87,6 +84,14 @@ pub(super) fn compile(
             e
         })?;
     }
+    Ok(build_dir)
+}
+pub(super) fn compile(
+    target: &String,
+    source: &String,
+    force_recompile: bool,
+) -> std::io::Result<PathBuf> {
+    let build_dir = build_dir()?;
 
     let target_lib = format!("{}.bc", target);
 
@@ -120,6 +125,9 @@ pub(super) fn compile(
         args.push("-o");
         args.push(&target_lib);
         let clang = &LLVM_PATH.clang;
+        if clang.is_empty() {
+            panic_abort!("Could not find clang. Please set LUISA_CLANG_PATH to the path of clang++ executable");
+        }
         let tic = std::time::Instant::now();
         let mut child = Command::new(clang)
             .args(args)
@@ -162,6 +170,29 @@ pub(super) fn compile(
     }
 }
 
+// writes LLVM IR restored from a shader artifact to where `compile` would have put it
+fn restore_bitcode(target: &String, bitcode: &[u8]) -> std::io::Result<PathBuf> {
+    let lib_path = build_dir()?.join(format!("{}.bc", target));
+    if !lib_path.exists() {
+        std::fs::write(&lib_path, bitcode).map_err(|e| {
+            eprintln!("fs::write({}) failed", lib_path.display());
+            e
+        })?;
+    }
+    Ok(lib_path)
+}
+
+const SHADER_ARTIFACT_MAGIC: &[u8; 8] = b"LCCPUSA1";
+
+#[derive(Serialize, Deserialize)]
+struct ShaderArtifactHeader {
+    name: String,
+    block_size: [u32; 3],
+    messages: Vec<String>,
+    clang_args: String,
+    llvm: String,
+}
+
 pub(crate) type KernelFn = unsafe extern "C" fn(*const KernelFnArgs);
 
 pub(crate) struct ShaderImpl {
@@ -169,6 +200,7 @@ pub(crate) struct ShaderImpl {
     // lib: libloading::Library,
     // entry: libloading::Symbol<'static, KernelFn>,
     entry: KernelFn,
+    pub(crate) name: String,
     pub(crate) dir: PathBuf,
     pub(crate) captures: Vec<defs::KernelFnArg>,
     pub(crate) custom_ops: Vec<defs::CpuCustomOp>,
@@ -196,6 +228,7 @@ impl ShaderImpl {
         Some(Self {
             // lib,
             entry,
+            name,
             captures,
             dir: path.clone(),
             custom_ops,
@@ -207,4 +240,56 @@ impl ShaderImpl {
     pub(crate) fn fn_ptr(&self) -> KernelFn {
         self.entry
     }
+    // layout: magic | header size (u64, little endian) | json header | LLVM IR
+    pub(crate) fn serialize(&self) -> Option<Vec<u8>> {
+        // custom ops are host function pointers and cannot outlive the process
+        if !self.custom_ops.is_empty() {
+            return None;
+        }
+        let bitcode = std::fs::read(&self.dir).ok()?;
+        let header = ShaderArtifactHeader {
+            name: self.name.clone(),
+            block_size: self.block_size,
+            messages: self.messages.clone(),
+            clang_args: clang_args().join(","),
+            llvm: LLVM_PATH.llvm.clone(),
+        };
+        let header = serde_json::to_vec(&header).ok()?;
+        let mut artifact =
+            Vec::with_capacity(SHADER_ARTIFACT_MAGIC.len() + 8 + header.len() + bitcode.len());
+        artifact.extend_from_slice(SHADER_ARTIFACT_MAGIC);
+        artifact.extend_from_slice(&(header.len() as u64).to_le_bytes());
+        artifact.extend_from_slice(&header);
+        artifact.extend_from_slice(&bitcode);
+        Some(artifact)
+    }
+    pub(crate) fn deserialize(artifact: &[u8], captures: Vec<defs::KernelFnArg>) -> Option<Self> {
+        let artifact = artifact.strip_prefix(SHADER_ARTIFACT_MAGIC.as_slice())?;
+        if artifact.len() < 8 {
+            return None;
+        }
+        let (header_size, artifact) = artifact.split_at(8);
+        let header_size = u64::from_le_bytes(header_size.try_into().unwrap()) as usize;
+        if artifact.len() < header_size {
+            return None;
+        }
+        let (header, bitcode) = artifact.split_at(header_size);
+        let header: ShaderArtifactHeader = serde_json::from_slice(header).ok()?;
+        if header.clang_args != clang_args().join(",") || header.llvm != LLVM_PATH.llvm {
+            log::debug!(
+                "Shader artifact {} was built with a different toolchain",
+                header.name
+            );
+            return None;
+        }
+        let path = restore_bitcode(&header.name, bitcode).ok()?;
+        Self::new(
+            header.name,
+            path,
+            captures,
+            vec![],
+            header.block_size,
+            &header.messages,
+        )
+    }
 }
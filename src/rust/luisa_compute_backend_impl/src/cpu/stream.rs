@@ -6,9 +6,10 @@ use luisa_compute_ir::{
 use parking_lot::{Condvar, Mutex};
 use rayon;
 use std::{
+    cell::RefCell,
     collections::VecDeque,
     sync::{atomic::AtomicUsize, Arc},
-    thread::{self, JoinHandle},
+    thread,
 };
 
 use std::{
@@ -18,7 +19,7 @@ use std::{
 
 use super::{
     accel::{AccelImpl, GeometryImpl},
-    resource::{BindlessArrayImpl, BufferImpl},
+    resource::{BindlessArrayImpl, BufferImpl, EventImpl},
     shader::ShaderImpl,
     texture::TextureImpl,
 };
@@ -26,9 +27,28 @@ use super::{
 use bumpalo::Bump;
 use luisa_compute_cpu_kernel_defs as defs;
 
+#[derive(Clone, Copy)]
+pub(super) struct Profiler {
+    callback: api::ProfilingCallback,
+    user_data: *mut u8,
+}
+
+unsafe impl Send for Profiler {}
+
+unsafe impl Sync for Profiler {}
+
+impl Profiler {
+    #[inline]
+    pub(super) fn mark(&self, mark: api::ProfilingMark, index: usize) {
+        (self.callback)(self.user_data, mark, index);
+    }
+}
+
 struct Work {
-    f: Box<dyn FnOnce() + Send + Sync>,
+    f: Box<dyn FnOnce(Option<Profiler>) + Send + Sync>,
     callback: (extern "C" fn(*mut u8), *mut u8),
+    // captured at submission so that marks match what the profiler saw submitted
+    profiler: Option<Profiler>,
 }
 
 unsafe impl Send for Work {}
@@ -97,98 +117,303 @@ impl StagingBufferPool {
         buffers
     }
 }
+// A task of a stream: host work, or a wait for an event to reach a ticket
+enum Task {
+    Work(Work),
+    Wait {
+        event: *const EventImpl,
+        ticket: u64,
+        // the wait is a work item of the profiler, which spans from parking to resuming
+        profiler: Option<Profiler>,
+    },
+}
+
+unsafe impl Send for Task {}
+
+unsafe impl Sync for Task {}
+
+struct StreamState {
+    queue: VecDeque<Task>,
+    // tasks that are enqueued but not finished, including a wait the stream is parked on
+    pending: usize,
+    // set while the stream is ready, running on an executor, or parked on an event,
+    // so that enqueuing only schedules an idle stream
+    scheduled: bool,
+}
+
 struct StreamContext {
-    queue: Mutex<VecDeque<Work>>,
-    new_work: Condvar,
+    state: Mutex<StreamState>,
     sync: Condvar,
-    work_count: AtomicUsize,
-    finished_count: AtomicUsize,
     staging_buffer_pool: StagingBufferPool,
+    profiler: Mutex<Option<Profiler>>,
+    scheduler: Arc<Scheduler>,
+}
+
+unsafe impl Send for StreamContext {}
+
+unsafe impl Sync for StreamContext {}
+
+impl StreamContext {
+    fn push(self: &Arc<Self>, task: Task) {
+        let mut state = self.state.lock();
+        state.queue.push_back(task);
+        state.pending += 1;
+        if !state.scheduled {
+            state.scheduled = true;
+            drop(state);
+            self.scheduler.schedule(self.clone());
+        }
+    }
+    fn finish_task(&self) {
+        let mut state = self.state.lock();
+        state.pending -= 1;
+        if state.pending == 0 {
+            self.sync.notify_all();
+        }
+    }
+    // Runs the stream on the calling executor until it goes idle, parks on an event, or has
+    // finished a work, after which it goes back to the ready queue behind the other streams.
+    fn run(self: Arc<Self>) {
+        loop {
+            let task = {
+                let mut state = self.state.lock();
+                match state.queue.pop_front() {
+                    Some(task) => task,
+                    None => {
+                        state.scheduled = false;
+                        return;
+                    }
+                }
+            };
+            match task {
+                Task::Wait {
+                    event,
+                    ticket,
+                    profiler,
+                } => {
+                    let event = unsafe { &*event };
+                    if let Some(profiler) = profiler {
+                        profiler.mark(api::ProfilingMark::WorkBegin, 0);
+                    }
+                    let stream = self.clone();
+                    let parked = event.wait_async(ticket, move || {
+                        if let Some(profiler) = profiler {
+                            profiler.mark(api::ProfilingMark::WorkEnd, 0);
+                        }
+                        stream.finish_task();
+                        let scheduler = stream.scheduler.clone();
+                        scheduler.schedule(stream);
+                    });
+                    if parked {
+                        // the signal schedules the stream again, possibly on another executor
+                        return;
+                    }
+                    if let Some(profiler) = profiler {
+                        profiler.mark(api::ProfilingMark::WorkEnd, 0);
+                    }
+                    self.finish_task();
+                }
+                Task::Work(Work {
+                    f,
+                    callback,
+                    profiler,
+                }) => {
+                    if let Some(profiler) = profiler {
+                        profiler.mark(api::ProfilingMark::WorkBegin, 0);
+                    }
+                    f(profiler);
+                    if let Some(profiler) = profiler {
+                        profiler.mark(api::ProfilingMark::WorkEnd, 0);
+                    }
+                    (callback.0)(callback.1);
+                    self.finish_task();
+                    let mut state = self.state.lock();
+                    if state.queue.is_empty() {
+                        state.scheduled = false;
+                        return;
+                    }
+                    drop(state);
+                    let scheduler = self.scheduler.clone();
+                    scheduler.schedule(self);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+struct SchedulerState {
+    ready: VecDeque<Arc<StreamContext>>,
+    // executors that are not blocked in block_in_place
+    target: usize,
+    executors: usize,
+    blocked: usize,
+    shutdown: bool,
+}
+
+// Executor threads shared by all the streams of a device. A stream with tasks is queued
+// for the executors, and a stream waiting for an event parks instead of blocking one, to
+// be queued again by the signal. Executors blocked by host synchronization are replaced,
+// so the streams they wait for always have an executor to make progress on.
+pub(super) struct Scheduler {
+    state: Mutex<SchedulerState>,
+    ready: Condvar,
+}
+
+thread_local! {
+    static CURRENT_SCHEDULER: RefCell<Option<Arc<Scheduler>>> = RefCell::new(None);
+}
+
+impl Scheduler {
+    pub(super) fn new(executors: usize) -> Arc<Self> {
+        let scheduler = Arc::new(Self {
+            state: Mutex::new(SchedulerState {
+                ready: VecDeque::new(),
+                target: executors.max(1),
+                executors: 0,
+                blocked: 0,
+                shutdown: false,
+            }),
+            ready: Condvar::new(),
+        });
+        {
+            let mut state = scheduler.state.lock();
+            for _ in 0..state.target {
+                scheduler.spawn_executor(&mut state);
+            }
+        }
+        scheduler
+    }
+    fn spawn_executor(self: &Arc<Self>, state: &mut SchedulerState) {
+        state.executors += 1;
+        let scheduler = self.clone();
+        thread::spawn(move || scheduler.run_executor());
+    }
+    fn schedule(&self, stream: Arc<StreamContext>) {
+        self.state.lock().ready.push_back(stream);
+        self.ready.notify_one();
+    }
+    // lets the executors exit once the ready streams are done
+    pub(super) fn shutdown(&self) {
+        self.state.lock().shutdown = true;
+        self.ready.notify_all();
+    }
+    fn run_executor(self: Arc<Self>) {
+        CURRENT_SCHEDULER.with(|current| *current.borrow_mut() = Some(self.clone()));
+        loop {
+            let stream = {
+                let mut state = self.state.lock();
+                loop {
+                    let surplus = state.executors - state.blocked > state.target;
+                    if surplus || (state.shutdown && state.ready.is_empty()) {
+                        state.executors -= 1;
+                        if !state.ready.is_empty() {
+                            self.ready.notify_one();
+                        }
+                        drop(state);
+                        CURRENT_SCHEDULER.with(|current| current.borrow_mut().take());
+                        return;
+                    }
+                    if let Some(stream) = state.ready.pop_front() {
+                        break stream;
+                    }
+                    self.ready.wait(&mut state);
+                }
+            };
+            stream.run();
+        }
+    }
+}
+
+// Runs `f`, which may block until other streams make progress. When called on an executor,
+// e.g. by a host command that synchronizes another stream, a replacement is started first.
+pub(super) fn block_in_place<R>(f: impl FnOnce() -> R) -> R {
+    let scheduler = match CURRENT_SCHEDULER.with(|current| current.borrow().clone()) {
+        Some(scheduler) => scheduler,
+        None => return f(),
+    };
+    {
+        let mut state = scheduler.state.lock();
+        state.blocked += 1;
+        if state.executors - state.blocked < state.target {
+            scheduler.spawn_executor(&mut state);
+        }
+    }
+    let result = f();
+    scheduler.state.lock().blocked -= 1;
+    // wakes an executor to retire if there are more than enough now
+    scheduler.ready.notify_one();
+    result
 }
 
 pub(super) struct StreamImpl {
     shared_pool: Arc<rayon::ThreadPool>,
-    #[allow(dead_code)]
-    private_thread: Arc<JoinHandle<()>>,
     ctx: Arc<StreamContext>,
+    // splits dispatches and large copies statically across the workers, so that
+    // first-touched pages are reused by workers on the same node
+    node_local: bool,
 }
 
-unsafe impl Send for StreamContext {}
-
-unsafe impl Sync for StreamContext {}
+// copies into buffers from this size on are split across the workers if `node_local` is set
+const NODE_LOCAL_COPY_MIN: usize = 4 << 20;
 
 impl StreamImpl {
-    pub(super) fn new(shared_pool: Arc<rayon::ThreadPool>) -> Self {
+    pub(super) fn new(
+        shared_pool: Arc<rayon::ThreadPool>,
+        scheduler: Arc<Scheduler>,
+        node_local: bool,
+    ) -> Self {
         let ctx = Arc::new(StreamContext {
-            queue: Mutex::new(VecDeque::new()),
-            new_work: Condvar::new(),
+            state: Mutex::new(StreamState {
+                queue: VecDeque::new(),
+                pending: 0,
+                scheduled: false,
+            }),
             sync: Condvar::new(),
-            work_count: AtomicUsize::new(0),
-            finished_count: AtomicUsize::new(0),
             staging_buffer_pool: StagingBufferPool::new(),
+            profiler: Mutex::new(None),
+            scheduler,
         });
-        let private_thread = {
-            let ctx = ctx.clone();
-            Arc::new(thread::spawn(move || {
-                let mut guard = ctx.queue.lock();
-                loop {
-                    while guard.is_empty() {
-                        ctx.new_work.wait(&mut guard);
-                    }
-                    loop {
-                        if guard.is_empty() {
-                            break;
-                        }
-                        let work = guard.pop_front().unwrap();
-                        let Work { f, callback } = work;
-                        drop(guard);
-                        f();
-                        (callback.0)(callback.1);
-                        ctx.finished_count
-                            .fetch_add(1, std::sync::atomic::Ordering::Relaxed);
-                        guard = ctx.queue.lock();
-                        if guard.is_empty() {
-                            ctx.sync.notify_one();
-                            break;
-                        }
-                    }
-                }
-            }))
-        };
         Self {
             shared_pool,
-            private_thread,
             ctx,
+            node_local,
         }
     }
     pub(super) fn synchronize(&self) {
-        let mut guard = self.ctx.queue.lock();
-        while self
-            .ctx
-            .work_count
-            .load(std::sync::atomic::Ordering::Relaxed)
-            > self
-                .ctx
-                .finished_count
-                .load(std::sync::atomic::Ordering::Relaxed)
-        {
-            self.ctx.sync.wait(&mut guard);
-        }
+        block_in_place(|| {
+            let mut state = self.ctx.state.lock();
+            while state.pending > 0 {
+                self.ctx.sync.wait(&mut state);
+            }
+        })
+    }
+    pub(super) fn set_profiler(&self, profiler: Option<(api::ProfilingCallback, *mut u8)>) {
+        *self.ctx.profiler.lock() = profiler.map(|(callback, user_data)| Profiler {
+            callback,
+            user_data,
+        });
     }
     pub(super) fn enqueue(
         &self,
-        work: impl FnOnce() + Send + Sync + 'static,
+        work: impl FnOnce(Option<Profiler>) + Send + Sync + 'static,
         callback: (extern "C" fn(*mut u8), *mut u8),
     ) {
-        let mut guard = self.ctx.queue.lock();
-        guard.push_back(Work {
+        let profiler = *self.ctx.profiler.lock();
+        self.ctx.push(Task::Work(Work {
             f: Box::new(work),
             callback,
+            profiler,
+        }));
+    }
+    // parks the stream until the event reaches the ticket, without holding an executor
+    pub(super) fn wait(&self, event: &EventImpl, ticket: u64) {
+        let profiler = *self.ctx.profiler.lock();
+        self.ctx.push(Task::Wait {
+            event: event as *const EventImpl,
+            ticket,
+            profiler,
         });
-        self.ctx
-            .work_count
-            .fetch_add(1, std::sync::atomic::Ordering::Relaxed);
-        self.ctx.new_work.notify_one();
     }
     pub(super) fn parallel_for(
         &self,
@@ -200,6 +425,30 @@ impl StreamImpl {
         let counter = Arc::new(AtomicUsize::new(0));
         let pool = self.shared_pool.clone();
         let nthreads = pool.current_num_threads();
+        if self.node_local {
+            // each worker starts on its own contiguous range and then helps the others,
+            // so the same blocks mostly run on the same workers in every dispatch
+            let starts: Vec<_> = (0..nthreads)
+                .map(|w| AtomicUsize::new(w * count / nthreads))
+                .collect();
+            let end = |w: usize| (w + 1) * count / nthreads;
+            pool.broadcast(|ctx| {
+                for k in 0..nthreads {
+                    let w = (ctx.index() + k) % nthreads;
+                    loop {
+                        let index =
+                            starts[w].fetch_add(block, std::sync::atomic::Ordering::Relaxed);
+                        if index >= end(w) {
+                            break;
+                        }
+                        for i in index..(index + block).min(end(w)) {
+                            kernel(i);
+                        }
+                    }
+                }
+            });
+            return;
+        }
         pool.scope(|s| {
             for _ in 0..nthreads {
                 s.spawn(|_| loop {
@@ -215,6 +464,27 @@ impl StreamImpl {
             }
         });
     }
+    unsafe fn copy_to_buffer(&self, src: *const u8, dst: *mut u8, size: usize) {
+        if !self.node_local || size < NODE_LOCAL_COPY_MIN {
+            std::ptr::copy_nonoverlapping(src, dst, size);
+            return;
+        }
+        let (src, dst) = (src as usize, dst as usize);
+        let chunks = self.shared_pool.current_num_threads();
+        self.parallel_for(
+            move |i| {
+                let begin = i * size / chunks;
+                let end = (i + 1) * size / chunks;
+                std::ptr::copy_nonoverlapping(
+                    (src + begin) as *const u8,
+                    (dst + begin) as *mut u8,
+                    end - begin,
+                );
+            },
+            1,
+            chunks,
+        );
+    }
     pub(super) fn allocate_staging_buffers(&self, command_list: &[api::Command]) -> StagingBuffers {
         self.ctx.staging_buffer_pool.allocate(command_list)
     }
@@ -222,12 +492,16 @@ impl StreamImpl {
         &self,
         mut staging_buffers: StagingBuffers,
         command_list: &[api::Command],
+        profiler: Option<Profiler>,
     ) {
         unsafe {
             let bump = &mut staging_buffers.bump;
             let buffers = &mut staging_buffers.buffers;
             let mut cnt = 0;
-            for cmd in command_list {
+            for (index, cmd) in command_list.iter().enumerate() {
+                if let Some(profiler) = profiler {
+                    profiler.mark(api::ProfilingMark::CommandBegin, index);
+                }
                 match cmd {
                     api::Command::BufferUpload(cmd) => {
                         let buffer = &*(cmd.buffer.0 as *mut BufferImpl);
@@ -236,7 +510,7 @@ impl StreamImpl {
                         // let data = cmd.data;
                         let data = buffers[cnt];
                         cnt += 1;
-                        std::ptr::copy_nonoverlapping(data, buffer.data.add(offset), size);
+                        self.copy_to_buffer(data, buffer.data.add(offset), size);
                     }
                     api::Command::BufferDownload(cmd) => {
                         let buffer = &*(cmd.buffer.0 as *mut BufferImpl);
@@ -252,7 +526,7 @@ impl StreamImpl {
                         let src_offset = cmd.src_offset;
                         let dst_offset = cmd.dst_offset;
                         let size = cmd.size;
-                        std::ptr::copy_nonoverlapping(
+                        self.copy_to_buffer(
                             src.data.add(src_offset),
                             dst.data.add(dst_offset),
                             size,
@@ -326,27 +600,57 @@ impl StreamImpl {
                         assert_eq!(cmd.storage, dst.storage);
                         assert_eq!(src_view.size, cmd.size);
                         assert_eq!(src_view.size, cmd.size);
-                        if src_view.data == dst_view.data {
-                            return;
+                        if src_view.tiled != dst_view.tiled {
+                            // sparse textures are tiled, so copies between them and
+                            // the others go pixel by pixel
+                            let pixel_size = 1 << src_view.pixel_stride_shift;
+                            for z in 0..cmd.size[2] {
+                                for y in 0..cmd.size[1] {
+                                    for x in 0..cmd.size[0] {
+                                        let (s, d) = if src.dimension == 2 {
+                                            (src_view.get_pixel_2d(x, y), dst_view.get_pixel_2d(x, y))
+                                        } else {
+                                            (src_view.get_pixel_3d(x, y, z), dst_view.get_pixel_3d(x, y, z))
+                                        };
+                                        std::ptr::copy_nonoverlapping(s, d, pixel_size);
+                                    }
+                                }
+                            }
+                        } else if src_view.data != dst_view.data {
+                            std::ptr::copy_nonoverlapping(
+                                src_view.data,
+                                dst_view.data,
+                                src_view.data_size,
+                            );
                         }
-                        std::ptr::copy_nonoverlapping(
-                            src_view.data,
-                            dst_view.data,
-                            src_view.data_size,
-                        );
                     }
                     api::Command::ShaderDispatch(cmd) => {
                         let shader = &*(cmd.shader.0 as *mut ShaderImpl);
-                        let dispatch_size = cmd.dispatch_size;
                         let block_size = shader.block_size;
-
-                        let blocks: [u32; 3] = [
-                            ((dispatch_size[0] + block_size[0] - 1) / block_size[0]).max(1),
-                            ((dispatch_size[1] + block_size[1] - 1) / block_size[1]).max(1),
-                            ((dispatch_size[2] + block_size[2] - 1) / block_size[2]).max(1),
-                        ];
-                        let block_count =
-                            blocks[0] as usize * blocks[1] as usize * blocks[2] as usize;
+                        let indirect = cmd.indirect.buffer.0 != api::INVALID_RESOURCE_HANDLE;
+                        let dispatches = if indirect {
+                            read_indirect_dispatches(&cmd.indirect)
+                        } else {
+                            vec![(cmd.dispatch_size, 0)]
+                        };
+                        // the blocks of all the dispatches are scheduled in a single loop
+                        let mut launches = Vec::with_capacity(dispatches.len());
+                        let mut block_count = 0usize;
+                        for (dispatch_size, kernel_id) in dispatches {
+                            let blocks: [u32; 3] = [
+                                ((dispatch_size[0] + block_size[0] - 1) / block_size[0]).max(1),
+                                ((dispatch_size[1] + block_size[1] - 1) / block_size[1]).max(1),
+                                ((dispatch_size[2] + block_size[2] - 1) / block_size[2]).max(1),
+                            ];
+                            launches.push(Launch {
+                                dispatch_size,
+                                kernel_id,
+                                blocks,
+                                first_block: block_count,
+                            });
+                            block_count +=
+                                blocks[0] as usize * blocks[1] as usize * blocks[2] as usize;
+                        }
                         let kernel = shader.fn_ptr();
                         let mut args: Vec<defs::KernelFnArg> = Vec::new();
 
@@ -365,8 +669,9 @@ impl StreamImpl {
                             args: (*args).as_ptr(),
                             dispatch_id: [0, 0, 0],
                             thread_id: [0, 0, 0],
-                            dispatch_size,
+                            dispatch_size: [0, 0, 0],
                             block_id: [0, 0, 0],
+                            kernel_id: 0,
                             args_count: args.len(),
                             custom_ops: shader.custom_ops.as_ptr(),
                             custom_ops_count: shader.custom_ops.len(),
@@ -375,7 +680,14 @@ impl StreamImpl {
 
                         self.parallel_for(
                             move |i| {
+                                let launch = &launches
+                                    [launches.partition_point(|l| l.first_block <= i) - 1];
+                                let i = i - launch.first_block;
+                                let blocks = launch.blocks;
+                                let dispatch_size = launch.dispatch_size;
                                 let mut args = kernel_args;
+                                args.dispatch_size = dispatch_size;
+                                args.kernel_id = launch.kernel_id;
                                 let block_z = i / (blocks[0] * blocks[1]) as usize;
                                 let block_y =
                                     (i % (blocks[0] * blocks[1]) as usize) / blocks[0] as usize;
@@ -434,6 +746,9 @@ impl StreamImpl {
                         mesh.build_procedural(mesh_build);
                     }
                 }
+                if let Some(profiler) = profiler {
+                    profiler.mark(api::ProfilingMark::CommandEnd, index);
+                }
             }
             bump.reset();
             buffers.clear();
@@ -442,6 +757,49 @@ impl StreamImpl {
     }
 }
 
+// one of the dispatches of a shader dispatch command
+struct Launch {
+    dispatch_size: [u32; 3],
+    kernel_id: u32,
+    blocks: [u32; 3],
+    first_block: usize,
+}
+
+// Indirect dispatch buffers hold a 16-byte header with the dispatch count, followed
+// by 32-byte dispatches of `uint3 block_size` (padded to 16 bytes), `uint3 dispatch_size`
+// and `uint kernel_id`. This mirrors the CUDA backend and lc_indirect_* in cpu_resource.h.
+const INDIRECT_DISPATCH_HEADER_SIZE: usize = 16;
+const INDIRECT_DISPATCH_STRIDE: usize = 32;
+
+// Reads the (dispatch size, kernel id) of the dispatches in [offset, offset + max_dispatch_count)
+// that were set by previous commands. The block size of each dispatch is ignored as the
+// shader is compiled with a fixed block size.
+unsafe fn read_indirect_dispatches(
+    indirect: &api::IndirectDispatchArgument,
+) -> Vec<([u32; 3], u32)> {
+    let buffer = &*(indirect.buffer.0 as *mut BufferImpl);
+    assert!(
+        buffer.size >= INDIRECT_DISPATCH_HEADER_SIZE,
+        "Invalid indirect dispatch buffer."
+    );
+    let capacity = (buffer.size - INDIRECT_DISPATCH_HEADER_SIZE) / INDIRECT_DISPATCH_STRIDE;
+    let offset = (indirect.offset as usize).min(capacity);
+    let end = (offset + indirect.max_dispatch_count as usize).min(capacity);
+    let count = (*(buffer.data as *const u32) as usize).min(end - offset);
+    (offset..offset + count)
+        .filter_map(|i| {
+            let dispatch = buffer
+                .data
+                .add(INDIRECT_DISPATCH_HEADER_SIZE + i * INDIRECT_DISPATCH_STRIDE)
+                as *const u32;
+            let dispatch_size = [*dispatch.add(4), *dispatch.add(5), *dispatch.add(6)];
+            let kernel_id = *dispatch.add(7);
+            // empty dispatches are skipped, as on the GPU backends
+            (dispatch_size.iter().all(|&s| s > 0)).then_some((dispatch_size, kernel_id))
+        })
+        .collect()
+}
+
 #[inline]
 pub unsafe fn convert_arg(arg: Argument) -> defs::KernelFnArg {
     match arg {
@@ -1,8 +1,22 @@
 use luisa_compute_api_types::PixelStorage;
 
+use super::memory::{Allocation, MemoryAllocator};
+
 use rayon::prelude::{IntoParallelIterator, ParallelIterator};
 
 const BLOCK_SIZE: usize = 4;
+// the tiles of sparse textures, CPUSparseResource::tile_size_bytes in cpu_sparse.h
+const TILE_SIZE_BYTES: usize = 64 * 1024;
+
+// the size in pixels of a tile of sparse textures, the same as CPUSparseTexture::tile_size
+#[inline]
+fn tile_size(dimension: u8, pixel_stride_shift: usize) -> [u32; 3] {
+    if dimension == 2 {
+        [1024 >> pixel_stride_shift, 64, 1]
+    } else {
+        [256 >> pixel_stride_shift, 16, 16]
+    }
+}
 
 pub struct TextureImpl {
     pub(crate) data: *mut u8,
@@ -13,24 +27,37 @@ pub struct TextureImpl {
     pub(crate) mip_levels: u8,
     pub(crate) mip_offsets: [usize; 16],
     pub(crate) storage: PixelStorage,
-    layout: std::alloc::Layout,
+    // whether the pixels are stored in 64KB tiles, one after another and block-linear within
+    // each tile, so that every tile of a sparse texture is a contiguous range of memory
+    pub(crate) tiled: bool,
+    // None if the memory is owned by the caller, e.g. a sparse texture
+    allocation: Option<Allocation>,
+}
+
+enum Memory<'a> {
+    Borrow(*mut u8),
+    Allocate(&'a MemoryAllocator),
 }
 
 unsafe impl Send for TextureImpl {}
 
 unsafe impl Sync for TextureImpl {}
 
-impl Drop for TextureImpl {
-    fn drop(&mut self) {
-        unsafe {
-            std::alloc::dealloc(self.data, self.layout);
-        }
-    }
-}
-
 impl TextureImpl {
-    pub(super) fn new(dimension: u8, size: [u32; 3], storage: PixelStorage,
+    pub(super) fn new(memory: &MemoryAllocator, dimension: u8, size: [u32; 3], storage: PixelStorage,
                       levels: u8, _allow_simultaneous_access: bool) -> Self {
+        Self::new_impl(dimension, size, storage, levels, Memory::Allocate(memory), false)
+    }
+    // wraps the memory of a sparse texture, which the caller allocated with the tiled layout,
+    // it must be at least as large as `data_size` and outlive the texture
+    pub(super) fn from_memory(dimension: u8, size: [u32; 3], storage: PixelStorage,
+                              levels: u8, data: *mut u8) -> Self {
+        assert!(!data.is_null());
+        assert_eq!(data as usize % 16, 0);
+        Self::new_impl(dimension, size, storage, levels, Memory::Borrow(data), true)
+    }
+    fn new_impl(dimension: u8, size: [u32; 3], storage: PixelStorage,
+                levels: u8, memory: Memory, tiled: bool) -> Self {
         let pixel_size = storage.size();
         let pixel_stride_shift = match pixel_size {
             1 => 0,
@@ -47,6 +74,14 @@ impl TextureImpl {
         let mut mip_offsets = [0; 16];
         for level in 0..levels {
             mip_offsets[level as usize] = data_size;
+            if tiled {
+                let tile = tile_size(dimension, pixel_stride_shift);
+                let tiles = (0..3)
+                    .map(|i| ((((size[i] >> level).max(1)) + tile[i] - 1) / tile[i]) as usize)
+                    .product::<usize>();
+                data_size += tiles * TILE_SIZE_BYTES;
+                continue;
+            }
             let blocks = [
                 (((size[0] as usize >> level).max(1)) + BLOCK_SIZE - 1) / BLOCK_SIZE,
                 (((size[1] as usize >> level).max(1)) + BLOCK_SIZE - 1) / BLOCK_SIZE,
@@ -67,8 +102,13 @@ impl TextureImpl {
         for level in levels..16 {
             mip_offsets[level as usize] = data_size;
         }
-        let layout = std::alloc::Layout::from_size_align(data_size, 16).unwrap();
-        let data = unsafe { std::alloc::alloc(layout) };
+        let (data, allocation) = match memory {
+            Memory::Borrow(data) => (data, None),
+            Memory::Allocate(memory) => {
+                let allocation = memory.allocate(data_size, 16, false);
+                (allocation.data(), Some(allocation))
+            }
+        };
         Self {
             data,
             data_size,
@@ -78,7 +118,8 @@ impl TextureImpl {
             mip_levels: levels,
             mip_offsets,
             storage,
-            layout,
+            tiled,
+            allocation,
         }
     }
     pub(crate) fn view(&self, level: u8) -> TextureView {
@@ -94,6 +135,7 @@ impl TextureImpl {
                 data: self.data.add(offset) as *mut u8,
                 size,
                 pixel_stride_shift: self.pixel_stride_shift,
+                tiled: self.tiled,
                 data_size: if level == 15 {
                     self.data_size - offset
                 } else {
@@ -117,6 +159,7 @@ impl TextureImpl {
             mip_levels: self.mip_levels,
             pixel_stride_shift: self.pixel_stride_shift as u8,
             mip_offsets: self.mip_offsets,
+            tiled: self.tiled as u8,
         }
     }
 }
@@ -126,6 +169,7 @@ pub(crate) struct TextureView {
     pub(crate) data: *mut u8,
     pub(crate) size: [u32; 3],
     pub(crate) pixel_stride_shift: usize,
+    pub(crate) tiled: bool,
     pub(crate) data_size: usize,
 }
 
@@ -140,36 +184,42 @@ impl TextureView {
             * self.size[2] as usize
             * (1 << self.pixel_stride_shift)
     }
+    // the index of a pixel, block-linear within tiles that are stored one after another;
+    // an untiled level is a single tile covering the whole level
+    #[inline]
+    fn pixel_index(&self, dimension: u8, x: u32, y: u32, z: u32) -> usize {
+        let b = BLOCK_SIZE as u32;
+        let align = |n: u32| (n + b - 1) / b * b;
+        let tile = if self.tiled {
+            tile_size(dimension, self.pixel_stride_shift)
+        } else if dimension == 2 {
+            [align(self.size[0]), align(self.size[1]), 1]
+        } else {
+            [align(self.size[0]), align(self.size[1]), align(self.size[2])]
+        };
+        let block_pixels = (if dimension == 2 { b * b } else { b * b * b }) as usize;
+        let tile_pixels = tile[0] as usize * tile[1] as usize * tile[2] as usize;
+        let tiles_x = ((self.size[0] + tile[0] - 1) / tile[0]) as usize;
+        let tiles_y = ((self.size[1] + tile[1] - 1) / tile[1]) as usize;
+        let tile_idx = (x / tile[0]) as usize
+            + (y / tile[1]) as usize * tiles_x
+            + (z / tile[2]) as usize * tiles_x * tiles_y;
+        let (grid_x, grid_y) = ((tile[0] / b) as usize, (tile[1] / b) as usize);
+        let block_idx = ((x % tile[0]) / b) as usize
+            + ((y % tile[1]) / b) as usize * grid_x
+            + ((z % tile[2]) / b) as usize * grid_x * grid_y;
+        let pixel_idx = (x % b + (y % b) * b + (z % b) * b * b) as usize;
+        tile_idx * tile_pixels + block_idx * block_pixels + pixel_idx
+    }
     #[inline]
     pub(crate) fn get_pixel_2d(&self, x: u32, y: u32) -> *mut u8 {
-        let block_x = x / BLOCK_SIZE as u32;
-        let block_y = y / BLOCK_SIZE as u32;
-        let grid_width = (self.size[0] + BLOCK_SIZE as u32 - 1) / BLOCK_SIZE as u32;
-        let block_idx = block_x + block_y * grid_width;
-        let pixel_x = x % BLOCK_SIZE as u32;
-        let pixel_y = y % BLOCK_SIZE as u32;
-        let pixel_idx =
-            block_idx * (BLOCK_SIZE * BLOCK_SIZE) as u32 + pixel_x + pixel_y * BLOCK_SIZE as u32;
-        let i = (pixel_idx as usize) << self.pixel_stride_shift;
+        let i = self.pixel_index(2, x, y, 0) << self.pixel_stride_shift;
         assert!(i <= self.data_size);
         unsafe { self.data.add(i) }
     }
     #[inline]
     pub(crate) fn get_pixel_3d(&self, x: u32, y: u32, z: u32) -> *mut u8 {
-        let block_x = x / BLOCK_SIZE as u32;
-        let block_y = y / BLOCK_SIZE as u32;
-        let block_z = z / BLOCK_SIZE as u32;
-        let grid_width = (self.size[0] + BLOCK_SIZE as u32 - 1) / BLOCK_SIZE as u32;
-        let grid_height = (self.size[1] + BLOCK_SIZE as u32 - 1) / BLOCK_SIZE as u32;
-        let block_idx = block_x + block_y * grid_width + block_z * grid_width * grid_height;
-        let pixel_x = x % BLOCK_SIZE as u32;
-        let pixel_y = y % BLOCK_SIZE as u32;
-        let pixel_z = z % BLOCK_SIZE as u32;
-        let pixel_idx = block_idx * (BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE) as u32
-            + pixel_x
-            + pixel_y * BLOCK_SIZE as u32
-            + pixel_z * BLOCK_SIZE as u32 * BLOCK_SIZE as u32;
-        let i = (pixel_idx as usize) << self.pixel_stride_shift;
+        let i = self.pixel_index(3, x, y, z) << self.pixel_stride_shift;
         assert!(i <= self.data_size);
         unsafe { self.data.add(i) }
     }
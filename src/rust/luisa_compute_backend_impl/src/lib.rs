@@ -1,7 +1,5 @@
 #[cfg(feature = "cpu")]
 mod cpu;
-#[cfg(feature = "remote")]
-mod remote;
 
 use libloading::Library;
 use log::{Level, LevelFilter, Metadata, Record};
@@ -182,10 +180,15 @@ extern "C" fn destroy_context(ctx: api::Context) {
 unsafe extern "C" fn create_device(
     ctx: api::Context,
     device: *const c_char,
-    _config: *const c_char,// TODO: respect config
+    config: *const c_char,
 ) -> DeviceInterface {
     let device = CStr::from_ptr(device).to_str().unwrap();
-    // let config = CStr::from_ptr(config).to_str().unwrap();
+    let config = if config.is_null() {
+        serde_json::Value::Null
+    } else {
+        serde_json::from_str(CStr::from_ptr(config).to_str().unwrap())
+            .unwrap_or_else(|e| panic_abort!("invalid device config: {}", e))
+    };
     let ctx = &*(ctx.0 as *const Context);
     match device {
         "cpu" => {
@@ -209,7 +212,7 @@ unsafe extern "C" fn create_device(
                     })
                     .ok()
                     .map(|x| Arc::new(x));
-                let device = cpu::RustBackend::new();
+                let device = cpu::RustBackend::new(&config);
                 if let Some(swapchain) = swapchain {
                     device.set_swapchain_contex(swapchain);
                 }
@@ -220,18 +223,6 @@ unsafe extern "C" fn create_device(
                 panic_abort!("cpu device is not enabled")
             }
         }
-        "remote" => {
-            #[cfg(feature = "remote")]
-            {
-                // let device = remote::RemoteBackend::new(config);
-                // create_device_interface(device)
-                todo!()
-            }
-            #[cfg(not(feature = "remote"))]
-            {
-                panic_abort!("remote device is not enabled")
-            }
-        }
         _ => panic_abort!("unknown device {}", device),
     }
 }
@@ -80,6 +80,7 @@ struct Texture {
     uint8_t pixel_stride_shift;
     size_t mip_offsets[16];
     uint8_t sampler;
+    uint8_t tiled;
 };
 
 struct BindlessArray {
@@ -146,6 +147,7 @@ struct KernelFnArgs {
     uint32_t thread_id[3];
     uint32_t dispatch_size[3];
     uint32_t block_id[3];
+    uint32_t kernel_id;
     const CpuCustomOp *custom_ops;
     size_t custom_ops_count;
     const void *internal_data;
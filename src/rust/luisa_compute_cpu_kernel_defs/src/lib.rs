@@ -11,6 +11,7 @@ pub struct KernelFnArgs {
     pub thread_id: [u32; 3],
     pub dispatch_size: [u32; 3],
     pub block_id: [u32; 3],
+    pub kernel_id: u32,
     pub custom_ops: *const CpuCustomOp,
     pub custom_ops_count: usize,
     pub internal_data: *const c_void,
@@ -161,6 +162,7 @@ pub struct Texture {
     pub pixel_stride_shift: u8,
     pub mip_offsets: [usize; 16],
     pub sampler: u8,
+    pub tiled: u8,
 }
 impl Default for Texture {
     fn default() -> Self {
@@ -175,6 +177,7 @@ impl Default for Texture {
             pixel_stride_shift: 0,
             mip_offsets: [0; 16],
             sampler: 0,
+            tiled: 0,
         }
     }
 }
@@ -205,8 +205,15 @@ impl DisplayIR {
                 self.add_ident(ident);
                 self.output += "}";
             }
-            Instruction::AdScope { body } => {
-                self.output += "AdScope {\n";
+            Instruction::AdScope {
+                body,
+                checkpoint_interval,
+            } => {
+                if *checkpoint_interval == 1 {
+                    self.output += "AdScope {\n";
+                } else {
+                    self.output += &format!("AdScope(checkpoint = {}) {{\n", checkpoint_interval);
+                }
                 for node in body.nodes().iter() {
                     self.display(*node, ident + 1, false);
                 }
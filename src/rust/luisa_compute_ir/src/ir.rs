@@ -521,6 +521,7 @@ pub enum Func {
     WarpLaneId,
     DispatchId,
     DispatchSize,
+    KernelId,
 
     RequiresGradient,
     Backward,
@@ -726,6 +727,24 @@ pub enum Func {
     AtomicFetchMin,
     /// (buffer/smem, indices..., val) -> old: stores max(old, val), returns old.
     AtomicFetchMax,
+    /// (buffer/smem, indices..., desired, order) -> old: same as AtomicExchange, with the constant memory order.
+    AtomicExchangeExplicit,
+    /// (buffer/smem, indices..., expected, desired, order) -> old: same as AtomicCompareExchange, with the constant memory order.
+    AtomicCompareExchangeExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchAdd, with the constant memory order.
+    AtomicFetchAddExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchSub, with the constant memory order.
+    AtomicFetchSubExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchAnd, with the constant memory order.
+    AtomicFetchAndExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchOr, with the constant memory order.
+    AtomicFetchOrExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchXor, with the constant memory order.
+    AtomicFetchXorExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchMin, with the constant memory order.
+    AtomicFetchMinExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchMax, with the constant memory order.
+    AtomicFetchMaxExplicit,
     // memory access
     /// (buffer, index) -> value: reads the index-th element in buffer
     BufferRead,
@@ -1074,6 +1093,10 @@ pub enum Instruction {
     },
     AdScope {
         body: Pooled<BasicBlock>,
+        // forward intermediates needed by the backward pass:
+        // 1 stores all of them, k > 1 stores every k-th recomputable one
+        // and recomputes the rest, 0 recomputes everything recomputable
+        checkpoint_interval: u32,
     },
     RayQuery {
         ray_query: NodeRef,
@@ -1638,7 +1661,7 @@ impl NodeCollector {
         self.nodes.push(node_ref);
         let inst = node_ref.get().instruction.as_ref();
         match inst {
-            Instruction::AdScope { body } => {
+            Instruction::AdScope { body, .. } => {
                 self.visit_block(*body);
             }
             Instruction::If {
@@ -1865,9 +1888,12 @@ impl ModuleDuplicator {
                 let dup_default = self.duplicate_block(&builder.pools, default);
                 builder.switch(dup_value, dup_cases.as_slice(), dup_default)
             }
-            Instruction::AdScope { body } => {
+            Instruction::AdScope {
+                body,
+                checkpoint_interval,
+            } => {
                 let dup_body = self.duplicate_block(&builder.pools, body);
-                builder.ad_scope(dup_body)
+                builder.ad_scope(dup_body, *checkpoint_interval)
             }
             Instruction::RayQuery { ray_query, on_triangle_hit, on_procedural_hit } => {
                 let dup_ray_query = self.find_duplicated_node(*ray_query);
@@ -1946,6 +1972,54 @@ pub fn duplicate_callable(callable: &CArc<CallableModule>) -> CArc<CallableModul
     dup.duplicate_callable(callable)
 }
 
+// Makes the module call private copies of its callables (and of the callables they call),
+// so that in-place transforms do not modify modules shared with other kernels, e.g. the ones
+// interned by AST2IR. Each callable is copied once, however many times it is called.
+pub fn detach_callables(module: &Module) {
+    fn visit(dup: &mut ModuleDuplicator, block: &Pooled<BasicBlock>) {
+        for node in block.nodes() {
+            match node.get().instruction.as_ref() {
+                Instruction::Call(Func::Callable(callable), args) => {
+                    let copy = dup.duplicate_callable(&callable.0);
+                    let call = Node::new(
+                        CArc::new(Instruction::Call(
+                            Func::Callable(CallableModuleRef(copy)),
+                            args.clone(),
+                        )),
+                        node.type_().clone(),
+                    );
+                    node.replace_with(&call);
+                }
+                Instruction::Loop { body, .. } => visit(dup, body),
+                Instruction::GenericLoop { prepare, body, update, .. } => {
+                    visit(dup, prepare);
+                    visit(dup, body);
+                    visit(dup, update);
+                }
+                Instruction::If { true_branch, false_branch, .. } => {
+                    visit(dup, true_branch);
+                    visit(dup, false_branch);
+                }
+                Instruction::Switch { cases, default, .. } => {
+                    for case in cases.iter() {
+                        visit(dup, &case.block);
+                    }
+                    visit(dup, default);
+                }
+                Instruction::AdScope { body, .. } => visit(dup, body),
+                Instruction::RayQuery { on_triangle_hit, on_procedural_hit, .. } => {
+                    visit(dup, on_triangle_hit);
+                    visit(dup, on_procedural_hit);
+                }
+                Instruction::AdDetach(body) => visit(dup, body),
+                _ => {}
+            }
+        }
+    }
+    let mut dup = ModuleDuplicator::new();
+    visit(&mut dup, &module.entry);
+}
+
 #[repr(C)]
 pub struct IrBuilder {
     bb: Pooled<BasicBlock>,
@@ -2185,8 +2259,14 @@ impl IrBuilder {
         self.append(node);
         node
     }
-    pub fn ad_scope(&mut self, body: Pooled<BasicBlock>) -> NodeRef {
-        let node = Node::new(CArc::new(Instruction::AdScope { body }), Type::void());
+    pub fn ad_scope(&mut self, body: Pooled<BasicBlock>, checkpoint_interval: u32) -> NodeRef {
+        let node = Node::new(
+            CArc::new(Instruction::AdScope {
+                body,
+                checkpoint_interval,
+            }),
+            Type::void(),
+        );
         let node = new_node(&self.pools, node);
         self.append(node);
         node
@@ -231,9 +231,15 @@ impl KernelSerializer {
                     cases,
                 }
             }
-            Instruction::AdScope { body } => {
+            Instruction::AdScope {
+                body,
+                checkpoint_interval,
+            } => {
                 let body = self.serialize_block(body);
-                SerializedInstruction::AdScope { body }
+                SerializedInstruction::AdScope {
+                    body,
+                    checkpoint_interval: *checkpoint_interval,
+                }
             }
             Instruction::AdDetach(b) => {
                 let b = self.serialize_block(b);
@@ -269,6 +275,7 @@ impl KernelSerializer {
             Func::BlockId => SerializedFunc::BlockId,
             Func::DispatchId => SerializedFunc::DispatchId,
             Func::DispatchSize => SerializedFunc::DispatchSize,
+            Func::KernelId => SerializedFunc::KernelId,
             Func::Backward => SerializedFunc::Backward,
             Func::RequiresGradient => SerializedFunc::RequiresGradient,
             Func::Gradient => SerializedFunc::Gradient,
@@ -394,6 +401,15 @@ impl KernelSerializer {
             Func::AtomicFetchXor => SerializedFunc::AtomicFetchXor,
             Func::AtomicFetchMin => SerializedFunc::AtomicFetchMin,
             Func::AtomicFetchMax => SerializedFunc::AtomicFetchMax,
+            Func::AtomicExchangeExplicit => SerializedFunc::AtomicExchangeExplicit,
+            Func::AtomicCompareExchangeExplicit => SerializedFunc::AtomicCompareExchangeExplicit,
+            Func::AtomicFetchAddExplicit => SerializedFunc::AtomicFetchAddExplicit,
+            Func::AtomicFetchSubExplicit => SerializedFunc::AtomicFetchSubExplicit,
+            Func::AtomicFetchAndExplicit => SerializedFunc::AtomicFetchAndExplicit,
+            Func::AtomicFetchOrExplicit => SerializedFunc::AtomicFetchOrExplicit,
+            Func::AtomicFetchXorExplicit => SerializedFunc::AtomicFetchXorExplicit,
+            Func::AtomicFetchMinExplicit => SerializedFunc::AtomicFetchMinExplicit,
+            Func::AtomicFetchMaxExplicit => SerializedFunc::AtomicFetchMaxExplicit,
             Func::BufferRead => SerializedFunc::BufferRead,
             Func::BufferWrite => SerializedFunc::BufferWrite,
             Func::BufferSize => SerializedFunc::BufferSize,
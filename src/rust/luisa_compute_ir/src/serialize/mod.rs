@@ -141,6 +141,7 @@ pub enum SerializedInstruction {
     },
     AdScope {
         body: SerializedBlockRef,
+        checkpoint_interval: u32,
     },
     AdDetach(SerializedBlockRef),
     RayQuery {
@@ -167,6 +168,7 @@ pub enum SerializedFunc {
     WarpLaneId,
     DispatchId,
     DispatchSize,
+    KernelId,
 
     RequiresGradient,
     Backward,
@@ -371,6 +373,24 @@ pub enum SerializedFunc {
     AtomicFetchMin,
     /// (buffer/smem, indices..., val) -> old: stores max(old, val), returns old.
     AtomicFetchMax,
+    /// (buffer/smem, indices..., desired, order) -> old: same as AtomicExchange, with the constant memory order.
+    AtomicExchangeExplicit,
+    /// (buffer/smem, indices..., expected, desired, order) -> old: same as AtomicCompareExchange, with the constant memory order.
+    AtomicCompareExchangeExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchAdd, with the constant memory order.
+    AtomicFetchAddExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchSub, with the constant memory order.
+    AtomicFetchSubExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchAnd, with the constant memory order.
+    AtomicFetchAndExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchOr, with the constant memory order.
+    AtomicFetchOrExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchXor, with the constant memory order.
+    AtomicFetchXorExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchMin, with the constant memory order.
+    AtomicFetchMinExplicit,
+    /// (buffer/smem, indices..., val, order) -> old: same as AtomicFetchMax, with the constant memory order.
+    AtomicFetchMaxExplicit,
     // memory access
     /// (buffer, index) -> value: reads the index-th element in buffer
     BufferRead,
@@ -0,0 +1,211 @@
+/*
+ * This file implements the AggregateAtomics transform, which merges integer atomic additions
+ * issued by the active lanes of a warp (SIMD group) into a single atomic operation:
+ *   1. Find the atomic_fetch_add calls on integer scalars in the kernel and the callables it invokes.
+ *   2. Check at runtime whether all active lanes agree on the non-constant indices of the address.
+ *   3. If they do, let the first active lane add the warp-wide sum and broadcast the old value, so that
+ *      each lane returns it offset by the exclusive prefix sum of the values of the lanes before it.
+ *   4. Otherwise, fall back to the original per-lane atomic operation.
+ * Integer additions are associative, so the values observed by the lanes and the final result stay the
+ * same as long as the other lanes of the warp do not access the address in between.
+ * Callables are shared by the kernels converted from AST, so the ones containing such atomics are
+ * duplicated before being transformed.
+ */
+
+use std::collections::{HashMap, HashSet};
+use crate::ir::{BasicBlock, CallableModule, CallableModuleRef, Const, duplicate_callable, Func, Instruction, IrBuilder, Module, ModulePools, Node, NodeRef, Type};
+use crate::{CArc, CBoxedSlice, Pooled};
+use crate::transform::Transform;
+
+pub struct AggregateAtomics;
+
+struct AggregateAtomicsImpl {
+    // whether a callable contains aggregatable atomics, directly or in the callables it invokes
+    contains_atomics: HashMap<*const CallableModule, bool>,
+    // callables of the kernel to their transformed duplicates
+    duplicated: HashMap<*const CallableModule, CArc<CallableModule>>,
+    // duplicates that have been transformed in place
+    transformed: HashSet<*const CallableModule>,
+}
+
+impl AggregateAtomicsImpl {
+    fn new() -> Self {
+        Self {
+            contains_atomics: HashMap::new(),
+            duplicated: HashMap::new(),
+            transformed: HashSet::new(),
+        }
+    }
+
+    fn sub_blocks(node: NodeRef) -> Vec<Pooled<BasicBlock>> {
+        match node.get().instruction.as_ref() {
+            Instruction::Loop { body, cond: _ } => vec![*body],
+            Instruction::GenericLoop { prepare, body, update, cond: _ } => vec![*prepare, *body, *update],
+            Instruction::If { cond: _, true_branch, false_branch } => vec![*true_branch, *false_branch],
+            Instruction::Switch { value: _, cases, default } => {
+                let mut blocks: Vec<_> = cases.iter().map(|case| case.block).collect();
+                blocks.push(*default);
+                blocks
+            }
+            Instruction::AdScope { body, .. } => vec![*body],
+            Instruction::RayQuery { ray_query: _, on_triangle_hit, on_procedural_hit } => {
+                vec![*on_triangle_hit, *on_procedural_hit]
+            }
+            Instruction::AdDetach(body) => vec![*body],
+            _ => vec![],
+        }
+    }
+
+    fn block_contains_atomics(&mut self, block: &Pooled<BasicBlock>) -> bool {
+        block.nodes().into_iter().any(|node| {
+            if Self::is_aggregatable(node) {
+                return true;
+            }
+            if let Instruction::Call(Func::Callable(callable), _) = node.get().instruction.as_ref() {
+                return self.callable_contains_atomics(&callable.0);
+            }
+            Self::sub_blocks(node).iter().any(|block| self.block_contains_atomics(block))
+        })
+    }
+
+    fn callable_contains_atomics(&mut self, callable: &CArc<CallableModule>) -> bool {
+        if let Some(contains) = self.contains_atomics.get(&callable.as_ptr()) {
+            return *contains;
+        }
+        let contains = self.block_contains_atomics(&callable.module.entry);
+        self.contains_atomics.insert(callable.as_ptr(), contains);
+        contains
+    }
+
+    fn is_aggregatable(node: NodeRef) -> bool {
+        match node.get().instruction.as_ref() {
+            Instruction::Call(Func::AtomicFetchAdd, args) => {
+                // (buffer/smem, indices..., val)
+                let t = node.type_();
+                args.len() >= 3 && t.is_primitive() && t.is_int()
+            }
+            _ => false,
+        }
+    }
+
+    fn aggregate(pools: &CArc<ModulePools>, node: NodeRef) {
+        let args = match node.get().instruction.as_ref() {
+            Instruction::Call(_, args) => args.to_vec(),
+            _ => unreachable!(),
+        };
+        let t = node.type_().clone();
+        let bool_t = Type::bool(t.clone());
+        let (value, address) = args.split_last().unwrap();
+        let value = *value;
+
+        let mut builder = IrBuilder::new(pools.clone());
+        builder.set_insert_point(node.get().prev);
+        let zero = builder.const_(Const::Zero(t.clone()));
+        let result = builder.local(zero);
+        // constant indices, e.g., struct member accesses, are the same across lanes
+        let mut uniform = None;
+        for index in &address[1..] {
+            if index.is_const() {
+                continue;
+            }
+            let equal = builder.call(Func::WarpActiveAllEqual, &[*index], bool_t.clone());
+            uniform = Some(match uniform {
+                Some(u) => builder.call(Func::BitAnd, &[u, equal], bool_t.clone()),
+                None => equal,
+            });
+        }
+        let uniform = match uniform {
+            Some(u) => u,
+            None => builder.const_(Const::Bool(true)),
+        };
+
+        let aggregated = {
+            let mut builder = IrBuilder::new(pools.clone());
+            let sum = builder.call(Func::WarpActiveSum, &[value], t.clone());
+            let prefix = builder.call(Func::WarpPrefixSum, &[value], t.clone());
+            let zero = builder.const_(Const::Zero(t.clone()));
+            let base = builder.local(zero);
+            let is_first = builder.call(Func::WarpIsFirstActiveLane, &[], bool_t.clone());
+            let first_lane = {
+                let mut builder = IrBuilder::new(pools.clone());
+                let mut first_lane_args = address.to_vec();
+                first_lane_args.push(sum);
+                let old = builder.call(Func::AtomicFetchAdd, &first_lane_args, t.clone());
+                builder.update(base, old);
+                builder.finish()
+            };
+            let other_lanes = IrBuilder::new(pools.clone()).finish();
+            builder.if_(is_first, first_lane, other_lanes);
+            let base = builder.load(base);
+            let base = builder.call(Func::WarpReadFirstLane, &[base], t.clone());
+            let old = builder.call(Func::Add, &[base, prefix], t.clone());
+            builder.update(result, old);
+            builder.finish()
+        };
+        let divergent = {
+            let mut builder = IrBuilder::new(pools.clone());
+            let old = builder.call(Func::AtomicFetchAdd, &args, t.clone());
+            builder.update(result, old);
+            builder.finish()
+        };
+        builder.if_(uniform, aggregated, divergent);
+
+        // the original node now loads the result so that its users stay untouched
+        let load = Node::new(
+            CArc::new(Instruction::Call(Func::Load, CBoxedSlice::new(vec![result]))),
+            t,
+        );
+        node.replace_with(&load);
+    }
+
+    fn transform_callable(&mut self, callable: &CArc<CallableModule>) -> CArc<CallableModule> {
+        if let Some(dup) = self.duplicated.get(&callable.as_ptr()) {
+            return dup.clone();
+        }
+        // the callables invoked by the duplicate are duplicated as well, so it can be transformed in place
+        let dup = duplicate_callable(callable);
+        self.transformed.insert(dup.as_ptr());
+        self.transform_recursive(&dup.module.pools, &dup.module.entry, true);
+        self.duplicated.insert(callable.as_ptr(), dup.clone());
+        dup
+    }
+
+    fn transform_recursive(&mut self, pools: &CArc<ModulePools>, block: &Pooled<BasicBlock>, owned: bool) {
+        // collect the nodes first so that the inserted ones are not visited again
+        for node in block.nodes() {
+            if Self::is_aggregatable(node) {
+                Self::aggregate(pools, node);
+                continue;
+            }
+            if let Instruction::Call(Func::Callable(callable), args) = node.get().instruction.as_ref() {
+                if !self.callable_contains_atomics(&callable.0) {
+                    continue;
+                }
+                if owned {
+                    if self.transformed.insert(callable.0.as_ptr()) {
+                        self.transform_recursive(&callable.0.module.pools, &callable.0.module.entry, true);
+                    }
+                } else {
+                    let dup = self.transform_callable(&callable.0);
+                    let call = Node::new(
+                        CArc::new(Instruction::Call(Func::Callable(CallableModuleRef(dup)), args.clone())),
+                        node.type_().clone(),
+                    );
+                    node.replace_with(&call);
+                }
+                continue;
+            }
+            for block in Self::sub_blocks(node) {
+                self.transform_recursive(pools, &block, owned);
+            }
+        }
+    }
+}
+
+impl Transform for AggregateAtomics {
+    fn transform(&self, module: Module) -> Module {
+        let mut imp = AggregateAtomicsImpl::new();
+        imp.transform_recursive(&module.pools, &module.entry, false);
+        module
+    }
+}
@@ -177,9 +177,38 @@ fn _grad_type_of(type_: CArc<Type>) -> Option<GradTypeRecord> {
     record
 }
 
+// pure functions whose results are cheap enough to recompute in the backward pass
+fn is_recomputable_func(func: &Func) -> bool {
+    match func {
+        Func::Cast | Func::Bitcast => true,
+        Func::Add | Func::Sub | Func::Mul | Func::Div | Func::Rem => true,
+        Func::BitAnd | Func::BitOr | Func::BitXor | Func::Shl | Func::Shr => true,
+        Func::Eq | Func::Ne | Func::Lt | Func::Le | Func::Gt | Func::Ge => true,
+        Func::MatCompMul | Func::Neg | Func::Not | Func::BitNot | Func::All | Func::Any => true,
+        Func::Select | Func::Clamp | Func::Lerp | Func::Step | Func::Saturate | Func::Abs => true,
+        Func::Min | Func::Max | Func::ReduceSum | Func::ReduceProd => true,
+        Func::ReduceMin | Func::ReduceMax => true,
+        Func::Acos | Func::Asin | Func::Atan | Func::Atan2 => true,
+        Func::Cos | Func::Sin | Func::Tan => true,
+        Func::Exp | Func::Exp2 | Func::Exp10 | Func::Log | Func::Log2 | Func::Log10 => true,
+        Func::Powi | Func::Powf | Func::Sqrt | Func::Rsqrt | Func::Fma => true,
+        Func::Ceil | Func::Floor | Func::Fract | Func::Trunc | Func::Round => true,
+        Func::Cross | Func::Dot | Func::Length | Func::LengthSquared | Func::Normalize => true,
+        Func::Transpose => true,
+        Func::Vec | Func::Vec2 | Func::Vec3 | Func::Vec4 | Func::Permute => true,
+        Func::InsertElement | Func::ExtractElement | Func::Struct | Func::Array => true,
+        Func::Mat | Func::Mat2 | Func::Mat3 | Func::Mat4 => true,
+        _ => false,
+    }
+}
+
 struct StoreIntermediate<'a> {
     // map from node to its intermediate
     intermediate: IndexMap<NodeRef, NodeRef>,
+    // nodes that are recomputed in the backward pass instead of being stored
+    recompute: IndexSet<NodeRef>,
+    checkpoint_interval: u32,
+    recomputable_count: u32,
     intermediate_to_node: IndexMap<NodeRef, NodeRef>,
     forward_reachable: IndexSet<NodeRef>,
     backward_reachable: IndexSet<NodeRef>,
@@ -192,12 +221,15 @@ struct StoreIntermediate<'a> {
 }
 
 impl<'a> StoreIntermediate<'a> {
-    fn new(module: &'a Module) -> Self {
+    fn new(module: &'a Module, checkpoint_interval: u32) -> Self {
         let mut builder = IrBuilder::new(module.pools.clone());
         builder.set_insert_point(module.entry.first);
         let locally_defined_nodes = HashSet::from_iter(module.collect_nodes());
         Self {
             intermediate: IndexMap::new(),
+            recompute: IndexSet::new(),
+            checkpoint_interval,
+            recomputable_count: 0,
             intermediate_to_node: IndexMap::new(),
             grads: IndexMap::new(),
             module,
@@ -254,8 +286,34 @@ impl<'a> StoreIntermediate<'a> {
         let grad = self.builder.local_zero_init(node.type_().clone());
         self.grads.insert(node, grad);
     }
+    fn is_recomputable(&self, node: NodeRef) -> bool {
+        match node.get().instruction.as_ref() {
+            Instruction::Const(_) => true,
+            Instruction::Call(func, args) => {
+                is_recomputable_func(func) && args.as_ref().iter().all(|a| !a.is_local())
+            }
+            _ => false,
+        }
+    }
+    // decides whether a locally defined node is checkpointed (stored) or recomputed
+    fn should_recompute(&mut self, node: NodeRef) -> bool {
+        if self.checkpoint_interval == 1 || !self.is_recomputable(node) {
+            return false;
+        }
+        self.recomputable_count += 1;
+        self.checkpoint_interval == 0 || self.recomputable_count % self.checkpoint_interval != 0
+    }
     fn create_intermediate(&mut self, node: NodeRef) {
-        if self.intermediate.contains_key(&node) {
+        if self.intermediate.contains_key(&node) || self.recompute.contains(&node) {
+            return;
+        }
+        if self.locally_defined_nodes.contains(&node) && self.should_recompute(node) {
+            self.recompute.insert(node);
+            if let Instruction::Call(_, args) = node.get().instruction.as_ref() {
+                for a in args.as_ref() {
+                    self.create_intermediate(*a);
+                }
+            }
             return;
         }
         // {
@@ -410,6 +468,9 @@ struct Backward {
     pools: CArc<ModulePools>,
     grads: IndexMap<NodeRef, NodeRef>,
     intermediate: IndexMap<NodeRef, NodeRef>,
+    recompute: IndexSet<NodeRef>,
+    // recomputed nodes visible in the current backward block, one frame per nested block
+    recomputed: Vec<HashMap<NodeRef, NodeRef>>,
     intermediate_to_node: IndexMap<NodeRef, NodeRef>,
     final_grad: IndexMap<NodeRef, usize>,
 }
@@ -1098,11 +1159,33 @@ impl Backward {
         let b_grad = builder.call(Func::Mul, &[out_grad_t, a], b.type_().clone());
         return (a_grad, b_grad);
     }
-    fn get_intermediate(&self, node: NodeRef) -> NodeRef {
-        self.intermediate
-            .get(&node)
-            .cloned()
-            .unwrap_or_else(|| panic!("{:?}", node.get().instruction))
+    fn get_intermediate(&mut self, node: NodeRef, builder: &mut IrBuilder) -> NodeRef {
+        if let Some(intermediate) = self.intermediate.get(&node) {
+            return *intermediate;
+        }
+        if !self.recompute.contains(&node) {
+            panic!("{:?}", node.get().instruction);
+        }
+        for frame in self.recomputed.iter().rev() {
+            if let Some(recomputed) = frame.get(&node) {
+                return *recomputed;
+            }
+        }
+        let recomputed = match node.get().instruction.as_ref() {
+            Instruction::Const(c) => builder.const_(c.clone()),
+            Instruction::Call(func, args) => {
+                let args = args
+                    .as_ref()
+                    .iter()
+                    .map(|a| self.get_intermediate(*a, builder))
+                    .collect::<Vec<_>>();
+                builder.call(func.clone(), &args, node.type_().clone())
+            }
+            _ => unreachable!("{:?} is not recomputable", node.get().instruction),
+        };
+        self.intermediate_to_node.insert(recomputed, node);
+        self.recomputed.last_mut().unwrap().insert(node, recomputed);
+        recomputed
     }
     fn backward(&mut self, node: NodeRef, builder: &mut IrBuilder) {
         let instruction = &node.get().instruction;
@@ -1142,9 +1225,9 @@ impl Backward {
                 let args = args
                     .as_ref()
                     .iter()
-                    .map(|a| self.get_intermediate(*a))
+                    .map(|a| self.get_intermediate(*a, builder))
                     .collect::<Vec<_>>();
-                let node = self.get_intermediate(node);
+                let node = self.get_intermediate(node, builder);
                 let out_grad = out_grad.unwrap();
                 match func {
                     Func::Add => {
@@ -1701,7 +1784,7 @@ impl Backward {
                 true_branch,
                 false_branch,
             } => {
-                let cond = self.get_intermediate(*cond);
+                let cond = self.get_intermediate(*cond, builder);
                 let true_branch =
                     self.backward_block(true_branch, IrBuilder::new(self.pools.clone()));
                 let false_branch =
@@ -1713,7 +1796,7 @@ impl Backward {
                 cases,
                 default,
             } => {
-                let value = self.get_intermediate(*value);
+                let value = self.get_intermediate(*value, builder);
                 let cases = cases
                     .as_ref()
                     .iter()
@@ -1735,14 +1818,16 @@ impl Backward {
         }
     }
     fn backward_block(&mut self, block: &BasicBlock, mut builder: IrBuilder) -> Pooled<BasicBlock> {
+        self.recomputed.push(HashMap::new());
         for node in block.nodes().iter().rev() {
             self.backward(*node, &mut builder);
         }
-
+        self.recomputed.pop();
         builder.finish()
     }
     fn run(&mut self, block: &BasicBlock) -> Pooled<BasicBlock> {
         let mut builder = IrBuilder::new(self.pools.clone());
+        self.recomputed.push(HashMap::new());
         for node in block.nodes().iter().rev() {
             self.backward(*node, &mut builder);
         }
@@ -1768,17 +1853,18 @@ impl Backward {
 }
 
 pub struct Autodiff;
-fn ad_transform_block(module: crate::ir::Module) -> crate::ir::Module {
+fn ad_transform_block(module: crate::ir::Module, checkpoint_interval: u32) -> crate::ir::Module {
     assert!(
         module.kind == crate::ir::ModuleKind::Block,
         "ad_transform_block should be applied to a block"
     );
-    let mut store = StoreIntermediate::new(&module);
+    let mut store = StoreIntermediate::new(&module, checkpoint_interval);
     store.run();
     let StoreIntermediate {
         grads,
         final_grad,
         intermediate,
+        recompute,
         intermediate_to_node,
         // backward_reachable,
         // forward_reachable,
@@ -1790,6 +1876,8 @@ fn ad_transform_block(module: crate::ir::Module) -> crate::ir::Module {
         grads,
         final_grad,
         intermediate,
+        recompute,
+        recomputed: Vec::new(),
         intermediate_to_node,
         pools: module.pools.clone(),
     };
@@ -1813,7 +1901,10 @@ fn ad_transform_block(module: crate::ir::Module) -> crate::ir::Module {
 fn ad_transform_recursive(block: Pooled<BasicBlock>, pools: &CArc<ModulePools>) {
     for node in block.iter() {
         match node.get().instruction.as_ref() {
-            Instruction::AdScope { body } => {
+            Instruction::AdScope {
+                body,
+                checkpoint_interval,
+            } => {
                 let ad_block = Module {
                     kind: ModuleKind::Block,
                     entry: body.clone(),
@@ -1840,7 +1931,7 @@ fn ad_transform_recursive(block: Pooled<BasicBlock>, pools: &CArc<ModulePools>)
                 });
                 let epilogue = body.split(backward, pools);
                 backward.remove();
-                let ad_block = ad_transform_block(ad_block);
+                let ad_block = ad_transform_block(ad_block, *checkpoint_interval);
                 assert_eq!(ad_block.entry.ptr, body.ptr);
                 body.merge(epilogue);
             }
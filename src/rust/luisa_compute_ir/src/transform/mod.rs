@@ -5,6 +5,7 @@ pub mod ssa;
 pub mod vectorize;
 pub mod eval;
 pub mod ref2ret;
+pub mod aggregate_atomics;
 
 pub mod reg2mem;
 
@@ -29,6 +30,9 @@ impl TransformPipeline {
 }
 impl Transform for TransformPipeline {
     fn transform(&self, module: ir::Module) -> ir::Module {
+        if !self.transforms.is_empty() {
+            ir::detach_callables(&module);
+        }
         let mut module = module;
         for transform in &self.transforms {
             module = transform.transform(module);
@@ -76,6 +80,10 @@ pub extern "C" fn luisa_compute_ir_transform_pipeline_add_transform(
             let transform = reg2mem::Reg2Mem;
             unsafe { (*pipeline).add_transform(Box::new(transform)) };
         }
+        "aggregate_atomics" => {
+            let transform = aggregate_atomics::AggregateAtomics;
+            unsafe { (*pipeline).add_transform(Box::new(transform)) };
+        }
         _ => panic!("unknown transform {}", name),
     }
 }
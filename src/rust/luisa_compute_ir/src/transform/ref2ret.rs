@@ -202,7 +202,7 @@ impl Ref2RetImpl {
                     }
                     self.transform_block(default);
                 }
-                Instruction::AdScope { body } => {
+                Instruction::AdScope { body, .. } => {
                     self.transform_block(body)
                 }
                 Instruction::RayQuery { on_triangle_hit, on_procedural_hit, .. } => {
@@ -79,7 +79,7 @@ impl Reg2MemImpl {
                     }
                     self.transform_recursive(default);
                 }
-                Instruction::AdScope { body } => {
+                Instruction::AdScope { body, .. } => {
                     self.transform_recursive(body);
                 }
                 Instruction::RayQuery { ray_query: _, on_triangle_hit, on_procedural_hit } => {
@@ -137,7 +137,7 @@ impl Reg2MemImpl {
                     }
                     self.collect_phi_and_local_nodes(default);
                 }
-                Instruction::AdScope { body } => {
+                Instruction::AdScope { body, .. } => {
                     self.collect_phi_and_local_nodes(body);
                 }
                 Instruction::RayQuery { ray_query: _, on_triangle_hit, on_procedural_hit } => {
@@ -172,6 +172,10 @@ impl Validator {
                         assert!(args.is_empty());
                         assert_eq!(type_, uvec3_ty);
                     }
+                    Func::KernelId => {
+                        assert!(args.is_empty());
+                        assert_eq!(type_, <u32 as TypeOf>::type_());
+                    }
                     Func::RequiresGradient => {
                         assert_eq!(args.len(), 1);
                         // assert!(grad_type_of(args[0].type_()).is_some());
@@ -427,6 +431,15 @@ impl Validator {
                     Func::AtomicFetchXor => todo!(),
                     Func::AtomicFetchMin => todo!(),
                     Func::AtomicFetchMax => todo!(),
+                    Func::AtomicExchangeExplicit => todo!(),
+                    Func::AtomicCompareExchangeExplicit => todo!(),
+                    Func::AtomicFetchAddExplicit => todo!(),
+                    Func::AtomicFetchSubExplicit => todo!(),
+                    Func::AtomicFetchAndExplicit => todo!(),
+                    Func::AtomicFetchOrExplicit => todo!(),
+                    Func::AtomicFetchXorExplicit => todo!(),
+                    Func::AtomicFetchMinExplicit => todo!(),
+                    Func::AtomicFetchMaxExplicit => todo!(),
                     Func::BufferRead => todo!(),
                     Func::BufferWrite => todo!(),
                     Func::BufferSize => todo!(),
@@ -74,7 +74,16 @@ impl UsageDetector {
                     | crate::ir::Func::AtomicFetchOr
                     | crate::ir::Func::AtomicFetchXor
                     | crate::ir::Func::AtomicFetchMin
-                    | crate::ir::Func::AtomicFetchMax => {
+                    | crate::ir::Func::AtomicFetchMax
+                    | crate::ir::Func::AtomicExchangeExplicit
+                    | crate::ir::Func::AtomicCompareExchangeExplicit
+                    | crate::ir::Func::AtomicFetchAddExplicit
+                    | crate::ir::Func::AtomicFetchSubExplicit
+                    | crate::ir::Func::AtomicFetchAndExplicit
+                    | crate::ir::Func::AtomicFetchOrExplicit
+                    | crate::ir::Func::AtomicFetchXorExplicit
+                    | crate::ir::Func::AtomicFetchMinExplicit
+                    | crate::ir::Func::AtomicFetchMaxExplicit => {
                         for (index, arg) in args.as_ref().iter().enumerate() {
                             self.mark(*arg, UsageMark::READ);
                             if index == 0 {
@@ -159,7 +168,7 @@ impl UsageDetector {
                 }
                 self.detect_block(default);
             }
-            crate::ir::Instruction::AdScope { body } => {
+            crate::ir::Instruction::AdScope { body, .. } => {
                 self.detect_block(body);
             }
             crate::ir::Instruction::AdDetach(block) => {
@@ -0,0 +1,57 @@
+import sys
+import time
+import numpy as np
+from luisa import *
+from luisa.types import *
+from luisa.buffer import is_host_visible
+init()
+
+n = 16 * 1024 * 1024
+buffer = Buffer(n, float)
+
+
+@func
+def scale(buf, s: float):
+    i = dispatch_id().x
+    buf.write(i, buf.read(i) * s)
+
+
+def measure(name, round_trip, repeats=20):
+    round_trip()  # compile & warm up
+    start = time.perf_counter()
+    for r in range(repeats):
+        round_trip()
+    elapsed = time.perf_counter() - start
+    print(f"{name}: {2 * repeats * buffer.bytesize / elapsed / 1e9:.2f} GB/s")
+
+
+data = np.random.rand(n).astype(np.float32)
+
+
+def copy_round_trip():
+    buffer.copy_from(data)
+    scale(buffer, 1.0, dispatch_size=n)
+    buffer.numpy()
+
+
+measure("copy", copy_round_trip)
+
+if is_host_visible():
+    def zero_copy_round_trip():
+        view = buffer.numpy(zero_copy=True)
+        view[:] = data
+        scale(buffer, 1.0, dispatch_size=n)
+        buffer.numpy(zero_copy=True)
+
+    measure("zero copy", zero_copy_round_trip)
+    view = np.from_dlpack(buffer)
+    assert np.allclose(view, data)
+    view[0] = 42.0
+    assert buffer.to_list()[0] == 42.0
+    if sys.version_info >= (3, 12):
+        assert memoryview(buffer).nbytes == buffer.bytesize
+    try:
+        import torch
+        assert torch.from_dlpack(buffer).data_ptr() == buffer.native_handle
+    except ImportError:
+        pass
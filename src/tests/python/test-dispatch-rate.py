@@ -0,0 +1,37 @@
+import time
+from luisa import *
+from luisa.types import *
+init()
+
+n = 256
+buffer = Buffer(n, float)
+
+
+@func
+def step(dst, scale: float, offset: int):
+    i = dispatch_id().x
+    dst.write(i, float(i + offset) * scale)
+
+
+def measure(name, dispatch, repeats=20000):
+    dispatch(0)  # compile & warm up
+    synchronize()
+    start = time.perf_counter()
+    for r in range(repeats):
+        dispatch(r)
+    synchronize()
+    elapsed = time.perf_counter() - start
+    print(f"{name}: {repeats / elapsed:.0f} dispatches/s")
+
+
+measure("func.__call__", lambda r: step(buffer, 0.5, r, dispatch_size=n))
+launch = step.launcher(buffer, 0.5, 0)
+measure("func.launcher", lambda r: launch(buffer, 0.5, r, dispatch_size=n))
+
+# a mismatched argument raises instead of aborting the interpreter
+try:
+    launch(buffer, 1, 0, dispatch_size=n)
+except TypeError as e:
+    print(f"mismatched argument rejected: {e}")
+else:
+    raise AssertionError("a mismatched argument type was accepted")
@@ -0,0 +1,112 @@
+#include <array>
+#include <thread>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/thread_pool.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/ir/ast2ir.h>
+#include <luisa/ir/transform.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend> [callables = 64]. <backend>: cpu", argv[0]);
+        exit(1);
+    }
+    auto callable_count = argc > 2 ? static_cast<uint>(std::atoi(argv[2])) : 64u;
+    LUISA_ASSERT(callable_count > 1u, "Invalid arguments.");
+
+    // two levels of distinct callables: every outer one calls two inner ones
+    luisa::vector<Callable<uint(uint)>> inner;
+    inner.reserve(callable_count);
+    for (auto c = 0u; c < callable_count; c++) {
+        inner.emplace_back([c](UInt x) noexcept {
+            auto y = def(x * (c + 1u) + c);
+            $if (y % 3u == 0u) { y += c; };
+            return y;
+        });
+    }
+    luisa::vector<Callable<uint(uint)>> outer;
+    outer.reserve(callable_count);
+    for (auto c = 0u; c < callable_count; c++) {
+        outer.emplace_back([&inner, c, callable_count](UInt x) noexcept {
+            return inner[c](x) ^ inner[(c + 1u) % callable_count](x + c);
+        });
+    }
+    Kernel1D kernel = [&](BufferUInt buffer) noexcept {
+        auto i = dispatch_x();
+        auto sum = def(0u);
+        for (auto &&c : outer) { sum += c(i); }
+        buffer.write(i, sum);
+    };
+    auto function = kernel.function()->function();
+
+    // with a single cache entry, every inner callable is evicted before the outer
+    // ones calling it are converted, which must not lose it
+    ThreadPool pool;
+    AST2IR::set_callable_cache_capacity(1u);
+    for (auto p : {static_cast<ThreadPool *>(nullptr), &pool}) {
+        AST2IR::clear_callable_cache();
+        auto m = AST2IR::build_kernel(function, p);
+        LUISA_ASSERT(m != nullptr, "Conversion failed.");
+    }
+
+    // many threads convert the kernel at once, each on a shared pool, through a
+    // callable cache small enough to evict while they run
+    AST2IR::clear_callable_cache();
+    AST2IR::set_callable_cache_capacity(callable_count / 2u);
+    Clock clock;
+    luisa::vector<std::thread> threads;
+    for (auto t = 0u; t < 8u; t++) {
+        threads.emplace_back([&] {
+            for (auto round = 0u; round < 4u; round++) {
+                auto m = AST2IR::build_kernel(function, &pool);
+                LUISA_ASSERT(m != nullptr, "Conversion failed.");
+            }
+        });
+    }
+    for (auto &&t : threads) { t.join(); }
+    LUISA_INFO("Converted a kernel with {} callables 32 times concurrently in {:.2f} ms.",
+               callable_count * 2u, clock.toc());
+    AST2IR::set_callable_cache_capacity(4096u);
+
+    // transforms work on copies, so they do not disturb the cached callables
+    static_cast<void>(transform_kernel(function, std::array{"reg2mem"}));
+
+    // the device converts the kernel on its own pool
+    auto expected = [&](uint x) noexcept {
+        auto f = [](uint c, uint x) noexcept {
+            auto y = x * (c + 1u) + c;
+            if (y % 3u == 0u) { y += c; }
+            return y;
+        };
+        auto sum = 0u;
+        for (auto c = 0u; c < callable_count; c++) {
+            sum += f(c, x) ^ f((c + 1u) % callable_count, x + c);
+        }
+        return sum;
+    };
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+    auto shader = device.compile(kernel);
+    Buffer<uint> buffer = device.create_buffer<uint>(1024u);
+    luisa::vector<uint> result(1024u);
+    stream << shader(buffer).dispatch(1024u)
+           << buffer.copy_to(result.data())
+           << synchronize();
+    for (auto i = 0u; i < result.size(); i++) {
+        LUISA_ASSERT(result[i] == expected(i), "Mismatch at {}: expected {}, got {}.",
+                     i, expected(i), result[i]);
+    }
+    LUISA_INFO("Results match.");
+}
@@ -0,0 +1,108 @@
+#include <numeric>
+#include <algorithm>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/sugar.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend> [bins = 4] [passes = 16]. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    auto bin_count = argc > 2 ? static_cast<uint>(std::atoi(argv[2])) : 4u;
+    auto pass_count = argc > 3 ? static_cast<uint>(std::atoi(argv[3])) : 16u;
+    LUISA_ASSERT(bin_count > 0u && pass_count > 0u, "Invalid arguments.");
+
+    static constexpr auto n = 4u * 1024u * 1024u;
+
+    // every thread hits one of a few hot bins
+    Kernel1D histogram_kernel = [bin_count](BufferUInt bins) noexcept {
+        auto bin = dispatch_x() % bin_count;
+        bins.atomic(bin).fetch_add(1u);
+    };
+    // every other thread appends its index to a queue
+    Kernel1D append_kernel = [](BufferUInt tail, BufferUInt queue) noexcept {
+        auto i = dispatch_x();
+        $if (i % 2u == 0u) {
+            auto slot = tail.atomic(0u).fetch_add(1u);
+            queue.write(slot, i);
+        };
+    };
+
+    Stream stream = device.create_stream();
+    Buffer<uint> bins = device.create_buffer<uint>(bin_count);
+    Buffer<uint> tail = device.create_buffer<uint>(1u);
+    Buffer<uint> queue = device.create_buffer<uint>(n / 2u);
+    luisa::vector<uint> host_bins(bin_count);
+    luisa::vector<uint> host_queue(n / 2u);
+    // the per-bin counts of each mode, which aggregation must not change
+    luisa::vector<uint> mode_bins[2];
+
+    for (auto aggregate : {false, true}) {
+        ShaderOption option{.enable_atomic_aggregation = aggregate};
+        auto histogram = device.compile(histogram_kernel, option);
+        auto append = device.compile(append_kernel, option);
+        auto mode = aggregate ? "aggregated" : "per-thread";
+
+        // warm up
+        std::fill(host_bins.begin(), host_bins.end(), 0u);
+        stream << bins.copy_from(host_bins.data())
+               << histogram(bins).dispatch(n)
+               << synchronize();
+        Clock clock;
+        for (auto p = 0u; p < pass_count; p++) { stream << histogram(bins).dispatch(n); }
+        stream << synchronize();
+        auto ms = clock.toc();
+        stream << bins.copy_to(host_bins.data()) << synchronize();
+        auto total = std::accumulate(host_bins.cbegin(), host_bins.cend(), static_cast<size_t>(0u));
+        LUISA_INFO("Histogram ({}, {} bin(s)): {:.3f} ms/pass.", mode, bin_count, ms / pass_count);
+        LUISA_ASSERT(total == static_cast<size_t>(n) * (pass_count + 1u), "Histogram is incorrect.");
+        for (auto b = 0u; b < bin_count; b++) {
+            auto expected = (n / bin_count + (b < n % bin_count ? 1u : 0u)) * (pass_count + 1u);
+            LUISA_ASSERT(host_bins[b] == expected, "Histogram ({}) bin {} is incorrect: expected {}, got {}.",
+                         mode, b, expected, host_bins[b]);
+        }
+        mode_bins[aggregate] = host_bins;
+
+        uint zero = 0u;
+        stream << tail.copy_from(&zero)
+               << append(tail, queue).dispatch(n)
+               << synchronize();
+        clock.tic();
+        for (auto p = 0u; p < pass_count; p++) {
+            stream << tail.copy_from(&zero)
+                   << append(tail, queue).dispatch(n);
+        }
+        stream << synchronize();
+        ms = clock.toc();
+        uint host_tail = 0u;
+        stream << tail.copy_to(&host_tail)
+               << queue.copy_to(host_queue.data())
+               << synchronize();
+        LUISA_INFO("Queue append ({}): {:.3f} ms/pass.", mode, ms / pass_count);
+        LUISA_ASSERT(host_tail == n / 2u, "Queue size is incorrect.");
+        // each slot must be claimed by exactly one thread
+        std::sort(host_queue.begin(), host_queue.end());
+        for (auto i = 0u; i < n / 2u; i++) {
+            LUISA_ASSERT(host_queue[i] == i * 2u, "Queue is incorrect.");
+        }
+    }
+    for (auto b = 0u; b < bin_count; b++) {
+        LUISA_ASSERT(mode_bins[0][b] == mode_bins[1][b],
+                     "Histogram bin {} differs between modes: {} (per-thread) vs. {} (aggregated).",
+                     b, mode_bins[0][b], mode_bins[1][b]);
+    }
+}
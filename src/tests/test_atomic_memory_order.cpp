@@ -0,0 +1,73 @@
+#include <numeric>
+
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/sugar.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+
+    static constexpr auto n = 1024u * 1024u;
+
+    // every thread publishes a partial value and the last one to arrive sums them up,
+    // which relies on the acquire-release counter to see the values of the others
+    Kernel1D reduce_kernel = [](BufferUInt partials, BufferUInt arrived, BufferUInt result) noexcept {
+        auto i = dispatch_x();
+        partials.write(i, i % 7u);
+        auto count = arrived.atomic(0u).fetch_add(1u, MemoryOrder::ACQ_REL);
+        $if (count == n - 1u) {
+            auto sum = def(0u);
+            $for (j, n) { sum += partials.read(j); };
+            result.atomic(0u).exchange(sum, MemoryOrder::RELAXED);
+        };
+    };
+    // statistics counters need no ordering at all
+    Kernel1D count_kernel = [](BufferUInt counters) noexcept {
+        auto i = dispatch_x();
+        counters.atomic(i % 4u).fetch_add(1u, MemoryOrder::RELAXED);
+        counters.atomic(4u).fetch_max(i, MemoryOrder::RELAXED);
+    };
+
+    Stream stream = device.create_stream();
+    auto reduce = device.compile(reduce_kernel);
+    auto count = device.compile(count_kernel);
+    Buffer<uint> partials = device.create_buffer<uint>(n);
+    Buffer<uint> arrived = device.create_buffer<uint>(1u);
+    Buffer<uint> result = device.create_buffer<uint>(1u);
+    Buffer<uint> counters = device.create_buffer<uint>(5u);
+
+    uint zero = 0u;
+    uint host_result = 0u;
+    luisa::vector<uint> host_counters(5u, 0u);
+    stream << arrived.copy_from(&zero)
+           << result.copy_from(&zero)
+           << reduce(partials, arrived, result).dispatch(n)
+           << result.copy_to(&host_result)
+           << counters.copy_from(host_counters.data())
+           << count(counters).dispatch(n)
+           << counters.copy_to(host_counters.data())
+           << synchronize();
+
+    auto expected = 0u;
+    for (auto i = 0u; i < n; i++) { expected += i % 7u; }
+    LUISA_INFO("Reduced: {} (expected {}).", host_result, expected);
+    LUISA_ASSERT(host_result == expected, "Reduction is incorrect.");
+    for (auto i = 0u; i < 4u; i++) {
+        LUISA_ASSERT(host_counters[i] == n / 4u, "Counter #{} is incorrect.", i);
+    }
+    LUISA_ASSERT(host_counters[4] == n - 1u, "Maximum is incorrect.");
+}
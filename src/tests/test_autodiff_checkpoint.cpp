@@ -0,0 +1,108 @@
+#include <random>
+#include <luisa/luisa-compute.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+// total size of the local variables in a block, an upper bound of the
+// per-thread local memory (the autodiff transform stores intermediates in locals)
+[[nodiscard]] size_t local_bytes(const ir::BasicBlock *block) noexcept {
+    auto bytes = static_cast<size_t>(0u);
+    for (auto node_ref = block->first; node_ref != ir::INVALID_REF;) {
+        auto node = ir::luisa_compute_ir_node_get(node_ref);
+        auto instr = node->instruction.get();
+        switch (instr->tag) {
+            case ir::Instruction::Tag::Local:
+                bytes += ir::luisa_compute_ir_type_size(&node->type_);
+                break;
+            case ir::Instruction::Tag::If:
+                bytes += local_bytes(instr->if_.true_branch.get());
+                bytes += local_bytes(instr->if_.false_branch.get());
+                break;
+            case ir::Instruction::Tag::Loop:
+                bytes += local_bytes(instr->loop.body.get());
+                break;
+            case ir::Instruction::Tag::AdScope:
+                bytes += local_bytes(instr->ad_scope.body.get());
+                break;
+            default: break;
+        }
+        node_ref = node->next;
+    }
+    return bytes;
+}
+
+int main(int argc, char *argv[]) {
+
+    luisa::log_level_info();
+
+    auto context = Context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    auto device = context.create_device(argv[1]);
+    auto stream = device.create_stream();
+
+    static constexpr auto n = 1024u * 1024u;
+    static constexpr auto depth = 256u;
+    static constexpr auto repeats = 8u;
+
+    auto rng = std::mt19937{std::random_device{}()};
+    auto dist = std::uniform_real_distribution<float>{-1.0f, 1.0f};
+    luisa::vector<float> input_data(n);
+    for (auto &&x : input_data) { x = dist(rng); }
+    auto input = device.create_buffer<float>(n);
+    auto grad_buffer = device.create_buffer<float>(n);
+    stream << input.copy_from(input_data.data()) << synchronize();
+
+    luisa::vector<float> reference;
+    for (auto interval : {1u, 2u, 8u, 32u, 0u}) {
+        Kernel1D kernel = [&] {
+            auto i = dispatch_x();
+            auto x = def(input->read(i));
+            $autodiff_checkpoint(interval) {
+                requires_grad(x);
+                auto v = def(x);
+                for (auto d = 0u; d < depth; d++) {
+                    v = sin(v) * 0.9f + v * v * 0.1f;
+                }
+                backward(v);
+                grad_buffer->write(i, grad(x));
+            };
+        };
+
+        // measure the locals introduced by the autodiff transform
+        auto m = AST2IR::build_kernel(kernel.function()->function());
+        auto pipeline = ir::luisa_compute_ir_transform_pipeline_new();
+        ir::luisa_compute_ir_transform_pipeline_add_transform(pipeline, "autodiff");
+        auto module = ir::luisa_compute_ir_transform_pipeline_transform(pipeline, m->get()->module);
+        ir::luisa_compute_ir_transform_pipeline_destroy(pipeline);
+        auto bytes = local_bytes(module.entry.get());
+
+        Clock clk;
+        auto shader = device.compile(kernel);
+        auto compile_time = clk.toc();
+        stream << shader().dispatch(n) << synchronize();
+        clk.tic();
+        for (auto r = 0u; r < repeats; r++) {
+            stream << shader().dispatch(n);
+        }
+        stream << synchronize();
+        auto run_time = clk.toc() / repeats;
+
+        luisa::vector<float> grads(n);
+        stream << grad_buffer.copy_to(grads.data()) << synchronize();
+        auto max_error = 0.0f;
+        if (reference.empty()) {
+            reference = grads;
+        } else {
+            for (auto i = 0u; i < n; i++) {
+                max_error = std::max(max_error, std::abs(grads[i] - reference[i]));
+            }
+        }
+        LUISA_INFO("checkpoint interval {:>2}: local memory = {:>6} bytes/thread, "
+                   "compile = {:.2f} ms, run = {:.3f} ms, max error = {}",
+                   interval, bytes, compile_time, run_time, max_error);
+    }
+}
@@ -0,0 +1,104 @@
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/backends/ext/cpu_config_ext.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend> [MiB per buffer = 1024] [passes = 10] [cpu memory options]. "
+                   "<backend>: cuda, dx, cpu, metal. "
+                   "<cpu memory options>: any of thp, hugetlb, interleaved, first-touch, pin.",
+                   argv[0]);
+        exit(1);
+    }
+    auto mib = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 1024u;
+    auto pass_count = argc > 3 ? static_cast<uint>(std::atoi(argv[3])) : 10u;
+    LUISA_ASSERT(mib > 0u && pass_count > 0u, "Invalid arguments.");
+
+    DeviceConfig config;
+    if (luisa::string_view{argv[1]} == "cpu") {
+        auto ext = luisa::make_unique<CPUDeviceConfigExt>();
+        for (auto i = 4; i < argc; i++) {
+            luisa::string_view option{argv[i]};
+            if (option == "thp") {
+                ext->huge_pages = CPUDeviceConfigExt::HugePages::TRANSPARENT;
+            } else if (option == "hugetlb") {
+                ext->huge_pages = CPUDeviceConfigExt::HugePages::EXPLICIT;
+            } else if (option == "interleaved") {
+                ext->placement = CPUDeviceConfigExt::Placement::INTERLEAVED;
+            } else if (option == "first-touch") {
+                ext->placement = CPUDeviceConfigExt::Placement::FIRST_TOUCH;
+            } else if (option == "pin") {
+                ext->pin_workers = true;
+            } else {
+                LUISA_ERROR_WITH_LOCATION("Unknown memory option '{}'.", option);
+            }
+        }
+        config.extension = std::move(ext);
+    }
+    Device device = context.create_device(argv[1], &config);
+    Stream stream = device.create_stream();
+
+    auto n = static_cast<uint>(mib * 1024u * 1024u / sizeof(float4));
+    Buffer<float4> a = device.create_buffer<float4>(n);
+    Buffer<float4> b = device.create_buffer<float4>(n);
+    Buffer<float4> c = device.create_buffer<float4>(n);
+
+    // the buffers are first written by a dispatch, so that they are placed by its workers
+    Kernel1D fill_kernel = [](BufferFloat4 b, BufferFloat4 c) noexcept {
+        auto i = dispatch_id().x;
+        auto x = cast<float>(i % 1024u);
+        b.write(i, make_float4(x));
+        c.write(i, make_float4(1.f, 2.f, 3.f, 4.f));
+    };
+    Kernel1D copy_kernel = [](BufferFloat4 dst, BufferFloat4 src) noexcept {
+        auto i = dispatch_id().x;
+        dst.write(i, src.read(i));
+    };
+    Kernel1D triad_kernel = [](BufferFloat4 a, BufferFloat4 b, BufferFloat4 c, Float s) noexcept {
+        auto i = dispatch_id().x;
+        a.write(i, b.read(i) + s * c.read(i));
+    };
+    auto fill = device.compile(fill_kernel);
+    auto copy = device.compile(copy_kernel);
+    auto triad = device.compile(triad_kernel);
+
+    Clock clock;
+    stream << fill(b, c).dispatch(n) << synchronize();
+    LUISA_INFO("First touch of {} MiB: {:.2f} ms.", mib * 2u, clock.toc());
+
+    auto bytes = static_cast<double>(n) * sizeof(float4);
+    auto measure = [&](luisa::string_view name, auto &&command, double traffic) noexcept {
+        // warm up
+        stream << command() << synchronize();
+        clock.tic();
+        for (auto pass = 0u; pass < pass_count; pass++) { stream << command(); }
+        stream << synchronize();
+        auto ms = clock.toc() / pass_count;
+        LUISA_INFO("{}: {:.3f} ms/pass, {:.2f} GB/s.", name, ms, traffic * bytes * 1e-6 / ms);
+    };
+    measure("Copy", [&] { return copy(a, b).dispatch(n); }, 2.);
+    measure("Triad", [&] { return triad(a, b, c, 2.f).dispatch(n); }, 3.);
+
+    // spot-check the triad against the fill pattern
+    luisa::vector<float4> host(1024u);
+    for (auto offset : {size_t{0u}, static_cast<size_t>(n / 2u / 1024u) * 1024u, static_cast<size_t>(n - 1024u)}) {
+        stream << a.view(offset, 1024u).copy_to(host.data()) << synchronize();
+        for (auto i = 0u; i < 1024u; i++) {
+            auto x = static_cast<float>((offset + i) % 1024u);
+            auto expected = make_float4(x) + 2.f * make_float4(1.f, 2.f, 3.f, 4.f);
+            LUISA_ASSERT(all(host[i] == expected), "Triad mismatch at element {}: expected {}, got {}.",
+                         offset + i, expected, host[i]);
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#include <cstdlib>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/dsl/syntax.h>
+
+#ifdef LUISA_CODEGEN_BENCHMARK_CUDA
+#include "../backends/cuda/cuda_codegen_ast.h"
+#endif
+
+#ifdef LUISA_CODEGEN_BENCHMARK_METAL
+#include "../backends/metal/metal_codegen_ast.h"
+#endif
+
+#ifdef LUISA_CODEGEN_BENCHMARK_HLSL
+#include "../backends/common/hlsl/hlsl_codegen.h"
+#endif
+
+using namespace luisa;
+using namespace luisa::compute;
+
+struct BenchmarkMaterial {
+    float3 albedo;
+    float roughness;
+    float4 params;
+    uint flags;
+};
+
+LUISA_STRUCT(BenchmarkMaterial, albedo, roughness, params, flags) {};
+
+// generates source for all kernels with a code generator, which returns the size
+// of the generated source; later passes reuse whatever the generator has cached
+template<typename F>
+static void benchmark(luisa::string_view name, luisa::span<const Function> kernels, uint passes, F &&codegen) noexcept {
+    for (auto pass = 0u; pass < passes; pass++) {
+        Clock clock;
+        auto bytes = static_cast<size_t>(0u);
+        for (auto kernel : kernels) { bytes += codegen(kernel); }
+        auto ms = clock.toc();
+        LUISA_INFO("{} codegen pass #{}: {} kernel(s), {:.2f} MB in {:.2f} ms "
+                   "({:.2f} ms/kernel, {:.2f} MB/s).",
+                   name, pass, kernels.size(), static_cast<double>(bytes) * 1e-6, ms,
+                   ms / static_cast<double>(kernels.size()),
+                   static_cast<double>(bytes) * 1e-3 / ms);
+    }
+}
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    // no device is created, the context is only for locating the built-in HLSL library
+    Context context{argv[0]};
+    for (auto i = 1; i < argc; i++) {
+        if (std::atoi(argv[i]) > 0) { continue; }
+        LUISA_INFO("Usage: {} [callables = 256] [statements = 32] [kernels = 8] [passes = 3]", argv[0]);
+        exit(1);
+    }
+    auto arg = [&](int index, uint default_value) noexcept {
+        return argc > index ? static_cast<uint>(std::atoi(argv[index])) : default_value;
+    };
+    auto callable_count = arg(1, 256u);
+    auto statement_count = arg(2, 32u);
+    auto kernel_count = arg(3, 8u);
+    auto pass_count = arg(4, 3u);
+
+    // synthetic megakernels sharing most of their callables, with plenty of literals
+    Clock clock;
+    luisa::vector<Callable<float3(float3, BenchmarkMaterial)>> callables;
+    callables.reserve(callable_count);
+    for (auto c = 0u; c < callable_count; c++) {
+        callables.emplace_back([c, statement_count](Float3 x, Var<BenchmarkMaterial> m) noexcept {
+            auto y = def(x);
+            for (auto s = 0u; s < statement_count; s++) {
+                auto k = static_cast<float>(c * statement_count + s);
+                $if (y.x > k * 0.1f) {
+                    y = sin(y * m.albedo + make_float3(k, .5f * k, .25f)) * m.roughness;
+                }
+                $else {
+                    y = fma(y, make_float3(1.f / (k + 1.f)), m.params.xyz());
+                };
+                $if ((m.flags & (1u << (s % 32u))) != 0u) {
+                    y = clamp(y, make_float3(-k), make_float3(k));
+                };
+            }
+            return y;
+        });
+    }
+    luisa::vector<luisa::shared_ptr<const detail::FunctionBuilder>> builders;
+    builders.reserve(kernel_count);
+    for (auto k = 0u; k < kernel_count; k++) {
+        Kernel1D kernel = [&callables, k, kernel_count](BufferFloat3 buffer, BufferVar<BenchmarkMaterial> materials) noexcept {
+            auto i = dispatch_x();
+            Float3 x = buffer.read(i);
+            Var<BenchmarkMaterial> m = materials.read(i);
+            for (auto c = 0u; c < callables.size(); c++) {
+                // each kernel skips a few callables so that they differ but share the rest
+                if ((c + k) % (kernel_count + 1u) != 0u) { x = callables[c](x, m); }
+            }
+            buffer.write(i, x + static_cast<float>(k));
+        };
+        builders.emplace_back(kernel.function());
+    }
+    luisa::vector<Function> kernels;
+    kernels.reserve(builders.size());
+    for (auto &&b : builders) { kernels.emplace_back(b->function()); }
+    LUISA_INFO("Traced {} kernel(s) with {} callable(s) of {} statement(s) in {:.2f} ms.",
+               kernel_count, callable_count, statement_count, clock.toc());
+
+#ifdef LUISA_CODEGEN_BENCHMARK_CUDA
+    benchmark("CUDA", kernels, pass_count, [](Function kernel) noexcept {
+        StringScratch scratch;
+        cuda::CUDACodegenAST codegen{scratch, false};
+        codegen.emit(kernel, {}, {});
+        return scratch.size();
+    });
+#endif
+
+#ifdef LUISA_CODEGEN_BENCHMARK_METAL
+    benchmark("Metal", kernels, pass_count, [](Function kernel) noexcept {
+        StringScratch scratch;
+        metal::MetalCodegenAST codegen{scratch};
+        codegen.emit(kernel, {});
+        return scratch.size();
+    });
+#endif
+
+#ifdef LUISA_CODEGEN_BENCHMARK_HLSL
+    benchmark("HLSL", kernels, pass_count, [](Function kernel) noexcept {
+        return lc::hlsl::CodegenUtility{}.Codegen(kernel, nullptr, {}, 0u, false).result.size();
+    });
+#endif
+}
@@ -0,0 +1,143 @@
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <luisa/luisa-compute.h>
+#include <luisa/backends/ext/cpu/lcub/lcub.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+using namespace luisa::compute::cpu::lcub;
+
+// checks the primitives against the standard library and compares their timings
+void device_radix_sort_test(Device &device, Stream &stream, uint n) {
+    std::mt19937 rng{42u};
+    luisa::vector<int> keys(n);
+    luisa::vector<int> values(n);
+    for (auto i = 0u; i < n; i++) {
+        keys[i] = static_cast<int>(rng());
+        values[i] = static_cast<int>(i);
+    }
+    auto d_keys_in = device.create_buffer<int>(n);
+    auto d_keys_out = device.create_buffer<int>(n);
+    auto d_values_in = device.create_buffer<int>(n);
+    auto d_values_out = device.create_buffer<int>(n);
+    size_t temp_storage_size = -1;
+    DeviceRadixSort::SortPairs(temp_storage_size, d_keys_in, d_keys_out, d_values_in, d_values_out, n);
+    auto temp_storage = device.create_buffer<int>(temp_storage_size);
+    stream << d_keys_in.copy_from(keys.data())
+           << d_values_in.copy_from(values.data())
+           << synchronize();
+
+    Clock clock;
+    stream << DeviceRadixSort::SortPairs(temp_storage, d_keys_in, d_keys_out, d_values_in, d_values_out, n)
+           << synchronize();
+    auto lcub_time = clock.toc();
+    luisa::vector<int> sorted_keys(n);
+    luisa::vector<int> sorted_values(n);
+    stream << d_keys_out.copy_to(sorted_keys.data())
+           << d_values_out.copy_to(sorted_values.data())
+           << synchronize();
+
+    auto expected = keys;
+    clock.tic();
+    std::sort(expected.begin(), expected.end());
+    auto std_time = clock.toc();
+    LUISA_INFO("DeviceRadixSort::SortPairs ({} items): {} ms, std::sort: {} ms", n, lcub_time, std_time);
+    LUISA_ASSERT(sorted_keys == expected, "DeviceRadixSort::SortPairs failed.");
+    for (auto i = 0u; i < n; i++) {
+        LUISA_ASSERT(keys[sorted_values[i]] == sorted_keys[i],
+                     "DeviceRadixSort::SortPairs failed at {}.", i);
+        LUISA_ASSERT(i == 0u || sorted_keys[i - 1u] != sorted_keys[i] ||
+                         sorted_values[i - 1u] < sorted_values[i],
+                     "DeviceRadixSort::SortPairs is not stable at {}.", i);
+    }
+}
+
+void device_scan_test(Device &device, Stream &stream, uint n) {
+    luisa::vector<uint> input(n);
+    std::iota(input.begin(), input.end(), 0u);
+    auto d_in = device.create_buffer<uint>(n);
+    auto d_out = device.create_buffer<uint>(n);
+    size_t temp_storage_size = -1;
+    DeviceScan::InclusiveSum(temp_storage_size, d_in, d_out, n);
+    auto temp_storage = device.create_buffer<int>(temp_storage_size);
+    stream << d_in.copy_from(input.data()) << synchronize();
+
+    Clock clock;
+    stream << DeviceScan::InclusiveSum(temp_storage, d_in, d_out, n)
+           << synchronize();
+    auto lcub_time = clock.toc();
+    luisa::vector<uint> output(n);
+    stream << d_out.copy_to(output.data()) << synchronize();
+
+    luisa::vector<uint> expected(n);
+    clock.tic();
+    std::inclusive_scan(input.begin(), input.end(), expected.begin());
+    auto std_time = clock.toc();
+    LUISA_INFO("DeviceScan::InclusiveSum ({} items): {} ms, std::inclusive_scan: {} ms", n, lcub_time, std_time);
+    LUISA_ASSERT(output == expected, "DeviceScan::InclusiveSum failed.");
+}
+
+void device_reduce_select_rle_test(Device &device, Stream &stream, uint n) {
+    std::mt19937 rng{7u};
+    luisa::vector<int> input(n);
+    for (auto i = 0u; i < n; i++) {
+        input[i] = i == 0u ? 0 : input[i - 1u] + static_cast<int>(rng() % 4u == 0u);
+    }
+    auto d_in = device.create_buffer<int>(n);
+    auto d_out = device.create_buffer<int>(n);
+    auto d_counts = device.create_buffer<int>(n);
+    auto d_count = device.create_buffer<int>(1u);
+    size_t max_size = -1, unique_size = -1, encode_size = -1;
+    DeviceReduce::Max(max_size, d_in, d_count, n);
+    DeviceSelect::Unique(unique_size, d_in, d_out, d_count, n);
+    DeviceRunLengthEncode::Encode(encode_size, d_in, d_out, d_counts, d_count, n);
+    auto temp_storage = device.create_buffer<int>(std::max({max_size, unique_size, encode_size}));
+    stream << d_in.copy_from(input.data());
+
+    int max = 0;
+    stream << DeviceReduce::Max(temp_storage, d_in, d_count, n)
+           << d_count.copy_to(&max)
+           << synchronize();
+    LUISA_ASSERT(max == input.back(), "DeviceReduce::Max failed.");
+
+    auto expected = input;
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    int count = 0;
+    luisa::vector<int> output(n);
+    stream << DeviceSelect::Unique(temp_storage, d_in, d_out, d_count, n)
+           << d_count.copy_to(&count)
+           << d_out.copy_to(output.data())
+           << synchronize();
+    LUISA_ASSERT(count == static_cast<int>(expected.size()) &&
+                     std::equal(expected.begin(), expected.end(), output.begin()),
+                 "DeviceSelect::Unique failed.");
+
+    luisa::vector<int> counts(n);
+    stream << DeviceRunLengthEncode::Encode(temp_storage, d_in, d_out, d_counts, d_count, n)
+           << d_count.copy_to(&count)
+           << d_out.copy_to(output.data())
+           << d_counts.copy_to(counts.data())
+           << synchronize();
+    LUISA_ASSERT(count == static_cast<int>(expected.size()) &&
+                     std::equal(expected.begin(), expected.end(), output.begin()),
+                 "DeviceRunLengthEncode::Encode failed.");
+    for (auto i = 0; i < count; i++) {
+        auto run = std::equal_range(input.begin(), input.end(), output[i]);
+        LUISA_ASSERT(counts[i] == run.second - run.first,
+                     "DeviceRunLengthEncode::Encode failed at {}.", i);
+    }
+    LUISA_INFO("DeviceReduce, DeviceSelect and DeviceRunLengthEncode passed.");
+}
+
+int main(int argc, char *argv[]) {
+    // cpu only
+    Context context{argv[0]};
+    Device device = context.create_device("cpu");
+    Stream stream = device.create_stream();
+    for (auto n : {100u, 1u << 20u, 1u << 24u}) {
+        device_radix_sort_test(device, stream, n);
+        device_scan_test(device, stream, n);
+        device_reduce_select_rle_test(device, stream, n);
+    }
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cmath>
 #include <luisa/core/clock.h>
 #include <luisa/core/logging.h>
 #include <luisa/runtime/context.h>
@@ -11,7 +12,6 @@
 #include "common/cornell_box.h"
 #include <stb/stb_image_write.h>
 #include <stb/stb_image.h>
-#include <luisa/gui/window.h>
 #include <luisa/backends/ext/denoiser_ext.h>
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "common/tiny_obj_loader.h"
@@ -20,6 +20,16 @@
 using namespace luisa;
 using namespace luisa::compute;
 
+#ifndef ENABLE_DISPLAY
+#ifdef LUISA_ENABLE_GUI
+#define ENABLE_DISPLAY 1
+#endif
+#endif
+
+#if ENABLE_DISPLAY
+#include <luisa/gui/window.h>
+#endif
+
 struct Material {
     float3 albedo;
     float3 emission;
@@ -44,20 +54,30 @@ int main(int argc, char *argv[]) {
     log_level_verbose();
 
     Context context{argv[0]};
-    Device device = context.create_device("cuda");
+    // e.g., "cpu headless" renders a few frames without a window and checks the denoised result
+    Device device = context.create_device(argc > 1 ? argv[1] : "cuda");
+#if ENABLE_DISPLAY
+    auto headless = argc > 2 && luisa::string_view{argv[2]} == "headless";
+#else
+    // there is no window to show the frames without the GUI module
+    constexpr auto headless = true;
+#endif
     auto denoiser_ext = device.extension<DenoiserExt>();
     auto resolution = make_uint2(1024u);
 
     //params
-    uint optix_examples = 1;//0:cornellbox pathtracing, 1:soane temporal example, 2:aovs example
+    uint optix_examples = headless ? 0 : 1;//0:cornellbox pathtracing, 1:soane temporal example, 2:aovs example
     //all for online cornell box
     bool seperate_usage = 1; //check the fullpipeline(denoise) or sperately call functions. the temporal denoise mode can only run when this is true
     bool temporal = 1;       // 1: add camera movement, 0: static camera and accumulate samples
     bool flow_validation = 0;// use when temporal on: 1: validation for the flow calculation, 0: normal
     auto channel_count = 4;  //processing buffer channel, for testing.
-    LUISA_INFO("{}",getenv("OPTIX_INCLUDE_DIR"));
-    luisa::filesystem::path optix= getenv("OPTIX_INCLUDE_DIR");
-    auto optix_path = optix.parent_path() / "SDK";//your optix sdk path, for finding the examples
+    luisa::filesystem::path optix_path;
+    if (optix_examples) {
+        LUISA_INFO("{}",getenv("OPTIX_INCLUDE_DIR"));
+        luisa::filesystem::path optix= getenv("OPTIX_INCLUDE_DIR");
+        optix_path = optix.parent_path() / "SDK";//your optix sdk path, for finding the examples
+    }
 
     if (optix_examples) {
         auto datapath = optix_path / "optixDenoiser" / "motiondata";
@@ -442,19 +462,36 @@ int main(int argc, char *argv[]) {
     cmd_list << clear_shader(accum_image).dispatch(resolution)
              << make_sampler_shader(seed_image).dispatch(resolution);
 
-    Window window{"path tracing", resolution};
-    auto swap_chain{device.create_swapchain(
-        window.native_handle(),
-        stream,
-        resolution,
-        false, false, 3)};
+#if ENABLE_DISPLAY
+    luisa::unique_ptr<Window> window;
+    Swapchain swap_chain;
+    if (!headless) {
+        window = luisa::make_unique<Window>("path tracing", resolution);
+        swap_chain = device.create_swapchain(
+            window->native_handle(),
+            stream,
+            resolution,
+            false, false, 3);
+    }
+    auto ldr_storage = headless ? PixelStorage::BYTE4 : swap_chain.backend_storage();
+#else
+    auto ldr_storage = PixelStorage::BYTE4;
+#endif
+    auto present = [&](ImageView<float> frame) noexcept {
+#if ENABLE_DISPLAY
+        if (!headless) {
+            stream << swap_chain.present(frame);
+            window->poll_events();
+        }
+#endif
+    };
     auto combined_image = device.create_image<float>(PixelStorage::FLOAT4, resolution);
     auto prev_image = device.create_image<float>(PixelStorage::FLOAT4, resolution);
     auto normal_image = device.create_image<float>(PixelStorage::FLOAT4, resolution);
     auto albedo_image = device.create_image<float>(PixelStorage::FLOAT4, resolution);
     auto hdr_image = device.create_image<float>(PixelStorage::FLOAT4, resolution);
     auto denoised_image = device.create_image<float>(PixelStorage::FLOAT4, resolution);
-    auto ldr_image = device.create_image<float>(swap_chain.backend_storage(), resolution);
+    auto ldr_image = device.create_image<float>(ldr_storage, resolution);
     auto flow_image = device.create_image<float>(PixelStorage::FLOAT4, resolution);
     auto glossy_image = device.create_image<float>(PixelStorage::FLOAT4, resolution);
     auto diffuse_image = device.create_image<float>(PixelStorage::FLOAT4, resolution);
@@ -518,12 +555,12 @@ int main(int argc, char *argv[]) {
                 denoiser_ext->process(stream, data);
                 denoiser_ext->get_result(stream, denoised_buffer);
                 cmd_list << buf_to_image(denoised_buffer, denoised_image, channel_count).dispatch(resolution);
-                cmd_list << hdr2ldr_shader(denoised_image, ldr_image, 0.001f, swap_chain.backend_storage() != PixelStorage::BYTE4).dispatch(resolution);
+                cmd_list << hdr2ldr_shader(denoised_image, ldr_image, 0.001f, ldr_storage != PixelStorage::BYTE4).dispatch(resolution);
                 stream << cmd_list.commit()
                        << denoised_image.copy_to(host_image.data())
                        << synchronize();
-                stream << cmd_list.commit() << swap_chain.present(ldr_image);
-                window.poll_events();
+                stream << cmd_list.commit();
+                present(ldr_image);
 
                 using namespace std::chrono_literals;
                 std::this_thread::sleep_for(400ms);
@@ -588,14 +625,14 @@ int main(int argc, char *argv[]) {
             auto save_image = [&](int index, const char *file_name) {
                 denoiser_ext->get_result(stream, denoised_buffer, index);
                 cmd_list << buf_to_image(denoised_buffer, denoised_image, channel_count).dispatch(resolution);
-                cmd_list << hdr2ldr_shader(denoised_image, ldr_image, 0.001f, swap_chain.backend_storage() != PixelStorage::BYTE4).dispatch(resolution);
+                cmd_list << hdr2ldr_shader(denoised_image, ldr_image, 0.001f, ldr_storage != PixelStorage::BYTE4).dispatch(resolution);
                 if (index >= 0)
                     cmd_list << accumulate_shader(accum_image, denoised_image).dispatch(resolution);
                 stream << cmd_list.commit()
                        << denoised_image.copy_to(host_image.data())
                        << synchronize();
-                stream << cmd_list.commit() << swap_chain.present(ldr_image);
-                window.poll_events();
+                stream << cmd_list.commit();
+                present(ldr_image);
                 using namespace std::chrono_literals;
                 std::this_thread::sleep_for(400ms);
                 SaveEXR(
@@ -620,8 +657,8 @@ int main(int argc, char *argv[]) {
                    << adjust(accum_image).dispatch(resolution)
                    << accum_image.copy_to(host_image.data())
                    << synchronize();
-            stream << cmd_list.commit() << swap_chain.present(ldr_image);
-            window.poll_events();
+            stream << cmd_list.commit();
+            present(ldr_image);
             using namespace std::chrono_literals;
             std::this_thread::sleep_for(400ms);
             SaveEXR(
@@ -657,8 +694,15 @@ int main(int argc, char *argv[]) {
              << image_to_buf(flow_image, flow_buffer, 4, channel_count).dispatch(resolution);
 
     uint state = 42u;
+    static constexpr auto headless_frame_count = 8u;
+    auto should_close = [&] {
+#if ENABLE_DISPLAY
+        if (!headless) { return window->should_close(); }
+#endif
+        return frame_count >= headless_frame_count;
+    };
 
-    while (!window.should_close()) {
+    while (!should_close()) {
         cmd_list << raytracing_shader(framebuffer, seed_image, accel, resolution, origin)
                         .dispatch(resolution)
                  << accumulate_shader(accum_image, framebuffer)
@@ -684,13 +728,15 @@ int main(int argc, char *argv[]) {
             cmd_list << buf_to_image(denoised_buffer, denoised_image, channel_count).dispatch(resolution);
         }
         cmd_list << combine_shader(hdr_image, denoised_image, combined_image).dispatch(resolution);
-        cmd_list << hdr2ldr_shader(combined_image, ldr_image, 1.0f, swap_chain.backend_storage() != PixelStorage::BYTE4).dispatch(resolution);
-        stream << cmd_list.commit() << swap_chain.present(ldr_image);
-        window.poll_events();
+        cmd_list << hdr2ldr_shader(combined_image, ldr_image, 1.0f, ldr_storage != PixelStorage::BYTE4).dispatch(resolution);
+        stream << cmd_list.commit();
+        present(ldr_image);
         auto dt = clock.toc() - last_time;
         frame_count += spp_per_dispatch;
-        using namespace std::chrono_literals;
-        std::this_thread::sleep_for(400ms);
+        if (!headless) {
+            using namespace std::chrono_literals;
+            std::this_thread::sleep_for(400ms);
+        }
         LUISA_INFO("time: {} ms", dt);
         last_time = clock.toc();
         if (temporal) {
@@ -716,5 +762,39 @@ int main(int argc, char *argv[]) {
            << synchronize();
 
     LUISA_INFO("FPS: {}", frame_count / clock.toc() * 1000);
+    if (headless && !flow_validation) {
+        // the denoised frame should keep the energy of the noisy one while being much smoother
+        std::vector<float> noisy(hdr_buffer.size());
+        std::vector<float> denoised(denoised_buffer.size());
+        stream << hdr_buffer.copy_to(noisy.data())
+               << denoised_buffer.copy_to(denoised.data())
+               << synchronize();
+        auto statistics = [&](const std::vector<float> &pixels) noexcept {
+            auto lum = [&](uint x, uint y) noexcept {
+                auto p = (y * resolution.x + x) * channel_count;
+                return 0.2126f * pixels[p] + 0.7152f * pixels[p + 1] + 0.0722f * pixels[p + 2];
+            };
+            auto mean = 0.0, roughness = 0.0;
+            for (auto y = 0u; y < resolution.y; y++) {
+                for (auto x = 0u; x < resolution.x; x++) {
+                    auto l = lum(x, y);
+                    LUISA_ASSERT(std::isfinite(l), "Non-finite pixel ({}, {}).", x, y);
+                    mean += l;
+                    if (x + 1u < resolution.x) { roughness += std::abs(lum(x + 1u, y) - l); }
+                }
+            }
+            auto pixel_count = static_cast<double>(resolution.x) * resolution.y;
+            return std::make_pair(mean / pixel_count, roughness / pixel_count);
+        };
+        auto [noisy_mean, noisy_roughness] = statistics(noisy);
+        auto [denoised_mean, denoised_roughness] = statistics(denoised);
+        LUISA_INFO("Mean luminance {} -> {}, mean gradient {} -> {}.",
+                   noisy_mean, denoised_mean, noisy_roughness, denoised_roughness);
+        LUISA_ASSERT(std::abs(denoised_mean - noisy_mean) <= 0.2 * noisy_mean,
+                     "Denoising changed the mean luminance from {} to {}.", noisy_mean, denoised_mean);
+        LUISA_ASSERT(denoised_roughness < 0.5 * noisy_roughness,
+                     "Denoising did not smooth the image: mean gradient {} -> {}.",
+                     noisy_roughness, denoised_roughness);
+    }
     stbi_write_png("test_denoiser.png", resolution.x, resolution.y, 4, host_image.data(), 0);
 }
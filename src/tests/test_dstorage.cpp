@@ -1,4 +1,5 @@
 #include <fstream>
+#include <cstring>
 
 #include <luisa/runtime/context.h>
 #include <luisa/runtime/device.h>
@@ -72,6 +73,8 @@ int main(int argc, char *argv[]) {
         }
         LUISA_INFO("Memory result: {}", file_text);
         LUISA_INFO("Buffer result: {}", buffer_data.data());
+        LUISA_ASSERT(file_text == "hello world!", "Memory read mismatch.");
+        LUISA_ASSERT(luisa::string_view{buffer_data.data()} == "hello world!", "Buffer read mismatch.");
     }
     LUISA_INFO("Start test texture read.");
 
@@ -94,6 +97,7 @@ int main(int argc, char *argv[]) {
         double time = clock.toc();
         LUISA_INFO("Texture read time: {} ms", time);
         compute_stream << img.copy_to(out_pixels.data()) << synchronize();
+        LUISA_ASSERT(out_pixels == pixels, "Texture read mismatch.");
         stbi_write_png("test_dstorage_texture.png", width, height, 4, out_pixels.data(), 0);
     }
     LUISA_INFO("Texture result written to test_dstorage_texture.png.");
@@ -120,12 +124,34 @@ int main(int argc, char *argv[]) {
         double decompress_time = decompress_clock.toc();
         LUISA_INFO("Texture decompress time: {} ms", decompress_time);
         compute_stream << img.copy_to(out_pixels.data()) << synchronize();
+        LUISA_ASSERT(std::memcmp(out_pixels.data(), pixels.data(), pixels.size_bytes()) == 0,
+                     "Texture decompression mismatch.");
         stbi_write_png("test_dstorage_texture_decompressed.png", width, height, 4, out_pixels.data(), 0);
         decompress_clock.tic();
         dstorage_memory_stream << pinned_pixels.copy_to(luisa::span{out_pixels}, compression)
                                << synchronize();
         decompress_time = decompress_clock.toc();
         LUISA_INFO("Memory decompress time: {} ms", decompress_time);
+        LUISA_ASSERT(std::memcmp(out_pixels.data(), pixels.data(), pixels.size_bytes()) == 0,
+                     "Memory decompression mismatch.");
         stbi_write_png("test_dstorage_texture_decompressed_memory.png", width, height, 4, out_pixels.data(), 0);
     }
+    LUISA_INFO("Start test compressed file read.");
+    {
+        DStorageFile file = dstorage_ext->open_file("test_dstorage_texture_compressed.gdeflate");
+        if (!file) {
+            LUISA_WARNING("Compressed file not found.");
+            exit(1);
+        }
+        Buffer<uint> buffer = device.create_buffer<uint>(width * height);
+        luisa::vector<uint8_t> out_pixels(width * height * 4u);
+        Clock decompress_clock{};
+        dstorage_file_stream << file.copy_to(buffer, compression)
+                             << event.signal(3);
+        compute_stream << event.wait(3)
+                       << buffer.copy_to(out_pixels.data())
+                       << synchronize();
+        LUISA_INFO("Buffer decompress time: {} ms", decompress_clock.toc());
+        LUISA_ASSERT(out_pixels == pixels, "Buffer decompression mismatch.");
+    }
 }
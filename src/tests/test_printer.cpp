@@ -1,3 +1,7 @@
+#include <cstdio>
+#include <mutex>
+#include <string_view>
+
 #include <luisa/runtime/context.h>
 #include <luisa/runtime/device.h>
 #include <luisa/runtime/stream.h>
@@ -13,6 +17,34 @@ struct MyStruct {
     uint2 b;
 };
 LUISA_STRUCT(MyStruct, a, b) {};
+
+// collects the dispatch ids of the kernel logs
+class KernelLogSink final : public spdlog::sinks::base_sink<std::mutex> {
+
+private:
+    luisa::vector<uint3> _ids;
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        std::string_view name{msg.logger_name.data(), msg.logger_name.size()};
+        std::string_view payload{msg.payload.data(), msg.payload.size()};
+        auto p = payload.find("[dispatch_id = (");
+        if (name != "device" || p == std::string_view::npos) { return; }
+        std::string id{payload.substr(p)};
+        uint3 v;
+        if (std::sscanf(id.c_str(), "[dispatch_id = (%u, %u, %u)]", &v.x, &v.y, &v.z) == 3) {
+            _ids.emplace_back(v);
+        }
+    }
+    void flush_() override {}
+
+public:
+    [[nodiscard]] auto ids() noexcept {
+        std::scoped_lock lock{mutex_};
+        return _ids;
+    }
+};
+
 int main(int argc, char *argv[]) {
 
     log_level_verbose();
@@ -22,23 +54,61 @@ int main(int argc, char *argv[]) {
         LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
         exit(1);
     }
+    // the printer logs to the sinks of the default logger at its creation
+    auto sink = std::make_shared<KernelLogSink>();
+    luisa::detail::default_logger().sinks().emplace_back(sink);
     Device device = context.create_device(argv[1]);
-    Printer printer{device};
-
-    Kernel2D kernel = [&]() noexcept {
-        UInt2 coord = dispatch_id().xy();
-        $if (coord.x == coord.y) {
-            Float2 v = make_float2(coord) / make_float2(dispatch_size().xy());
-            Var<MyStruct> s;
-            s.a = v;
-            s.b = coord;
-            printer.info_with_location("s = {}", s);
+    {
+        Printer printer{device};
+
+        Kernel2D kernel = [&]() noexcept {
+            UInt2 coord = dispatch_id().xy();
+            $if (coord.x == coord.y) {
+                Float2 v = make_float2(coord) / make_float2(dispatch_size().xy());
+                Var<MyStruct> s;
+                s.a = v;
+                s.b = coord;
+                printer.info_with_location("s = {}", s);
+            };
         };
-    };
-    Shader2D<> shader = device.compile(kernel);
-    Stream stream = device.create_stream();
-    stream << printer.reset()
-           << shader().dispatch(128u, 128u);
-    stream << printer.retrieve()
-           << synchronize();
+        Shader2D<> shader = device.compile(kernel);
+        Stream stream = device.create_stream();
+        stream << printer.reset()
+               << shader().dispatch(128u, 128u);
+        stream << printer.retrieve()
+               << synchronize();
+
+        // logs of each frame are printed in the background while the stream keeps going
+        for (auto i = 0u; i < 4u; i++) {
+            stream << shader().dispatch(16u, 16u)
+                   << printer.retrieve_async();
+        }
+        stream << synchronize();
+
+        // retrievals dropped without being submitted free their snapshots, so
+        // neither the next retrieval nor the destruction of the printer waits for them
+        static_cast<void>(printer.retrieve_async());
+        static_cast<void>(printer.retrieve_async());
+        stream << shader().dispatch(16u, 16u)
+               << printer.retrieve_async()
+               << synchronize();
+    }
+
+    // the synchronous retrieval logs the diagonal of 128 x 128, the five
+    // asynchronous ones that of 16 x 16 each
+    auto ids = sink->ids();
+    LUISA_ASSERT(ids.size() == 128u + 5u * 16u, "Expected {} kernel logs, got {}.",
+                 128u + 5u * 16u, ids.size());
+    luisa::vector<uint> histogram(128u, 0u);
+    for (auto id : ids) {
+        LUISA_ASSERT(id.x == id.y && id.x < 128u && id.z == 0u,
+                     "Unexpected dispatch id ({}, {}, {}).", id.x, id.y, id.z);
+        histogram[id.x]++;
+    }
+    for (auto x = 0u; x < 128u; x++) {
+        auto expected = x < 16u ? 6u : 1u;
+        LUISA_ASSERT(histogram[x] == expected, "Expected {} logs at ({}, {}), got {}.",
+                     expected, x, x, histogram[x]);
+    }
+    LUISA_INFO("Printer test passed.");
 }
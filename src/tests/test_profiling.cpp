@@ -0,0 +1,156 @@
+#include <fstream>
+#include <luisa/luisa-compute.h>
+#include <luisa/backends/ext/profiling_ext.hpp>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cpu", argv[0]);
+        exit(1);
+    }
+    auto device = context.create_device(argv[1]);
+
+    static constexpr auto n = 1024u * 1024u;
+    auto buffer = device.create_buffer<float>(n);
+    auto fill = device.compile<1>([&](Float x) noexcept {
+        buffer->write(dispatch_x(), x);
+    });
+    auto scale = device.compile<1>([&](Float s) noexcept {
+        auto i = dispatch_x();
+        buffer->write(i, buffer->read(i) * s);
+    });
+    fill.set_name("fill");
+    scale.set_name("scale");
+
+    // host timing works on every backend, one record per command list
+    {
+        auto stream = device.create_stream();
+        auto host_profiler = HostProfiler::create();
+        stream.set_profiler(host_profiler);
+        luisa::vector<float> result(n);
+        stream << fill(1.f).dispatch(n)
+               << buffer.copy_to(result.data());
+        stream << scale(2.f).dispatch(n)
+               << buffer.copy_to(result.data())
+               << synchronize();
+        stream.set_profiler(nullptr);
+        stream << scale(2.f).dispatch(n) << synchronize();
+        auto host_records = host_profiler->collect();
+        LUISA_ASSERT(host_records.size() == 2u, "Expected 2 host records, got {}.", host_records.size());
+        for (auto &&r : host_records) {
+            LUISA_ASSERT(r.kind == ProfilingRecord::Kind::COMMAND_LIST &&
+                             r.stream_handle == stream.handle() &&
+                             r.bytes == n * sizeof(float) &&
+                             r.submit_time <= r.start_time && r.start_time <= r.end_time,
+                         "Unexpected host record '{}'.", r.name);
+        }
+        LUISA_ASSERT(host_records[0].end_time <= host_records[1].start_time,
+                     "Host records of a stream overlap.");
+        LUISA_ASSERT(result[0] == 2.f, "Unexpected result {}.", result[0]);
+    }
+
+    auto profiling = device.extension<ProfilingExt>();
+    if (profiling == nullptr) {
+        LUISA_WARNING("ProfilingExt is not supported on backend '{}'.", argv[1]);
+        return 0;
+    }
+
+    auto producer = device.create_stream();
+    auto consumer = device.create_stream();
+    auto enabled_producer = profiling->enable(producer);
+    auto enabled_consumer = profiling->enable(consumer);
+    LUISA_ASSERT(enabled_producer && enabled_consumer, "Failed to enable profiling.");
+
+    luisa::vector<float> input(n, 1.f);
+    luisa::vector<float> output(n);
+    auto event = device.create_timeline_event();
+    producer << buffer.copy_from(input.data())
+             << fill(2.f).dispatch(n)
+             << event.signal(1u);
+    consumer << event.wait(1u)
+             << scale(3.f).dispatch(n)
+             << buffer.copy_to(output.data())
+             << synchronize();
+    producer << synchronize();
+    profiling->disable(producer);
+    profiling->disable(consumer);
+    LUISA_ASSERT(output[0] == 6.f, "Unexpected result {}.", output[0]);
+
+    auto records = profiling->collect();
+    std::ofstream{"profiling_trace.json"} << ProfilingExt::chrome_trace(records);
+
+    // work items of each stream, in execution order
+    using Kind = ProfilingRecord::Kind;
+    auto top_level = [&](const Stream &stream) noexcept {
+        luisa::vector<size_t> indices;
+        for (auto i = 0u; i < records.size(); i++) {
+            if (records[i].stream_handle == stream.handle() && records[i].kind != Kind::COMMAND) {
+                indices.emplace_back(i);
+            }
+        }
+        return indices;
+    };
+    auto children = [&](size_t parent) noexcept {
+        luisa::vector<const ProfilingRecord *> commands;
+        for (auto &&r : records) {
+            if (r.parent == parent) {
+                LUISA_ASSERT(r.kind == Kind::COMMAND, "Only commands have parents.");
+                LUISA_ASSERT(r.start_time >= records[parent].start_time &&
+                                 r.end_time <= records[parent].end_time,
+                             "Command '{}' is not nested in its command list.", r.name);
+                commands.emplace_back(&r);
+            }
+        }
+        return commands;
+    };
+    for (auto &&r : records) {
+        LUISA_ASSERT(r.submit_time <= r.start_time && r.start_time <= r.end_time,
+                     "Invalid timestamps for '{}'.", r.name);
+    }
+
+    auto produced = top_level(producer);
+    LUISA_ASSERT(produced.size() == 2u, "Expected 2 work items on the producer, got {}.", produced.size());
+    auto &&produce_list = records[produced[0]];
+    auto &&signal = records[produced[1]];
+    LUISA_ASSERT(produce_list.kind == Kind::COMMAND_LIST && produce_list.bytes == n * sizeof(float),
+                 "Unexpected producer command list.");
+    auto produce_commands = children(produced[0]);
+    LUISA_ASSERT(produce_commands.size() == 2u &&
+                     produce_commands[0]->name == "BufferUploadCommand" &&
+                     produce_commands[0]->bytes == n * sizeof(float) &&
+                     produce_commands[1]->name == "fill" &&
+                     produce_commands[1]->dispatch_size.x == n &&
+                     produce_commands[0]->end_time <= produce_commands[1]->start_time,
+                 "Unexpected producer commands.");
+    LUISA_ASSERT(signal.kind == Kind::EVENT_SIGNAL && signal.event_value == 1u &&
+                     signal.start_time >= produce_list.end_time,
+                 "Unexpected producer signal.");
+
+    auto consumed = top_level(consumer);
+    LUISA_ASSERT(consumed.size() == 2u, "Expected 2 work items on the consumer, got {}.", consumed.size());
+    auto &&wait = records[consumed[0]];
+    auto &&consume_list = records[consumed[1]];
+    LUISA_ASSERT(wait.kind == Kind::EVENT_WAIT && wait.event_value == 1u &&
+                     wait.end_time >= signal.start_time,
+                 "Unexpected consumer wait.");
+    auto consume_commands = children(consumed[1]);
+    LUISA_ASSERT(consume_list.kind == Kind::COMMAND_LIST &&
+                     consume_list.start_time >= wait.end_time &&
+                     consume_commands.size() == 2u &&
+                     consume_commands[0]->name == "scale" &&
+                     consume_commands[1]->name == "BufferDownloadCommand",
+                 "Unexpected consumer command list.");
+
+    for (auto &&r : records) {
+        LUISA_INFO("[{:016x}] {:<24} wait = {:>8.3f} us, duration = {:>8.3f} us",
+                   r.stream_handle, r.name,
+                   static_cast<double>(r.queue_wait_time()) * 1e-3,
+                   static_cast<double>(r.duration()) * 1e-3);
+    }
+}
@@ -0,0 +1,151 @@
+#include <random>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/image.h>
+#include <luisa/runtime/raster/raster_shader.h>
+#include <luisa/runtime/raster/raster_scene.h>
+#include <luisa/runtime/raster/raster_state.h>
+#include <luisa/runtime/raster/depth_buffer.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/raster/raster_kernel.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+struct V2P {
+    float4 pos;
+    float2 uv;
+};
+
+LUISA_STRUCT(V2P, pos, uv) {};
+
+struct Vertex {
+    std::array<float, 3> pos;
+};
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend> [triangles = 1M] [resolution = 1024] [passes = 8]. "
+                   "<backend>: cuda, dx, cpu, metal",
+                   argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    auto triangle_count = argc > 2 ? static_cast<uint>(std::atoi(argv[2])) : 1024u * 1024u;
+    auto resolution = argc > 3 ? static_cast<uint>(std::atoi(argv[3])) : 1024u;
+    auto pass_count = argc > 4 ? static_cast<uint>(std::atoi(argv[4])) : 8u;
+    LUISA_ASSERT(triangle_count > 0u && resolution > 0u && pass_count > 0u, "Invalid arguments.");
+
+    // the vertex stage moves every vertex to the given depth, and the pixel stage outputs a constant color
+    RasterStageKernel vert = [](Var<AppData> data, Float depth) noexcept {
+        Var<V2P> o;
+        o.pos = make_float4(data.position.xy(), depth, 1.f);
+        o.uv = data.position.xy() * .5f + .5f;
+        return o;
+    };
+    RasterStageKernel pixel = [](Var<V2P> i, Float4 color) noexcept {
+        return color;
+    };
+    RasterKernel<decltype(vert), decltype(pixel)> kernel{vert, pixel};
+    Kernel2D clear_kernel = [](ImageFloat image) noexcept {
+        image.write(dispatch_id().xy(), make_float4(0.f));
+    };
+    MeshFormat mesh_format;
+    VertexAttribute attributes[] = {
+        {VertexAttributeType::Position, VertexElementFormat::XYZ32Float}};
+    mesh_format.emplace_vertex_stream(attributes);
+    RasterShader<float, float4> shader = device.compile(kernel, mesh_format);
+    auto clear = device.compile(clear_kernel);
+
+    Stream stream = device.create_stream(StreamTag::GRAPHICS);
+    DepthBuffer depth = device.create_depth_buffer(DepthFormat::D32, make_uint2(resolution));
+    Image<float> target = device.create_image<float>(PixelStorage::FLOAT4, resolution, resolution);
+    RasterState state{
+        .cull_mode = CullMode::None,
+        .depth_state = DepthState{
+            .enable_depth = true,
+            .comparison = Comparison::Less,
+            .write = true}};
+
+    // two triangles covering the whole screen
+    Vertex quad[] = {{-1.f, -1.f, 0.f}, {1.f, -1.f, 0.f}, {1.f, 1.f, 0.f},
+                     {-1.f, -1.f, 0.f}, {1.f, 1.f, 0.f}, {-1.f, 1.f, 0.f}};
+    Buffer<Vertex> quad_buffer = device.create_buffer<Vertex>(6u);
+    VertexBufferView quad_view{quad_buffer};
+    auto draw_quad = [&](float z, float4 color) noexcept {
+        luisa::vector<RasterMesh> meshes;
+        meshes.emplace_back(luisa::span<const VertexBufferView>{&quad_view, 1u}, 6u, 1u, 0u);
+        return shader(z, color).draw(std::move(meshes), Viewport{}, state, &depth, target);
+    };
+    luisa::vector<float4> host_target(resolution * resolution);
+    luisa::vector<float> host_depth(resolution * resolution);
+    auto check = [&](luisa::string_view name, float4 color, float z) noexcept {
+        stream << target.copy_to(host_target.data())
+               << depth.to_img().copy_to(host_depth.data())
+               << synchronize();
+        for (auto i = 0u; i < resolution * resolution; i++) {
+            LUISA_ASSERT(all(abs(host_target[i] - color) < 1e-4f) && std::abs(host_depth[i] - z) < 1e-4f,
+                         "{} mismatch at pixel ({}, {}): expected {} at depth {}, got {} at depth {}.",
+                         name, i % resolution, i / resolution, color, z, host_target[i], host_depth[i]);
+        }
+    };
+    stream << quad_buffer.copy_from(quad)
+           << depth.clear(1.f)
+           << clear(target).dispatch(resolution, resolution)
+           << draw_quad(.5f, make_float4(.25f, .5f, .75f, 1.f));
+    check("Full-screen quad", make_float4(.25f, .5f, .75f, 1.f), .5f);
+    // the far quad is occluded by the near one drawn before it
+    stream << depth.clear(1.f)
+           << draw_quad(.2f, make_float4(1.f, 0.f, 0.f, 1.f))
+           << draw_quad(.8f, make_float4(0.f, 1.f, 0.f, 1.f));
+    check("Depth occlusion", make_float4(1.f, 0.f, 0.f, 1.f), .2f);
+
+    // random small triangles, drawn with an index buffer
+    luisa::vector<Vertex> host_vertices(triangle_count * 3u);
+    luisa::vector<uint> host_indices(triangle_count * 3u);
+    std::mt19937 engine{std::random_device{}()};
+    std::uniform_real_distribution<float> center_dist{-1.f, 1.f};
+    std::uniform_real_distribution<float> offset_dist{-.02f, .02f};
+    auto covered_pixels = 0.;
+    for (auto t = 0u; t < triangle_count; t++) {
+        auto c = make_float2(center_dist(engine), center_dist(engine));
+        std::array<float2, 3u> p;
+        for (auto k = 0u; k < 3u; k++) {
+            p[k] = c + make_float2(offset_dist(engine), offset_dist(engine));
+            host_vertices[t * 3u + k].pos = {p[k].x, p[k].y, 0.f};
+            host_indices[t * 3u + k] = t * 3u + k;
+        }
+        auto e1 = p[1] - p[0];
+        auto e2 = p[2] - p[0];
+        covered_pixels += .5 * std::abs(e1.x * e2.y - e1.y * e2.x) * .25 * resolution * resolution;
+    }
+    Buffer<Vertex> vertex_buffer = device.create_buffer<Vertex>(host_vertices.size());
+    Buffer<uint> index_buffer = device.create_buffer<uint>(host_indices.size());
+    VertexBufferView vertex_view{vertex_buffer};
+    stream << vertex_buffer.copy_from(host_vertices.data())
+           << index_buffer.copy_from(host_indices.data());
+    auto draw_triangles = [&] {
+        luisa::vector<RasterMesh> meshes;
+        meshes.emplace_back(luisa::span<const VertexBufferView>{&vertex_view, 1u}, index_buffer.view(), 1u, 0u);
+        return shader(.5f, make_float4(1.f)).draw(std::move(meshes), Viewport{}, state, &depth, target);
+    };
+    // warm up
+    stream << depth.clear(1.f) << draw_triangles() << synchronize();
+    Clock clock;
+    for (auto pass = 0u; pass < pass_count; pass++) {
+        stream << depth.clear(1.f) << draw_triangles();
+    }
+    stream << synchronize();
+    auto ms = clock.toc() / pass_count;
+    LUISA_INFO("{} triangles at {}x{}: {:.3f} ms/pass, {:.2f} M triangles/s, {:.2f} M pixels/s (covered).",
+               triangle_count, resolution, resolution, ms,
+               triangle_count * 1e-3 / ms, covered_pixels * 1e-3 / ms);
+}
@@ -0,0 +1,47 @@
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    Kernel1D fill_kernel = [](BufferUInt buffer, UInt scale) noexcept {
+        auto i = dispatch_id().x;
+        buffer.write(i, i * scale);
+    };
+    Clock clock;
+    device.compile_to(fill_kernel, "test_shader_bundle");
+    LUISA_INFO("Compiled shader bundle in {} ms.", clock.toc());
+
+    // loading by name does not trace the kernel
+    clock.tic();
+    auto fill_shader = device.load_shader<1, Buffer<uint>, uint>("test_shader_bundle");
+    LUISA_INFO("Loaded shader bundle in {} ms.", clock.toc());
+    LUISA_ASSERT(fill_shader, "Failed to load the shader bundle.");
+
+    static constexpr auto n = 1024u;
+    static constexpr auto scale = 3u;
+    Buffer<uint> buffer = device.create_buffer<uint>(n);
+    luisa::vector<uint> result(n);
+    stream << fill_shader(buffer, scale).dispatch(n)
+           << buffer.copy_to(result.data())
+           << synchronize();
+    for (auto i = 0u; i < n; i++) {
+        LUISA_ASSERT(result[i] == i * scale, "result[{}] = {}, expected {}.", i, result[i], i * scale);
+    }
+    LUISA_INFO("Shader bundle test passed.");
+}
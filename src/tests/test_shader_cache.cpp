@@ -0,0 +1,61 @@
+#include <random>
+
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cpu", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    // the salt is baked into the kernel, so its hash is new to the cache of every run
+    auto salt = std::random_device{}();
+    Kernel1D kernel = [salt](BufferUInt buffer) noexcept {
+        buffer.write(dispatch_id().x, salt + dispatch_id().x);
+    };
+
+    auto before = context.shader_cache_statistics();
+    auto first = device.compile(kernel);
+    auto after_first = context.shader_cache_statistics();
+    LUISA_ASSERT(after_first.miss_count == before.miss_count + 1u &&
+                     after_first.hit_count == before.hit_count,
+                 "Expected one miss on the first compilation, got {} miss(es) and {} hit(s).",
+                 after_first.miss_count - before.miss_count,
+                 after_first.hit_count - before.hit_count);
+    auto second = device.compile(kernel);
+    auto after_second = context.shader_cache_statistics();
+    LUISA_ASSERT(after_second.hit_count == after_first.hit_count + 1u &&
+                     after_second.miss_count == after_first.miss_count,
+                 "Expected one hit on the second compilation, got {} miss(es) and {} hit(s).",
+                 after_second.miss_count - after_first.miss_count,
+                 after_second.hit_count - after_first.hit_count);
+
+    // the shader loaded from the cache behaves as the one built
+    Buffer<uint> buffer = device.create_buffer<uint>(64u);
+    luisa::vector<uint> result(64u);
+    for (auto shader : {&first, &second}) {
+        std::fill(result.begin(), result.end(), 0u);
+        stream << (*shader)(buffer).dispatch(64u)
+               << buffer.copy_to(result.data())
+               << synchronize();
+        for (auto i = 0u; i < 64u; i++) {
+            LUISA_ASSERT(result[i] == salt + i, "Mismatch at {}: expected {}, got {}.",
+                         i, salt + i, result[i]);
+        }
+    }
+    LUISA_INFO("Shader cache: {} miss(es), {} hit(s).",
+               after_second.miss_count, after_second.hit_count);
+}
@@ -0,0 +1,189 @@
+#include <random>
+#include <algorithm>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/soa.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+struct Particle {
+    float3 position;
+    float3 velocity;
+    float4 color;
+    float mass;
+    uint id;
+};
+
+LUISA_STRUCT(Particle, position, velocity, color, mass, id) {};
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend> [count = 4M] [block size = 32] [passes = 16]. "
+                   "<backend>: cuda, dx, cpu, metal",
+                   argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    auto n = argc > 2 ? static_cast<uint>(std::atoi(argv[2])) : 4u * 1024u * 1024u;
+    auto block_size = argc > 3 ? static_cast<uint>(std::atoi(argv[3])) : 32u;
+    auto pass_count = argc > 4 ? static_cast<uint>(std::atoi(argv[4])) : 16u;
+    LUISA_ASSERT(n > 0u && pass_count > 0u, "Invalid arguments.");
+
+    luisa::vector<Particle> host_particles(n);
+    std::mt19937 engine{std::random_device{}()};
+    std::uniform_real_distribution<float> dist{-1.f, 1.f};
+    for (auto i = 0u; i < n; i++) {
+        auto &p = host_particles[i];
+        p.position = make_float3(dist(engine), dist(engine), dist(engine));
+        p.velocity = make_float3(dist(engine), dist(engine), dist(engine));
+        p.color = make_float4(dist(engine), dist(engine), dist(engine), 1.f);
+        p.mass = dist(engine) + 2.f;
+        p.id = i;
+    }
+    auto same = [](const Particle &lhs, const Particle &rhs) noexcept {
+        return all(lhs.position == rhs.position) && all(lhs.velocity == rhs.velocity) &&
+               all(lhs.color == rhs.color) && lhs.mass == rhs.mass && lhs.id == rhs.id;
+    };
+
+    Stream stream = device.create_stream();
+    Buffer<Particle> aos = device.create_buffer<Particle>(n);
+    SOA<Particle> soa = device.create_soa<Particle>(n);
+    AoSoA<Particle> aosoa = device.create_aosoa<Particle>(n, block_size);
+
+    // host-side transposition, checked against a device-side conversion into AoS
+    Kernel1D soa_to_aos_kernel = [](SOAVar<Particle> soa, BufferVar<Particle> aos) noexcept {
+        auto i = dispatch_x();
+        aos.write(i, soa.read(i));
+    };
+    Kernel1D aosoa_to_aos_kernel = [](AoSoAVar<Particle> aosoa, BufferVar<Particle> aos) noexcept {
+        auto i = dispatch_x();
+        aos.write(i, aosoa.read(i));
+    };
+    auto soa_to_aos = device.compile(soa_to_aos_kernel);
+    auto aosoa_to_aos = device.compile(aosoa_to_aos_kernel);
+    luisa::vector<Particle> host_download(n);
+    auto check = [&](luisa::string_view layout) noexcept {
+        for (auto i = 0u; i < n; i++) {
+            LUISA_ASSERT(same(host_particles[i], host_download[i]),
+                         "{} mismatch at index {}: expected {}, got {}.",
+                         layout, i, host_particles[i], host_download[i]);
+        }
+    };
+    Clock clock;
+    stream << soa.copy_from(host_particles.data()) << synchronize();
+    auto soa_upload_ms = clock.toc();
+    stream << soa_to_aos(soa, aos).dispatch(n)
+           << aos.copy_to(host_download.data())
+           << synchronize();
+    check("SOA upload");
+    clock.tic();
+    stream << soa.copy_to(host_download.data()) << synchronize();
+    auto soa_download_ms = clock.toc();
+    check("SOA download");
+    clock.tic();
+    stream << aosoa.copy_from(host_particles.data()) << synchronize();
+    auto aosoa_upload_ms = clock.toc();
+    stream << aosoa_to_aos(aosoa, aos).dispatch(n)
+           << aos.copy_to(host_download.data())
+           << synchronize();
+    check("AoSoA upload");
+    clock.tic();
+    stream << aosoa.copy_to(host_download.data()) << synchronize();
+    auto aosoa_download_ms = clock.toc();
+    check("AoSoA download");
+    // a subview starting and ending in the middle of blocks must leave the other elements untouched
+    auto sub_offset = std::min(n / 3u, block_size + 1u);
+    auto sub_size = n / 2u;
+    stream << aosoa.view().subview(sub_offset, sub_size).copy_from(host_particles.data() + sub_offset)
+           << aosoa.copy_to(host_download.data())
+           << synchronize();
+    check("AoSoA subview upload");
+    auto bytes = static_cast<double>(n) * sizeof(Particle);
+    LUISA_INFO("Host transposition of {:.2f} MB: SOA upload {:.2f} ms, download {:.2f} ms; "
+               "AoSoA (block size {}) upload {:.2f} ms, download {:.2f} ms.",
+               bytes * 1e-6, soa_upload_ms, soa_download_ms,
+               block_size, aosoa_upload_ms, aosoa_download_ms);
+
+    // full updates touch every member, while partial ones only the position and velocity
+    Kernel1D aos_full_kernel = [](BufferVar<Particle> particles, Float dt) noexcept {
+        auto i = dispatch_x();
+        auto p = particles.read(i);
+        p.position += p.velocity * dt;
+        p.color *= .5f;
+        p.mass += dt;
+        particles.write(i, p);
+    };
+    // AoS elements can only be accessed as a whole
+    Kernel1D aos_partial_kernel = [](BufferVar<Particle> particles, Float dt) noexcept {
+        auto i = dispatch_x();
+        auto p = particles.read(i);
+        p.position += p.velocity * dt;
+        particles.write(i, p);
+    };
+    Kernel1D soa_full_kernel = [](SOAVar<Particle> particles, Float dt) noexcept {
+        auto i = dispatch_x();
+        auto p = particles.read(i);
+        p.position += p.velocity * dt;
+        p.color *= .5f;
+        p.mass += dt;
+        particles.write(i, p);
+    };
+    Kernel1D soa_partial_kernel = [](SOAVar<Particle> particles, Float dt) noexcept {
+        auto i = dispatch_x();
+        auto position = particles.position.read(i);
+        auto velocity = particles.velocity.read(i);
+        particles.position.write(i, position + velocity * dt);
+    };
+    Kernel1D aosoa_full_kernel = [](AoSoAVar<Particle> particles, Float dt) noexcept {
+        auto i = dispatch_x();
+        auto p = particles.read(i);
+        p.position += p.velocity * dt;
+        p.color *= .5f;
+        p.mass += dt;
+        particles.write(i, p);
+    };
+    Kernel1D aosoa_partial_kernel = [](AoSoAVar<Particle> particles, Float dt) noexcept {
+        auto i = dispatch_x();
+        auto [block, lane] = particles.block(i);
+        auto position = block.position.read(lane);
+        auto velocity = block.velocity.read(lane);
+        block.position.write(lane, position + velocity * dt);
+    };
+
+    auto benchmark = [&](luisa::string_view name, double bytes_per_element, auto &&dispatch) noexcept {
+        // warm up
+        stream << dispatch() << synchronize();
+        Clock clock;
+        for (auto pass = 0u; pass < pass_count; pass++) { stream << dispatch(); }
+        stream << synchronize();
+        auto ms = clock.toc() / pass_count;
+        LUISA_INFO("{}: {:.3f} ms/pass, {:.2f} GB/s.",
+                   name, ms, bytes_per_element * n * 1e-6 / ms);
+    };
+    // bytes read and written per element
+    auto aos_bytes = 2.0 * sizeof(Particle);
+    auto packed_full_bytes = 2.0 * (3u + 3u + 4u + 1u + 1u) * sizeof(float);
+    auto packed_partial_bytes = 3.0 * 3u * sizeof(float);
+    auto aos_full = device.compile(aos_full_kernel);
+    auto aos_partial = device.compile(aos_partial_kernel);
+    auto soa_full = device.compile(soa_full_kernel);
+    auto soa_partial = device.compile(soa_partial_kernel);
+    auto aosoa_full = device.compile(aosoa_full_kernel);
+    auto aosoa_partial = device.compile(aosoa_partial_kernel);
+    benchmark("AoS (full)", aos_bytes, [&] { return aos_full(aos, 1e-3f).dispatch(n); });
+    benchmark("AoS (partial)", aos_bytes, [&] { return aos_partial(aos, 1e-3f).dispatch(n); });
+    benchmark("SOA (full)", packed_full_bytes, [&] { return soa_full(soa, 1e-3f).dispatch(n); });
+    benchmark("SOA (partial)", packed_partial_bytes, [&] { return soa_partial(soa, 1e-3f).dispatch(n); });
+    benchmark("AoSoA (full)", packed_full_bytes, [&] { return aosoa_full(aosoa, 1e-3f).dispatch(n); });
+    benchmark("AoSoA (partial)", packed_partial_bytes, [&] { return aosoa_partial(aosoa, 1e-3f).dispatch(n); });
+}
@@ -0,0 +1,60 @@
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/sparse_buffer.h>
+#include <luisa/runtime/sparse_heap.h>
+#include <luisa/runtime/sparse_command_list.h>
+#include <luisa/core/logging.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    auto device = context.create_device(argv[1]);
+    auto stream = device.create_stream();
+
+    Kernel1D write_kernel = [](BufferFloat buffer, Float base) noexcept {
+        auto i = dispatch_id().x;
+        buffer.write(i, base + cast<float>(i));
+    };
+    auto write = device.compile(write_kernel);
+
+    auto sparse_buffer = device.create_sparse_buffer<float>(1024ull * 1024ull * 1024ull);
+    auto tile_elements = static_cast<uint>(sparse_buffer.tile_size() / sizeof(float));
+    auto heap = device.allocate_sparse_buffer_heap(sparse_buffer.tile_size());
+    SparseCommandList sparse_cmdlist;
+    luisa::vector<float> result(tile_elements);
+
+    // only the middle one of three tiles is resident, the writes to the others are discarded
+    sparse_cmdlist << sparse_buffer.map_tile(1u, 1u, heap);
+    stream << sparse_cmdlist.commit()
+           << write(sparse_buffer.view(0u, 3u * tile_elements), 1.f).dispatch(3u * tile_elements)
+           << sparse_buffer.view(tile_elements, tile_elements).copy_to(result.data())
+           << synchronize();
+    for (auto i = 0u; i < tile_elements; i++) {
+        auto expected = 1.f + static_cast<float>(tile_elements + i);
+        LUISA_ASSERT(result[i] == expected, "Resident tile mismatch at {}: expected {}, got {}.",
+                     i, expected, result[i]);
+    }
+
+    // a remapped tile starts over from zero
+    sparse_cmdlist << sparse_buffer.unmap_tile(1u, 1u);
+    stream << sparse_cmdlist.commit();
+    sparse_cmdlist << sparse_buffer.map_tile(1u, 1u, heap);
+    stream << sparse_cmdlist.commit()
+           << sparse_buffer.view(tile_elements, tile_elements).copy_to(result.data())
+           << synchronize();
+    for (auto i = 0u; i < tile_elements; i++) {
+        LUISA_ASSERT(result[i] == 0.f, "Remapped tile is not zero at {}: got {}.", i, result[i]);
+    }
+    LUISA_INFO("Sparse buffer test passed.");
+}
@@ -0,0 +1,70 @@
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/event.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend> [streams = 64] [rounds = 100]. "
+                   "<backend>: cuda, dx, cpu, metal",
+                   argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    auto stream_count = argc > 2 ? static_cast<uint>(std::atoi(argv[2])) : 64u;
+    auto round_count = argc > 3 ? static_cast<uint>(std::atoi(argv[3])) : 100u;
+    LUISA_ASSERT(stream_count > 1u && round_count > 0u, "Invalid arguments.");
+
+    luisa::vector<Stream> streams;
+    streams.reserve(stream_count);
+    for (auto i = 0u; i < stream_count; i++) { streams.emplace_back(device.create_stream()); }
+    TimelineEvent event = device.create_timeline_event();
+    Buffer<uint> counter = device.create_buffer<uint>(1u);
+    Buffer<uint> trace = device.create_buffer<uint>(stream_count * round_count);
+
+    // each step records the counter and increments it, so the trace is in the order the steps ran
+    Kernel1D step_kernel = [](BufferUInt counter, BufferUInt trace, UInt index) noexcept {
+        auto value = counter.read(0u);
+        trace.write(index, value);
+        counter.write(0u, value + 1u);
+    };
+    auto step = device.compile(step_kernel);
+    luisa::vector<uint> zero(1u, 0u);
+    streams[0] << counter.copy_from(zero.data()) << synchronize();
+
+    // the streams form a ring: each waits for the previous one in every round, and they are
+    // submitted in reverse, so almost every stream waits for an event that is not signaled yet
+    Clock clock;
+    for (auto round = 0u; round < round_count; round++) {
+        for (auto i = stream_count; i-- > 0u;) {
+            auto fence = static_cast<uint64_t>(round) * stream_count + i;
+            streams[i] << event.wait(fence + 1u)
+                       << step(counter, trace, static_cast<uint>(fence)).dispatch(1u)
+                       << event.signal(fence + 2u);
+        }
+    }
+    // kicked off by another stream, as the first one is parked on the event
+    Stream kickoff = device.create_stream();
+    kickoff << event.signal(1u);
+    event.synchronize(static_cast<uint64_t>(round_count) * stream_count + 1u);
+    auto ms = clock.toc();
+
+    luisa::vector<uint> host_trace(stream_count * round_count);
+    streams[0] << trace.copy_to(host_trace.data()) << synchronize();
+    for (auto i = 0u; i < host_trace.size(); i++) {
+        LUISA_ASSERT(host_trace[i] == i, "Step {} ran at position {}.", i, host_trace[i]);
+    }
+    for (auto &&s : streams) { s.synchronize(); }
+    LUISA_INFO("{} dependent steps over {} streams in {:.2f} ms ({:.2f} us/step).",
+               host_trace.size(), stream_count, ms, ms * 1e3 / host_trace.size());
+}
@@ -1,3 +1,6 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
 #include <luisa/runtime/stream.h>
 #include <luisa/runtime/image.h>
 #include <luisa/runtime/shader.h>
@@ -11,10 +14,199 @@
 using namespace luisa;
 using namespace luisa::compute;
 
+// Host decoders for the block modes that the CPU backend emits (BC7 modes 1
+// and 6, BC6H modes 11 to 14), as the CPU backend cannot sample BC images.
+struct BlockReader {
+    const uint8_t *data;
+    uint offset{0u};
+    uint read(uint count) noexcept {
+        auto v = 0u;
+        for (auto i = 0u; i < count; i++, offset++) {
+            v |= ((data[offset >> 3u] >> (offset & 7u)) & 1u) << i;
+        }
+        return v;
+    }
+};
+
+static constexpr int weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+static constexpr int weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+
+bool decode_bc7_block(const uint8_t *block, uint8_t (&texels)[16][4]) noexcept {
+    static constexpr uint16_t partitions[64] = {
+        0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+        0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+        0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+        0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+        0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+        0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+        0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+        0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22};
+    static constexpr uint8_t anchors[64] = {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+        15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+        6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15};
+    BlockReader r{block};
+    auto mode = 0u;
+    while (mode < 8u && r.read(1u) == 0u) { mode++; }
+    if (mode == 6u) {
+        int e[2][4];
+        for (auto c = 0u; c < 4u; c++) {
+            for (auto &endpoint : e) { endpoint[c] = static_cast<int>(r.read(7u)) << 1; }
+        }
+        for (auto &endpoint : e) {
+            auto p = static_cast<int>(r.read(1u));
+            for (auto &v : endpoint) { v |= p; }
+        }
+        for (auto i = 0u; i < 16u; i++) {
+            auto w = weights4[r.read(i == 0u ? 3u : 4u)];
+            for (auto c = 0u; c < 4u; c++) {
+                texels[i][c] = static_cast<uint8_t>((e[0][c] * (64 - w) + e[1][c] * w + 32) >> 6);
+            }
+        }
+        return true;
+    }
+    if (mode == 1u) {
+        auto partition = r.read(6u);
+        int e[4][3];
+        for (auto c = 0u; c < 3u; c++) {
+            for (auto &endpoint : e) { endpoint[c] = static_cast<int>(r.read(6u)); }
+        }
+        int p[2] = {static_cast<int>(r.read(1u)), static_cast<int>(r.read(1u))};
+        for (auto k = 0u; k < 4u; k++) {
+            for (auto &v : e[k]) {
+                v = (v << 1) | p[k / 2u];
+                v = (v << 1) | (v >> 6);
+            }
+        }
+        for (auto i = 0u; i < 16u; i++) {
+            auto s = (partitions[partition] >> i) & 1u;
+            auto w = weights3[r.read(i == 0u || i == anchors[partition] ? 2u : 3u)];
+            for (auto c = 0u; c < 3u; c++) {
+                texels[i][c] = static_cast<uint8_t>((e[s * 2u][c] * (64 - w) + e[s * 2u + 1u][c] * w + 32) >> 6);
+            }
+            texels[i][3] = 255u;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool decode_bc6h_block(const uint8_t *block, float (&texels)[16][3]) noexcept {
+    BlockReader r{block};
+    auto precision = 0u, delta = 0u;
+    switch (r.read(5u)) {
+        case 0x03u: precision = 10u, delta = 10u; break;
+        case 0x07u: precision = 11u, delta = 9u; break;
+        case 0x0bu: precision = 12u, delta = 8u; break;
+        case 0x0fu: precision = 16u, delta = 4u; break;
+        default: return false;
+    }
+    auto unquantize = [precision](int q) noexcept {
+        if (precision >= 15u) { return q; }
+        if (q == 0) { return 0; }
+        if (q == (1 << precision) - 1) { return 0xffff; }
+        return ((q << 16) + 0x8000) >> precision;
+    };
+    int e0[3], e1[3];
+    for (auto &v : e0) { v = static_cast<int>(r.read(10u)); }
+    for (auto c = 0u; c < 3u; c++) {
+        e1[c] = static_cast<int>(r.read(delta));
+        for (auto bit = static_cast<int>(precision) - 1; bit >= 10; bit--) {
+            e0[c] |= static_cast<int>(r.read(1u)) << bit;
+        }
+    }
+    for (auto c = 0u; c < 3u; c++) {
+        if (precision != 10u) {
+            auto d = e1[c] & (1 << (delta - 1u)) ? e1[c] - (1 << delta) : e1[c];
+            e1[c] = (e0[c] + d) & ((1 << precision) - 1);
+        }
+        e0[c] = unquantize(e0[c]);
+        e1[c] = unquantize(e1[c]);
+    }
+    for (auto i = 0u; i < 16u; i++) {
+        auto w = weights4[r.read(i == 0u ? 3u : 4u)];
+        for (auto c = 0u; c < 3u; c++) {
+            auto h = static_cast<uint16_t>(((e0[c] * (64 - w) + e1[c] * w + 32) >> 6) * 31 >> 6);
+            texels[i][c] = static_cast<float>(luisa::bit_cast<half>(h));
+        }
+    }
+    return true;
+}
+
+// Pins the decoders to blocks laid out by hand from the format specification, so
+// that a decoder sharing a mistake with the encoder cannot pass the round trip.
+// Both blocks interpolate between two endpoints with texel i using index i.
+void check_reference_blocks() noexcept {
+    // BC7 mode 6: RGBA endpoints (127, 0, 64, 127) and (0, 127, 64, 127), p-bits 1 and 0
+    static constexpr uint8_t bc7_block[16] = {
+        0xc0, 0x3f, 0x00, 0xf0, 0x07, 0x02, 0xff, 0xff,
+        0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe};
+    static constexpr uint8_t bc7_texels[16][4] = {
+        {255, 1, 129, 255}, {239, 17, 129, 255}, {219, 37, 129, 255}, {203, 52, 129, 255},
+        {187, 68, 129, 255}, {171, 84, 129, 255}, {151, 104, 129, 255}, {135, 120, 129, 255},
+        {120, 135, 128, 254}, {104, 151, 128, 254}, {84, 171, 128, 254}, {68, 187, 128, 254},
+        {52, 203, 128, 254}, {36, 218, 128, 254}, {16, 238, 128, 254}, {0, 254, 128, 254}};
+    uint8_t ldr[16][4];
+    LUISA_ASSERT(decode_bc7_block(bc7_block, ldr), "Reference BC7 block is not decoded.");
+    for (auto i = 0u; i < 16u; i++) {
+        for (auto c = 0u; c < 4u; c++) {
+            LUISA_ASSERT(ldr[i][c] == bc7_texels[i][c],
+                         "Reference BC7 texel {} channel {}: expected {}, got {}.",
+                         i, c, bc7_texels[i][c], ldr[i][c]);
+        }
+    }
+    // BC6H mode 11: RGB endpoints (0, 512, 1023) and (1023, 512, 0), results as half bits
+    static constexpr uint8_t bc6h_block[16] = {
+        0x03, 0x00, 0x00, 0xff, 0xff, 0x1f, 0x40, 0x00,
+        0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe};
+    static constexpr uint16_t bc6h_texels[16][3] = {
+        {0, 15887, 31743}, {1984, 15887, 29759}, {4464, 15887, 27279}, {6448, 15887, 25295},
+        {8432, 15887, 23311}, {10416, 15887, 21327}, {12896, 15887, 18847}, {14880, 15887, 16863},
+        {16863, 15887, 14880}, {18847, 15887, 12896}, {21327, 15887, 10416}, {23311, 15887, 8432},
+        {25295, 15887, 6448}, {27279, 15887, 4464}, {29759, 15887, 1984}, {31743, 15887, 0}};
+    float hdr[16][3];
+    LUISA_ASSERT(decode_bc6h_block(bc6h_block, hdr), "Reference BC6H block is not decoded.");
+    for (auto i = 0u; i < 16u; i++) {
+        for (auto c = 0u; c < 3u; c++) {
+            auto expected = static_cast<float>(luisa::bit_cast<half>(bc6h_texels[i][c]));
+            LUISA_ASSERT(hdr[i][c] == expected,
+                         "Reference BC6H texel {} channel {}: expected {}, got {}.",
+                         i, c, expected, hdr[i][c]);
+        }
+    }
+}
+
+// PSNR of the RGB channels against the 8-bit source, or NaN for unknown modes
+template<typename Decode>
+double block_psnr(const uint8_t *pixels, uint2 resolution, const luisa::vector<uint> &blocks, Decode &&decode) noexcept {
+    auto block_count = (resolution + 3u) / 4u;
+    auto squared_error = 0.0;
+    for (auto by = 0u; by < block_count.y; by++) {
+        for (auto bx = 0u; bx < block_count.x; bx++) {
+            float texels[16][3];
+            if (!decode(reinterpret_cast<const uint8_t *>(blocks.data() + (by * block_count.x + bx) * 4u), texels)) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            for (auto i = 0u; i < 16u; i++) {
+                auto x = bx * 4u + (i & 3u), y = by * 4u + (i >> 2u);
+                if (x >= resolution.x || y >= resolution.y) { continue; }
+                for (auto c = 0u; c < 3u; c++) {
+                    auto d = static_cast<double>(pixels[(y * resolution.x + x) * 4u + c]) - texels[i][c];
+                    squared_error += d * d;
+                }
+            }
+        }
+    }
+    auto mse = squared_error / (3.0 * resolution.x * resolution.y);
+    return 10.0 * std::log10(255.0 * 255.0 / std::max(mse, 1e-10));
+}
+
 int main(int argc, char *argv[]) {
     Context context{argv[0]};
     if (argc <= 1) { exit(1); }
-    Device device = context.create_device(argv[1]);
+    luisa::string_view backend{argv[1]};
+    Device device = context.create_device(backend);
     auto tex_ext = device.extension<TexCompressExt>();
     Stream stream = device.create_stream();
     auto image_width = 0;
@@ -23,10 +215,10 @@ int main(int argc, char *argv[]) {
     auto image_pixels = stbi_load("logo.png", &image_width, &image_height, &image_channels, 4);
     auto resolution = make_uint2(image_width, image_height);
     Image<float> byte4_image{device.create_image<float>(PixelStorage::BYTE4, resolution)};
-    Image<float> bc6h_image{device.create_image<float>(PixelStorage::BC6, resolution)};
-    Image<float> bc7_image{device.create_image<float>(PixelStorage::BC7, resolution)};
-    Buffer<uint> bc6h_buffer{device.create_buffer<uint>(bc6h_image.view().size_bytes() / sizeof(uint))};
-    Buffer<uint> bc7_buffer{device.create_buffer<uint>(bc7_image.view().size_bytes() / sizeof(uint))};
+    auto block_count = (resolution + 3u) / 4u;
+    auto compressed_size = block_count.x * block_count.y * 4u;
+    Buffer<uint> bc6h_buffer{device.create_buffer<uint>(compressed_size)};
+    Buffer<uint> bc7_buffer{device.create_buffer<uint>(compressed_size)};
     stream << byte4_image.copy_from(image_pixels) << synchronize();
     Clock clk;
     tex_ext->compress_bc6h(stream, byte4_image, bc6h_buffer);
@@ -34,6 +226,53 @@ int main(int argc, char *argv[]) {
     stream << synchronize();
     auto compress_time = clk.toc();
     LUISA_INFO("Compress {}x{} image spend {} ms", resolution.x, resolution.y, compress_time);
+
+    // throughput
+    constexpr auto iterations = 8u;
+    auto mega_pixels = static_cast<double>(resolution.x) * resolution.y * iterations * 1e-6;
+    clk.tic();
+    for (auto i = 0u; i < iterations; i++) { tex_ext->compress_bc6h(stream, byte4_image, bc6h_buffer); }
+    stream << synchronize();
+    auto bc6h_time = clk.toc();
+    clk.tic();
+    for (auto i = 0u; i < iterations; i++) { tex_ext->compress_bc7(stream, byte4_image, bc7_buffer, 0); }
+    stream << synchronize();
+    auto bc7_time = clk.toc();
+    LUISA_INFO("BC6H: {} ms per image ({} MPixel/s), BC7: {} ms per image ({} MPixel/s)",
+               bc6h_time / iterations, mega_pixels / bc6h_time * 1e3,
+               bc7_time / iterations, mega_pixels / bc7_time * 1e3);
+
+    if (backend == "cpu") {
+        // quality
+        check_reference_blocks();
+        luisa::vector<uint> bc6h_blocks(compressed_size);
+        luisa::vector<uint> bc7_blocks(compressed_size);
+        stream << bc6h_buffer.copy_to(bc6h_blocks.data())
+               << bc7_buffer.copy_to(bc7_blocks.data())
+               << synchronize();
+        auto bc6h_psnr = block_psnr(image_pixels, resolution, bc6h_blocks, [](auto block, auto &texels) noexcept {
+            float hdr[16][3];
+            if (!decode_bc6h_block(block, hdr)) { return false; }
+            for (auto i = 0u; i < 16u; i++) {
+                for (auto c = 0u; c < 3u; c++) { texels[i][c] = hdr[i][c] * 255.f; }
+            }
+            return true;
+        });
+        auto bc7_psnr = block_psnr(image_pixels, resolution, bc7_blocks, [](auto block, auto &texels) noexcept {
+            uint8_t ldr[16][4];
+            if (!decode_bc7_block(block, ldr)) { return false; }
+            for (auto i = 0u; i < 16u; i++) {
+                for (auto c = 0u; c < 3u; c++) { texels[i][c] = ldr[i][c]; }
+            }
+            return true;
+        });
+        LUISA_INFO("PSNR of RGB: BC6H {} dB, BC7 {} dB", bc6h_psnr, bc7_psnr);
+        LUISA_ASSERT(bc6h_psnr > 30.0 && bc7_psnr > 35.0, "Texture compression quality is too low.");
+        return 0;
+    }
+
+    Image<float> bc6h_image{device.create_image<float>(PixelStorage::BC6, resolution)};
+    Image<float> bc7_image{device.create_image<float>(PixelStorage::BC7, resolution)};
     Kernel2D present_kernel = [&](ImageVar<float> image) {
         Var coord = dispatch_id().xy();
         byte4_image->write(coord, make_float4(image.read(coord).xyz(), 1.0f));
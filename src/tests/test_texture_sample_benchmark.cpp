@@ -0,0 +1,111 @@
+#include <array>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/bindless_array.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/sugar.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend> [resolution = 1024] [samples = 16]. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    auto resolution = argc > 2 ? static_cast<uint>(std::atoi(argv[2])) : 1024u;
+    auto sample_count = argc > 3 ? static_cast<uint>(std::atoi(argv[3])) : 16u;
+    LUISA_ASSERT(resolution > 0u && sample_count > 0u, "Invalid arguments.");
+
+    static constexpr auto texture_size = 1024u;
+    static constexpr std::array storages{PixelStorage::BYTE1, PixelStorage::BYTE4,
+                                         PixelStorage::SHORT4, PixelStorage::HALF4,
+                                         PixelStorage::FLOAT1, PixelStorage::FLOAT4};
+    static constexpr std::array filters{Sampler::Filter::POINT, Sampler::Filter::LINEAR_POINT,
+                                        Sampler::Filter::LINEAR_LINEAR, Sampler::Filter::ANISOTROPIC};
+    static constexpr std::array addresses{Sampler::Address::EDGE, Sampler::Address::REPEAT,
+                                          Sampler::Address::MIRROR, Sampler::Address::ZERO};
+
+    Stream stream = device.create_stream();
+    BindlessArray heap = device.create_bindless_array(storages.size() * filters.size() * addresses.size());
+
+    // a mip-mapped checkerboard in each storage, bound with every sampler
+    Kernel2D fill_kernel = [](ImageFloat image) noexcept {
+        auto p = dispatch_id().xy();
+        auto checker = ((p.x / 8u) ^ (p.y / 8u)) & 1u;
+        auto uv = make_float2(p) / make_float2(dispatch_size().xy());
+        image.write(p, make_float4(uv, cast<float>(checker), 1.f));
+    };
+    auto fill = device.compile(fill_kernel);
+    luisa::vector<Image<float>> textures;
+    for (auto storage : storages) {
+        auto &texture = textures.emplace_back(device.create_image<float>(storage, texture_size, texture_size, 0u));
+        for (auto level = 0u; level < texture.mip_levels(); level++) {
+            stream << fill(texture.view(level)).dispatch(texture.view(level).size());
+        }
+    }
+    for (auto s = 0u; s < storages.size(); s++) {
+        for (auto f = 0u; f < filters.size(); f++) {
+            for (auto a = 0u; a < addresses.size(); a++) {
+                auto slot = (s * filters.size() + f) * addresses.size() + a;
+                heap.emplace_on_update(slot, textures[s], Sampler{filters[f], addresses[a]});
+            }
+        }
+    }
+    stream << heap.update() << synchronize();
+
+    // uv slightly outside [0, 1] to exercise the address modes, with a rotating footprint for the anisotropic filter
+    Kernel2D sample_kernel = [sample_count](BindlessVar heap, UInt slot, UInt mode, BufferFloat4 result) noexcept {
+        auto p = dispatch_id().xy();
+        auto size = make_float2(dispatch_size().xy());
+        auto sum = def(make_float4());
+        for (auto i = 0u; i < sample_count; i++) {
+            auto offset = static_cast<float>(i) / static_cast<float>(sample_count);
+            auto uv = (make_float2(p) + offset) / size * 1.2f - .1f;
+            auto texture = heap.tex2d(slot);
+            $switch (mode) {
+                $case (0u) { sum += texture.sample(uv); };
+                $case (1u) { sum += texture.sample(uv, offset * 4.f); };
+                $default {
+                    auto angle = offset * 3.1415926f;
+                    auto dpdx = make_float2(cos(angle), sin(angle)) * 4.f / size;
+                    auto dpdy = make_float2(-sin(angle), cos(angle)) * .5f / size;
+                    sum += texture.sample(uv, dpdx, dpdy);
+                };
+            };
+        }
+        result.write(p.y * dispatch_size_x() + p.x, sum / static_cast<float>(sample_count));
+    };
+    auto sample = device.compile(sample_kernel);
+    auto result = device.create_buffer<float4>(resolution * resolution);
+
+    constexpr std::array mode_names{"sample", "sample_level", "sample_grad"};
+    for (auto mode = 0u; mode < mode_names.size(); mode++) {
+        for (auto s = 0u; s < storages.size(); s++) {
+            for (auto f = 0u; f < filters.size(); f++) {
+                for (auto a = 0u; a < addresses.size(); a++) {
+                    auto slot = static_cast<uint>((s * filters.size() + f) * addresses.size() + a);
+                    // warm up
+                    stream << sample(heap, slot, mode, result).dispatch(resolution, resolution) << synchronize();
+                    Clock clock;
+                    stream << sample(heap, slot, mode, result).dispatch(resolution, resolution) << synchronize();
+                    auto ms = clock.toc();
+                    LUISA_INFO("{} ({}, {}, {}): {:.3f} ms, {:.2f} Msamples/s.",
+                               mode_names[mode], luisa::to_string(storages[s]),
+                               luisa::to_string(filters[f]), luisa::to_string(addresses[a]), ms,
+                               static_cast<double>(resolution) * resolution * sample_count * 1e-3 / ms);
+                }
+            }
+        }
+    }
+}
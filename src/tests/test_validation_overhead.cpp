@@ -0,0 +1,71 @@
+#include <cstdlib>
+#include <luisa/luisa-compute.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+// submission cost of many small command lists on two streams that hand
+// buffer chunks to each other, with and without the validation layer
+[[nodiscard]] double run(Context &context, luisa::string_view backend, bool validation) noexcept {
+    static constexpr auto chunk_count = 64u;
+    static constexpr auto chunk_size = 256u;
+    static constexpr auto list_count = 4096u;
+
+    auto device = context.create_device(backend, nullptr, validation);
+    auto buffer = device.create_buffer<float>(chunk_count * chunk_size);
+    auto step = device.compile<1>([&](UInt offset) noexcept {
+        auto i = offset + dispatch_x();
+        buffer->write(i, buffer->read(i) * .5f + 1.f);
+    });
+    auto streams = std::array{device.create_stream(), device.create_stream()};
+    auto event = device.create_timeline_event();
+    luisa::vector<float> zeros(chunk_count * chunk_size, 0.f);
+    streams[0] << buffer.copy_from(zeros.data()) << synchronize();
+
+    // monotonic across the runs on the same event, otherwise the waits of a later run
+    // would already be satisfied and let the lists race on the chunks
+    auto fence = 0ull;
+    auto run_lists = [&] {
+        for (auto i = 0u; i < list_count; i++) {
+            // every list touches its own chunk, ownership alternates between the streams
+            auto &stream = streams[i % 2u];
+            auto offset = (i % chunk_count) * chunk_size;
+            if (i != 0u) { stream << event.wait(fence); }
+            stream << step(offset).dispatch(chunk_size)
+                   << event.signal(++fence);
+        }
+        for (auto &&s : streams) { s << synchronize(); }
+    };
+    run_lists();// compile & warm up
+    Clock clk;
+    run_lists();
+    return clk.toc() * 1e3 / list_count;
+}
+
+void set_sample_interval(uint interval) noexcept {
+    auto value = luisa::format("{}", interval);
+#ifdef _WIN32
+    _putenv_s("LUISA_VALIDATION_SAMPLE_INTERVAL", value.c_str());
+#else
+    setenv("LUISA_VALIDATION_SAMPLE_INTERVAL", value.c_str(), 1);
+#endif
+}
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    auto native = run(context, argv[1], false);
+    LUISA_INFO("native:                  {:>8.3f} us/list", native);
+    for (auto interval : {1u, 4u, 16u, 64u}) {
+        set_sample_interval(interval);
+        auto validated = run(context, argv[1], true);
+        LUISA_INFO("validation (1 in {:>2}):   {:>8.3f} us/list, overhead = {:>6.2f}%",
+                   interval, validated, (validated - native) / native * 1e2);
+    }
+}
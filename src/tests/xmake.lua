@@ -86,9 +86,13 @@ end
 test_proj("test_helloworld")
 if get_config("enable_ir") then
 	test_proj('test_autodiff')
+	test_proj('test_autodiff_checkpoint')
+	test_proj('test_ast2ir_concurrent')
 end
 test_proj("test_ast")
 test_proj("test_atomic")
+test_proj("test_atomic_contention")
+test_proj("test_atomic_memory_order")
 test_proj("test_bindless", true)
 test_proj("test_callable")
 -- test_proj("test_dsl")
@@ -103,31 +107,59 @@ test_proj("test_path_tracing_camera", true)
 test_proj("test_path_tracing_cutout", true)
 test_proj("test_photon_mapping", true)
 test_proj("test_printer")
+test_proj("test_profiling")
+test_proj("test_validation_overhead")
+test_proj("test_validation_ranges")
 test_proj("test_procedural")
 test_proj("test_rtx")
 test_proj("test_runtime", true)
 test_proj("test_sampler")
-test_proj("test_denoiser", true)
+test_proj("test_texture_sample_benchmark")
+test_proj("test_denoiser", false, function()
+	if enable_gui then
+		add_defines("ENABLE_DISPLAY")
+	end
+end)
 test_proj("test_sdf_renderer", true, function()
 	add_defines("ENABLE_DISPLAY")
 end)
 test_proj("test_shader_toy", true)
 test_proj("test_shader_visuals_present", true)
+test_proj("test_soa_bandwidth")
 test_proj("test_texture_io")
 test_proj("test_thread_pool")
 test_proj("test_type")
 test_proj("test_raster", true)
+test_proj("test_raster_throughput")
+test_proj("test_stream_events")
+test_proj("test_buffer_bandwidth")
+test_proj("test_shader_cache")
 test_proj("test_texture_compress")
 test_proj("test_swapchain", true)
 test_proj("test_swapchain_static", true)
 test_proj("test_select_device", true)
 test_proj("test_dstorage", true)
 test_proj("test_indirect", true)
+test_proj("test_indirect_rtx", true)
+test_proj("test_shader_bundle", true)
+test_proj("test_codegen_benchmark", false, function()
+	add_files("../backends/common/string_scratch.cpp", "../backends/metal/metal_codegen_ast.cpp",
+			  "../backends/metal/metal_builtin_embedded.cpp")
+	add_defines("LUISA_CODEGEN_BENCHMARK_METAL")
+	if get_config("dx_backend") or get_config("vk_backend") then
+		add_files("../backends/common/hlsl/access_chain.cpp", "../backends/common/hlsl/codegen_stack_data.cpp",
+				  "../backends/common/hlsl/hlsl_codegen.cpp", "../backends/common/hlsl/hlsl_codegen_util.cpp",
+				  "../backends/common/hlsl/string_builder.cpp", "../backends/common/hlsl/struct_generator.cpp")
+		add_defines("LUISA_CODEGEN_BENCHMARK_HLSL")
+		add_deps("lc-hlsl-builtin")
+	end
+end)
 test_proj("test_texture3d", true)
 test_proj("test_atomic_queue", true)
 test_proj("test_shared_memory", true)
 test_proj("test_native_include", true)
 test_proj("test_sparse_texture", true)
+test_proj("test_sparse_buffer")
 test_proj("test_dml")
 
 if get_config("cuda_ext_lcub") then 
@@ -136,6 +168,12 @@ if get_config("cuda_ext_lcub") then
 	end)
 end
 
+if get_config("cpu_backend") then
+	test_proj("test_cpu_lcub", false, function ()
+		add_deps("lc-backend-cpu-ext-lcub")
+	end)
+end
+
 local enable_fsr2
 local enable_xess
 -- Super-sampling example
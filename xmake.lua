@@ -28,8 +28,7 @@ option_end()
 -- enable Vulkan backend
 option("vk_backend")
 set_values(true, false)
--- TODO: vulkan backend not ready
-set_default(false)
+set_default(true)
 set_showmenu(true)
 option_end()
 -- enable NVIDIA-CUDA backend